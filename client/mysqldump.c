@@ -174,6 +174,35 @@ static MYSQL_RES *get_table_name_result= NULL;
 static MEM_ROOT glob_root;
 static MYSQL_RES *routine_res, *routine_list_res;
 
+/*
+  With --parallel, the SELECT ... INTO OUTFILE statements of --tab are
+  queued as DUMP_TASKs and run by worker threads, each with its own
+  connection, while the main connection writes the table definitions.
+*/
+typedef struct st_dump_task
+{
+  struct st_dump_task *next;
+  char *db;
+  char *query;
+} DUMP_TASK;
+
+typedef struct st_dump_worker
+{
+  MYSQL mysql;
+  pthread_t thread;
+  char db[NAME_LEN + 1];                  /* Current database */
+} DUMP_WORKER;
+
+static uint opt_parallel= 0;
+static DUMP_WORKER *dump_workers;
+static uint dump_worker_count= 0;
+static pthread_mutex_t dump_task_mutex;
+static pthread_cond_t dump_task_cond;     /* A task was queued, or stop */
+static pthread_cond_t dump_done_cond;     /* dump_tasks_pending decreased */
+static DUMP_TASK *dump_task_first, **dump_task_last= &dump_task_first;
+static uint dump_tasks_pending;           /* Queued or running */
+static my_bool dump_workers_stop, dump_workers_failed;
+
 
 #include <sslopt-vars.h>
 FILE *md_result_file= 0;
@@ -489,6 +518,12 @@ static struct my_option my_long_options[] =
   {"order-by-primary", OPT_ORDER_BY_PRIMARY,
    "Sorts each table's rows by primary key, or first unique key, if such a key exists.  Useful when dumping a MyISAM table to be loaded into an InnoDB table, but will make the dump itself take considerably longer.",
    &opt_order_by_primary, &opt_order_by_primary, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"parallel", OPT_USE_THREADS,
+   "Dump table data with this many connections in parallel. Only used "
+   "with --tab, as the server writes the data files. With "
+   "--single-transaction, all connections start their transactions under "
+   "FLUSH TABLES WITH READ LOCK, so that they see the same snapshot.",
+   &opt_parallel, &opt_parallel, 0, GET_UINT, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"password", 'p',
    "Password to use when connecting to server. If password is not given it's solicited on the tty.",
    0, 0, 0, GET_STR, OPT_ARG, 0, 0, 0, 0, 0, 0},
@@ -621,6 +656,9 @@ static int dump_tablespaces_for_tables(char *db, char **table_names, int tables)
 static int dump_tablespaces_for_databases(char** databases);
 static int dump_tablespaces(char* ts_where);
 static void print_comment(FILE *, my_bool, const char *, ...);
+static void add_dump_task(const char *db, const char *query);
+static void wait_for_dump_workers();
+static void stop_dump_workers();
 
 /*
   Print the supplied message if in verbose mode
@@ -1213,6 +1251,12 @@ static int get_options(int *argc, char ***argv)
     fprintf(stderr, "%s: You can't use ..enclosed.. and ..optionally-enclosed.. at the same time.\n", my_progname_short);
     return(EX_USAGE);
   }
+  if (opt_parallel > 1 && !path)
+  {
+    fprintf(stderr, "%s: --parallel can only be used with --tab.\n",
+            my_progname_short);
+    return(EX_USAGE);
+  }
   if ((opt_databases || opt_alldbs) && path)
   {
     fprintf(stderr,
@@ -1798,6 +1842,7 @@ static FILE* open_sql_file_for_table(const char* table, int flags)
 
 static void free_resources()
 {
+  stop_dump_workers();
   if (md_result_file && md_result_file != stdout)
     my_fclose(md_result_file, MYF(0));
   if (get_table_name_result)
@@ -1847,69 +1892,59 @@ static void maybe_exit(int error)
 
 
 /*
-  db_connect -- connects to the host and selects DB.
+  Connects to the host and sets up the session the way the dump expects.
 */
 
-static int connect_to_db(char *host, char *user,char *passwd)
+static int connect_to_server(MYSQL *con, char *host, char *user,
+                             char *passwd)
 {
   char buff[20+FN_REFLEN];
   my_bool reconnect;
-  DBUG_ENTER("connect_to_db");
+  DBUG_ENTER("connect_to_server");
 
-  verbose_msg("-- Connecting to %s...\n", host ? host : "localhost");
-  mysql_init(&mysql_connection);
+  mysql_init(con);
   if (opt_compress)
-    mysql_options(&mysql_connection,MYSQL_OPT_COMPRESS,NullS);
+    mysql_options(con,MYSQL_OPT_COMPRESS,NullS);
 #ifdef HAVE_OPENSSL
   if (opt_use_ssl)
   {
-    mysql_ssl_set(&mysql_connection, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
+    mysql_ssl_set(con, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
                   opt_ssl_capath, opt_ssl_cipher);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
-    mysql_options(&mysql_connection, MARIADB_OPT_TLS_VERSION, opt_tls_version);
+    mysql_options(con, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
+    mysql_options(con, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
+    mysql_options(con, MARIADB_OPT_TLS_VERSION, opt_tls_version);
   }
-  mysql_options(&mysql_connection,MYSQL_OPT_SSL_VERIFY_SERVER_CERT,
+  mysql_options(con,MYSQL_OPT_SSL_VERIFY_SERVER_CERT,
                 (char*)&opt_ssl_verify_server_cert);
 #endif
   if (opt_protocol)
-    mysql_options(&mysql_connection,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
-  mysql_options(&mysql_connection, MYSQL_SET_CHARSET_NAME, default_charset);
+    mysql_options(con,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
+  mysql_options(con, MYSQL_SET_CHARSET_NAME, default_charset);
 
   if (opt_plugin_dir && *opt_plugin_dir)
-    mysql_options(&mysql_connection, MYSQL_PLUGIN_DIR, opt_plugin_dir);
+    mysql_options(con, MYSQL_PLUGIN_DIR, opt_plugin_dir);
 
   if (opt_default_auth && *opt_default_auth)
-    mysql_options(&mysql_connection, MYSQL_DEFAULT_AUTH, opt_default_auth);
+    mysql_options(con, MYSQL_DEFAULT_AUTH, opt_default_auth);
 
-  mysql_options(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
-  mysql_options4(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_ADD,
+  mysql_options(con, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
+  mysql_options4(con, MYSQL_OPT_CONNECT_ATTR_ADD,
                  "program_name", "mysqldump");
-  mysql= &mysql_connection;          /* So we can mysql_close() it properly */
-  if (!mysql_real_connect(&mysql_connection,host,user,passwd,
+  if (!mysql_real_connect(con,host,user,passwd,
                           NULL,opt_mysql_port,opt_mysql_unix_port, 0))
   {
-    DB_error(&mysql_connection, "when trying to connect");
+    DB_error(con, "when trying to connect");
     DBUG_RETURN(1);
   }
-  if ((mysql_get_server_version(&mysql_connection) < 40100) ||
-      (opt_compatible_mode & 3))
-  {
-    /* Don't dump SET NAMES with a pre-4.1 server (bug#7997).  */
-    opt_set_charset= 0;
-
-    /* Don't switch charsets for 4.1 and earlier.  (bug#34192). */
-    server_supports_switching_charsets= FALSE;
-  } 
   /*
     As we're going to set SQL_MODE, it would be lost on reconnect, so we
     cannot reconnect.
   */
   reconnect= 0;
-  mysql_options(&mysql_connection, MYSQL_OPT_RECONNECT, &reconnect);
+  mysql_options(con, MYSQL_OPT_RECONNECT, &reconnect);
   my_snprintf(buff, sizeof(buff), "/*!40100 SET @@SQL_MODE='%s' */",
               compatible_mode_normal_str);
-  if (mysql_query_with_error_report(mysql, 0, buff))
+  if (mysql_query_with_error_report(con, 0, buff))
     DBUG_RETURN(1);
   /*
     set time_zone to UTC to allow dumping date types between servers with
@@ -1918,10 +1953,35 @@ static int connect_to_db(char *host, char *user,char *passwd)
   if (opt_tz_utc)
   {
     my_snprintf(buff, sizeof(buff), "/*!40103 SET TIME_ZONE='+00:00' */");
-    if (mysql_query_with_error_report(mysql, 0, buff))
+    if (mysql_query_with_error_report(con, 0, buff))
       DBUG_RETURN(1);
   }
   DBUG_RETURN(0);
+} /* connect_to_server */
+
+
+/*
+  db_connect -- connects to the host and selects DB.
+*/
+
+static int connect_to_db(char *host, char *user,char *passwd)
+{
+  DBUG_ENTER("connect_to_db");
+
+  verbose_msg("-- Connecting to %s...\n", host ? host : "localhost");
+  mysql= &mysql_connection;          /* So we can mysql_close() it properly */
+  if (connect_to_server(&mysql_connection, host, user, passwd))
+    DBUG_RETURN(1);
+  if ((mysql_get_server_version(&mysql_connection) < 40100) ||
+      (opt_compatible_mode & 3))
+  {
+    /* Don't dump SET NAMES with a pre-4.1 server (bug#7997).  */
+    opt_set_charset= 0;
+
+    /* Don't switch charsets for 4.1 and earlier.  (bug#34192). */
+    server_supports_switching_charsets= FALSE;
+  } 
+  DBUG_RETURN(0);
 } /* connect_to_db */
 
 
@@ -4059,12 +4119,7 @@ static void dump_table(const char *table, const char *db, const uchar *hash_key,
       order_by= 0;
     }
 
-    if (mysql_real_query(mysql, query_string.str, (ulong)query_string.length))
-    {
-      dynstr_free(&query_string);
-      DB_error(mysql, "when executing 'SELECT INTO OUTFILE'");
-      DBUG_VOID_RETURN;
-    }
+    add_dump_task(db, query_string.str);
   }
   else
   {
@@ -5493,6 +5548,8 @@ static int dump_all_tables_in_db(char *database)
     fputs("</database>\n", md_result_file);
     check_io(md_result_file);
   }
+  /* The data must be read under the table locks */
+  wait_for_dump_workers();
   if (lock_tables)
     (void) mysql_query_with_error_report(mysql, 0, "UNLOCK TABLES");
   if (using_mysql_db)
@@ -5878,6 +5935,8 @@ static int dump_selected_tables(char *db, char **table_names, int tables)
     fputs("</database>\n", md_result_file);
     check_io(md_result_file);
   }
+  /* The data must be read under the table locks */
+  wait_for_dump_workers();
   if (lock_tables)
     (void) mysql_query_with_error_report(mysql, 0, "UNLOCK TABLES");
   DBUG_RETURN(0);
@@ -6249,6 +6308,205 @@ static int start_transaction(MYSQL *mysql_con)
 }
 
 
+/*
+  Runs the queued tasks on one worker connection until
+  stop_dump_workers() is called.
+*/
+
+pthread_handler_t dump_worker_thread(void *arg)
+{
+  DUMP_WORKER *worker= (DUMP_WORKER*) arg;
+  DUMP_TASK *task;
+
+  mysql_thread_init();
+  pthread_mutex_lock(&dump_task_mutex);
+  for (;;)
+  {
+    my_bool failed= 0;
+
+    while (!(task= dump_task_first) && !dump_workers_stop)
+      pthread_cond_wait(&dump_task_cond, &dump_task_mutex);
+    if (!task)
+      break;
+    if (!(dump_task_first= task->next))
+      dump_task_last= &dump_task_first;
+
+    if (!dump_workers_failed)
+    {
+      pthread_mutex_unlock(&dump_task_mutex);
+      if (strcmp(worker->db, task->db) &&
+          mysql_select_db(&worker->mysql, task->db))
+        failed= 1;
+      else
+      {
+        strmake_buf(worker->db, task->db);
+        failed= mysql_real_query(&worker->mysql, task->query,
+                                 (ulong) strlen(task->query)) != 0;
+      }
+      pthread_mutex_lock(&dump_task_mutex);
+      if (failed)
+      {
+        fprintf(stderr, "%s: Got error: %d: \"%s\" %s\n", my_progname_short,
+                mysql_errno(&worker->mysql), mysql_error(&worker->mysql),
+                "when executing 'SELECT INTO OUTFILE'");
+        fflush(stderr);
+        if (!first_error)
+          first_error= EX_MYSQLERR;
+        if (!ignore_errors)
+          dump_workers_failed= 1;
+      }
+    }
+    my_free(task);
+    dump_tasks_pending--;
+    pthread_cond_broadcast(&dump_done_cond);
+  }
+  pthread_mutex_unlock(&dump_task_mutex);
+  mysql_thread_end();
+  return 0;
+}
+
+
+/*
+  Opens the worker connections for --parallel and starts their threads.
+
+  This is called right after the main connection started its
+  transaction, while FLUSH TABLES WITH READ LOCK is still held, so
+  that with --single-transaction all connections see the same snapshot.
+*/
+
+static int start_dump_workers()
+{
+  uint i;
+  DBUG_ENTER("start_dump_workers");
+
+  if (!(dump_workers= (DUMP_WORKER*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                               opt_parallel *
+                                               sizeof(DUMP_WORKER),
+                                               MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  pthread_mutex_init(&dump_task_mutex, NULL);
+  pthread_cond_init(&dump_task_cond, NULL);
+  pthread_cond_init(&dump_done_cond, NULL);
+
+  for (i= 0; i < opt_parallel; i++)
+  {
+    DUMP_WORKER *worker= &dump_workers[i];
+    verbose_msg("-- Connecting worker %u...\n", i + 1);
+    if (connect_to_server(&worker->mysql, current_host, current_user,
+                          opt_password) ||
+        (opt_single_transaction && start_transaction(&worker->mysql)))
+    {
+      mysql_close(&worker->mysql);
+      break;
+    }
+    if (pthread_create(&worker->thread, NULL, dump_worker_thread, worker))
+    {
+      fprintf(stderr, "%s: Could not create thread\n", my_progname_short);
+      mysql_close(&worker->mysql);
+      break;
+    }
+    dump_worker_count++;
+  }
+  DBUG_RETURN(dump_worker_count != opt_parallel);
+}
+
+
+/*
+  Queues a query for the workers, or runs it on the main connection if
+  there are no workers.
+*/
+
+static void add_dump_task(const char *db, const char *query)
+{
+  DUMP_TASK *task;
+  size_t db_length= strlen(db) + 1, query_length= strlen(query) + 1;
+
+  if (!dump_worker_count)
+  {
+    if (mysql_real_query(mysql, query, (ulong) query_length - 1))
+      DB_error(mysql, "when executing 'SELECT INTO OUTFILE'");
+    return;
+  }
+
+  if (!(task= (DUMP_TASK*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                     sizeof(DUMP_TASK) + db_length +
+                                     query_length, MYF(MY_WME))))
+    die(EX_MYSQLERR, "Couldn't allocate memory");
+  task->next= NULL;
+  task->db= (char*) (task + 1);
+  task->query= task->db + db_length;
+  memcpy(task->db, db, db_length);
+  memcpy(task->query, query, query_length);
+
+  pthread_mutex_lock(&dump_task_mutex);
+  *dump_task_last= task;
+  dump_task_last= &task->next;
+  dump_tasks_pending++;
+  pthread_cond_signal(&dump_task_cond);
+  pthread_mutex_unlock(&dump_task_mutex);
+}
+
+
+/*
+  Waits until the workers have run all queued tasks. This must be done
+  before the main connection releases the table locks that the data
+  was read under.
+*/
+
+static void wait_for_dump_workers()
+{
+  my_bool failed;
+
+  if (!dump_worker_count)
+    return;
+  pthread_mutex_lock(&dump_task_mutex);
+  while (dump_tasks_pending)
+    pthread_cond_wait(&dump_done_cond, &dump_task_mutex);
+  failed= dump_workers_failed;
+  pthread_mutex_unlock(&dump_task_mutex);
+  if (failed)
+    maybe_exit(EX_MYSQLERR);
+}
+
+
+/*
+  Stops the worker threads and closes their connections. Tasks that are
+  still queued are discarded.
+*/
+
+static void stop_dump_workers()
+{
+  uint i;
+  DUMP_TASK *task;
+
+  if (!dump_workers)
+    return;
+  pthread_mutex_lock(&dump_task_mutex);
+  while ((task= dump_task_first))
+  {
+    dump_task_first= task->next;
+    my_free(task);
+    dump_tasks_pending--;
+  }
+  dump_task_last= &dump_task_first;
+  dump_workers_stop= 1;
+  pthread_cond_broadcast(&dump_task_cond);
+  pthread_mutex_unlock(&dump_task_mutex);
+
+  for (i= 0; i < dump_worker_count; i++)
+  {
+    pthread_join(dump_workers[i].thread, NULL);
+    mysql_close(&dump_workers[i].mysql);
+  }
+  pthread_mutex_destroy(&dump_task_mutex);
+  pthread_cond_destroy(&dump_task_cond);
+  pthread_cond_destroy(&dump_done_cond);
+  my_free(dump_workers);
+  dump_workers= NULL;
+  dump_worker_count= 0;
+}
+
+
 static ulong find_set(TYPELIB *lib, const char *x, size_t length,
                       char **err_pos, uint *err_len)
 {
@@ -6849,7 +7107,7 @@ int main(int argc, char **argv)
   }
 
   if ((opt_lock_all_tables || (opt_master_data && !consistent_binlog_pos) ||
-       (opt_single_transaction && flush_logs)) &&
+       (opt_single_transaction && (flush_logs || opt_parallel > 1))) &&
       do_flush_tables_read_lock(mysql))
     goto err;
 
@@ -6881,6 +7139,9 @@ int main(int argc, char **argv)
   if (opt_single_transaction && start_transaction(mysql))
     goto err;
 
+  if (opt_parallel > 1 && start_dump_workers())
+    goto err;
+
   /* Add 'STOP SLAVE to beginning of dump */
   if (opt_slave_apply && add_stop_slave())
     goto err;
@@ -6961,6 +7222,9 @@ int main(int argc, char **argv)
   if (opt_slave_apply && add_slave_statements())
     goto err;
 
+  /* wait for the data files of the last tables */
+  wait_for_dump_workers();
+
   /* ensure dumped data flushed */
   if (md_result_file && fflush(md_result_file))
   {
@@ -57,6 +57,12 @@
               --iterations=5 --query=query.sql --create=create.sql \
               --delimiter=";"
 
+  Replay the sessions of a general query log, twice as fast as they were
+  logged, and report the throughput and the latency percentiles of every
+  statement digest:
+
+    mysqlslap --replay=general.log --replay-speed=2
+
 TODO:
   Add language for better tests
   String length for files and those put on the command line are not
@@ -84,6 +90,7 @@
 #include "client_priv.h"
 #include <mysqld_error.h>
 #include <my_dir.h>
+#include <hash.h>
 #include <signal.h>
 #include <sslopt-vars.h>
 #ifndef __WIN__
@@ -120,7 +127,10 @@ static char *host= NULL, *opt_password= NULL, *user= NULL,
             *pre_system= NULL,
             *post_system= NULL,
             *opt_mysql_unix_port= NULL,
-            *opt_init_command= NULL;
+            *opt_init_command= NULL,
+            *opt_replay_file= NULL,
+            *opt_replay_speed_str= NULL;
+static double replay_speed= 1.0;
 static char *opt_plugin_dir= 0, *opt_default_auth= 0;
 
 const char *delimiter= "\n";
@@ -261,6 +271,8 @@ void option_cleanup(option_string *stmt);
 void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr);
 static int run_statements(MYSQL *mysql, statement *stmt);
 int slap_connect(MYSQL *mysql);
+static int slap_connect_db(MYSQL *mysql, const char *db);
+static int run_replay(void);
 static int run_query(MYSQL *mysql, const char *query, size_t len);
 
 static const char ALPHANUMERICS[]=
@@ -372,6 +384,13 @@ int main(int argc, char **argv)
   pthread_mutex_init(&sleeper_mutex, NULL);
   pthread_cond_init(&sleep_threshhold, NULL);
 
+  if (opt_replay_file)
+  {
+    if (run_replay())
+      exit(1);
+    goto end;
+  }
+
   /* Main iterations loop */
   eptr= engine_options;
   do
@@ -401,6 +420,7 @@ int main(int argc, char **argv)
 
   } while (eptr ? (eptr= eptr->next) : 0);
 
+end:
   pthread_mutex_destroy(&counter_mutex);
   pthread_cond_destroy(&count_threshhold);
   pthread_mutex_destroy(&sleeper_mutex);
@@ -684,6 +704,18 @@ static struct my_option my_long_options[] =
   {"query", 'q', "Query to run or file containing query to run.",
     &user_supplied_query, &user_supplied_query,
     0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"replay", OPT_SLAP_REPLAY,
+    "General query log file to replay. Every session of the log is replayed "
+    "by its own connection, which runs the statements of the session in "
+    "their logged order and at their logged time. The throughput and the "
+    "latency percentiles of every statement digest are reported.",
+    &opt_replay_file, &opt_replay_file,
+    0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"replay-speed", OPT_SLAP_REPLAY_SPEED,
+    "Speed-up factor of the logged timing for --replay, like 2 for twice "
+    "as fast. 0 runs the statements of every session without waiting.",
+    &opt_replay_speed_str, &opt_replay_speed_str,
+    0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"silent", 's', "Run program in silent mode - no output.",
     &opt_silent, &opt_silent, 0, GET_BOOL,  NO_ARG,
     0, 0, 0, 0, 0, 0},
@@ -1226,6 +1258,27 @@ get_options(int *argc,char ***argv)
       exit(1);
   }
 
+  if (opt_replay_file && (auto_generate_sql || create_string ||
+                          user_supplied_query))
+  {
+      fprintf(stderr,
+              "%s: Can't use --replay when create and query strings or --auto-generate-sql are specified!\n",
+              my_progname);
+      exit(1);
+  }
+
+  if (opt_replay_speed_str)
+  {
+    char *end;
+    replay_speed= strtod(opt_replay_speed_str, &end);
+    if (*end || replay_speed < 0)
+    {
+      fprintf(stderr, "Invalid value specified for the option "
+              "'replay-speed'\n");
+      return 1;
+    }
+  }
+
   parse_comma(concurrency_str ? concurrency_str : "1", &concurrency);
 
   if (opt_csv_str)
@@ -2268,6 +2321,13 @@ statement_cleanup(statement *stmt)
 
 int 
 slap_connect(MYSQL *mysql)
+{
+  return slap_connect_db(mysql, create_schema_string);
+}
+
+
+static int
+slap_connect_db(MYSQL *mysql, const char *db)
 {
   /* Connect to server */
   static ulong connection_retry_sleep= 100000; /* Microseconds */
@@ -2278,7 +2338,7 @@ slap_connect(MYSQL *mysql)
     if (opt_init_command)
       mysql_options(mysql, MYSQL_INIT_COMMAND, opt_init_command);
     if (mysql_real_connect(mysql, host, user, opt_password,
-                           create_schema_string,
+                           db,
                            opt_mysql_port,
                            opt_mysql_unix_port,
                            connect_flags))
@@ -2298,3 +2358,610 @@ slap_connect(MYSQL *mysql)
 
   return 0;
 }
+
+
+/*
+  Replay of a general query log (--replay)
+
+  Every session (thread id) of the log is replayed by its own thread and
+  connection, which runs the statements of the session in their logged
+  order. A statement is started at its logged time relative to the first
+  entry of the log, divided by --replay-speed; the timestamps of the
+  general log have a resolution of one second. The latencies are
+  collected per digest, the statement with its literals replaced by '?'.
+*/
+
+#define REPLAY_QUERY 0
+#define REPLAY_INIT_DB 1
+
+/* Maximum length of a digest text, like performance_schema_max_digest_length */
+#define REPLAY_DIGEST_LENGTH 1024
+
+typedef struct replay_entry replay_entry;
+
+struct replay_entry {
+  ulonglong time;            /* Seconds after the first entry of the log */
+  uint command;              /* REPLAY_QUERY or REPLAY_INIT_DB */
+  char *string;              /* Points into the buffer of the log file */
+  size_t length;
+  replay_entry *next;
+};
+
+typedef struct replay_session replay_session;
+
+struct replay_session {
+  ulonglong thread_id;
+  char *db;                  /* Database of the Connect entry, or NULL */
+  replay_entry *first, *last;
+};
+
+typedef struct replay_digest replay_digest;
+
+struct replay_digest {
+  char *text;
+  size_t length;
+  ulonglong errors;
+  ulonglong total;           /* Sum of the latencies in microseconds */
+  DYNAMIC_ARRAY latencies;   /* ulonglong, in microseconds */
+};
+
+static HASH replay_sessions, replay_digests;
+static pthread_mutex_t replay_mutex;
+static ulonglong replay_start;
+
+
+static void free_replay_session(void *arg)
+{
+  replay_session *session= (replay_session *) arg;
+  replay_entry *entry, *next;
+  for (entry= session->first; entry; entry= next)
+  {
+    next= entry->next;
+    my_free(entry);
+  }
+  my_free(session->db);
+  my_free(session);
+}
+
+
+static void free_replay_digest(void *arg)
+{
+  replay_digest *digest= (replay_digest *) arg;
+  delete_dynamic(&digest->latencies);
+  my_free(digest);
+}
+
+
+static uchar *get_replay_digest_key(const uchar *arg, size_t *length,
+                                    my_bool not_used __attribute__((unused)))
+{
+  const replay_digest *digest= (const replay_digest *) arg;
+  *length= digest->length;
+  return (uchar *) digest->text;
+}
+
+
+/** Whether a line of the general log is part of the header of the file */
+static my_bool is_replay_header(const char *line, size_t length)
+{
+  static const char started[]= "started with:";
+  return (is_prefix(line, "Time\t\t") || is_prefix(line, "Tcp port: ") ||
+          is_prefix(line, "TCP Port: ") ||
+          (length >= sizeof(started) - 1 &&
+           !memcmp(line + length - (sizeof(started) - 1), started,
+                   sizeof(started) - 1)));
+}
+
+
+/**
+  Parse a general query log into replay_sessions.
+
+  Every entry starts with a "YYMMDD HH:MM:SS" timestamp, or with two tabs
+  if its time is the one of the previous entry, followed by the thread id,
+  the command and a tab. Lines that do not start like this continue the
+  statement of the previous entry.
+
+  @return the buffer with the contents of the file, which the entries
+          point into, or NULL on error
+*/
+static char *parse_replay_log(const char *file)
+{
+  MY_STAT sbuf;
+  File data_file;
+  char *buffer, *line, *eol, *end;
+  replay_entry *entry= NULL;
+  time_t first_time= 0, last_time= 0;
+  my_bool have_time= FALSE;
+
+  if (!my_stat(file, &sbuf, MYF(0)) || !MY_S_ISREG(sbuf.st_mode))
+  {
+    fprintf(stderr,"%s: Replay file is not a regular file: %s\n",
+            my_progname, file);
+    return NULL;
+  }
+  if ((data_file= my_open(file, O_RDONLY, MYF(0))) == -1)
+  {
+    fprintf(stderr,"%s: Could not open replay file: %s\n", my_progname, file);
+    return NULL;
+  }
+  buffer= (char *) my_malloc(PSI_NOT_INSTRUMENTED, (size_t) sbuf.st_size + 1,
+                             MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+  if (my_read(data_file, (uchar *) buffer, (size_t) sbuf.st_size, MYF(MY_NABP)))
+  {
+    fprintf(stderr,"%s: Could not read replay file: %s\n", my_progname, file);
+    my_close(data_file, MYF(0));
+    my_free(buffer);
+    return NULL;
+  }
+  my_close(data_file, MYF(0));
+  end= buffer + sbuf.st_size;
+
+  for (line= buffer; line < end; line= eol + 1)
+  {
+    char *pos, *command;
+    ulonglong thread_id;
+    replay_session *session;
+
+    if (!(eol= memchr(line, '\n', (size_t) (end - line))))
+      eol= end;
+
+    if (is_replay_header(line, (size_t) (eol - line)))
+    {
+      entry= NULL;
+      continue;
+    }
+
+    if (eol - line > 16 && my_isdigit(&my_charset_latin1, line[0]) &&
+        line[6] == ' ')
+    {
+      struct tm tm_time;
+      uint year, month, day, hour, minute, second;
+      if (sscanf(line, "%2u%2u%2u %u:%u:%u", &year, &month, &day,
+                 &hour, &minute, &second) != 6)
+        goto continuation;
+      bzero(&tm_time, sizeof(tm_time));
+      tm_time.tm_year= year + 100;
+      tm_time.tm_mon= month - 1;
+      tm_time.tm_mday= day;
+      tm_time.tm_hour= hour;
+      tm_time.tm_min= minute;
+      tm_time.tm_sec= second;
+      tm_time.tm_isdst= -1;
+      last_time= mktime(&tm_time);
+      if (!have_time)
+      {
+        first_time= last_time;
+        have_time= TRUE;
+      }
+      pos= line + 15;
+    }
+    else if (line[0] == '\t' && line + 1 < eol && line[1] == '\t')
+      pos= line + 2;
+    else
+      goto continuation;
+
+    while (pos < eol && (*pos == ' ' || *pos == '\t'))
+      pos++;
+    if (pos == eol || !my_isdigit(&my_charset_latin1, *pos))
+      goto continuation;
+    thread_id= strtoull(pos, &pos, 10);
+    if (*pos != ' ')
+      goto continuation;
+    command= pos + 1;
+    if (!(pos= memchr(command, '\t', (size_t) (eol - command))))
+      goto continuation;
+
+    if (!(session= (replay_session *)
+          my_hash_search(&replay_sessions, (uchar *) &thread_id,
+                         sizeof(thread_id))))
+    {
+      session= (replay_session *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                            sizeof(replay_session),
+                                            MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+      session->thread_id= thread_id;
+      my_hash_insert(&replay_sessions, (uchar *) session);
+    }
+
+    entry= NULL;
+    if (is_prefix(command, "Query\t") || is_prefix(command, "Execute\t") ||
+        is_prefix(command, "Init DB\t"))
+    {
+      entry= (replay_entry *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                        sizeof(replay_entry),
+                                        MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+      entry->time= (ulonglong) (last_time - first_time);
+      entry->command= command[0] == 'I' ? REPLAY_INIT_DB : REPLAY_QUERY;
+      entry->string= pos + 1;
+      entry->length= (size_t) (eol - entry->string);
+      if (session->last)
+        session->last->next= entry;
+      else
+        session->first= entry;
+      session->last= entry;
+    }
+    else if (is_prefix(command, "Connect\t") && !session->first)
+    {
+      /* user@host [as anonymous] on db using protocol */
+      char save= *eol, *db, *db_end;
+      *eol= 0;
+      if ((db= strstr(pos + 1, " on ")) && (db_end= strstr(db + 4, " using")) &&
+          db_end > db + 4)
+      {
+        my_free(session->db);
+        session->db= my_strndup(PSI_NOT_INSTRUMENTED, db + 4,
+                                (size_t) (db_end - db - 4),
+                                MYF(MY_FAE|MY_WME));
+      }
+      *eol= save;
+    }
+    continue;
+
+continuation:
+    /* A multi-line statement; the lines are adjacent in the buffer */
+    if (entry)
+      entry->length= (size_t) (eol - entry->string);
+  }
+
+  return buffer;
+}
+
+
+/**
+  Compute the digest text of a statement: white space is folded into one
+  space, every number and string literal is replaced by '?' and a list of
+  literals is folded into one '?'.
+*/
+static size_t replay_digest_text(const char *query, size_t length,
+                                 char *to, size_t to_length)
+{
+  const char *end= query + length;
+  char *pos= to, *to_end= to + to_length;
+  CHARSET_INFO *cs= &my_charset_latin1;
+
+  while (query < end && pos < to_end)
+  {
+    char c= *query;
+    my_bool literal= FALSE;
+
+    if (my_isspace(cs, c))
+    {
+      while (query < end && my_isspace(cs, *query))
+        query++;
+      if (pos > to && pos[-1] != ' ')
+        *pos++= ' ';
+      continue;
+    }
+    if (c == '\'' || c == '"')
+    {
+      for (query++; query < end; query++)
+      {
+        if (*query == '\\' && query + 1 < end)
+          query++;
+        else if (*query == c)
+        {
+          if (query + 1 < end && query[1] == c)
+            query++;
+          else
+            break;
+        }
+      }
+      query++;
+      literal= TRUE;
+    }
+    else if (my_isdigit(cs, c) && (pos == to || !my_isvar(cs, pos[-1])))
+    {
+      while (query < end && (my_isalnum(cs, *query) || *query == '.'))
+        query++;
+      literal= TRUE;
+    }
+
+    if (literal)
+    {
+      /* Fold "?, ?" into "?" */
+      char *prev= pos > to && pos[-1] == ' ' ? pos - 1 : pos;
+      if (prev - to >= 2 && prev[-1] == ',' && prev[-2] == '?')
+        pos= prev - 1;
+      else
+        *pos++= '?';
+      continue;
+    }
+    *pos++= c;
+    query++;
+  }
+
+  if (pos > to && pos[-1] == ' ')
+    pos--;
+  return (size_t) (pos - to);
+}
+
+
+static void replay_record(const char *query, size_t length,
+                          ulonglong latency, my_bool error)
+{
+  char text[REPLAY_DIGEST_LENGTH];
+  size_t text_length= replay_digest_text(query, length, text, sizeof(text));
+  replay_digest *digest;
+
+  pthread_mutex_lock(&replay_mutex);
+  if (!(digest= (replay_digest *) my_hash_search(&replay_digests,
+                                                 (uchar *) text,
+                                                 text_length)))
+  {
+    digest= (replay_digest *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                        sizeof(replay_digest) + text_length,
+                                        MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+    digest->text= (char *) (digest + 1);
+    digest->length= text_length;
+    memcpy(digest->text, text, text_length);
+    my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &digest->latencies,
+                          sizeof(ulonglong), 64, 64, MYF(0));
+    my_hash_insert(&replay_digests, (uchar *) digest);
+  }
+  if (error)
+    digest->errors++;
+  else
+  {
+    insert_dynamic(&digest->latencies, &latency);
+    digest->total+= latency;
+  }
+  pthread_mutex_unlock(&replay_mutex);
+}
+
+
+pthread_handler_t run_replay_session(void *p)
+{
+  replay_session *session= (replay_session *) p;
+  replay_entry *entry;
+  MYSQL *mysql;
+  MYSQL_RES *result;
+  my_bool connected= FALSE;
+  DBUG_ENTER("run_replay_session");
+
+  if (mysql_thread_init())
+  {
+    fprintf(stderr,"%s: mysql_thread_init() failed\n", my_progname);
+    exit(0);
+  }
+
+  if (!(mysql= mysql_init(NULL)))
+  {
+    fprintf(stderr,"%s: mysql_init() failed\n", my_progname);
+    mysql_thread_end();
+    exit(0);
+  }
+
+  for (entry= session->first; entry; entry= entry->next)
+  {
+    ulonglong start;
+    int error;
+
+    if (replay_speed > 0)
+    {
+      ulonglong due= replay_start +
+        (ulonglong) ((double) entry->time * 1e9 / replay_speed);
+      ulonglong now= my_interval_timer();
+      if (due > now)
+        my_sleep((ulong) ((due - now) / 1000));
+    }
+
+    if (!connected && !opt_only_print)
+    {
+      if (slap_connect_db(mysql, session->db))
+        goto end;
+      connected= TRUE;
+    }
+
+    if (entry->command == REPLAY_INIT_DB)
+    {
+      char *db= my_strndup(PSI_NOT_INSTRUMENTED, entry->string, entry->length,
+                           MYF(MY_FAE|MY_WME));
+      if (!opt_only_print && mysql_select_db(mysql, db))
+        fprintf(stderr,"%s: Cannot select database %s ERROR : %s\n",
+                my_progname, db, mysql_error(mysql));
+      my_free(db);
+      continue;
+    }
+
+    start= my_interval_timer();
+    if (!(error= run_query(mysql, entry->string, entry->length)) &&
+        !opt_only_print)
+    {
+      do
+      {
+        if ((result= mysql_store_result(mysql)))
+          mysql_free_result(result);
+      } while (!(error= mysql_next_result(mysql)));
+      error= error > 0;
+    }
+    if (error && verbose >= 1)
+      fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
+              my_progname, (uint) entry->length, entry->string,
+              mysql_error(mysql));
+    replay_record(entry->string, entry->length,
+                  (my_interval_timer() - start) / 1000, error != 0);
+  }
+
+end:
+  mysql_close(mysql);
+
+  mysql_thread_end();
+
+  pthread_mutex_lock(&counter_mutex);
+  thread_counter--;
+  pthread_cond_signal(&count_threshhold);
+  pthread_mutex_unlock(&counter_mutex);
+
+  DBUG_RETURN(0);
+}
+
+
+static int compare_latency(const void *a, const void *b)
+{
+  ulonglong x= *(const ulonglong *) a, y= *(const ulonglong *) b;
+  return x < y ? -1 : x > y;
+}
+
+
+static int compare_digest_total(const void *a, const void *b)
+{
+  ulonglong x= (*(const replay_digest **) a)->total;
+  ulonglong y= (*(const replay_digest **) b)->total;
+  return x > y ? -1 : x < y;
+}
+
+
+/** Nearest-rank percentile of sorted latencies, in milliseconds */
+static double replay_percentile(const ulonglong *latencies, size_t count,
+                                uint percent)
+{
+  size_t rank;
+  if (!count)
+    return 0.0;
+  rank= (count * percent + 99) / 100;
+  return (double) latencies[rank ? rank - 1 : 0] / 1000.0;
+}
+
+
+static void print_replay_report(ulonglong elapsed)
+{
+  replay_digest **digests;
+  ulonglong *all;
+  size_t all_count= 0;
+  ulonglong statements= 0, errors= 0;
+  ulong i;
+
+  digests= (replay_digest **) my_malloc(PSI_NOT_INSTRUMENTED,
+                                        sizeof(replay_digest *) *
+                                        (replay_digests.records + 1),
+                                        MYF(MY_FAE|MY_WME));
+  for (i= 0; i < replay_digests.records; i++)
+  {
+    replay_digest *digest= (replay_digest *) my_hash_element(&replay_digests,
+                                                             i);
+    digests[i]= digest;
+    sort_dynamic(&digest->latencies, compare_latency);
+    statements+= digest->latencies.elements + digest->errors;
+    errors+= digest->errors;
+    all_count+= digest->latencies.elements;
+  }
+
+  /* The latencies of all statements, for the overall percentiles */
+  all= (ulonglong *) my_malloc(PSI_NOT_INSTRUMENTED,
+                               sizeof(ulonglong) * (all_count + 1),
+                               MYF(MY_FAE|MY_WME));
+  for (i= 0, all_count= 0; i < replay_digests.records; i++)
+  {
+    memcpy(all + all_count, digests[i]->latencies.buffer,
+           sizeof(ulonglong) * digests[i]->latencies.elements);
+    all_count+= digests[i]->latencies.elements;
+  }
+  my_qsort(all, all_count, sizeof(ulonglong), compare_latency);
+  my_qsort(digests, replay_digests.records, sizeof(replay_digest *),
+           compare_digest_total);
+
+  printf("Replay\n");
+  printf("\tNumber of sessions: %lu\n", (ulong) replay_sessions.records);
+  printf("\tNumber of statements: %llu (%llu failed)\n", statements, errors);
+  printf("\tNumber of seconds to run all statements: %llu.%03llu seconds\n",
+         elapsed / 1000000000, elapsed / 1000000 % 1000);
+  printf("\tStatements per second: %.1f\n",
+         elapsed ? (double) statements * 1e9 / (double) elapsed : 0.0);
+  printf("\tLatency: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+         replay_percentile(all, all_count, 50),
+         replay_percentile(all, all_count, 95),
+         replay_percentile(all, all_count, 99),
+         replay_percentile(all, all_count, 100));
+  printf("\n%10s %8s %10s %9s %9s %9s %9s %9s  %s\n", "Count", "Errors",
+         "Total(s)", "Avg(ms)", "p50(ms)", "p95(ms)", "p99(ms)", "Max(ms)",
+         "Digest");
+  for (i= 0; i < replay_digests.records; i++)
+  {
+    replay_digest *digest= digests[i];
+    const ulonglong *latencies= (ulonglong *) digest->latencies.buffer;
+    size_t count= digest->latencies.elements;
+    printf("%10lu %8llu %10.3f %9.3f %9.3f %9.3f %9.3f %9.3f  %.*s\n",
+           (ulong) count, digest->errors, (double) digest->total / 1e6,
+           count ? (double) digest->total / 1000.0 / (double) count : 0.0,
+           replay_percentile(latencies, count, 50),
+           replay_percentile(latencies, count, 95),
+           replay_percentile(latencies, count, 99),
+           replay_percentile(latencies, count, 100),
+           (int) digest->length, digest->text);
+  }
+  printf("\n");
+
+  my_free(all);
+  my_free(digests);
+}
+
+
+static int run_replay(void)
+{
+  char *buffer;
+  pthread_t mainthread;            /* Thread descriptor */
+  pthread_attr_t attr;          /* Thread attributes */
+  ulong i;
+  DBUG_ENTER("run_replay");
+
+  if (my_hash_init(PSI_NOT_INSTRUMENTED, &replay_sessions, &my_charset_bin,
+                   64, offsetof(replay_session, thread_id), sizeof(ulonglong),
+                   0, free_replay_session, 0) ||
+      my_hash_init(PSI_NOT_INSTRUMENTED, &replay_digests, &my_charset_bin,
+                   64, 0, 0, get_replay_digest_key, free_replay_digest, 0))
+    DBUG_RETURN(1);
+
+  if (!(buffer= parse_replay_log(opt_replay_file)))
+  {
+    my_hash_free(&replay_sessions);
+    my_hash_free(&replay_digests);
+    DBUG_RETURN(1);
+  }
+
+  if (verbose >= 2)
+    printf("Replaying %lu sessions\n", (ulong) replay_sessions.records);
+
+  pthread_mutex_init(&replay_mutex, NULL);
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr,
+		  PTHREAD_CREATE_DETACHED);
+
+  replay_start= my_interval_timer();
+  pthread_mutex_lock(&counter_mutex);
+  thread_counter= 0;
+  for (i= 0; i < replay_sessions.records; i++)
+  {
+    if (pthread_create(&mainthread, &attr, run_replay_session,
+                       my_hash_element(&replay_sessions, i)) != 0)
+    {
+      fprintf(stderr,"%s: Could not create thread\n",
+              my_progname);
+      exit(0);
+    }
+    thread_counter++;
+  }
+  pthread_mutex_unlock(&counter_mutex);
+  pthread_attr_destroy(&attr);
+
+  /*
+    We loop until we know that all children have cleaned up.
+  */
+  pthread_mutex_lock(&counter_mutex);
+  while (thread_counter)
+  {
+    struct timespec abstime;
+
+    set_timespec(abstime, 3);
+    pthread_cond_timedwait(&count_threshhold, &counter_mutex, &abstime);
+  }
+  pthread_mutex_unlock(&counter_mutex);
+
+  if (!opt_silent)
+    print_replay_report(my_interval_timer() - replay_start);
+
+  pthread_mutex_destroy(&replay_mutex);
+  my_hash_free(&replay_digests);
+  my_hash_free(&replay_sessions);
+  my_free(buffer);
+
+  DBUG_RETURN(0);
+}
@@ -0,0 +1,48 @@
+# Copyright (c) 2021, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335 USA
+
+# Detect liburing, for the io_uring based tpool::aio implementation.
+# WITH_URING=AUTO (default) uses liburing if it is found,
+# WITH_URING=ON requires it and WITH_URING=OFF disables it.
+
+SET(WITH_URING "AUTO" CACHE STRING "Use io_uring for asynchronous I/O (AUTO, ON or OFF)")
+
+INCLUDE(CheckSymbolExists)
+
+MACRO (MYSQL_CHECK_URING)
+  STRING(TOLOWER "${WITH_URING}" WITH_URING_LOWERCASE)
+
+  IF(WITH_URING AND CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    IF(WITH_URING_LOWERCASE STREQUAL "auto")
+      FIND_PACKAGE(URING QUIET)
+    ELSE()
+      FIND_PACKAGE(URING REQUIRED)
+    ENDIF()
+    IF(URING_FOUND)
+      ADD_DEFINITIONS(-DHAVE_URING=1)
+      INCLUDE_DIRECTORIES(${URING_INCLUDE_DIRS})
+      LINK_LIBRARIES(${URING_LIBRARIES})
+      SET(CMAKE_REQUIRED_INCLUDES ${URING_INCLUDE_DIRS})
+      SET(CMAKE_REQUIRED_LIBRARIES ${URING_LIBRARIES})
+      CHECK_SYMBOL_EXISTS(io_uring_register_buffers_sparse liburing.h
+                          HAVE_URING_BUFFERS_UPDATE)
+      UNSET(CMAKE_REQUIRED_INCLUDES)
+      UNSET(CMAKE_REQUIRED_LIBRARIES)
+      IF(HAVE_URING_BUFFERS_UPDATE)
+        ADD_DEFINITIONS(-DHAVE_URING_BUFFERS_UPDATE=1)
+      ENDIF()
+    ENDIF()
+  ENDIF()
+ENDMACRO()
@@ -0,0 +1,66 @@
+# Copyright (c) 2021, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA
+
+# MYSQL_CHECK_ZSTD
+#
+# Looks for the zstd library that is used for the compressed client/server
+# protocol. Sets HAVE_ZSTD and ZSTD_LIBRARY if it is found.
+
+MACRO (MYSQL_CHECK_ZSTD)
+
+  STRING(TOLOWER "${WITH_ZSTD}" WITH_ZSTD_LOWERCASE)
+
+  IF(NOT WITH_ZSTD)
+    MESSAGE_ONCE(zstd "WITH_ZSTD=OFF: zstd protocol compression disabled")
+
+  ELSEIF(NOT WITH_ZSTD_LOWERCASE STREQUAL "auto" AND NOT WITH_ZSTD_LOWERCASE STREQUAL "on")
+    MESSAGE(FATAL_ERROR "Wrong value for WITH_ZSTD")
+
+  ELSE()
+    FIND_PACKAGE(ZSTD QUIET)
+    IF(ZSTD_FOUND)
+      SET(SAVE_CMAKE_REQUIRED_INCLUDES ${CMAKE_REQUIRED_INCLUDES})
+      SET(SAVE_CMAKE_REQUIRED_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES})
+      SET(CMAKE_REQUIRED_INCLUDES ${CMAKE_REQUIRED_INCLUDES} ${ZSTD_INCLUDE_DIR})
+      SET(CMAKE_REQUIRED_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES} ${ZSTD_LIBRARIES})
+      # ZSTD_compressStream2() and the parameter API are stable since 1.4.0
+      CHECK_C_SOURCE_COMPILES(
+      "
+      #include <zstd.h>
+      int main()
+      {
+        ZSTD_CCtx *cctx= ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, 3);
+        return ZSTD_freeCCtx(cctx) != 0 || ZSTD_compressStream2 == 0;
+      }"
+      HAVE_ZSTD)
+      SET(CMAKE_REQUIRED_INCLUDES ${SAVE_CMAKE_REQUIRED_INCLUDES})
+      SET(CMAKE_REQUIRED_LIBRARIES ${SAVE_CMAKE_REQUIRED_LIBRARIES})
+    ENDIF()
+
+    IF(HAVE_ZSTD)
+      ADD_DEFINITIONS(-DHAVE_ZSTD=1)
+      INCLUDE_DIRECTORIES(SYSTEM ${ZSTD_INCLUDE_DIR})
+      SET(ZSTD_LIBRARY ${ZSTD_LIBRARIES})
+      MESSAGE_ONCE(zstd "zstd protocol compression enabled")
+    ELSEIF(WITH_ZSTD_LOWERCASE STREQUAL "auto")
+      MESSAGE_ONCE(zstd "WITH_ZSTD=AUTO: zstd protocol compression disabled")
+    ELSE()
+      UNSET(WITH_ZSTD CACHE)
+      MESSAGE(FATAL_ERROR "WITH_ZSTD=ON: Could not find zstd 1.4.0 or later")
+    ENDIF()
+  ENDIF()
+
+ENDMACRO()
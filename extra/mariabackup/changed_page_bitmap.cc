@@ -728,6 +728,20 @@ xb_page_bitmap_init(void)
 		return NULL;
 	}
 
+	/* The run must not start after the incremental backup LSN, which
+	it would after the server was killed while tracking changed pages. */
+	if (UNIV_UNLIKELY(mach_read_from_8(page + MODIFIED_PAGE_START_LSN)
+			  > bmp_start_lsn)) {
+
+		xb_msg_missing_lsn_data(bmp_start_lsn,
+					mach_read_from_8(
+						page + MODIFIED_PAGE_START_LSN));
+		rbt_free(result);
+		free(bitmap_files.files);
+		os_file_close(bitmap_file.file);
+		return NULL;
+	}
+
 	/* 1st bitmap page found, add it to the tree.  */
 	rbt_insert(result, page, page);
 
@@ -812,6 +826,22 @@ xb_page_bitmap_init(void)
 			return NULL;
 		}
 
+		/* A new run must start where the previous run ended */
+		if (UNIV_UNLIKELY(last_page_in_run
+				  && mach_read_from_8(
+					  page + MODIFIED_PAGE_START_LSN)
+				  > current_page_end_lsn)) {
+
+			xb_msg_missing_lsn_data(current_page_end_lsn,
+						mach_read_from_8(
+							page
+							+ MODIFIED_PAGE_START_LSN));
+			rbt_free(result);
+			free(bitmap_files.files);
+			os_file_close(bitmap_file.file);
+			return NULL;
+		}
+
 		/* Merge the current page with an existing page or insert a new
 		page into the tree */
 
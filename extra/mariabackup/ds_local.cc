@@ -34,6 +34,8 @@ typedef struct {
 	my_bool is_ibd;
 	my_bool compressed;
 	size_t pagesize;
+	/* current offset in the file */
+	my_off_t offset;
 } ds_local_file_t;
 
 static ds_ctxt_t *local_init(const char *root);
@@ -120,6 +122,7 @@ local_open(ds_ctxt_t *ctxt, const char *path,
 	local_file->is_ibd = (path_len > 5) && !strcmp(fullpath + path_len - 5, ".ibd");
 	local_file->compressed = 0;
 	local_file->pagesize = 0;
+	local_file->offset = 0;
 	file->path = (char *) local_file + sizeof(ds_local_file_t);
 	memcpy(file->path, fullpath, path_len);
 
@@ -146,9 +149,7 @@ static int write_compressed(File fd,  uchar *data, size_t len, size_t pagesize)
 		size_t n_bytes =  MY_MIN(pagesize, len - written);
 		size_t datasize= trim_binary_zeros(ptr,n_bytes);
 		if (datasize > 0) {
-			if (!my_write(fd, ptr, datasize, MYF(MY_WME | MY_NABP)))
-				posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
-			else
+			if (my_write(fd, ptr, datasize, MYF(MY_WME | MY_NABP)))
 				return 1;
 		}
 		if (datasize < n_bytes) {
@@ -209,15 +210,17 @@ local_write(ds_file_t *file, const uchar *buf, size_t len)
 		local_file->init_ibd_done= 1;
 	}
 
-	if (local_file->compressed) {
-		return write_compressed(fd, b, len, local_file->pagesize);
+	if (local_file->compressed
+	    ? write_compressed(fd, b, len, local_file->pagesize)
+	    : my_write(fd, b , len, MYF(MY_WME | MY_NABP))) {
+		return 1;
 	}
 
-	if (!my_write(fd, b , len, MYF(MY_WME | MY_NABP))) {
-		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
-		return 0;
-	}
-	return 1;
+	/* Drop the written data from the page cache. Advising on the
+	whole file would scan all its cached pages on every write. */
+	posix_fadvise(fd, local_file->offset, len, POSIX_FADV_DONTNEED);
+	local_file->offset += len;
+	return 0;
 }
 
 /* Set EOF at file's current position.*/
@@ -336,8 +336,9 @@ static bool page_is_corrupted(const byte *page, ulint page_no,
 
 	if (page_type == FIL_PAGE_PAGE_COMPRESSED
 	    || page_type == FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED) {
-		ulint decomp = fil_page_decompress(tmp_frame, tmp_page,
-						   space->flags);
+		ulint decomp = fil_page_decompress(
+			tmp_frame, tmp_page, space->flags,
+			space->zstd_dict.load(std::memory_order_acquire));
 		page_type = fil_page_get_type(tmp_page);
 
 		return (!decomp
@@ -81,9 +81,17 @@ typedef struct {
 typedef struct {
 	char 		*path;
 	uint		pathlen;
+	/* offset of the next chunk to read; protected by
+	extract_ctxt_t::mutex */
+	my_off_t	read_offset;
+	/* offset of the next chunk to write; protected by mutex */
 	my_off_t	offset;
+	/* whether writing a chunk failed; protected by mutex */
+	my_bool		failed;
 	ds_file_t	*file;
 	pthread_mutex_t	mutex;
+	/* broadcast when offset or failed changes */
+	pthread_cond_t	cond;
 } file_entry_t;
 
 static int get_options(int *argc, char ***argv);
@@ -344,6 +352,7 @@ file_entry_new(extract_ctxt_t *ctxt, const char *path, uint pathlen)
 	entry->file = file;
 
 	pthread_mutex_init(&entry->mutex, NULL);
+	pthread_cond_init(&entry->cond, NULL);
 
 	return entry;
 
@@ -369,12 +378,48 @@ static
 void
 file_entry_free(file_entry_t *entry)
 {
+	pthread_cond_destroy(&entry->cond);
 	pthread_mutex_destroy(&entry->mutex);
 	ds_close(entry->file);
 	my_free(entry->path);
 	my_free(entry);
 }
 
+/* Wait until the chunks of the file before offset have been written.
+@return whether writing a preceding chunk failed */
+static
+my_bool
+file_entry_wait(file_entry_t *entry, my_off_t offset)
+{
+	pthread_mutex_lock(&entry->mutex);
+	while (!entry->failed && entry->offset != offset) {
+		pthread_cond_wait(&entry->cond, &entry->mutex);
+	}
+	my_bool failed = entry->failed;
+	pthread_mutex_unlock(&entry->mutex);
+	return failed;
+}
+
+/* Note that the chunk of the file at the write offset was written, or that
+writing it failed. */
+static
+void
+file_entry_written(file_entry_t *entry, size_t length, my_bool failed)
+{
+	pthread_mutex_lock(&entry->mutex);
+	if (failed) {
+		entry->failed = TRUE;
+	} else {
+		entry->offset += length;
+	}
+	pthread_cond_broadcast(&entry->cond);
+	pthread_mutex_unlock(&entry->mutex);
+}
+
+/* Extraction worker. The stream is read under ctxt->mutex, but the chunks
+are validated and written without holding it, so that the other workers
+can read and write chunks of other files meanwhile. The chunks of one file
+are written in the order of their offsets. */
 static
 void *
 extract_worker_thread_func(void *arg)
@@ -382,6 +427,7 @@ extract_worker_thread_func(void *arg)
 	xb_rstream_chunk_t	chunk;
 	file_entry_t		*entry;
 	xb_rstream_result_t	res;
+	my_off_t		offset;
 
 	extract_ctxt_t *ctxt = (extract_ctxt_t *) arg;
 
@@ -417,55 +463,70 @@ extract_worker_thread_func(void *arg)
 					       chunk.pathlen);
 			if (entry == NULL) {
 				pthread_mutex_unlock(ctxt->mutex);
+				res = XB_STREAM_READ_ERROR;
 				break;
 			}
 			if (my_hash_insert(ctxt->filehash, (uchar *) entry)) {
 				msg("%s: my_hash_insert() failed.",
 				    my_progname);
 				pthread_mutex_unlock(ctxt->mutex);
+				res = XB_STREAM_READ_ERROR;
 				break;
 			}
 		}
 
-		pthread_mutex_lock(&entry->mutex);
+		offset = entry->read_offset;
 
-		pthread_mutex_unlock(ctxt->mutex);
+		if (chunk.type == XB_CHUNK_TYPE_EOF) {
+			/* Close the file after its last chunk was written.
+			The stream has no chunks of the file after this one. */
+			pthread_mutex_unlock(ctxt->mutex);
 
-		res = xb_stream_validate_checksum(&chunk);
+			my_bool failed = file_entry_wait(entry, offset);
 
-		if (res != XB_STREAM_READ_CHUNK) {
-			pthread_mutex_unlock(&entry->mutex);
-			break;
-		}
-
-		if (chunk.type == XB_CHUNK_TYPE_EOF) {
 			pthread_mutex_lock(ctxt->mutex);
-			pthread_mutex_unlock(&entry->mutex);
 			my_hash_delete(ctxt->filehash, (uchar *) entry);
 			pthread_mutex_unlock(ctxt->mutex);
 
+			if (failed) {
+				res = XB_STREAM_READ_ERROR;
+				break;
+			}
 			continue;
 		}
 
-		if (entry->offset != chunk.offset) {
+		if (offset != chunk.offset) {
 			msg("%s: out-of-order chunk: real offset = 0x%llx, "
 			    "expected offset = 0x%llx", my_progname,
-			    chunk.offset, entry->offset);
-			pthread_mutex_unlock(&entry->mutex);
+			    chunk.offset, offset);
+			pthread_mutex_unlock(ctxt->mutex);
+			res = XB_STREAM_READ_ERROR;
+			break;
+		}
+
+		entry->read_offset += chunk.length;
+
+		pthread_mutex_unlock(ctxt->mutex);
+
+		res = xb_stream_validate_checksum(&chunk);
+
+		if (file_entry_wait(entry, offset)) {
 			res = XB_STREAM_READ_ERROR;
+		}
+
+		if (res != XB_STREAM_READ_CHUNK) {
+			file_entry_written(entry, chunk.length, TRUE);
 			break;
 		}
 
 		if (ds_write(entry->file, chunk.data, chunk.length)) {
 			msg("%s: my_write() failed.", my_progname);
-			pthread_mutex_unlock(&entry->mutex);
+			file_entry_written(entry, chunk.length, TRUE);
 			res = XB_STREAM_READ_ERROR;
 			break;
 		}
 
-		entry->offset += chunk.length;
-
-		pthread_mutex_unlock(&entry->mutex);
+		file_entry_written(entry, chunk.length, FALSE);
 	}
 
 	if (chunk.data)
@@ -77,6 +77,7 @@ Street, Fifth Floor, Boston, MA 02110-1335 USA
 #include <list>
 #include <sstream>
 #include <set>
+#include <vector>
 #include <fstream>
 #include <mysql.h>
 
@@ -1427,7 +1428,8 @@ struct my_option xb_server_options[] =
    (G_PTR*) &opt_mysql_tmpdir,
    (G_PTR*) &opt_mysql_tmpdir, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"parallel", OPT_XTRA_PARALLEL,
-   "Number of threads to use for parallel datafiles transfer. "
+   "Number of threads to use for parallel datafiles transfer, and "
+   "for applying delta files and redo log in --prepare. "
    "The default value is 1.",
    (G_PTR*) &xtrabackup_parallel, (G_PTR*) &xtrabackup_parallel, 0, GET_INT,
    REQUIRED_ARG, 1, 1, INT_MAX, 0, 0, 0},
@@ -4412,6 +4414,15 @@ static bool xtrabackup_backup_func()
 	if (!flush_changed_page_bitmaps()) {
 		goto fail;
 	}
+
+	if (xtrabackup_incremental && have_changed_page_bitmaps
+	    && !xtrabackup_incremental_force_scan) {
+		changed_page_bitmap = xb_page_bitmap_init();
+		if (!changed_page_bitmap) {
+			msg("mariabackup: using the full scan for incremental "
+			    "backup");
+		}
+	}
 	debug_sync_point("xtrabackup_suspend_at_start");
 
 
@@ -5464,15 +5475,135 @@ static ibool xb_process_datadir(const char *path, const char *suffix,
 	return(TRUE);
 }
 
+/* ======== Delta applying thread context ======== */
+
+/** A .delta file found by xb_process_datadir() */
+struct xb_delta_file_t
+{
+	/** database name, or empty for the system tablespace files */
+	std::string	dbname;
+	/** file name, including the .delta extension */
+	std::string	filename;
+};
+
+/** State shared by the delta_apply_thread_func() threads */
+struct delta_apply_ctxt_t
+{
+	/** the .delta files to apply */
+	std::vector<xb_delta_file_t>	files;
+	/** index of the next file in files to apply */
+	size_t				next;
+	/** number of running threads */
+	uint				count;
+	/** whether all the applied files succeeded */
+	bool				ok;
+	/** protects next, count, ok */
+	pthread_mutex_t			mutex;
+	/** signalled when count reaches 0 */
+	pthread_cond_t			done;
+};
+
+/************************************************************************
+Callback of xb_process_datadir() that remembers a .delta file.
+@return TRUE always */
+static
+ibool
+xb_collect_delta(
+	const char*	/*dirname*/,
+	const char*	dbname,
+	const char*	filename,
+	void*		data)
+{
+	static_cast<std::vector<xb_delta_file_t>*>(data)->push_back(
+		xb_delta_file_t{dbname ? dbname : "", filename});
+	return TRUE;
+}
+
 /************************************************************************
-Applies all .delta files from incremental_dir to the full backup.
+Delta applying thread. Each .delta file is applied by one thread only;
+the files of different tablespaces are applied concurrently. */
+static
+os_thread_ret_t
+DECLARE_THREAD(delta_apply_thread_func)(
+	void *arg) /* thread context */
+{
+	delta_apply_ctxt_t	*ctxt = static_cast<delta_apply_ctxt_t*>(arg);
+
+	my_thread_init();
+
+	for (;;) {
+		pthread_mutex_lock(&ctxt->mutex);
+		if (!ctxt->ok || ctxt->next == ctxt->files.size()) {
+			break;
+		}
+		const xb_delta_file_t& f = ctxt->files[ctxt->next++];
+		pthread_mutex_unlock(&ctxt->mutex);
+
+		if (!xtrabackup_apply_delta(
+			    xtrabackup_incremental_dir,
+			    f.dbname.empty() ? NULL : f.dbname.c_str(),
+			    f.filename.c_str(), NULL)) {
+			pthread_mutex_lock(&ctxt->mutex);
+			ctxt->ok = false;
+			pthread_mutex_unlock(&ctxt->mutex);
+		}
+	}
+
+	if (!--ctxt->count) {
+		pthread_cond_signal(&ctxt->done);
+	}
+	pthread_mutex_unlock(&ctxt->mutex);
+
+	my_thread_end();
+	os_thread_exit();
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/************************************************************************
+Applies all .delta files from incremental_dir to the full backup,
+using --parallel threads.
 @return TRUE on success. */
 static
 ibool
 xtrabackup_apply_deltas()
 {
-	return xb_process_datadir(xtrabackup_incremental_dir, ".delta",
-		xtrabackup_apply_delta);
+	delta_apply_ctxt_t	ctxt;
+
+	if (!xb_process_datadir(xtrabackup_incremental_dir, ".delta",
+				xb_collect_delta, &ctxt.files)) {
+		return FALSE;
+	}
+
+	ctxt.next = 0;
+	ctxt.ok = true;
+	ctxt.count = uint(std::min<size_t>(std::max(xtrabackup_parallel, 1),
+					   ctxt.files.size()));
+
+	if (!ctxt.count) {
+		return TRUE;
+	}
+
+	if (ctxt.count > 1) {
+		msg("mariabackup: Starting %u threads for applying "
+		    "delta files", ctxt.count);
+	}
+
+	pthread_mutex_init(&ctxt.mutex, NULL);
+	pthread_cond_init(&ctxt.done, NULL);
+
+	pthread_mutex_lock(&ctxt.mutex);
+	for (uint i = ctxt.count; i--; ) {
+		os_thread_create(delta_apply_thread_func, &ctxt);
+	}
+	while (ctxt.count) {
+		pthread_cond_wait(&ctxt.done, &ctxt.mutex);
+	}
+	pthread_mutex_unlock(&ctxt.mutex);
+
+	pthread_cond_destroy(&ctxt.done);
+	pthread_mutex_destroy(&ctxt.mutex);
+
+	return ctxt.ok;
 }
 
 
@@ -5725,6 +5856,13 @@ static bool xtrabackup_prepare_func(char** argv)
 		srv_n_write_io_threads = 4;
 	}
 
+	/* recv_sys_t::apply() recovers pages on up to
+	srv_n_read_io_threads tasks; use --parallel of them. */
+	if (srv_n_read_io_threads < uint(xtrabackup_parallel)) {
+		srv_n_read_io_threads = std::min(uint(xtrabackup_parallel),
+						 64U);
+	}
+
 	msg("Starting InnoDB instance for recovery.");
 
 	msg("mariabackup: Using %lld bytes for buffer pool "
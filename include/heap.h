@@ -109,6 +109,12 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+typedef struct st_hp_blob_desc		/* BLOB column of a record */
+{
+  uint offset;				/* Offset of the length in record */
+  uint packlength;			/* Bytes used for the length */
+} HP_BLOB_DESC;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -134,6 +140,7 @@ typedef struct st_heap_share
 {
   HP_BLOCK block;
   HP_KEYDEF  *keydef;
+  HP_BLOB_DESC *blob_descs;		/* BLOB columns (only internal tables) */
   ulonglong data_length,index_length,max_table_size;
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
@@ -147,6 +154,7 @@ typedef struct st_heap_share
   uint visible;                         /* Offset to the visible/deleted mark */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;				/* Number of BLOB columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
@@ -173,6 +181,7 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar **blob_ptrs;                     /* BLOB copies, see hp_copy_blobs() */
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -192,6 +201,8 @@ typedef struct st_heap_create_info
   uint auto_key_type;
   uint keys;
   uint reclength;
+  uint blobs;				/* Number of BLOB columns */
+  HP_BLOB_DESC *blob_descs;
   ulong max_records;
   ulong min_records;
   ulonglong max_table_size;
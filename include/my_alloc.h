@@ -24,6 +24,8 @@
 
 #define ALLOC_MAX_BLOCK_TO_DROP			4096
 #define ALLOC_MAX_BLOCK_USAGE_BEFORE_DROP	10
+/* Number of blocks that free_root(MY_RECYCLE_BLOCKS) keeps */
+#define ALLOC_ROOT_RECYCLE_BLOCKS		4
 
 #ifdef __cplusplus
 extern "C" {
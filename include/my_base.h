@@ -219,7 +219,13 @@ enum ha_extra_function {
   /** Finish writing rows during ALTER TABLE...ALGORITHM=COPY. */
   HA_EXTRA_END_ALTER_COPY,
   /** Fake the start of a statement after wsrep_load_data_splitting hack */
-  HA_EXTRA_FAKE_START_STMT
+  HA_EXTRA_FAKE_START_STMT,
+  /**
+    A table scan of the handler will start soon. Used by
+    ha_partition::rnd_next() to let the engine read the first pages of
+    the next partition in the background.
+  */
+  HA_EXTRA_PREFETCH_SCAN
 };
 
 /* Compatible option, to be deleted in 6.0 */
@@ -128,6 +128,7 @@ C_MODE_START
 	/* root_alloc flags */
 #define MY_KEEP_PREALLOC	1U
 #define MY_MARK_BLOCKS_FREE     2U /* move used to free list and reuse them */
+#define MY_RECYCLE_BLOCKS       4U /* keep a few blocks for the next use */
 
 	/* Internal error numbers (for assembler functions) */
 #define MY_ERRNO_EDOM		33
@@ -179,8 +180,10 @@ extern BOOL my_obtain_privilege(LPCSTR lpPrivilege);
 void my_init_atomic_write(void);
 #ifdef __linux__
 my_bool my_test_if_atomic_write(File handle, int pagesize);
+my_bool my_test_if_fs_atomic_write(File handle, int pagesize);
 #else
 #define my_test_if_atomic_write(A, B) 0
+#define my_test_if_fs_atomic_write(A, B) 0
 #endif /* __linux__ */
 extern my_bool my_may_have_atomic_write;
 
@@ -246,6 +249,7 @@ extern const char *my_collation_get_tailoring(uint id);
 /* statistics */
 extern ulong    my_stream_opened, my_tmp_file_created;
 extern ulong    my_file_total_opened;
+extern int64    my_mem_root_recycled_blocks;
 extern ulong    my_sync_count;
 extern uint	mysys_usage_id;
 extern int32    my_file_opened;
@@ -774,6 +778,8 @@ extern my_bool radixsort_is_appliccable(uint n_items, size_t size_of_element);
 extern void my_string_ptr_sort(uchar *base,uint items,size_t size);
 extern void radixsort_for_str_ptr(uchar* base[], uint number_of_elements,
 				  size_t size_of_element,uchar *buffer[]);
+extern void radixsort_msd_for_str_ptr(uchar* base[], uint number_of_elements,
+				      size_t size_of_element,uchar *buffer[]);
 extern qsort_t my_qsort(void *base_ptr, size_t total_elems, size_t size,
                         qsort_cmp cmp);
 extern qsort_t my_qsort2(void *base_ptr, size_t total_elems, size_t size,
@@ -905,10 +911,26 @@ extern void *my_az_allocator(void *dummy, unsigned int items, unsigned int size)
 extern void my_az_free(void *dummy, void *address);
 extern int my_compress_buffer(uchar *dest, size_t *destLen,
                               const uchar *source, size_t sourceLen);
+#ifdef HAVE_ZSTD
+typedef struct st_my_zstd_stream MY_ZSTD_STREAM;
+extern MY_ZSTD_STREAM *my_zstd_stream_init(int level);
+extern void my_zstd_stream_end(MY_ZSTD_STREAM *stream);
+extern size_t my_zstd_compress_bound(size_t len);
+extern my_bool my_zstd_compress(MY_ZSTD_STREAM *stream, uchar *dst,
+                                size_t *dst_len, const uchar *src, size_t len);
+extern my_bool my_zstd_uncompress(MY_ZSTD_STREAM *stream, uchar *packet,
+                                  size_t len, size_t *complen);
+extern my_bool my_zstd_compress_buffer(uchar *dst, size_t *dst_len,
+                                       const uchar *src, size_t len,
+                                       int level);
+extern my_bool my_zstd_uncompress_buffer(uchar *dst, size_t *dst_len,
+                                         const uchar *src, size_t len);
+#endif
 extern int packfrm(const uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
 extern uint32 my_checksum(uint32, const void *, size_t);
+extern uint32 my_checksum_combine(uint32, uint32, size_t);
 extern uint32 my_crc32c(uint32, const void *, size_t);
 
 extern const char *my_crc32c_implementation();
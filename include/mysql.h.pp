@@ -59,6 +59,7 @@ typedef struct st_net {
   char last_error[512];
   char sqlstate[5 +1];
   void *extension;
+  void *compress_stream;
 } NET;
 enum enum_field_types { MYSQL_TYPE_DECIMAL, MYSQL_TYPE_TINY,
    MYSQL_TYPE_SHORT, MYSQL_TYPE_LONG,
@@ -119,10 +120,13 @@ extern "C" {
 my_bool my_net_init(NET *net, Vio* vio, void *thd, unsigned int my_flags);
 void my_net_local_init(NET *net);
 void net_end(NET *net);
+my_bool net_enable_zstd_compression(NET *net, int level);
 void net_clear(NET *net, my_bool clear_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool net_flush(NET *net);
 my_bool my_net_write(NET *net,const unsigned char *packet, size_t len);
+unsigned char *net_reserve_packet(NET *net, size_t *length);
+void net_write_reserved(NET *net, size_t len);
 my_bool net_write_command(NET *net,unsigned char command,
      const unsigned char *header, size_t head_len,
      const unsigned char *packet, size_t len);
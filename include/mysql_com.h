@@ -308,12 +308,21 @@ enum enum_indicator_type
 /* Do not resend metadata for prepared statements, since 10.6*/
 #define MARIADB_CLIENT_CACHE_METADATA (1ULL << 36)
 
+/* CLIENT_COMPRESS uses streaming zstd instead of zlib */
+#define MARIADB_CLIENT_ZSTD_COMPRESSION (1ULL << 37)
+
 #ifdef HAVE_COMPRESS
 #define CAN_CLIENT_COMPRESS CLIENT_COMPRESS
 #else
 #define CAN_CLIENT_COMPRESS 0
 #endif
 
+#if defined(HAVE_COMPRESS) && defined(HAVE_ZSTD)
+#define CAN_CLIENT_ZSTD_COMPRESS MARIADB_CLIENT_ZSTD_COMPRESSION
+#else
+#define CAN_CLIENT_ZSTD_COMPRESS 0ULL
+#endif
+
 /*
   Gather all possible capabilities (flags) supported by the server
 
@@ -349,15 +358,17 @@ enum enum_indicator_type
                            MARIADB_CLIENT_STMT_BULK_OPERATIONS |\
                            MARIADB_CLIENT_EXTENDED_METADATA|\
                            MARIADB_CLIENT_CACHE_METADATA |\
+                           MARIADB_CLIENT_ZSTD_COMPRESSION |\
                            CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS)
 /*
   Switch off the flags that are optional and depending on build flags
   If any of the optional flags is supported by the build it will be switched
   on before sending to the client during the connection handshake.
 */
-#define CLIENT_BASIC_FLAGS (((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
+#define CLIENT_BASIC_FLAGS ((((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
                                                & ~CLIENT_COMPRESS) \
-                                               & ~CLIENT_SSL_VERIFY_SERVER_CERT)
+                                               & ~CLIENT_SSL_VERIFY_SERVER_CERT) \
+                                               & ~MARIADB_CLIENT_ZSTD_COMPRESSION)
 
 enum mariadb_field_attr_t
 {
@@ -494,6 +505,8 @@ typedef struct st_net {
   /** Client library sqlstate buffer. Set along with the error message. */
   char sqlstate[SQLSTATE_LENGTH+1];
   void *extension;
+  /* Compression contexts for compress == NET_COMPRESS_ZSTD */
+  void *compress_stream;
 } NET;
 
 
@@ -647,10 +660,13 @@ extern "C" {
 my_bool	my_net_init(NET *net, Vio* vio, void *thd, unsigned int my_flags);
 void	my_net_local_init(NET *net);
 void	net_end(NET *net);
+my_bool	net_enable_zstd_compression(NET *net, int level);
 void	net_clear(NET *net, my_bool clear_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool	net_flush(NET *net);
 my_bool	my_net_write(NET *net,const unsigned char *packet, size_t len);
+unsigned char *net_reserve_packet(NET *net, size_t *length);
+void	net_write_reserved(NET *net, size_t len);
 my_bool	net_write_command(NET *net,unsigned char command,
 			  const unsigned char *header, size_t head_len,
 			  const unsigned char *packet, size_t len);
@@ -714,6 +730,12 @@ typedef struct st_udf_init
 #define NET_HEADER_SIZE 4		/* standard header size */
 #define COMP_HEADER_SIZE 3		/* compression header extra size */
 
+  /*
+    Values of NET::compress: 1 is zlib, 2 is zlib without compressing the
+    packets that are being sent (used for error packets)
+  */
+#define NET_COMPRESS_ZSTD 3		/* zstd stream, see my_zstd.c */
+
   /* Prototypes to password functions */
 
 #ifdef __cplusplus
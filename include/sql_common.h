@@ -41,6 +41,8 @@ struct st_mysql_options_extention {
                           uint proc_info_length);
   HASH connection_attributes;
   size_t connection_attributes_length;
+  /* The server offered zstd protocol compression */
+  my_bool zstd_compression;
 };
 
 typedef struct st_mysql_methods
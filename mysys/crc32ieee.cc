@@ -61,3 +61,54 @@ extern "C" unsigned int my_checksum(unsigned int crc, const void *data, size_t l
 #endif
 
 
+/* The CRC-32 polynomial, bit reversed */
+#define CRC32_POLY 0xedb88320U
+
+/* Multiply a and b modulo the CRC-32 polynomial */
+static uint32 crc32_multmodp(uint32 a, uint32 b)
+{
+  uint32 m= 1U << 31, p= 0;
+  for (;;)
+  {
+    if (a & m)
+    {
+      p^= b;
+      if (!(a & (m - 1)))
+        break;
+    }
+    m>>= 1;
+    b= b & 1 ? (b >> 1) ^ CRC32_POLY : b >> 1;
+  }
+  return p;
+}
+
+/* x^(2^k) modulo the CRC-32 polynomial, for k= 0..31 */
+static const uint32 crc32_x2n_table[32]=
+{
+  0x40000000, 0x20000000, 0x08000000, 0x00800000,
+  0x00008000, 0xedb88320, 0xb1e6b092, 0xa06a2517,
+  0xed627dae, 0x88d14467, 0xd7bbfe6a, 0xec447f11,
+  0x8e7ea170, 0x6427800e, 0x4d47bae0, 0x09fe548f,
+  0x83852d0f, 0x30362f1a, 0x7b5a9cc3, 0x31fec169,
+  0x9fec022a, 0x6c8dedc4, 0x15d6874d, 0x5fde7a4e,
+  0xbad90e37, 0x2e4e5eef, 0x4eaba214, 0xa8a472c0,
+  0x429a969e, 0x148d302a, 0xc40ba6d0, 0xc4e22c3c
+};
+
+/**
+  Compute the checksum of the concatenation of two buffers from the
+  checksums of the buffers, in O(log(len2)) time.
+
+  @param crc1  my_checksum() of the first buffer
+  @param crc2  my_checksum() of the second buffer
+  @param len2  length of the second buffer
+*/
+extern "C" uint32 my_checksum_combine(uint32 crc1, uint32 crc2, size_t len2)
+{
+  uint32 p= 1U << 31;                           /* x^0 */
+  /* Multiply by x^(8 * len2), that is, append len2 zero bytes */
+  for (uint k= 3; len2; len2>>= 1, k++)
+    if (len2 & 1)
+      p= crc32_multmodp(crc32_x2n_table[k & 31], p);
+  return crc32_multmodp(p, crc1) ^ crc2;
+}
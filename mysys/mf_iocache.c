@@ -577,6 +577,36 @@ int _my_b_write(IO_CACHE *info, const uchar *Buffer, size_t Count)
   return res;
 }
 
+/*
+  Let the kernel read the block that follows the one that was just read
+  into the cache, so that the next refill of a sequential reader finds it
+  in the file system cache instead of waiting for the disk.
+
+  SYNOPSIS
+    io_cache_read_ahead()
+      info                      IO_CACHE pointer
+      pos                       Offset of the next block in the file
+
+  NOTE
+    The kernel read-ahead alone does not help when several caches read
+    different parts of the same file, such as the merge passes of
+    filesort and Unique, or when the reads are not aligned.
+*/
+
+static void io_cache_read_ahead(IO_CACHE *info, my_off_t pos)
+{
+#ifdef POSIX_FADV_WILLNEED
+  if (info->type == READ_CACHE && pos < info->end_of_file)
+    (void) posix_fadvise(info->file, (off_t) pos,
+                         (off_t) MY_MIN((my_off_t) info->read_length,
+                                        info->end_of_file - pos),
+                         POSIX_FADV_WILLNEED);
+#else
+  (void) info;
+  (void) pos;
+#endif
+}
+
 /*
   Read buffered.
 
@@ -769,6 +799,8 @@ int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
   info->read_pos=info->buffer+Count;
   info->read_end=info->buffer+length;
   info->pos_in_file=pos_in_file;
+  if (length)
+    io_cache_read_ahead(info, pos_in_file + length);
   if (Count)
     memcpy(Buffer, info->buffer, Count);
   DBUG_RETURN(0);
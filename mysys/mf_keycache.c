@@ -153,6 +153,13 @@ typedef struct st_keycache_wqueue
 /* Default size of hash for changed files */
 #define MIN_CHANGED_BLOCKS_HASH_SIZE 128
 
+/*
+  Reads of at most this many bytes from a cache block are copied while
+  holding cache_lock. For a cache hit, releasing and reacquiring the
+  lock around such a copy costs more than the copy itself.
+*/
+#define KEYCACHE_MAX_LOCKED_COPY 1024
+
 /* Control block for a simple (non-partitioned) key cache */
 
 typedef struct st_simple_key_cache_cb
@@ -2900,15 +2907,19 @@ uchar *simple_key_cache_read(SIMPLE_KEY_CACHE_CB *keycache,
         {
           DBUG_ASSERT(block->status & (BLOCK_READ | BLOCK_IN_USE));
 #if !defined(SERIALIZED_READ_FROM_CACHE)
-          keycache_pthread_mutex_unlock(&keycache->cache_lock);
-#endif
-
+          if (read_length <= KEYCACHE_MAX_LOCKED_COPY)
+            memcpy(buff, block->buffer+offset, (size_t) read_length);
+          else
+          {
+            keycache_pthread_mutex_unlock(&keycache->cache_lock);
+            /* Copy data from the cache buffer */
+            memcpy(buff, block->buffer+offset, (size_t) read_length);
+            keycache_pthread_mutex_lock(&keycache->cache_lock);
+            DBUG_ASSERT(block->status & (BLOCK_READ | BLOCK_IN_USE));
+          }
+#else
           /* Copy data from the cache buffer */
           memcpy(buff, block->buffer+offset, (size_t) read_length);
-
-#if !defined(SERIALIZED_READ_FROM_CACHE)
-          keycache_pthread_mutex_lock(&keycache->cache_lock);
-          DBUG_ASSERT(block->status & (BLOCK_READ | BLOCK_IN_USE));
 #endif
         }
       }
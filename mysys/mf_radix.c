@@ -58,3 +58,104 @@ void radixsort_for_str_ptr(uchar **base, uint number_of_elements, size_t size_of
   next:;
   }
 }
+
+
+/*
+  MSD radix sort for pointers to fixed length, memcmp() comparable strings.
+
+  Unlike radixsort_for_str_ptr(), this only looks at as many leading bytes
+  as are needed to tell the strings apart, so it handles long strings with
+  common prefixes well. Small groups are sorted with insertion sort, and
+  groups whose first RADIX_MSD_MAX_DEPTH bytes are equal are sorted with
+  my_qsort2() on the remaining bytes.
+*/
+
+#define RADIX_MSD_MAX_DEPTH 32
+#define RADIX_MSD_SMALL 32
+
+struct radix_msd_tail
+{
+  size_t offset;
+  size_t length;
+};
+
+static int radix_msd_cmp_tail(const void *arg, const void *a, const void *b)
+{
+  const struct radix_msd_tail *tail= (const struct radix_msd_tail*) arg;
+  return memcmp(*(const uchar**) a + tail->offset,
+                *(const uchar**) b + tail->offset, tail->length);
+}
+
+static void radix_msd_insertion_sort(uchar **base, uint n,
+                                     size_t offset, size_t length)
+{
+  uchar **i, **j, **end= base + n;
+  for (i= base + 1; i < end; i++)
+  {
+    uchar *key= *i;
+    for (j= i; j > base && memcmp(j[-1] + offset, key + offset, length) > 0;
+         j--)
+      *j= j[-1];
+    *j= key;
+  }
+}
+
+static void radix_msd_sort(uchar **base, uint n, size_t size, size_t depth,
+                           uchar **buffer)
+{
+  uint32 count[256];
+  uchar **ptr, **end;
+  uint i, start, bucket;
+
+  for (;;)
+  {
+    if (depth >= size)
+      return;
+    if (n < RADIX_MSD_SMALL)
+    {
+      radix_msd_insertion_sort(base, n, depth, size - depth);
+      return;
+    }
+    if (depth >= RADIX_MSD_MAX_DEPTH)
+    {
+      struct radix_msd_tail tail;
+      tail.offset= depth;
+      tail.length= size - depth;
+      my_qsort2(base, n, sizeof(uchar*), radix_msd_cmp_tail, &tail);
+      return;
+    }
+
+    end= base + n;
+    bzero((uchar*) count, sizeof(count));
+    for (ptr= base; ptr < end; ptr++)
+      count[ptr[0][depth]]++;
+
+    if (count[base[0][depth]] != n)
+      break;
+    /* All strings share this byte; look at the next one. */
+    depth++;
+  }
+
+  /* Turn the counts into bucket end offsets and distribute. */
+  for (i= 1; i < 256; i++)
+    count[i]+= count[i - 1];
+  for (ptr= end; ptr-- != base;)
+    buffer[--count[ptr[0][depth]]]= *ptr;
+  memcpy(base, buffer, n * sizeof(uchar*));
+
+  /* count[i] is now the start offset of bucket i. */
+  for (i= 0; i < 256; i++)
+  {
+    start= count[i];
+    bucket= (i == 255 ? n : count[i + 1]) - start;
+    if (bucket > 1)
+      radix_msd_sort(base + start, bucket, size, depth + 1, buffer);
+  }
+}
+
+void radixsort_msd_for_str_ptr(uchar **base, uint number_of_elements,
+                               size_t size_of_element, uchar **buffer)
+{
+  if (number_of_elements > 1)
+    radix_msd_sort(base, number_of_elements, size_of_element, 0, buffer);
+}
@@ -20,6 +20,7 @@
 #include <my_global.h>
 #include <my_sys.h>
 #include <m_string.h>
+#include <my_atomic.h>
 #undef EXTRA_DEBUG
 #define EXTRA_DEBUG
 
@@ -364,6 +365,28 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 #endif
 
 
+/**
+  Keep a block instead of freeing it, if it has the initial block size
+  and not too many blocks were kept yet. The next statement that uses
+  the root will then find the block in the free list instead of
+  allocating it again.
+*/
+
+static inline my_bool recycle_block(MEM_ROOT *root, USED_MEM *block,
+                                    USED_MEM **recycled, uint *n_recycled)
+{
+  if (*n_recycled >= ALLOC_ROOT_RECYCLE_BLOCKS ||
+      block->size != (root->block_size & ~1))
+    return FALSE;
+  block->next= *recycled;
+  block->left= block->size - ALIGN_SIZE(sizeof(USED_MEM));
+  TRASH_MEM(block);
+  *recycled= block;
+  (*n_recycled)++;
+  return TRUE;
+}
+
+
 /*
   Deallocate everything used by alloc_root or just move
   used blocks to free list if called with MY_USED_TO_FREE
@@ -376,6 +399,8 @@ static inline void mark_blocks_free(MEM_ROOT* root)
         MY_MARK_BLOCKS_FREED	Don't free blocks, just mark them free
         MY_KEEP_PREALLOC	If this is not set, then free also the
         		        preallocated block
+        MY_RECYCLE_BLOCKS	Keep up to ALLOC_ROOT_RECYCLE_BLOCKS blocks
+                                of the initial block size in the free list
 
   NOTES
     One can call this function either with root block initialised with
@@ -386,6 +411,8 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 void free_root(MEM_ROOT *root, myf MyFlags)
 {
   reg1 USED_MEM *next,*old;
+  USED_MEM *recycled= 0;
+  uint n_recycled= 0;
   DBUG_ENTER("free_root");
   DBUG_PRINT("enter",("root: %p  flags: %lu", root, MyFlags));
 
@@ -399,6 +426,9 @@ void free_root(MEM_ROOT *root, myf MyFlags)
     mark_blocks_free(root);
     DBUG_VOID_RETURN;
   }
+#else
+  /* Every allocation is a block of its own; do not keep any */
+  MyFlags&= ~MY_RECYCLE_BLOCKS;
 #endif
   if (!(MyFlags & MY_KEEP_PREALLOC))
     root->pre_alloc=0;
@@ -406,23 +436,31 @@ void free_root(MEM_ROOT *root, myf MyFlags)
   for (next=root->used; next ;)
   {
     old=next; next= next->next ;
-    if (old != root->pre_alloc)
+    if (old != root->pre_alloc &&
+        !((MyFlags & MY_RECYCLE_BLOCKS) &&
+          recycle_block(root, old, &recycled, &n_recycled)))
       my_free(old);
   }
   for (next=root->free ; next ;)
   {
     old=next; next= next->next;
-    if (old != root->pre_alloc)
+    if (old != root->pre_alloc &&
+        !((MyFlags & MY_RECYCLE_BLOCKS) &&
+          recycle_block(root, old, &recycled, &n_recycled)))
       my_free(old);
   }
-  root->used=root->free=0;
+  root->used=0;
+  root->free=recycled;
   if (root->pre_alloc)
   {
     root->free=root->pre_alloc;
     root->free->left=root->pre_alloc->size-ALIGN_SIZE(sizeof(USED_MEM));
     TRASH_MEM(root->pre_alloc);
-    root->free->next=0;
+    root->free->next=recycled;
   }
+  if (n_recycled)
+    my_atomic_add64_explicit(&my_mem_root_recycled_blocks, n_recycled,
+                             MY_MEMORY_ORDER_RELAXED);
   root->block_num= 4;
   root->first_block_usage= 0;
   DBUG_VOID_RETURN;
@@ -358,6 +358,66 @@ static my_bool sfx_has_atomic_write(File file, int page_size)
   }
   return 0;
 }
+/***********************************************************************
+  Kernel and file system atomic writes
+************************************************************************/
+
+#include <sys/vfs.h>
+#include <linux/fs.h>
+
+#ifndef BTRFS_SUPER_MAGIC
+#define BTRFS_SUPER_MAGIC 0x9123683E
+#endif
+#define ZFS_SUPER_MAGIC 0x2fc12fc1
+
+/**
+  Check if a write of page_size bytes is atomic because the kernel
+  reports a large enough atomic write unit for the file (NVMe AWUPF and
+  similar), or because the file is on a copy-on-write file system that
+  never overwrites a record in place.
+
+  @param[in] file              OS file handle
+  @param[in] page_size         page size
+  @return TRUE                 Atomic write supported
+*/
+
+my_bool my_test_if_fs_atomic_write(File file, int page_size)
+{
+  struct statfs fs_buff;
+#ifdef STATX_WRITE_ATOMIC
+  struct statx stx;
+
+  if (!statx(file, "", AT_EMPTY_PATH, STATX_WRITE_ATOMIC, &stx) &&
+      (stx.stx_mask & STATX_WRITE_ATOMIC) &&
+      (stx.stx_attributes & STATX_ATTR_WRITE_ATOMIC) &&
+      stx.stx_atomic_write_unit_min <= (uint) page_size &&
+      stx.stx_atomic_write_unit_max >= (uint) page_size)
+    return 1;
+#endif
+
+  if (fstatfs(file, &fs_buff) < 0)
+    return 0;
+
+  switch ((ulong) fs_buff.f_type) {
+  case ZFS_SUPER_MAGIC:
+  {
+    /* A ZFS record is written atomically if it contains whole pages */
+    struct stat stat_buff;
+    return !fstat(file, &stat_buff) &&
+      stat_buff.st_blksize >= page_size &&
+      !(stat_buff.st_blksize % page_size);
+  }
+  case BTRFS_SUPER_MAGIC:
+  {
+    /* Files with the NOCOW attribute are overwritten in place */
+    int flags;
+    return !ioctl(file, FS_IOC_GETFLAGS, &flags) && !(flags & FS_NOCOW_FL);
+  }
+  }
+  return 0;
+}
+
+
 /***********************************************************************
   Generic atomic write code
 ************************************************************************/
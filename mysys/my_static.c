@@ -63,6 +63,7 @@ char		curr_dir[FN_REFLEN]= {0},
 		home_dir_buff[FN_REFLEN]= {0};
 ulong		my_stream_opened=0,my_tmp_file_created=0;
 ulong           my_file_total_opened= 0;
+int64           my_mem_root_recycled_blocks= 0;
 int		my_umask=0664, my_umask_dir=0777;
 #ifdef _WIN32
 SECURITY_ATTRIBUTES my_dir_security_attributes= {sizeof(SECURITY_ATTRIBUTES),NULL,FALSE};
@@ -0,0 +1,253 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Streaming zstd compression of the client/server protocol.
+
+  Unlike my_compress(), which compresses every packet on its own, all
+  packets of a connection are compressed with the same compression
+  context, and every packet ends with a zstd flush. The peer decompresses
+  them in the same order with one decompression context, so later packets
+  can refer to the data of the earlier ones.
+
+  A packet that was passed to my_zstd_compress() must be sent compressed
+  even if it did not get shorter, because the peer must see it to keep its
+  window in sync.
+*/
+
+#include <mysys_priv.h>
+#include <my_sys.h>
+#include <zstd.h>
+
+/*
+  The window is kept small, because there is one compression and one
+  decompression context for every connection, and most packets are small.
+*/
+#define MY_ZSTD_WINDOW_LOG 17
+
+struct st_my_zstd_stream
+{
+  ZSTD_CCtx *cctx;
+  ZSTD_DCtx *dctx;
+};
+
+
+/*
+  Create the compression and decompression contexts of a connection
+
+  SYNOPSIS
+    my_zstd_stream_init()
+    level       Compression level
+
+  RETURN
+    0    Out of memory or invalid level
+    #    The contexts
+*/
+
+MY_ZSTD_STREAM *my_zstd_stream_init(int level)
+{
+  MY_ZSTD_STREAM *stream;
+  DBUG_ENTER("my_zstd_stream_init");
+
+  if (!(stream= (MY_ZSTD_STREAM*) my_malloc(key_memory_my_compress_alloc,
+                                            sizeof(*stream),
+                                            MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(0);
+
+  if (!(stream->cctx= ZSTD_createCCtx()) ||
+      !(stream->dctx= ZSTD_createDCtx()) ||
+      ZSTD_isError(ZSTD_CCtx_setParameter(stream->cctx,
+                                          ZSTD_c_compressionLevel, level)) ||
+      ZSTD_isError(ZSTD_CCtx_setParameter(stream->cctx, ZSTD_c_windowLog,
+                                          MY_ZSTD_WINDOW_LOG)))
+  {
+    my_zstd_stream_end(stream);
+    DBUG_RETURN(0);
+  }
+  DBUG_RETURN(stream);
+}
+
+
+void my_zstd_stream_end(MY_ZSTD_STREAM *stream)
+{
+  if (!stream)
+    return;
+  ZSTD_freeCCtx(stream->cctx);
+  ZSTD_freeDCtx(stream->dctx);
+  my_free(stream);
+}
+
+
+/* Size of the buffer that my_zstd_compress() needs for len bytes */
+
+size_t my_zstd_compress_bound(size_t len)
+{
+  return ZSTD_compressBound(len);
+}
+
+
+/*
+  Compress one packet
+
+  SYNOPSIS
+    my_zstd_compress()
+    stream      Contexts of the connection
+    dst         Buffer for the compressed data
+    dst_len     in: size of dst, at least my_zstd_compress_bound(len)
+                out: length of the compressed data
+    src         Data to compress
+    len         Length of data to compress
+
+  RETURN
+    1   error
+    0   ok
+*/
+
+my_bool my_zstd_compress(MY_ZSTD_STREAM *stream, uchar *dst, size_t *dst_len,
+                         const uchar *src, size_t len)
+{
+  ZSTD_inBuffer in= { src, len, 0 };
+  ZSTD_outBuffer out= { dst, *dst_len, 0 };
+  size_t res;
+  DBUG_ENTER("my_zstd_compress");
+
+  res= ZSTD_compressStream2(stream->cctx, &out, &in, ZSTD_e_flush);
+  if (ZSTD_isError(res) || res != 0 || in.pos != len)
+  {
+    DBUG_PRINT("error", ("Can't compress packet: %s",
+                         ZSTD_isError(res) ? ZSTD_getErrorName(res)
+                                           : "buffer too small"));
+    DBUG_RETURN(1);
+  }
+  *dst_len= out.pos;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Uncompress packet
+
+  SYNOPSIS
+    my_zstd_uncompress()
+    stream      Contexts of the connection
+    packet      Compressed data. This is is replaced with the original data.
+    len         Length of compressed data
+    complen     Length of the original data, 0 if the packet was not
+                compressed
+
+  RETURN
+    1   error
+    0   ok.  In this case 'complen' contains the updated size of the
+             real data.
+*/
+
+my_bool my_zstd_uncompress(MY_ZSTD_STREAM *stream, uchar *packet, size_t len,
+                           size_t *complen)
+{
+  DBUG_ENTER("my_zstd_uncompress");
+
+  if (*complen)                                 /* If compressed */
+  {
+    uchar *compbuf= (uchar *) my_malloc(key_memory_my_compress_alloc,
+                                        *complen, MYF(MY_WME));
+    ZSTD_inBuffer in= { packet, len, 0 };
+    ZSTD_outBuffer out;
+    if (!compbuf)
+      DBUG_RETURN(1);                           /* Not enough memory */
+
+    out.dst= compbuf;
+    out.size= *complen;
+    out.pos= 0;
+    while (in.pos < in.size)
+    {
+      size_t in_pos= in.pos, out_pos= out.pos;
+      size_t res= ZSTD_decompressStream(stream->dctx, &out, &in);
+      if (ZSTD_isError(res) || (in.pos == in_pos && out.pos == out_pos))
+      {                                         /* Probably wrong packet */
+        DBUG_PRINT("error", ("Can't uncompress packet: %s",
+                             ZSTD_isError(res) ? ZSTD_getErrorName(res)
+                                               : "no progress"));
+        my_free(compbuf);
+        DBUG_RETURN(1);
+      }
+    }
+    if (out.pos != *complen)
+    {
+      DBUG_PRINT("error", ("Wrong uncompressed length: %zu", out.pos));
+      my_free(compbuf);
+      DBUG_RETURN(1);
+    }
+    memcpy(packet, compbuf, *complen);
+    my_free(compbuf);
+  }
+  else
+    *complen= len;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Compress a buffer on its own, without a stream
+
+  SYNOPSIS
+    my_zstd_compress_buffer()
+    dst         Buffer for the compressed data
+    dst_len     in: size of dst, at least my_zstd_compress_bound(len)
+                out: length of the compressed data
+    src         Data to compress
+    len         Length of data to compress
+    level       Compression level
+
+  RETURN
+    1   error
+    0   ok
+*/
+
+my_bool my_zstd_compress_buffer(uchar *dst, size_t *dst_len,
+                                const uchar *src, size_t len, int level)
+{
+  size_t res= ZSTD_compress(dst, *dst_len, src, len, level);
+  if (ZSTD_isError(res))
+    return 1;
+  *dst_len= res;
+  return 0;
+}
+
+
+/*
+  Uncompress a buffer that was compressed by my_zstd_compress_buffer()
+
+  SYNOPSIS
+    my_zstd_uncompress_buffer()
+    dst         Buffer for the original data
+    dst_len     in: size of dst
+                out: length of the original data
+    src         Compressed data
+    len         Length of the compressed data
+
+  RETURN
+    1   error
+    0   ok
+*/
+
+my_bool my_zstd_uncompress_buffer(uchar *dst, size_t *dst_len,
+                                  const uchar *src, size_t len)
+{
+  size_t res= ZSTD_decompress(dst, *dst_len, src, len);
+  if (ZSTD_isError(res))
+    return 1;
+  *dst_len= res;
+  return 0;
+}
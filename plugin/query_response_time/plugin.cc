@@ -18,12 +18,14 @@
 #include <sql_class.h>
 #include <sql_i_s.h>
 #include <sql_show.h>
+#include <sql_parse.h>
 #include <mysql/plugin_audit.h>
 #include "query_response_time.h"
 
 
 ulong opt_query_response_time_range_base= QRT_DEFAULT_BASE;
 my_bool opt_query_response_time_stats= 0;
+ulong opt_query_response_time_group_by= QRT_GROUP_BY_NONE;
 static my_bool opt_query_response_time_flush= 0;
 
 
@@ -51,6 +53,18 @@ static MYSQL_SYSVAR_BOOL(flush, opt_query_response_time_flush,
        "Update of this variable flushes statistics and re-reads "
        "query_response_time_range_base",
        NULL, query_response_time_flush_update, FALSE);
+static const char *group_by_names[]= { "NONE", "SCHEMA", "USER", NullS };
+static TYPELIB group_by_typelib=
+{
+  array_elements(group_by_names) - 1, "group_by_typelib",
+  group_by_names, NULL
+};
+static MYSQL_SYSVAR_ENUM(group_by, opt_query_response_time_group_by,
+       PLUGIN_VAR_RQCMDARG,
+       "Also collect query response time statistics separately for every "
+       "SCHEMA or USER, shown in INFORMATION_SCHEMA."
+       "QUERY_RESPONSE_TIME_BY_GROUP. NONE disables this",
+       NULL, NULL, QRT_GROUP_BY_NONE, &group_by_typelib);
 #ifndef DBUG_OFF
 static MYSQL_THDVAR_ULONGLONG(exec_time_debug, PLUGIN_VAR_NOCMDOPT,
        "Pretend queries take this many microseconds. When 0 (the default) use "
@@ -64,6 +78,7 @@ static struct st_mysql_sys_var *query_response_time_info_vars[]=
   MYSQL_SYSVAR(range_base),
   MYSQL_SYSVAR(stats),
   MYSQL_SYSVAR(flush),
+  MYSQL_SYSVAR(group_by),
 #ifndef DBUG_OFF
   MYSQL_SYSVAR(exec_time_debug),
 #endif
@@ -81,6 +96,15 @@ ST_FIELD_INFO query_response_time_fields_info[] =
   CEnd()
 };
 
+ST_FIELD_INFO query_response_time_by_group_fields_info[] =
+{
+  Column("GROUP_NAME", Varchar(USERNAME_CHAR_LENGTH), NOT_NULL, "Group_name"),
+  Column("TIME",  Varchar(QRT_TIME_STRING_LENGTH), NOT_NULL, "Time"),
+  Column("COUNT", ULong(),                         NOT_NULL, "Count"),
+  Column("TOTAL", Varchar(QRT_TIME_STRING_LENGTH), NOT_NULL, "Total"),
+  CEnd()
+};
+
 } // namespace Show
 
 static int query_response_time_info_init(void *p)
@@ -94,6 +118,37 @@ static int query_response_time_info_init(void *p)
 }
 
 
+static int query_response_time_read_info_init(void *p)
+{
+  ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
+  i_s_query_response_time->fields_info= Show::query_response_time_fields_info;
+  i_s_query_response_time->fill_table= query_response_time_fill_read;
+  i_s_query_response_time->reset_table= query_response_time_flush;
+  return 0;
+}
+
+
+static int query_response_time_write_info_init(void *p)
+{
+  ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
+  i_s_query_response_time->fields_info= Show::query_response_time_fields_info;
+  i_s_query_response_time->fill_table= query_response_time_fill_write;
+  i_s_query_response_time->reset_table= query_response_time_flush;
+  return 0;
+}
+
+
+static int query_response_time_by_group_info_init(void *p)
+{
+  ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
+  i_s_query_response_time->fields_info=
+    Show::query_response_time_by_group_fields_info;
+  i_s_query_response_time->fill_table= query_response_time_fill_by_group;
+  i_s_query_response_time->reset_table= query_response_time_flush;
+  return 0;
+}
+
+
 static int query_response_time_info_deinit(void *arg __attribute__((unused)))
 {
   opt_query_response_time_stats= 0;
@@ -106,6 +161,21 @@ static struct st_mysql_information_schema query_response_time_info_descriptor=
 { MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
 
 
+/*
+  Statements that change data count as writes, SELECT and SHOW as reads.
+  Everything else, like SET, is only counted in QUERY_RESPONSE_TIME.
+*/
+static qrt_query_type query_type(const LEX *lex)
+{
+  if (sql_command_flags[lex->sql_command] & CF_CHANGES_DATA)
+    return QRT_WRITE;
+  if (lex->sql_command == SQLCOM_SELECT ||
+      (sql_command_flags[lex->sql_command] & CF_STATUS_COMMAND))
+    return QRT_READ;
+  return QRT_ANY;
+}
+
+
 static void query_response_time_audit_notify(MYSQL_THD thd,
                                              unsigned int event_class,
                                              const void *event)
@@ -116,13 +186,32 @@ static void query_response_time_audit_notify(MYSQL_THD thd,
   if (event_general->event_subclass == MYSQL_AUDIT_GENERAL_STATUS &&
       opt_query_response_time_stats)
   {
+    ulonglong query_time= thd->utime_after_query - thd->utime_after_lock;
+    const char *group= NULL;
+    size_t group_length= 0;
 #ifndef DBUG_OFF
     if (THDVAR(thd, exec_time_debug))
-      query_response_time_collect(thd->lex->sql_command != SQLCOM_SET_OPTION ?
-                                  THDVAR(thd, exec_time_debug) : 0);
-    else
+      query_time= thd->lex->sql_command != SQLCOM_SET_OPTION ?
+                  THDVAR(thd, exec_time_debug) : 0;
 #endif
-    query_response_time_collect(thd->utime_after_query - thd->utime_after_lock);
+    switch (opt_query_response_time_group_by) {
+    case QRT_GROUP_BY_SCHEMA:
+      if (thd->db.str)
+      {
+        group= thd->db.str;
+        group_length= thd->db.length;
+      }
+      break;
+    case QRT_GROUP_BY_USER:
+      if (thd->security_ctx->user)
+      {
+        group= thd->security_ctx->user;
+        group_length= strlen(group);
+      }
+      break;
+    }
+    query_response_time_collect(query_type(thd->lex), query_time,
+                                thd->thread_id, group, group_length);
   }
 }
 
@@ -150,6 +239,52 @@ maria_declare_plugin(query_response_time)
   "1.0",
   MariaDB_PLUGIN_MATURITY_STABLE
 },
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &query_response_time_info_descriptor,
+  "QUERY_RESPONSE_TIME_READ",
+  "Percona and Sergey Vojtovich",
+  "Query Response Time Distribution INFORMATION_SCHEMA Plugin, reads",
+  PLUGIN_LICENSE_GPL,
+  query_response_time_read_info_init,
+  NULL,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &query_response_time_info_descriptor,
+  "QUERY_RESPONSE_TIME_WRITE",
+  "Percona and Sergey Vojtovich",
+  "Query Response Time Distribution INFORMATION_SCHEMA Plugin, writes",
+  PLUGIN_LICENSE_GPL,
+  query_response_time_write_info_init,
+  NULL,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &query_response_time_info_descriptor,
+  "QUERY_RESPONSE_TIME_BY_GROUP",
+  "Percona and Sergey Vojtovich",
+  "Query Response Time Distribution INFORMATION_SCHEMA Plugin, "
+  "by schema or user",
+  PLUGIN_LICENSE_GPL,
+  query_response_time_by_group_info_init,
+  NULL,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+},
 {
   MYSQL_AUDIT_PLUGIN,
   &query_response_time_audit_descriptor,
@@ -6,7 +6,11 @@
 #include "table.h"
 #include "field.h"
 #include "sql_show.h"
+#include "hash.h"
 #include "query_response_time.h"
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 #define TIME_STRING_POSITIVE_POWER_LENGTH QRT_TIME_STRING_POSITIVE_POWER_LENGTH
 #define TIME_STRING_NEGATIVE_POWER_LENGTH 6
@@ -145,107 +149,250 @@ void print_time(char* buffer, std::size_t buffer_size, const char* format,
   my_snprintf(buffer, buffer_size, format, second, microsecond);
 }
 
+/*
+  Number of shards of the global counters. Queries that run on different
+  CPUs update different shards, so that the counters of a busy server do
+  not bounce between the caches of all CPUs.
+*/
+#define SHARD_COUNT 64
+
+/*
+  Maximum number of distinct schemas or users for which
+  query_response_time_group_by keeps a separate histogram.
+*/
+#define MAXIMUM_GROUP_COUNT 1024
+
+static inline uint shard_index(ulonglong thread_id)
+{
+#ifdef HAVE_SCHED_GETCPU
+  int cpu= sched_getcpu();
+  if (cpu >= 0)
+    return uint(cpu) % SHARD_COUNT;
+#endif
+  return uint(thread_id % SHARD_COUNT);
+}
+
+template <uint shard_count>
 class time_collector
 {
+  struct shard
+  {
+    Atomic_counter<uint32_t> m_count[OVERALL_POWER_COUNT + 1];
+    Atomic_counter<uint64_t> m_total[OVERALL_POWER_COUNT + 1];
+    /* Keep the counters of neighbour shards in different cache lines */
+    char m_pad[CPU_LEVEL1_DCACHE_LINESIZE];
+  };
   utility *m_utility;
-  Atomic_counter<uint32_t> m_count[OVERALL_POWER_COUNT + 1];
-  Atomic_counter<uint64_t> m_total[OVERALL_POWER_COUNT + 1];
+  shard m_shard[shard_count];
 
 public:
   time_collector(utility& u): m_utility(&u) { flush(); }
   ~time_collector() { }
-  uint32_t count(uint index) { return m_count[index]; }
-  uint64_t total(uint index) { return m_total[index]; }
+  uint32_t count(uint index)
+  {
+    uint32_t result= 0;
+    for (uint i= 0; i < shard_count; i++)
+      result+= m_shard[i].m_count[index];
+    return result;
+  }
+  uint64_t total(uint index)
+  {
+    uint64_t result= 0;
+    for (uint i= 0; i < shard_count; i++)
+      result+= m_shard[i].m_total[index];
+    return result;
+  }
   void flush()
   {
-    for (auto i= 0; i < OVERALL_POWER_COUNT + 1; i++)
+    for (uint s= 0; s < shard_count; s++)
     {
-      m_count[i]= 0;
-      m_total[i]= 0;
+      for (auto i= 0; i < OVERALL_POWER_COUNT + 1; i++)
+      {
+        m_shard[s].m_count[i]= 0;
+        m_shard[s].m_total[i]= 0;
+      }
     }
   }
-  void collect(uint64_t time)
+  void collect(uint shard_no, uint64_t time)
   {
     int i= 0;
     for(int count= m_utility->bound_count(); count > i; ++i)
     {
       if(m_utility->bound(i) > time)
       {
-        m_count[i]++;
-        m_total[i]+= time;
+        m_shard[shard_no].m_count[i]++;
+        m_shard[shard_no].m_total[i]+= time;
         break;
       }
     }
   }
 };
 
+/* Histogram of the queries of one schema or user */
+struct group
+{
+  time_collector<1> m_time;
+  size_t m_name_length;
+  char m_name[USERNAME_CHAR_LENGTH * SYSTEM_CHARSET_MBMAXLEN + 1];
+
+  group(utility& u, const char *name, size_t length) : m_time(u)
+  {
+    m_name_length= MY_MIN(length, sizeof(m_name) - 1);
+    memcpy(m_name, name, m_name_length);
+    m_name[m_name_length]= 0;
+  }
+};
+
+static uchar *group_get_key(const uchar *entry, size_t *length, my_bool)
+{
+  group *g= (group*) entry;
+  *length= g->m_name_length;
+  return (uchar*) g->m_name;
+}
+
+static void group_free(void *entry)
+{
+  delete static_cast<group*>(entry);
+}
+
+static
+int fill_row(THD *thd, TABLE *table, Field **fields, ulonglong bound,
+             bool overflow, ulonglong count, ulonglong total)
+{
+  char time_str[TIME_STRING_BUFFER_LENGTH];
+  char total_str[TOTAL_STRING_BUFFER_LENGTH];
+  if(overflow)
+  {
+    assert(sizeof(TIME_OVERFLOW) <= TIME_STRING_BUFFER_LENGTH);
+    assert(sizeof(TIME_OVERFLOW) <= TOTAL_STRING_BUFFER_LENGTH);
+    memcpy(time_str,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
+    memcpy(total_str,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
+  }
+  else
+  {
+    print_time(time_str, sizeof(time_str), TIME_STRING_FORMAT, bound);
+    print_time(total_str, sizeof(total_str), TOTAL_STRING_FORMAT, total);
+  }
+  fields[0]->store(time_str,strlen(time_str),system_charset_info);
+  fields[1]->store((longlong)count,true);
+  fields[2]->store(total_str,strlen(total_str),system_charset_info);
+  return schema_table_store_record(thd, table);
+}
+
 class collector
 {
 public:
-  collector() : m_time(m_utility)
+  collector() : m_time{ {m_utility}, {m_utility}, {m_utility} }
   {
     m_utility.setup(DEFAULT_BASE);
   }
 public:
+  void init()
+  {
+    mysql_rwlock_init(PSI_NOT_INSTRUMENTED, &m_groups_lock);
+    my_hash_init(PSI_NOT_INSTRUMENTED, &m_groups, &my_charset_bin, 32, 0, 0,
+                 group_get_key, group_free, 0);
+  }
+  void cleanup()
+  {
+    flush();
+    my_hash_free(&m_groups);
+    mysql_rwlock_destroy(&m_groups_lock);
+  }
   void flush()
   {
+    mysql_rwlock_wrlock(&m_groups_lock);
     m_utility.setup(opt_query_response_time_range_base);
-    m_time.flush();
+    for (uint type= 0; type < QRT_QUERY_TYPES; type++)
+      m_time[type].flush();
+    my_hash_reset(&m_groups);
+    mysql_rwlock_unlock(&m_groups_lock);
   }
-  int fill(THD* thd, TABLE_LIST *tables, COND *cond)
+  int fill(THD* thd, TABLE_LIST *tables, qrt_query_type type)
   {
     DBUG_ENTER("fill_schema_query_response_time");
     TABLE        *table= static_cast<TABLE*>(tables->table);
     Field        **fields= table->field;
     for(uint i= 0, count= bound_count() + 1 /* with overflow */; count > i; ++i)
     {
-      char time[TIME_STRING_BUFFER_LENGTH];
-      char total[TOTAL_STRING_BUFFER_LENGTH];
-      if(i == bound_count())
-      {
-        assert(sizeof(TIME_OVERFLOW) <= TIME_STRING_BUFFER_LENGTH);
-        assert(sizeof(TIME_OVERFLOW) <= TOTAL_STRING_BUFFER_LENGTH);
-        memcpy(time,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
-        memcpy(total,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
-      }
-      else
-      {
-        print_time(time, sizeof(time), TIME_STRING_FORMAT, this->bound(i));
-        print_time(total, sizeof(total), TOTAL_STRING_FORMAT, this->total(i));
-      }
-      fields[0]->store(time,strlen(time),system_charset_info);
-      fields[1]->store((longlong)this->count(i),true);
-      fields[2]->store(total,strlen(total),system_charset_info);
-      if (schema_table_store_record(thd, table))
-      {
+      if (fill_row(thd, table, fields, i < bound_count() ? bound(i) : 0,
+                   i == bound_count(), m_time[type].count(i),
+                   m_time[type].total(i)))
 	DBUG_RETURN(1);
-      }
     }
     DBUG_RETURN(0);
   }
-  void collect(ulonglong time)
+  int fill_groups(THD* thd, TABLE_LIST *tables)
   {
-    m_time.collect(time);
+    DBUG_ENTER("fill_schema_query_response_time_by_group");
+    TABLE        *table= static_cast<TABLE*>(tables->table);
+    Field        **fields= table->field;
+    int          res= 0;
+    mysql_rwlock_rdlock(&m_groups_lock);
+    for (ulong g= 0; !res && g < m_groups.records; g++)
+    {
+      group *entry= (group*) my_hash_element(&m_groups, g);
+      for(uint i= 0, count= bound_count() + 1; !res && count > i; ++i)
+      {
+        fields[0]->store(entry->m_name, entry->m_name_length,
+                         system_charset_info);
+        res= fill_row(thd, table, fields + 1,
+                      i < bound_count() ? bound(i) : 0, i == bound_count(),
+                      entry->m_time.count(i), entry->m_time.total(i));
+      }
+    }
+    mysql_rwlock_unlock(&m_groups_lock);
+    DBUG_RETURN(res);
   }
-  uint bound_count() const
+  void collect(qrt_query_type type, ulonglong time, ulonglong thread_id)
   {
-    return m_utility.bound_count();
+    uint shard_no= shard_index(thread_id);
+    m_time[QRT_ANY].collect(shard_no, time);
+    if (type != QRT_ANY)
+      m_time[type].collect(shard_no, time);
   }
-  ulonglong bound(uint index)
+  void collect_group(const char *name, size_t length, ulonglong time)
   {
-    return m_utility.bound(index);
+    mysql_rwlock_rdlock(&m_groups_lock);
+    group *entry= (group*) my_hash_search(&m_groups, (const uchar*) name,
+                                          length);
+    if (entry)
+    {
+      entry->m_time.collect(0, time);
+      mysql_rwlock_unlock(&m_groups_lock);
+      return;
+    }
+    mysql_rwlock_unlock(&m_groups_lock);
+
+    mysql_rwlock_wrlock(&m_groups_lock);
+    entry= (group*) my_hash_search(&m_groups, (const uchar*) name, length);
+    if (!entry && m_groups.records < MAXIMUM_GROUP_COUNT)
+    {
+      entry= new group(m_utility, name, length);
+      if (my_hash_insert(&m_groups, (uchar*) entry))
+      {
+        delete entry;
+        entry= NULL;
+      }
+    }
+    if (entry)
+      entry->m_time.collect(0, time);
+    mysql_rwlock_unlock(&m_groups_lock);
   }
-  ulonglong count(uint index)
+  uint bound_count() const
   {
-    return m_time.count(index);
+    return m_utility.bound_count();
   }
-  ulonglong total(uint index)
+  ulonglong bound(uint index)
   {
-    return m_time.total(index);
+    return m_utility.bound(index);
   }
 private:
   utility          m_utility;
-  time_collector   m_time;
+  time_collector<SHARD_COUNT> m_time[QRT_QUERY_TYPES];
+  /* Histograms by schema or user, protected by m_groups_lock */
+  HASH             m_groups;
+  mysql_rwlock_t   m_groups_lock;
 };
 
 static collector g_collector;
@@ -254,11 +401,12 @@ static collector g_collector;
 
 void query_response_time_init()
 {
+  query_response_time::g_collector.init();
 }
 
 void query_response_time_free()
 {
-  query_response_time::g_collector.flush();
+  query_response_time::g_collector.cleanup();
 }
 
 int query_response_time_flush()
@@ -266,13 +414,35 @@ int query_response_time_flush()
   query_response_time::g_collector.flush();
   return 0;
 }
-void query_response_time_collect(ulonglong query_time)
+
+void query_response_time_collect(qrt_query_type type, ulonglong query_time,
+                                 ulonglong thread_id,
+                                 const char *group, size_t group_length)
 {
-  query_response_time::g_collector.collect(query_time);
+  query_response_time::g_collector.collect(type, query_time, thread_id);
+  if (group)
+    query_response_time::g_collector.collect_group(group, group_length,
+                                                   query_time);
 }
 
 int query_response_time_fill(THD* thd, TABLE_LIST *tables, COND *cond)
 {
-  return query_response_time::g_collector.fill(thd,tables,cond);
+  return query_response_time::g_collector.fill(thd, tables, QRT_ANY);
+}
+
+int query_response_time_fill_read(THD* thd, TABLE_LIST *tables, COND *cond)
+{
+  return query_response_time::g_collector.fill(thd, tables, QRT_READ);
+}
+
+int query_response_time_fill_write(THD* thd, TABLE_LIST *tables, COND *cond)
+{
+  return query_response_time::g_collector.fill(thd, tables, QRT_WRITE);
+}
+
+int query_response_time_fill_by_group(THD* thd, TABLE_LIST *tables,
+                                      COND *cond)
+{
+  return query_response_time::g_collector.fill_groups(thd, tables);
 }
 #endif // HAVE_RESPONSE_TIME_DISTRIBUTION
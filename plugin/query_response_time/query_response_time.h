@@ -51,17 +51,37 @@
   MY_MAX( (QRT_TOTAL_STRING_POSITIVE_POWER_LENGTH + 1 /* '.' */ + 6 /*QRT_TOTAL_STRING_NEGATIVE_POWER_LENGTH*/), \
        (sizeof(QRT_TIME_OVERFLOW) - 1) )
 
+/*
+  Statement types with a separate histogram. Every query is counted in
+  the QRT_ANY histogram, reads and writes are counted in theirs as well.
+*/
+enum qrt_query_type { QRT_ANY, QRT_READ, QRT_WRITE, QRT_QUERY_TYPES };
+
+/* Values of query_response_time_group_by */
+enum qrt_group_by { QRT_GROUP_BY_NONE, QRT_GROUP_BY_SCHEMA, QRT_GROUP_BY_USER };
+
 extern ST_SCHEMA_TABLE query_response_time_table;
 
 #ifdef HAVE_RESPONSE_TIME_DISTRIBUTION
 extern void query_response_time_init   ();
 extern void query_response_time_free   ();
 extern int query_response_time_flush  ();
-extern void query_response_time_collect(ulonglong query_time);
+extern void query_response_time_collect(qrt_query_type type,
+                                        ulonglong query_time,
+                                        ulonglong thread_id,
+                                        const char *group,
+                                        size_t group_length);
 extern int  query_response_time_fill   (THD* thd, TABLE_LIST *tables, COND *cond);
+extern int  query_response_time_fill_read(THD* thd, TABLE_LIST *tables,
+                                          COND *cond);
+extern int  query_response_time_fill_write(THD* thd, TABLE_LIST *tables,
+                                           COND *cond);
+extern int  query_response_time_fill_by_group(THD* thd, TABLE_LIST *tables,
+                                              COND *cond);
 
 extern ulong   opt_query_response_time_range_base;
 extern my_bool opt_query_response_time_stats;
+extern ulong   opt_query_response_time_group_by;
 #endif // HAVE_RESPONSE_TIME_DISTRIBUTION
 
 #endif // QUERY_RESPONSE_TIME_H
@@ -0,0 +1,10 @@
+package My::Suite::Thread_samples;
+
+@ISA = qw(My::Suite);
+
+return "No THREAD_SAMPLES plugin" unless $ENV{THREAD_SAMPLES_SO};
+
+sub is_default { 1 }
+
+bless { };
+
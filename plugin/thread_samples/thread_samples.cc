@@ -0,0 +1,242 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Sampling profiler for server threads
+
+  A background thread wakes up thread_samples_frequency times a second
+  and records the command, stage and statement of every thread that is
+  not idle in a ring buffer of thread_samples_history_size entries,
+  which is shown in INFORMATION_SCHEMA.THREAD_SAMPLES. Grouping the
+  samples by STATE or INFO shows where the server spends its time,
+  without the per-event timing of the performance schema.
+*/
+
+#define MYSQL_SERVER
+#include <my_global.h>
+#include <sql_class.h>
+#include <sql_i_s.h>
+#include <sql_show.h>
+#include <sql_parse.h>
+#include <tztime.h>
+
+#define SAMPLE_STATE_LENGTH 64
+#define SAMPLE_INFO_LENGTH  256
+
+struct thread_sample
+{
+  my_hrtime_t time;
+  my_thread_id thread_id;
+  query_id_t query_id;
+  enum enum_server_command command;
+  uint info_length;
+  char state[SAMPLE_STATE_LENGTH];
+  char info[SAMPLE_INFO_LENGTH];
+};
+
+static uint frequency, history_size;
+
+static thread_sample *samples;
+/* Number of samples taken, the last history_size of them are in samples */
+static ulonglong sample_count;
+static bool sampler_stop;
+static mysql_mutex_t LOCK_samples;
+static mysql_cond_t COND_sampler;
+static pthread_t sampler_thread;
+
+
+static MYSQL_SYSVAR_UINT(frequency, frequency, PLUGIN_VAR_RQCMDARG,
+       "Number of times per second that the threads are sampled",
+       NULL, NULL, 100, 1, 1000, 0);
+
+static MYSQL_SYSVAR_UINT(history_size, history_size,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Number of samples that are kept",
+       NULL, NULL, 10000, 100, 1024*1024, 0);
+
+static struct st_mysql_sys_var *thread_samples_vars[]=
+{
+  MYSQL_SYSVAR(frequency),
+  MYSQL_SYSVAR(history_size),
+  NULL
+};
+
+
+static my_bool take_sample(THD *thd, my_hrtime_t *now)
+{
+  enum enum_server_command command= thd->get_command();
+  thread_sample *sample;
+  const char *state;
+
+  if (command == COM_SLEEP || command == COM_DAEMON)
+    return 0;
+
+  sample= &samples[sample_count++ % history_size];
+  sample->time= *now;
+  sample->thread_id= thd->thread_id;
+  sample->query_id= thd->query_id;
+  sample->command= command;
+  /* The THD can't go away while the thread list is locked */
+  state= thd->proc_info;
+  strmake_buf(sample->state, state ? state : "");
+
+  sample->info_length= 0;
+  if (!mysql_mutex_trylock(&thd->LOCK_thd_data))
+  {
+    if (thd->query())
+    {
+      sample->info_length= (uint) MY_MIN(thd->query_length(),
+                                         SAMPLE_INFO_LENGTH);
+      memcpy(sample->info, thd->query(), sample->info_length);
+    }
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+  }
+  return 0;
+}
+
+
+static void *sampler(void *)
+{
+  my_thread_init();
+  mysql_mutex_lock(&LOCK_samples);
+  while (!sampler_stop)
+  {
+    struct timespec abstime;
+    set_timespec_nsec(abstime, 1000000000ULL / frequency);
+    if (mysql_cond_timedwait(&COND_sampler, &LOCK_samples, &abstime) == 0)
+      continue;                                 /* Woken up to stop */
+    my_hrtime_t now= my_hrtime();
+    THD_list_iterator::iterator()->iterate(take_sample, &now);
+  }
+  mysql_mutex_unlock(&LOCK_samples);
+  my_thread_end();
+  return NULL;
+}
+
+
+namespace Show {
+
+static ST_FIELD_INFO thread_samples_fields_info[]=
+{
+  Column("SAMPLE_TIME", Datetime(6),                  NOT_NULL),
+  Column("THREAD_ID",   ULonglong(),                  NOT_NULL),
+  Column("QUERY_ID",    ULonglong(),                  NOT_NULL),
+  Column("COMMAND",     Varchar(16),                  NOT_NULL),
+  Column("STATE",       Varchar(SAMPLE_STATE_LENGTH), NOT_NULL),
+  Column("INFO",        Varchar(SAMPLE_INFO_LENGTH),  NULLABLE),
+  CEnd()
+};
+
+} // namespace Show
+
+
+static int thread_samples_fill_table(THD *thd, TABLE_LIST *tables, COND *)
+{
+  TABLE *table= tables->table;
+  CHARSET_INFO *cs= system_charset_info;
+  ulonglong i, count;
+  int res= 0;
+
+  mysql_mutex_lock(&LOCK_samples);
+  count= MY_MIN(sample_count, history_size);
+  for (i= sample_count - count; i < sample_count && !res; i++)
+  {
+    thread_sample *sample= &samples[i % history_size];
+    MYSQL_TIME time;
+
+    thd->variables.time_zone->gmt_sec_to_TIME(&time,
+                                              (my_time_t)
+                                              hrtime_to_my_time(sample->time));
+    time.second_part= hrtime_sec_part(sample->time);
+    table->field[0]->store_time_dec(&time, 6);
+    table->field[1]->store((longlong) sample->thread_id, TRUE);
+    table->field[2]->store((longlong) sample->query_id, TRUE);
+    table->field[3]->store(command_name[sample->command].str,
+                           command_name[sample->command].length, cs);
+    table->field[4]->store(sample->state, strlen(sample->state), cs);
+    if (sample->info_length)
+    {
+      table->field[5]->store(sample->info, sample->info_length, cs);
+      table->field[5]->set_notnull();
+    }
+    else
+      table->field[5]->set_null();
+    res= schema_table_store_record(thd, table);
+  }
+  mysql_mutex_unlock(&LOCK_samples);
+  return res;
+}
+
+
+static int thread_samples_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE*) p;
+  schema->fields_info= Show::thread_samples_fields_info;
+  schema->fill_table= thread_samples_fill_table;
+
+  if (!(samples= (thread_sample*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                            sizeof(*samples) * history_size,
+                                            MYF(MY_WME))))
+    return 1;
+  sample_count= 0;
+  sampler_stop= false;
+  mysql_mutex_init(0, &LOCK_samples, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(0, &COND_sampler, 0);
+  if (mysql_thread_create(0, &sampler_thread, NULL, sampler, NULL))
+  {
+    mysql_cond_destroy(&COND_sampler);
+    mysql_mutex_destroy(&LOCK_samples);
+    my_free(samples);
+    return 1;
+  }
+  return 0;
+}
+
+
+static int thread_samples_deinit(void *)
+{
+  mysql_mutex_lock(&LOCK_samples);
+  sampler_stop= true;
+  mysql_cond_signal(&COND_sampler);
+  mysql_mutex_unlock(&LOCK_samples);
+  pthread_join(sampler_thread, NULL);
+
+  mysql_cond_destroy(&COND_sampler);
+  mysql_mutex_destroy(&LOCK_samples);
+  my_free(samples);
+  return 0;
+}
+
+
+static struct st_mysql_information_schema thread_samples_plugin=
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
+maria_declare_plugin(thread_samples)
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &thread_samples_plugin,
+  "THREAD_SAMPLES",
+  "MariaDB Corporation",
+  "Periodic samples of the state of the server threads",
+  PLUGIN_LICENSE_GPL,
+  thread_samples_init,
+  thread_samples_deinit,
+  0x0100,
+  NULL,
+  thread_samples_vars,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_EXPERIMENTAL
+}
+maria_declare_plugin_end;
@@ -11,57 +11,62 @@ static ST_FIELD_INFO index_stats_fields[]=
 
 } // namespace Show
 
-static int index_stats_fill(THD *thd, TABLE_LIST *tables, COND *cond)
+struct index_stats_fill_arg
 {
-  TABLE *table= tables->table;
+  THD *thd;
+  TABLE *table;
+};
 
-  mysql_mutex_lock(&LOCK_global_index_stats);
-  for (uint i= 0; i < global_index_stats.records; i++)
-  {
-    INDEX_STATS *index_stats =
-      (INDEX_STATS*) my_hash_element(&global_index_stats, i);
-    TABLE_LIST tmp_table;
-    const char *index_name;
-    size_t index_name_length;
+static my_bool index_stats_fill_one(void *element, void *arg)
+{
+  THD *thd= ((index_stats_fill_arg*) arg)->thd;
+  TABLE *table= ((index_stats_fill_arg*) arg)->table;
+  INDEX_STATS *index_stats= (INDEX_STATS*) element;
+  TABLE_LIST tmp_table;
+  const char *index_name;
+  size_t index_name_length;
 
-    bzero((char*) &tmp_table,sizeof(tmp_table));
-    tmp_table.db.str=    index_stats->index;
-    tmp_table.db.length= strlen(index_stats->index);
-    tmp_table.table_name.str= index_stats->index + tmp_table.db.length + 1;
-    tmp_table.table_name.length= strlen(tmp_table.table_name.str);
-    tmp_table.grant.privilege= NO_ACL;
-    if (check_access(thd, SELECT_ACL, tmp_table.db.str,
-                      &tmp_table.grant.privilege, NULL, 0, 1) ||
-        check_grant(thd, SELECT_ACL, &tmp_table, 1, UINT_MAX, 1))
-      continue;
+  bzero((char*) &tmp_table,sizeof(tmp_table));
+  tmp_table.db.str=    index_stats->index;
+  tmp_table.db.length= strlen(index_stats->index);
+  tmp_table.table_name.str= index_stats->index + tmp_table.db.length + 1;
+  tmp_table.table_name.length= strlen(tmp_table.table_name.str);
+  tmp_table.grant.privilege= NO_ACL;
+  if (check_access(thd, SELECT_ACL, tmp_table.db.str,
+                    &tmp_table.grant.privilege, NULL, 0, 1) ||
+      check_grant(thd, SELECT_ACL, &tmp_table, 1, UINT_MAX, 1))
+    return 0;
 
-    index_name=         tmp_table.table_name.str + tmp_table.table_name.length + 1;
-    index_name_length=  (index_stats->index_name_length - tmp_table.db.length -
-                         tmp_table.table_name.length - 3);
+  index_name=         tmp_table.table_name.str + tmp_table.table_name.length + 1;
+  index_name_length=  (index_stats->index_name_length - tmp_table.db.length -
+                       tmp_table.table_name.length - 3);
 
-    table->field[0]->store(tmp_table.db.str, tmp_table.db.length, system_charset_info);
-    table->field[1]->store(tmp_table.table_name.str, tmp_table.table_name.length,
-                           system_charset_info);
-    table->field[2]->store(index_name, (uint) index_name_length, system_charset_info);
-    table->field[3]->store((longlong)index_stats->rows_read, TRUE);
+  table->field[0]->store(tmp_table.db.str, tmp_table.db.length, system_charset_info);
+  table->field[1]->store(tmp_table.table_name.str, tmp_table.table_name.length,
+                         system_charset_info);
+  table->field[2]->store(index_name, (uint) index_name_length, system_charset_info);
+  table->field[3]->store(my_atomic_load64_explicit(
+                           (int64*) &index_stats->rows_read,
+                           MY_MEMORY_ORDER_RELAXED), TRUE);
+  return schema_table_store_record(thd, table);
+}
 
-    if (schema_table_store_record(thd, table))
-    {
-      mysql_mutex_unlock(&LOCK_global_index_stats);
-      return 1;
-    }
-  }
-  mysql_mutex_unlock(&LOCK_global_index_stats);
-  return 0;
+static int index_stats_fill(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  index_stats_fill_arg arg= { thd, tables->table };
+  LF_PINS *pins;
+  int res;
+
+  if (!(pins= lf_hash_get_pins(&global_index_stats)))
+    return 1;
+  res= lf_hash_iterate(&global_index_stats, pins, index_stats_fill_one, &arg);
+  lf_hash_put_pins(pins);
+  return res;
 }
 
 static int index_stats_reset()
 {
-  mysql_mutex_lock(&LOCK_global_index_stats);
-  free_global_index_stats();
-  init_global_index_stats();
-  mysql_mutex_unlock(&LOCK_global_index_stats);
-  return 0;
+  return delete_global_stats(&global_index_stats, 0, 0);
 }
 
 static int index_stats_init(void *p)
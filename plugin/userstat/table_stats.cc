@@ -12,60 +12,69 @@ static ST_FIELD_INFO table_stats_fields[]=
 
 } // namespace Show
 
-static int table_stats_fill(THD *thd, TABLE_LIST *tables, COND *cond)
+struct table_stats_fill_arg
 {
-  TABLE *table= tables->table;
+  THD *thd;
+  TABLE *table;
+};
 
-  mysql_mutex_lock(&LOCK_global_table_stats);
-  for (uint i= 0; i < global_table_stats.records; i++)
-  {
-    char *end_of_schema;
-    TABLE_STATS *table_stats=
-      (TABLE_STATS*)my_hash_element(&global_table_stats, i);
-    TABLE_LIST tmp_table;
-    size_t schema_length, table_name_length;
+static my_bool table_stats_fill_one(void *element, void *arg)
+{
+  THD *thd= ((table_stats_fill_arg*) arg)->thd;
+  TABLE *table= ((table_stats_fill_arg*) arg)->table;
+  TABLE_STATS *table_stats= (TABLE_STATS*) element;
+  char *end_of_schema;
+  TABLE_LIST tmp_table;
+  size_t schema_length, table_name_length;
 
-    end_of_schema= strend(table_stats->table);
-    schema_length= (size_t) (end_of_schema - table_stats->table);
-    table_name_length= strlen(table_stats->table + schema_length + 1);
+  end_of_schema= strend(table_stats->table);
+  schema_length= (size_t) (end_of_schema - table_stats->table);
+  table_name_length= strlen(table_stats->table + schema_length + 1);
 
-    bzero((char*) &tmp_table,sizeof(tmp_table));
-    tmp_table.db.str= table_stats->table;
-    tmp_table.db.length= schema_length;
-    tmp_table.table_name.str= end_of_schema+1;
-    tmp_table.table_name.length= table_name_length;
-    tmp_table.grant.privilege= NO_ACL;
-    if (check_access(thd, SELECT_ACL, tmp_table.db.str,
-                     &tmp_table.grant.privilege, NULL, 0, 1) ||
-        check_grant(thd, SELECT_ACL, &tmp_table, 1, UINT_MAX,
-                    1))
-      continue;
+  bzero((char*) &tmp_table,sizeof(tmp_table));
+  tmp_table.db.str= table_stats->table;
+  tmp_table.db.length= schema_length;
+  tmp_table.table_name.str= end_of_schema+1;
+  tmp_table.table_name.length= table_name_length;
+  tmp_table.grant.privilege= NO_ACL;
+  if (check_access(thd, SELECT_ACL, tmp_table.db.str,
+                   &tmp_table.grant.privilege, NULL, 0, 1) ||
+      check_grant(thd, SELECT_ACL, &tmp_table, 1, UINT_MAX,
+                  1))
+    return 0;
 
-    table->field[0]->store(table_stats->table, schema_length,
-                           system_charset_info);
-    table->field[1]->store(table_stats->table + schema_length+1,
-                           table_name_length, system_charset_info);
-    table->field[2]->store((longlong)table_stats->rows_read, TRUE);
-    table->field[3]->store((longlong)table_stats->rows_changed, TRUE);
-    table->field[4]->store((longlong)table_stats->rows_changed_x_indexes,
-                           TRUE);
-    if (schema_table_store_record(thd, table))
-    {
-      mysql_mutex_unlock(&LOCK_global_table_stats);
-      return 1;
-    }
-  }
-  mysql_mutex_unlock(&LOCK_global_table_stats);
-  return 0;
+  table->field[0]->store(table_stats->table, schema_length,
+                         system_charset_info);
+  table->field[1]->store(table_stats->table + schema_length+1,
+                         table_name_length, system_charset_info);
+  table->field[2]->store(my_atomic_load64_explicit(
+                           (int64*) &table_stats->rows_read,
+                           MY_MEMORY_ORDER_RELAXED), TRUE);
+  table->field[3]->store(my_atomic_load64_explicit(
+                           (int64*) &table_stats->rows_changed,
+                           MY_MEMORY_ORDER_RELAXED), TRUE);
+  table->field[4]->store(my_atomic_load64_explicit(
+                           (int64*) &table_stats->rows_changed_x_indexes,
+                           MY_MEMORY_ORDER_RELAXED), TRUE);
+  return schema_table_store_record(thd, table);
+}
+
+static int table_stats_fill(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  table_stats_fill_arg arg= { thd, tables->table };
+  LF_PINS *pins;
+  int res;
+
+  if (!(pins= lf_hash_get_pins(&global_table_stats)))
+    return 1;
+  res= lf_hash_iterate(&global_table_stats, pins, table_stats_fill_one, &arg);
+  lf_hash_put_pins(pins);
+  return res;
 }
 
 static int table_stats_reset()
 {
-  mysql_mutex_lock(&LOCK_global_table_stats);
-  free_global_table_stats();
-  init_global_table_stats();
-  mysql_mutex_unlock(&LOCK_global_table_stats);
-  return 0;
+  return delete_global_stats(&global_table_stats, 0, 0);
 }
 
 static int table_stats_init(void *p)
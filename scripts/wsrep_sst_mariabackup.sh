@@ -44,6 +44,7 @@ totime=0
 lsn=""
 ecmd=""
 rlimit=""
+backup_threads=""
 # Initially
 stagemsg="${WSREP_SST_OPT_ROLE}"
 cpat=""
@@ -375,6 +376,7 @@ read_cnf()
     fi
 
     rlimit=$(parse_cnf sst rlimit "")
+    backup_threads=$(parse_cnf sst backup-threads "")
     uextra=$(parse_cnf sst use-extra 0)
     speciald=$(parse_cnf sst sst-special-dirs 1)
     iopts=$(parse_cnf sst inno-backup-opts "")
@@ -411,6 +413,9 @@ get_stream()
         wsrep_log_info "Streaming with ${sfmt}"
         if [[ "$WSREP_SST_OPT_ROLE"  == "joiner" ]];then
             strmcmd="${XBSTREAM_BIN} -x"
+            if [[ -n $backup_threads ]];then
+                strmcmd+=" --parallel=$backup_threads"
+            fi
         else
             strmcmd="${XBSTREAM_BIN} -c \${INFO_FILE}"
         fi
@@ -710,6 +715,13 @@ fi
 
 iopts+=" --databases-exclude=\"lost+found\""
 
+# Copy the data files into the stream, and move them into place on the
+# joiner, with several threads
+if [[ -n $backup_threads ]];then
+    iopts+=" --parallel=$backup_threads"
+    impts+=" --parallel=$backup_threads"
+fi
+
 if [[ ${FORCE_FTWRL:-0} -eq 1 ]];then 
     wsrep_log_info "Forcing FTWRL due to environment variable FORCE_FTWRL equal to $FORCE_FTWRL"
     iopts+=" --no-backup-locks"
@@ -60,7 +60,7 @@ $log_prog_args=join(" ", skip_arguments(\@ARGV,"comments","cmp","server",
 					"use-old-results","skip-test",
 					"optimization","hw",
 					"machine", "dir", "suffix", "log"));
-GetOptions("skip-test=s","comments=s","cmp=s","server=s","user=s","host=s","database=s","password=s","loop-count=i","row-count=i","skip-create","skip-delete","verbose","fast-insert","lock-tables","debug","fast","force","field-count=i","regions=i","groups=i","time-limit=i","log","use-old-results","machine=s","dir=s","suffix=s","help","odbc","small-test","small-tables","small-key-tables","stage=i","threads=i","random","old-headers","die-on-errors","create-options=s","hires","tcpip","silent","optimization=s","hw=s","socket=s","connect-options=s","connect-command=s","only-missing-tests","temporary-tables") || usage();
+GetOptions("skip-test=s","comments=s","cmp=s","server=s","user=s","host=s","database=s","password=s","loop-count=i","row-count=i","skip-create","skip-delete","verbose","fast-insert","lock-tables","debug","fast","force","field-count=i","regions=i","groups=i","time-limit=i","log","use-old-results","machine=s","dir=s","suffix=s","help","odbc","small-test","small-tables","small-key-tables","stage=i","threads=i","random","old-headers","die-on-errors","create-options=s","hires","tcpip","silent","optimization=s","hw=s","socket=s","connect-options=s","connect-command=s","only-missing-tests","temporary-tables","thread-counts=s","json-file=s") || usage();
 
 usage() if ($opt_help);
 $server=get_server($opt_server,$opt_host,$opt_database,$opt_odbc,
@@ -503,6 +503,10 @@ All benchmarks takes the following options:
 --help
   Shows this help
 
+--json-file='file name'
+  Used by test-concurrency; also write the results to the named file as
+  JSON, for tracking regressions between versions.
+
 --host='host name' (Default $opt_host)
   Host name where the database server is located.
 
@@ -569,6 +573,10 @@ All benchmarks takes the following options:
   Inform test suite that we are generate random initial values for sequence of
   test executions. It should be used for imitation of real conditions.
 
+--thread-counts=#[,#...]
+  Used by test-concurrency; the numbers of concurrent connections that
+  every scenario is run with.
+
 --threads=#  **DEPRECATED**
   This option has no effect, and will be removed in a future version.
 
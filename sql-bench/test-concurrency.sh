@@ -0,0 +1,452 @@
+#!/usr/bin/env perl
+# Copyright (c) 2021, MariaDB Corporation.
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Library General Public
+# License as published by the Free Software Foundation; version 2
+# of the License.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the GNU
+# Library General Public License for more details.
+#
+# You should have received a copy of the GNU Library General Public
+# License along with this library; if not, write to the Free
+# Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston,
+# MA 02110-1335  USA
+#
+# Test of how the server scales with concurrent connections.
+#
+# OLTP point selects, range selects and writes, analytical joins and DDL
+# are run by each of the --thread-counts number of connections. Every
+# connection is a forked process that runs --loop-count queries (fewer for
+# the joins and DDL). For every scenario and number of connections the
+# throughput, the p50 and p99 latency and the CPU time per query of the
+# clients and, if the server runs on this machine, of the server are
+# reported. With --json-file the results are also written as JSON.
+#
+
+##################### Standard benchmark inits ##############################
+
+use Cwd;
+use DBI;
+use Benchmark;
+use POSIX ();
+use Time::HiRes;
+
+$opt_loop_count=10000;	    # Queries per connection and scenario
+$opt_row_count=100000;	    # Rows in the test tables
+$opt_thread_counts="1,2,4,8,16";
+$opt_json_file="";
+
+$pwd = cwd(); $pwd = "." if ($pwd eq '');
+require "$pwd/bench-init.pl" || die "Can't read Configuration file: $!\n";
+
+if ($opt_small_test || $opt_small_tables)
+{
+  $opt_loop_count/=10;
+  $opt_row_count/=10;
+}
+
+@thread_counts=split(/,\s*/,$opt_thread_counts);
+$join_range=1000;
+@results=();
+
+####
+####  Connect and start timeing
+####
+
+$start_time=new Benchmark;
+$dbh = $server->connect();
+$server_pid= get_server_pid($dbh);
+$clock_ticks= POSIX::sysconf(POSIX::_SC_CLK_TCK()) || 100;
+
+###
+### Create and fill the tables
+###
+
+print "Creating tables\n";
+$dbh->do("drop table bench1" . $server->{'drop_attr'});
+$dbh->do("drop table bench2" . $server->{'drop_attr'});
+
+do_many($dbh,$server->create("bench1",
+			     ["id int NOT NULL",
+			      "k int NOT NULL",
+			      "c char(120) NOT NULL",
+			      "pad char(60) NOT NULL"],
+			     ["primary key (id)",
+			      "index (k)"]));
+do_many($dbh,$server->create("bench2",
+			     ["id int NOT NULL",
+			      "grp int NOT NULL",
+			      "val int NOT NULL"],
+			     ["primary key (id)"]));
+
+print "Inserting $opt_row_count rows\n";
+$loop_time=new Benchmark;
+{
+  my ($id,@values1,@values2);
+  $dbh->{AutoCommit}= 0 if ($server->{transactions});
+  for ($id=0 ; $id < $opt_row_count ; $id++)
+  {
+    push(@values1,"($id," . ($id % 1000) . ",'" . row_text($id) .
+	 "','pad')");
+    push(@values2,"($id," . ($id % 100) . ",$id)");
+    if (!$limits->{'insert_multi_value'} || @values1 >= 100 ||
+	$id == $opt_row_count-1)
+    {
+      if ($limits->{'insert_multi_value'})
+      {
+	do_query($dbh,"insert into bench1 values " . join(",",@values1));
+	do_query($dbh,"insert into bench2 values " . join(",",@values2));
+      }
+      else
+      {
+	do_query($dbh,"insert into bench1 values $values1[0]");
+	do_query($dbh,"insert into bench2 values $values2[0]");
+      }
+      @values1=@values2=();
+    }
+  }
+  $dbh->commit if ($server->{transactions});
+  $dbh->{AutoCommit}= 1 if ($server->{transactions});
+}
+$end_time=new Benchmark;
+print "Time for insert ($opt_row_count): " .
+  timestr(timediff($end_time, $loop_time),"all") . "\n\n";
+
+###
+### Run the scenarios with every number of connections
+###
+
+foreach $threads (@thread_counts)
+{
+  print "Testing with $threads connections\n";
+  run_scenario("point_select",$threads,$opt_loop_count,\&point_select);
+  run_scenario("range_select",$threads,$opt_loop_count,\&range_select);
+  run_scenario("update_index",$threads,$opt_loop_count,\&update_index);
+  run_scenario("write_mix",$threads,$opt_loop_count,\&write_mix);
+  run_scenario("oltp_mix",$threads,int($opt_loop_count/10)+1,\&oltp_mix);
+  run_scenario("join_group",$threads,int($opt_loop_count/100)+1,
+	       \&join_group);
+  run_scenario("ddl",$threads,int($opt_loop_count/100)+1,\&ddl);
+  print "\n";
+}
+
+write_json($opt_json_file) if (length($opt_json_file));
+
+####
+#### End of benchmark
+####
+
+if (!$opt_skip_delete)
+{
+  do_query($dbh,"drop table bench1" . $server->{'drop_attr'});
+  do_query($dbh,"drop table bench2" . $server->{'drop_attr'});
+}
+
+$dbh->disconnect;				# close connection
+
+end_benchmark($start_time);
+
+###
+### The scenarios. Every call is one timed query or transaction.
+###
+
+sub row_text
+{
+  my ($id)=@_;
+  return sprintf("%010d-%s",$id,"x" x 50);
+}
+
+# A random row of the part of the table that only this worker changes
+sub worker_row
+{
+  my ($worker,$threads)=@_;
+  return $worker + $threads * int(rand(int($opt_row_count/$threads)));
+}
+
+sub point_select
+{
+  my ($dbh)=@_;
+  fetch_all_rows($dbh,"select c from bench1 where id=" .
+		 int(rand($opt_row_count)));
+}
+
+sub range_select
+{
+  my ($dbh)=@_;
+  my $id=int(rand($opt_row_count-100));
+  fetch_all_rows($dbh,"select c from bench1 where id between $id and " .
+		 ($id+99));
+}
+
+sub update_index
+{
+  my ($dbh,$worker,$threads)=@_;
+  do_query($dbh,"update bench1 set k=k+1 where id=" .
+	   worker_row($worker,$threads));
+}
+
+sub write_mix
+{
+  my ($dbh,$worker,$threads)=@_;
+  my $id=worker_row($worker,$threads);
+  do_query($dbh,"delete from bench1 where id=$id");
+  do_query($dbh,"insert into bench1 values ($id," . ($id % 1000) . ",'" .
+	   row_text($id) . "','pad')");
+}
+
+sub oltp_mix
+{
+  my ($dbh,$worker,$threads)=@_;
+  my $i;
+  $dbh->{AutoCommit}= 0 if ($server->{transactions});
+  for ($i=0 ; $i < 10 ; $i++)
+  {
+    point_select($dbh);
+  }
+  range_select($dbh);
+  update_index($dbh,$worker,$threads);
+  write_mix($dbh,$worker,$threads);
+  if ($server->{transactions})
+  {
+    $dbh->commit;
+    $dbh->{AutoCommit}= 1;
+  }
+}
+
+sub join_group
+{
+  my ($dbh)=@_;
+  my $id=int(rand($opt_row_count-$join_range));
+  fetch_all_rows($dbh,"select b2.grp,count(*),sum(b1.k) from bench1 b1,bench2 b2 where b1.id=b2.id and b1.id between $id and " .
+		 ($id+$join_range-1) . " group by b2.grp");
+}
+
+sub ddl
+{
+  my ($dbh,$worker)=@_;
+  my $table="bench_ddl_$worker";
+  do_many($dbh,$server->create($table,
+			       ["a int NOT NULL",
+				"b int NOT NULL"],
+			       ["primary key (a)"]));
+  do_query($dbh,"insert into $table values (1,1)");
+  do_query($dbh,"create index ${table}_b on $table (b)");
+  do_query($dbh,"drop table $table" . $server->{'drop_attr'});
+}
+
+###
+### Running a scenario with concurrent connections
+###
+
+#
+# Run $queries calls of $query_sub in each of $threads forked processes.
+# The processes connect first and then start together. Each reports its
+# start and end time, its CPU time and the latency of every call through
+# a pipe.
+#
+
+sub run_scenario
+{
+  my ($name,$threads,$queries,$query_sub)=@_;
+  my ($worker,$pid,@pids,@readers,$reader,$writer,$byte);
+  my ($ready_reader,$ready_writer,$go_reader,$go_writer);
+  my ($loop_time,$end_time,@latencies,$first_start,$last_end);
+  my ($client_cpu,$server_cpu,$count,$seconds,$result);
+
+  pipe($ready_reader,$ready_writer) || die "Can't create pipe: $!\n";
+  pipe($go_reader,$go_writer) || die "Can't create pipe: $!\n";
+  $dbh->{InactiveDestroy}= 1;		# Don't disconnect in the children
+
+  $loop_time=new Benchmark;
+  for ($worker=0 ; $worker < $threads ; $worker++)
+  {
+    pipe($reader,$writer) || die "Can't create pipe: $!\n";
+    if (!defined($pid=fork()))
+    {
+      die "Can't fork: $!\n";
+    }
+    if (!$pid)
+    {
+      close($reader);
+      close($ready_reader);
+      close($go_writer);
+      run_worker($worker,$threads,$queries,$query_sub,$writer,
+		 $ready_writer,$go_reader);
+      POSIX::_exit(0);
+    }
+    close($writer);
+    push(@pids,$pid);
+    push(@readers,$reader);
+    undef($reader);
+  }
+  close($ready_writer);
+  close($go_reader);
+
+  # Start all workers together once they are connected
+  for ($worker=0 ; $worker < $threads ; $worker++)
+  {
+    sysread($ready_reader,$byte,1);
+  }
+  close($ready_reader);
+  $server_cpu=server_cpu_time();
+  syswrite($go_writer,"x" x $threads);
+  close($go_writer);
+
+  $client_cpu=0;
+  foreach $reader (@readers)
+  {
+    while (<$reader>)
+    {
+      chomp;
+      if (/^start (\S+) end (\S+) cpu (\S+)$/)
+      {
+	$first_start=$1 if (!defined($first_start) || $1 < $first_start);
+	$last_end=$2 if (!defined($last_end) || $2 > $last_end);
+	$client_cpu+=$3;
+      }
+      elsif (length($_))
+      {
+	push(@latencies,$_);
+      }
+    }
+    close($reader);
+  }
+  foreach $pid (@pids)
+  {
+    waitpid($pid,0);
+    die "A worker of $name failed\n" if ($? && !$opt_force);
+  }
+  $server_cpu=defined($server_cpu) ? server_cpu_time() - $server_cpu : undef;
+  $dbh->{InactiveDestroy}= 0;
+  $end_time=new Benchmark;
+
+  $count=$threads*$queries;
+  $seconds=(defined($last_end) ? $last_end - $first_start : 0) || 1e-6;
+  @latencies=sort { $a <=> $b } @latencies;
+  $result= { "scenario" => $name,
+	     "threads" => $threads,
+	     "queries" => $count,
+	     "seconds" => $seconds,
+	     "queries_per_second" => $count/$seconds,
+	     "p50_ms" => percentile(\@latencies,50)*1000,
+	     "p99_ms" => percentile(\@latencies,99)*1000,
+	     "client_cpu_ms_per_query" => $client_cpu*1000/$count,
+	     "server_cpu_ms_per_query" =>
+	       defined($server_cpu) ? $server_cpu*1000/$count : undef };
+  push(@results,$result);
+
+  print "Time for ${name}_$threads ($count): " .
+    timestr(timediff($end_time, $loop_time),"all") . "\n";
+  printf("Latency for ${name}_$threads: p50 %.3f ms, p99 %.3f ms, " .
+	 "%.1f queries/sec, client CPU %.3f ms/query",
+	 $result->{p50_ms}, $result->{p99_ms},
+	 $result->{queries_per_second}, $result->{client_cpu_ms_per_query});
+  printf(", server CPU %.3f ms/query",$result->{server_cpu_ms_per_query})
+    if (defined($server_cpu));
+  print "\n";
+}
+
+sub run_worker
+{
+  my ($worker,$threads,$queries,$query_sub,$writer,$ready,$go)=@_;
+  my ($dbh,$i,$start,$end,$query_start,@cpu_start,@cpu_end,@latencies,$byte);
+
+  $dbh=$server->connect();
+  syswrite($ready,"x");
+  sysread($go,$byte,1);
+
+  @cpu_start=times;
+  $start=Time::HiRes::time();
+  for ($i=0 ; $i < $queries ; $i++)
+  {
+    $query_start=Time::HiRes::time();
+    &$query_sub($dbh,$worker,$threads);
+    push(@latencies,Time::HiRes::time() - $query_start);
+  }
+  $end=Time::HiRes::time();
+  @cpu_end=times;
+  $dbh->disconnect;
+
+  print $writer "start $start end $end cpu " .
+    ($cpu_end[0]+$cpu_end[1]-$cpu_start[0]-$cpu_start[1]) . "\n";
+  print $writer join("\n",@latencies) . "\n";
+  close($writer);
+}
+
+# Nearest-rank percentile of sorted values
+
+sub percentile
+{
+  my ($values,$percent)=@_;
+  my $rank;
+  return 0 if (!@$values);
+  $rank=int((@$values * $percent + 99) / 100);
+  return $values->[$rank ? $rank-1 : 0];
+}
+
+#
+# The process id of the server if it runs on this machine and its CPU
+# time can be read from /proc
+#
+
+sub get_server_pid
+{
+  my ($dbh)=@_;
+  my ($row,$pid);
+  return undef if ($server->{'cmp_name'} ne "mysql" ||
+		   ($opt_host ne "localhost" && $opt_host ne "127.0.0.1"));
+  return undef if (!($row=$dbh->selectrow_arrayref("select \@\@pid_file")));
+  return undef if (!open(PID,"<$row->[0]"));
+  $pid=<PID>;
+  close(PID);
+  chomp($pid);
+  return (-r "/proc/$pid/stat") ? $pid : undef;
+}
+
+# User and system CPU time of the server in seconds, or undef
+
+sub server_cpu_time
+{
+  my (@stat);
+  return undef if (!defined($server_pid) ||
+		   !open(STAT,"</proc/$server_pid/stat"));
+  @stat=split(/\s+/,<STAT>);
+  close(STAT);
+  return ($stat[13]+$stat[14])/$clock_ticks;
+}
+
+sub json_value
+{
+  my ($value)=@_;
+  return "null" if (!defined($value));
+  return $value if ($value =~ /^-?\d+$/);
+  return sprintf("%.6f",$value) if ($value =~ /^-?[\d.]+(e-?\d+)?$/i);
+  $value =~ s/(["\\])/\\$1/g;
+  return "\"$value\"";
+}
+
+sub write_json
+{
+  my ($file)=@_;
+  my ($result,@lines);
+  open(JSON,">$file") || die "Can't write to $file: $!\n";
+  print JSON "{\n  \"server\": " . json_value($server->version()) .
+    ",\n  \"machine\": " . json_value(machine()) .
+    ",\n  \"date\": " . json_value($date) .
+    ",\n  \"rows\": $opt_row_count,\n  \"results\": [\n";
+  foreach $result (@results)
+  {
+    push(@lines,"    {" . join(", ",
+			      map { "\"$_\": " . json_value($result->{$_}) }
+			      ("scenario","threads","queries","seconds",
+			       "queries_per_second","p50_ms","p99_ms",
+			       "client_cpu_ms_per_query",
+			       "server_cpu_ms_per_query")) . "}");
+  }
+  print JSON join(",\n",@lines) . "\n  ]\n}\n";
+  close(JSON);
+}
@@ -110,6 +110,9 @@ typedef enum {
 #define native_password_plugin_name "mysql_native_password"
 #define old_password_plugin_name    "mysql_old_password"
 
+/* zstd compression level of the packets that are sent to the server */
+#define NET_ZSTD_CLIENT_LEVEL 3
+
 PSI_memory_key key_memory_mysql_options;
 PSI_memory_key key_memory_MYSQL_DATA;
 PSI_memory_key key_memory_MYSQL;
@@ -2115,11 +2118,22 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
 
   if (mysql->client_flag & CLIENT_PROTOCOL_41)
   {
+    my_bool zstd= (mysql->client_flag & CLIENT_COMPRESS) &&
+                  mysql->options.extension &&
+                  mysql->options.extension->zstd_compression;
+    /*
+      The extended capabilities are only read from clients that do not
+      claim to be MySQL clients.
+    */
+    if (zstd)
+      mysql->client_flag&= ~CLIENT_MYSQL;
     /* 4.1 server and 4.1 client has a 32 byte option flag */
     int4store(buff,mysql->client_flag);
     int4store(buff+4, net->max_packet_size);
     buff[8]= (char) mysql->charset->number;
     bzero(buff+9, 32-9);
+    if (zstd)
+      int4store(buff+28, MARIADB_CLIENT_ZSTD_COMPRESSION >> 32);
     end= buff+32;
   }
   else
@@ -3021,6 +3035,15 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
     mysql->server_language=end[2];
     mysql->server_status=uint2korr(end+3);
     mysql->server_capabilities|= ((unsigned) uint2korr(end+5)) << 16;
+    /* MariaDB servers send their extended capabilities in the filler */
+    if (uint4korr(end+14) & (CAN_CLIENT_ZSTD_COMPRESS >> 32))
+    {
+      ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+      if (mysql->options.extension)
+        mysql->options.extension->zstd_compression= 1;
+    }
+    else if (mysql->options.extension)
+      mysql->options.extension->zstd_compression= 0;
     pkt_scramble_len= end[7];
     if (pkt_scramble_len < 0)
     {
@@ -3120,7 +3143,16 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   */
 
   if (mysql->client_flag & CLIENT_COMPRESS)      /* We will use compression */
-    net->compress=1;
+  {
+    /* CLIENT_MYSQL was cleared when zstd was requested */
+    if (mysql->client_flag & CLIENT_MYSQL)
+      net->compress=1;
+    else if (net_enable_zstd_compression(net, NET_ZSTD_CLIENT_LEVEL))
+    {
+      set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      goto error;
+    }
+  }
 
   if (db && !mysql->db && mysql_select_db(mysql, db))
   {
@@ -253,6 +253,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 
   param.set_all_read_bits= filesort->set_all_read_bits;
   param.unpack= filesort->unpack;
+  param.parallel_threads= (uint) thd->variables.sort_parallel_threads;
 
   sort->addon_fields=  param.addon_fields;
   sort->sort_keys= param.sort_keys;
@@ -313,6 +314,17 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
     size_t min_sort_memory= MY_MAX(MIN_SORT_MEMORY,
                                    param.sort_length*MERGEBUFF2);
     set_if_bigger(min_sort_memory, sizeof(Merge_chunk*)*MERGEBUFF2);
+    /*
+      Do not let the sort buffer take more than half of what is left of
+      max_session_mem_used. A smaller buffer only means more merge passes
+      through the temporary file, while going over the limit kills the
+      statement.
+    */
+    longlong mem_left= (longlong) thd->variables.max_mem_used -
+                       thd->status_var.local_memory_used;
+    if (mem_left / 2 < (longlong) memory_available)
+      memory_available= MY_MAX((size_t) MY_MAX(mem_left / 2, 0),
+                               min_sort_memory);
     while (memory_available >= min_sort_memory)
     {
       ulonglong keys= memory_available / (param.rec_length + sizeof(char*));
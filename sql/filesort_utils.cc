@@ -19,6 +19,8 @@
 #include "sql_const.h"
 #include "sql_sort.h"
 #include "table.h"
+#include "mysqld.h"
+#include <queues.h>
 
 
 PSI_memory_key key_memory_Filesort_buffer_sort_keys;
@@ -159,30 +161,183 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
-void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+/**
+  Whether the keys can be ordered by a radix sort on the sort key bytes.
+  Packed sort keys have a variable length and must be compared field by
+  field.
+*/
+static bool radix_sort_is_applicable(const Sort_param *param, uint count)
+{
+  return !param->using_packed_sortkeys() && count >= MIN_KEYS_FOR_RADIX_SORT;
+}
+
+
+/**
+  Sort an array of key pointers.
+
+  @param param   sort parameters
+  @param keys    the key pointers to sort
+  @param count   number of elements in keys
+  @param buffer  scratch space of count pointers for radix sort, or NULL
+*/
+static void sort_key_pointers(const Sort_param *param, uchar **keys,
+                              uint count, uchar **buffer)
+{
+  size_t size= param->sort_length;
+
+  if (buffer && radix_sort_is_applicable(param, count))
+  {
+    /*
+      The key prefix is memcmp() comparable: short keys are best handled by
+      the LSD radix sort, longer ones by the MSD radix sort, which only
+      examines the leading bytes that are needed to order the keys.
+    */
+    if (radixsort_is_appliccable(count, size))
+      radixsort_for_str_ptr(keys, count, size, buffer);
+    else
+      radixsort_msd_for_str_ptr(keys, count, size, buffer);
+    return;
+  }
+
+  my_qsort2(keys, count, sizeof(uchar*),
+            param->get_compare_function(),
+            param->get_compare_argument(&size));
+}
+
+
+/**
+  A contiguous range of key pointers that one worker thread sorts,
+  and that is afterwards consumed by the k-way merge.
+*/
+struct Sort_run
+{
+  /** The key that the merge will output next; must be the first member */
+  uchar *m_current_key;
+  uchar **m_keys;
+  uchar **m_end;
+  uchar **m_buffer;
+  uint m_count;
+  const Sort_param *m_param;
+  pthread_t m_thread;
+  /** Whether m_thread was created for sorting this range */
+  bool m_spawned;
+};
+
+
+static void *sort_run_thread(void *arg)
+{
+  Sort_run *run= static_cast<Sort_run*>(arg);
+  my_thread_init();
+  sort_key_pointers(run->m_param, run->m_keys, run->m_count, run->m_buffer);
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Sort the key pointers by sorting up to param->parallel_threads ranges
+  concurrently and merging the sorted ranges.
+
+  @param param   sort parameters
+  @param keys    the key pointers to sort
+  @param count   number of elements in keys
+  @param n_runs  number of ranges to sort concurrently
+  @retval false  on success
+  @retval true   if resources could not be allocated; keys are unchanged
+*/
+static bool parallel_sort_key_pointers(const Sort_param *param, uchar **keys,
+                                       uint count, uint n_runs)
 {
   size_t size= param->sort_length;
+  Sort_run *runs;
+  uchar **buffer;
+  QUEUE queue;
+
+  if (!my_multi_malloc(PSI_INSTRUMENT_ME, MYF(MY_THREAD_SPECIFIC),
+                       &runs, n_runs * sizeof(Sort_run),
+                       &buffer, count * sizeof(uchar*), NullS))
+    return true;
+
+  if (init_queue(&queue, n_runs, offsetof(Sort_run, m_current_key), 0,
+                 (queue_compare) param->get_compare_function(),
+                 param->get_compare_argument(&size), 0, 0))
+  {
+    my_free(runs);
+    return true;
+  }
+
+  /* Run generation: the last range is sorted by the calling thread. */
+  const uint per_run= count / n_runs;
+  for (uint i= 0, start= 0; i < n_runs; i++, start+= per_run)
+  {
+    Sort_run *run= &runs[i];
+    run->m_keys= keys + start;
+    run->m_count= i == n_runs - 1 ? count - start : per_run;
+    run->m_end= run->m_keys + run->m_count;
+    run->m_buffer= buffer + start;
+    run->m_param= param;
+    run->m_spawned= i < n_runs - 1 &&
+      !mysql_thread_create(key_thread_sort, &run->m_thread, NULL,
+                           sort_run_thread, run);
+    if (!run->m_spawned)
+      sort_key_pointers(param, run->m_keys, run->m_count, run->m_buffer);
+  }
+
+  for (uint i= 0; i < n_runs - 1; i++)
+    if (runs[i].m_spawned)
+      pthread_join(runs[i].m_thread, NULL);
+
+  /* k-way merge of the sorted ranges into buffer */
+  for (uint i= 0; i < n_runs; i++)
+  {
+    runs[i].m_current_key= *runs[i].m_keys++;
+    queue_insert(&queue, (uchar*) &runs[i]);
+  }
+
+  uchar **to= buffer;
+  while (queue.elements)
+  {
+    Sort_run *run= (Sort_run*) queue_top(&queue);
+    *to++= run->m_current_key;
+    if (run->m_keys == run->m_end)
+      queue_remove_top(&queue);
+    else
+    {
+      run->m_current_key= *run->m_keys++;
+      queue_replace_top(&queue);
+    }
+  }
+  DBUG_ASSERT(to == buffer + count);
+
+  memcpy(keys, buffer, count * sizeof(uchar*));
+  delete_queue(&queue);
+  my_free(runs);
+  return false;
+}
+
+
+void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+{
   m_sort_keys= get_sort_keys();
 
-  if (count <= 1 || size == 0)
+  if (count <= 1 || param->sort_length == 0)
     return;
 
   // don't reverse for PQ, it is already done
   if (!param->using_pq)
     reverse_record_pointers();
 
-  uchar **buffer= NULL;
-  if (!param->using_packed_sortkeys() &&
-      radixsort_is_appliccable(count, param->sort_length) &&
-      (buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(char*),
-                                   MYF(MY_THREAD_SPECIFIC))))
-  {
-    radixsort_for_str_ptr(m_sort_keys, count, param->sort_length, buffer);
-    my_free(buffer);
+  /* Only sort in parallel if every thread gets a reasonable share. */
+  uint n_runs= MY_MIN(param->parallel_threads,
+                      count / MIN_KEYS_PER_SORT_THREAD);
+  if (n_runs > 1 &&
+      !parallel_sort_key_pointers(param, m_sort_keys, count, n_runs))
     return;
-  }
 
-  my_qsort2(m_sort_keys, count, sizeof(uchar*),
-            param->get_compare_function(),
-            param->get_compare_argument(&size));
+  uchar **buffer= NULL;
+  if (radix_sort_is_applicable(param, count))
+    buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(char*),
+                                MYF(MY_THREAD_SPECIFIC));
+  sort_key_pointers(param, m_sort_keys, count, buffer);
+  my_free(buffer);
 }
@@ -5210,6 +5210,7 @@ int ha_partition::rnd_next(uchar *buf)
     error= handle_pre_scan(FALSE, check_parallel_search());
     if (m_pre_calling || error)
       DBUG_RETURN(error);
+    prefetch_next_partition(part_id);
   }
 
   file= m_file[part_id];
@@ -5246,6 +5247,7 @@ int ha_partition::rnd_next(uchar *buf)
     m_part_spec.start_part= part_id;
     file= m_file[part_id];
     late_extra_cache(part_id);
+    prefetch_next_partition(part_id);
   }
 
 end:
@@ -9145,6 +9147,7 @@ int ha_partition::extra(enum ha_extra_function operation)
   case HA_EXTRA_BEGIN_ALTER_COPY:
   case HA_EXTRA_END_ALTER_COPY:
   case HA_EXTRA_FAKE_START_STMT:
+  case HA_EXTRA_PREFETCH_SCAN:
     DBUG_RETURN(loop_partitions(extra_cb, &operation));
   default:
   {
@@ -9393,6 +9396,35 @@ void ha_partition::late_extra_no_cache(uint partition_id)
 }
 
 
+/*
+  Call extra(HA_EXTRA_PREFETCH_SCAN) on the partition after partition_id
+
+  SYNOPSIS
+    prefetch_next_partition()
+    partition_id               Partition that is being scanned
+
+  RETURN VALUE
+    NONE
+
+  DESCRIPTION
+    The partitions of a table scan are read one after another, so the
+    engine of the next partition can read its first pages in the
+    background while the current partition is scanned.
+*/
+
+void ha_partition::prefetch_next_partition(uint partition_id)
+{
+  uint next_part_id;
+  DBUG_ENTER("ha_partition::prefetch_next_partition");
+
+  next_part_id= bitmap_get_next_set(&m_part_info->read_partitions,
+                                    partition_id);
+  if (next_part_id < m_tot_parts)
+    (void) m_file[next_part_id]->extra(HA_EXTRA_PREFETCH_SCAN);
+  DBUG_VOID_RETURN;
+}
+
+
 /****************************************************************************
                 MODULE optimiser support
 ****************************************************************************/
@@ -980,6 +980,7 @@ class ha_partition :public handler
   int loop_extra_alter(enum ha_extra_function operations);
   void late_extra_cache(uint partition_id);
   void late_extra_no_cache(uint partition_id);
+  void prefetch_next_partition(uint partition_id);
   void prepare_extra_cache(uint cachesize);
   handler *get_open_file_sample() const { return m_file_sample; }
 public:
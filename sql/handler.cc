@@ -5283,12 +5283,13 @@ void handler::get_dynamic_partition_info(PARTITION_STATS *stat_info,
 
 void handler::update_global_table_stats()
 {
-  TABLE_STATS * table_stats;
+  THD *thd= table->in_use;
+  TABLE_STATS *table_stats;
 
-  status_var_add(table->in_use->status_var.rows_read, rows_read);
+  status_var_add(thd->status_var.rows_read, rows_read);
   DBUG_ASSERT(rows_tmp_read == 0);
 
-  if (!table->in_use->userstat_running)
+  if (!thd->userstat_running)
   {
     rows_read= rows_changed= 0;
     return;
@@ -5300,42 +5301,42 @@ void handler::update_global_table_stats()
   DBUG_ASSERT(table->s);
   DBUG_ASSERT(table->s->table_cache_key.str);
 
-  mysql_mutex_lock(&LOCK_global_table_stats);
+  if (!thd->table_stats_hash_pins &&
+      !(thd->table_stats_hash_pins= lf_hash_get_pins(&global_table_stats)))
+    goto end;
+
   /* Gets the global table stats, creating one if necessary. */
-  if (!(table_stats= (TABLE_STATS*)
-        my_hash_search(&global_table_stats,
-                    (uchar*) table->s->table_cache_key.str,
-                    table->s->table_cache_key.length)))
-  {
-    if (!(table_stats = ((TABLE_STATS*)
-                         my_malloc(PSI_INSTRUMENT_ME, sizeof(TABLE_STATS),
-                                   MYF(MY_WME | MY_ZEROFILL)))))
-    {
-      /* Out of memory error already given */
-      goto end;
-    }
-    memcpy(table_stats->table, table->s->table_cache_key.str,
+  while (!(table_stats= (TABLE_STATS*)
+           lf_hash_search(&global_table_stats, thd->table_stats_hash_pins,
+                          table->s->table_cache_key.str,
+                          (uint) table->s->table_cache_key.length)))
+  {
+    TABLE_STATS new_stats;
+    bzero((char*) &new_stats, sizeof(new_stats));
+    memcpy(new_stats.table, table->s->table_cache_key.str,
            table->s->table_cache_key.length);
-    table_stats->table_name_length= (uint)table->s->table_cache_key.length;
-    table_stats->engine_type= ht->db_type;
-    /* No need to set variables to 0, as we use MY_ZEROFILL above */
-
-    if (my_hash_insert(&global_table_stats, (uchar*) table_stats))
-    {
-      /* Out of memory error is already given */
-      my_free(table_stats);
+    new_stats.table_name_length= (uint)table->s->table_cache_key.length;
+    new_stats.engine_type= ht->db_type;
+    /* 1 means that another thread inserted it first */
+    if (lf_hash_insert(&global_table_stats, thd->table_stats_hash_pins,
+                       &new_stats) < 0)
       goto end;
-    }
   }
+  if (table_stats == MY_ERRPTR)
+    goto end;
+
   // Updates the global table stats.
-  table_stats->rows_read+=    rows_read;
-  table_stats->rows_changed+= rows_changed;
-  table_stats->rows_changed_x_indexes+= (rows_changed *
-                                         (table->s->keys ? table->s->keys :
-                                          1));
-  rows_read= rows_changed= 0;
+  my_atomic_add64_explicit((int64*) &table_stats->rows_read, rows_read,
+                           MY_MEMORY_ORDER_RELAXED);
+  my_atomic_add64_explicit((int64*) &table_stats->rows_changed, rows_changed,
+                           MY_MEMORY_ORDER_RELAXED);
+  my_atomic_add64_explicit((int64*) &table_stats->rows_changed_x_indexes,
+                           rows_changed * (table->s->keys ? table->s->keys :
+                                           1),
+                           MY_MEMORY_ORDER_RELAXED);
+  lf_hash_search_unpin(thd->table_stats_hash_pins);
 end:
-  mysql_mutex_unlock(&LOCK_global_table_stats);
+  rows_read= rows_changed= 0;
 }
 
 
@@ -5345,9 +5346,12 @@ void handler::update_global_table_stats()
 
 void handler::update_global_index_stats()
 {
+  THD *thd= table->in_use;
   DBUG_ASSERT(table->s);
 
-  if (!table->in_use->userstat_running)
+  if (!thd->userstat_running ||
+      (!thd->index_stats_hash_pins &&
+       !(thd->index_stats_hash_pins= lf_hash_get_pins(&global_index_stats))))
   {
     /* Reset all index read values */
     bzero(index_rows_read, sizeof(index_rows_read[0]) * table->s->keys);
@@ -5366,30 +5370,28 @@ void handler::update_global_index_stats()
       if (!key_info->cache_name)
         continue;
       key_length= table->s->table_cache_key.length + key_info->name.length + 1;
-      mysql_mutex_lock(&LOCK_global_index_stats);
       // Gets the global index stats, creating one if necessary.
-      if (!(index_stats= (INDEX_STATS*) my_hash_search(&global_index_stats,
-                                                    key_info->cache_name,
-                                                    key_length)))
+      while (!(index_stats= (INDEX_STATS*)
+               lf_hash_search(&global_index_stats, thd->index_stats_hash_pins,
+                              key_info->cache_name, (uint) key_length)))
       {
-        if (!(index_stats = ((INDEX_STATS*)
-                             my_malloc(PSI_INSTRUMENT_ME, sizeof(INDEX_STATS),
-                                       MYF(MY_WME | MY_ZEROFILL)))))
-          goto end;                             // Error is already given
-
-        memcpy(index_stats->index, key_info->cache_name, key_length);
-        index_stats->index_name_length= key_length;
-        if (my_hash_insert(&global_index_stats, (uchar*) index_stats))
-        {
-          my_free(index_stats);
-          goto end;
-        }
+        INDEX_STATS new_stats;
+        bzero((char*) &new_stats, sizeof(new_stats));
+        memcpy(new_stats.index, key_info->cache_name, key_length);
+        new_stats.index_name_length= key_length;
+        if (lf_hash_insert(&global_index_stats, thd->index_stats_hash_pins,
+                           &new_stats) < 0)
+          break;
+      }
+      if (index_stats && index_stats != MY_ERRPTR)
+      {
+        /* Updates the global index stats. */
+        my_atomic_add64_explicit((int64*) &index_stats->rows_read,
+                                 index_rows_read[index],
+                                 MY_MEMORY_ORDER_RELAXED);
+        lf_hash_search_unpin(thd->index_stats_hash_pins);
       }
-      /* Updates the global index stats. */
-      index_stats->rows_read+= index_rows_read[index];
       index_rows_read[index]= 0;
-end:
-      mysql_mutex_unlock(&LOCK_global_index_stats);
     }
   }
 }
@@ -6619,6 +6621,8 @@ int handler::binlog_log_row(TABLE *table,
       thd->binlog_write_table_maps())
     DBUG_RETURN(HA_ERR_RBR_LOGGING_FAILED);
 
+  thd->binlog_add_writeset(table, row_logging_has_trans,
+                           before_record, after_record);
   error= (*log_func)(thd, table, row_logging_has_trans,
                      before_record, after_record);
   DBUG_RETURN(error ? HA_ERR_RBR_LOGGING_FAILED : 0);
@@ -7688,51 +7692,14 @@ bool HA_CREATE_INFO::check_conflicting_charset_declarations(CHARSET_INFO *cs)
   return false;
 }
 
-/* Remove all indexes for a given table from global index statistics */
-
-static
-int del_global_index_stats_for_table(THD *thd, uchar* cache_key, size_t cache_key_length)
-{
-  int res = 0;
-  DBUG_ENTER("del_global_index_stats_for_table");
-
-  mysql_mutex_lock(&LOCK_global_index_stats);
-
-  for (uint i= 0; i < global_index_stats.records;)
-  {
-    INDEX_STATS *index_stats =
-      (INDEX_STATS*) my_hash_element(&global_index_stats, i);
-
-    /* We search correct db\0table_name\0 string */
-    if (index_stats &&
-	index_stats->index_name_length >= cache_key_length &&
-	!memcmp(index_stats->index, cache_key, cache_key_length))
-    {
-      res= my_hash_delete(&global_index_stats, (uchar*)index_stats);
-      /*
-          In our HASH implementation on deletion one elements
-          is moved into a place where a deleted element was,
-          and the last element is moved into the empty space.
-          Thus we need to re-examine the current element, but
-          we don't have to restart the search from the beginning.
-      */
-    }
-    else
-      i++;
-  }
-
-  mysql_mutex_unlock(&LOCK_global_index_stats);
-  DBUG_RETURN(res);
-}
-
 /* Remove a table from global table statistics */
 
 int del_global_table_stat(THD *thd, const LEX_CSTRING *db, const LEX_CSTRING *table)
 {
-  TABLE_STATS *table_stats;
   int res = 0;
   uchar *cache_key;
   size_t cache_key_length;
+  LF_PINS *pins;
   DBUG_ENTER("del_global_table_stat");
 
   cache_key_length= db->length + 1 + table->length + 1;
@@ -7748,17 +7715,19 @@ int del_global_table_stat(THD *thd, const LEX_CSTRING *db, const LEX_CSTRING *ta
   memcpy(cache_key, db->str, db->length);
   memcpy(cache_key + db->length + 1, table->str, table->length);
 
-  res= del_global_index_stats_for_table(thd, cache_key, cache_key_length);
-
-  mysql_mutex_lock(&LOCK_global_table_stats);
+  /* Remove all indexes of the table; their keys start with cache_key */
+  res= delete_global_stats(&global_index_stats, cache_key, cache_key_length);
 
-  if((table_stats= (TABLE_STATS*) my_hash_search(&global_table_stats,
-                                                cache_key,
-                                                cache_key_length)))
-    res= my_hash_delete(&global_table_stats, (uchar*)table_stats);
+  if ((pins= lf_hash_get_pins(&global_table_stats)))
+  {
+    lf_hash_delete(&global_table_stats, pins, cache_key,
+                   (uint) cache_key_length);
+    lf_hash_put_pins(pins);
+  }
+  else
+    res= 1;
 
   my_free(cache_key);
-  mysql_mutex_unlock(&LOCK_global_table_stats);
 
 end:
   DBUG_RETURN(res);
@@ -7768,18 +7737,20 @@ int del_global_table_stat(THD *thd, const LEX_CSTRING *db, const LEX_CSTRING *ta
 
 int del_global_index_stat(THD *thd, TABLE* table, KEY* key_info)
 {
-  INDEX_STATS *index_stats;
   size_t key_length= table->s->table_cache_key.length + key_info->name.length + 1;
+  LF_PINS *pins;
   int res = 0;
   DBUG_ENTER("del_global_index_stat");
-  mysql_mutex_lock(&LOCK_global_index_stats);
 
-  if((index_stats= (INDEX_STATS*) my_hash_search(&global_index_stats,
-                                                key_info->cache_name,
-                                                key_length)))
-    res= my_hash_delete(&global_index_stats, (uchar*)index_stats);
+  if ((pins= lf_hash_get_pins(&global_index_stats)))
+  {
+    lf_hash_delete(&global_index_stats, pins, key_info->cache_name,
+                   (uint) key_length);
+    lf_hash_put_pins(pins);
+  }
+  else
+    res= 1;
 
-  mysql_mutex_unlock(&LOCK_global_index_stats);
   DBUG_RETURN(res);
 }
 
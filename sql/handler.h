@@ -349,7 +349,10 @@ enum chf_create_flags {
  */
 #define HA_ONLINE_ANALYZE             (1ULL << 59)
 
-#define HA_LAST_TABLE_FLAG HA_ONLINE_ANALYZE
+/* The engine implements handler::prefetch_keys() */
+#define HA_CAN_PREFETCH_KEYS          (1ULL << 60)
+
+#define HA_LAST_TABLE_FLAG HA_CAN_PREFETCH_KEYS
 
 
 /* bits in index_flags(index_number) for what you can do with index */
@@ -3930,6 +3933,19 @@ class handler :public Sql_alloc
     ha_rnd_end();
     return error;
   }
+  /**
+    Read the rows with the given keys into the engine's cache, possibly
+    with several threads, before they are looked up one by one. This is
+    only a hint: nothing is returned and errors are ignored.
+    Only called for handlers having HA_CAN_PREFETCH_KEYS set.
+
+    @param keynr       index of the keys
+    @param keys        n_keys keys in key_copy() format, each of
+                       key_length bytes
+  */
+  virtual void prefetch_keys(uint keynr, const uchar *keys, uint key_length,
+                             uint n_keys)
+  {}
   virtual int read_first_row(uchar *buf, uint primary_key);
 public:
 
@@ -620,6 +620,18 @@ bool Arg_comparator::set_cmp_func_int()
   }
   a= cache_converted_constant(thd, a, &a_cache, compare_type_handler());
   b= cache_converted_constant(thd, b, &b_cache, compare_type_handler());
+  /*
+    Integer literals do not change their value, unlike parameters
+    or cached expressions, so read it once instead of for every row.
+  */
+  if (func == &Arg_comparator::compare_int_signed &&
+      (*b)->type() == Item::CONST_ITEM && !(*b)->maybe_null &&
+      dynamic_cast<Item_int*>(*b))
+  {
+    b_int_item= *b;
+    b_int_value= b_int_item->val_int();
+    func= &Arg_comparator::compare_int_const;
+  }
   return false;
 }
 
@@ -949,6 +961,24 @@ int Arg_comparator::compare_int_signed()
 }
 
 
+/**
+  Compare a signed BIGINT value with an integer literal read by
+  set_cmp_func_int().
+*/
+
+int Arg_comparator::compare_int_const()
+{
+  if (unlikely(*b != b_int_item))
+    return compare_int_signed();
+  longlong val1= (*a)->val_int();
+  if (!(*a)->null_value)
+    return compare_not_null_values(val1, b_int_value);
+  if (set_null)
+    owner->null_value= 1;
+  return -1;
+}
+
+
 /**
   Compare values as BIGINT UNSIGNED.
 */
@@ -6010,6 +6040,16 @@ int Regexp_processor_pcre::pcre_exec_with_warn(const pcre2_code *code,
 #endif
   int rc= pcre2_match(code, (PCRE2_SPTR8) subject, (PCRE2_SIZE) length,
                       (PCRE2_SIZE) startoffset, options, data, mctx);
+  if (unlikely(rc == PCRE2_ERROR_JIT_STACKLIMIT))
+  {
+    /*
+      The default JIT stack is small. Fall back to the interpreter, which
+      is bound by the limits above.
+    */
+    rc= pcre2_match(code, (PCRE2_SPTR8) subject, (PCRE2_SIZE) length,
+                    (PCRE2_SIZE) startoffset, options | PCRE2_NO_JIT, data,
+                    mctx);
+  }
   pcre2_match_context_free(mctx); // NULL is ok here
   DBUG_EXECUTE_IF("pcre_exec_error_123", rc= -123;);
   if (unlikely(rc < PCRE2_ERROR_NOMATCH))
@@ -6079,6 +6119,12 @@ void Regexp_processor_pcre::fix_owner(Item_func *owner,
       return;
     }
     set_const(true);
+    /*
+      A constant pattern is matched against every row, so compile it to
+      machine code. If the library has no JIT support, this fails and
+      pcre2_match() keeps using the interpreter.
+    */
+    pcre2_jit_compile(m_pcre, PCRE2_JIT_COMPLETE);
     owner->maybe_null= subject_arg->maybe_null;
   }
   else
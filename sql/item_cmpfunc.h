@@ -55,6 +55,8 @@ class Arg_comparator: public Sql_alloc
   /* Fields used in DATE/DATETIME comparison. */
   Item *a_cache, *b_cache;         // Cached values of a and b items
                                    //   when one of arguments is NULL.
+  Item *b_int_item;                // Integer literal of compare_int_const()
+  longlong b_int_value;            //   and its value
 
   int set_cmp_func(Item_func_or_sum *owner_arg, Item **a1, Item **a2);
 
@@ -75,12 +77,12 @@ class Arg_comparator: public Sql_alloc
     m_compare_handler(&type_handler_null),
     m_compare_collation(&my_charset_bin),
     set_null(TRUE), comparators(0),
-    a_cache(0), b_cache(0) {};
+    a_cache(0), b_cache(0), b_int_item(0) {};
   Arg_comparator(Item **a1, Item **a2): a(a1), b(a2),
     m_compare_handler(&type_handler_null),
     m_compare_collation(&my_charset_bin),
     set_null(TRUE), comparators(0),
-    a_cache(0), b_cache(0) {};
+    a_cache(0), b_cache(0), b_int_item(0) {};
 
 public:
   bool set_cmp_func_for_row_arguments();
@@ -105,6 +107,7 @@ class Arg_comparator: public Sql_alloc
   int compare_real();            // compare args[0] & args[1]
   int compare_decimal();         // compare args[0] & args[1]
   int compare_int_signed();      // compare args[0] & args[1]
+  int compare_int_const();       // compare args[0] & integer literal
   int compare_int_signed_unsigned();
   int compare_int_unsigned_signed();
   int compare_int_unsigned();
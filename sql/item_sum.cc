@@ -1492,6 +1492,10 @@ Item_sum_sum::Item_sum_sum(THD *thd, Item_sum_sum *item)
   {
     my_decimal2decimal(item->dec_buffs, dec_buffs);
     my_decimal2decimal(item->dec_buffs + 1, dec_buffs + 1);
+#ifdef __SIZEOF_INT128__
+    dec_int_sum= item->dec_int_sum;
+    dec_int_sum_used= item->dec_int_sum_used;
+#endif
   }
   else
     sum= item->sum;
@@ -1521,6 +1525,10 @@ void Item_sum_sum::clear()
   {
     curr_dec_buff= 0;
     my_decimal_set_zero(dec_buffs);
+#ifdef __SIZEOF_INT128__
+    dec_int_sum= 0;
+    dec_int_sum_used= false;
+#endif
   }
   else
     sum= 0.0;
@@ -1547,6 +1555,10 @@ void Item_sum_sum::fix_length_and_dec_decimal()
                                                            unsigned_flag);
   curr_dec_buff= 0;
   my_decimal_set_zero(dec_buffs);
+#ifdef __SIZEOF_INT128__
+  dec_int_sum= 0;
+  dec_int_sum_used= false;
+#endif
 }
 
 
@@ -1602,6 +1614,42 @@ bool Item_sum_sum::add()
   DBUG_RETURN(0);
 }
 
+/**
+  Add a value to or subtract it from the DECIMAL sum.
+*/
+void Item_sum_sum::dec_add(const my_decimal *val, bool subtract)
+{
+#ifdef __SIZEOF_INT128__
+  /*
+    Values with up to 18 integer digits are less than 10^36 when scaled,
+    so that dec_int_sum cannot overflow while it is less than 10^37.
+  */
+  static const __int128 max_int_sum=
+    (__int128) log_10_int[18] * (__int128) log_10_int[19];
+  __int128 value;
+  if (args[0]->decimals <= MY_DECIMAL_INT128_MAX_SCALE &&
+      !my_decimal2int128(val, args[0]->decimals, &value))
+  {
+    if (dec_int_sum >= max_int_sum || dec_int_sum <= -max_int_sum)
+      dec_flush();
+    if (subtract)
+      dec_int_sum-= value;
+    else
+      dec_int_sum+= value;
+    dec_int_sum_used= true;
+    return;
+  }
+#endif
+  if (subtract)
+    my_decimal_sub(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                   dec_buffs + curr_dec_buff, val);
+  else
+    my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                   val, dec_buffs + curr_dec_buff);
+  curr_dec_buff^= 1;
+}
+
+
 void Item_sum_sum::add_helper(bool perform_removal)
 {
   DBUG_ENTER("Item_sum_sum::add_helper");
@@ -1633,8 +1681,7 @@ void Item_sum_sum::add_helper(bool perform_removal)
         {
           if (count > 0)
           {
-            my_decimal_sub(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
-              dec_buffs + curr_dec_buff, val);
+            dec_add(val, true);
             count--;
           }
           else
@@ -1643,10 +1690,8 @@ void Item_sum_sum::add_helper(bool perform_removal)
         else
         {
           count++;
-          my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
-            val, dec_buffs + curr_dec_buff);
+          dec_add(val, false);
         }
-        curr_dec_buff^= 1;
         null_value= (count > 0) ? 0 : 1;
       }
     }
@@ -1698,7 +1743,10 @@ longlong Item_sum_sum::val_int()
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    dec_flush();
     return dec_buffs[curr_dec_buff].to_longlong(unsigned_flag);
+  }
   return val_int_from_real();
 }
 
@@ -1709,7 +1757,10 @@ double Item_sum_sum::val_real()
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    dec_flush();
     sum= dec_buffs[curr_dec_buff].to_double();
+  }
   return sum;
 }
 
@@ -1729,7 +1780,10 @@ my_decimal *Item_sum_sum::val_decimal(my_decimal *val)
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    dec_flush();
     return null_value ? NULL : (dec_buffs + curr_dec_buff);
+  }
   return val_decimal_from_real(val);
 }
 
@@ -1944,6 +1998,131 @@ void Item_sum_count::cleanup()
 }
 
 
+/*
+  Approximate count of distinct values
+*/
+
+/* The finalizer of MurmurHash3, to spread the bits of a hash value */
+
+static inline ulonglong approx_count_distinct_mix(ulonglong h)
+{
+  h^= h >> 33;
+  h*= 0xff51afd7ed558ccdULL;
+  h^= h >> 33;
+  h*= 0xc4ceb9fe1a85ec53ULL;
+  h^= h >> 33;
+  return h;
+}
+
+
+Item_sum_approx_count_distinct::
+Item_sum_approx_count_distinct(THD *thd, Item *item_par)
+  :Item_sum_int(thd, item_par),
+   registers((uchar*) thd->calloc(APPROX_COUNT_DISTINCT_REGISTERS))
+{
+  quick_group= 0;
+}
+
+
+Item_sum_approx_count_distinct::
+Item_sum_approx_count_distinct(THD *thd, Item_sum_approx_count_distinct *item)
+  :Item_sum_int(thd, item),
+   registers((uchar*) thd->alloc(APPROX_COUNT_DISTINCT_REGISTERS))
+{
+  if (registers)
+    memcpy(registers, item->registers, APPROX_COUNT_DISTINCT_REGISTERS);
+}
+
+
+Item *Item_sum_approx_count_distinct::copy_or_same(THD* thd)
+{
+  Item_sum_approx_count_distinct *item= new (thd->mem_root)
+    Item_sum_approx_count_distinct(thd, this);
+  return item && item->registers ? item : NULL;
+}
+
+
+void Item_sum_approx_count_distinct::clear()
+{
+  bzero(registers, APPROX_COUNT_DISTINCT_REGISTERS);
+}
+
+
+/*
+  Hash the value and keep, in the register that the first bits of the
+  hash select, the largest position of the first 1-bit in the rest of it.
+  Values that are equal in the collation of the argument get the same
+  hash.
+*/
+
+bool Item_sum_approx_count_distinct::add()
+{
+  ulonglong hash;
+  switch (args[0]->cmp_type()) {
+  case INT_RESULT:
+  {
+    longlong nr= args[0]->val_int();
+    if (args[0]->null_value)
+      return 0;
+    hash= (ulonglong) nr;
+    break;
+  }
+  case REAL_RESULT:
+  {
+    double nr= args[0]->val_real();
+    if (args[0]->null_value)
+      return 0;
+    if (nr == 0.0)
+      nr= 0.0;                                  // -0.0 and 0.0 are equal
+    memcpy(&hash, &nr, sizeof(hash));
+    break;
+  }
+  default:
+  {
+    StringBuffer<STRING_BUFFER_USUAL_SIZE> buf;
+    String *res= args[0]->val_str(&buf);
+    if (!res)
+      return 0;
+    ulong nr1= 1, nr2= 4;
+    res->charset()->hash_sort((const uchar*) res->ptr(), res->length(),
+                              &nr1, &nr2);
+    hash= nr1;
+    break;
+  }
+  }
+
+  hash= approx_count_distinct_mix(hash);
+  uint idx= (uint) (hash >> (64 - APPROX_COUNT_DISTINCT_PRECISION));
+  ulonglong rest= hash << APPROX_COUNT_DISTINCT_PRECISION;
+  uchar rank= (uchar) (rest ? 64 - my_bit_log2_uint64(rest)
+                            : 64 - APPROX_COUNT_DISTINCT_PRECISION + 1);
+  if (registers[idx] < rank)
+    registers[idx]= rank;
+  return 0;
+}
+
+
+longlong Item_sum_approx_count_distinct::val_int()
+{
+  DBUG_ASSERT(fixed == 1);
+  const double m= APPROX_COUNT_DISTINCT_REGISTERS;
+  double sum= 0;
+  uint zeros= 0;
+  for (uint i= 0; i < APPROX_COUNT_DISTINCT_REGISTERS; i++)
+  {
+    sum+= ldexp(1.0, -(int) registers[i]);
+    if (!registers[i])
+      zeros++;
+  }
+  double estimate= 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  /* Small cardinalities are estimated better by linear counting */
+  if (estimate <= 2.5 * m && zeros)
+    estimate= m * log(m / zeros);
+  null_value= 0;
+  return (longlong) (estimate + 0.5);
+}
+
+
 /*
   Average
 */
@@ -2073,6 +2252,7 @@ my_decimal *Item_sum_avg::val_decimal(my_decimal *val)
   if (result_type() != DECIMAL_RESULT)
     return val_decimal_from_real(val);
 
+  dec_flush();
   sum_dec= dec_buffs + curr_dec_buff;
   int2my_decimal(E_DEC_FATAL_ERROR, count, 0, &cnt);
   my_decimal_div(E_DEC_FATAL_ERROR, val, sum_dec, &cnt, prec_increment);
@@ -356,7 +356,7 @@ class Item_sum :public Item_func_or_sum
     CUME_DIST_FUNC, NTILE_FUNC, FIRST_VALUE_FUNC, LAST_VALUE_FUNC,
     NTH_VALUE_FUNC, LEAD_FUNC, LAG_FUNC, PERCENTILE_CONT_FUNC,
     PERCENTILE_DISC_FUNC, SP_AGGREGATE_FUNC, JSON_ARRAYAGG_FUNC,
-    JSON_OBJECTAGG_FUNC
+    JSON_OBJECTAGG_FUNC, APPROX_COUNT_DISTINCT_FUNC
   };
 
   Item **ref_by; /* pointer to a ref to the object used to register it */
@@ -430,6 +430,7 @@ class Item_sum :public Item_func_or_sum
     case UDF_SUM_FUNC:
     case GROUP_CONCAT_FUNC:
     case JSON_ARRAYAGG_FUNC:
+    case APPROX_COUNT_DISTINCT_FUNC:
       return true;
     default:
       return false;
@@ -797,7 +798,34 @@ class Item_sum_sum :public Item_sum_num,
   my_decimal direct_sum_decimal;
   my_decimal dec_buffs[2];
   uint curr_dec_buff;
+#ifdef __SIZEOF_INT128__
+  /*
+    Part of the DECIMAL sum that is not in dec_buffs yet, as an integer
+    scaled by 10^args[0]->decimals. Small values are added here, which
+    is much faster than my_decimal_add().
+  */
+  __int128 dec_int_sum;
+  /* Whether any value was added to dec_int_sum since dec_flush() */
+  bool dec_int_sum_used;
+#endif
   bool fix_length_and_dec();
+  void dec_add(const my_decimal *val, bool subtract);
+  /** Add the pending part of the DECIMAL sum to dec_buffs */
+  void dec_flush()
+  {
+#ifdef __SIZEOF_INT128__
+    if (dec_int_sum_used)
+    {
+      my_decimal value;
+      int128_to_my_decimal(dec_int_sum, args[0]->decimals, &value);
+      dec_int_sum= 0;
+      dec_int_sum_used= false;
+      my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                     &value, dec_buffs + curr_dec_buff);
+      curr_dec_buff^= 1;
+    }
+#endif
+  }
 
 public:
   Item_sum_sum(THD *thd, Item *item_par, bool distinct):
@@ -919,6 +947,43 @@ class Item_sum_count :public Item_sum_int
 };
 
 
+/*
+  APPROX_COUNT_DISTINCT(expr) estimates the number of distinct non-NULL
+  values with a HyperLogLog sketch of APPROX_COUNT_DISTINCT_REGISTERS
+  one-byte registers instead of keeping the values in a Unique tree.
+  The standard error of the estimate is about 1.6%.
+*/
+
+#define APPROX_COUNT_DISTINCT_PRECISION 12
+#define APPROX_COUNT_DISTINCT_REGISTERS (1U << APPROX_COUNT_DISTINCT_PRECISION)
+
+class Item_sum_approx_count_distinct final :public Item_sum_int
+{
+  uchar *registers;
+public:
+  Item_sum_approx_count_distinct(THD *thd, Item *item_par);
+  Item_sum_approx_count_distinct(THD *thd,
+                                 Item_sum_approx_count_distinct *item);
+  enum Sumfunctype sum_func () const { return APPROX_COUNT_DISTINCT_FUNC; }
+  const Type_handler *type_handler() const { return &type_handler_slonglong; }
+  bool fix_length_and_dec()
+  {
+    if (!registers)
+      return true;
+    return Item_sum_int::fix_length_and_dec();
+  }
+  void clear();
+  bool add();
+  longlong val_int();
+  void reset_field() { DBUG_ASSERT(0); }        // not used
+  void update_field() { DBUG_ASSERT(0); }       // not used
+  const char *func_name() const { return "approx_count_distinct("; }
+  Item *copy_or_same(THD* thd);
+  Item *get_copy(THD *thd)
+  { return get_item_copy<Item_sum_approx_count_distinct>(thd, this); }
+};
+
+
 class Item_sum_avg :public Item_sum_sum
 {
 public:
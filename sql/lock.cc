@@ -78,6 +78,7 @@
 #include "sql_base.h"                       // close_tables_for_reopen
 #include "sql_parse.h"                     // is_log_table_write_query
 #include "sql_handler.h"
+#include "sp_cache.h"                      // sp_cache_invalidate
 #include <hash.h>
 #include "wsrep_mysqld.h"
 
@@ -151,7 +152,15 @@ lock_tables_check(THD *thd, TABLE **tables, uint count, uint flags)
     if (t->reginfo.lock_type >= TL_WRITE_ALLOW_WRITE)
     {
       if (t->s->table_category == TABLE_CATEGORY_SYSTEM)
+      {
         system_count++;
+        /*
+          Make the routines be read again if mysql.proc is modified
+          directly, as the definitions of the routines are cached.
+        */
+        if (lex_string_eq(&t->s->table_name, &MYSQL_PROC_NAME))
+          sp_cache_invalidate();
+      }
 
       if (t->db_stat & HA_READ_ONLY)
       {
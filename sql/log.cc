@@ -263,6 +263,22 @@ void make_default_log_name(char **out, const char* log_ext, bool once)
 }
 
 
+/*
+  Checksum of the data of an event in a binlog cache, without the event
+  header, which is only known when the cache is written to the binary log.
+*/
+struct binlog_data_checksum
+{
+  my_off_t pos;                                 // Position of the event
+  ha_checksum crc;
+};
+
+/*
+  Number of event checksums kept allocated by a binlog cache between
+  transactions
+*/
+#define BINLOG_CACHE_CHECKSUMS_KEEP 1024
+
 /*
   Helper classes to store non-transactional and transactional data
   before copying it to the binary log.
@@ -275,12 +291,16 @@ class binlog_cache_data
   incident(FALSE), changes_to_non_trans_temp_table_flag(FALSE),
   saved_max_binlog_cache_size(0), ptr_binlog_cache_use(0),
   ptr_binlog_cache_disk_use(0)
-  { }
+  {
+    my_init_dynamic_array(key_memory_binlog_cache_mngr, &checksums,
+                          sizeof(binlog_data_checksum), 0, 64, MYF(0));
+  }
   
   ~binlog_cache_data()
   {
     DBUG_ASSERT(empty());
     close_cached_file(&cache_log);
+    delete_dynamic(&checksums);
   }
 
   /*
@@ -346,6 +366,8 @@ class binlog_cache_data
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    if (checksums.max_element > BINLOG_CACHE_CHECKSUMS_KEEP)
+      delete_dynamic(&checksums);
     DBUG_ASSERT(empty());
   }
 
@@ -411,11 +433,30 @@ class binlog_cache_data
     status|= status_arg;
   }
 
+  /*
+    Remember the checksum of the data of the event at position pos of the
+    cache. If memory runs out, write_cache() computes it under LOCK_log.
+  */
+  void add_checksum(my_off_t pos, ha_checksum crc)
+  {
+    binlog_data_checksum *sum;
+    if ((sum= (binlog_data_checksum*) alloc_dynamic(&checksums)))
+    {
+      sum->pos= pos;
+      sum->crc= crc;
+    }
+  }
+
   /*
     Cache to store data before copying it to the binary log.
   */
   IO_CACHE cache_log;
 
+  /*
+    Checksums of the event data in the cache, in the order of the events
+  */
+  DYNAMIC_ARRAY checksums;
+
 private:
   /*
     Pending binrows event. This event is the event where the rows are currently
@@ -501,6 +542,10 @@ class binlog_cache_data
     }
     reinit_io_cache(&cache_log, WRITE_CACHE, pos, 0, reset_cache);
     cache_log.end_of_file= saved_max_binlog_cache_size;
+    while (checksums.elements &&
+           dynamic_element(&checksums, checksums.elements - 1,
+                           binlog_data_checksum*)->pos >= pos)
+      checksums.elements--;
   }
 
   binlog_cache_data& operator=(const binlog_cache_data& info);
@@ -519,6 +564,11 @@ void Log_event_writer::set_incident()
   cache_data->set_incident();
 }
 
+void Log_event_writer::add_data_checksum()
+{
+  cache_data->add_checksum(event_start, crc);
+}
+
 
 class binlog_cache_mngr {
 public:
@@ -528,8 +578,11 @@ class binlog_cache_mngr {
                     ulong *param_ptr_binlog_stmt_cache_disk_use,
                     ulong *param_ptr_binlog_cache_use,
                     ulong *param_ptr_binlog_cache_disk_use)
-    : last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0)
+    : last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0),
+      writeset_invalid(FALSE)
   {
+     my_init_dynamic_array(key_memory_binlog_cache_mngr, &writeset,
+                           sizeof(ulonglong), 16, 64, MYF(0));
      stmt_cache.set_binlog_cache_info(param_max_binlog_stmt_cache_size,
                                       param_ptr_binlog_stmt_cache_use,
                                       param_ptr_binlog_stmt_cache_disk_use);
@@ -539,6 +592,11 @@ class binlog_cache_mngr {
      last_commit_pos_file[0]= 0;
   }
 
+  ~binlog_cache_mngr()
+  {
+    delete_dynamic(&writeset);
+  }
+
   void reset(bool do_stmt, bool do_trx)
   {
     if (do_stmt)
@@ -549,9 +607,17 @@ class binlog_cache_mngr {
       using_xa= FALSE;
       last_commit_pos_file[0]= 0;
       last_commit_pos_offset= 0;
+      reset_dynamic(&writeset);
+      writeset_invalid= FALSE;
     }
   }
 
+  void invalidate_writeset()
+  {
+    writeset_invalid= TRUE;
+    reset_dynamic(&writeset);
+  }
+
   binlog_cache_data* get_binlog_cache_data(bool is_transactional)
   {
     return (is_transactional ? &trx_cache : &stmt_cache);
@@ -591,6 +657,18 @@ class binlog_cache_mngr {
   /* Set if we get an error during commit that must be returned from unlog(). */
   bool delayed_error;
 
+  /*
+    Hashes of the unique key values modified by the transaction, logged in
+    its Gtid_log_event when binlog_transaction_dependency_tracking=WRITESET.
+    See THD::binlog_add_writeset().
+  */
+  DYNAMIC_ARRAY writeset;
+  /*
+    Set when the writeset does not cover all changes of the transaction, so
+    that the slave must not apply it in parallel based on the writeset.
+  */
+  bool writeset_invalid;
+
 private:
 
   binlog_cache_mngr& operator=(const binlog_cache_mngr& info);
@@ -3392,7 +3470,7 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
    checksum_alg_reset(BINLOG_CHECKSUM_ALG_UNDEF),
    relay_log_checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF),
    description_event_for_exec(0), description_event_for_queue(0),
-   current_binlog_id(0)
+   current_binlog_id(0), binlog_verified_pos(0)
 {
   /*
     We don't want to initialize locks here as such initialization depends on
@@ -5449,14 +5527,12 @@ int MYSQL_BIN_LOG::new_file_impl()
 bool MYSQL_BIN_LOG::write_event(Log_event *ev, binlog_cache_data *cache_data,
                                 IO_CACHE *file)
 {
-  Log_event_writer writer(file, 0, &crypto);
+  Log_event_writer writer(file, cache_data, &crypto);
   if (crypto.scheme && file == &log_file)
   {
     writer.ctx= alloca(crypto.ctx_size);
     writer.set_encrypted_writer();
   }
-  if (cache_data)
-    cache_data->add_status(ev->logged_status());
   return writer.write(ev);
 }
 
@@ -5764,6 +5840,110 @@ binlog_cache_mngr *THD::binlog_setup_trx_data()
   DBUG_RETURN(cache_mngr);
 }
 
+/*
+  Upper limit for the number of hashes in the writeset of a transaction.
+  Larger transactions are applied by the slave without regard to their
+  writeset.
+*/
+static const uint BINLOG_WRITESET_MAX_SIZE= 4096;
+
+
+/*
+  Add the hashes of the unique key values of one record to the writeset.
+
+  @return TRUE if some change of the record can not be described by
+  the writeset.
+*/
+static bool binlog_writeset_add_record(binlog_cache_mngr *cache_mngr,
+                                       TABLE *table, const uchar *record,
+                                       bool check_read_set)
+{
+  my_ptrdiff_t diff= record - table->record[0];
+  uint hashed_keys= 0;
+
+  for (uint i= 0; i < table->s->keys; i++)
+  {
+    KEY *key= table->key_info + i;
+    KEY_PART_INFO *key_part, *key_part_end;
+    bool null_found= FALSE;
+
+    if (!(key->flags & HA_NOSAME))
+      continue;
+    if (key->algorithm == HA_KEY_ALG_LONG_HASH)
+      return TRUE;
+
+    key_part_end= key_part= key->key_part;
+    key_part_end+= key->user_defined_key_parts;
+    for (; key_part < key_part_end; key_part++)
+    {
+      Field *field= key_part->field;
+      /* Blobs and prefixes do not compare like the indexed value */
+      if ((field->flags & BLOB_FLAG) ||
+          key_part->length < field->key_length())
+        return TRUE;
+      /* A column that was not read has no value in the record */
+      if (check_read_set &&
+          !bitmap_is_set(table->read_set, field->field_index))
+        return TRUE;
+      if (field->is_null(diff))
+        null_found= TRUE;
+    }
+    /* NULL values never conflict with each other in a unique key */
+    if (null_found)
+      continue;
+
+    ulong nr= 1, nr2= 4;
+    my_charset_bin.hash_sort((const uchar *) table->s->table_cache_key.str,
+                             table->s->table_cache_key.length, &nr, &nr2);
+    my_charset_bin.hash_sort((const uchar *) key->name.str, key->name.length,
+                             &nr, &nr2);
+    for (key_part= key->key_part; key_part < key_part_end; key_part++)
+    {
+      Field *field= key_part->field;
+      field->move_field_offset(diff);
+      field->hash(&nr, &nr2);
+      field->move_field_offset(-diff);
+    }
+    ulonglong hash= (ulonglong) nr ^ ((ulonglong) nr2 << 32);
+    if (insert_dynamic(&cache_mngr->writeset, (uchar *) &hash) ||
+        cache_mngr->writeset.elements > BINLOG_WRITESET_MAX_SIZE)
+      return TRUE;
+    hashed_keys++;
+  }
+  /* Without a unique key the row could be changed by any other transaction */
+  return hashed_keys == 0;
+}
+
+
+/*
+  Add the unique key values of a row changed by the transaction to its
+  writeset.
+
+  The writeset is invalidated, so that the slave applies the transaction
+  without regard to it, when a change can not be described by unique key
+  values: for changes to non-transactional tables or tables referenced by
+  foreign keys, rows without a not NULL unique key, or when dependency
+  tracking was not enabled for all of the transaction.
+*/
+void THD::binlog_add_writeset(TABLE *table, bool is_trans,
+                              const uchar *before_record,
+                              const uchar *after_record)
+{
+  binlog_cache_mngr *const cache_mngr= binlog_setup_trx_data();
+
+  if (!cache_mngr || cache_mngr->writeset_invalid)
+    return;
+  if (opt_binlog_dependency_tracking != BINLOG_DEPENDENCY_TRACKING_WRITESET ||
+      !is_trans || table->file->referenced_by_foreign_key() ||
+      (before_record &&
+       binlog_writeset_add_record(cache_mngr, table, before_record, TRUE)) ||
+      (after_record &&
+       binlog_writeset_add_record(cache_mngr, table, after_record,
+                                  before_record != NULL)))
+    cache_mngr->invalidate_writeset();
+}
+
+
 /*
   Function to start a statement and optionally a transaction for the
   binary log.
@@ -6280,6 +6460,16 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
                             LOG_EVENT_SUPPRESS_USE_F, is_transactional,
                             commit_id);
 
+  if (!standalone && is_transactional &&
+      opt_binlog_dependency_tracking == BINLOG_DEPENDENCY_TRACKING_WRITESET)
+  {
+    binlog_cache_mngr *cache_mngr=
+      (binlog_cache_mngr*) thd_get_ha_data(thd, binlog_hton);
+    if (cache_mngr && !cache_mngr->writeset_invalid)
+      gtid_event.set_writeset((ulonglong *) cache_mngr->writeset.buffer,
+                              cache_mngr->writeset.elements);
+  }
+
   /* Write the event to the binary log. */
   DBUG_ASSERT(this == &mysql_bin_log);
 
@@ -6632,6 +6822,8 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       is_trans_cache= use_trans_cache(thd, using_trans);
       cache_data= cache_mngr->get_binlog_cache_data(is_trans_cache);
       file= &cache_data->cache_log;
+      /* Statements in the binlog may change any rows on the slave */
+      cache_mngr->invalidate_writeset();
 
       if (thd->lex->stmt_accessed_non_trans_temp_table())
         cache_data->set_changes_to_non_trans_temp_table();
@@ -7221,11 +7413,26 @@ class CacheWriter: public Log_event_writer
   size_t remains;
 
   CacheWriter(THD *thd_arg, IO_CACHE *file_arg, bool do_checksum,
-              Binlog_crypt_data *cr)
+              Binlog_crypt_data *cr, DYNAMIC_ARRAY *checksums)
     : Log_event_writer(file_arg, 0, cr), remains(0), thd(thd_arg),
-      first(true)
+      first(true),
+      next_sum(dynamic_element(checksums, 0, binlog_data_checksum*)),
+      end_sum(next_sum + checksums->elements)
   { checksum_len= do_checksum ? BINLOG_CHECKSUM_LEN : 0; }
 
+  /*
+    Look up the checksum of the data of the event at position pos of the
+    cache, which is passed to write() next
+  */
+  void find_data_checksum(my_off_t pos)
+  {
+    while (next_sum < end_sum && next_sum->pos < pos)
+      next_sum++;
+    if ((data_checksum_known= checksum_len && next_sum < end_sum &&
+                              next_sum->pos == pos))
+      data_checksum= next_sum->crc;
+  }
+
   ~CacheWriter()
   { status_var_add(thd->status_var.binlog_bytes_written, bytes_written); }
 
@@ -7245,6 +7452,7 @@ class CacheWriter: public Log_event_writer
 private:
   THD *thd;
   bool first;
+  const binlog_data_checksum *next_sum, *end_sum;
 };
 
 /*
@@ -7252,8 +7460,8 @@ class CacheWriter: public Log_event_writer
 
   SYNOPSIS
     write_cache()
-    thd      Current_thread
-    cache    Cache to write to the binary log
+    thd         Current_thread
+    cache_data  Cache to write to the binary log
 
   DESCRIPTION
     Write the contents of the cache to the binary log. The cache will
@@ -7262,12 +7470,17 @@ class CacheWriter: public Log_event_writer
     Reading from the trans cache with possible (per @c binlog_checksum_options) 
     adding checksum value  and then fixing the length and the end_log_pos of 
     events prior to fill in the binlog cache.
+
+    The checksums of the event data were mostly computed when the events
+    were written to the cache, so that only the event headers need to be
+    checksummed here, under LOCK_log.
 */
 
-int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
+int MYSQL_BIN_LOG::write_cache(THD *thd, binlog_cache_data *cache_data)
 {
   DBUG_ENTER("MYSQL_BIN_LOG::write_cache");
 
+  IO_CACHE *cache= &cache_data->cache_log;
   mysql_mutex_assert_owner(&LOCK_log);
   if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
     DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -7275,7 +7488,8 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
   size_t val;
   size_t end_log_pos_inc= 0; // each event processed adds BINLOG_CHECKSUM_LEN 2 t
   uchar header[LOG_EVENT_HEADER_LEN];
-  CacheWriter writer(thd, &log_file, binlog_checksum_options, &crypto);
+  CacheWriter writer(thd, &log_file, binlog_checksum_options, &crypto,
+                     &cache_data->checksums);
 
   if (crypto.scheme)
   {
@@ -7329,6 +7543,7 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
       len+= writer.checksum_len;
       int4store(header + EVENT_LEN_OFFSET, len);
 
+      writer.find_data_checksum(my_b_tell(cache) - carry);
       if (writer.write(header, LOG_EVENT_HEADER_LEN))
         DBUG_RETURN(ER_ERROR_ON_WRITE);
 
@@ -7397,6 +7612,7 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
           int4store(ev + EVENT_LEN_OFFSET, ev_len + writer.checksum_len);
 
           writer.remains= ev_len;
+          writer.find_data_checksum(my_b_tell(cache) + hdr_offs);
           if (writer.write(ev, MY_MIN(ev_len, length - hdr_offs)))
             DBUG_RETURN(ER_ERROR_ON_WRITE);
 
@@ -8418,26 +8634,35 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   }
 
   /*
-    Wakeup each participant waiting for our group commit, first calling the
-    commit_ordered() methods for any transactions doing 2-phase commit.
+    Call the commit_ordered() methods for any transactions doing 2-phase
+    commit, in the binlog order.
   */
-  current= queue;
-  while (current != NULL)
+  for (current= queue; current != NULL; current= current->next)
   {
-    group_commit_entry *next;
-
     DEBUG_SYNC(leader->thd, "commit_loop_entry_commit_ordered");
     ++num_commits;
     if (current->cache_mngr->using_xa && likely(!current->error) &&
         DBUG_EVALUATE_IF("skip_commit_ordered", 0, 1))
       run_commit_ordered(current->thd, current->all);
     current->thd->wakeup_subsequent_commits(current->error);
+  }
+  DEBUG_SYNC(leader->thd, "commit_after_group_run_commit_ordered");
+  mysql_mutex_unlock(&LOCK_commit_ordered);
 
+  /*
+    Wakeup each participant waiting for our group commit. This is done after
+    releasing LOCK_commit_ordered, so that the next group can run its
+    commit_ordered() calls while we signal the participants of this one. The
+    participants are still sleeping, so nobody else can touch the queue.
+  */
+  current= queue;
+  while (current != NULL)
+  {
     /*
       Careful not to access current->next after waking up the other thread! As
       it may change immediately after wakeup.
     */
-    next= current->next;
+    group_commit_entry *next= current->next;
     if (current != leader)                      // Don't wake up ourself
     {
       if (current->queued_by_other)
@@ -8447,8 +8672,6 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     }
     current= next;
   }
-  DEBUG_SYNC(leader->thd, "commit_after_group_run_commit_ordered");
-  mysql_mutex_unlock(&LOCK_commit_ordered);
   DEBUG_SYNC(leader->thd, "commit_after_group_release_commit_ordered");
 
   if (check_purge)
@@ -8470,7 +8693,7 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
     DBUG_RETURN(ER_ERROR_ON_WRITE);
 
   if (entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
-      write_cache(entry->thd, mngr->get_binlog_cache_log(FALSE)))
+      write_cache(entry->thd, &mngr->stmt_cache))
   {
     entry->error_cache= &mngr->stmt_cache.cache_log;
     DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -8480,8 +8703,7 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
   {
     DBUG_EXECUTE_IF("crash_before_writing_xid",
                     {
-                      if ((write_cache(entry->thd,
-                                       mngr->get_binlog_cache_log(TRUE))))
+                      if ((write_cache(entry->thd, &mngr->trx_cache)))
                         DBUG_PRINT("info", ("error writing binlog cache"));
                       else
                         flush_and_sync(0);
@@ -8490,7 +8712,7 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                       DBUG_SUICIDE();
                     });
 
-    if (write_cache(entry->thd, mngr->get_binlog_cache_log(TRUE)))
+    if (write_cache(entry->thd, &mngr->trx_cache))
     {
       entry->error_cache= &mngr->trx_cache.cache_log;
       DBUG_RETURN(ER_ERROR_ON_WRITE);
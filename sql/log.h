@@ -815,7 +815,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   bool write_incident_already_locked(THD *thd);
   bool write_incident(THD *thd);
   void write_binlog_checkpoint_event_already_locked(const char *name, uint len);
-  int  write_cache(THD *thd, IO_CACHE *cache);
+  int  write_cache(THD *thd, binlog_cache_data *cache_data);
   void set_write_error(THD *thd, bool is_transactional);
   bool check_write_error(THD *thd);
 
@@ -919,6 +919,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     mysql_mutex_assert_not_owner(&LOCK_binlog_end_pos);
     lock_binlog_end_pos();
     binlog_end_pos= pos;
+    binlog_verified_pos= BIN_LOG_HEADER_SIZE;
     strcpy(binlog_end_pos_file, file_name);
     signal_bin_log_update();
     unlock_binlog_end_pos();
@@ -935,6 +936,28 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     strcpy(file_name_buf, binlog_end_pos_file);
     return binlog_end_pos;
   }
+  /*
+    End of the events of the active binlog whose checksums some dump thread
+    has verified, so that the other dump threads need not verify them again
+  */
+  my_off_t get_binlog_verified_pos() const
+  {
+    mysql_mutex_assert_owner(&LOCK_binlog_end_pos);
+    return binlog_verified_pos;
+  }
+
+  /*
+    Called by a dump thread that has verified the checksums of all events
+    of file_name from get_binlog_verified_pos() up to pos
+  */
+  void update_binlog_verified_pos(const char *file_name, my_off_t pos)
+  {
+    lock_binlog_end_pos();
+    if (pos > binlog_verified_pos && !strcmp(file_name, binlog_end_pos_file))
+      binlog_verified_pos= pos;
+    unlock_binlog_end_pos();
+  }
+
   void lock_binlog_end_pos() { mysql_mutex_lock(&LOCK_binlog_end_pos); }
   void unlock_binlog_end_pos() { mysql_mutex_unlock(&LOCK_binlog_end_pos); }
   mysql_mutex_t* get_binlog_end_pos_lock() { return &LOCK_binlog_end_pos; }
@@ -953,6 +976,8 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   */
   my_off_t binlog_end_pos;
   char binlog_end_pos_file[FN_REFLEN];
+  /* Protected by LOCK_binlog_end_pos, see get_binlog_verified_pos() */
+  my_off_t binlog_verified_pos;
 };
 
 class Log_event_handler
@@ -272,12 +272,14 @@ char *str_to_hex(char *to, const char *from, size_t len)
 
 #define BINLOG_COMPRESSED_HEADER_LEN 1
 #define BINLOG_COMPRESSED_ORIGINAL_LENGTH_MAX_BYTES 4
+/* zstd's default level, faster than zlib's default and compresses better */
+#define BINLOG_COMPRESSED_ZSTD_LEVEL 3
 /**
   Compressed Record
     Record Header: 1 Byte
              7 Bit: Always 1, mean compressed;
-           4-6 Bit: Compressed algorithm - Always 0, means zlib
-                    It maybe support other compression algorithm in the future.
+           4-6 Bit: Compressed algorithm - 0 means zlib, 1 means zstd
+                    (see enum_binlog_compress_alg)
            0-3 Bit: Bytes of "Record Original Length"
     Record Original Length: 1-4 Bytes
     Compressed Buf:
@@ -289,9 +291,13 @@ char *str_to_hex(char *to, const char *from, size_t len)
 
 uint32 binlog_get_compress_len(uint32 len)
 {
+    size_t bound= compressBound(len);
+#ifdef HAVE_ZSTD
+    bound= MY_MAX(bound, my_zstd_compress_bound(len));
+#endif
     /* 5 for the begin content, 1 reserved for a '\0'*/
     return ALIGN_SIZE((BINLOG_COMPRESSED_HEADER_LEN + BINLOG_COMPRESSED_ORIGINAL_LENGTH_MAX_BYTES) 
-                        + compressBound(len) + 1);
+                        + (uint32) bound + 1);
 }
 
 /**
@@ -302,10 +308,13 @@ uint32 binlog_get_compress_len(uint32 len)
       the content uncompressed.
          2) The 'comlen' should stored the length of 'dst', and it will
       be set as the size of compressed content after return.
+         3) 'alg' is one of enum_binlog_compress_alg. zstd falls back to
+      zlib if the server was built without it.
 
    return zero if successful, others otherwise.
 */
-int binlog_buf_compress(const char *src, char *dst, uint32 len, uint32 *comlen)
+int binlog_buf_compress(const char *src, char *dst, uint32 len, uint32 *comlen,
+                        uint alg)
 {
   uchar lenlen;
   if (len & 0xFF000000)
@@ -334,6 +343,20 @@ int binlog_buf_compress(const char *src, char *dst, uint32 len, uint32 *comlen)
     dst[1] = uchar(len);
     lenlen = 1;
   }
+#ifdef HAVE_ZSTD
+  if (alg == BINLOG_COMPRESS_ZSTD)
+  {
+    dst[0] = 0x80 | (BINLOG_COMPRESS_ZSTD << 4) | (lenlen & 0x07);
+
+    size_t tmplen = *comlen - BINLOG_COMPRESSED_HEADER_LEN - lenlen - 1;
+    if (my_zstd_compress_buffer((uchar *)dst + BINLOG_COMPRESSED_HEADER_LEN +
+                                lenlen, &tmplen, (const uchar *)src, len,
+                                BINLOG_COMPRESSED_ZSTD_LEVEL))
+      return 1;
+    *comlen = (uint32)tmplen + BINLOG_COMPRESSED_HEADER_LEN + lenlen;
+    return 0;
+  }
+#endif
   dst[0] = 0x80 | (lenlen & 0x07);
 
   uLongf tmplen = (uLongf)*comlen - BINLOG_COMPRESSED_HEADER_LEN - lenlen - 1;
@@ -630,14 +653,25 @@ int binlog_buf_uncompress(const char *src, char *dst, uint32 len,
   uint32 alg = (src[0] & 0x70) >> 4;
   switch(alg)
   {
-  case 0:
-    // zlib
+  case BINLOG_COMPRESS_ZLIB:
     if(uncompress((Bytef *)dst, &buflen,
       (const Bytef*)src + 1 + lenlen, len - 1 - lenlen) != Z_OK)
     {
       return 1;
     }
     break;
+#ifdef HAVE_ZSTD
+  case BINLOG_COMPRESS_ZSTD:
+  {
+    size_t zlen= buflen;
+    if (my_zstd_uncompress_buffer((uchar *)dst, &zlen,
+                                  (const uchar *)src + 1 + lenlen,
+                                  len - 1 - lenlen))
+      return 1;
+    buflen= (uLongf) zlen;
+    break;
+  }
+#endif
   default:
     //TODO
     //bad algorithm
@@ -2569,8 +2603,10 @@ Binlog_checkpoint_log_event::Binlog_checkpoint_log_event(
 
 Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
                const Format_description_log_event *description_event)
-  : Log_event(buf, description_event), seq_no(0), commit_id(0)
+  : Log_event(buf, description_event), seq_no(0), commit_id(0),
+    flags_extra(0), writeset_count(0), writeset(0), writeset_alloced(false)
 {
+  const char *buf_0= buf;
   uint8 header_size= description_event->common_header_len;
   uint8 post_header_len= description_event->post_header_len[GTID_EVENT-1];
   if (event_len < (uint) header_size + (uint) post_header_len ||
@@ -2606,6 +2642,41 @@ Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
     memcpy(xid.data, buf, data_length);
     buf+= data_length;
   }
+
+  /*
+    The extra flags are optional, older servers pad the event with zeros
+    to GTID_HEADER_LEN instead.
+  */
+  if ((uint) (buf - buf_0) < event_len)
+  {
+    flags_extra= *(buf++);
+    if (flags_extra & FL_EXTRA_WRITESET)
+    {
+      uint32 count;
+      ulonglong *hashes;
+      if ((uint) (buf - buf_0) + 4 > event_len ||
+          (ulonglong) (buf - buf_0) + 4 + 8 * (ulonglong) uint4korr(buf) >
+          event_len)
+      {
+        seq_no= 0;                              // So is_valid() returns false
+        return;
+      }
+      count= uint4korr(buf);
+      buf+= 4;
+      if (!(hashes= (ulonglong *) my_malloc(PSI_INSTRUMENT_ME,
+                                            MY_MAX(count, 1) * sizeof(ulonglong),
+                                            MYF(MY_WME))))
+      {
+        seq_no= 0;
+        return;
+      }
+      for (uint32 i= 0; i < count; i++, buf+= 8)
+        hashes[i]= uint8korr(buf);
+      writeset= hashes;
+      writeset_count= count;
+      writeset_alloced= true;
+    }
+  }
 }
 
 
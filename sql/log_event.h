@@ -940,6 +940,12 @@ class Log_event_writer
   ulonglong bytes_written;
   void *ctx;         ///< Encryption context or 0 if no encryption is needed
   uint checksum_len;
+  /**
+    Checksum of the event data after the header, set by write_cache() when
+    it was computed while the event was written to the binlog cache
+  */
+  ha_checksum data_checksum;
+  bool data_checksum_known;
   int write(Log_event *ev);
   int write_header(uchar *pos, size_t len);
   int write_data(const uchar *pos, size_t len);
@@ -947,14 +953,16 @@ class Log_event_writer
   my_off_t pos() { return my_b_safe_tell(file); }
   void add_status(enum_logged_status status);
   void set_incident();
+  void add_data_checksum();
   void set_encrypted_writer()
   { encrypt_or_write= &Log_event_writer::encrypt_and_write; }
 
   Log_event_writer(IO_CACHE *file_arg, binlog_cache_data *cache_data_arg,
                    Binlog_crypt_data *cr= 0)
     :encrypt_or_write(&Log_event_writer::write_internal),
-    bytes_written(0), ctx(0),
-    file(file_arg), cache_data(cache_data_arg), crypto(cr) { }
+    bytes_written(0), ctx(0), data_checksum_known(false),
+    file(file_arg), cache_data(cache_data_arg), crypto(cr),
+    cache_checksum(false) { }
 
 private:
   IO_CACHE *file;
@@ -971,6 +979,15 @@ class Log_event_writer
     Event length to be written into the next encrypted block
   */
   uint event_len;
+  /**
+    True while the data of an event that is written to a binlog cache is
+    checksummed for binlog_cache_data::add_checksum()
+  */
+  bool cache_checksum;
+  /**
+    Position of that event in the binlog cache
+  */
+  my_off_t event_start;
   int write_internal(const uchar *pos, size_t len);
   int encrypt_and_write(const uchar *pos, size_t len);
   int maybe_write_event_len(uchar *pos, size_t len);
@@ -3572,8 +3589,35 @@ class Binlog_checkpoint_log_event: public Log_event
   </tr>
   </table>
 
-  The Body of Gtid_log_event is empty. The total event size is 19 bytes +
-  the normal 19 bytes common-header.
+  The XID of an XA transaction follows when flags bit 6 or 7 is set.
+
+  <table>
+  <caption>Optional extra part</caption>
+
+  <tr>
+    <th>Name</th>
+    <th>Format</th>
+    <th>Description</th>
+  </tr>
+
+  <tr>
+    <td>flags_extra</td>
+    <td>1 byte bitfield</td>
+    <td>Present when the event is long enough. Bit 0 set indicates that the
+        writeset follows.</td>
+  </tr>
+
+  <tr>
+    <td>writeset</td>
+    <td>4 byte unsigned integer count, followed by count 8 byte unsigned
+        integers</td>
+    <td>Hashes of the unique key values modified by the event group, see
+        @@binlog_transaction_dependency_tracking.</td>
+  </tr>
+  </table>
+
+  Otherwise the Body of Gtid_log_event is empty. The total event size is
+  19 bytes + the normal 19 bytes common-header.
 */
 
 class Gtid_log_event: public Log_event
@@ -3588,6 +3632,13 @@ class Gtid_log_event: public Log_event
   event_mysql_xid_t xid;
 #endif
   uchar flags2;
+  uchar flags_extra;
+  /*
+    Hashes of the unique keys modified by the event group, when
+    flags_extra has FL_EXTRA_WRITESET.
+  */
+  uint32 writeset_count;
+  const ulonglong *writeset;
   /* Flags2. */
 
   /* FL_STANDALONE is set when there is no terminating COMMIT event. */
@@ -3619,6 +3670,15 @@ class Gtid_log_event: public Log_event
   /* FL_"COMMITTED or ROLLED-BACK"_XA is set for XA transaction. */
   static const uchar FL_COMPLETED_XA= 128;
 
+  /* Flags_extra. */
+
+  /*
+    FL_EXTRA_WRITESET is set when the event carries the writeset of the event
+    group. Event groups whose writesets do not intersect can be applied in
+    parallel by slave_parallel_mode=writeset.
+  */
+  static const uchar FL_EXTRA_WRITESET= 1;
+
 #ifdef MYSQL_SERVER
   Gtid_log_event(THD *thd_arg, uint64 seq_no, uint32 domain_id, bool standalone,
                  uint16 flags, bool is_transactional, uint64 commit_id);
@@ -3633,7 +3693,7 @@ class Gtid_log_event: public Log_event
 #endif
   Gtid_log_event(const char *buf, uint event_len,
                  const Format_description_log_event *description_event);
-  ~Gtid_log_event() { }
+  ~Gtid_log_event() { if (writeset_alloced) my_free((void *) writeset); }
   Log_event_type get_type_code() { return GTID_EVENT; }
   enum_logged_status logged_status() { return LOGGED_NO_DATA; }
   int get_data_size()
@@ -3649,7 +3709,16 @@ class Gtid_log_event: public Log_event
                    enum enum_binlog_checksum_alg checksum_alg,
                    uint32 *domain_id, uint32 *server_id, uint64 *seq_no,
                    uchar *flags2, const Format_description_log_event *fdev);
+  void set_writeset(const ulonglong *hashes, uint32 count)
+  {
+    flags_extra|= FL_EXTRA_WRITESET;
+    writeset= hashes;
+    writeset_count= count;
+  }
 #endif
+private:
+  /* The writeset was allocated when reading the event */
+  bool writeset_alloced;
 };
 
 
@@ -5168,6 +5237,7 @@ class Rows_log_event : public Log_event
 
   int find_key(); // Find a best key to use in find_row()
   int find_row(rpl_group_info *);
+  void prefetch_rows(rpl_group_info *); // Prefetch the rows for find_row()
   int write_row(rpl_group_info *, const bool);
   int update_sequence();
 
@@ -5498,6 +5568,8 @@ class Delete_rows_log_event : public Rows_log_event
   virtual int do_before_row_operations(const Slave_reporting_capability *const);
   virtual int do_after_row_operations(const Slave_reporting_capability *const,int);
   virtual int do_exec_row(rpl_group_info *);
+  bool can_hash_scan_rows();
+  int do_hash_scan_rows(rpl_group_info *);
 #endif
 };
 
@@ -5765,7 +5837,15 @@ enum Log_event_type wsrep_peak_event(rpl_group_info *rgi, ulonglong* event_size)
 */
 
 
-int binlog_buf_compress(const char *src, char *dst, uint32 len, uint32 *comlen);
+/* Algorithms of compressed records, see binlog_buf_compress() */
+enum enum_binlog_compress_alg
+{
+  BINLOG_COMPRESS_ZLIB= 0,
+  BINLOG_COMPRESS_ZSTD= 1
+};
+
+int binlog_buf_compress(const char *src, char *dst, uint32 len, uint32 *comlen,
+                        uint alg);
 int binlog_buf_uncompress(const char *src, char *dst, uint32 len, uint32 *newlen);
 uint32 binlog_get_compress_len(uint32 len);
 uint32 binlog_get_uncompress_len(const char *buf);
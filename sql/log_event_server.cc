@@ -876,9 +876,28 @@ int Log_event_writer::write_header(uchar *pos, size_t len)
   {
     uchar save=pos[FLAGS_OFFSET];
     pos[FLAGS_OFFSET]&= ~LOG_EVENT_BINLOG_IN_USE_F;
-    crc= my_checksum(0, pos, len);
+    if (data_checksum_known)
+    {
+      /* Only the header is left to checksum, see write_cache() */
+      size_t data_len= uint4korr(pos + EVENT_LEN_OFFSET) -
+                       LOG_EVENT_HEADER_LEN - checksum_len;
+      crc= my_checksum_combine(my_checksum(0, pos, LOG_EVENT_HEADER_LEN),
+                               data_checksum, data_len);
+    }
+    else
+      crc= my_checksum(0, pos, len);
     pos[FLAGS_OFFSET]= save;
   }
+  else if (cache_data && binlog_checksum_options)
+  {
+    /*
+      The event goes to a binlog cache. Checksum its data now, so that
+      write_cache() only has to checksum the header under LOCK_log.
+    */
+    event_start= my_b_safe_tell(file);
+    crc= 0;
+    cache_checksum= true;
+  }
 
   if (ctx)
   {
@@ -902,7 +921,7 @@ int Log_event_writer::write_header(uchar *pos, size_t len)
 int Log_event_writer::write_data(const uchar *pos, size_t len)
 {
   DBUG_ENTER("Log_event_writer::write_data");
-  if (checksum_len)
+  if (checksum_len ? !data_checksum_known : cache_checksum)
     crc= my_checksum(crc, pos, len);
 
   DBUG_RETURN((this->*encrypt_or_write)(pos, len));
@@ -927,6 +946,12 @@ int Log_event_writer::write_footer()
     if (maybe_write_event_len(dst, dstlen) || write_internal(dst, dstlen))
       DBUG_RETURN(ER_ERROR_ON_WRITE);
   }
+  if (cache_checksum)
+  {
+    add_data_checksum();
+    cache_checksum= false;
+  }
+  data_checksum_known= false;
   DBUG_RETURN(0);
 }
 
@@ -1337,7 +1362,8 @@ bool Query_compressed_log_event::write()
   compressed_size= alloc_size= binlog_get_compress_len(q_len);
   buffer= (char*) my_safe_alloca(alloc_size);
   if (buffer &&
-      !binlog_buf_compress(query, buffer, q_len, &compressed_size))
+      !binlog_buf_compress(query, buffer, q_len, &compressed_size,
+                           (uint) opt_bin_log_compress_algorithm))
   {
     /*
       Write the compressed event. We have to temporarily store the event
@@ -3253,7 +3279,8 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
                                uint64 commit_id_arg)
   : Log_event(thd_arg, flags_arg, is_transactional),
     seq_no(seq_no_arg), commit_id(commit_id_arg), domain_id(domain_id_arg),
-    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0))
+    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0)),
+    flags_extra(0), writeset_count(0), writeset(0), writeset_alloced(false)
 {
   cache_type= Log_event::EVENT_NO_CACHE;
   bool is_tmp_table= thd_arg->lex->stmt_accessed_temp_table();
@@ -3326,7 +3353,8 @@ Gtid_log_event::peek(const char *event_start, size_t event_len,
 bool
 Gtid_log_event::write()
 {
-  uchar buf[GTID_HEADER_LEN+2+sizeof(XID)];
+  uchar buf[GTID_HEADER_LEN+2+sizeof(XID)+1+4];
+  uchar hash_buf[8*64];
   size_t write_len;
 
   int8store(buf, seq_no);
@@ -3351,14 +3379,36 @@ Gtid_log_event::write()
     write_len+= data_length;
   }
 
-  if (write_len < GTID_HEADER_LEN)
+  if (flags_extra)
+  {
+    buf[write_len++]= flags_extra;
+    if (flags_extra & FL_EXTRA_WRITESET)
+    {
+      int4store(buf+write_len, writeset_count);
+      write_len+= 4;
+    }
+  }
+
+  size_t hashes_len= (flags_extra & FL_EXTRA_WRITESET) ? 8 * writeset_count : 0;
+  if (write_len + hashes_len < GTID_HEADER_LEN)
   {
-    bzero(buf+write_len, GTID_HEADER_LEN-write_len);
-    write_len= GTID_HEADER_LEN;
+    bzero(buf+write_len, GTID_HEADER_LEN-write_len-hashes_len);
+    write_len= GTID_HEADER_LEN-hashes_len;
   }
-  return write_header(write_len) ||
-         write_data(buf, write_len) ||
-         write_footer();
+  if (write_header(write_len + hashes_len) ||
+      write_data(buf, write_len))
+    return true;
+
+  /* The hashes are written in batches of what fits into hash_buf */
+  for (uint32 i= 0; i < hashes_len / 8; )
+  {
+    size_t len= 0;
+    for (; i < hashes_len / 8 && len < sizeof(hash_buf); i++, len+= 8)
+      int8store(hash_buf+len, writeset[i]);
+    if (write_data(hash_buf, len))
+      return true;
+  }
+  return write_footer();
 }
 
 
@@ -5637,6 +5687,9 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
     // Do event specific preparations 
     error= do_before_row_operations(rli);
 
+    if (likely(!error))
+      prefetch_rows(rgi);
+
     /*
       Bug#56662 Assertion failed: next_insert_id == 0, file handler.cc
       Don't allow generation of auto_increment value when processing
@@ -6002,7 +6055,8 @@ bool Rows_log_event::write_compressed()
   m_rows_buf = (uchar *)my_safe_alloca(alloc_size);
   if(m_rows_buf &&
      !binlog_buf_compress((const char *)m_rows_buf_tmp, (char *)m_rows_buf,
-                          (uint32)(m_rows_cur_tmp - m_rows_buf_tmp), &comlen))
+                          (uint32)(m_rows_cur_tmp - m_rows_buf_tmp), &comlen,
+                          (uint) opt_bin_log_compress_algorithm))
   {
     m_rows_cur= comlen + m_rows_buf;
     ret= Log_event::write();
@@ -7719,6 +7773,72 @@ static int row_not_found_error(rpl_group_info *rgi)
          ? HA_ERR_KEY_NOT_FOUND : HA_ERR_RECORD_CHANGED;
 }
 
+/**
+  Pass the primary keys of the rows of an update or delete event to the
+  storage engine before the rows are applied, so that the engine can
+  read them into its cache with several threads while find_row() looks
+  them up one at a time in the transaction of the applier.
+
+  The before images are unpacked into record[0] only to build the keys.
+  Warnings of the unpacking are suppressed, as they are reported again
+  when the rows are applied, and any error just ends the prefetch.
+*/
+
+void Rows_log_event::prefetch_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  DBUG_ENTER("Rows_log_event::prefetch_rows");
+
+  if (!(table->file->ha_table_flags() & HA_CAN_PREFETCH_KEYS) ||
+      table->s->primary_key >= MAX_KEY || table->versioned())
+    DBUG_VOID_RETURN;
+
+  const bool is_update= get_general_type_code() == UPDATE_ROWS_EVENT;
+  if (!is_update && get_general_type_code() != DELETE_ROWS_EVENT)
+    DBUG_VOID_RETURN;
+
+  KEY *key_info= table->key_info + table->s->primary_key;
+  DYNAMIC_ARRAY keys;
+  if (my_init_dynamic_array(PSI_INSTRUMENT_ME, &keys, key_info->key_length,
+                            64, 64, MYF(0)))
+    DBUG_VOID_RETURN;
+
+  const uchar *saved_curr_row= m_curr_row;
+  const uchar *saved_curr_row_end= m_curr_row_end;
+  THD *old_thd= table->in_use;
+  Dummy_error_handler error_handler;
+  table->in_use= thd;
+  thd->push_internal_handler(&error_handler);
+
+  while (m_curr_row < m_rows_end)
+  {
+    uchar *key;
+    prepare_record(table, m_width, FALSE);
+    if (unpack_current_row(rgi) || !(key= (uchar*) alloc_dynamic(&keys)))
+      break;
+    key_copy(key, table->record[0], key_info, 0);
+    m_curr_row= m_curr_row_end;
+    if (is_update)
+    {
+      /* Skip the after image */
+      if (unpack_current_row(rgi, &m_cols_ai))
+        break;
+      m_curr_row= m_curr_row_end;
+    }
+  }
+
+  thd->pop_internal_handler();
+  table->in_use= old_thd;
+  m_curr_row= saved_curr_row;
+  m_curr_row_end= saved_curr_row_end;
+
+  if (keys.elements > 1)
+    table->file->prefetch_keys(table->s->primary_key, keys.buffer,
+                               key_info->key_length, keys.elements);
+  delete_dynamic(&keys);
+  DBUG_VOID_RETURN;
+}
+
 /**
   Locate the current row in event's table.
 
@@ -8096,6 +8216,182 @@ Delete_rows_log_event::do_after_row_operations(const Slave_reporting_capability
   return error;
 }
 
+/*
+  Compute a hash value of table->record[0] for do_hash_scan_rows()
+
+  Records that record_compare() finds equal get the same hash value,
+  because the null bits and the values of all not null fields are hashed.
+*/
+static ulong record_hash(TABLE *table)
+{
+  ulong nr= 1, nr2= 4;
+  my_charset_bin.hash_sort(table->null_flags, table->s->null_bytes,
+                           &nr, &nr2);
+  for (Field **ptr= table->field ; *ptr ; ptr++)
+  {
+    if ((*ptr)->is_null())
+      continue;
+    if ((*ptr)->flags & BLOB_FLAG)
+    {
+      /* Hash the blob contents, not the pointer to them */
+      Field_blob *blob= (Field_blob *) *ptr;
+      my_charset_bin.hash_sort(blob->get_ptr(), blob->get_length(),
+                               &nr, &nr2);
+    }
+    else
+      (*ptr)->hash(&nr, &nr2);
+  }
+  return nr;
+}
+
+
+/* An unpacked before image of the event for do_hash_scan_rows() */
+struct Hash_scan_row
+{
+  ulong hash_value;
+  uchar *record;
+  bool deleted;
+};
+
+
+/*
+  Check whether the rows of the event can be deleted by one table scan
+
+  This is done when every row would otherwise be searched for by a
+  scan of the table, because the table has no usable key.
+*/
+bool Delete_rows_log_event::can_hash_scan_rows()
+{
+  if ((m_table->file->ha_table_flags() &
+       HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+      m_table->s->primary_key < MAX_KEY)
+    return false;
+  /* Triggers must see the rows deleted in the order of the event */
+  return !m_key_info && m_curr_row == m_rows_buf &&
+         !(m_table->triggers && do_invoke_trigger()) &&
+         !m_table->versioned();
+}
+
+
+/**
+  Delete all rows of the event with one scan of the table.
+
+  The before images of all rows of the event are unpacked and put into
+  a hash on their record_hash() value. The table is then scanned once,
+  and every record of the table whose hash value is found is compared
+  with the before images of that value by record_compare(). A record
+  that is equal to a before image not consumed yet is deleted. This
+  replaces one table scan per row by find_row() with one table scan per
+  event.
+
+  @returns Error code on failure, 0 on success.
+  HA_ERR_END_OF_FILE is returned, as by find_row(), if some rows of the
+  event were not found in the table.
+*/
+int Delete_rows_log_event::do_hash_scan_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  MEM_ROOT mem_root;
+  HASH rows;
+  ulong pending= 0;
+  int error= 0;
+  DBUG_ENTER("Delete_rows_log_event::do_hash_scan_rows");
+
+  init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 8192, 0,
+                  MYF(MY_THREAD_SPECIFIC));
+  if (my_hash_init(PSI_INSTRUMENT_ME, &rows, &my_charset_bin, 64,
+                   offsetof(Hash_scan_row, hash_value), sizeof(ulong),
+                   NULL, NULL, HASH_THREAD_SPECIFIC))
+  {
+    free_root(&mem_root, MYF(0));
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  }
+
+  table->use_all_columns();
+
+  /* Unpack the before images of all rows of the event */
+  while (m_curr_row != m_rows_end)
+  {
+    Hash_scan_row *row;
+    prepare_record(table, m_width, FALSE);
+    if (unlikely((error= unpack_current_row(rgi))))
+      goto end;
+    if (!(row= (Hash_scan_row *) alloc_root(&mem_root, sizeof(*row))) ||
+        !(row->record= (uchar *) memdup_root(&mem_root, table->record[0],
+                                             table->s->reclength)))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      goto end;
+    }
+    row->hash_value= record_hash(table);
+    row->deleted= false;
+    if (my_hash_insert(&rows, (uchar *) row))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      goto end;
+    }
+    pending++;
+    m_curr_row= m_curr_row_end;
+  }
+
+  DBUG_PRINT("info",("deleting %lu records using one table scan (rnd_next)",
+                     pending));
+  /* We use this to test that the correct key is used in test cases. */
+  DBUG_EXECUTE_IF("slave_crash_if_table_scan", abort(););
+
+  if (unlikely((error= table->file->ha_rnd_init_with_error(1))))
+    goto end;
+
+  while (pending &&
+         !(error= table->file->ha_rnd_next(table->record[0])))
+  {
+    ulong hash_value= record_hash(table);
+    HASH_SEARCH_STATE state;
+    Hash_scan_row *row;
+
+    for (row= (Hash_scan_row *) my_hash_first(&rows, (uchar *) &hash_value,
+                                              sizeof(hash_value), &state);
+         row;
+         row= (Hash_scan_row *) my_hash_next(&rows, (uchar *) &hash_value,
+                                             sizeof(hash_value), &state))
+    {
+      if (row->deleted)
+        continue;
+      memcpy(table->record[1], row->record, table->s->reclength);
+      if (!record_compare(table))
+        break;
+    }
+    if (!row)
+      continue;
+
+    row->deleted= true;
+    pending--;
+    table->mark_columns_per_binlog_row_image();
+    error= table->file->ha_delete_row(table->record[0]);
+    table->default_column_bitmaps();
+    if (unlikely(error))
+      goto scan_end;
+    table->use_all_columns();
+  }
+
+  /* The loop ends on success only when all rows were deleted */
+  if (error == HA_ERR_END_OF_FILE)
+    DBUG_PRINT("info", ("%lu records not found", pending));
+  else if (unlikely(error))
+    table->file->print_error(error, MYF(0));
+
+scan_end:
+  table->file->ha_rnd_end();
+
+  issue_long_find_row_warning(get_general_type_code(), m_table->alias.c_ptr(),
+                              false, rgi);
+end:
+  my_hash_free(&rows);
+  free_root(&mem_root, MYF(0));
+  DBUG_RETURN(error);
+}
+
+
 int Delete_rows_log_event::do_exec_row(rpl_group_info *rgi)
 {
   int error;
@@ -8104,6 +8400,14 @@ int Delete_rows_log_event::do_exec_row(rpl_group_info *rgi)
   const bool invoke_triggers= (m_table->triggers && do_invoke_trigger());
   DBUG_ASSERT(m_table != NULL);
 
+  if (can_hash_scan_rows())
+  {
+    thd_proc_info(thd, "Delete_rows_log_event::do_hash_scan_rows()");
+    error= do_hash_scan_rows(rgi);
+    thd_proc_info(thd, tmp);
+    return error;
+  }
+
 #ifdef WSREP_PROC_INFO
   my_snprintf(thd->wsrep_info, sizeof(thd->wsrep_info) - 1,
               "Delete_rows_log_event::find_row(%lld)",
@@ -30,15 +30,20 @@
 #include <mysql/psi/mysql_mdl.h>
 #include <algorithm>
 #include <array>
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 static PSI_memory_key key_memory_MDL_context_acquire_locks;
 
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_MDL_wait_LOCK_wait_status;
+static PSI_mutex_key key_MDL_lock_fast_path_mutex;
 
 static PSI_mutex_info all_mdl_mutexes[]=
 {
-  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0}
+  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0},
+  { &key_MDL_lock_fast_path_mutex, "MDL_lock::fast_path_mutex", 0}
 };
 
 static PSI_rwlock_key key_MDL_lock_rwlock;
@@ -170,7 +175,8 @@ class MDL_map
 public:
   void init();
   void destroy();
-  MDL_lock *find_or_insert(LF_PINS *pins, const MDL_key *key);
+  MDL_lock *find_or_insert(LF_PINS *pins, const MDL_key *key,
+                           MDL_ticket *fast_path_ticket, uint shard);
   unsigned long get_lock_owner(LF_PINS *pins, const MDL_key *key);
   void remove(LF_PINS *pins, MDL_lock *lock);
   LF_PINS *get_pins() { return lf_hash_get_pins(&m_locks); }
@@ -545,6 +551,56 @@ class MDL_lock
     return (m_granted.is_empty() && m_waiting.is_empty());
   }
 
+  /**
+    Lock types which are compatible with each other and with all waiting
+    requests that are not obtrusive, so that they can be granted without
+    MDL_lock::m_rwlock as long as there are no obtrusive tickets.
+    DML takes only such locks on tables.
+  */
+  static constexpr bitmap_t FAST_PATH_TYPES=
+    MDL_BIT(MDL_SHARED) | MDL_BIT(MDL_SHARED_HIGH_PRIO) |
+    MDL_BIT(MDL_SHARED_READ) | MDL_BIT(MDL_SHARED_WRITE);
+  /** Lock types which conflict with some of FAST_PATH_TYPES. */
+  static constexpr bitmap_t OBTRUSIVE_TYPES=
+    MDL_BIT(MDL_SHARED_READ_ONLY) | MDL_BIT(MDL_SHARED_NO_WRITE) |
+    MDL_BIT(MDL_SHARED_NO_READ_WRITE) | MDL_BIT(MDL_EXCLUSIVE);
+  static constexpr uint FAST_PATH_SHARDS= 8;
+
+  /** Bits of m_fast_path_state */
+  enum
+  {
+    /** Obtrusive tickets are granted, being acquired or waiting. */
+    FAST_PATH_OBTRUSIVE= 1,
+    /** The lock is being removed from MDL_map. */
+    FAST_PATH_DESTROYED= 2
+  };
+
+  static bool is_fast_path_type(const MDL_key *key, enum_mdl_type type)
+  {
+    return key->mdl_namespace() != MDL_key::BACKUP &&
+           key->mdl_namespace() != MDL_key::SCHEMA &&
+           (MDL_BIT(type) & FAST_PATH_TYPES);
+  }
+
+  bool try_acquire_fast_path(MDL_ticket *ticket, uint shard);
+  void remove_fast_path_ticket(LF_PINS *pins, MDL_ticket *ticket);
+  void materialize_fast_path_ticket(MDL_ticket *ticket);
+  void block_fast_path(enum_mdl_type type);
+  void update_fast_path_state();
+  bool destroy_fast_path();
+
+  /**
+    Check if there are no fast path tickets. Can be called without
+    any mutexes, in which case the result is only a hint.
+  */
+  bool fast_path_is_empty() const
+  {
+    for (const Fast_path_shard &shard : m_fast_path)
+      if (shard.m_count.load())
+        return false;
+    return true;
+  }
+
   const bitmap_t *incompatible_granted_types_bitmap() const
   { return m_strategy->incompatible_granted_types_bitmap(); }
   const bitmap_t *incompatible_waiting_types_bitmap() const
@@ -554,6 +610,8 @@ class MDL_lock
 
   bool can_grant_lock(enum_mdl_type type, MDL_context *requstor_ctx,
                       bool ignore_lock_priority) const;
+  bool has_incompatible_tickets(const Ticket_list &list, enum_mdl_type type,
+                                MDL_context *requestor_ctx) const;
 
   inline unsigned long get_lock_owner() const;
 
@@ -567,9 +625,9 @@ class MDL_lock
 
   bool needs_notification(const MDL_ticket *ticket) const
   { return m_strategy->needs_notification(ticket); }
-  void notify_conflicting_locks(MDL_context *ctx)
+  void notify_conflicting_locks(MDL_context *ctx, const Ticket_list &list)
   {
-    for (const auto &conflicting_ticket : m_granted)
+    for (const auto &conflicting_ticket : list)
     {
       if (conflicting_ticket.get_ctx() != ctx &&
           m_strategy->conflicting_locks(&conflicting_ticket))
@@ -582,6 +640,16 @@ class MDL_lock
       }
     }
   }
+  void notify_conflicting_locks(MDL_context *ctx)
+  {
+    notify_conflicting_locks(ctx, m_granted);
+    for (Fast_path_shard &shard : m_fast_path)
+    {
+      mysql_mutex_lock(&shard.m_mutex);
+      notify_conflicting_locks(ctx, shard.m_tickets);
+      mysql_mutex_unlock(&shard.m_mutex);
+    }
+  }
 
   bitmap_t hog_lock_types_bitmap() const
   { return m_strategy->hog_lock_types_bitmap(); }
@@ -601,16 +669,56 @@ class MDL_lock
   */
   ulong m_hog_lock_count;
 
+  /**
+    Granted tickets of FAST_PATH_TYPES which were added without
+    MDL_lock::m_rwlock. Each context picks the shard of the CPU it runs
+    on, so that concurrent DML on the same object does not write to the
+    same cache lines. These tickets are not visible to the deadlock
+    detector: a context moves them to m_granted before it starts waiting,
+    see MDL_context::materialize_fast_path_locks().
+
+    Fast path tickets are added only if m_fast_path_state is 0, which is
+    checked under the mutex of the shard. Whoever sets a bit of
+    m_fast_path_state acquires the mutex of every shard afterwards before
+    looking at its tickets, so no ticket can be added behind its back.
+  */
+  struct Fast_path_shard
+  {
+    Fast_path_shard() : m_count(0)
+    {
+      mysql_mutex_init(key_MDL_lock_fast_path_mutex, &m_mutex,
+                       MY_MUTEX_INIT_FAST);
+    }
+    ~Fast_path_shard() { mysql_mutex_destroy(&m_mutex); }
+
+    mysql_mutex_t m_mutex;
+    Ticket_list m_tickets;
+    /**
+      Number of tickets in m_tickets, can be read without m_mutex.
+      Decremented before a ticket is removed, see remove_fast_path_ticket().
+    */
+    std::atomic<uint32_t> m_count;
+    char pad[CPU_LEVEL1_DCACHE_LINESIZE];
+  };
+  Fast_path_shard m_fast_path[FAST_PATH_SHARDS];
+  /**
+    FAST_PATH_OBTRUSIVE and FAST_PATH_DESTROYED. Only modified under
+    write-locked MDL_lock::m_rwlock.
+  */
+  std::atomic<uint32_t> m_fast_path_state;
+
 public:
 
   MDL_lock()
     : m_hog_lock_count(0),
+      m_fast_path_state(0),
       m_strategy(0)
   { mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock); }
 
   MDL_lock(const MDL_key *key_arg)
   : key(key_arg),
     m_hog_lock_count(0),
+    m_fast_path_state(0),
     m_strategy(&m_backup_lock_strategy)
   {
     DBUG_ASSERT(key_arg->mdl_namespace() == MDL_key::BACKUP);
@@ -631,6 +739,8 @@ class MDL_lock
   {
     DBUG_ASSERT(key_arg->mdl_namespace() != MDL_key::BACKUP);
     new (&lock->key) MDL_key(key_arg);
+    DBUG_ASSERT(lock->fast_path_is_empty());
+    lock->m_fast_path_state.store(0, std::memory_order_relaxed);
     if (key_arg->mdl_namespace() == MDL_key::SCHEMA)
       lock->m_strategy= &m_scoped_lock_strategy;
     else
@@ -725,6 +835,15 @@ static my_bool mdl_iterate_lock(MDL_lock *lock, mdl_iterate_arg *arg)
                         [arg](MDL_ticket &ticket) {
                           return arg->callback(&ticket, arg->argument, true);
                         });
+  for (MDL_lock::Fast_path_shard &shard : lock->m_fast_path)
+  {
+    mysql_mutex_lock(&shard.m_mutex);
+    res= std::any_of(shard.m_tickets.begin(), shard.m_tickets.end(),
+                     [arg](MDL_ticket &ticket) {
+                       return arg->callback(&ticket, arg->argument, true);
+                     });
+    mysql_mutex_unlock(&shard.m_mutex);
+  }
   res= std::any_of(lock->m_waiting.begin(), lock->m_waiting.end(),
                    [arg](MDL_ticket &ticket) {
                      return arg->callback(&ticket, arg->argument, false);
@@ -795,12 +914,18 @@ void MDL_map::destroy()
   Find MDL_lock object corresponding to the key, create it
   if it does not exist.
 
+  @param fast_path_ticket  Ticket to grant without MDL_lock::m_rwlock
+                           if possible, or NULL.
+  @param shard             Fast path shard of the requesting context.
+
   @retval non-NULL - Success. MDL_lock instance for the key with
-                     locked MDL_lock::m_rwlock.
+                     locked MDL_lock::m_rwlock, unless fast_path_ticket
+                     was granted.
   @retval NULL     - Failure (OOM).
 */
 
-MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, const MDL_key *mdl_key)
+MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, const MDL_key *mdl_key,
+                                  MDL_ticket *fast_path_ticket, uint shard)
 {
   MDL_lock *lock;
 
@@ -824,6 +949,16 @@ MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, const MDL_key *mdl_key)
     if (lf_hash_insert(&m_locks, pins, (uchar*) mdl_key) == -1)
       return NULL;
 
+  /*
+    The pin keeps the object from being reused for another key, and
+    try_acquire_fast_path() fails once the lock is being removed.
+  */
+  if (fast_path_ticket && lock->try_acquire_fast_path(fast_path_ticket, shard))
+  {
+    lf_hash_search_unpin(pins);
+    return lock;
+  }
+
   mysql_prlock_wrlock(&lock->m_rwlock);
   if (unlikely(!lock->m_strategy))
   {
@@ -1729,42 +1864,73 @@ MDL_lock::can_grant_lock(enum_mdl_type type_arg,
   if (!ignore_lock_priority && (m_waiting.bitmap() & waiting_incompat_map))
     return false;
 
-  if (m_granted.bitmap() & granted_incompat_map)
-  {
-    bool can_grant= true;
+  bool can_grant= !(m_granted.bitmap() & granted_incompat_map) ||
+                   !has_incompatible_tickets(m_granted, type_arg,
+                                             requestor_ctx);
 
-    /* Check that the incompatible lock belongs to some other context. */
-    for (const auto &ticket : m_granted)
+  if (granted_incompat_map & FAST_PATH_TYPES &&
+      m_strategy == &m_object_lock_strategy)
+  {
+    /*
+      The caller has set FAST_PATH_OBTRUSIVE, so no new fast path tickets
+      can be added. Check the ones that were added before.
+    */
+    DBUG_ASSERT(m_fast_path_state.load(std::memory_order_relaxed));
+    for (const Fast_path_shard &shard : m_fast_path)
     {
-      if (ticket.get_ctx() != requestor_ctx &&
-          ticket.is_incompatible_when_granted(type_arg))
-      {
+      mysql_mutex_t *mutex= const_cast<mysql_mutex_t*>(&shard.m_mutex);
+      mysql_mutex_lock(mutex);
+      if (shard.m_tickets.bitmap() & granted_incompat_map &&
+          has_incompatible_tickets(shard.m_tickets, type_arg, requestor_ctx))
         can_grant= false;
+      mysql_mutex_unlock(mutex);
+    }
+  }
+  return can_grant;
+}
+
+
+/**
+  Check if the list has tickets of other contexts which are incompatible
+  with the requested lock type.
+*/
+
+bool MDL_lock::has_incompatible_tickets(const Ticket_list &list,
+                                        enum_mdl_type type_arg,
+                                        MDL_context *requestor_ctx) const
+{
+  bool found= false;
+
+  /* Check that the incompatible lock belongs to some other context. */
+  for (const auto &ticket : list)
+  {
+    if (ticket.get_ctx() != requestor_ctx &&
+        ticket.is_incompatible_when_granted(type_arg))
+    {
+      found= true;
 #ifdef WITH_WSREP
-        /*
-          non WSREP threads must report conflict immediately
-          note: RSU processing wsrep threads, have wsrep_on==OFF
-        */
-        if (WSREP(requestor_ctx->get_thd()) ||
-            requestor_ctx->get_thd()->wsrep_cs().mode() ==
-            wsrep::client_state::m_rsu)
+      /*
+        non WSREP threads must report conflict immediately
+        note: RSU processing wsrep threads, have wsrep_on==OFF
+      */
+      if (WSREP(requestor_ctx->get_thd()) ||
+          requestor_ctx->get_thd()->wsrep_cs().mode() ==
+          wsrep::client_state::m_rsu)
+      {
+        wsrep_handle_mdl_conflict(requestor_ctx, &ticket, &key);
+        if (wsrep_log_conflicts)
         {
-          wsrep_handle_mdl_conflict(requestor_ctx, &ticket, &key);
-          if (wsrep_log_conflicts)
-          {
-            auto key= ticket.get_key();
-            WSREP_INFO("MDL conflict db=%s table=%s ticket=%d solved by abort",
-                       key->db_name(), key->name(), ticket.get_type());
-          }
-          continue;
+          auto key= ticket.get_key();
+          WSREP_INFO("MDL conflict db=%s table=%s ticket=%d solved by abort",
+                     key->db_name(), key->name(), ticket.get_type());
         }
-#endif /* WITH_WSREP */
-        break;
+        continue;
       }
+#endif /* WITH_WSREP */
+      break;
     }
-    return can_grant;
   }
-  return true;
+  return found;
 }
 
 
@@ -1790,7 +1956,7 @@ void MDL_lock::remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*list,
 {
   mysql_prlock_wrlock(&m_rwlock);
   (this->*list).remove_ticket(ticket);
-  if (is_empty())
+  if (is_empty() && destroy_fast_path())
     mdl_locks.remove(pins, this);
   else
   {
@@ -1809,11 +1975,172 @@ void MDL_lock::remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*list,
       pending request).
     */
     reschedule_waiters();
+    update_fast_path_state();
     mysql_prlock_unlock(&m_rwlock);
   }
 }
 
 
+/**
+  Try to grant a lock of one of FAST_PATH_TYPES without MDL_lock::m_rwlock.
+
+  @param ticket  Ticket of the request
+  @param shard   Shard of the requesting context
+
+  @retval TRUE   The ticket was granted and added to the shard.
+  @retval FALSE  There may be obtrusive tickets or the lock is being
+                 destroyed, the request must go through m_rwlock.
+*/
+
+bool MDL_lock::try_acquire_fast_path(MDL_ticket *ticket, uint shard)
+{
+  Fast_path_shard *fast_path= &m_fast_path[shard];
+  bool granted= false;
+
+  DBUG_ASSERT(is_fast_path_type(&key, ticket->get_type()));
+  DBUG_ASSERT(shard < FAST_PATH_SHARDS);
+  ticket->m_lock= this;
+
+  mysql_mutex_lock(&fast_path->m_mutex);
+  if (!m_fast_path_state.load(std::memory_order_relaxed))
+  {
+    ticket->m_fast_path_shard= shard;
+    fast_path->m_tickets.add_ticket(ticket);
+    fast_path->m_count.fetch_add(1, std::memory_order_relaxed);
+    granted= true;
+  }
+  mysql_mutex_unlock(&fast_path->m_mutex);
+  return granted;
+}
+
+
+/**
+  Release a fast path ticket, and destroy the lock if it was the last one.
+*/
+
+void MDL_lock::remove_fast_path_ticket(LF_PINS *pins, MDL_ticket *ticket)
+{
+  Fast_path_shard *fast_path= &m_fast_path[ticket->m_fast_path_shard];
+
+  mysql_mutex_lock(&fast_path->m_mutex);
+  /*
+    If obtrusive requests are waiting, some of them may be waiting just
+    for this ticket. Otherwise only the last ticket has anything to do.
+    The count is decremented before the other shards are looked at, so
+    that of two contexts releasing the last tickets of their shards at
+    the same time at least one sees that all shards are empty.
+  */
+  uint32_t count= fast_path->m_count.fetch_sub(1) - 1;
+  if (!m_fast_path_state.load(std::memory_order_relaxed) &&
+      (count || !fast_path_is_empty()))
+  {
+    fast_path->m_tickets.remove_ticket(ticket);
+    mysql_mutex_unlock(&fast_path->m_mutex);
+    return;
+  }
+  mysql_mutex_unlock(&fast_path->m_mutex);
+
+  /*
+    The ticket is still in the shard, so the lock can not be destroyed
+    before m_rwlock is acquired.
+  */
+  mysql_prlock_wrlock(&m_rwlock);
+  mysql_mutex_lock(&fast_path->m_mutex);
+  fast_path->m_tickets.remove_ticket(ticket);
+  mysql_mutex_unlock(&fast_path->m_mutex);
+
+  if (is_empty() && destroy_fast_path())
+    mdl_locks.remove(pins, this);
+  else
+  {
+    reschedule_waiters();
+    update_fast_path_state();
+    mysql_prlock_unlock(&m_rwlock);
+  }
+}
+
+
+/**
+  Move a fast path ticket to m_granted, where the deadlock detector
+  can see it.
+
+  @pre MDL_lock::m_rwlock is write-locked.
+*/
+
+void MDL_lock::materialize_fast_path_ticket(MDL_ticket *ticket)
+{
+  Fast_path_shard *fast_path= &m_fast_path[ticket->m_fast_path_shard];
+
+  mysql_mutex_lock(&fast_path->m_mutex);
+  fast_path->m_tickets.remove_ticket(ticket);
+  fast_path->m_count.fetch_sub(1);
+  mysql_mutex_unlock(&fast_path->m_mutex);
+
+  ticket->m_fast_path_shard= MDL_ticket::NO_FAST_PATH_SHARD;
+  m_granted.add_ticket(ticket);
+}
+
+
+/**
+  Stop granting fast path tickets before an obtrusive request is
+  checked against them.
+
+  @pre MDL_lock::m_rwlock is write-locked.
+*/
+
+void MDL_lock::block_fast_path(enum_mdl_type type)
+{
+  if (m_strategy == &m_object_lock_strategy &&
+      (MDL_BIT(type) & OBTRUSIVE_TYPES))
+    m_fast_path_state.store(FAST_PATH_OBTRUSIVE, std::memory_order_relaxed);
+}
+
+
+/**
+  Allow fast path tickets again if there are no more obtrusive tickets.
+
+  @pre MDL_lock::m_rwlock is write-locked.
+*/
+
+void MDL_lock::update_fast_path_state()
+{
+  if (m_strategy == &m_object_lock_strategy &&
+      !((m_granted.bitmap() | m_waiting.bitmap()) & OBTRUSIVE_TYPES))
+    m_fast_path_state.store(0, std::memory_order_relaxed);
+}
+
+
+/**
+  Prevent new fast path tickets before the lock is removed from MDL_map.
+
+  @pre MDL_lock::m_rwlock is write-locked and there are no tickets in
+       m_granted and m_waiting.
+
+  @retval TRUE   There are no fast path tickets, the lock can be removed.
+  @retval FALSE  There are fast path tickets, the lock must stay.
+*/
+
+bool MDL_lock::destroy_fast_path()
+{
+  DBUG_ASSERT(is_empty());
+  if (m_strategy != &m_object_lock_strategy)
+    return true;
+  m_fast_path_state.store(FAST_PATH_DESTROYED, std::memory_order_relaxed);
+  for (Fast_path_shard &fast_path : m_fast_path)
+  {
+    mysql_mutex_lock(&fast_path.m_mutex);
+    bool empty= fast_path.m_tickets.is_empty();
+    mysql_mutex_unlock(&fast_path.m_mutex);
+    if (!empty)
+    {
+      m_fast_path_state.store(0, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  return true;
+}
+
+
 /**
   Check if we have any pending locks which conflict with existing
   shared lock.
@@ -1984,7 +2311,9 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
       We can't get here if we allocated a new lock object so there
       is no need to release it.
     */
-    DBUG_ASSERT(! ticket->m_lock->is_empty());
+    DBUG_ASSERT(! ticket->m_lock->is_empty() ||
+                ! ticket->m_lock->fast_path_is_empty());
+    ticket->m_lock->update_fast_path_state();
     mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
     MDL_ticket::destroy(ticket);
   }
@@ -2015,7 +2344,7 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 {
   MDL_lock *lock;
   MDL_key *key= &mdl_request->key;
-  MDL_ticket *ticket;
+  MDL_ticket *ticket, *fast_path_ticket;
   enum_mdl_duration found_duration;
 
   /* Don't take chances in production. */
@@ -2069,8 +2398,15 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                    )))
     return TRUE;
 
-  /* The below call implicitly locks MDL_lock::m_rwlock on success. */
-  if (!(lock= mdl_locks.find_or_insert(m_pins, key)))
+  /*
+    The below call implicitly locks MDL_lock::m_rwlock on success,
+    unless the ticket could be granted on the fast path.
+  */
+  fast_path_ticket= MDL_lock::is_fast_path_type(key, mdl_request->type) ?
+                    ticket : NULL;
+  if (!(lock= mdl_locks.find_or_insert(m_pins, key, fast_path_ticket,
+                                       fast_path_ticket ?
+                                       fast_path_shard() : 0)))
   {
     MDL_ticket::destroy(ticket);
     return TRUE;
@@ -2085,7 +2421,16 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                   mdl_request->m_src_file,
                                   mdl_request->m_src_line);
 
+  if (ticket->is_fast_path())
+  {
+    m_tickets[mdl_request->duration].push_front(ticket);
+    mdl_request->ticket= ticket;
+    mysql_mdl_set_status(ticket->m_psi, MDL_ticket::GRANTED);
+    return FALSE;
+  }
+
   ticket->m_lock= lock;
+  lock->block_fast_path(mdl_request->type);
 
   if (lock->can_grant_lock(mdl_request->type, this, false))
   {
@@ -2269,6 +2614,7 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
 
   if (lock_wait_timeout == 0)
   {
+    lock->update_fast_path_state();
     mysql_prlock_unlock(&lock->m_rwlock);
     MDL_ticket::destroy(ticket);
     my_error(ER_LOCK_WAIT_TIMEOUT, MYF(0));
@@ -2313,6 +2659,7 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
   if (ticket->m_psi != NULL)
     locker= PSI_CALL_start_metadata_wait(&state, ticket->m_psi, __FILE__, __LINE__);
 
+  materialize_fast_path_locks();
   will_wait_for(ticket);
 
   /* There is a shared or exclusive lock on the object. */
@@ -2539,6 +2886,8 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
 
   /* Merge the acquired and the original lock. @todo: move to a method. */
   mysql_prlock_wrlock(&mdl_ticket->m_lock->m_rwlock);
+  if (mdl_ticket->is_fast_path())
+    mdl_ticket->m_lock->materialize_fast_path_ticket(mdl_ticket);
   if (is_new_ticket)
     mdl_ticket->m_lock->m_granted.remove_ticket(mdl_xlock_request.ticket);
   /*
@@ -2819,7 +3168,10 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
 
   DBUG_ASSERT(this == ticket->get_ctx());
 
-  lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
+  if (ticket->is_fast_path())
+    lock->remove_fast_path_ticket(m_pins, ticket);
+  else
+    lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -2828,6 +3180,46 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
 }
 
 
+/**
+  Move all fast path tickets of the context to MDL_lock::m_granted of
+  their locks, so that the deadlock detector can see what this context
+  holds while it is waiting.
+*/
+
+void MDL_context::materialize_fast_path_locks()
+{
+  for (int i= 0; i < MDL_DURATION_END; i++)
+  {
+    Ticket_iterator it(m_tickets[i]);
+    MDL_ticket *ticket;
+
+    while ((ticket= it++))
+    {
+      if (ticket->is_fast_path())
+      {
+        MDL_lock *lock= ticket->m_lock;
+        mysql_prlock_wrlock(&lock->m_rwlock);
+        lock->materialize_fast_path_ticket(ticket);
+        mysql_prlock_unlock(&lock->m_rwlock);
+      }
+    }
+  }
+}
+
+
+/** Shard of MDL_lock::m_fast_path to be used by this context. */
+
+uint MDL_context::fast_path_shard() const
+{
+#ifdef HAVE_SCHED_GETCPU
+  int cpu= sched_getcpu();
+  if (cpu >= 0)
+    return uint(cpu) % MDL_lock::FAST_PATH_SHARDS;
+#endif
+  return uint(get_thread_id() % MDL_lock::FAST_PATH_SHARDS);
+}
+
+
 /**
   Release lock with explicit duration.
 
@@ -2937,6 +3329,7 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
   m_type= type;
   m_lock->m_granted.add_ticket(this);
   m_lock->reschedule_waiters();
+  m_lock->update_fast_path_state();
   mysql_prlock_unlock(&m_lock->m_rwlock);
 }
 
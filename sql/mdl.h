@@ -718,6 +718,9 @@ class MDL_ticket : public MDL_wait_for_subgraph, public ilist_node<>
   const LEX_STRING *get_type_name(enum_mdl_type type) const;
   MDL_lock *get_lock() const { return m_lock; }
   MDL_key *get_key() const;
+  /** @sa MDL_lock::m_fast_path */
+  bool is_fast_path() const
+  { return m_fast_path_shard != NO_FAST_PATH_SHARD; }
   void downgrade_lock(enum_mdl_type type);
 
   bool has_stronger_or_equal_type(enum_mdl_type type) const;
@@ -735,6 +738,9 @@ class MDL_ticket : public MDL_wait_for_subgraph, public ilist_node<>
                          PRE_ACQUIRE_NOTIFY, POST_RELEASE_NOTIFY };
 private:
   friend class MDL_context;
+  friend class MDL_lock;
+
+  static const uint NO_FAST_PATH_SHARD= UINT_MAX;
 
   MDL_ticket(MDL_context *ctx_arg, enum_mdl_type type_arg
 #ifndef DBUG_OFF
@@ -747,6 +753,7 @@ class MDL_ticket : public MDL_wait_for_subgraph, public ilist_node<>
 #endif
      m_ctx(ctx_arg),
      m_lock(NULL),
+     m_fast_path_shard(NO_FAST_PATH_SHARD),
      m_psi(NULL)
   {}
 
@@ -781,6 +788,13 @@ class MDL_ticket : public MDL_wait_for_subgraph, public ilist_node<>
   */
   MDL_lock *m_lock;
 
+  /**
+    Shard of MDL_lock::m_fast_path which holds the ticket, or
+    NO_FAST_PATH_SHARD if it is in MDL_lock::m_granted or m_waiting.
+    Context private.
+  */
+  uint m_fast_path_shard;
+
   PSI_metadata_lock *m_psi;
 
 private:
@@ -1055,6 +1069,8 @@ class MDL_context
   bool try_acquire_lock_impl(MDL_request *mdl_request,
                              MDL_ticket **out_ticket);
   bool fix_pins();
+  void materialize_fast_path_locks();
+  uint fast_path_shard() const;
 
 public:
   THD *get_thd() const { return m_owner->get_thd(); }
@@ -117,6 +117,14 @@ handler::multi_range_read_info_const(uint keyno, RANGE_SEQ_IF *seq,
   bool use_statistics_for_eq_range= eq_ranges_exceeds_limit(seq,
                                                             seq_init_param,
                                                             limit);
+  /*
+    The number of equality ranges for which records_in_range() has been
+    called and the total of the returned estimates. When there are more
+    equality ranges than the limit and the index has no statistics, the
+    first 'limit' ranges are used as a sample for the remaining ones.
+  */
+  uint eq_range_dives= 0;
+  ha_rows eq_range_dive_rows= 0;
   DBUG_ENTER("multi_range_read_info_const");
 
   /* Default MRR implementation doesn't need buffer */
@@ -171,6 +179,15 @@ handler::multi_range_read_info_const(uint keyno, RANGE_SEQ_IF *seq,
              actual_rec_per_key(keyparts_used-1));
       range_blocks_cnt+= ((MY_MAX(rows, 1) - 1) / avg_block_records + 1);
     }
+    else if (use_statistics_for_eq_range &&
+             !(range.range_flag & NULL_RANGE) &&
+             (range.range_flag & EQ_RANGE) &&
+             eq_range_dives >= limit)
+    {
+      /* No statistics: use the average of the sampled equality ranges */
+      rows= MY_MAX(eq_range_dive_rows / eq_range_dives, 1);
+      range_blocks_cnt+= ((rows - 1) / avg_block_records + 1);
+    }
     else
     {
       page_range pages= unused_page_range;
@@ -181,6 +198,11 @@ handler::multi_range_read_info_const(uint keyno, RANGE_SEQ_IF *seq,
         total_rows= HA_POS_ERROR;
         break;
       }
+      if ((range.range_flag & EQ_RANGE) && !(range.range_flag & NULL_RANGE))
+      {
+        eq_range_dives++;
+        eq_range_dive_rows+= rows;
+      }
       if (pages.first_page == UNUSED_PAGE_NO)
       {
         /*
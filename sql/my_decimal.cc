@@ -368,6 +368,65 @@ int my_decimal2int(uint mask, const decimal_t *d, bool unsigned_flag,
 }
 
 
+#ifdef __SIZEOF_INT128__
+/**
+  Convert a decimal to an integer scaled by 10^scale, e.g. 12.5 to 1250
+  for scale=2.
+
+  @param d      the decimal
+  @param scale  the scale, not larger than MY_DECIMAL_INT128_MAX_SCALE
+  @param to     the scaled integer, less than 10^36 in absolute value
+
+  @retval false on success
+  @retval true  if d has more than 18 integer digits or more than
+                scale fractional digits
+*/
+bool my_decimal2int128(const my_decimal *d, uint scale, __int128 *to)
+{
+  DBUG_ASSERT(scale <= MY_DECIMAL_INT128_MAX_SCALE);
+  if (d->intg > 18 || d->frac > (int) scale)
+    return true;
+  const decimal_digit_t *buf= d->buf;
+  /* Each decimal_digit_t holds 9 decimal digits */
+  const decimal_digit_t *end= buf + (d->intg + 8) / 9 + (d->frac + 8) / 9;
+  uint frac= (d->frac + 8) / 9 * 9;
+  __int128 value= 0;
+  for (; buf < end; buf++)
+    value= value * 1000000000 + *buf;
+  /* The digits after d->frac are zero, so that the division is exact */
+  if (frac > scale)
+    value/= (longlong) log_10_int[frac - scale];
+  else
+    value*= (longlong) log_10_int[scale - frac];
+  *to= d->sign() ? -value : value;
+  return false;
+}
+
+
+/**
+  Convert an integer that is scaled by 10^scale to a decimal.
+*/
+void int128_to_my_decimal(__int128 from, uint scale, my_decimal *to)
+{
+  char buf[64], *end= buf + sizeof buf, *s= end;
+  const bool neg= from < 0;
+  unsigned __int128 value= neg ? 0 - (unsigned __int128) from : from;
+  uint digits= 0;
+  do
+  {
+    if (digits++ == scale && scale)
+      *--s= '.';
+    *--s= (char) ('0' + (int) (value % 10));
+    value/= 10;
+  } while (value || digits <= scale);
+  if (neg)
+    *--s= '-';
+  char *str_end= end;
+  string2decimal(s, to, &str_end);
+}
+#endif
+
+
 longlong my_decimal::to_longlong(bool unsigned_flag) const
 {
   longlong result;
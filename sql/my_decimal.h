@@ -534,5 +534,14 @@ int my_decimal_intg(const my_decimal *a)
 void my_decimal_trim(ulonglong *precision, uint *scale);
 
 
+#ifdef __SIZEOF_INT128__
+/** Largest scale that my_decimal2int128() converts */
+#define MY_DECIMAL_INT128_MAX_SCALE 18
+
+bool my_decimal2int128(const my_decimal *d, uint scale, __int128 *to);
+void int128_to_my_decimal(__int128 from, uint scale, my_decimal *to);
+#endif
+
+
 #endif /*my_decimal_h*/
 
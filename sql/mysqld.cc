@@ -357,6 +357,7 @@ static longlong start_memory_used;
 bool opt_bin_log, opt_bin_log_used=0, opt_ignore_builtin_innodb= 0;
 bool opt_bin_log_compress;
 uint opt_bin_log_compress_min_len;
+ulong opt_bin_log_compress_algorithm;
 my_bool opt_log, debug_assert_if_crashed_table= 0, opt_help= 0;
 my_bool debug_assert_on_not_freed_memory= 0;
 my_bool disable_log_notes, opt_support_flashback= 0;
@@ -388,6 +389,7 @@ my_bool opt_skip_slave_start = 0; ///< If set, slave is not autostarted
 my_bool opt_reckless_slave = 0;
 my_bool opt_enable_named_pipe= 0;
 my_bool opt_local_infile, opt_slave_compressed_protocol;
+uint opt_protocol_zstd_compression_level;
 my_bool opt_safe_user_create = 0;
 my_bool opt_show_slave_auth_info;
 my_bool opt_log_slave_updates= 0;
@@ -528,6 +530,7 @@ ulong opt_slave_domain_parallel_threads= 0;
 ulong opt_slave_parallel_mode;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+ulong opt_binlog_dependency_tracking= BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER;
 ulong opt_slave_parallel_max_queued= 131072;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 uint opt_gtid_cleanup_batch_size= 64;
@@ -688,8 +691,7 @@ mysql_mutex_t
   LOCK_global_system_variables,
   LOCK_user_conn,
   LOCK_error_messages, LOCK_slave_background;
-mysql_mutex_t LOCK_stats, LOCK_global_user_client_stats,
-              LOCK_global_table_stats, LOCK_global_index_stats;
+mysql_mutex_t LOCK_stats, LOCK_global_user_client_stats;
 
 /* This protects against changes in master_info_index */
 mysql_mutex_t LOCK_active_mi;
@@ -900,8 +902,7 @@ PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
 PSI_mutex_key key_LOCK_binlog;
 
 PSI_mutex_key key_LOCK_stats,
-  key_LOCK_global_user_client_stats, key_LOCK_global_table_stats,
-  key_LOCK_global_index_stats,
+  key_LOCK_global_user_client_stats,
   key_LOCK_wakeup_ready, key_LOCK_wait_commit;
 PSI_mutex_key key_LOCK_gtid_waiting;
 
@@ -953,8 +954,6 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_system_variables_hash, "LOCK_system_variables_hash", PSI_FLAG_GLOBAL},
   { &key_LOCK_stats, "LOCK_stats", PSI_FLAG_GLOBAL},
   { &key_LOCK_global_user_client_stats, "LOCK_global_user_client_stats", PSI_FLAG_GLOBAL},
-  { &key_LOCK_global_table_stats, "LOCK_global_table_stats", PSI_FLAG_GLOBAL},
-  { &key_LOCK_global_index_stats, "LOCK_global_index_stats", PSI_FLAG_GLOBAL},
   { &key_LOCK_wakeup_ready, "THD::LOCK_wakeup_ready", 0},
   { &key_LOCK_wait_commit, "wait_for_commit::LOCK_wait_commit", 0},
   { &key_LOCK_gtid_waiting, "gtid_waiting::LOCK_gtid_waiting", 0},
@@ -1107,7 +1106,7 @@ static PSI_cond_info all_server_conds[]=
 PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_background, key_rpl_parallel_thread;
+  key_thread_slave_background, key_rpl_parallel_thread, key_thread_sort;
 PSI_thread_key key_thread_ack_receiver;
 
 static PSI_thread_info all_server_threads[]=
@@ -1119,7 +1118,8 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_background, "slave_background", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
+  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0},
+  { &key_thread_sort, "sort", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -2091,8 +2091,6 @@ static void clean_up_mutexes()
   mysql_mutex_destroy(&LOCK_thread_id);
   mysql_mutex_destroy(&LOCK_stats);
   mysql_mutex_destroy(&LOCK_global_user_client_stats);
-  mysql_mutex_destroy(&LOCK_global_table_stats);
-  mysql_mutex_destroy(&LOCK_global_index_stats);
 #ifdef HAVE_OPENSSL
   mysql_mutex_destroy(&LOCK_des_key_file);
 #if defined(HAVE_OPENSSL10) && !defined(HAVE_WOLFSSL)
@@ -4245,10 +4243,6 @@ static int init_thread_environment()
   mysql_mutex_init(key_LOCK_stats, &LOCK_stats, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_global_user_client_stats,
                    &LOCK_global_user_client_stats, MY_MUTEX_INIT_FAST);
-  mysql_mutex_init(key_LOCK_global_table_stats,
-                   &LOCK_global_table_stats, MY_MUTEX_INIT_FAST);
-  mysql_mutex_init(key_LOCK_global_index_stats,
-                   &LOCK_global_index_stats, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_prepare_ordered, &LOCK_prepare_ordered,
                    MY_MUTEX_INIT_SLOW);
   mysql_cond_init(key_COND_prepare_ordered, &COND_prepare_ordered, NULL);
@@ -6482,7 +6476,10 @@ struct my_option my_long_options[]=
    "--slave-parallel-threads. Possible values: \"optimistic\" tries to "
    "apply most transactional DML in parallel, and handles any conflicts "
    "with rollback and retry. \"conservative\" limits parallelism in an "
-   "effort to avoid any conflicts. \"aggressive\" tries to maximise the "
+   "effort to avoid any conflicts. \"writeset\" additionally applies in "
+   "parallel transactions whose writesets, logged by the master with "
+   "--binlog-transaction-dependency-tracking=WRITESET, do not intersect. "
+   "\"aggressive\" tries to maximise the "
    "parallelism, possibly at the cost of increased conflict rate. "
    "\"minimal\" only parallelizes the commit steps of transactions. "
    "\"none\" disables parallel apply completely.",
@@ -7170,6 +7167,7 @@ SHOW_VAR status_vars[]= {
   {"Max_used_connections",     (char*) &max_used_connections,  SHOW_LONG},
   {"Memory_used",              (char*) &show_memory_used, SHOW_SIMPLE_FUNC},
   {"Memory_used_initial",      (char*) &start_memory_used, SHOW_LONGLONG},
+  {"Memory_root_blocks_recycled", (char*) &my_mem_root_recycled_blocks, SHOW_LONGLONG},
   {"Resultset_metadata_skipped", (char *) offsetof(STATUS_VAR, skip_metadata_count),SHOW_LONG_STATUS},
   {"Not_flushed_delayed_rows", (char*) &delayed_rows_in_use,    SHOW_LONG_NOFLUSH},
   {"Open_files",               (char*) &my_file_opened,         SHOW_SINT},
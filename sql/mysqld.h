@@ -69,10 +69,17 @@ enum enum_slave_parallel_mode {
   SLAVE_PARALLEL_NONE,
   SLAVE_PARALLEL_MINIMAL,
   SLAVE_PARALLEL_CONSERVATIVE,
+  SLAVE_PARALLEL_WRITESET,
   SLAVE_PARALLEL_OPTIMISTIC,
   SLAVE_PARALLEL_AGGRESSIVE
 };
 
+/* Values for --binlog-transaction-dependency-tracking */
+enum enum_binlog_dependency_tracking {
+  BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER,
+  BINLOG_DEPENDENCY_TRACKING_WRITESET
+};
+
 /* Function prototypes */
 void kill_mysql(THD *thd);
 void close_connection(THD *thd, uint sql_errno= 0);
@@ -104,6 +111,7 @@ extern MY_BITMAP temp_pool;
 extern bool opt_large_files;
 extern bool opt_update_log, opt_bin_log, opt_error_log, opt_bin_log_compress; 
 extern uint opt_bin_log_compress_min_len;
+extern ulong opt_bin_log_compress_algorithm;
 extern my_bool opt_log, opt_bootstrap;
 extern my_bool opt_backup_history_log;
 extern my_bool opt_backup_progress_log;
@@ -120,6 +128,7 @@ extern Atomic_counter<uint> connection_count;
 extern my_bool opt_safe_user_create;
 extern my_bool opt_safe_show_db, opt_local_infile, opt_myisam_use_mmap;
 extern my_bool opt_slave_compressed_protocol, use_temp_pool;
+extern uint opt_protocol_zstd_compression_level;
 extern ulong slave_exec_mode_options, slave_ddl_exec_mode_options;
 extern ulong slave_retried_transactions;
 extern ulong transactions_multi_engine;
@@ -252,6 +261,7 @@ extern ulong opt_slave_parallel_max_queued;
 extern ulong opt_slave_parallel_mode;
 extern ulong opt_binlog_commit_wait_count;
 extern ulong opt_binlog_commit_wait_usec;
+extern ulong opt_binlog_dependency_tracking;
 extern my_bool opt_gtid_ignore_duplicates;
 extern uint opt_gtid_cleanup_batch_size;
 extern ulong back_log;
@@ -341,8 +351,7 @@ extern PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state,
   key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry;
 
 extern PSI_mutex_key key_TABLE_SHARE_LOCK_share, key_LOCK_stats,
-  key_LOCK_global_user_client_stats, key_LOCK_global_table_stats,
-  key_LOCK_global_index_stats, key_LOCK_wakeup_ready, key_LOCK_wait_commit,
+  key_LOCK_global_user_client_stats, key_LOCK_wakeup_ready, key_LOCK_wait_commit,
   key_TABLE_SHARE_LOCK_rotation;
 extern PSI_mutex_key key_LOCK_gtid_waiting;
 
@@ -385,7 +394,7 @@ extern PSI_cond_key key_TABLE_SHARE_COND_rotation;
 extern PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_kill_server, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_background, key_rpl_parallel_thread;
+  key_thread_slave_background, key_rpl_parallel_thread, key_thread_sort;
 
 extern PSI_file_key key_file_binlog, key_file_binlog_cache,
        key_file_binlog_index, key_file_binlog_index_cache, key_file_casetest,
@@ -158,6 +158,7 @@ my_bool my_net_init(NET *net, Vio *vio, void *thd, uint my_flags)
   net->last_errno=0;
   net->thread_specific_malloc= MY_TEST(my_flags & MY_THREAD_SPECIFIC);
   net->thd= 0;
+  net->compress_stream= 0;
 #ifdef MYSQL_SERVER
   net->extension= NULL;
   net->thd= thd;
@@ -198,10 +199,42 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+#ifdef HAVE_ZSTD
+  my_zstd_stream_end((MY_ZSTD_STREAM*) net->compress_stream);
+  net->compress_stream= 0;
+#endif
   DBUG_VOID_RETURN;
 }
 
 
+/**
+  Start using zstd streaming compression on the connection.
+
+  Like setting net->compress= 1 for zlib, this must be done by both peers
+  at the same point of the protocol.
+
+  @param net    Network handler
+  @param level  zstd compression level of the packets that are sent
+
+  @retval 0 ok
+  @retval 1 out of memory, or built without zstd
+*/
+
+my_bool net_enable_zstd_compression(NET *net, int level)
+{
+  DBUG_ENTER("net_enable_zstd_compression");
+#ifdef HAVE_ZSTD
+  DBUG_ASSERT(!net->compress_stream);
+  if (!(net->compress_stream= my_zstd_stream_init(level)))
+    DBUG_RETURN(1);
+  net->compress= NET_COMPRESS_ZSTD;
+  DBUG_RETURN(0);
+#else
+  DBUG_RETURN(1);
+#endif
+}
+
+
 /** Realloc the packet buffer. */
 
 my_bool net_realloc(NET *net, size_t length)
@@ -568,14 +601,39 @@ net_write_command(NET *net,uchar command,
     1
 */
 
+#ifdef HAVE_ZSTD
+/*
+  The compressed data of a zstd stream can not be replaced by the original
+  data if it got longer, so the data must be small enough for its worst
+  case compressed length to fit in the 3 bytes of the header.
+*/
+#define NET_ZSTD_MAX_PACKET_LENGTH (MAX_PACKET_LENGTH - (MAX_PACKET_LENGTH >> 7))
+#endif
+
+/** Longest data that net_real_write() can compress into one packet */
+
+static inline size_t net_max_compress_length(NET *net)
+{
+#ifdef HAVE_ZSTD
+  if (net->compress == NET_COMPRESS_ZSTD)
+    return NET_ZSTD_MAX_PACKET_LENGTH;
+#endif
+  return MAX_PACKET_LENGTH;
+}
+
+/** Number of bytes that fit in the write buffer before it is flushed */
+
+static inline size_t net_write_space(NET *net)
+{
+  if (net->compress && net->max_packet > net_max_compress_length(net))
+    return (net_max_compress_length(net) - (net->write_pos - net->buff));
+  return (net->buff_end - net->write_pos);
+}
+
 static my_bool
 net_write_buff(NET *net, const uchar *packet, size_t len)
 {
-  size_t left_length;
-  if (net->compress && net->max_packet > MAX_PACKET_LENGTH)
-    left_length= (MAX_PACKET_LENGTH - (net->write_pos - net->buff));
-  else
-    left_length= (net->buff_end - net->write_pos);
+  size_t left_length= net_write_space(net);
 
 #ifdef DEBUG_DATA_PACKETS
   DBUG_DUMP("data_written", packet, len);
@@ -599,7 +657,7 @@ net_write_buff(NET *net, const uchar *packet, size_t len)
 	We can't have bigger packets than 16M with compression
 	Because the uncompressed length is stored in 3 bytes
       */
-      left_length= MAX_PACKET_LENGTH;
+      left_length= net_max_compress_length(net);
       while (len > left_length)
       {
 	if (net_real_write(net, packet, left_length))
@@ -619,6 +677,53 @@ net_write_buff(NET *net, const uchar *packet, size_t len)
 }
 
 
+/**
+  Reserve the free space of the write buffer for the next packet.
+
+  The caller stores the packet data directly at the returned position,
+  instead of building it elsewhere and copying it with my_net_write(),
+  and then commits it with net_write_reserved().
+
+  @param net      NET handler
+  @param length   Out: number of bytes that may be stored
+
+  @return Start of the packet data, 0 if there is no room left
+*/
+
+uchar *net_reserve_packet(NET *net, size_t *length)
+{
+  size_t left_length= net_write_space(net);
+
+  if (unlikely(!net->vio) || left_length <= NET_HEADER_SIZE)
+    return 0;
+  *length= MY_MIN(left_length - NET_HEADER_SIZE, MAX_PACKET_LENGTH - 1);
+  return net->write_pos + NET_HEADER_SIZE;
+}
+
+
+/**
+  Add a packet that was stored at the position returned by
+  net_reserve_packet() to the write buffer.
+
+  @param net      NET handler
+  @param len      Length of the packet data
+*/
+
+void net_write_reserved(NET *net, size_t len)
+{
+  MYSQL_NET_WRITE_START(len);
+  DBUG_ASSERT(len < MAX_PACKET_LENGTH);
+  DBUG_ASSERT(len + NET_HEADER_SIZE <= net_write_space(net));
+  int3store(net->write_pos, len);
+  net->write_pos[3]= (uchar) net->pkt_nr++;
+#ifdef DEBUG_DATA_PACKETS
+  DBUG_DUMP("data_written", net->write_pos + NET_HEADER_SIZE, len);
+#endif
+  net->write_pos+= NET_HEADER_SIZE + len;
+  MYSQL_NET_WRITE_DONE(0);
+}
+
+
 /**
   Read and write one packet using timeouts.
   If needed, the packet is compressed before sending.
@@ -654,8 +759,13 @@ net_real_write(NET *net,const uchar *packet, size_t len)
     size_t complen;
     uchar *b;
     uint header_length=NET_HEADER_SIZE+COMP_HEADER_SIZE;
+    size_t buff_length= len;
+#ifdef HAVE_ZSTD
+    if (net->compress == NET_COMPRESS_ZSTD)
+      buff_length= my_zstd_compress_bound(len);
+#endif
     if (!(b= (uchar*) my_malloc(key_memory_NET_compress_packet,
-                                len + NET_HEADER_SIZE + COMP_HEADER_SIZE + 1,
+                                buff_length + header_length + 1,
                                 MYF(MY_WME | (net->thread_specific_malloc
                                               ? MY_THREAD_SPECIFIC : 0)))))
     {
@@ -665,11 +775,36 @@ net_real_write(NET *net,const uchar *packet, size_t len)
       net->reading_or_writing= 0;
       DBUG_RETURN(1);
     }
-    memcpy(b+header_length,packet,len);
+#ifdef HAVE_ZSTD
+    if (net->compress == NET_COMPRESS_ZSTD && len >= MIN_COMPRESS_LENGTH)
+    {
+      /* The packet is sent compressed even if it got longer */
+      complen= len;
+      len= buff_length;
+      if (my_zstd_compress((MY_ZSTD_STREAM*) net->compress_stream,
+                           b + header_length, &len, packet, complen))
+      {
+        my_free(b);
+        net->error= 2;
+        net->last_errno= ER_NET_ERROR_ON_WRITE;
+        MYSQL_SERVER_my_error(ER_NET_ERROR_ON_WRITE, MYF(0));
+        net->reading_or_writing= 0;
+        DBUG_RETURN(1);
+      }
+      DBUG_ASSERT(len <= MAX_PACKET_LENGTH);
+    }
+    else
+#endif
+    {
+      memcpy(b+header_length,packet,len);
 
-    /* Don't compress error packets (compress == 2) */
-    if (net->compress == 2 || my_compress(b+header_length, &len, &complen))
-      complen=0;
+      /*
+        Don't compress error packets (compress == 2).
+        Short packets are not passed to zstd at all.
+      */
+      if (net->compress != 1 || my_compress(b+header_length, &len, &complen))
+        complen=0;
+    }
     int3store(&b[NET_HEADER_SIZE],complen);
     int3store(b,len);
     b[3]=(uchar) (net->compress_pkt_nr++);
@@ -1237,6 +1372,22 @@ ulong my_net_read(NET *net)
   The function returns the length of the found packet or packet_error.
   net->read_pos points to the read data.
 */
+#ifdef HAVE_COMPRESS
+/** Uncompress a packet with the algorithm of the connection */
+
+static my_bool net_uncompress(NET *net, uchar *packet, size_t len,
+                              size_t *complen)
+{
+#ifdef HAVE_ZSTD
+  if (net->compress == NET_COMPRESS_ZSTD)
+    return my_zstd_uncompress((MY_ZSTD_STREAM*) net->compress_stream,
+                              packet, len, complen);
+#endif
+  return my_uncompress(packet, len, complen);
+}
+#endif /* HAVE_COMPRESS */
+
+
 ulong
 my_net_read_packet(NET *net, my_bool read_from_server)
 {
@@ -1370,8 +1521,8 @@ my_net_read_packet_reallen(NET *net, my_bool read_from_server, ulong* reallen)
 	return packet_error;
       }
       read_from_server= 0;
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-			&complen))
+      if (net_uncompress(net, net->buff + net->where_b, packet_len,
+			 &complen))
       {
 	net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
@@ -7905,6 +7905,39 @@ SEL_TREE *Item_func_in::get_func_mm_tree(RANGE_OPT_PARAM *param,
   }
   else
   {
+    if (array && array->used_count &&
+        array->type_handler()->result_type() != ROW_RESULT)
+    {
+      /*
+        We get here for conditions in form "t.key IN (c1, c2, ...)", where
+        c{i} are constants. The array of the predicate holds the values
+        sorted and without NULLs, so the ranges are built from it: every
+        distinct value is converted and added to the tree only once, and
+        the values come in increasing order. For long IN lists with
+        repeated values this saves most of the work of tree_or().
+      */
+      MEM_ROOT *tmp_root= param->mem_root;
+      param->thd->mem_root= param->old_root;
+      /* See the comment for NOT IN above */
+      Item *value_item= array->create_item(param->thd);
+      param->thd->mem_root= tmp_root;
+
+      if (value_item)
+      {
+        for (uint i= 0; i < array->used_count; i++)
+        {
+          if (i && !array->compare_elems(i, i-1))
+            continue;
+          array->value_to_item(i, value_item);
+          SEL_TREE *tree2= get_mm_parts(param, field, Item_func::EQ_FUNC,
+                                        value_item);
+          if (!(tree= i ? tree_or(param, tree, tree2) : tree2))
+            break;
+        }
+        DBUG_RETURN(tree);
+      }
+    }
+
     tree= get_mm_parts(param, field, Item_func::EQ_FUNC, args[1]);
     if (tree)
     {
@@ -246,6 +246,11 @@ class SplM_opt_info : public Sql_alloc
   double unsplit_card;
   /* Lastly evaluated execution plan for 'join' with pushed equalities */
   SplM_plan_info *last_plan;
+  /*
+    The values from the outer tables used in the injected splitting
+    condition, as of the last materialization of T
+  */
+  List<Cached_item> injected_values;
 
   SplM_plan_info *find_plan(TABLE *table, uint key, uint parts);
 };
@@ -1048,11 +1053,15 @@ bool JOIN::inject_best_splitting_cond(table_map remaining_tables)
   List<Item> inj_cond_list;
   List_iterator<KEY_FIELD> li(spl_opt_info->added_key_fields);
   KEY_FIELD *added_key_field;
+  spl_opt_info->injected_values.empty();
   while ((added_key_field= li++))
   {
     if (remaining_tables & added_key_field->val->used_tables())
       continue;
-    if (inj_cond_list.push_back(added_key_field->cond, thd->mem_root))
+    Cached_item *value= new_Cached_item(thd, added_key_field->val, FALSE);
+    if (!value ||
+        inj_cond_list.push_back(added_key_field->cond, thd->mem_root) ||
+        spl_opt_info->injected_values.push_back(value, thd->mem_root))
       return true;
   }
   DBUG_ASSERT(inj_cond_list.elements);
@@ -1078,6 +1087,35 @@ bool JOIN::inject_best_splitting_cond(table_map remaining_tables)
 }
 
 
+/**
+  @brief
+    Check whether a table materialized with splitting is to be refilled
+
+  @details
+    A materialized table T that uses splitting depends on the current rows
+    of the preceding tables only through the values the injected splitting
+    condition compares with. The function checks whether these values have
+    changed since T was materialized last time and remembers the current
+    ones, so that T is not refilled for consecutive rows of the outer
+    tables with the same join key.
+
+  @note
+    The function must be called every time the execution comes to T,
+    whether T is going to be refilled or not.
+
+  @retval
+    true   the values have changed or splitting is not used for T
+    false  T contains the rows for the current values
+*/
+
+bool TABLE::split_injected_values_changed()
+{
+  if (!spl_opt_info || spl_opt_info->injected_values.is_empty())
+    return true;
+  return test_if_group_changed(spl_opt_info->injected_values) >= 0;
+}
+
+
 /**
   @brief
     Fix the splitting chosen for a splittable table in the final query plan
@@ -358,6 +358,10 @@ constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_COMMIT_WAIT_USEC=
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_ROW_METADATA=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
+constexpr privilege_t
+  PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY_TRACKING=
+  SUPER_ACL | BINLOG_ADMIN_ACL;
+
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_EXPIRE_LOGS_DAYS=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
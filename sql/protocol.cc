@@ -34,6 +34,38 @@
 static const unsigned int PACKET_BUFFER_EXTRA_ALLOC= 1024;
 #ifndef EMBEDDED_LIBRARY
 static bool write_eof_packet(THD *, NET *, uint, uint);
+
+/**
+  Check if the client has already sent (part of) its next command.
+
+  Data that is already in the compressed read buffer or in the SSL
+  buffer is checked first, the socket only after that.
+*/
+
+bool net_has_pending_input(NET *net)
+{
+  Vio *vio= net->vio;
+  if (net->remain_in_buf)
+    return true;
+  return vio && (vio->has_data(vio) || vio_pending(vio) > 0);
+}
+
+
+/**
+  Flush the reply that ends a statement.
+
+  If the client has pipelined its next command, the reply is left in
+  the network buffer, so that the replies of a batch of commands go out
+  together. dispatch_command() flushes them before the server waits for
+  more input.
+*/
+
+static bool net_flush_reply(NET *net)
+{
+  if (net_has_pending_input(net))
+    return false;
+  return net_flush(net);
+}
 #endif
 
 CHARSET_INFO *Protocol::character_set_results() const
@@ -285,7 +317,7 @@ Protocol::net_send_ok(THD *thd,
 
   error= my_net_write(net, (const unsigned char*)store.ptr(), store.length());
   if (likely(!error))
-    error= net_flush(net);
+    error= net_flush_reply(net);
 
   thd->server_status&= ~SERVER_SESSION_STATE_CHANGED;
 
@@ -349,7 +381,7 @@ Protocol::net_send_eof(THD *thd, uint server_status, uint statement_warn_count)
     thd->get_stmt_da()->set_overwrite_status(true);
     error= write_eof_packet(thd, net, server_status, statement_warn_count);
     if (likely(!error))
-      error= net_flush(net);
+      error= net_flush_reply(net);
     thd->get_stmt_da()->set_overwrite_status(false);
     DBUG_PRINT("info", ("EOF sent, so no more error sending allowed"));
   }
@@ -764,6 +796,9 @@ void Protocol::init(THD *thd_arg)
   thd=thd_arg;
   packet= &thd->packet;
   convert= &thd->convert_buffer;
+#ifndef EMBEDDED_LIBRARY
+  net_row_length= 0;
+#endif
 #ifndef DBUG_OFF
   field_handlers= 0;
   field_pos= 0;
@@ -1275,9 +1310,70 @@ bool Protocol::send_list_fields(List<Field> *list, const TABLE_LIST *table_list)
 }
 
 
+/**
+  Store the next result set row directly in the network buffer.
+
+  The row is built in the free space of thd->net, after the room for the
+  packet header, so that write() only has to add the header instead of
+  copying the row from thd->packet. If the row does not fit after all,
+  net_row is reallocated like any String and write() sends the copy.
+
+  The length of the last row is used to guess if the next one fits. If
+  it does not, the row is built in thd->packet as usual, and sending it
+  fills up and flushes the network buffer for the rows that follow.
+*/
+
+void Protocol::start_net_row()
+{
+  size_t length;
+  uchar *to;
+
+  if (!net_row_length ||
+      (type() != PROTOCOL_TEXT && type() != PROTOCOL_BINARY) ||
+      !(to= net_reserve_packet(&thd->net, &length)) ||
+      length <= net_row_length)
+    return;
+  net_row.set_alloced((char*) to, 0, length);
+  net_row.set_charset(packet->charset());
+  packet= &net_row;
+}
+
+
+/**
+  Stop storing rows in the network buffer, see start_net_row()
+*/
+
+void Protocol::end_net_row()
+{
+  if (packet == &net_row)
+  {
+    net_row.free();
+    packet= &thd->packet;
+  }
+}
+
+
 bool Protocol::write()
 {
+  bool error;
   DBUG_ENTER("Protocol::write");
+
+  net_row_length= packet->length();
+  if (packet == &net_row)
+  {
+    error= FALSE;
+    if (!net_row.is_alloced())
+    {
+      DBUG_ASSERT(net_row.ptr() ==
+                  (char*) thd->net.write_pos + NET_HEADER_SIZE);
+      net_write_reserved(&thd->net, net_row.length());
+    }
+    else
+      error= my_net_write(&thd->net, (uchar*) net_row.ptr(),
+                          net_row.length());
+    end_net_row();
+    DBUG_RETURN(error);
+  }
   DBUG_RETURN(my_net_write(&thd->net, (uchar*) packet->ptr(),
                            packet->length()));
 }
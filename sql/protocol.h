@@ -50,6 +50,12 @@ class Protocol
   }
 #endif
   uint field_count;
+#ifndef EMBEDDED_LIBRARY
+  /* Result set row that is stored in the free space of thd->net */
+  String net_row;
+  /* Length of the last packet sent by write() */
+  size_t net_row_length;
+#endif
   virtual bool net_store_data(const uchar *from, size_t length);
   virtual bool net_store_data_cs(const uchar *from, size_t length,
                       CHARSET_INFO *fromcs, CHARSET_INFO *tocs);
@@ -104,6 +110,13 @@ class Protocol
   String *storage_packet() { return packet; }
   inline void free() { packet->free(); }
   virtual bool write();
+#ifndef EMBEDDED_LIBRARY
+  void start_net_row();
+  void end_net_row();
+#else
+  void start_net_row() {}
+  void end_net_row() {}
+#endif
   inline  bool store(int from)
   { return store_long((longlong) from); }
   inline  bool store(uint32 from)
@@ -118,6 +131,9 @@ class Protocol
   virtual bool prepare_for_send(uint num_columns)
   {
     field_count= num_columns;
+#ifndef EMBEDDED_LIBRARY
+    net_row_length= 0;
+#endif
     return 0;
   }
   virtual bool flush();
@@ -324,6 +340,7 @@ class Protocol_discard final : public Protocol
 
 void send_warning(THD *thd, uint sql_errno, const char *err=0);
 void net_send_progress_packet(THD *thd);
+bool net_has_pending_input(NET *net);
 uchar *net_store_data(uchar *to,const uchar *from, size_t length);
 uchar *net_store_data(uchar *to,int32 from);
 uchar *net_store_data(uchar *to,longlong from);
@@ -43,7 +43,7 @@ template<bool,bool> static int rr_unpack_from_buffer(READ_RECORD *info);
 int rr_from_pointers(READ_RECORD *info);
 static int rr_from_cache(READ_RECORD *info);
 static int init_rr_cache(THD *thd, READ_RECORD *info);
-static int rr_cmp(uchar *a,uchar *b);
+static int rr_cmp(const void *cmp_arg, const void *a, const void *b);
 static int rr_index_first(READ_RECORD *info);
 static int rr_index_last(READ_RECORD *info);
 static int rr_index(READ_RECORD *info);
@@ -261,8 +261,7 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
 	(ulonglong) MIN_FILE_LENGTH_TO_USE_ROW_CACHE &&
 	info->io_cache->end_of_file/info->ref_length * table->s->reclength >
 	(my_off_t) MIN_ROWS_TO_USE_TABLE_CACHE &&
-	!table->s->blob_fields &&
-        info->ref_length <= MAX_REFLENGTH)
+	!table->s->blob_fields)
     {
       if (! init_rr_cache(thd, info))
       {
@@ -664,32 +663,38 @@ static int rr_unpack_from_buffer(READ_RECORD *info)
 }
 	/* cacheing of records from a database */
 
-static const uint STRUCT_LENGTH= 3 + MAX_REFLENGTH;
+/*
+  Each entry of read_positions is a row reference followed by the 3-byte
+  position of the row in the cache. The length follows ref_length, so that
+  engines with long references (such as InnoDB, whose reference is the
+  primary key) can use the cache too.
+*/
 
 static int init_rr_cache(THD *thd, READ_RECORD *info)
 {
   uint rec_cache_size, cache_records;
   DBUG_ENTER("init_rr_cache");
 
+  info->struct_length= 3 + info->ref_length;
   info->reclength= ALIGN_SIZE(info->table->s->reclength+1);
-  if (info->reclength < STRUCT_LENGTH)
-    info->reclength= ALIGN_SIZE(STRUCT_LENGTH);
+  if (info->reclength < info->struct_length)
+    info->reclength= ALIGN_SIZE(info->struct_length);
 
   info->error_offset= info->table->s->reclength;
   cache_records= thd->variables.read_rnd_buff_size /
-                 (info->reclength + STRUCT_LENGTH);
+                 (info->reclength + info->struct_length);
   rec_cache_size= cache_records * info->reclength;
   info->rec_cache_size= cache_records * info->ref_length;
 
   // We have to allocate one more byte to use uint3korr (see comments for it)
   if (cache_records <= 2 ||
       !(info->cache= (uchar*) my_malloc_lock(rec_cache_size + cache_records *
-                                             STRUCT_LENGTH + 1,
+                                             info->struct_length + 1,
                                              MYF(MY_THREAD_SPECIFIC))))
     DBUG_RETURN(1);
 #ifdef HAVE_valgrind
   // Avoid warnings in qsort
-  bzero(info->cache, rec_cache_size + cache_records * STRUCT_LENGTH + 1);
+  bzero(info->cache, rec_cache_size + cache_records * info->struct_length + 1);
 #endif
   DBUG_PRINT("info", ("Allocated buffer for %d records", cache_records));
   info->read_positions=info->cache+rec_cache_size;
@@ -742,17 +747,23 @@ static int rr_from_cache(READ_RECORD *info)
     for (i=0 ; i < length ; i++,position+=info->ref_length)
     {
       memcpy(ref_position,position,(size_t) info->ref_length);
-      ref_position+=MAX_REFLENGTH;
+      ref_position+=info->ref_length;
       int3store(ref_position,(long) i);
       ref_position+=3;
     }
-    my_qsort(info->read_positions, length, STRUCT_LENGTH, (qsort_cmp) rr_cmp);
+    /*
+      Fetch the rows in the order of the engine's own reference comparison,
+      which for InnoDB is primary key order, not the byte order of the
+      stored key image.
+    */
+    my_qsort2(info->read_positions, length, info->struct_length, rr_cmp,
+              info->table->file);
 
     position=info->read_positions;
     for (i=0 ; i < length ; i++)
     {
       memcpy(info->ref_pos,position,(size_t) info->ref_length);
-      position+=MAX_REFLENGTH;
+      position+=info->ref_length;
       record=uint3korr(position);
       position+=3;
       record_pos=info->cache+record*info->reclength;
@@ -772,27 +783,11 @@ static int rr_from_cache(READ_RECORD *info)
 } /* rr_from_cache */
 
 
-static int rr_cmp(uchar *a,uchar *b)
+static int rr_cmp(const void *cmp_arg, const void *a, const void *b)
 {
-  if (a[0] != b[0])
-    return (int) a[0] - (int) b[0];
-  if (a[1] != b[1])
-    return (int) a[1] - (int) b[1];
-  if (a[2] != b[2])
-    return (int) a[2] - (int) b[2];
-#if MAX_REFLENGTH == 4
-  return (int) a[3] - (int) b[3];
-#else
-  if (a[3] != b[3])
-    return (int) a[3] - (int) b[3];
-  if (a[4] != b[4])
-    return (int) a[4] - (int) b[4];
-  if (a[5] != b[5])
-    return (int) a[5] - (int) b[5];
-  if (a[6] != b[6])
-    return (int) a[6] - (int) b[6];
-  return (int) a[7] - (int) b[7];
-#endif
+  handler *file= static_cast<handler*>(const_cast<void*>(cmp_arg));
+  return file->cmp_ref(static_cast<const uchar*>(a),
+                       static_cast<const uchar*>(b));
 }
 
 
@@ -60,6 +60,7 @@ struct READ_RECORD
   THD *thd;
   SQL_SELECT *select;
   uint ref_length, reclength, rec_cache_size, error_offset;
+  uint struct_length;                           /* rr_from_cache entry */
 
   /**
     Counting records when reading result from filesort().
@@ -30,6 +30,8 @@ double Range_rowid_filter_cost_info::lookup_cost(
   switch (cont_type) {
   case SORTED_ARRAY_CONTAINER:
     return log(est_elements)*0.01;
+  case BLOOM_FILTER_CONTAINER:
+    return BLOOM_LOOKUP_COST;
   default:
     DBUG_ASSERT(0);
     return 0;
@@ -46,7 +48,9 @@ inline
 double Range_rowid_filter_cost_info::avg_access_and_eval_gain_per_row(
                                      Rowid_filter_container_type cont_type)
 {
-  return (1+1.0/TIME_FOR_COMPARE) * (1 - selectivity) -
+  double pass= cont_type == BLOOM_FILTER_CONTAINER ?
+               1 - BLOOM_FALSE_POSITIVE_RATE : 1;
+  return (1+1.0/TIME_FOR_COMPARE) * (1 - selectivity) * pass -
          lookup_cost(cont_type);
 }
 
@@ -146,6 +150,9 @@ Range_rowid_filter_cost_info::build_cost(Rowid_filter_container_type cont_type)
     cost+= ARRAY_WRITE_COST * est_elements; /* cost filling the container */
     cost+= ARRAY_SORT_C * est_elements * log(est_elements); /* sorting cost */
     break;
+  case BLOOM_FILTER_CONTAINER:
+    cost+= BLOOM_WRITE_COST * est_elements; /* cost filling the container */
+    break;
   default:
     DBUG_ASSERT(0);
   }
@@ -165,6 +172,9 @@ Rowid_filter_container *Range_rowid_filter_cost_info::create_container()
     res= new (thd->mem_root) Rowid_filter_sorted_array((uint) est_elements,
                                                        elem_sz);
     break;
+  case BLOOM_FILTER_CONTAINER:
+    res= new (thd->mem_root) Rowid_filter_bloom((uint) est_elements, elem_sz);
+    break;
   default:
     DBUG_ASSERT(0);
   }
@@ -315,6 +325,8 @@ get_max_range_rowid_filter_elems_for_table(
   switch (cont_type) {
   case SORTED_ARRAY_CONTAINER :
     return thd->variables.max_rowid_filter_size/tab->file->ref_length;
+  case BLOOM_FILTER_CONTAINER :
+    return thd->variables.max_rowid_filter_size * 8 / BLOOM_BITS_PER_ELEM;
   default :
     DBUG_ASSERT(0);
     return 0;
@@ -355,6 +367,8 @@ void TABLE::init_cost_info_for_usable_range_rowid_filters(THD *thd)
     - range filter pushdown is supported by the engine for them     (1)
     - they are not clustered primary                                (2)
     - the range filter containers for them are not too large        (3)
+    A bloom filter is used for the filters that would not fit into
+    a sorted array of max_rowid_filter_size bytes.
   */
   while ((key_no= it++) != key_map::Iterator::BITMAP_END)
   {
@@ -364,7 +378,10 @@ void TABLE::init_cost_info_for_usable_range_rowid_filters(THD *thd)
       continue;
    if (opt_range[key_no].rows >
        get_max_range_rowid_filter_elems_for_table(thd, this,
-                                                  SORTED_ARRAY_CONTAINER)) // !3
+                                                  SORTED_ARRAY_CONTAINER) &&
+       opt_range[key_no].rows >
+       get_max_range_rowid_filter_elems_for_table(thd, this,
+                                                  BLOOM_FILTER_CONTAINER)) // !3
       continue;
     usable_range_filter_keys.set_bit(key_no);
   }
@@ -401,7 +418,12 @@ void TABLE::init_cost_info_for_usable_range_rowid_filters(THD *thd)
   while ((key_no= li++) != key_map::Iterator::BITMAP_END)
   {
     *curr_ptr= curr_filter_cost_info;
-    curr_filter_cost_info->init(SORTED_ARRAY_CONTAINER, this, key_no);
+    curr_filter_cost_info->init(opt_range[key_no].rows <=
+                                get_max_range_rowid_filter_elems_for_table(
+                                  thd, this, SORTED_ARRAY_CONTAINER) ?
+                                SORTED_ARRAY_CONTAINER :
+                                BLOOM_FILTER_CONTAINER,
+                                this, key_no);
     curr_ptr++;
     curr_filter_cost_info++;
   }
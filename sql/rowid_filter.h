@@ -150,10 +150,21 @@ class Range_rowid_filter_cost_info;
 /* Cost to evaluate condition */
 #define COST_COND_EVAL  0.2
 
+/* Cost to set the bits of a rowid in a bloom filter */
+#define BLOOM_WRITE_COST      0.005
+/* Cost to check the bits of a rowid in a bloom filter */
+#define BLOOM_LOOKUP_COST     0.02
+/* Number of bits of a bloom filter per element */
+#define BLOOM_BITS_PER_ELEM   10
+/* Number of bits set in a bloom filter for one element */
+#define BLOOM_N_HASHES        5
+/* Share of rowids not in a bloom filter for which check() returns true */
+#define BLOOM_FALSE_POSITIVE_RATE 0.01
+
 typedef enum
 {
   SORTED_ARRAY_CONTAINER,
-  BLOOM_FILTER_CONTAINER      // Not used yet
+  BLOOM_FILTER_CONTAINER
 } Rowid_filter_container_type;
 
 /**
@@ -370,6 +381,80 @@ class Rowid_filter_sorted_array: public Rowid_filter_container
   bool check(void *ctxt, char *elem);
 };
 
+
+/**
+  @class Rowid_filter_bloom
+  The implementation of the Rowid_filter_container interface as
+  a bloom filter of rowids / primary keys
+
+  It takes BLOOM_BITS_PER_ELEM bits per element instead of the length
+  of a rowid, so it is used for filters that are too large for a sorted
+  array. A check may return true for an element that was not added.
+*/
+
+class Rowid_filter_bloom: public Rowid_filter_container
+{
+  /* Number of bits in the filter */
+  uint n_bits;
+  /* Length of an element */
+  uint elem_size;
+  /* The bits of the filter */
+  uchar *bits;
+
+  /* Get the first bit to set for elem and the step to the next ones */
+  void hash(const char *elem, uint32 *h1, uint32 *h2) const
+  {
+    *h1= my_crc32c(0, elem, elem_size);
+    *h2= my_crc32c(0x9e3779b9, elem, elem_size) | 1;
+  }
+  /* Map a 32-bit hash value to a bit number less than n_bits */
+  uint bit_no(uint32 h) const
+  {
+    return (uint) (((ulonglong) h * n_bits) >> 32);
+  }
+public:
+  Rowid_filter_bloom(uint elems, uint elem_sz)
+    : n_bits(MY_MAX(elems, 8) * BLOOM_BITS_PER_ELEM), elem_size(elem_sz),
+      bits(0) {}
+
+  ~Rowid_filter_bloom() { my_free(bits); }
+
+  Rowid_filter_container_type get_type()
+  { return BLOOM_FILTER_CONTAINER; }
+
+  bool alloc()
+  {
+    bits= (uchar *) my_malloc(PSI_INSTRUMENT_ME, (n_bits + 7) / 8,
+                              MYF(MY_WME | MY_ZEROFILL));
+    return bits == NULL;
+  }
+
+  bool add(void *ctxt, char *elem)
+  {
+    uint32 h1, h2;
+    hash(elem, &h1, &h2);
+    for (uint i= 0; i < BLOOM_N_HASHES; i++, h1+= h2)
+    {
+      uint n= bit_no(h1);
+      bits[n / 8]|= (uchar) (1 << (n % 8));
+    }
+    return false;
+  }
+
+  bool check(void *ctxt, char *elem)
+  {
+    uint32 h1, h2;
+    hash(elem, &h1, &h2);
+    for (uint i= 0; i < BLOOM_N_HASHES; i++, h1+= h2)
+    {
+      uint n= bit_no(h1);
+      if (!(bits[n / 8] & (1 << (n % 8))))
+        return false;
+    }
+    return true;
+  }
+};
+
 /**
   @class Range_rowid_filter_cost_info
 
@@ -2237,6 +2237,8 @@ free_rpl_parallel_entry(void *element)
     dealloc_gco(e->current_gco);
     e->current_gco= prev_gco;
   }
+  my_hash_free(&e->writeset_hash);
+  free_root(&e->writeset_root, MYF(0));
   mysql_cond_destroy(&e->COND_parallel_entry);
   mysql_mutex_destroy(&e->LOCK_parallel_entry);
   my_free(e);
@@ -2301,6 +2303,9 @@ rpl_parallel::find(uint32 domain_id)
     mysql_mutex_init(key_LOCK_parallel_entry, &e->LOCK_parallel_entry,
                      MY_MUTEX_INIT_FAST);
     mysql_cond_init(key_COND_parallel_entry, &e->COND_parallel_entry, NULL);
+    my_hash_init(PSI_INSTRUMENT_ME, &e->writeset_hash, &my_charset_bin, 64, 0,
+                 sizeof(ulonglong), NULL, NULL, 0);
+    init_alloc_root(PSI_INSTRUMENT_ME, &e->writeset_root, 8192, 0, MYF(0));
   }
   else
     e->force_abort= false;
@@ -2308,6 +2313,76 @@ rpl_parallel::find(uint32 domain_id)
   return e;
 }
 
+/*
+  Upper limit for the number of hashes in the writeset of one
+  group_commit_orderer, to bound the memory used for it.
+*/
+static const uint WRITESET_MAX_GCO_SIZE= 65536;
+
+
+/*
+  Check whether an event group may conflict with the event groups of
+  current_gco, for slave_parallel_mode=writeset.
+
+  @return false if the event group has a writeset and it does not intersect
+  the writesets of all event groups in current_gco.
+*/
+bool
+rpl_parallel_entry::writeset_conflicts(Gtid_log_event *gtid_ev)
+{
+  if (!writeset_valid ||
+      !(gtid_ev->flags_extra & Gtid_log_event::FL_EXTRA_WRITESET))
+    return true;
+  for (uint32 i= 0; i < gtid_ev->writeset_count; i++)
+  {
+    if (my_hash_search(&writeset_hash, (const uchar *) &gtid_ev->writeset[i],
+                       sizeof(ulonglong)))
+      return true;
+  }
+  return false;
+}
+
+
+/*
+  Add the writeset of an event group queued in current_gco, starting
+  a new writeset for a new current_gco.
+*/
+void
+rpl_parallel_entry::writeset_add(Gtid_log_event *gtid_ev, bool new_gco)
+{
+  if (new_gco)
+  {
+    my_hash_reset(&writeset_hash);
+    free_root(&writeset_root, MYF(MY_MARK_BLOCKS_FREE));
+    writeset_valid= true;
+    writeset_extended= false;
+  }
+  if (!writeset_valid)
+    return;
+  if (!(gtid_ev->flags_extra & Gtid_log_event::FL_EXTRA_WRITESET) ||
+      writeset_hash.records + gtid_ev->writeset_count > WRITESET_MAX_GCO_SIZE)
+  {
+    writeset_valid= false;
+    return;
+  }
+  for (uint32 i= 0; i < gtid_ev->writeset_count; i++)
+  {
+    ulonglong *hash;
+    if (my_hash_search(&writeset_hash, (const uchar *) &gtid_ev->writeset[i],
+                       sizeof(ulonglong)))
+      continue;
+    if (!(hash= (ulonglong *) memdup_root(&writeset_root,
+                                          &gtid_ev->writeset[i],
+                                          sizeof(ulonglong))) ||
+        my_hash_insert(&writeset_hash, (uchar *) hash))
+    {
+      writeset_valid= false;
+      return;
+    }
+  }
+}
+
+
 /**
   Wait until all sql worker threads has stopped processing
 
@@ -2829,7 +2904,8 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
       if (gtid_flags & Gtid_log_event::FL_DDL)
         flags|= (force_switch_flag= group_commit_orderer::FORCE_SWITCH);
 
-      if (!(flags & group_commit_orderer::MULTI_BATCH))
+      if (!(flags & group_commit_orderer::MULTI_BATCH) &&
+          !(mode == SLAVE_PARALLEL_WRITESET && e->writeset_extended))
       {
         /*
           Still the same batch of event groups that group-committed together
@@ -2837,6 +2913,25 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
         */
         new_gco= false;
       }
+      else if (mode == SLAVE_PARALLEL_WRITESET &&
+               !(flags & group_commit_orderer::FORCE_SWITCH) &&
+               (gtid_flags & Gtid_log_event::FL_TRANSACTIONAL) &&
+               (gtid_flags & Gtid_log_event::FL_ALLOW_PARALLEL) &&
+               !e->writeset_conflicts(gtid_ev))
+      {
+        /*
+          The event group modified none of the rows modified by the event
+          groups in this batch, so it can run in parallel with them even if
+          it did not group-commit with them on the master.
+
+          The batch then no longer consists of event groups that
+          group-committed together, so from now on only the writeset
+          decides which event groups can join it.
+        */
+        new_gco= false;
+        flags&= ~group_commit_orderer::MULTI_BATCH;
+        e->writeset_extended= true;
+      }
       else if ((mode >= SLAVE_PARALLEL_OPTIMISTIC) &&
                !(flags & group_commit_orderer::FORCE_SWITCH))
       {
@@ -2881,6 +2976,8 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
         force_switch_flag= group_commit_orderer::FORCE_SWITCH;
     }
     rgi->speculation= speculation;
+    if (mode == SLAVE_PARALLEL_WRITESET)
+      e->writeset_add(gtid_ev, new_gco);
 
     if (gtid_flags & Gtid_log_event::FL_GROUP_COMMIT_ID)
       e->last_commit_id= gtid_ev->commit_id;
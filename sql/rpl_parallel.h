@@ -345,12 +345,25 @@ struct rpl_parallel_entry {
   uint64 count_committing_event_groups;
   /* The group_commit_orderer object for the events currently being queued. */
   group_commit_orderer *current_gco;
+  /*
+    For slave_parallel_mode=writeset, the union of the writesets of the event
+    groups in current_gco, allocated in writeset_root. writeset_valid is
+    cleared when some event group in current_gco has no writeset, and
+    writeset_extended is set when an event group was added to current_gco
+    because its writeset did not conflict.
+  */
+  HASH writeset_hash;
+  MEM_ROOT writeset_root;
+  bool writeset_valid;
+  bool writeset_extended;
 
   rpl_parallel_thread * choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
                                       PSI_stage_info *old_stage,
                                       Gtid_log_event *gtid_ev);
   int queue_master_restart(rpl_group_info *rgi,
                            Format_description_log_event *fdev);
+  bool writeset_conflicts(Gtid_log_event *gtid_ev);
+  void writeset_add(Gtid_log_event *gtid_ev, bool new_gco);
 };
 struct rpl_parallel {
   HASH domain_hash;
@@ -205,10 +205,10 @@ int Active_tranx::insert_tranx_node(const char *log_file_name,
   DBUG_RETURN(result);
 }
 
-bool Active_tranx::is_tranx_end_pos(const char *log_file_name,
-                                    my_off_t    log_file_pos)
+Tranx_node *Active_tranx::find_tranx_node(const char *log_file_name,
+                                          my_off_t    log_file_pos)
 {
-  DBUG_ENTER("Active_tranx::is_tranx_end_pos");
+  DBUG_ENTER("Active_tranx::find_tranx_node");
 
   unsigned int hash_val = get_hash_value(log_file_name, log_file_pos);
   Tranx_node *entry = m_trx_htb[hash_val];
@@ -222,10 +222,10 @@ bool Active_tranx::is_tranx_end_pos(const char *log_file_name,
   }
 
   DBUG_PRINT("semisync", ("%s: probe (%s, %lu) in entry(%u)",
-                          "Active_tranx::is_tranx_end_pos",
+                          "Active_tranx::find_tranx_node",
                           log_file_name, (ulong)log_file_pos, hash_val));
 
-  DBUG_RETURN(entry != NULL);
+  DBUG_RETURN(entry);
 }
 
 void Active_tranx::clear_active_tranx_nodes(const char *log_file_name,
@@ -256,6 +256,11 @@ void Active_tranx::clear_active_tranx_nodes(const char *log_file_name,
   {
     /* No active transaction nodes after the call. */
 
+    /* Wake up the committers waiting for any of the nodes. */
+    for (Tranx_node *node= m_trx_front; node; node= node->next)
+      if (node->cond)
+        mysql_cond_signal(node->cond);
+
     /* Clear the hash table. */
     memset(m_trx_htb, 0, m_num_entries * sizeof(Tranx_node *));
     m_allocator.free_all_nodes();
@@ -282,6 +287,10 @@ void Active_tranx::clear_active_tranx_nodes(const char *log_file_name,
       next_node = curr_node->next;
       n_frees++;
 
+      /* The reply covers this transaction, wake up its committer. */
+      if (curr_node->cond)
+        mysql_cond_signal(curr_node->cond);
+
       /* Remove the node from the hash table. */
       unsigned int hash_val = get_hash_value(curr_node->log_name, curr_node->log_pos);
       Tranx_node **hash_ptr = &(m_trx_htb[hash_val]);
@@ -341,6 +350,7 @@ Repl_semi_sync_master::Repl_semi_sync_master()
     m_reply_file_pos(0L),
     m_wait_file_name_inited(false),
     m_wait_file_pos(0),
+    m_wait_send_sessions(0),
     m_master_enabled(false),
     m_wait_timeout(0L),
     m_state(0),
@@ -478,14 +488,14 @@ void Repl_semi_sync_master::cond_broadcast()
   mysql_cond_broadcast(&COND_binlog_send);
 }
 
-int Repl_semi_sync_master::cond_timewait(struct timespec *wait_time)
+int Repl_semi_sync_master::cond_timewait(mysql_cond_t *cond,
+                                         struct timespec *wait_time)
 {
   int wait_res;
 
   DBUG_ENTER("Repl_semi_sync_master::cond_timewait()");
 
-  wait_res= mysql_cond_timedwait(&COND_binlog_send,
-                                 &LOCK_binlog, wait_time);
+  wait_res= mysql_cond_timedwait(cond, &LOCK_binlog, wait_time);
 
   DBUG_RETURN(wait_res);
 }
@@ -637,10 +647,12 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
                                 m_wait_file_name, m_wait_file_pos);
     if (cmp >= 0)
     {
-      /* Yes, at least one waiting thread can now proceed:
-       * let us release all waiting threads with a broadcast
+      /* Yes, at least one waiting thread can now proceed.  The threads
+       * waiting for the cleared transaction nodes have been signaled by
+       * clear_active_tranx_nodes(); release the ones waiting without a
+       * node of their own with a broadcast.
        */
-      can_release_threads = true;
+      can_release_threads = m_wait_send_sessions > 0;
       m_wait_file_name_inited = false;
     }
   }
@@ -790,6 +802,9 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     int wait_result;
     PSI_stage_info old_stage;
     THD *thd= current_thd;
+    Tranx_node *node= NULL;
+    mysql_cond_t ack_cond;
+    mysql_cond_t *wait_cond= &COND_binlog_send;
 
     set_timespec(start_ts, 0);
 
@@ -797,8 +812,22 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     /* Acquire the mutex. */
     lock();
 
+    /*
+      Wait on a condition of our own that report_reply_binlog() signals
+      when the reply covers our position, so that a reply does not wake
+      up all the waiting committers.
+    */
+    if (get_master_enabled() && is_on() &&
+        (node= m_active_tranxs->find_tranx_node(trx_wait_binlog_name,
+                                                trx_wait_binlog_pos)) &&
+        !node->cond)
+    {
+      mysql_cond_init(key_COND_binlog_send, &ack_cond, NULL);
+      node->cond= wait_cond= &ack_cond;
+    }
+
     /* This must be called after acquired the lock */
-    THD_ENTER_COND(thd, &COND_binlog_send, &LOCK_binlog,
+    THD_ENTER_COND(thd, wait_cond, &LOCK_binlog,
                    & stage_waiting_for_semi_sync_ack_from_slave,
                    & old_stage);
 
@@ -878,14 +907,18 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
        * these waiting threads.
        */
       rpl_semi_sync_master_wait_sessions++;
+      if (wait_cond == &COND_binlog_send)
+        m_wait_send_sessions++;
 
       DBUG_PRINT("semisync", ("%s: wait %lu ms for binlog sent (%s, %lu)",
                               "Repl_semi_sync_master::commit_trx",
                               m_wait_timeout,
                               m_wait_file_name, (ulong)m_wait_file_pos));
 
-      wait_result = cond_timewait(&abstime);
+      wait_result = cond_timewait(wait_cond, &abstime);
       rpl_semi_sync_master_wait_sessions--;
+      if (wait_cond == &COND_binlog_send)
+        m_wait_send_sessions--;
 
       if (wait_result != 0)
       {
@@ -931,6 +964,20 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
                                              trx_wait_binlog_pos));
 
   l_end:
+    if (wait_cond != &COND_binlog_send)
+    {
+      /*
+        The node is still there if we were killed; it must not point to
+        our condition once we return. Look it up again, as it may have
+        been freed while we waited.
+      */
+      if (m_active_tranxs &&
+          (node= m_active_tranxs->find_tranx_node(trx_wait_binlog_name,
+                                                  trx_wait_binlog_pos)) &&
+          node->cond == wait_cond)
+        node->cond= NULL;
+    }
+
     /* Update the status counter. */
     if (is_on())
       rpl_semi_sync_master_yes_transactions++;
@@ -940,6 +987,9 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     /* The lock held will be released by thd_exit_cond, so no need to
        call unlock() here */
     THD_EXIT_COND(thd, &old_stage);
+
+    if (wait_cond != &COND_binlog_send)
+      mysql_cond_destroy(wait_cond);
   }
 
   DBUG_RETURN(0);
@@ -33,6 +33,8 @@ struct Tranx_node {
   my_off_t          log_pos;
   struct Tranx_node *next;            /* the next node in the sorted list */
   struct Tranx_node *hash_next;    /* the next node during hash collision */
+  /* The committer waiting for the reply on this position, or NULL */
+  mysql_cond_t      *cond;
 };
 
 /**
@@ -128,6 +130,7 @@ class Tranx_node_allocator
     trx_node->log_pos= 0;
     trx_node->next= 0;
     trx_node->hash_next= 0;
+    trx_node->cond= 0;
     return trx_node;
   }
 
@@ -341,7 +344,7 @@ class Active_tranx
   int insert_tranx_node(const char *log_file_name, my_off_t log_file_pos);
 
   /* Clear the active transaction nodes until(inclusive) the specified
-   * position.
+   * position, and signal the committers that wait on them.
    * If log_file_name is NULL, everything will be cleared: the sorted
    * list and the hash table will be reset to empty.
    */
@@ -351,7 +354,16 @@ class Active_tranx
   /* Given a position, check to see whether the position is an active
    * transaction's ending position by probing the hash table.
    */
-  bool is_tranx_end_pos(const char *log_file_name, my_off_t log_file_pos);
+  bool is_tranx_end_pos(const char *log_file_name, my_off_t log_file_pos)
+  {
+    return find_tranx_node(log_file_name, log_file_pos) != NULL;
+  }
+
+  /* Return the active transaction node with the given ending position,
+   * or NULL.
+   */
+  Tranx_node *find_tranx_node(const char *log_file_name,
+                              my_off_t log_file_pos);
 
   /* Given two binlog positions, compare which one is bigger based on
    * (file_name, file_position).
@@ -374,9 +386,15 @@ class Repl_semi_sync_master
 
   /* This cond variable is signaled when enough binlog has been sent to slave,
    * so that a waiting trx can return the 'ok' to the client for a commit.
+   * Only committers whose position is not in the active transaction list
+   * wait on it, the others wait on their own condition in Tranx_node::cond,
+   * which is signaled when the reply covers that position.
    */
   mysql_cond_t  COND_binlog_send;
 
+  /* The number of committers waiting on COND_binlog_send. */
+  ulong           m_wait_send_sessions;
+
   /* Mutex that protects the following state variables and the active
    * transaction list.
    * Under no cirumstances we can acquire mysql_bin_log.LOCK_log if we are
@@ -434,7 +452,7 @@ class Repl_semi_sync_master
   void lock();
   void unlock();
   void cond_broadcast();
-  int  cond_timewait(struct timespec *wait_time);
+  int  cond_timewait(mysql_cond_t *cond, struct timespec *wait_time);
 
   /* Is semi-sync replication on? */
   bool is_on() {
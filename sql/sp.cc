@@ -689,16 +689,11 @@ Sp_handler::db_find_routine(THD *thd,
                             sp_head **sphp) const
 {
   TABLE *table;
-  LEX_CSTRING params, returns, body;
   int ret;
-  longlong created;
-  longlong modified;
-  Sp_chistics chistics;
   bool saved_time_zone_used= thd->time_zone_used;
   bool trans_commited= 0;
-  sql_mode_t sql_mode;
-  Stored_program_creation_ctx *creation_ctx;
-  AUTHID definer;
+  Sp_definition def;
+  ulong version;
   DBUG_ENTER("db_find_routine");
   DBUG_PRINT("enter", ("type: %s name: %.*s",
 		       type_str(),
@@ -706,6 +701,18 @@ Sp_handler::db_find_routine(THD *thd,
 
   *sphp= 0;                                     // In case of errors
 
+  /*
+    The version must be read before mysql.proc, so that a definition
+    that was changed meanwhile is not put into the shared cache as an
+    up to date one.
+  */
+  version= sp_cache_version();
+  if (sp_definition_cache_lookup(thd->mem_root, type(), name, &def))
+    DBUG_RETURN(db_load_routine(thd, name, sphp, def.sql_mode, def.params,
+                                def.returns, def.body, def.chistics,
+                                def.definer, def.created, def.modified,
+                                NULL, def.creation_ctx));
+
   start_new_trans new_trans(thd);
   Sql_mode_instant_set sms(thd, 0);
 
@@ -724,45 +731,50 @@ Sp_handler::db_find_routine(THD *thd,
     goto done;
   }
 
-  if (chistics.read_from_mysql_proc_row(thd, table) ||
-      definer.read_from_mysql_proc_row(thd, table))
+  if (def.chistics.read_from_mysql_proc_row(thd, table) ||
+      def.definer.read_from_mysql_proc_row(thd, table))
   {
     ret= SP_GET_FIELD_FAILED;
     goto done;
   }
 
   table->field[MYSQL_PROC_FIELD_PARAM_LIST]->val_str_nopad(thd->mem_root,
-                                                           &params);
+                                                           &def.params);
   if (type() != SP_TYPE_FUNCTION)
-    returns= empty_clex_str;
+    def.returns= empty_clex_str;
   else if (table->field[MYSQL_PROC_FIELD_RETURNS]->val_str_nopad(thd->mem_root,
-                                                                 &returns))
+                                                                 &def.returns))
   {
     ret= SP_GET_FIELD_FAILED;
     goto done;
   }
 
   if (table->field[MYSQL_PROC_FIELD_BODY]->val_str_nopad(thd->mem_root,
-                                                         &body))
+                                                         &def.body))
   {
     ret= SP_GET_FIELD_FAILED;
     goto done;
   }
 
   // Get additional information
-  modified= table->field[MYSQL_PROC_FIELD_MODIFIED]->val_int();
-  created= table->field[MYSQL_PROC_FIELD_CREATED]->val_int();
-  sql_mode= (sql_mode_t) table->field[MYSQL_PROC_FIELD_SQL_MODE]->val_int();
+  def.modified= table->field[MYSQL_PROC_FIELD_MODIFIED]->val_int();
+  def.created= table->field[MYSQL_PROC_FIELD_CREATED]->val_int();
+  def.sql_mode=
+    (sql_mode_t) table->field[MYSQL_PROC_FIELD_SQL_MODE]->val_int();
 
-  creation_ctx= Stored_routine_creation_ctx::load_from_db(thd, name, table);
+  def.creation_ctx= Stored_routine_creation_ctx::load_from_db(thd, name,
+                                                              table);
 
   trans_commited= 1;
   thd->commit_whole_transaction_and_close_tables();
   new_trans.restore_old_transaction();
 
+  sp_definition_cache_insert(type(), name, version, &def);
+
   ret= db_load_routine(thd, name, sphp,
-                       sql_mode, params, returns, body, chistics, definer,
-                       created, modified, NULL, creation_ctx);
+                       def.sql_mode, def.params, def.returns, def.body,
+                       def.chistics, def.definer, def.created, def.modified,
+                       NULL, def.creation_ctx);
  done:
   /* 
     Restore the time zone flag as the timezone usage in proc table
@@ -26,6 +26,25 @@ static mysql_mutex_t Cversion_lock;
 static ulong volatile Cversion= 1;
 
 
+/*
+  Routine definition in the cache shared by all threads.
+*/
+
+struct sp_definition_cache_entry
+{
+  MEM_ROOT mem_root;
+  /* Routine type followed by the qualified name */
+  LEX_CSTRING key;
+  /* Cversion before the definition was read from mysql.proc */
+  ulong version;
+  Sp_definition def;
+};
+
+static mysql_mutex_t LOCK_sp_definitions;
+/* sp_definition_cache_entry objects, protected by LOCK_sp_definitions */
+static HASH sp_definitions;
+
+
 /*
   Cache of stored routines.
 */
@@ -81,11 +100,12 @@ class sp_cache
 }; // class sp_cache
 
 #ifdef HAVE_PSI_INTERFACE
-static PSI_mutex_key key_Cversion_lock;
+static PSI_mutex_key key_Cversion_lock, key_LOCK_sp_definitions;
 
 static PSI_mutex_info all_sp_cache_mutexes[]=
 {
-  { &key_Cversion_lock, "Cversion_lock", PSI_FLAG_GLOBAL}
+  { &key_Cversion_lock, "Cversion_lock", PSI_FLAG_GLOBAL},
+  { &key_LOCK_sp_definitions, "LOCK_sp_definitions", PSI_FLAG_GLOBAL}
 };
 
 static void init_sp_cache_psi_keys(void)
@@ -101,6 +121,11 @@ static void init_sp_cache_psi_keys(void)
 }
 #endif
 
+extern "C" uchar *hash_get_key_for_sp_definition(const uchar *ptr,
+                                                 size_t *plen,
+                                                 my_bool first);
+extern "C" void hash_free_sp_definition(void *p);
+
 /* Initialize the SP caching once at startup */
 
 void sp_cache_init()
@@ -110,6 +135,11 @@ void sp_cache_init()
 #endif
 
   mysql_mutex_init(key_Cversion_lock, &Cversion_lock, MY_MUTEX_INIT_FAST);
+  mysql_mutex_init(key_LOCK_sp_definitions, &LOCK_sp_definitions,
+                   MY_MUTEX_INIT_FAST);
+  my_hash_init(key_memory_sp_cache, &sp_definitions, system_charset_info,
+               0, 0, 0, hash_get_key_for_sp_definition,
+               hash_free_sp_definition, 0);
 }
 
 
@@ -138,6 +168,8 @@ void sp_cache_clear(sp_cache **cp)
 
 void sp_cache_end()
 {
+  my_hash_free(&sp_definitions);
+  mysql_mutex_destroy(&LOCK_sp_definitions);
   mysql_mutex_destroy(&Cversion_lock);
 }
 
@@ -263,6 +295,128 @@ sp_cache_enforce_limit(sp_cache *c, ulong upper_limit_for_elements)
    c->enforce_limit(upper_limit_for_elements);
 }
 
+
+static bool copy_lex_cstring(MEM_ROOT *mem_root, LEX_CSTRING *to,
+                             const LEX_CSTRING &from)
+{
+  to->length= from.length;
+  return !(to->str= strmake_root(mem_root, from.str ? from.str : "",
+                                 from.length));
+}
+
+
+/**
+  Copy a routine definition with all its strings to a memory root.
+
+  @return Error status
+*/
+
+static bool copy_sp_definition(MEM_ROOT *mem_root, Sp_definition *to,
+                               const Sp_definition *from)
+{
+  if (!from->creation_ctx)
+    return true;
+  to->sql_mode= from->sql_mode;
+  to->chistics= from->chistics;
+  to->created= from->created;
+  to->modified= from->modified;
+  return copy_lex_cstring(mem_root, &to->params, from->params) ||
+         copy_lex_cstring(mem_root, &to->returns, from->returns) ||
+         copy_lex_cstring(mem_root, &to->body, from->body) ||
+         copy_lex_cstring(mem_root, &to->chistics.comment,
+                          from->chistics.comment) ||
+         copy_lex_cstring(mem_root, &to->definer.user, from->definer.user) ||
+         copy_lex_cstring(mem_root, &to->definer.host, from->definer.host) ||
+         !(to->creation_ctx= from->creation_ctx->clone(mem_root));
+}
+
+
+static size_t make_sp_definition_key(char *buf, size_t size, uint type,
+                                     const Database_qualified_name *name)
+{
+  buf[0]= (char) type;
+  return 1 + name->make_qname(buf + 1, size - 1);
+}
+
+
+/**
+  Look up the definition of a routine in the cache shared by all threads.
+
+  @param[in]  mem_root  Memory root for the strings of the definition
+  @param[in]  type      Routine type
+  @param[in]  name      Routine name
+  @param[out] def       The definition
+
+  @return Whether an up to date definition was found
+*/
+
+bool sp_definition_cache_lookup(MEM_ROOT *mem_root, uint type,
+                                const Database_qualified_name *name,
+                                Sp_definition *def)
+{
+  char key[NAME_LEN * 2 + 3];
+  size_t key_length= make_sp_definition_key(key, sizeof(key), type, name);
+  bool found= false;
+
+  mysql_mutex_lock(&LOCK_sp_definitions);
+  sp_definition_cache_entry *entry=
+    (sp_definition_cache_entry *) my_hash_search(&sp_definitions,
+                                                 (uchar *) key, key_length);
+  /* Reading a ulong variable with no lock. */
+  if (entry && entry->version == Cversion)
+    found= !copy_sp_definition(mem_root, def, &entry->def);
+  mysql_mutex_unlock(&LOCK_sp_definitions);
+  return found;
+}
+
+
+/**
+  Put the definition of a routine into the cache shared by all threads.
+
+  @param type     Routine type
+  @param name     Routine name
+  @param version  sp_cache_version() before the definition was read
+  @param def      The definition
+
+  @note The cache is emptied when it holds more than stored_program_cache
+  definitions, in the same way as the per-thread caches are.
+*/
+
+void sp_definition_cache_insert(uint type, const Database_qualified_name *name,
+                                ulong version, const Sp_definition *def)
+{
+  char key[NAME_LEN * 2 + 3];
+  size_t key_length= make_sp_definition_key(key, sizeof(key), type, name);
+  sp_definition_cache_entry *entry;
+
+  /* The definition may already be obsolete */
+  if (version != Cversion || !stored_program_cache_size)
+    return;
+
+  if (!(entry= (sp_definition_cache_entry *)
+        my_malloc(key_memory_sp_cache, sizeof(*entry), MYF(0))))
+    return;
+  init_sql_alloc(key_memory_sp_cache, &entry->mem_root, 1024, 0, MYF(0));
+  entry->version= version;
+  if (!(entry->key.str= (char *) memdup_root(&entry->mem_root, key,
+                                             key_length)) ||
+      copy_sp_definition(&entry->mem_root, &entry->def, def))
+  {
+    hash_free_sp_definition(entry);
+    return;
+  }
+  entry->key.length= key_length;
+
+  mysql_mutex_lock(&LOCK_sp_definitions);
+  if (uchar *old= my_hash_search(&sp_definitions, (uchar *) key, key_length))
+    my_hash_delete(&sp_definitions, old);
+  if (sp_definitions.records >= stored_program_cache_size)
+    my_hash_reset(&sp_definitions);
+  if (my_hash_insert(&sp_definitions, (uchar *) entry))
+    hash_free_sp_definition(entry);
+  mysql_mutex_unlock(&LOCK_sp_definitions);
+}
+
 /*************************************************************************
   Internal functions
  *************************************************************************/
@@ -287,6 +441,23 @@ void hash_free_sp_head(void *p)
 }
 
 
+uchar *hash_get_key_for_sp_definition(const uchar *ptr, size_t *plen,
+                                      my_bool first)
+{
+  sp_definition_cache_entry *entry= (sp_definition_cache_entry *) ptr;
+  *plen= entry->key.length;
+  return (uchar*) entry->key.str;
+}
+
+
+void hash_free_sp_definition(void *p)
+{
+  sp_definition_cache_entry *entry= (sp_definition_cache_entry *) p;
+  free_root(&entry->mem_root, MYF(0));
+  my_free(entry);
+}
+
+
 sp_cache::sp_cache()
 {
   init();
@@ -26,11 +26,17 @@
    * Each thread has its own cache.
    * Each sp_head object is put into its thread cache before it is used, and
      then remains in the cache until deleted.
+   * The definitions read from mysql.proc to create the sp_head objects
+     are kept in a cache shared by all threads, so that a routine that
+     was loaded by one thread is parsed by the others without reading
+     mysql.proc again.
 */
 
 class sp_head;
 class sp_cache;
 class Database_qualified_name;
+struct Sp_definition;
+typedef struct st_mem_root MEM_ROOT;
 
 /*
   Cache usage scenarios:
@@ -51,6 +57,11 @@ class Database_qualified_name;
   
   3. Before thread exit:
     sp_cache_clear();
+
+  4. Loading a routine from mysql.proc:
+    sp_cache_version();         // before reading mysql.proc
+    sp_definition_cache_lookup();
+    sp_definition_cache_insert();
 */
 
 void sp_cache_init();
@@ -62,5 +73,10 @@ void sp_cache_invalidate();
 void sp_cache_flush_obsolete(sp_cache **cp, sp_head **sp);
 ulong sp_cache_version();
 void sp_cache_enforce_limit(sp_cache *cp, ulong upper_limit_for_elements);
+bool sp_definition_cache_lookup(MEM_ROOT *mem_root, uint type,
+                                const Database_qualified_name *name,
+                                Sp_definition *def);
+void sp_definition_cache_insert(uint type, const Database_qualified_name *name,
+                                ulong version, const Sp_definition *def);
 
 #endif /* _SP_CACHE_H_ */
@@ -3486,7 +3486,15 @@ sp_lex_keeper::reset_lex_and_exec_core(THD *thd, uint *nextp,
 
   Json_writer_object trace_command(thd);
   Json_writer_array trace_command_steps(thd, "steps");
-  if (open_tables)
+  /*
+    An expression that reads no tables and invokes no stored functions,
+    like the ones of most SET, IF and RETURN instructions in loops, does
+    not need to open and lock tables, nor to end the statement
+    transaction and close the tables afterwards.
+  */
+  const bool use_tables= open_tables &&
+    (m_lex->query_tables || m_lex->uses_stored_routines());
+  if (use_tables)
     res= check_dependencies_in_with_clauses(m_lex->with_clauses_list) ||
          instr->exec_open_and_lock_tables(thd, m_lex->query_tables);
 
@@ -3501,8 +3509,9 @@ sp_lex_keeper::reset_lex_and_exec_core(THD *thd, uint *nextp,
     key read.
   */
   if (open_tables)
-  {
     m_lex->unit.cleanup();
+  if (use_tables)
+  {
     /* Here we also commit or rollback the current statement. */
     if (! thd->in_sub_stmt)
     {
@@ -107,6 +107,25 @@ class Stored_program_creation_ctx :public Default_object_creation_ctx
 
 /*************************************************************************/
 
+/**
+  Definition of a stored routine as it is stored in mysql.proc.
+*/
+
+struct Sp_definition
+{
+  sql_mode_t sql_mode;
+  LEX_CSTRING params;
+  LEX_CSTRING returns;
+  LEX_CSTRING body;
+  Sp_chistics chistics;
+  AUTHID definer;
+  longlong created;
+  longlong modified;
+  Stored_program_creation_ctx *creation_ctx;
+};
+
+/*************************************************************************/
+
 class sp_name : public Sql_alloc,
                 public Database_qualified_name
 {
@@ -12970,6 +12970,8 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
     thd->client_capabilities|= CLIENT_TRANSACTIONS;
 
   thd->client_capabilities|= CAN_CLIENT_COMPRESS;
+  if (opt_protocol_zstd_compression_level)
+    thd->client_capabilities|= CAN_CLIENT_ZSTD_COMPRESS;
 
   if (ssl_acceptor_fd)
   {
@@ -120,3 +120,13 @@ void process_gap_time_tracker(THD *thd, ulonglong timeval)
   }
 }
 
+/*
+  Bill the gap time, if any, up to now. Used by a sampling
+  Exec_time_tracker that does not time the current call.
+*/
+void close_gap_time_tracker(THD *thd)
+{
+  if (thd->gap_tracker_data.bill_to)
+    process_gap_time_tracker(thd, my_timer_cycles());
+}
+
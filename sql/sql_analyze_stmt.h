@@ -41,6 +41,7 @@ overhead. Because of that, we measure the time only when running "ANALYZE
 class Gap_time_tracker;
 void attach_gap_time_tracker(THD *thd, Gap_time_tracker *gap_tracker, ulonglong timeval);
 void process_gap_time_tracker(THD *thd, ulonglong timeval);
+void close_gap_time_tracker(THD *thd);
 
 /*
   A class for tracking time it takes to do a certain action
@@ -52,6 +53,20 @@ class Exec_time_tracker
   ulonglong cycles;
   ulonglong last_start;
 
+  /*
+    With sampling enabled, the first SAMPLING_START calls are all timed,
+    and after that only every SAMPLING_INTERVAL-th call. The time of the
+    timed calls is extrapolated to all calls, which keeps the cost of
+    timing per-row operations low in ANALYZE.
+  */
+  static const ulonglong SAMPLING_START= 1024;
+  static const ulonglong SAMPLING_INTERVAL= 16;
+  /* Number of timed calls, counted only when sampling */
+  ulonglong timed_count;
+  bool sampling;
+  /* Whether the current call is being timed */
+  bool timing;
+
   void cycles_stop_tracking(THD *thd)
   {
     ulonglong end= my_timer_cycles();
@@ -64,7 +79,8 @@ class Exec_time_tracker
       attach_gap_time_tracker(thd, my_gap_tracker, end);
   }
 public:
-  Exec_time_tracker() : count(0), cycles(0), my_gap_tracker(NULL) {}
+  Exec_time_tracker() : count(0), cycles(0), timed_count(0),
+    sampling(false), timing(true), my_gap_tracker(NULL) {}
 
   /*
     The time spent between stop_tracking() call on this object and any
@@ -72,9 +88,22 @@ class Exec_time_tracker
   */
   Gap_time_tracker *my_gap_tracker;
 
+  void enable_sampling() { sampling= true; }
+
   // interface for collecting time
   void start_tracking(THD *thd)
   {
+    if (unlikely(sampling))
+    {
+      timing= count < SAMPLING_START || !(count % SAMPLING_INTERVAL);
+      if (!timing)
+      {
+        /* The gap after the previous timed call ends here */
+        close_gap_time_tracker(thd);
+        return;
+      }
+      timed_count++;
+    }
     last_start= my_timer_cycles();
     process_gap_time_tracker(thd, last_start);
   }
@@ -82,16 +111,30 @@ class Exec_time_tracker
   void stop_tracking(THD *thd)
   {
     count++;
-    cycles_stop_tracking(thd);
+    if (likely(timing))
+      cycles_stop_tracking(thd);
   }
 
   // interface for getting the time
   ulonglong get_loops() const { return count; }
+
+  /*
+    The factor by which the time of the timed calls (and of the gaps
+    that follow them) is multiplied to estimate the time of all calls.
+  */
+  double get_sampling_factor() const
+  {
+    return timed_count && timed_count < count
+      ? static_cast<double>(count) / static_cast<double>(timed_count)
+      : 1.0;
+  }
+
   double get_time_ms() const
   {
     // convert 'cycles' to milliseconds.
     return 1000.0 * static_cast<double>(cycles) /
-      static_cast<double>(sys_timer_info.cycles.frequency);
+      static_cast<double>(sys_timer_info.cycles.frequency) *
+      get_sampling_factor();
   }
 };
 
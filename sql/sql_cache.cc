@@ -2782,6 +2782,8 @@ void Query_cache::make_disabled()
   first_block= 0;
   total_blocks= 0;
   tables_blocks= 0;
+  for (uint i= 0; i < QUERY_CACHE_TABLE_FILTER_SIZE; i++)
+    table_filter[i].store(0);
   DBUG_VOID_RETURN;
 }
 
@@ -3302,6 +3304,15 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 {
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
+  /*
+    No cached query uses a table that is not in table_filter, so there is
+    nothing to invalidate. Tables are registered before the query reads
+    them, and we are called after the change, so a query that registers
+    the table after this check sees the changed data.
+  */
+  if (!table_filter[table_filter_slot(key, key_length)].load())
+    return;
+
   /*
     Lock the query cache and queue all invalidation attempts to avoid
     the risk of a race between invalidation, cache inserts and flushes.
@@ -3317,6 +3328,17 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 }
 
 
+/**
+  Slot of table_filter for the given table key
+*/
+
+uint Query_cache::table_filter_slot(const uchar *key, size_t key_length)
+{
+  return (my_hash_sort(&my_charset_bin, key, key_length) &
+          (QUERY_CACHE_TABLE_FILTER_SIZE - 1));
+}
+
+
 /**
   Try to locate and invalidate a table by name.
   The caller must ensure that no other thread is trying to work with
@@ -3567,13 +3589,18 @@ Query_cache::insert_table(THD *thd, size_t key_len, const char *key,
     */
     list_root->next= list_root->prev= list_root;
 
-    if (hash &&
-        my_hash_insert(&tables, (const uchar *) table_block))
+    if (hash)
     {
-      DBUG_PRINT("qcache", ("Can't insert table to hash"));
-      // write_block_data return locked block
-      free_memory_block(table_block);
-      DBUG_RETURN(0);
+      /* Set before the table can be found, see invalidate_table() */
+      table_filter[table_filter_slot((const uchar*) key, key_len)]++;
+      if (my_hash_insert(&tables, (const uchar *) table_block))
+      {
+        DBUG_PRINT("qcache", ("Can't insert table to hash"));
+        table_filter[table_filter_slot((const uchar*) key, key_len)]--;
+        // write_block_data return locked block
+        free_memory_block(table_block);
+        DBUG_RETURN(0);
+      }
     }
     char *db= header->db();
     header->table(db + db_length + 1);
@@ -3638,7 +3665,13 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
                                &tables_blocks);
     Query_cache_table *header= table_block->table();
     if (header->is_hashed())
+    {
+      size_t key_length;
+      uchar *key= query_cache_table_get_key((uchar *) table_block,
+                                            &key_length, 0);
       my_hash_delete(&tables,(uchar *) table_block);
+      table_filter[table_filter_slot(key, key_length)]--;
+    }
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
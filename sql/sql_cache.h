@@ -18,6 +18,7 @@
 
 #include "hash.h"
 #include "my_base.h"                            /* ha_rows */
+#include <atomic>
 
 class MY_LOCALE;
 struct TABLE_LIST;
@@ -66,6 +67,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_PACK_ITERATION		2
 #define QUERY_CACHE_PACK_LIMIT			(512*1024L)
 
+/* number of slots of the table filter (power of 2) */
+#define QUERY_CACHE_TABLE_FILTER_SIZE		4096
+
 #define TABLE_COUNTER_TYPE uint
 
 struct Query_cache_block;
@@ -320,6 +324,7 @@ class Query_cache
 
   void free_query_internal(Query_cache_block *point);
   void invalidate_table_internal(THD *thd, uchar *key, size_t key_length);
+  static uint table_filter_slot(const uchar *key, size_t key_length);
 
 protected:
   /*
@@ -346,6 +351,13 @@ class Query_cache
   Query_cache_memory_bin *bins;			// free block lists
   Query_cache_memory_bin_step *steps;		// bins spacing info
   HASH queries, tables;
+  /*
+    Number of hashed table blocks per slot of the table key hash. Changed
+    only under structure_guard_mutex, but read without it, so that the
+    invalidation of a table that has no cached queries does not have to
+    lock the cache.
+  */
+  std::atomic<uint32> table_filter[QUERY_CACHE_TABLE_FILTER_SIZE];
   /* options */
   size_t min_allocation_unit, min_result_data_size;
   uint def_query_hash_size, def_table_hash_size;
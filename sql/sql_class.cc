@@ -682,6 +682,8 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
    m_stmt_da(&main_da),
    tdc_hash_pins(0),
    xid_hash_pins(0),
+   table_stats_hash_pins(0),
+   index_stats_hash_pins(0),
    m_tmp_tables_locked(false)
 #ifdef HAVE_REPLICATION
    ,
@@ -1744,6 +1746,10 @@ THD::~THD()
     lf_hash_put_pins(tdc_hash_pins);
   if (xid_hash_pins)
     lf_hash_put_pins(xid_hash_pins);
+  if (table_stats_hash_pins)
+    lf_hash_put_pins(table_stats_hash_pins);
+  if (index_stats_hash_pins)
+    lf_hash_put_pins(index_stats_hash_pins);
   debug_sync_end_thread(this);
   /* Ensure everything is freed */
   status_var.local_memory_used-= sizeof(THD);
@@ -3021,10 +3027,12 @@ int select_send::send_data(List<Item> &items)
   Protocol *protocol= thd->protocol;
   DBUG_ENTER("select_send::send_data");
 
+  protocol->start_net_row();
   protocol->prepare_for_resend();
   if (protocol->send_result_set_row(&items))
   {
     protocol->remove_last_row();
+    protocol->end_net_row();
     DBUG_RETURN(TRUE);
   }
 
@@ -3034,6 +3042,7 @@ int select_send::send_data(List<Item> &items)
   if (likely(thd->vio_ok()))
     DBUG_RETURN(protocol->write());
 
+  protocol->end_net_row();
   DBUG_RETURN(0);
 }
 
@@ -4248,6 +4257,7 @@ void TMP_TABLE_PARAM::init()
   quick_group= 1;
   table_charset= 0;
   precomputed_group_by= 0;
+  prev_group_valid= 0;
   bit_fields_as_long= 0;
   materialized_subquery= 0;
   force_not_null_cols= 0;
@@ -676,6 +676,7 @@ typedef struct system_variables
   ulong max_length_for_sort_data;
   ulong max_recursive_iterations;
   ulong max_sort_length;
+  ulong sort_parallel_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -687,6 +688,7 @@ typedef struct system_variables
   ulong net_write_timeout;
   ulong optimizer_prune_level;
   ulong optimizer_search_depth;
+  my_bool optimizer_cache_join_order;
   ulong optimizer_selectivity_sampling_limit;
   ulong optimizer_use_condition_selectivity;
   ulong use_stat_tables;
@@ -2649,6 +2651,9 @@ class THD: public THD_count, /* this must be first */
                         const uchar *buf);
   int binlog_update_row(TABLE* table, bool is_transactional,
                         const uchar *old_data, const uchar *new_data);
+  void binlog_add_writeset(TABLE *table, bool is_transactional,
+                           const uchar *before_record,
+                           const uchar *after_record);
   bool prepare_handlers_for_update(uint flag);
   bool binlog_write_annotated_row(Log_event_writer *writer);
   void binlog_prepare_for_row_logging();
@@ -4932,6 +4937,9 @@ class THD: public THD_count, /* this must be first */
 
   LF_PINS *tdc_hash_pins;
   LF_PINS *xid_hash_pins;
+  /* Pins for global_table_stats and global_index_stats */
+  LF_PINS *table_stats_hash_pins;
+  LF_PINS *index_stats_hash_pins;
   bool fix_xid_hash_pins();
 
   const XID *get_xid() const
@@ -5891,6 +5899,11 @@ class TMP_TABLE_PARAM :public Sql_alloc
   List<Item> copy_funcs;
   Copy_field *copy_field, *copy_field_end;
   uchar	    *group_buff;
+  /*
+    Key of the group that end_update() updated last, valid only while
+    prev_group_valid is set. The handler is still positioned on that row.
+  */
+  uchar	    *prev_group_buff;
   Item	    **items_to_copy;			/* Fields in tmp table */
   TMP_ENGINE_COLUMNDEF *recinfo, *start_recinfo;
   KEY *keyinfo;
@@ -5944,6 +5957,7 @@ class TMP_TABLE_PARAM :public Sql_alloc
     aggregate functions as normal functions.
   */
   bool precomputed_group_by;
+  bool prev_group_valid;
   bool force_copy_fields;
   /*
     If TRUE, create_tmp_field called from create_tmp_table will convert
@@ -5962,7 +5976,7 @@ class TMP_TABLE_PARAM :public Sql_alloc
      group_length(0), group_null_parts(0),
      using_outer_summary_function(0),
      schema_table(0), materialized_subquery(0), force_not_null_cols(0),
-     precomputed_group_by(0),
+     precomputed_group_by(0), prev_group_valid(0),
      force_copy_fields(0), bit_fields_as_long(0), skip_create_table(0)
   {}
   ~TMP_TABLE_PARAM()
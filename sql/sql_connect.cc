@@ -45,12 +45,14 @@
 #include "proxy_protocol.h"
 #include <ssl_compat.h>
 
-HASH global_user_stats, global_client_stats, global_table_stats;
-HASH global_index_stats;
+HASH global_user_stats, global_client_stats;
 /* Protects the above global stats */
 extern mysql_mutex_t LOCK_global_user_client_stats;
-extern mysql_mutex_t LOCK_global_table_stats;
-extern mysql_mutex_t LOCK_global_index_stats;
+/*
+  Updated at the end of every statement that touched a table, so these
+  are lock-free; the counters in the elements are updated atomically.
+*/
+LF_HASH global_table_stats, global_index_stats;
 extern vio_keepalive_opts opt_vio_keepalive;
 
 /*
@@ -502,16 +504,11 @@ extern "C" uchar *get_key_table_stats(TABLE_STATS *table_stats, size_t *length,
   return (uchar*) table_stats->table;
 }
 
-extern "C" void free_table_stats(TABLE_STATS* table_stats)
-{
-  my_free(table_stats);
-}
-
 void init_global_table_stats(void)
 {
-  my_hash_init(PSI_INSTRUMENT_ME, &global_table_stats, system_charset_info,
-               max_connections, 0, 0, (my_hash_get_key) get_key_table_stats,
-               (my_hash_free_key) free_table_stats, 0);
+  lf_hash_init(&global_table_stats, sizeof(TABLE_STATS), LF_HASH_UNIQUE,
+               0, 0, (my_hash_get_key) get_key_table_stats,
+               system_charset_info);
 }
 
 extern "C" uchar *get_key_index_stats(INDEX_STATS *index_stats, size_t *length,
@@ -521,19 +518,13 @@ extern "C" uchar *get_key_index_stats(INDEX_STATS *index_stats, size_t *length,
   return (uchar*) index_stats->index;
 }
 
-extern "C" void free_index_stats(INDEX_STATS* index_stats)
-{
-  my_free(index_stats);
-}
-
 void init_global_index_stats(void)
 {
-  my_hash_init(PSI_INSTRUMENT_ME, &global_index_stats, system_charset_info,
-               max_connections, 0, 0, (my_hash_get_key) get_key_index_stats,
-               (my_hash_free_key) free_index_stats, 0);
+  lf_hash_init(&global_index_stats, sizeof(INDEX_STATS), LF_HASH_UNIQUE,
+               0, 0, (my_hash_get_key) get_key_index_stats,
+               system_charset_info);
 }
 
-
 void free_global_user_stats(void)
 {
   my_hash_free(&global_user_stats);
@@ -541,12 +532,12 @@ void free_global_user_stats(void)
 
 void free_global_table_stats(void)
 {
-  my_hash_free(&global_table_stats);
+  lf_hash_destroy(&global_table_stats);
 }
 
 void free_global_index_stats(void)
 {
-  my_hash_free(&global_index_stats);
+  lf_hash_destroy(&global_index_stats);
 }
 
 void free_global_client_stats(void)
@@ -554,6 +545,71 @@ void free_global_client_stats(void)
   my_hash_free(&global_client_stats);
 }
 
+
+struct delete_global_stats_arg
+{
+  LF_HASH *hash;
+  const uchar *prefix;
+  size_t prefix_length;
+  MEM_ROOT mem_root;
+  Dynamic_array<LEX_CSTRING> keys;
+
+  delete_global_stats_arg(LF_HASH *hash_arg, const uchar *prefix_arg,
+                          size_t prefix_length_arg)
+    : hash(hash_arg), prefix(prefix_arg), prefix_length(prefix_length_arg),
+      keys(PSI_INSTRUMENT_MEM)
+  {
+    init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 1024, 0, MYF(0));
+  }
+  ~delete_global_stats_arg() { free_root(&mem_root, MYF(0)); }
+};
+
+
+static my_bool collect_global_stats_key(void *element, void *arg)
+{
+  delete_global_stats_arg *del= (delete_global_stats_arg*) arg;
+  size_t length;
+  const uchar *key= del->hash->get_key((uchar*) element, &length, 0);
+  LEX_CSTRING copy;
+
+  if (length < del->prefix_length ||
+      memcmp(key, del->prefix, del->prefix_length))
+    return 0;
+  copy.str= (const char*) memdup_root(&del->mem_root, key, length);
+  copy.length= length;
+  return !copy.str || del->keys.append(copy);
+}
+
+
+/**
+  Delete the elements of global_table_stats or global_index_stats whose
+  key starts with the given prefix, or all elements if prefix_length is 0.
+
+  An LF_HASH cannot be modified while it is being iterated, so the keys
+  are collected first. Elements that are inserted concurrently may
+  survive; this is no different from an update that arrives right after
+  the deletion.
+
+  @return 0 ok, 1 out of memory
+*/
+
+int delete_global_stats(LF_HASH *hash, const uchar *prefix,
+                        size_t prefix_length)
+{
+  delete_global_stats_arg del(hash, prefix, prefix_length);
+  LF_PINS *pins;
+  int res;
+
+  if (!(pins= lf_hash_get_pins(hash)))
+    return 1;
+  res= lf_hash_iterate(hash, pins, collect_global_stats_key, &del);
+  for (size_t i= 0; i < del.keys.elements(); i++)
+    lf_hash_delete(hash, pins, del.keys.at(i).str,
+                   (uint) del.keys.at(i).length);
+  lf_hash_put_pins(pins);
+  return res;
+}
+
 /*
   Increments the global stats connection count for an entry from
   global_client_stats or global_user_stats. Returns 0 on success
@@ -1228,7 +1284,19 @@ void prepare_new_connection_state(THD* thd)
   Security_context *sctx= thd->security_ctx;
 
   if (thd->client_capabilities & CLIENT_COMPRESS)
-    thd->net.compress=1;				// Use compression
+  {
+    if (!(thd->client_capabilities & MARIADB_CLIENT_ZSTD_COMPRESSION))
+      thd->net.compress=1;				// Use compression
+    else if (net_enable_zstd_compression(&thd->net,
+                                         opt_protocol_zstd_compression_level))
+    {
+      /* The client expects zstd, so it can not talk to us any more */
+      thd->net.error= 2;
+      thd->set_killed(KILL_CONNECTION);
+      thd->print_aborted_warning(0, "out of memory for zstd compression");
+      return;
+    }
+  }
 
   /*
     Much of this is duplicated in create_embedded_thd() for the
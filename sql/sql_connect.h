@@ -21,6 +21,7 @@
 #include "structs.h"
 #include <mysql/psi/mysql_socket.h>
 #include <hash.h>
+#include <lf.h>
 #include "violite.h"
 
 /*
@@ -69,6 +70,8 @@ void free_global_user_stats(void);
 void free_global_table_stats(void);
 void free_global_index_stats(void);
 void free_global_client_stats(void);
+int delete_global_stats(LF_HASH *hash, const uchar *prefix,
+                        size_t prefix_length);
 
 pthread_handler_t handle_one_connection(void *arg);
 void do_handle_one_connection(CONNECT *connect, bool put_in_cache);
@@ -100,12 +103,10 @@ int check_for_max_user_connections(THD *thd, USER_CONN *uc);
 
 extern HASH global_user_stats;
 extern HASH global_client_stats;
-extern HASH global_table_stats;
-extern HASH global_index_stats;
+extern LF_HASH global_table_stats;
+extern LF_HASH global_index_stats;
 
 extern mysql_mutex_t LOCK_global_user_client_stats;
-extern mysql_mutex_t LOCK_global_table_stats;
-extern mysql_mutex_t LOCK_global_index_stats;
 extern mysql_mutex_t LOCK_stats;
 
 #endif /* SQL_CONNECT_INCLUDED */
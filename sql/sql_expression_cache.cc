@@ -138,6 +138,16 @@ void Expression_cache_tmptable::init()
     goto error;
   }
 
+  /* The parameters form the key, and HEAP cannot index BLOB columns */
+  for (Field **field= cache_table->field + 1; *field; field++)
+  {
+    if ((*field)->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("BLOB parameter"));
+      goto error;
+    }
+  }
+
   field_counter= 1;
 
   if (cache_table->alloc_keys(1) ||
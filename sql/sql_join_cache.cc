@@ -32,6 +32,9 @@
 #include "sql_base.h"
 #include "sql_select.h"
 #include "opt_subselect.h"
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+#include "partition_info.h"
+#endif
 
 #define NO_MORE_RECORDS_IN_BUFFER  (uint)(-1)
 
@@ -2704,7 +2707,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   ref_key_info= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
   ref_used_key_parts= join_tab->ref.key_parts;
 
-  hash_func= &JOIN_CACHE_HASHED::get_hash_idx_simple;
+  hash_func= &JOIN_CACHE_HASHED::get_hash_simple;
   hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_simple;
 
   KEY_PART_INFO *key_part= ref_key_info->key_part;
@@ -2713,7 +2716,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   {
     if (!key_part->field->eq_cmp_as_binary())
     {
-      hash_func= &JOIN_CACHE_HASHED::get_hash_idx_complex;
+      hash_func= &JOIN_CACHE_HASHED::get_hash_complex;
       hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_complex;
       break;
     }
@@ -2765,6 +2768,7 @@ int JOIN_CACHE_HASHED::init_hash_table()
   {    
     key_entry_length= get_size_of_rec_offset() + // key chain header
                       size_of_key_ofs +          // reference to the next key 
+                      1 +                        // tag of the key
                       (use_emb_key ?  get_size_of_rec_offset() : key_length);
 
     size_t space_per_rec= avg_record_length +
@@ -2854,6 +2858,7 @@ uint JOIN_CACHE_HASHED::get_max_key_addon_space_per_record()
   len= (use_emb_key ?  get_size_of_rec_offset() : ref->key_length) +
         size_of_rec_ofs +    // size of the key chain header
         size_of_rec_ofs +    // >= size of the reference to the next key 
+        1 +                  // tag of the key
         2*size_of_rec_ofs;   // >= 2*( size of hash table entry)
   return len; 
 }    
@@ -2974,6 +2979,7 @@ bool JOIN_CACHE_HASHED::put_record()
     store_null_key_ref(cp);
     store_next_rec_ref(next_ref_ptr, next_ref_ptr);
     store_next_rec_ref(cp+get_size_of_key_offset(), next_ref_ptr);
+    *--cp= key_search_tag;
     if (use_emb_key)
     {
       cp-= get_size_of_rec_offset();
@@ -3093,6 +3099,8 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
     to the next key from  to the hash element for the given key. 
     Otherwise the function returns the position where the reference to the
     newly created hash element for the given key is to be added.  
+    Only the key entries whose tag matches the tag of the key are compared
+    with the key. The tag is saved in key_search_tag.
 
   RETURN VALUE
     TRUE    the key is found in the hash table
@@ -3103,14 +3111,18 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
                                    uchar **key_ref_ptr) 
 {
   bool is_found= FALSE;
-  uint idx= (this->*hash_func)(key, key_length);
+  ulonglong nr= (this->*hash_func)(key, key_length);
+  uint idx= (uint) (nr % hash_entries);
+  const uchar tag= key_search_tag= get_hash_tag(nr);
   uchar *ref_ptr= hash_table+size_of_key_ofs*idx;
   while (!is_null_key_ref(ref_ptr))
   {
     uchar *next_key;
     ref_ptr= get_next_key_ref(ref_ptr);
-    next_key= use_emb_key ? get_emb_key(ref_ptr-get_size_of_rec_offset()) :
-                            ref_ptr-key_length;
+    if (ref_ptr[-1] != tag)
+      continue;
+    next_key= use_emb_key ? get_emb_key(ref_ptr-1-get_size_of_rec_offset()) :
+                            ref_ptr-1-key_length;
 
     if ((this->*hash_cmp_func)(next_key, key, key_len))
     {
@@ -3127,32 +3139,41 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
   Hash function that considers a key in the hash table as byte array
 
   SYNOPSIS
-    get_hash_idx_simple()
+    get_hash_simple()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It considers the key just as
-    a sequence of bytes of the length key_len.
+    The function calculates the hash value of the given key that is used
+    to find the hash entry in the hash table of the join buffer and the tag
+    of the key entry. It considers the key just as a sequence of bytes of
+    the length key_len and processes it 8 bytes at a time.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+ulonglong JOIN_CACHE_HASHED::get_hash_simple(uchar* key, uint key_len)
 {
-  ulong nr= 1;
-  ulong nr2= 4;
+  const ulonglong mul= 0x9E3779B97F4A7C15ULL;
+  ulonglong nr= key_len;
   uchar *pos= key;
   uchar *end= key+key_len;
-  for (; pos < end ; pos++)
+  for (; pos + 8 <= end; pos+= 8)
   {
-    nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
-    nr2+= 3;
+    nr= (nr ^ uint8korr(pos)) * mul;
+    nr^= nr >> 32;
   }
-  return nr % hash_entries;
+  if (pos < end)
+  {
+    ulonglong tail= 0;
+    for (; pos < end; pos++)
+      tail= (tail << 8) | *pos;
+    nr= (nr ^ tail) * mul;
+    nr^= nr >> 32;
+  }
+  return nr;
 }
 
 
@@ -3160,13 +3181,14 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
   Hash function that takes into account collations of the components of the key  
 
   SYNOPSIS
-    get_hash_idx_complex()
+    get_hash_complex()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It takes into account that the
+    The function calculates the hash value of the given key that is used
+    to find the hash entry in the hash table of the join buffer and the tag
+    of the key entry. It takes into account that the
     components of the key may be of a varchar type with different collations.
     The function guarantees that the same hash value for any two equal
     keys that may differ as byte sequences.
@@ -3176,14 +3198,13 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     operation.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
+ulonglong JOIN_CACHE_HASHED::get_hash_complex(uchar *key, uint key_len)
 {
-  return 
-    (uint) (key_hashnr(ref_key_info, ref_used_key_parts, key) % hash_entries);
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
 }
 
 
@@ -3335,6 +3356,67 @@ uint JOIN_CACHE_HASHED::get_next_key(uchar ** key)
 }
 
 
+void JOIN_CACHE::free()
+{
+  my_free(buff);
+  buff= 0;
+  if (join_tab_scan)
+    join_tab_scan->free_replay();
+}
+
+
+void JOIN_CACHE::expect_refill(bool more_records)
+{
+  if (join_tab_scan)
+    join_tab_scan->expect_refill(more_records);
+}
+
+
+void JOIN_CACHE::reset_replay()
+{
+  if (join_tab_scan)
+    join_tab_scan->reset_replay();
+}
+
+
+/* 
+  Check whether the records read by a scan can be replayed by later scans
+
+  SYNOPSIS
+    can_replay()
+
+  DESCRIPTION
+    The records saved in replay_file are images of the record buffer
+    of the joined table. They can replace a new scan of the table only
+    if the table has no blobs, whose data is not stored in the record
+    buffer, if no row ids of the table are needed and if the condition
+    pushed to the table returns the same result for every scan.
+
+  RETURN VALUE   
+    TRUE   the records can be replayed
+    FALSE  otherwise
+*/
+
+bool JOIN_TAB_SCAN::can_replay()
+{
+  TABLE *table= join_tab->table;
+  SQL_SELECT *select= join_tab->cache_select;
+
+  if (table->s->blob_fields || join_tab->keep_current_rowid ||
+      join_tab->use_quick == 2)
+    return FALSE;
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  /* A pruned scan does not read all records of the table */
+  if (part_src_fields)
+    return FALSE;
+#endif
+  if (select && select->cond &&
+      (select->cond->used_tables() & (RAND_TABLE_BIT | OUTER_REF_TABLE_BIT)))
+    return FALSE;
+  return TRUE;
+}
+
+
 /* 
   Initiate an iteration process over records in the joined table
 
@@ -3344,6 +3426,10 @@ uint JOIN_CACHE_HASHED::get_next_key(uchar ** key)
   DESCRIPTION
     The function initiates the process of iteration over records from the 
     joined table recurrently performed by the BNL/BKLH join algorithm.  
+    If the records of a complete earlier scan have been saved, they are
+    read from the temporary file instead. If the join buffer is going to be
+    refilled, the records of this scan are saved to be replayed by the
+    scans for the next refills.
 
   RETURN VALUE   
     0            the initiation is a success 
@@ -3355,10 +3441,61 @@ int JOIN_TAB_SCAN::open()
   save_or_restore_used_tabs(join_tab, FALSE);
   is_first_record= TRUE;
   join_tab->tracker->r_scans++;
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  if (!part_pruning_checked)
+  {
+    part_pruning_checked= TRUE;
+    if (init_partition_pruning())
+      return 1;
+  }
+  if (part_src_fields)
+    prune_partitions();
+#endif
+
+  if (replay_state == REPLAY_READY)
+  {
+    if (!reinit_io_cache(&replay_file, READ_CACHE, 0L, 0, 0))
+    {
+      replaying= TRUE;
+      return 0;
+    }
+    replay_state= REPLAY_NONE;
+  }
+  else if (refill_expected && can_replay())
+  {
+    if ((my_b_inited(&replay_file) ||
+         !open_cached_file(&replay_file, mysql_tmpdir, TEMP_PREFIX,
+                           DISK_BUFFER_SIZE, MYF(MY_WME))) &&
+        !reinit_io_cache(&replay_file, WRITE_CACHE, 0L, 0, 0))
+      replay_state= REPLAY_WRITING;
+  }
   return join_init_read_record(join_tab);
 }
 
 
+/* 
+  Read the next record saved for replaying the scan of the joined table
+
+  RETURN VALUE   
+    0            the next record has been read into the record buffer
+    -1           there are no more records
+    1            an error occurred
+*/
+
+int JOIN_TAB_SCAN::next_replayed()
+{
+  TABLE *table= join_tab->table;
+  if (my_b_read(&replay_file, table->record[0], table->s->reclength))
+    return replay_file.error ? 1 : -1;
+  table->status= 0;
+  table->null_row= 0;
+  join_tab->tracker->r_rows++;
+  join_tab->tracker->r_rows_after_where++;
+  return 0;
+}
+
+
 /* 
   Read the next record that can match while scanning the joined table
 
@@ -3388,6 +3525,9 @@ int JOIN_TAB_SCAN::next()
   SQL_SELECT *select= join_tab->cache_select;
   THD *thd= join->thd;
 
+  if (replaying)
+    return next_replayed();
+
   if (is_first_record)
     is_first_record= FALSE;
   else
@@ -3414,7 +3554,15 @@ int JOIN_TAB_SCAN::next()
   }
 
   if (!err)
+  {
     join_tab->tracker->r_rows_after_where++;
+    if (replay_state == REPLAY_WRITING &&
+        my_b_write(&replay_file, join_tab->table->record[0],
+                   join_tab->table->s->reclength))
+      replay_state= REPLAY_NONE;
+  }
+  else if (err < 0 && replay_state == REPLAY_WRITING)
+    replay_state= REPLAY_READY;
   return err; 
 }
 
@@ -3479,9 +3627,184 @@ static void save_or_restore_used_tabs(JOIN_TAB *join_tab, bool save)
 void JOIN_TAB_SCAN::close()
 {
   save_or_restore_used_tabs(join_tab, TRUE);
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  if (part_src_fields)
+    restore_partitions();
+#endif
+  /* An interrupted scan cannot be replayed */
+  if (replay_state == REPLAY_WRITING)
+    replay_state= REPLAY_NONE;
+  replaying= FALSE;
+  if (!refill_expected)
+    reset_replay();
+}
+
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+
+/*
+  Check whether the scans of the joined table can be limited to partitions
+
+  SYNOPSIS
+    init_partition_pruning()
+
+  DESCRIPTION
+    The function checks whether every field of the partitioning functions
+    of the joined table belongs to a multiple equality of the WHERE
+    condition that also contains a field of the same definition stored in
+    the join buffer. All records of the joined table that match a record
+    from the buffer have the values of these fields in the partitioning
+    fields, so the partitions that such records belong to can be found
+    before the scan. When two tables are partitioned in the same way on
+    the join key, the records of one partition of the first table are
+    joined with the records of the same partition of the second one.
+    The pruning is done only for full table scans of tables that are not
+    inner tables of outer joins.
+    If the pruning is possible, part_src_fields is set.
+
+  RETURN VALUE
+    TRUE   out of memory
+    FALSE  otherwise
+*/
+
+bool JOIN_TAB_SCAN::init_partition_pruning()
+{
+  TABLE *table= join_tab->table;
+  partition_info *part_info= table->part_info;
+  THD *thd= join->thd;
+  Field **part_field;
+  Field **src_fields;
+  uint n_fields= 0;
+
+  if (!part_info || !join->cond_equal || join_tab->first_inner ||
+      join_tab->use_quick == 2 ||
+      (join_tab->select && join_tab->select->quick))
+    return FALSE;
+
+  for (part_field= part_info->full_part_field_array; *part_field;
+       part_field++)
+    n_fields++;
+  if (!(src_fields= (Field **) thd->alloc(sizeof(Field *) * n_fields)))
+    return TRUE;
+
+  for (uint i= 0; i < n_fields; i++)
+  {
+    Field *field= part_info->full_part_field_array[i];
+    bool inherited;
+    Item_equal *item_equal= find_item_equal(join->cond_equal, field,
+                                            &inherited);
+    src_fields[i]= 0;
+    /* With a constant the partitions have been pruned at optimization */
+    if (!item_equal || item_equal->get_const())
+      return FALSE;
+    for (JOIN_CACHE *c= cache; c && !src_fields[i]; c= c->prev_cache)
+    {
+      CACHE_FIELD *copy= c->field_descr + c->flag_fields;
+      CACHE_FIELD *copy_end= c->field_descr + c->fields;
+      for ( ; copy < copy_end; copy++)
+      {
+        Field *src= copy->field;
+        if (src && src->table != table && field->eq_def(src) &&
+            item_equal->contains(src))
+        {
+          src_fields[i]= src;
+          break;
+        }
+      }
+    }
+    if (!src_fields[i])
+      return FALSE;
+  }
+
+  uint n_parts= part_info->read_partitions.n_bits;
+  my_bitmap_map *bitmap_buf=
+    (my_bitmap_map *) thd->alloc(bitmap_buffer_size(n_parts));
+  if (!bitmap_buf)
+    return TRUE;
+  my_bitmap_init(&all_read_partitions, bitmap_buf, n_parts, FALSE);
+  part_src_fields= src_fields;
+  return FALSE;
+}
+
+
+/*
+  Limit the coming scan of the joined table to the partitions with matches
+
+  SYNOPSIS
+    prune_partitions()
+
+  DESCRIPTION
+    The function reads the records from the join buffer, copies the values
+    of the fields part_src_fields into the partitioning fields of the joined
+    table and marks the partitions found by the partitioning functions for
+    these values in part_info->read_partitions. The partitions that were
+    pruned at optimization are never read. The original set of partitions
+    is saved to be restored by restore_partitions().
+*/
+
+void JOIN_TAB_SCAN::prune_partitions()
+{
+  TABLE *table= join_tab->table;
+  partition_info *part_info= table->part_info;
+  MY_BITMAP *read_partitions= &part_info->read_partitions;
+  Field **part_fields= part_info->full_part_field_array;
+
+  bitmap_copy(&all_read_partitions, read_partitions);
+  bitmap_clear_all(read_partitions);
+
+  my_bitmap_map *old_map= dbug_tmp_use_all_columns(table, table->write_set);
+  cache->reset(FALSE);
+  for (size_t cnt= cache->records; cnt; cnt--)
+  {
+    uint32 part_id;
+    longlong func_value;
+    uint i;
+    if (cache->get_record())
+      break;
+    for (i= 0; part_fields[i]; i++)
+    {
+      Field *src= part_src_fields[i];
+      /* A NULL value cannot be equal to anything */
+      if (src->is_null())
+        break;
+      part_fields[i]->set_notnull();
+      part_fields[i]->store_field(src);
+    }
+    if (part_fields[i] ||
+        part_info->get_partition_id(part_info, &part_id, &func_value))
+      continue;
+    if (bitmap_is_set(&all_read_partitions, part_id))
+    {
+      bitmap_set_bit(read_partitions, part_id);
+      if (bitmap_cmp(read_partitions, &all_read_partitions))
+        break;
+    }
+  }
+  cache->reset(FALSE);
+  dbug_tmp_restore_column_map(table->write_set, old_map);
 }
 
 
+/*
+  Restore the set of partitions to read after a pruned scan
+
+  DESCRIPTION
+    The scan is ended before the original set of partitions is restored,
+    because ha_partition ends the scans of the partitions that are set in
+    part_info->read_partitions. The next scan is initialized again by
+    join_init_read_record().
+*/
+
+void JOIN_TAB_SCAN::restore_partitions()
+{
+  TABLE *table= join_tab->table;
+  table->file->ha_index_or_rnd_end();
+  bitmap_copy(&table->part_info->read_partitions, &all_read_partitions);
+}
+
+#endif /* WITH_PARTITION_STORAGE_ENGINE */
+
+
 /*
   Prepare to iterate over the BNL join cache buffer to look for matches 
 
@@ -540,6 +540,7 @@ class JOIN_CACHE :public Sql_alloc
     join_tab= tab;
     prev_cache= next_cache= 0;
     buff= 0;
+    join_tab_scan= 0;
   }
 
   /* 
@@ -555,6 +556,7 @@ class JOIN_CACHE :public Sql_alloc
     next_cache= 0;
     prev_cache= prev;
     buff= 0;
+    join_tab_scan= 0;
     if (prev)
       prev->next_cache= this;
   }
@@ -668,11 +670,16 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
-  { 
-    my_free(buff);
-    buff= 0;
-  }   
+  void free();
+
+  /*
+    Inform the join cache whether the join buffer is going to be refilled
+    after the records in it have been joined
+  */
+  void expect_refill(bool more_records);
+
+  /* Forget the records of the joined table saved from an earlier execution */
+  void reset_replay();
   
   friend class JOIN_CACHE_HASHED;
   friend class JOIN_CACHE_BNL;
@@ -705,6 +712,7 @@ class JOIN_CACHE :public Sql_alloc
         uchar[] value;
         cache_ref *value_ref; // offset from the beginning of the buffer
       } hash_table_key;
+      uchar tag;        // 8 bits of the hash value of the key
       key_ref next_key; // offset backward from the beginning of hash table
       cache_ref *last_rec // offset from the beginning of the buffer
     }
@@ -712,6 +720,8 @@ class JOIN_CACHE :public Sql_alloc
   beginning of the record info stored in the join buffer. The records are 
   linked in a circular list. A new record is always added to the end of this 
   list.
+  The tag of a key entry allows key_search() to skip most entries with
+  a different key in the chain of a hash entry without comparing the keys.
 
   The following picture represents a typical layout for the info stored in the
   join buffer of a join cache object of the JOIN_CACHE_HASHED class.
@@ -763,7 +773,8 @@ class JOIN_CACHE :public Sql_alloc
 class JOIN_CACHE_HASHED: public JOIN_CACHE
 {
 
-  typedef uint (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
+  typedef ulonglong (JOIN_CACHE_HASHED::*Hash_func) (uchar *key,
+                                                     uint key_len);
   typedef bool (JOIN_CACHE_HASHED::*Hash_cmp_func) (uchar *key1, uchar *key2,
                                                     uint key_len);
   
@@ -791,8 +802,14 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
-  inline uint get_hash_idx_simple(uchar *key, uint key_len);
-  inline uint get_hash_idx_complex(uchar *key, uint key_len);
+  inline ulonglong get_hash_simple(uchar *key, uint key_len);
+  inline ulonglong get_hash_complex(uchar *key, uint key_len);
+
+  /* Get the tag stored in a key entry for a key with the hash value nr */
+  static uchar get_hash_tag(ulonglong nr)
+  {
+    return (uchar) ((nr * 0x9E3779B97F4A7C15ULL) >> 56);
+  }
 
   inline bool equal_keys_simple(uchar *key1, uchar *key2, uint key_len);
   inline bool equal_keys_complex(uchar *key1, uchar *key2, uint key_len);
@@ -838,6 +855,9 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* The position of the last key entry in the hash table */
   uchar *last_key_entry;
 
+  /* The tag of the key passed to the last call of key_search() */
+  uchar key_search_tag;
+
   /* 
     The offset of the record fields from the beginning of the record
     representation. The record representation starts with a reference to
@@ -1042,6 +1062,43 @@ class JOIN_TAB_SCAN: public Sql_alloc
   /* TRUE if this is the first record from the joined table to iterate over */
   bool is_first_record;
 
+  /*
+    When the join buffer has to be refilled, the joined table is scanned
+    once for every refill. To avoid repeating the table scan and the check
+    of the pushed condition, the records that pass the condition are written
+    into replay_file during the first scan and read back from it by the
+    following scans.
+  */
+  enum { REPLAY_NONE, REPLAY_WRITING, REPLAY_READY } replay_state;
+  /* TRUE if the current scan reads the records from replay_file */
+  bool replaying;
+  /* TRUE if more refills of the join buffer are expected */
+  bool refill_expected;
+  IO_CACHE replay_file;
+
+  bool can_replay();
+  int next_replayed();
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  /*
+    When the joined table is partitioned and every field of its partitioning
+    functions is equal to a field stored in the join buffer, each scan reads
+    only the partitions that can contain matches for the records currently
+    in the buffer. part_src_fields[i] is the field of the buffer that is
+    equal to part_info->full_part_field_array[i], or part_src_fields is 0
+    if the scans cannot be pruned.
+  */
+  Field **part_src_fields;
+  /* TRUE once it has been checked whether the scans can be pruned */
+  bool part_pruning_checked;
+  /* The partitions left to read by the pruning at optimization */
+  MY_BITMAP all_read_partitions;
+
+  bool init_partition_pruning();
+  void prune_partitions();
+  void restore_partitions();
+#endif
+
 protected:
 
   /* The joined table to be iterated over */
@@ -1061,6 +1118,14 @@ class JOIN_TAB_SCAN: public Sql_alloc
     join= j;
     join_tab= tab;
     cache= join_tab->cache;
+    replay_state= REPLAY_NONE;
+    replaying= FALSE;
+    refill_expected= FALSE;
+    my_b_clear(&replay_file);
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+    part_src_fields= 0;
+    part_pruning_checked= FALSE;
+#endif
   }
 
   virtual ~JOIN_TAB_SCAN() {}
@@ -1084,6 +1149,30 @@ class JOIN_TAB_SCAN: public Sql_alloc
   */ 
   virtual void close();
 
+  /*
+    Inform the scan whether the join buffer is going to be refilled after
+    the coming scan. Once no more refills are expected, the records saved
+    for replaying are discarded after the next scan.
+  */
+  void expect_refill(bool more_records)
+  {
+    refill_expected= more_records;
+  }
+
+  /* Discard the records saved for replaying the scan */
+  void reset_replay()
+  {
+    replay_state= REPLAY_NONE;
+    replaying= FALSE;
+  }
+
+  /* Release the resources used for replaying the scan */
+  void free_replay()
+  {
+    reset_replay();
+    close_cached_file(&replay_file);
+  }
+
 };
 
 /*
@@ -1621,6 +1621,11 @@ bool Lex_input_stream::get_text(Lex_string_with_metadata_st *dst, uint sep,
   uint found_escape=0;
   CHARSET_INFO *cs= m_thd->charset();
   bool is_8bit= false;
+#ifdef USE_MB
+  /* In ASCII based character sets, an ASCII byte is a whole character */
+  const bool use_mb= cs->use_mb();
+  const bool ascii_based= my_charset_is_ascii_based(cs);
+#endif
 
   while (! eof())
   {
@@ -1630,7 +1635,7 @@ bool Lex_input_stream::get_text(Lex_string_with_metadata_st *dst, uint sep,
 #ifdef USE_MB
     {
       int l;
-      if (cs->use_mb() &&
+      if (use_mb && ((c & 0x80) || !ascii_based) &&
           (l = my_ismbchar(cs,
                            get_ptr() -1,
                            get_end_of_query()))) {
@@ -2676,9 +2681,13 @@ int Lex_input_stream::scan_ident_start(THD *thd, Lex_ident_cli_st *str)
 
   if (cs->use_mb())
   {
+    const bool ascii_based= my_charset_is_ascii_based(cs);
     is_8bit= true;
     while (ident_map[c= yyGet()])
     {
+      /* In ASCII based character sets, an ASCII byte is a whole character */
+      if (!(c & 0x80) && ascii_based)
+        continue;
       int char_length= cs->charlen(get_ptr() - 1, get_end_of_query());
       if (char_length <= 0)
         break;
@@ -2728,8 +2737,11 @@ int Lex_input_stream::scan_ident_middle(THD *thd, Lex_ident_cli_st *str,
     }
     skip_binary(char_length - 1);
 
+    const bool ascii_based= my_charset_is_ascii_based(cs);
     while (ident_map[c= yyGet()])
     {
+      if (!(c & 0x80) && ascii_based)
+        continue;
       char_length= cs->charlen(get_ptr() - 1, get_end_of_query());
       if (char_length <= 0)
         break;
@@ -2984,6 +2996,7 @@ void st_select_lex::init_query()
   in_tvc= false;
   versioned_tables= 0;
   pushdown_select= 0;
+  join_order_cache= 0;
 }
 
 void st_select_lex::init_select()
@@ -842,6 +842,7 @@ typedef class st_select_lex_node SELECT_LEX_NODE;
 class THD;
 class select_result;
 class JOIN;
+struct Join_order_cache;
 class select_unit;
 class Procedure;
 class Explain_query;
@@ -1144,6 +1145,8 @@ class st_select_lex: public st_select_lex_node
   List<TABLE_LIST> *join_list;    /* list for the currently parsed join  */
   TABLE_LIST *embedding;          /* table embedding to the above list   */
   List<TABLE_LIST> sj_nests;      /* Semi-join nests within this join */
+  /* Join order of an earlier execution, allocated on the statement arena */
+  Join_order_cache *join_order_cache;
   /*
     Beginning of the list of leaves in a FROM clause, where the leaves
     inlcude all base tables including view tables. The tables are connected
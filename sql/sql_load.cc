@@ -146,6 +146,13 @@ class READ_INFO: public Load_data_param
   int	*stack,*stack_pos;
   bool	found_end_of_line,start_of_line,eof;
   int level; /* for load xml */
+  /*
+    Bytes that can start a terminator or an escape sequence inside an
+    unenclosed field. m_bulk_scan is set if no other byte of the file
+    can end such a field, see read_plain_bytes().
+  */
+  bool m_special_byte[256];
+  bool m_bulk_scan;
 
   bool getbyte(char *to)
   {
@@ -219,6 +226,31 @@ class READ_INFO: public Load_data_param
     return false; // Good multi-byte character
   }
 
+  /**
+    Append to "data" the bytes of an unenclosed field that are already
+    in the read buffer, up to the first byte that may start a terminator
+    or an escape sequence.
+
+    This is what the byte-by-byte loop of read_field() does with these
+    bytes, without the per-byte overhead. It is only used when nothing
+    was pushed back and no byte of a multi-byte character can be taken
+    for a special byte, so the result is the same.
+  */
+  void read_plain_bytes()
+  {
+    const uchar *pos= cache.read_pos;
+    const uchar *end= cache.read_end;
+    /* Leave room for the longest character, as read_field() expects */
+    size_t room= data.alloced_length() - data.length() - charset()->mbmaxlen;
+    if ((size_t) (end - pos) > room)
+      end= pos + room;
+    const uchar *run= pos;
+    while (run < end && !m_special_byte[*run])
+      run++;
+    data.q_append((const char*) pos, (size_t) (run - pos));
+    cache.read_pos= (uchar*) run;
+  }
+
 public:
   bool error,line_cuted,found_null,enclosed;
   uchar	*row_start,			/* Found row starts here */
@@ -1360,6 +1392,27 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
     m_line_term.reset();
   enclosed_char= enclosed_par.length() ? (uchar) enclosed_par[0] : INT_MAX;
 
+  bzero(m_special_byte, sizeof(m_special_byte));
+  if (escape_char != INT_MAX)
+    m_special_byte[(uchar) escape_char]= true;
+  if (m_field_term.initial_byte() != INT_MAX)
+    m_special_byte[(uchar) m_field_term.initial_byte()]= true;
+  if (m_line_term.initial_byte() != INT_MAX)
+    m_special_byte[(uchar) m_line_term.initial_byte()]= true;
+  /*
+    In a multi-byte character set, only UTF-8 guarantees that the bytes
+    of a multi-byte character never look like an ASCII special byte.
+  */
+  m_bulk_scan= !charset()->use_mb();
+  if (!m_bulk_scan && charset()->mbminlen == 1 &&
+      (charset()->state & (MY_CS_UNICODE | MY_CS_NONASCII)) == MY_CS_UNICODE)
+  {
+    m_bulk_scan= true;
+    for (uint i= 0x80; i < 256; i++)
+      if (m_special_byte[i])
+        m_bulk_scan= false;
+  }
+
   /* Set of a stack for unget if long terminators */
   uint length= MY_MAX(charset()->mbmaxlen, MY_MAX(m_field_term.length(),
                                                   m_line_term.length())) + 1;
@@ -1511,6 +1564,8 @@ int READ_INFO::read_field()
     // Make sure we have enough space for the longest multi-byte character.
     while (data.length() + charset()->mbmaxlen <= data.alloced_length())
     {
+      if (m_bulk_scan && found_enclosed_char == INT_MAX && stack_pos == stack)
+        read_plain_bytes();
       chr = GET;
       if (chr == my_b_EOF)
 	goto found_eof;
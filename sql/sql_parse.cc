@@ -2353,7 +2353,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
     Unlink it now, before freeing the root.
   */
   thd->lex->m_sql_cmd= NULL;
-  free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
+  free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC | MY_RECYCLE_BLOCKS));
 
 #if defined(ENABLED_PROFILING)
   thd->profiling.finish_current_query();
@@ -2370,6 +2370,16 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   }
   DEBUG_SYNC(thd,"dispatch_command_end");
 
+#ifndef EMBEDDED_LIBRARY
+  /*
+    Send the replies that were held back while the client was pipelining
+    commands, unless the next command has already arrived.
+  */
+  if (net->vio && net->write_pos != net->buff &&
+      (command == COM_QUIT || !net_has_pending_input(net)))
+    (void) net_flush(net);
+#endif
+
   /* Check that some variables are reset properly */
   DBUG_ASSERT(thd->abort_on_warning == 0);
   thd->lex->restore_set_statement_var();
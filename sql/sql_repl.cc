@@ -152,6 +152,12 @@ struct binlog_send_info {
   /** last pos for error message */
   my_off_t last_pos;
 
+  /**
+    end of the events of the active binlog whose checksums were verified
+    by a dump thread, 0 if the file is not the active one
+  */
+  my_off_t verified_pos;
+
 #ifndef DBUG_OFF
   int left_events;
   uint dbug_reconnect_counter;
@@ -172,7 +178,7 @@ struct binlog_send_info {
       slave_gtid_ignore_duplicates(false),
       error(0),
       errmsg("Unknown error"),
-      heartbeat_period(0),
+      heartbeat_period(0), verified_pos(0),
 #ifndef DBUG_OFF
       left_events(max_binlog_dump_events),
       dbug_reconnect_counter(0),
@@ -2578,6 +2584,7 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
   mysql_bin_log.lock_binlog_end_pos();
   char binlog_end_pos_filename[FN_REFLEN];
   my_off_t end_pos= mysql_bin_log.get_binlog_end_pos(binlog_end_pos_filename);
+  info->verified_pos= mysql_bin_log.get_binlog_verified_pos();
   mysql_bin_log.unlock_binlog_end_pos();
 
   do
@@ -2589,6 +2596,7 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
        * it safe to check file length and use that as end_pos
        */
       end_pos= my_b_filelength(log);
+      info->verified_pos= 0;
 
       if (log_pos == end_pos)
         return 0;        // already at end of file inactive file
@@ -2654,6 +2662,15 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
   linfo->pos= my_b_tell(log);
   info->last_pos= my_b_tell(log);
 
+  /*
+    With master_verify_checksum, every dump thread would checksum the same
+    events of the active binlog. Events before info->verified_pos were
+    verified by another dump thread already; if this one continues from
+    there, it publishes how far it got.
+  */
+  bool publish_verified= opt_master_verify_checksum && info->verified_pos &&
+                         linfo->pos <= info->verified_pos;
+
   log->end_of_file= end_pos;
   while (linfo->pos < end_pos)
   {
@@ -2667,8 +2684,9 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
 
     info->last_pos= linfo->pos;
     error= Log_event::read_log_event(log, packet, info->fdev,
-                       opt_master_verify_checksum ? info->current_checksum_alg
-                                                  : BINLOG_CHECKSUM_ALG_OFF);
+                       opt_master_verify_checksum &&
+                       linfo->pos >= info->verified_pos ?
+                       info->current_checksum_alg : BINLOG_CHECKSUM_ALG_OFF);
     linfo->pos= my_b_tell(log);
 
     if (unlikely(error))
@@ -2760,6 +2778,9 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
                     });
   }
 
+  if (publish_verified && linfo->pos > info->verified_pos)
+    mysql_bin_log.update_binlog_verified_pos(linfo->log_file_name, linfo->pos);
+
   return 0;
 }
 
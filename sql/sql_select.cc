@@ -4081,6 +4081,8 @@ JOIN::reinit()
         continue;
       tmp_table->file->extra(HA_EXTRA_RESET_STATE);
       tmp_table->file->ha_delete_all_rows();
+      if (curr_tab->tmp_table_param)
+        curr_tab->tmp_table_param->prev_group_valid= 0;
     }
   }
   clear_sj_tmp_tables(this);
@@ -4098,6 +4100,8 @@ JOIN::reinit()
          tab= next_linear_tab(this, tab, WITH_BUSH_ROOTS))
     {
       tab->ref.key_err= TRUE;
+      if (tab->cache)
+        tab->cache->reset_replay();
     }
   }
 
@@ -8256,6 +8260,128 @@ static void choose_initial_table_order(JOIN *join)
     TRUE        Fatal error
 */
 
+static bool join_order_cache_usable(JOIN *join)
+{
+  THD *thd= join->thd;
+  return (thd->variables.optimizer_cache_join_order &&
+          thd->stmt_arena->is_stmt_execute() &&
+          !join->emb_sjm_nest && !join->select_lex->sj_nests.elements &&
+          join->table_count - join->const_tables > 1);
+}
+
+
+/**
+  Remember the join order found by greedy_search() in the SELECT_LEX,
+  so that the next execution of the statement can reuse it.
+
+  @note The order is allocated on the statement arena. It is overwritten
+  in place when the statement is optimized again.
+*/
+
+static void save_join_order(JOIN *join)
+{
+  SELECT_LEX *select_lex= join->select_lex;
+  Join_order_cache *cache= select_lex->join_order_cache;
+  uint size= join->table_count - join->const_tables;
+
+  if (!cache || cache->capacity < size)
+  {
+    MEM_ROOT *mem_root= join->thd->stmt_arena->mem_root;
+    if (!(cache= (Join_order_cache*) alloc_root(mem_root, sizeof(*cache))) ||
+        !(cache->tables= (TABLE_LIST**) alloc_root(mem_root,
+                                                   sizeof(TABLE_LIST*) *
+                                                   size)) ||
+        !(cache->records= (ha_rows*) alloc_root(mem_root,
+                                                sizeof(ha_rows) * size)))
+      return;
+    cache->capacity= size;
+    select_lex->join_order_cache= cache;
+  }
+
+  cache->size= size;
+  cache->const_tables= join->const_table_map;
+  for (uint i= 0; i < size; i++)
+  {
+    JOIN_TAB *tab= join->best_positions[join->const_tables + i].table;
+    cache->tables[i]= tab->table->pos_in_table_list;
+    cache->records[i]= tab->found_records;
+  }
+}
+
+
+/*
+  The cheapest partial plans that join the same set of tables, remembered
+  with optimizer_prune_level=2 during one call of
+  best_extension_by_limited_search() from greedy_search().
+*/
+
+struct Best_prefix_cost
+{
+  /* The tables that are not in the partial plan */
+  table_map remaining_tables;
+  /* [1] is for partial plans that start with join->sort_by_table */
+  double record_count[2];
+  double read_time[2];
+};
+
+/* Upper bound for the number of remembered partial plans */
+static const ulong max_best_prefix_costs= 65536;
+
+
+/**
+  Put join->best_ref into the join order that save_join_order() stored
+  at an earlier execution, if it is still likely to be a good one.
+
+  It is if the same tables are constant and the estimated number of rows
+  of every table is within a factor of 2 of the estimate the order was
+  chosen for. The estimates come from the range optimizer and the table
+  statistics, so they reflect both the parameter values and the changes
+  of the data.
+
+  @retval TRUE   join->best_ref is in the stored order
+  @retval FALSE  The order must be searched for
+*/
+
+static bool restore_join_order(JOIN *join)
+{
+  Join_order_cache *cache= join->select_lex->join_order_cache;
+  uint size= join->table_count - join->const_tables;
+  JOIN_TAB **best_ref= join->best_ref + join->const_tables;
+  JOIN_TAB *order[MAX_TABLES];
+  table_map prefix= join->const_table_map;
+
+  if (!cache || cache->size != size ||
+      cache->const_tables != join->const_table_map)
+    return FALSE;
+
+  for (uint i= 0; i < size; i++)
+  {
+    JOIN_TAB *tab= NULL;
+    for (uint j= 0; j < size; j++)
+    {
+      if (best_ref[j]->table->pos_in_table_list == cache->tables[i])
+      {
+        tab= best_ref[j];
+        break;
+      }
+    }
+    if (!tab || (tab->dependent & ~prefix))
+      return FALSE;
+
+    ha_rows rows= MY_MAX(tab->found_records, 1);
+    ha_rows cached_rows= MY_MAX(cache->records[i], 1);
+    if (rows / 2 > cached_rows || cached_rows / 2 > rows)
+      return FALSE;
+
+    order[i]= tab;
+    prefix|= tab->table->map;
+  }
+
+  memcpy(best_ref, order, sizeof(JOIN_TAB*) * size);
+  return TRUE;
+}
+
+
 bool
 choose_plan(JOIN *join, table_map join_tables)
 {
@@ -8314,15 +8440,41 @@ choose_plan(JOIN *join, table_map join_tables)
   {
     optimize_straight_join(join, join_tables);
   }
+  else if (join_order_cache_usable(join) && restore_join_order(join))
+  {
+    /* The order was found at an earlier execution of the statement */
+    optimize_straight_join(join, join_tables);
+  }
   else
   {
     DBUG_ASSERT(search_depth <= MAX_TABLES + 1);
     if (search_depth == 0)
       /* Automatically determine a reasonable value for 'search_depth' */
       search_depth= determine_search_depth(join);
-    if (greedy_search(join, join_tables, search_depth, prune_level,
-                      use_cond_selectivity))
+    /*
+      Pruning partial plans by the set of joined tables assumes that the
+      extensions of a partial plan do not depend on the order of its tables,
+      which is not the case with outer joins and semi-joins.
+    */
+    HASH best_prefix_costs;
+    join->best_prefix_costs= NULL;
+    if (prune_level == 2 && !join->emb_sjm_nest && !join->outer_join &&
+        join->select_lex->sj_nests.is_empty() &&
+        !my_hash_init(PSI_INSTRUMENT_ME, &best_prefix_costs, &my_charset_bin,
+                      64, offsetof(Best_prefix_cost, remaining_tables),
+                      sizeof(table_map), 0, my_free, 0))
+      join->best_prefix_costs= &best_prefix_costs;
+    bool error= greedy_search(join, join_tables, search_depth, prune_level,
+                              use_cond_selectivity);
+    if (join->best_prefix_costs)
+    {
+      my_hash_free(&best_prefix_costs);
+      join->best_prefix_costs= NULL;
+    }
+    if (error)
       DBUG_RETURN(TRUE);
+    if (join_order_cache_usable(join))
+      save_join_order(join);
   }
 
   /* 
@@ -8755,6 +8907,8 @@ greedy_search(JOIN      *join,
   do {
     /* Find the extension of the current QEP with the lowest cost */
     join->best_read= DBL_MAX;
+    if (join->best_prefix_costs)
+      my_hash_reset(join->best_prefix_costs);
     if (best_extension_by_limited_search(join, remaining_tables, idx, record_count,
                                          read_time, search_depth, prune_level,
                                          use_cond_selectivity))
@@ -9365,6 +9519,61 @@ double table_cond_selectivity(JOIN *join, uint idx, JOIN_TAB *s,
 }
 
 
+/**
+  Check if the partial plan in join->positions can be pruned because
+  a partial plan that joins the same tables with no more rows and at no
+  higher cost has already been expanded.
+
+  Such a plan has the same extensions as the current one, and each of
+  them is at least as cheap, so the current plan can be skipped.
+
+  @param join              the join being optimized
+  @param remaining_tables  the tables that are not in the partial plan
+  @param record_count      rows produced by the partial plan
+  @param read_time         cost of the partial plan
+
+  @retval true   the partial plan can be pruned
+  @retval false  the partial plan must be expanded
+*/
+
+static bool prune_by_same_tables(JOIN *join, table_map remaining_tables,
+                                 double record_count, double read_time)
+{
+  HASH *hash= join->best_prefix_costs;
+  const uint sorted= join->sort_by_table &&
+    join->positions[join->const_tables].table->table == join->sort_by_table;
+  Best_prefix_cost *cost=
+    (Best_prefix_cost*) my_hash_search(hash, (uchar*) &remaining_tables,
+                                       sizeof(remaining_tables));
+  if (!cost)
+  {
+    if (hash->records >= max_best_prefix_costs ||
+        !(cost= (Best_prefix_cost*) my_malloc(PSI_INSTRUMENT_ME,
+                                              sizeof(*cost), MYF(0))))
+      return false;
+    cost->remaining_tables= remaining_tables;
+    cost->record_count[0]= cost->record_count[1]= DBL_MAX;
+    cost->read_time[0]= cost->read_time[1]= DBL_MAX;
+    if (my_hash_insert(hash, (uchar*) cost))
+    {
+      my_free(cost);
+      return false;
+    }
+  }
+
+  if (cost->record_count[sorted] <= record_count &&
+      cost->read_time[sorted] <= read_time)
+    return true;
+  if (cost->record_count[sorted] >= record_count &&
+      cost->read_time[sorted] >= read_time)
+  {
+    cost->record_count[sorted]= record_count;
+    cost->read_time[sorted]= read_time;
+  }
+  return false;
+}
+
+
 /**
   Find a good, possibly optimal, query execution plan (QEP) by a possibly
   exhaustive search.
@@ -9474,7 +9683,8 @@ double table_cond_selectivity(JOIN *join, uint idx, JOIN_TAB *s,
                           (0 < search_depth <= join->tables+1).
   @param prune_level      pruning heuristics that should be applied during
                           optimization
-                          (values: 0 = EXHAUSTIVE, 1 = PRUNE_BY_TIME_OR_ROWS)
+                          (values: 0 = EXHAUSTIVE, 1 = PRUNE_BY_TIME_OR_ROWS,
+                          2 = PRUNE_BY_TIME_OR_ROWS and PRUNE_BY_SAME_TABLES)
   @param use_cond_selectivity  specifies how the selectivity of the conditions
                           pushed to a table should be taken into account
 
@@ -9591,7 +9801,7 @@ best_extension_by_limited_search(JOIN      *join,
         Prune some less promising partial plans. This heuristic may miss
         the optimal QEPs, thus it results in a non-exhaustive search.
       */
-      if (prune_level == 1)
+      if (prune_level >= 1)
       {
         if (best_record_count > current_record_count ||
             best_read_time > current_read_time ||
@@ -9636,6 +9846,21 @@ best_extension_by_limited_search(JOIN      *join,
                                         pushdown_cond_selectivity;
       if ( (search_depth > 1) && (remaining_tables & ~real_table_bit) & allowed_tables )
       { /* Recursively expand the current partial plan */
+        if (join->best_prefix_costs &&
+            prune_by_same_tables(join, remaining_tables & ~real_table_bit,
+                                 partial_join_cardinality,
+                                 current_read_time))
+        {
+          DBUG_EXECUTE("opt", print_plan(join, idx+1,
+                                         current_record_count,
+                                         read_time,
+                                         current_read_time,
+                                         "pruned_by_same_tables"););
+          trace_one_table.add("pruned_by_same_tables", true);
+          restore_prev_nj_state(s);
+          restore_prev_sj_state(remaining_tables, s, idx);
+          continue;
+        }
         swap_variables(JOIN_TAB*, join->best_ref[idx], *pos);
         Json_writer_array trace_rest(thd, "rest_of_plan");
         if (best_extension_by_limited_search(join,
@@ -13594,10 +13819,19 @@ bool JOIN_TAB::preread_init()
     return FALSE;
   }
 
+  /*
+    A table materialized with splitting needs not be refilled while the
+    join key of the preceding tables stays the same
+  */
+  uint8 uncacheable= derived->get_unit()->uncacheable;
+  if (uncacheable == UNCACHEABLE_DEPENDENT_INJECTED &&
+      !table->split_injected_values_changed())
+    uncacheable= 0;
+
   /* Materialize derived table/view. */
   if ((!derived->get_unit()->executed  ||
        derived->is_recursive_with_table() ||
-       derived->get_unit()->uncacheable) &&
+       uncacheable) &&
       mysql_handle_single_derived(join->thd->lex, derived, DT_CREATE | DT_FILL))
       return TRUE;
 
@@ -18340,7 +18574,7 @@ TABLE *Create_tmp_table::start(THD *thd,
                         sizeof(*param->recinfo)*(field_count*2+4),
                         &tmpname, (uint) strlen(path)+1,
                         &m_group_buff, (m_group && ! m_using_unique_constraint ?
-                                      param->group_length : 0),
+                                      param->group_length * 2 : 0),
                         &m_bitmaps, bitmap_buffer_size(field_count)*6,
                         &const_key_parts, sizeof(*const_key_parts),
                         NullS))
@@ -18636,9 +18870,23 @@ bool Create_tmp_table::finalize(THD *thd,
   DBUG_ASSERT(m_alloced_field_count >= share->fields);
   DBUG_ASSERT(m_alloced_field_count >= share->blob_fields);
 
+  /*
+    HEAP can store BLOB columns of internal temporary tables, but it
+    cannot index them.
+  */
+  bool blob_in_key= m_distinct && m_blobs_count[distinct];
+  if (share->blob_fields)
+  {
+    for (ORDER *tmp= m_group; tmp && !blob_in_key; tmp= tmp->next)
+    {
+      Field *field= (*tmp->item)->get_tmp_table_field();
+      blob_in_key= field && (field->flags & BLOB_FLAG);
+    }
+  }
+
   /* If result table is small; use a heap */
   /* future: storage engine selection can be made dynamic? */
-  if (share->blob_fields || m_using_unique_constraint
+  if (blob_in_key || m_using_unique_constraint
       || (thd->variables.big_tables && !(m_select_options & SELECT_SMALL_RESULT))
       || (m_select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_memory_table_size == 0)
@@ -18844,6 +19092,9 @@ bool Create_tmp_table::finalize(THD *thd,
     DBUG_PRINT("info",("Creating group key in temporary table"));
     table->group= m_group;				/* Table is grouped by key */
     param->group_buff= m_group_buff;
+    param->prev_group_buff= (m_using_unique_constraint ? 0 :
+                             m_group_buff + param->group_length);
+    param->prev_group_valid= 0;
     share->keys=1;
     share->uniques= MY_TEST(m_using_unique_constraint);
     table->key_info= table->s->key_info= keyinfo;
@@ -20369,6 +20620,7 @@ sub_select_cache(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
 
   if (end_of_records)
   {
+    cache->expect_refill(FALSE);
     rc= cache->join_records(FALSE);
     if (rc == NESTED_LOOP_OK || rc == NESTED_LOOP_NO_MORE_ROWS ||
         rc == NESTED_LOOP_QUERY_LIMIT)
@@ -20389,6 +20641,7 @@ sub_select_cache(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
       won't add any more records. Now try to find all the matching 
       extensions for all records in the buffer.
     */ 
+    cache->expect_refill(TRUE);
     rc= cache->join_records(FALSE);
     DBUG_RETURN(rc);
   }
@@ -22081,6 +22334,12 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 
   @detail
     Also applies HAVING, etc.
+
+    Rows of the same group often come one after another, for example
+    when the rows are read in the order of an index on a prefix of the
+    GROUP BY columns. If the key of a row is the key of the group that
+    was updated last, the handler is still positioned on that group and
+    record[1] holds it, so the group is updated without a key lookup.
 */
 
 static enum_nested_loop_state
@@ -22088,12 +22347,16 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 	   bool end_of_records)
 {
   TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
   ORDER   *group;
   int	  error;
   DBUG_ENTER("end_update");
 
   if (end_of_records)
+  {
+    param->prev_group_valid= 0;
     DBUG_RETURN(NESTED_LOOP_OK);
+  }
 
   join->found_records++;
   copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
@@ -22115,8 +22378,11 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (item->maybe_null)
       group->buff[-1]= (char) group->field->is_null();
   }
-  if (!table->file->ha_index_read_map(table->record[1],
-                                      join_tab->tmp_table_param->group_buff,
+  if ((param->prev_group_valid &&
+       !memcmp(param->group_buff, param->prev_group_buff,
+               param->group_length)) ||
+      !table->file->ha_index_read_map(table->record[1],
+                                      param->group_buff,
                                       HA_WHOLE_KEY,
                                       HA_READ_KEY_EXACT))
   {						/* Update old record */
@@ -22128,9 +22394,19 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       table->file->print_error(error,MYF(0));	/* purecov: inspected */
       DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
     }
+    /*
+      BLOB values in record[0] may point to storage that the update
+      released, so the row is not kept for the next group.
+    */
+    if ((param->prev_group_valid= !table->s->blob_fields))
+    {
+      store_record(table,record[1]);
+      memcpy(param->prev_group_buff, param->group_buff, param->group_length);
+    }
     goto end;
   }
 
+  param->prev_group_valid= 0;
   init_tmptable_sum_functions(join->sum_funcs);
   if (unlikely(copy_funcs(join_tab->tmp_table_param->items_to_copy,
                           join->thd)))
@@ -22958,7 +23234,7 @@ uint find_shortest_key(TABLE *table, const key_map *usable_keys)
     {
       if (usable_keys->is_set(nr))
       {
-        double cost= table->file->keyread_time(nr, 1, table->file->records());
+        double cost= table->file->keyread_time(nr, 1, table->file->stats.records);
         if (cost < min_cost)
         {
           min_cost= cost;
@@ -23981,8 +24257,9 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  /* The hash keys would only contain a prefix of BLOB columns. */
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
@@ -26415,6 +26692,7 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
   if (thd->lex->analyze_stmt)
   {
     table->file->set_time_tracker(&eta->op_tracker);
+    eta->op_tracker.enable_sampling();
     eta->op_tracker.my_gap_tracker = &eta->extra_time_tracker;
   }
   /* No need to save id and select_type here, they are kept in Explain_select */
@@ -1010,6 +1010,27 @@ typedef struct st_rollup
 } ROLLUP;
 
 
+/**
+  Join order that was chosen at an earlier execution of a prepared
+  statement, see SELECT_LEX::join_order_cache and
+  @@optimizer_cache_join_order.
+*/
+
+struct Join_order_cache
+{
+  /** Number of entries of tables and records that can be stored */
+  uint capacity;
+  /** Number of non-constant tables, 0 if no order is stored */
+  uint size;
+  /** Constant tables of the join */
+  table_map const_tables;
+  /** Non-constant tables, in join order */
+  TABLE_LIST **tables;
+  /** JOIN_TAB::found_records of the tables */
+  ha_rows *records;
+};
+
+
 class JOIN_TAB_RANGE: public Sql_alloc
 {
 public:
@@ -1265,6 +1286,12 @@ class JOIN :public Sql_alloc
     NULL    - otherwise
   */
   TABLE_LIST *emb_sjm_nest;
+
+  /*
+    Costs of the partial plans explored by greedy_search(), by the set of
+    joined tables (optimizer_prune_level=2), or NULL.
+  */
+  HASH *best_prefix_costs;
   
   /* Current join optimization state */
   POSITION *positions;
@@ -1605,6 +1632,7 @@ class JOIN :public Sql_alloc
     in_to_exists_where= NULL;
     in_to_exists_having= NULL;
     emb_sjm_nest= NULL;
+    best_prefix_costs= NULL;
     sjm_lookup_tables= 0;
     sjm_scan_tables= 0;
     is_orig_degenerated= false;
@@ -691,6 +691,13 @@ int sequence_definition::write(TABLE *table, bool all_fields)
     values up to this one can be used.
     If next_free_value >= reserved_until we have to reserve new
     values from the sequence.
+
+    As long as the value is inside the reserved range only next_free_value
+    changes. reserved_until and real_increment can only change under the
+    write lock, so in that case we only take a read lock and advance
+    next_free_value with compare-and-swap. This way concurrent NEXT VALUE
+    calls on the same sequence do not serialize until the cache has to be
+    refilled.
 */
 
 longlong SEQUENCE::next_value(TABLE *table, bool second_round, int *error)
@@ -701,7 +708,26 @@ longlong SEQUENCE::next_value(TABLE *table, bool second_round, int *error)
 
   *error= 0;
   if (!second_round)
+  {
+    mysql_rwlock_rdlock(&mutex);
+    res_value= my_atomic_load64_explicit((int64*) &next_free_value,
+                                         MY_MEMORY_ORDER_RELAXED);
+    while ((real_increment > 0 && res_value < reserved_until) ||
+           (real_increment < 0 && res_value > reserved_until))
+    {
+      if (my_atomic_cas64_weak_explicit((int64*) &next_free_value,
+                                        (int64*) &res_value,
+                                        increment_value(res_value),
+                                        MY_MEMORY_ORDER_RELAXED,
+                                        MY_MEMORY_ORDER_RELAXED))
+      {
+        mysql_rwlock_unlock(&mutex);
+        DBUG_RETURN(res_value);
+      }
+    }
+    mysql_rwlock_unlock(&mutex);
     write_lock(table);
+  }
 
   res_value= next_free_value;
   next_free_value= increment_value(next_free_value);
@@ -29,6 +29,10 @@ struct TABLE;
 
 #define MERGEBUFF		7
 #define MERGEBUFF2		15
+/* Minimum number of keys for each thread of a parallel in-memory sort */
+#define MIN_KEYS_PER_SORT_THREAD 16384
+/* Minimum number of keys for sorting a buffer with a radix sort */
+#define MIN_KEYS_FOR_RADIX_SORT 1000
 
 /*
    The structure SORT_ADDON_FIELD describes a fixed layout
@@ -563,6 +567,7 @@ class Sort_param {
 
   uchar *unique_buff;
   bool not_killable;
+  uint parallel_threads;      // Max threads for sorting a buffer in memory
   String tmp_buffer;
   // The fields below are used only by Unique class.
   qsort2_cmp compare;
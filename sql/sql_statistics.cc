@@ -32,6 +32,7 @@
 #include "uniques.h"
 #include "sql_show.h"
 #include "sql_partition.h"
+#include "json_lib.h"
 
 /*
   The system variable 'use_stat_tables' can take one of the
@@ -178,12 +179,12 @@ TABLE_FIELD_TYPE column_stat_fields[COLUMN_STAT_N_FIELDS] =
   },
   {
     { STRING_WITH_LEN("hist_type") },
-    { STRING_WITH_LEN("enum('SINGLE_PREC_HB','DOUBLE_PREC_HB')") },
+    { STRING_WITH_LEN("enum('SINGLE_PREC_HB','DOUBLE_PREC_HB','JSON_HB')") },
     { STRING_WITH_LEN("utf8") }
   },
   {
     { STRING_WITH_LEN("histogram") },
-    { STRING_WITH_LEN("varbinary(255)") },
+    { STRING_WITH_LEN("blob") },
     { NULL, 0 }
   }
 };
@@ -1078,11 +1079,18 @@ class Column_stat: public Stat_table
                             1);
           break;
         case COLUMN_STAT_HISTOGRAM:
-          const char * col_histogram=
-          (const char *) (table_field->collected_stats->histogram.get_values());
-	  stat_field->store(col_histogram,
-                            table_field->collected_stats->histogram.get_size(),
-                            &my_charset_bin);
+          Histogram *hist= &table_field->collected_stats->histogram;
+          if (hist->get_type() == JSON_HB)
+          {
+            val.length(0);
+            if (hist->serialize_json(&val))
+              stat_field->set_null();
+            else
+              stat_field->store(val.ptr(), val.length(), &my_charset_bin);
+            break;
+          }
+          const char * col_histogram= (const char *) (hist->get_values());
+	  stat_field->store(col_histogram, hist->get_size(), &my_charset_bin);
           break;           
         }
       }
@@ -1197,10 +1205,17 @@ class Column_stat: public Stat_table
       String val(buff, sizeof(buff), &my_charset_bin);
       uint fldno= COLUMN_STAT_HISTOGRAM;
       Field *stat_field= stat_table->field[fldno];
+      Histogram *hist= &table_field->read_stats->histogram;
       table_field->read_stats->set_not_null(fldno);
       stat_field->val_str(&val);
-      memcpy(table_field->read_stats->histogram.get_values(),
-             val.ptr(), table_field->read_stats->histogram.get_size());
+      if (hist->get_type() == JSON_HB)
+      {
+        /* A malformed histogram is left empty, and thus is not used. */
+        if (hist->parse_json(val.ptr(), val.length()))
+          bzero(hist->get_values(), hist->get_alloc_size());
+      }
+      else
+        memcpy(hist->get_values(), val.ptr(), hist->get_size());
     }
   }
 
@@ -1586,6 +1601,140 @@ class Histogram_builder
 };
 
 
+/*
+  Histogram_json_builder is a helper class that is used to build JSON_HB
+  histograms for columns.
+
+  Each value that occurs in more than records/hist_width rows, that is,
+  more often than an equi-height bucket could represent, becomes a most
+  common value. The remaining values are first gathered into
+  'chunks_per_bucket' times more chunks than the histogram has buckets,
+  because the number of rows that are not covered by the MCV is only known
+  at the end. finish() merges the chunks into buckets of nearly equal
+  numbers of rows.
+*/
+
+class Histogram_json_builder
+{
+  struct Chunk
+  {
+    double end_pos;        /* position of the last value in the chunk      */
+    ha_rows rows;          /* number of rows in the chunk                  */
+    ha_rows ndv;           /* number of distinct values in the chunk       */
+  };
+  static const uint chunks_per_bucket= 4;
+
+  Field *column;           /* table field for which the histogram is built */
+  uint col_length;         /* size of this field                           */
+  ha_rows records;         /* number of records the histogram is built for */
+  Field *min_value;        /* pointer to the minimal value for the field   */
+  Field *max_value;        /* pointer to the maximal value for the field   */
+  Histogram *histogram;    /* the histogram location                       */
+  uint hist_width;         /* the maximum number of MCV and of buckets     */
+  double mcv_threshold;    /* a value in more rows than this is a MCV      */
+  double chunk_capacity;   /* number of rows in a chunk                    */
+  Chunk *chunks;           /* the chunks, NULL if out of memory            */
+  uint max_chunks;         /* size of chunks[]                             */
+  uint curr_chunk;         /* number of the current chunk                  */
+  uint n_mcv;              /* number of MCV                                */
+  ulonglong count_distinct;    /* number of distinct values retrieved      */
+  /* number of distinct values that occured only once  */
+  ulonglong count_distinct_single_occurence;
+
+public:
+  Histogram_json_builder(Field *col, uint col_len, ha_rows rows)
+    : column(col), col_length(col_len), records(rows)
+  {
+    Column_statistics *col_stats= col->collected_stats;
+    min_value= col_stats->min_value;
+    max_value= col_stats->max_value;
+    histogram= &col_stats->histogram;
+    hist_width= histogram->get_width();
+    mcv_threshold= (double) records / hist_width;
+    max_chunks= hist_width * chunks_per_bucket;
+    chunk_capacity= (double) records / max_chunks;
+    chunks= (Chunk *) my_malloc(PSI_INSTRUMENT_ME,
+                                sizeof(Chunk) * (max_chunks + 1),
+                                MYF(MY_THREAD_SPECIFIC));
+    curr_chunk= 0;
+    if (chunks)
+      bzero(&chunks[0], sizeof(Chunk));
+    n_mcv= 0;
+    count_distinct= 0;
+    count_distinct_single_occurence= 0;
+    bzero(histogram->get_values(), histogram->get_alloc_size());
+  }
+
+  ~Histogram_json_builder() { my_free(chunks); }
+
+  ulonglong get_count_distinct() const { return count_distinct; }
+  ulonglong get_count_single_occurence() const
+  {
+    return count_distinct_single_occurence;
+  }
+
+  int next(void *elem, element_count elem_cnt)
+  {
+    count_distinct++;
+    if (elem_cnt == 1)
+      count_distinct_single_occurence++;
+
+    column->store_field_value((uchar *) elem, col_length);
+    double pos= column->pos_in_interval(min_value, max_value);
+
+    if (elem_cnt > mcv_threshold && n_mcv < hist_width)
+    {
+      histogram->set_json_mcv(n_mcv++, pos, (double) elem_cnt / records);
+      return 0;
+    }
+    if (!chunks)
+      return 0;
+
+    Chunk *chunk= &chunks[curr_chunk];
+    if (chunk->rows &&
+        chunk->rows + elem_cnt > chunk_capacity && curr_chunk + 1 < max_chunks)
+    {
+      chunk= &chunks[++curr_chunk];
+      bzero(chunk, sizeof(Chunk));
+    }
+    chunk->end_pos= pos;
+    chunk->rows+= elem_cnt;
+    chunk->ndv++;
+    return 0;
+  }
+
+  /* Merge the chunks into the equi-height buckets of the histogram */
+  void finish()
+  {
+    if (!chunks || !chunks[0].rows)
+      return;
+
+    ha_rows total= 0;
+    for (uint i= 0; i <= curr_chunk; i++)
+      total+= chunks[i].rows;
+
+    double bucket_capacity= (double) total / hist_width;
+    uint curr_bucket= 0;
+    ha_rows bucket_rows= 0, bucket_ndv= 0, rows= 0;
+    for (uint i= 0; i <= curr_chunk; i++)
+    {
+      bucket_rows+= chunks[i].rows;
+      bucket_ndv+= chunks[i].ndv;
+      rows+= chunks[i].rows;
+      if (i == curr_chunk ||
+          (rows >= bucket_capacity * (curr_bucket + 1) &&
+           curr_bucket + 1 < hist_width))
+      {
+        histogram->set_json_bucket(curr_bucket++, chunks[i].end_pos,
+                                   (double) bucket_rows / records,
+                                   (double) bucket_ndv);
+        bucket_rows= bucket_ndv= 0;
+      }
+    }
+  }
+};
+
+
 C_MODE_START
 
 int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
@@ -1595,6 +1744,14 @@ int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
 }
 
 
+static int json_histogram_build_walk(void *elem, element_count elem_cnt,
+                                     void *arg)
+{
+  Histogram_json_builder *hist_builder= (Histogram_json_builder *) arg;
+  return hist_builder->next(elem, elem_cnt);
+}
+
+
 
 static int count_distinct_single_occurence_walk(void *elem,
                                                 element_count count, void *arg)
@@ -1699,6 +1856,16 @@ class Count_distinct_field: public Sql_alloc
   */
    void walk_tree_with_histogram(ha_rows rows)
   {
+    if (table_field->collected_stats->histogram.get_type() == JSON_HB)
+    {
+      Histogram_json_builder hist_builder(table_field, tree_key_length, rows);
+      tree->walk(table_field->table, json_histogram_build_walk,
+                 (void *) &hist_builder);
+      hist_builder.finish();
+      distincts= hist_builder.get_count_distinct();
+      distincts_single_occurence= hist_builder.get_count_single_occurence();
+      return;
+    }
     Histogram_builder hist_builder(table_field, tree_key_length, rows);
     tree->walk(table_field->table,  histogram_build_walk, (void *) &hist_builder);
     distincts= hist_builder.get_count_distinct();
@@ -2134,12 +2301,13 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
   }
   uint hist_size= thd->variables.histogram_size;
   Histogram_type hist_type= (Histogram_type) (thd->variables.histogram_type);
+  uint hist_alloc_size= Histogram::get_alloc_size(hist_type, hist_size);
   uchar *histogram= NULL;
   if (hist_size > 0)
   {
     if ((histogram= (uchar *) alloc_root(&table->mem_root,
-                                         hist_size * columns)))
-      bzero(histogram, hist_size * columns);
+                                         hist_alloc_size * columns)))
+      bzero(histogram, hist_alloc_size * columns);
 
   }
 
@@ -2165,7 +2333,7 @@ int alloc_statistics_for_table(THD* thd, TABLE *table)
       column_stats->histogram.set_size(hist_size);
       column_stats->histogram.set_type(hist_type);
       column_stats->histogram.set_values(histogram);
-      histogram+= hist_size;
+      histogram+= hist_alloc_size;
     }
   }
 
@@ -2645,7 +2813,7 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
 
   if (thd->variables.sample_percentage == 0)
   {
-    if (file->records() < MIN_THRESHOLD_FOR_SAMPLING)
+    if (file->stats.records < MIN_THRESHOLD_FOR_SAMPLING)
     {
       sample_fraction= 1;
     }
@@ -2653,7 +2821,7 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
     {
       sample_fraction= std::fmin(
                   (MIN_THRESHOLD_FOR_SAMPLING + 4096 *
-                   log(200 * file->records())) / file->records(), 1);
+                   log(200 * file->stats.records)) / file->stats.records, 1);
     }
   }
 
@@ -2932,7 +3100,7 @@ int read_statistics_for_table(THD *thd, TABLE *table, TABLE_LIST *stat_tables)
     table_field= *field_ptr;
     column_stat.set_key_fields(table_field);
     column_stat.get_stat_values();
-    total_hist_size+= table_field->read_stats->histogram.get_size();
+    total_hist_size+= table_field->read_stats->histogram.get_alloc_size();
   }
   table_share->stats_cb.total_hist_size= total_hist_size;
 
@@ -3087,12 +3255,13 @@ int read_histograms_for_table(THD *thd, TABLE *table, TABLE_LIST *stat_tables)
     for (Field **field_ptr= table->s->field; *field_ptr; field_ptr++)
     {
       Field *table_field= *field_ptr;
-      if (uint hist_size= table_field->read_stats->histogram.get_size())
+      Histogram *hist= &table_field->read_stats->histogram;
+      if (hist->get_size())
       {
         column_stat.set_key_fields(table_field);
-        table_field->read_stats->histogram.set_values(histogram);
+        hist->set_values(histogram);
         column_stat.get_histogram_value();
-        histogram+= hist_size;
+        histogram+= hist->get_alloc_size();
       }
     }
     stats_cb->end_histograms_load();
@@ -3880,6 +4049,9 @@ double get_column_range_cardinality(Field *field,
 
 double Histogram::point_selectivity(double pos, double avg_sel)
 {
+  if (type == JSON_HB)
+    return json_point_selectivity(pos, avg_sel);
+
   double sel;
   /* Find the bucket that contains the value 'pos'. */
   uint min= find_bucket(pos, TRUE);
@@ -3959,6 +4131,215 @@ double Histogram::point_selectivity(double pos, double avg_sel)
   return sel;
 }
 
+/*
+  Selectivity of the condition 'col=const' for a JSON_HB histogram.
+
+  A most common value has its own frequency. Any other value is assumed to
+  be one of the distinct values of the bucket it falls into.
+*/
+
+double Histogram::json_point_selectivity(double pos, double avg_sel)
+{
+  uint n_mcv= get_json_mcv_count();
+  uint n_buckets= get_json_bucket_count();
+  double *mcv= json_mcv();
+  double *buckets= json_buckets();
+
+  for (uint i= 0; i < n_mcv; i++, mcv+= json_mcv_fields)
+  {
+    if (fabs(mcv[0] - pos) <= 4 * DBL_EPSILON)
+      return mcv[1];
+  }
+
+  if (!n_buckets)
+    return avg_sel;
+
+  uint i= 0;
+  while (i + 1 < n_buckets && buckets[i * json_bucket_fields] < pos)
+    i++;
+  double *bucket= buckets + i * json_bucket_fields;
+  return bucket[2] > 0 ? bucket[1] / bucket[2] : avg_sel;
+}
+
+
+/*
+  Selectivity of the range [min_pos, max_pos] for a JSON_HB histogram.
+
+  The rows within a bucket are assumed to be uniformly distributed over the
+  interval (end_pos of the previous bucket, end_pos of the bucket].
+*/
+
+double Histogram::json_range_selectivity(double min_pos, double max_pos)
+{
+  uint n_mcv= get_json_mcv_count();
+  uint n_buckets= get_json_bucket_count();
+  double *mcv= json_mcv();
+  double *bucket= json_buckets();
+  double sel= 0;
+
+  for (uint i= 0; i < n_mcv; i++, mcv+= json_mcv_fields)
+  {
+    if (mcv[0] >= min_pos && mcv[0] <= max_pos)
+      sel+= mcv[1];
+  }
+
+  double start= 0;
+  for (uint i= 0; i < n_buckets; i++, bucket+= json_bucket_fields)
+  {
+    double end= bucket[0];
+    if (end <= start)
+    {
+      /* All values of the bucket are equal to end */
+      if (end >= min_pos && end <= max_pos)
+        sel+= bucket[1];
+    }
+    else
+    {
+      double overlap= MY_MIN(end, max_pos) - MY_MAX(start, min_pos);
+      if (overlap > 0)
+        sel+= bucket[1] * overlap / (end - start);
+      else if (overlap == 0 && end == min_pos)
+        sel+= bucket[1] / MY_MAX(bucket[2], 1.0);
+    }
+    start= end;
+  }
+  return MY_MIN(sel, 1.0);
+}
+
+
+static bool json_append_double(String *str, double nr)
+{
+  char buf[FLOATING_POINT_BUFFER];
+  size_t len= my_gcvt(nr, MY_GCVT_ARG_DOUBLE, MY_GCVT_MAX_FIELD_WIDTH,
+                      buf, NULL);
+  return str->append(buf, len);
+}
+
+
+/*
+  Write the JSON_HB histogram into str as
+  {"mcv": [[pos, frac], ...], "buckets": [[end_pos, frac, ndv], ...]}
+*/
+
+bool Histogram::serialize_json(String *str)
+{
+  DBUG_ASSERT(type == JSON_HB);
+  uint n_mcv= get_json_mcv_count();
+  uint n_buckets= get_json_bucket_count();
+  double *mcv= json_mcv();
+  double *bucket= json_buckets();
+
+  if (str->append(STRING_WITH_LEN("{\"mcv\": [")))
+    return true;
+  for (uint i= 0; i < n_mcv; i++, mcv+= json_mcv_fields)
+  {
+    if ((i && str->append(STRING_WITH_LEN(", "))) ||
+        str->append('[') || json_append_double(str, mcv[0]) ||
+        str->append(STRING_WITH_LEN(", ")) ||
+        json_append_double(str, mcv[1]) || str->append(']'))
+      return true;
+  }
+  if (str->append(STRING_WITH_LEN("], \"buckets\": [")))
+    return true;
+  for (uint i= 0; i < n_buckets; i++, bucket+= json_bucket_fields)
+  {
+    if ((i && str->append(STRING_WITH_LEN(", "))) ||
+        str->append('[') || json_append_double(str, bucket[0]) ||
+        str->append(STRING_WITH_LEN(", ")) ||
+        json_append_double(str, bucket[1]) ||
+        str->append(STRING_WITH_LEN(", ")) ||
+        json_append_double(str, bucket[2]) || str->append(']'))
+      return true;
+  }
+  return str->append(STRING_WITH_LEN("]}"));
+}
+
+
+/*
+  Read a JSON_HB histogram written by serialize_json().
+
+  @retval false  OK
+  @retval true   The text is not a valid histogram of this size
+*/
+
+bool Histogram::parse_json(const char *str, size_t length)
+{
+  DBUG_ASSERT(type == JSON_HB);
+  json_engine_t je;
+  double *dst= NULL;
+  uint n= 0, max_n= 0;
+  uint n_mcv_values= 0, n_bucket_values= 0;
+  uint *count= NULL;
+
+  bzero(values, get_alloc_size());
+  json_scan_start(&je, &my_charset_utf8mb4_bin, (const uchar *) str,
+                  (const uchar *) str + length);
+
+  while (json_scan_next(&je) == 0)
+  {
+    switch (je.state) {
+    case JST_KEY:
+    {
+      const uchar *k_start= je.s.c_str, *k_end;
+      do
+      {
+        k_end= je.s.c_str;
+      } while (json_read_keyname_chr(&je) == 0);
+      if (je.s.error)
+        return true;
+
+      size_t k_len= k_end - k_start;
+      if (k_len == 3 && !memcmp(k_start, "mcv", 3))
+      {
+        dst= json_mcv();
+        max_n= json_mcv_fields * size;
+        count= &n_mcv_values;
+      }
+      else if (k_len == 7 && !memcmp(k_start, "buckets", 7))
+      {
+        dst= json_buckets();
+        max_n= json_bucket_fields * size;
+        count= &n_bucket_values;
+      }
+      else
+        return true;
+      n= 0;
+      if (json_read_value(&je) || je.value_type != JSON_VALUE_ARRAY)
+        return true;
+      break;
+    }
+    case JST_VALUE:
+      if (json_read_value(&je))
+        return true;
+      if (je.value_type == JSON_VALUE_NUMBER)
+      {
+        char *end= (char *) je.value_end;
+        int err;
+        if (!dst || n == max_n)
+          return true;
+        dst[n++]= my_strtod((const char *) je.value, &end, &err);
+        if (err)
+          return true;
+        *count= n;
+      }
+      else if (!(je.value_type == JSON_VALUE_ARRAY && dst) &&
+               !(je.value_type == JSON_VALUE_OBJECT && !dst))
+        return true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (je.s.error || n_mcv_values % json_mcv_fields ||
+      n_bucket_values % json_bucket_fields)
+    return true;
+  json_header()[0]= n_mcv_values / json_mcv_fields;
+  json_header()[1]= n_bucket_values / json_bucket_fields;
+  return false;
+}
+
+
 /*
   Check whether the table is one of the persistent statistical tables.
 */
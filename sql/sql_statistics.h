@@ -42,7 +42,8 @@ typedef
 enum enum_histogram_type
 {
   SINGLE_PREC_HB,
-  DOUBLE_PREC_HB
+  DOUBLE_PREC_HB,
+  JSON_HB
 } Histogram_type;
 
 enum enum_stat_tables
@@ -140,12 +141,32 @@ double get_column_range_cardinality(Field *field,
 bool is_stat_table(const LEX_CSTRING *db, LEX_CSTRING *table);
 bool is_eits_usable(Field* field);
 
+/*
+  A histogram of the values of a column.
+
+  SINGLE_PREC_HB and DOUBLE_PREC_HB are height-balanced histograms: 'values'
+  holds 'size' bytes with the positions, between min_value and max_value,
+  of the bucket endpoints.
+
+  A JSON_HB histogram holds up to 'size' most common values (MCV) with their
+  frequencies, and up to 'size' equi-height buckets over the remaining
+  values. It is stored in column_stats.histogram as
+    {"mcv": [[pos, frac], ...], "buckets": [[end_pos, frac, ndv], ...]}
+  where frac is the fraction of the non-NULL rows that have the value (or
+  that fall into the bucket and are not among the MCV), and ndv is the
+  number of distinct values of the bucket that are not among the MCV.
+  The bucket #i covers the positions (end_pos[i-1], end_pos[i]].
+  In memory, 'values' holds the same numbers as an array of doubles, see
+  json_mcv() and json_buckets().
+*/
+
 class Histogram
 {
 
 private:
   Histogram_type type;
-  uint8 size; /* Size of values array, in bytes */
+  uint8 size; /* Size of values array, in bytes; for JSON_HB, the maximum
+                 number of MCV and of buckets */
   uchar *values;
 
   uint prec_factor()
@@ -155,10 +176,20 @@ class Histogram
       return ((uint) (1 << 8) - 1);
     case DOUBLE_PREC_HB:
       return ((uint) (1 << 16) - 1);
+    case JSON_HB:
+      break;
     }
     return 1;
   }
 
+  /* JSON_HB: numbers of MCV and buckets, then the MCV and bucket arrays */
+  static const uint json_mcv_fields= 2;     /* pos, frac */
+  static const uint json_bucket_fields= 3;  /* end_pos, frac, ndv */
+
+  double *json_header() { return (double *) values; }
+  double *json_mcv() { return json_header() + 2; }
+  double *json_buckets() { return json_mcv() + json_mcv_fields * size; }
+
 public:
   uint get_width()
   {
@@ -167,10 +198,57 @@ class Histogram
       return size;
     case DOUBLE_PREC_HB:
       return size / 2;
+    case JSON_HB:
+      return size;
     }
     return 0;
   }
 
+  /* Size of the memory taken by 'values' of a histogram */
+  static uint get_alloc_size(Histogram_type type, uint size)
+  {
+    if (type == JSON_HB)
+      return (uint) sizeof(double) *
+             (2 + (json_mcv_fields + json_bucket_fields) * size);
+    return size;
+  }
+
+  uint get_alloc_size() { return get_alloc_size(type, size); }
+
+  uint get_json_mcv_count()
+  {
+    DBUG_ASSERT(type == JSON_HB);
+    return (uint) json_header()[0];
+  }
+
+  uint get_json_bucket_count()
+  {
+    DBUG_ASSERT(type == JSON_HB);
+    return (uint) json_header()[1];
+  }
+
+  void set_json_mcv(uint i, double pos, double frac)
+  {
+    DBUG_ASSERT(i < size);
+    double *mcv= json_mcv() + i * json_mcv_fields;
+    mcv[0]= pos;
+    mcv[1]= frac;
+    json_header()[0]= i + 1;
+  }
+
+  void set_json_bucket(uint i, double end_pos, double frac, double ndv)
+  {
+    DBUG_ASSERT(i < size);
+    double *bucket= json_buckets() + i * json_bucket_fields;
+    bucket[0]= end_pos;
+    bucket[1]= frac;
+    bucket[2]= ndv;
+    json_header()[1]= i + 1;
+  }
+
+  bool serialize_json(String *str);
+  bool parse_json(const char *str, size_t length);
+
 private:
   uint get_value(uint i)
   {
@@ -180,10 +258,16 @@ class Histogram
       return (uint) (((uint8 *) values)[i]);
     case DOUBLE_PREC_HB:
       return (uint) uint2korr(values + i * 2);
+    case JSON_HB:
+      DBUG_ASSERT(0);
+      break;
     }
     return 0;
   }
 
+  double json_point_selectivity(double pos, double avg_sel);
+  double json_range_selectivity(double min_pos, double max_pos);
+
   /* Find the bucket which value 'pos' falls into. */
   uint find_bucket(double pos, bool first)
   {
@@ -237,7 +321,13 @@ class Histogram
 
   void set_values (uchar *vals) { values= (uchar *) vals; }
 
-  bool is_available() { return get_size() > 0 && get_values(); }
+  bool is_available()
+  {
+    if (!get_size() || !get_values())
+      return false;
+    return type != JSON_HB ||
+           get_json_mcv_count() + get_json_bucket_count() > 0;
+  }
 
   void set_value(uint i, double val)
   {
@@ -248,6 +338,9 @@ class Histogram
     case DOUBLE_PREC_HB:
       int2store(values + i * 2, val * prec_factor());
       return;
+    case JSON_HB:
+      DBUG_ASSERT(0);
+      return;
     }
   }
 
@@ -260,11 +353,16 @@ class Histogram
     case DOUBLE_PREC_HB:
       int2store(values + i * 2, uint2korr(values + i * 2 - 2));
       return;
+    case JSON_HB:
+      DBUG_ASSERT(0);
+      return;
     }
   }
 
   double range_selectivity(double min_pos, double max_pos)
   {
+    if (type == JSON_HB)
+      return json_range_selectivity(min_pos, max_pos);
     double sel;
     double bucket_sel= 1.0/(get_width() + 1);  
     uint min= find_bucket(min_pos, TRUE);
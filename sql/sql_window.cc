@@ -2700,14 +2700,15 @@ void get_window_functions_required_cursors(
 /**
   Helper function that takes a list of window functions and writes
   their values in the current table record.
+
+  The table must be positioned on the current row.
 */
 static
 bool save_window_function_values(List<Item_window_func>& window_functions,
-                                 TABLE *tbl, uchar *rowid_buf)
+                                 TABLE *tbl)
 {
   List_iterator_fast<Item_window_func> iter(window_functions);
   JOIN_TAB *join_tab= tbl->reginfo.join_tab;
-  tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
   store_record(tbl, record[1]);
   while (Item_window_func *item_win= iter++)
     item_win->save_in_field(item_win->result_field, true);
@@ -2781,6 +2782,10 @@ bool save_window_function_values(List<Item_window_func>& window_functions,
   @TODO:  Only the first cursor needs to check for run-out-of-partition
   condition (Others can catch up by counting rows?)
 
+  Cursors of frames like ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW,
+  which ROW_NUMBER(), RANK() and running totals use, only look at the
+  current row. The current row is read again only if a cursor has read
+  another row, so such functions are computed in a single pass.
 */
 bool compute_window_func(THD *thd,
                          List<Item_window_func>& window_functions,
@@ -2832,6 +2837,9 @@ bool compute_window_func(THD *thd,
     iter_part_trackers.rewind();
     iter_cursor_managers.rewind();
 
+    /* Rows read by the cursors, which move away from the current row */
+    ulong rnd_reads= thd->status_var.ha_read_rnd_count;
+
     Group_bound_tracker *tracker;
     while ((win_func= iter_win_funcs++) &&
            (tracker= iter_part_trackers++) &&
@@ -2849,20 +2857,23 @@ bool compute_window_func(THD *thd,
         cursor_manager->notify_cursors_next_row();
       }
 
+      /* Return to current row after notifying cursors for each window
+         function. */
+      if (thd->status_var.ha_read_rnd_count != rnd_reads)
+      {
+        tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
+        rnd_reads= thd->status_var.ha_read_rnd_count;
+      }
+
       /* Check if we found any error in the window function while adding values
          through cursors. */
       if (unlikely(thd->is_error() || thd->is_killed()))
         break;
-
-
-      /* Return to current row after notifying cursors for each window
-         function. */
-      tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
     }
 
     /* We now have computed values for each window function. They can now
        be saved in the current row. */
-    save_window_function_values(window_functions, tbl, rowid_buf);
+    save_window_function_values(window_functions, tbl);
 
     rownum++;
   }
@@ -2944,6 +2955,10 @@ bool Window_func_runner::add_function_to_run(Item_window_func *win_func)
       my_error(ER_NOT_SUPPORTED_YET, MYF(0),
                "JSON_OBJECTAGG() aggregate as window function");
       return true;
+    case Item_sum::APPROX_COUNT_DISTINCT_FUNC:
+      my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+               "APPROX_COUNT_DISTINCT() aggregate as window function");
+      return true;
     default:
       break;
   }
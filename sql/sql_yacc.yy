@@ -522,6 +522,7 @@ End SQL_MODE_ORACLE_SPECIFIC */
 %token  <kwd> GOTO_ORACLE_SYM               /* Oracle-R   */
 %token  <kwd> GRANT                         /* SQL-2003-R */
 %token  <kwd> GROUP_CONCAT_SYM
+%token  <rwd> APPROX_COUNT_DISTINCT_SYM
 %token  <rwd> JSON_ARRAYAGG_SYM
 %token  <rwd> JSON_OBJECTAGG_SYM
 %token  <kwd> GROUP_SYM                     /* SQL-2003-R */
@@ -10765,6 +10766,12 @@ sum_expr:
             if (unlikely($$ == NULL))
               MYSQL_YYABORT;
           }
+        | APPROX_COUNT_DISTINCT_SYM '(' in_sum_expr ')'
+          {
+            $$= new (thd->mem_root) Item_sum_approx_count_distinct(thd, $3);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
         | BIT_AND  '(' in_sum_expr ')'
           {
             $$= new (thd->mem_root) Item_sum_and(thd, $3);
@@ -1412,6 +1412,18 @@ Sys_log_bin_compress(
   "log_bin_compress", "Whether the binary log can be compressed",
   GLOBAL_VAR(opt_bin_log_compress), CMD_LINE(OPT_ARG), DEFAULT(FALSE));
 
+static const char *log_bin_compress_algorithm_names[]= {"ZLIB", "ZSTD", 0};
+static Sys_var_on_access_global<Sys_var_enum,
+                            PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS>
+Sys_log_bin_compress_algorithm(
+  "log_bin_compress_algorithm",
+  "Algorithm that compresses the binary log if log_bin_compress is set. "
+  "ZSTD compresses better and faster than ZLIB, but its events can only be "
+  "read by slaves and mysqlbinlog built with zstd. ZSTD falls back to ZLIB "
+  "if the server was built without zstd",
+  GLOBAL_VAR(opt_bin_log_compress_algorithm), CMD_LINE(REQUIRED_ARG),
+  log_bin_compress_algorithm_names, DEFAULT(BINLOG_COMPRESS_ZLIB));
+
 /* the min length is 10, means that Begin/Commit/Rollback would never be compressed!   */
 static Sys_var_on_access_global<Sys_var_uint,
                             PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS_MIN_LEN>
@@ -2318,7 +2330,8 @@ Sys_var_slave_parallel_mode::global_value_ptr(THD *thd,
 
 /* The order here must match enum_slave_parallel_mode in mysqld.h. */
 static const char *slave_parallel_mode_names[] = {
-  "none", "minimal", "conservative", "optimistic", "aggressive", NULL
+  "none", "minimal", "conservative", "writeset", "optimistic", "aggressive",
+  NULL
 };
 export TYPELIB slave_parallel_mode_typelib = {
   array_elements(slave_parallel_mode_names)-1,
@@ -2335,7 +2348,10 @@ Sys_slave_parallel_mode(
        "--slave-parallel-threads. Possible values: \"optimistic\" tries to "
        "apply most transactional DML in parallel, and handles any conflicts "
        "with rollback and retry. \"conservative\" limits parallelism in an "
-       "effort to avoid any conflicts. \"aggressive\" tries to maximise the "
+       "effort to avoid any conflicts. \"writeset\" additionally applies in "
+       "parallel transactions whose writesets, logged by the master with "
+       "--binlog-transaction-dependency-tracking=WRITESET, do not intersect. "
+       "\"aggressive\" tries to maximise the "
        "parallelism, possibly at the cost of increased conflict rate. "
        "\"minimal\" only parallelizes the commit steps of transactions. "
        "\"none\" disables parallel apply completely.",
@@ -2415,6 +2431,24 @@ Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+/* The order here must match enum_binlog_dependency_tracking in mysqld.h. */
+static const char *binlog_dependency_tracking_names[]=
+  {"COMMIT_ORDER", "WRITESET", NullS};
+static Sys_var_on_access_global<Sys_var_enum,
+             PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY_TRACKING>
+Sys_binlog_transaction_dependency_tracking(
+       "binlog_transaction_dependency_tracking",
+       "Controls what the master logs about the dependencies between "
+       "transactions for parallel apply on the slave. COMMIT_ORDER only logs "
+       "which transactions group committed together. WRITESET additionally "
+       "logs with every transaction the hashes of the primary and unique key "
+       "values it modified, so that slave_parallel_mode=writeset can apply "
+       "transactions that modified different rows in parallel.",
+       GLOBAL_VAR(opt_binlog_dependency_tracking), CMD_LINE(REQUIRED_ARG),
+       binlog_dependency_tracking_names,
+       DEFAULT(BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -2633,15 +2667,26 @@ static Sys_var_ulong Sys_open_files_limit(
        AUTO_SET READ_ONLY GLOBAL_VAR(open_files_limit), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, OS_FILE_LIMIT), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_optimizer_cache_join_order(
+       "optimizer_cache_join_order",
+       "Let prepared statements and stored routines reuse the join order "
+       "of their previous execution without searching for a new one, "
+       "as long as the same tables are constant and the estimated number "
+       "of rows of every table has not changed by more than a factor of 2",
+       SESSION_VAR(optimizer_cache_join_order), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 /// @todo change to enum
 static Sys_var_ulong Sys_optimizer_prune_level(
        "optimizer_prune_level",
        "Controls the heuristic(s) applied during query optimization to prune "
        "less-promising partial plans from the optimizer search space. "
        "Meaning: 0 - do not apply any heuristic, thus perform exhaustive "
-       "search; 1 - prune plans based on number of retrieved rows",
+       "search; 1 - prune plans based on number of retrieved rows; "
+       "2 - also prune plans that join the same tables as an already "
+       "explored plan with no more rows at no higher cost",
        SESSION_VAR(optimizer_prune_level), CMD_LINE(REQUIRED_ARG),
-       VALID_RANGE(0, 1), DEFAULT(1), BLOCK_SIZE(1));
+       VALID_RANGE(0, 2), DEFAULT(1), BLOCK_SIZE(1));
 
 static Sys_var_ulong Sys_optimizer_selectivity_sampling_limit(
        "optimizer_selectivity_sampling_limit",
@@ -3251,6 +3296,16 @@ Sys_slave_compressed_protocol(
        GLOBAL_VAR(opt_slave_compressed_protocol), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_uint Sys_protocol_zstd_compression_level(
+       "protocol_zstd_compression_level",
+       "zstd compression level of the compressed client/server protocol. "
+       "Connections of clients that request compression and support zstd "
+       "are compressed as one zstd stream instead of compressing every "
+       "packet with zlib. 0 disables zstd. Has no effect if the server "
+       "was built without zstd",
+       GLOBAL_VAR(opt_protocol_zstd_compression_level), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 22), DEFAULT(3), BLOCK_SIZE(1));
+
 #ifdef HAVE_REPLICATION
 static const char *slave_exec_mode_names[]= {"STRICT", "IDEMPOTENT", 0};
 static Sys_var_on_access_global<Sys_var_enum,
@@ -3564,6 +3619,14 @@ static Sys_var_ulonglong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, SIZE_T_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_sort_parallel_threads(
+       "sort_parallel_threads",
+       "Maximum number of threads that sort a filesort buffer in memory. "
+       "The buffer is split into ranges that are sorted concurrently and "
+       "then merged. 1 disables parallel sorting",
+       SESSION_VAR(sort_parallel_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 export sql_mode_t expand_sql_mode(sql_mode_t sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -4005,6 +4068,24 @@ Sys_threadpool_dedicated_listener(
   GLOBAL_VAR(threadpool_dedicated_listener), CMD_LINE(OPT_ARG), DEFAULT(FALSE),
   NO_MUTEX_GUARD, NOT_IN_BINLOG
 );
+
+static Sys_var_mybool Sys_threadpool_numa_affinity(
+  "thread_pool_numa_affinity",
+  "If set to 1, the thread groups are distributed over the NUMA nodes, "
+  "and the worker threads of a group only run on the CPUs of its node",
+  READ_ONLY GLOBAL_VAR(threadpool_numa_affinity), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE)
+);
+
+static Sys_var_on_access_global<Sys_var_mybool,
+                                PRIV_SET_SYSTEM_GLOBAL_VAR_THREAD_POOL>
+Sys_threadpool_work_stealing(
+  "thread_pool_work_stealing",
+  "If set to 1, idle worker threads take queued requests from thread "
+  "groups whose threads are all busy",
+  GLOBAL_VAR(threadpool_work_stealing), CMD_LINE(OPT_ARG), DEFAULT(FALSE),
+  NO_MUTEX_GUARD, NOT_IN_BINLOG
+);
 #endif /* HAVE_POOL_OF_THREADS */
 
 /**
@@ -6404,7 +6485,8 @@ static Sys_var_enum Sys_optimizer_use_stat_tables(
 
 static Sys_var_ulong Sys_histogram_size(
        "histogram_size",
-       "Number of bytes used for a histogram. "
+       "Number of bytes used for a histogram, or the maximum number of "
+       "buckets and of most common values of a JSON_HB histogram. "
        "If set to 0, no histograms are created by ANALYZE.",
        SESSION_VAR(histogram_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 255), DEFAULT(254), BLOCK_SIZE(1));
@@ -6415,7 +6497,9 @@ static Sys_var_enum Sys_histogram_type(
        "Specifies type of the histograms created by ANALYZE. "
        "Possible values are: "
        "SINGLE_PREC_HB - single precision height-balanced, "
-       "DOUBLE_PREC_HB - double precision height-balanced.",
+       "DOUBLE_PREC_HB - double precision height-balanced, "
+       "JSON_HB - most common values and height-balanced buckets "
+       "in JSON format.",
        SESSION_VAR(histogram_type), CMD_LINE(REQUIRED_ARG),
        histogram_types, DEFAULT(1));
 
@@ -7939,6 +7939,9 @@ bool TABLE::check_tmp_key(uint key, uint key_parts,
     reg_field= field + fld_idx;
     if ((*reg_field)->type() == MYSQL_TYPE_BLOB)
       return FALSE;
+    /* HEAP cannot index BLOB columns, including GEOMETRY */
+    if (((*reg_field)->flags & BLOB_FLAG) && s->db_type() == heap_hton)
+      return FALSE;
     uint fld_store_len= (uint16) (*reg_field)->key_length();
     if ((*reg_field)->real_maybe_null())
       fld_store_len+= HA_KEY_NULL_LENGTH;
@@ -1681,6 +1681,7 @@ struct TABLE
   void set_spl_opt_info(SplM_opt_info *spl_info);
   void deny_splitting();
   double get_materialization_cost(); // Now used only if is_splittable()==true
+  bool split_injected_values_changed();
   void add_splitting_info_for_key_field(struct KEY_FIELD *key_field);
 
   key_map with_impossible_ranges;
@@ -50,6 +50,9 @@
 #include "lf.h"
 #include "table.h"
 #include "sql_base.h"
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 
 /** Configuration. */
@@ -213,6 +216,27 @@ struct Table_cache_instance
 static Table_cache_instance *tc;
 
 
+/**
+  Get the table cache instance to be used by the calling thread.
+
+  Threads that run on different CPUs use different instances, so that the
+  mutex of an instance is taken by threads of one CPU only, which seldom
+  run at the same time, and acquiring and releasing a hot table does not
+  bounce a shared cache line between CPUs. If the CPU is not known, the
+  instance is picked by thread id.
+*/
+
+static inline uint32_t tc_instance(THD *thd, uint32_t n_instances)
+{
+#ifdef HAVE_SCHED_GETCPU
+  int cpu= sched_getcpu();
+  if (cpu >= 0)
+    return uint32_t(cpu) % n_instances;
+#endif
+  return thd->thread_id % n_instances;
+}
+
+
 static void intern_close_table(TABLE *table)
 {
   delete table->triggers;
@@ -332,7 +356,7 @@ void tc_purge()
 void tc_add_table(THD *thd, TABLE *table)
 {
   uint32_t i=
-    thd->thread_id % tc_active_instances.load(std::memory_order_relaxed);
+    tc_instance(thd, tc_active_instances.load(std::memory_order_relaxed));
   TABLE *LRU_table= 0;
   TDC_element *element= table->s->tdc;
 
@@ -386,7 +410,7 @@ void tc_add_table(THD *thd, TABLE *table)
 TABLE *tc_acquire_table(THD *thd, TDC_element *element)
 {
   uint32_t n_instances= tc_active_instances.load(std::memory_order_relaxed);
-  uint32_t i= thd->thread_id % n_instances;
+  uint32_t i= tc_instance(thd, n_instances);
   TABLE *table;
 
   tc[i].lock_and_check_contention(n_instances, i);
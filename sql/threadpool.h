@@ -28,6 +28,8 @@ extern uint threadpool_oversubscribe;  /* Maximum active threads in group */
 extern uint threadpool_prio_kickup_timer;  /* Time before low prio item gets prio boost */
 extern my_bool threadpool_exact_stats; /* Better queueing time stats for information_schema, at small performance cost */
 extern my_bool threadpool_dedicated_listener; /* Listener thread does not pick up work items. */
+extern my_bool threadpool_numa_affinity; /* Bind thread groups to NUMA nodes */
+extern my_bool threadpool_work_stealing; /* Idle groups take work from busy ones */
 #ifdef _WIN32
 extern uint threadpool_mode; /* Thread pool implementation , windows or generic */
 #define TP_MODE_WINDOWS 0
@@ -45,6 +45,8 @@ uint threadpool_mode;
 uint threadpool_prio_kickup_timer;
 my_bool threadpool_exact_stats;
 my_bool threadpool_dedicated_listener;
+my_bool threadpool_numa_affinity;
+my_bool threadpool_work_stealing;
 
 /* Stats */
 TP_STATISTICS tp_stats;
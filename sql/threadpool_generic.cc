@@ -29,6 +29,10 @@
 #include <sql_plist.h>
 #include <threadpool.h>
 #include <algorithm>
+#include <vector>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
 #ifdef _WIN32
 #include "threadpool_winsockets.h"
 #define OPTIONAL_IO_POLL_READ_PARAM this
@@ -475,6 +479,99 @@ static bool is_queue_empty(thread_group_t *thread_group)
 }
 
 
+/**
+  Take a queued connection from a busy group, for an idle worker of
+  thread_group.
+
+  Only groups on the same NUMA node whose threads are all busy are
+  considered; the queue of a group with no active thread is drained by the
+  worker that the group wakes itself. The connection moves to thread_group,
+  in the same way as change_group() does it, so that its later events are
+  also handled here.
+
+  The caller holds thread_group->mutex, so the mutex of the other group is
+  only tried.
+*/
+
+static TP_connection_generic *queue_steal(thread_group_t *thread_group)
+{
+  uint count= group_count;
+  size_t self= size_t(thread_group - all_groups);
+
+  if (self >= count)
+    return NULL;
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(self + i) % count];
+    TP_connection_generic *c= NULL;
+
+    /* Unprotected reads, to skip the groups that have nothing to give */
+    if (group->numa_node != thread_group->numa_node ||
+        !group->active_thread_count || is_queue_empty(group) ||
+        mysql_mutex_trylock(&group->mutex))
+      continue;
+
+    if (!group->shutdown && group->active_thread_count)
+      c= queue_get(group, operation_origin::WORKER);
+    if (c)
+    {
+      if (c->bound_to_poll_descriptor)
+      {
+        io_poll_disassociate_fd(group->pollfd, c->fd);
+        c->bound_to_poll_descriptor= false;
+      }
+      group->connection_count--;
+    }
+    mysql_mutex_unlock(&group->mutex);
+
+    if (c)
+    {
+      c->thread_group= thread_group;
+      thread_group->connection_count++;
+      return c;
+    }
+  }
+  return NULL;
+}
+
+
+/**
+  Wake an idle worker of another group on the same NUMA node, to steal
+  from the queue of thread_group (see queue_steal()).
+
+  The caller holds thread_group->mutex, so the mutex of the other group is
+  only tried.
+*/
+
+static void wake_neighbour(thread_group_t *thread_group)
+{
+  uint count= group_count;
+  size_t self= size_t(thread_group - all_groups);
+
+  if (self >= count)
+    return;
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(self + i) % count];
+    bool woken= false;
+
+    if (group->numa_node != thread_group->numa_node ||
+        group->waiting_threads.is_empty() ||
+        mysql_mutex_trylock(&group->mutex))
+      continue;
+
+    if (!group->shutdown && is_queue_empty(group))
+      woken= !wake_thread(group, false);
+    mysql_mutex_unlock(&group->mutex);
+
+    if (woken)
+      return;
+  }
+}
+
+
 static void queue_init(thread_group_t *thread_group)
 {
   for (int i=0; i < NQUEUES; i++)
@@ -795,7 +892,16 @@ static TP_connection_generic * listener(worker_thread_t *current_thread,
       break;
     }
 
-    if(thread_group->active_thread_count==0)
+    if (thread_group->active_thread_count && threadpool_work_stealing)
+    {
+      /*
+        All threads of the group are busy, and the queued events would
+        wait for one of them. Let an idle thread of another group take
+        them.
+      */
+      wake_neighbour(thread_group);
+    }
+    else if(thread_group->active_thread_count==0)
     {
       /* We added some work items to queue, now wake a worker. */
       if(wake_thread(thread_group, false))
@@ -984,6 +1090,7 @@ int thread_group_init(thread_group_t *thread_group, pthread_attr_t* thread_attr)
   thread_group->pollfd= INVALID_HANDLE_VALUE;
   thread_group->shutdown_pipe[0]= -1;
   thread_group->shutdown_pipe[1]= -1;
+  thread_group->numa_node= -1;
   queue_init(thread_group);
   DBUG_RETURN(0);
 }
@@ -1214,6 +1321,14 @@ TP_connection_generic *get_event(worker_thread_t *current_thread,
       }
     }
 
+    /* Before going idle, help a group that is busy */
+    if (!oversubscribed && threadpool_work_stealing)
+    {
+      connection= queue_steal(thread_group);
+      if (connection)
+        break;
+    }
+
 
     /* And now, finally sleep */
     current_thread->woken = false; /* wake() sets this to true */
@@ -1375,9 +1490,28 @@ static void set_next_timeout_check(ulonglong abstime)
   DBUG_VOID_RETURN;
 }
 
-static size_t get_group_id(my_thread_id tid)
+/**
+  Pick the group for a connection.
+
+  This is the group with the fewest connections. The search starts at
+  thread_id % group_count, so that groups with the same number of
+  connections get new connections in turn. connection_count is read
+  without the group mutex, as an estimate is good enough here.
+*/
+
+static thread_group_t *get_group(my_thread_id tid)
 {
-  return size_t(tid % group_count);
+  uint count= group_count;
+  size_t start= size_t(tid % count);
+  thread_group_t *best= &all_groups[start];
+
+  for (uint i= 1; i < count && best->connection_count; i++)
+  {
+    thread_group_t *group= &all_groups[(start + i) % count];
+    if (group->connection_count < best->connection_count)
+      best= group;
+  }
+  return best;
 }
 
 
@@ -1401,8 +1535,7 @@ TP_connection_generic::TP_connection_generic(CONNECT *c):
 #endif
 
   /* Assign connection to a group. */
-  thread_group_t *group=
-    &all_groups[get_group_id(c->thread_id)];
+  thread_group_t *group= get_group(c->thread_id);
   thread_group=group;
 
   mysql_mutex_lock(&group->mutex);
@@ -1486,15 +1619,17 @@ int TP_connection_generic::start_io()
     connection should need to migrate  to another group, this ensures
     to ensure equal load between groups.
 
-    So we recalculate in which group the connection should be, based
-    on thread_id and current group count, and migrate if necessary.
+    So we migrate the connection if its group is no longer in use, or
+    if this makes the load of the groups more even.
   */
   if (fix_group)
   {
     fix_group = false;
-    thread_group_t *new_group= &all_groups[get_group_id(thd->thread_id)];
+    thread_group_t *new_group= get_group(thd->thread_id);
 
-    if (new_group != thread_group)
+    if (new_group != thread_group &&
+        (thread_group >= all_groups + group_count ||
+         thread_group->connection_count > new_group->connection_count + 1))
     {
       if (change_group(this, thread_group, new_group))
         return -1;
@@ -1530,6 +1665,16 @@ static void *worker_main(void *param)
 
   thread_group_t *thread_group = (thread_group_t *)param;
 
+#ifdef HAVE_LIBNUMA
+  /*
+    Run on the CPUs of the group's node. With the default memory policy,
+    the THDs and buffers of the group's connections are then allocated
+    from memory of the same node.
+  */
+  if (thread_group->numa_node >= 0)
+    numa_run_on_node(thread_group->numa_node);
+#endif
+
   /* Init per-thread structure */
   mysql_cond_init(key_worker_cond, &this_thread.cond, NULL);
   this_thread.thread_group= thread_group;
@@ -1569,6 +1714,44 @@ static void *worker_main(void *param)
 TP_pool_generic::TP_pool_generic()
 {}
 
+/**
+  Distribute the thread groups over the NUMA nodes that have CPUs.
+
+  Consecutive groups are put on different nodes, so that any
+  thread_pool_size uses all nodes evenly.
+*/
+
+static void set_numa_nodes()
+{
+#ifdef HAVE_LIBNUMA
+  if (numa_available() < 0)
+  {
+    sql_print_warning("Thread pool: NUMA is not available, "
+                      "ignoring thread_pool_numa_affinity");
+    return;
+  }
+
+  std::vector<int> nodes;
+  struct bitmask *cpus= numa_allocate_cpumask();
+  for (int node= 0; node <= numa_max_node(); node++)
+  {
+    if (numa_bitmask_isbitset(numa_all_nodes_ptr, node) &&
+        !numa_node_to_cpus(node, cpus) && numa_bitmask_weight(cpus))
+      nodes.push_back(node);
+  }
+  numa_free_cpumask(cpus);
+
+  if (nodes.empty())
+    return;
+  for (uint i= 0; i < threadpool_max_size; i++)
+    all_groups[i].numa_node= nodes[i % nodes.size()];
+#else
+  sql_print_warning("Thread pool: the server was built without NUMA "
+                    "support, ignoring thread_pool_numa_affinity");
+#endif
+}
+
+
 int TP_pool_generic::init()
 {
   DBUG_ENTER("TP_pool_generic::TP_pool_generic");
@@ -1588,6 +1771,8 @@ int TP_pool_generic::init()
   {
     thread_group_init(&all_groups[i], get_connection_attrib());
   }
+  if (threadpool_numa_affinity)
+    set_numa_nodes();
   set_pool_size(threadpool_size);
   if(group_count == 0)
   {
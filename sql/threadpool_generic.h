@@ -146,6 +146,8 @@ struct thread_group_t
   int  shutdown_pipe[2];
   bool shutdown;
   bool stalled;
+  /* NUMA node that the worker threads run on, -1 if not bound */
+  int numa_node;
   thread_group_counters_t counters;
   char pad[CPU_LEVEL1_DCACHE_LINESIZE];
 };
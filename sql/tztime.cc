@@ -44,6 +44,7 @@
 #endif
 
 #include "tztime.h"
+#include <my_atomic.h>
 #include "tzfile.h"
 #include <m_string.h>
 #include <my_dir.h>
@@ -141,6 +142,12 @@ typedef struct st_time_zone_info
     there are no transitions at all.
   */
   TRAN_TYPE_INFO *fallback_tti;
+  /*
+    Index of the transition range that find_transition_type() found last.
+    Shared by all threads using the time zone, so it is accessed with
+    relaxed atomics and always validated before use.
+  */
+  mutable uint32 last_range;
 
 } TIME_ZONE_INFO;
 
@@ -686,12 +693,26 @@ find_transition_type(my_time_t t, const TIME_ZONE_INFO *sp)
     return sp->fallback_tti;
   }
 
+  /*
+    Consecutive conversions, e.g. of the TIMESTAMP column of a result set
+    or the argument of CONVERT_TZ() over many rows, usually fall into the
+    same range between transitions, so try the last one found first.
+  */
+  uint i= (uint) my_atomic_load32_explicit((int32*) &sp->last_range,
+                                           MY_MEMORY_ORDER_RELAXED);
+  if (i < sp->timecnt && sp->ats[i] <= t &&
+      (i + 1 == sp->timecnt || t < sp->ats[i + 1]))
+    return &(sp->ttis[sp->types[i]]);
+
   /*
     Do binary search for minimal interval between transitions which
     contain t. With this localtime_r on real data may takes less
     time than with linear search (I've seen 30% speed up).
   */
-  return &(sp->ttis[sp->types[find_time_range(t, sp->ats, sp->timecnt)]]);
+  i= find_time_range(t, sp->ats, sp->timecnt);
+  my_atomic_store32_explicit((int32*) &sp->last_range, (int32) i,
+                             MY_MEMORY_ORDER_RELAXED);
+  return &(sp->ttis[sp->types[i]]);
 }
 
 
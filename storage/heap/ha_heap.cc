@@ -611,6 +611,7 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOB_DESC *blob_descs;
   bool found_real_auto_increment= 0;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
@@ -622,8 +623,17 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                        MYF(MY_WME | MY_THREAD_SPECIFIC),
                        &keydef, keys * sizeof(HP_KEYDEF),
                        &seg, parts * sizeof(HA_KEYSEG),
+                       &blob_descs, share->blob_fields * sizeof(HP_BLOB_DESC),
                        NULL))
     return my_errno;
+  /* Only internal temporary tables can have BLOB columns (HA_NO_BLOBS) */
+  DBUG_ASSERT(internal_table || !share->blob_fields);
+  for (uint i= 0; i < share->blob_fields; i++)
+  {
+    Field_blob *field= (Field_blob*) table_arg->field[share->blob_field[i]];
+    blob_descs[i].offset= (uint) (field->ptr - table_arg->record[0]);
+    blob_descs[i].packlength= field->pack_length_no_ptr();
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -716,6 +726,13 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  /*
+    The size of the BLOB data is not known in advance, so it cannot be
+    covered by max_rows like the size of the fixed-length records.
+  */
+  if (share->blob_fields)
+    set_if_smaller(hp_create_info->max_table_size,
+                   current_thd->variables.tmp_memory_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
@@ -728,6 +745,8 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blobs= share->blob_fields;
+  hp_create_info->blob_descs= blob_descs;
   return 0;
 }
 
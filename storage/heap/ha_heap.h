@@ -45,6 +45,10 @@ class ha_heap final : public handler
   }
   /* Rows also use a fixed-size format */
   enum row_type get_row_type() const { return ROW_TYPE_FIXED; }
+  /*
+    BLOB columns are only supported in internal temporary tables, because
+    a row that was read points to the BLOB data of the table.
+  */
   ulonglong table_flags() const
   {
     return (HA_FAST_KEY_READ | HA_NO_BLOBS | HA_NULL_IN_KEY |
@@ -0,0 +1,184 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  BLOB columns of internal temporary tables
+
+  A BLOB column is stored in the fixed-length record the same way as in
+  table->record[0]: the length of the data followed by a pointer to it.
+  heap_write() and heap_update() replace the pointer with a pointer to a
+  copy of the data that is owned by the table and has exactly the length
+  of the data. The copy is freed when the row is deleted or updated, or
+  when the table is cleared.
+
+  A row that is read from the table points to the data of the table,
+  which stays valid until the row is updated or deleted. The length of
+  the copies is included in data_length, so that a table that gets too
+  big for max_table_size can be converted to an on disk table.
+*/
+
+#include "heapdef.h"
+
+static ulong hp_blob_length(const HP_BLOB_DESC *desc, const uchar *record)
+{
+  const uchar *pos= record + desc->offset;
+  switch (desc->packlength) {
+  case 1:
+    return (ulong) *pos;
+  case 2:
+    return (ulong) uint2korr(pos);
+  case 3:
+    return (ulong) uint3korr(pos);
+  case 4:
+    return (ulong) uint4korr(pos);
+  }
+  DBUG_ASSERT(0);
+  return 0;
+}
+
+
+static uchar *hp_blob_data(const HP_BLOB_DESC *desc, const uchar *record)
+{
+  uchar *data;
+  memcpy(&data, record + desc->offset + desc->packlength, sizeof(data));
+  return data;
+}
+
+
+/*
+  Copy the BLOB data of a record that is about to be stored
+
+  SYNOPSIS
+    hp_copy_blobs()
+    info        Heap table info
+    record      Record to be written
+    check_size  Set if the copies must not make data_length + index_length
+                exceed max_table_size
+
+  NOTES
+    The copies are kept in info->blob_ptrs until they are moved into the
+    stored record by hp_store_blobs() or freed by hp_free_blob_copies().
+
+  RETURN
+    0  ok
+    #  error number (also in my_errno)
+*/
+
+int hp_copy_blobs(HP_INFO *info, const uchar *record, my_bool check_size)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  if (check_size)
+  {
+    ulonglong length= 0;
+    for (i= 0; i < share->blobs; i++)
+      length+= hp_blob_length(share->blob_descs + i, record);
+    if (share->data_length + share->index_length + length >
+        share->max_table_size)
+      return my_errno= HA_ERR_RECORD_FILE_FULL;
+  }
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    ulong length= hp_blob_length(desc, record);
+    DBUG_ASSERT(!info->blob_ptrs[i]);
+    if (!length)
+      continue;
+    if (!(info->blob_ptrs[i]= (uchar*) my_malloc(hp_key_memory_HP_BLOB,
+                                                 length,
+                                                 MYF(share->internal ?
+                                                     MY_THREAD_SPECIFIC :
+                                                     0))))
+    {
+      hp_free_blob_copies(info, record);
+      return my_errno= HA_ERR_OUT_OF_MEM;
+    }
+    memcpy(info->blob_ptrs[i], hp_blob_data(desc, record), length);
+    share->data_length+= length;
+  }
+  return 0;
+}
+
+
+/* Free the copies that hp_copy_blobs() made of record */
+
+void hp_free_blob_copies(HP_INFO *info, const uchar *record)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    if (info->blob_ptrs[i])
+    {
+      share->data_length-= hp_blob_length(share->blob_descs + i, record);
+      my_free(info->blob_ptrs[i]);
+      info->blob_ptrs[i]= 0;
+    }
+  }
+}
+
+
+/* Make the stored record pos point to the copies made by hp_copy_blobs() */
+
+void hp_store_blobs(HP_INFO *info, uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    memcpy(pos + desc->offset + desc->packlength, &info->blob_ptrs[i],
+           sizeof(info->blob_ptrs[i]));
+    info->blob_ptrs[i]= 0;
+  }
+}
+
+
+/* Free the BLOB data of the stored record pos */
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    ulong length= hp_blob_length(desc, pos);
+    if (length)
+    {
+      my_free(hp_blob_data(desc, pos));
+      share->data_length-= length;
+    }
+  }
+}
+
+
+/* Free the BLOB data of all rows of the table */
+
+void hp_free_all_blobs(HP_SHARE *share)
+{
+  ulong pos, end= share->records + share->deleted;
+
+  for (pos= 0; pos < end; pos++)
+  {
+    uchar *record= hp_find_block(&share->block, pos);
+    if (record[share->visible])
+      hp_free_blobs(share, record);
+  }
+}
@@ -162,7 +162,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!(share= (HP_SHARE*) my_malloc(hp_key_memory_HP_SHARE,
                                        sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+                                       create_info->blobs*sizeof(HP_BLOB_DESC),
 				       MYF(MY_ZEROFILL |
                                            (create_info->internal_table ?
                                             MY_THREAD_SPECIFIC : 0)))))
@@ -207,6 +208,10 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       if ((keyinfo->flag & HA_AUTO_KEY) && create_info->with_auto_increment)
         share->auto_key= i + 1;
     }
+    share->blob_descs= (HP_BLOB_DESC*) keyseg;
+    share->blobs= create_info->blobs;
+    memcpy(share->blob_descs, create_info->blob_descs,
+           create_info->blobs * sizeof(HP_BLOB_DESC));
     share->min_records= min_records;
     share->max_records= max_records;
     share->max_table_size= create_info->max_table_size;
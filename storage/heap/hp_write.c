@@ -42,8 +42,14 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_RETURN(my_errno=EACCES);
   }
 #endif
+  if (share->blobs && hp_copy_blobs(info, record, 1))
+    DBUG_RETURN(my_errno);
   if (!(pos=next_free_record_pos(share)))
+  {
+    if (share->blobs)
+      hp_free_blob_copies(info, record);
     DBUG_RETURN(my_errno);
+  }
   share->changed=1;
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
@@ -54,6 +60,8 @@ int heap_write(HP_INFO *info, const uchar *record)
   }
 
   memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blobs(info, pos);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -86,6 +94,8 @@ int heap_write(HP_INFO *info, const uchar *record)
       break;
     keydef--;
   } 
+  if (share->blobs)
+    hp_free_blob_copies(info, record);
 
   share->deleted++;
   *((uchar**) pos)=share->del_link;
@@ -977,6 +977,51 @@ btr_free_root_check(
 	return(block);
 }
 
+/** Initialize the root page of an empty index tree.
+@param[in,out]	block		root page, with the segment headers
+@param[in]	index_id	index id
+@param[in]	index		index, or NULL to create a system table
+@param[in,out]	mtr		mini-transaction */
+static
+void
+btr_root_page_init(
+	buf_block_t*		block,
+	index_id_t		index_id,
+	dict_index_t*		index,
+	mtr_t*			mtr)
+{
+	constexpr uint16_t field = PAGE_HEADER + PAGE_INDEX_ID;
+
+	byte* page_index_id = my_assume_aligned<2>(field + block->frame);
+
+	/* Create a new index page on the allocated segment page */
+	if (UNIV_LIKELY_NULL(block->page.zip.data)) {
+		mach_write_to_8(page_index_id, index_id);
+		ut_ad(!page_has_siblings(block->page.zip.data));
+		page_create_zip(block, index, 0, 0, mtr);
+	} else {
+		page_create(block, mtr,
+			    index && index->table->not_redundant());
+		if (index && index->is_spatial()) {
+			static_assert(((FIL_PAGE_INDEX & 0xff00)
+				       | byte(FIL_PAGE_RTREE))
+				      == FIL_PAGE_RTREE, "compatibility");
+			mtr->write<1>(*block, FIL_PAGE_TYPE + 1 + block->frame,
+				      byte(FIL_PAGE_RTREE));
+			if (mach_read_from_8(block->frame
+					     + FIL_RTREE_SPLIT_SEQ_NUM)) {
+				mtr->memset(block, FIL_RTREE_SPLIT_SEQ_NUM,
+					    8, 0);
+			}
+		}
+		/* Set the level of the new index page */
+		mtr->write<2,mtr_t::MAYBE_NOP>(*block, PAGE_HEADER + PAGE_LEVEL
+					       + block->frame, 0U);
+		mtr->write<8,mtr_t::MAYBE_NOP>(*block, page_index_id,
+					       index_id);
+	}
+}
+
 /** Create the root node for a new index tree.
 @param[in]	type			type of the index
 @param[in]	index_id		index id
@@ -1049,36 +1094,7 @@ btr_create(
 
 	ut_ad(!page_has_siblings(block->frame));
 
-	constexpr uint16_t field = PAGE_HEADER + PAGE_INDEX_ID;
-
-	byte* page_index_id = my_assume_aligned<2>(field + block->frame);
-
-	/* Create a new index page on the allocated segment page */
-	if (UNIV_LIKELY_NULL(block->page.zip.data)) {
-		mach_write_to_8(page_index_id, index_id);
-		ut_ad(!page_has_siblings(block->page.zip.data));
-		page_create_zip(block, index, 0, 0, mtr);
-	} else {
-		page_create(block, mtr,
-			    index && index->table->not_redundant());
-		if (index && index->is_spatial()) {
-			static_assert(((FIL_PAGE_INDEX & 0xff00)
-				       | byte(FIL_PAGE_RTREE))
-				      == FIL_PAGE_RTREE, "compatibility");
-			mtr->write<1>(*block, FIL_PAGE_TYPE + 1 + block->frame,
-				      byte(FIL_PAGE_RTREE));
-			if (mach_read_from_8(block->frame
-					     + FIL_RTREE_SPLIT_SEQ_NUM)) {
-				mtr->memset(block, FIL_RTREE_SPLIT_SEQ_NUM,
-					    8, 0);
-			}
-		}
-		/* Set the level of the new index page */
-		mtr->write<2,mtr_t::MAYBE_NOP>(*block, PAGE_HEADER + PAGE_LEVEL
-					       + block->frame, 0U);
-		mtr->write<8,mtr_t::MAYBE_NOP>(*block, page_index_id,
-					       index_id);
-	}
+	btr_root_page_init(block, index_id, index, mtr);
 
 	/* We reset the free bits for the page in a separate
 	mini-transaction to allow creation of several trees in the
@@ -1167,6 +1183,55 @@ btr_free_but_not_root(
 	}
 }
 
+/** Remove all records from an index tree, keeping its root page.
+This is used in the rollback of TRX_UNDO_EMPTY.
+@param[in,out]	index	index tree */
+void btr_clear(dict_index_t* index)
+{
+	mtr_t	mtr;
+	mtr.start();
+	if (index->table->is_temporary()) {
+		mtr.set_log_mode(MTR_LOG_NO_REDO);
+	} else {
+		index->set_modified(mtr);
+	}
+
+	if (buf_block_t* root = btr_root_block_get(index, RW_X_LATCH, &mtr)) {
+		/* ROLLBACK does not reset AUTO_INCREMENT. */
+		const ib_uint64_t autoinc = index->is_primary()
+			? page_get_autoinc(root->frame) : 0;
+
+		btr_search_drop_page_hash_index(root);
+		btr_free_but_not_root(root, mtr.get_log_mode());
+
+		/* Create the leaf page segment again, and re-create the
+		(now leaf) root page like btr_create() does. */
+		mtr.write<2>(*root, FIL_PAGE_TYPE + root->frame,
+			     FIL_PAGE_TYPE_SYS);
+		mtr.memset(root, PAGE_HEADER + PAGE_BTR_SEG_LEAF,
+			   FSEG_HEADER_SIZE, 0);
+		if (fseg_create(index->table->space,
+				PAGE_HEADER + PAGE_BTR_SEG_LEAF, &mtr,
+				false, root)) {
+			btr_root_page_init(root, index->id, index, &mtr);
+			if (autoinc) {
+				page_set_autoinc(root, autoinc, &mtr, false);
+			}
+			if (!index->is_clust()
+			    && !index->table->is_temporary()) {
+				ibuf_reset_free_bits(root);
+			}
+		} else {
+			ib::error() << "Failed to re-create the leaf page"
+				" segment of index " << index->name
+				    << " of table " << index->table->name;
+			index->type |= DICT_CORRUPT;
+		}
+	}
+
+	mtr.commit();
+}
+
 /** Free a persistent index tree if it exists.
 @param[in]	page_id		root page id
 @param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
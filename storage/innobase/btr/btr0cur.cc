@@ -4090,6 +4090,8 @@ void btr_cur_upd_rec_in_place(rec_t *rec, const dict_index_t *index,
 	}
 #endif /* UNIV_DEBUG */
 
+	block->vis_hint_note(page_rec_get_heap_no(rec));
+
 	static_assert(REC_INFO_BITS_SHIFT == 0, "compatibility");
 	if (UNIV_LIKELY_NULL(block->page.zip.data)) {
 		ut_ad(rec_offs_comp(offsets));
@@ -5268,6 +5270,7 @@ btr_cur_pessimistic_update(
 template<bool flag>
 void btr_rec_set_deleted(buf_block_t *block, rec_t *rec, mtr_t *mtr)
 {
+  block->vis_hint_note(page_rec_get_heap_no(rec));
   if (page_rec_is_comp(rec))
   {
     byte *b= &rec[-REC_NEW_INFO_BITS];
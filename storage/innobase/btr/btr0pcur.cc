@@ -25,6 +25,7 @@ Created 2/23/1996 Heikki Tuuri
 *******************************************************/
 
 #include "btr0pcur.h"
+#include "buf0rea.h"
 #include "ut0byte.h"
 #include "rem0cmp.h"
 #include "trx0trx.h"
@@ -499,6 +500,21 @@ btr_pcur_move_to_next_page(
 
 	page_cur_set_before_first(next_block, btr_pcur_get_page_cur(cursor));
 
+	/* Start reading the page after the next one, so that a scan of
+	an index whose leaf pages are not physically adjacent (which
+	buf_read_ahead_linear() cannot detect) does not have to wait
+	for every page read. */
+	const dict_index_t* index = btr_pcur_get_btr_cur(cursor)->index;
+	const uint32_t next_next = btr_page_get_next(next_page);
+
+	if (next_next != FIL_NULL && page_is_leaf(next_page)
+	    && !index->is_ibuf() && index->table->space->acquire()) {
+		buf_read_page_background(
+			index->table->space,
+			page_id_t(next_block->page.id().space(), next_next),
+			next_block->zip_size(), false);
+	}
+
 	ut_d(page_check_dir(next_page));
 }
 
@@ -48,6 +48,12 @@ char		btr_search_enabled;
 /** Number of adaptive hash index partition. */
 ulong		btr_ahi_parts;
 
+/** innodb_adaptive_hash_index_lock_free */
+my_bool		btr_search_lock_free;
+
+/** innodb_adaptive_hash_index_min_hit_ratio */
+ulong		btr_search_min_hit_ratio;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint		btr_search_n_succ	= 0;
@@ -71,6 +77,14 @@ is then built on the page, assuming the global limit has been reached */
 before hash index building is started */
 #define BTR_SEARCH_BUILD_LIMIT		100U
 
+/** Number of hash searches in an index after which the hit ratio is
+compared to btr_search_min_hit_ratio */
+#define BTR_SEARCH_HIT_RATIO_SAMPLE	1000U
+
+/** Number of searches for which the hash index of an index is not used
+after its hit ratio was found to be below btr_search_min_hit_ratio */
+#define BTR_SEARCH_OFF_LIMIT		100000U
+
 /** Compute a hash value of a record in a page.
 @param[in]	rec		index record
 @param[in]	offsets		return value of rec_get_offsets()
@@ -235,6 +249,10 @@ void btr_search_disable()
 
 	btr_search_enabled = false;
 
+	/* Wait for btr_search_guess_lock_free() to stop accessing
+	the hash tables and the blocks. */
+	btr_search_sys.wait_for_readers();
+
 	/* Clear the index->search_info->ref_count of every index in
 	the data dictionary cache. */
 	for (table = UT_LIST_GET_FIRST(dict_sys.table_LRU); table;
@@ -471,14 +489,13 @@ __attribute__((nonnull))
 Insert an entry into the hash table. If an entry with the same fold number
 is found, its node is updated to point to the new data, and no new node
 is inserted.
-@param table hash table
-@param heap  memory heap
+@param part  adaptive hash index partition
 @param fold  folded value of the record
 @param block buffer block containing the record
 @param data  the record
 @retval true on success
 @retval false if no more memory could be allocated */
-static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
+static bool ha_insert_for_fold(btr_search_sys_t::partition *part,
                                ulint fold,
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
                                buf_block_t *block, /*!< buffer block of data */
@@ -490,13 +507,14 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
   ut_ad(btr_search_enabled);
 
-  hash_cell_t *cell= &table->array[table->calc_hash(fold)];
+  hash_cell_t *cell= &part->table.array[part->table.calc_hash(fold)];
 
   for (ha_node_t *prev= static_cast<ha_node_t*>(cell->node); prev;
        prev= prev->next)
   {
     if (prev->fold == fold)
     {
+      part->start_write();
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
       buf_block_t *prev_block= prev->block;
       ut_a(prev_block->frame == page_align(prev->data));
@@ -506,12 +524,14 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
       prev->block= block;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
       prev->data= data;
+      part->end_write();
       return true;
     }
   }
 
   /* We have to allocate a new chain node */
-  ha_node_t *node= static_cast<ha_node_t*>(mem_heap_alloc(heap, sizeof *node));
+  ha_node_t *node= static_cast<ha_node_t*>(mem_heap_alloc(part->heap,
+                                                          sizeof *node));
 
   if (!node)
     return false;
@@ -525,6 +545,7 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
   node->fold= fold;
   node->next= nullptr;
 
+  part->start_write();
   ha_node_t *prev= static_cast<ha_node_t*>(cell->node);
   if (!prev)
     cell->node= node;
@@ -534,15 +555,15 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
       prev= prev->next;
     prev->next= node;
   }
+  part->end_write();
   return true;
 }
 
 __attribute__((nonnull))
 /** Delete a record.
-@param table     hash table
-@param heap      memory heap
+@param part      adaptive hash index partition
 @param del_node  record to be deleted */
-static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
+static void ha_delete_hash_node(btr_search_sys_t::partition *part,
                                 ha_node_t *del_node)
 {
   ut_ad(btr_search_enabled);
@@ -551,8 +572,12 @@ static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
   ut_a(del_node->block->n_pointers-- < MAX_N_POINTERS);
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
+  hash_table_t *table= &part->table;
+  mem_heap_t *heap= part->heap;
   const ulint fold= del_node->fold;
 
+  part->start_write();
+
   HASH_DELETE(ha_node_t, next, table, fold, del_node);
 
   ha_node_t *top= static_cast<ha_node_t*>(mem_heap_get_top(heap, sizeof *top));
@@ -580,50 +605,49 @@ static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
     }
   }
 
+  part->end_write();
+
   /* Free the occupied space */
   mem_heap_free_top(heap, sizeof *top);
 }
 
 __attribute__((nonnull))
 /** Delete all pointers to a page.
-@param table     hash table
-@param heap      memory heap
+@param part      adaptive hash index partition
 @param page      record to be deleted */
-static void ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
+static void ha_remove_all_nodes_to_page(btr_search_sys_t::partition *part,
                                         ulint fold, const page_t *page)
 {
-  for (ha_node_t *node= ha_chain_get_first(table, fold); node; )
+  for (ha_node_t *node= ha_chain_get_first(&part->table, fold); node; )
   {
     if (page_align(ha_node_get_data(node)) == page)
     {
-      ha_delete_hash_node(table, heap, node);
+      ha_delete_hash_node(part, node);
       /* The deletion may compact the heap of nodes and move other nodes! */
-      node= ha_chain_get_first(table, fold);
+      node= ha_chain_get_first(&part->table, fold);
     }
     else
       node= ha_chain_get_next(node);
   }
 #ifdef UNIV_DEBUG
   /* Check that all nodes really got deleted */
-  for (ha_node_t *node= ha_chain_get_first(table, fold); node;
+  for (ha_node_t *node= ha_chain_get_first(&part->table, fold); node;
        node= ha_chain_get_next(node))
     ut_ad(page_align(ha_node_get_data(node)) != page);
 #endif /* UNIV_DEBUG */
 }
 
 /** Delete a record if found.
-@param table     hash table
-@param heap      memory heap for the hash bucket chain
+@param part      adaptive hash index partition
 @param fold      folded value of the searched data
 @param data      pointer to the record
 @return whether the record was found */
-static bool ha_search_and_delete_if_found(hash_table_t *table,
-                                          mem_heap_t *heap,
+static bool ha_search_and_delete_if_found(btr_search_sys_t::partition *part,
                                           ulint fold, const rec_t *data)
 {
-  if (ha_node_t *node= ha_search_with_data(table, fold, data))
+  if (ha_node_t *node= ha_search_with_data(&part->table, fold, data))
   {
-    ha_delete_hash_node(table, heap, node);
+    ha_delete_hash_node(part, node);
     return true;
   }
 
@@ -633,12 +657,13 @@ static bool ha_search_and_delete_if_found(hash_table_t *table,
 __attribute__((nonnull))
 /** Looks for an element when we know the pointer to the data and
 updates the pointer to data if found.
-@param table     hash table
+@param part      adaptive hash index partition
 @param fold      folded value of the searched data
 @param data      pointer to the data
 @param new_data  new pointer to the data
 @return whether the element was found */
-static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
+static bool ha_search_and_update_if_found(btr_search_sys_t::partition *part,
+                                          ulint fold,
                                           const rec_t *data,
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
                                           /** block containing new_data */
@@ -653,14 +678,16 @@ static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
   if (!btr_search_enabled)
     return false;
 
-  if (ha_node_t *node= ha_search_with_data(table, fold, data))
+  if (ha_node_t *node= ha_search_with_data(&part->table, fold, data))
   {
+    part->start_write();
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
     ut_a(node->block->n_pointers-- < MAX_N_POINTERS);
     ut_a(new_block->n_pointers++ < MAX_N_POINTERS);
     node->block= new_block;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
     node->data= new_data;
+    part->end_write();
 
     return true;
   }
@@ -670,9 +697,9 @@ static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 #else
-# define ha_insert_for_fold(t,h,f,b,d) ha_insert_for_fold(t,h,f,d)
-# define ha_search_and_update_if_found(table,fold,data,new_block,new_data) \
-	ha_search_and_update_if_found(table,fold,data,new_data)
+# define ha_insert_for_fold(p,f,b,d) ha_insert_for_fold(p,f,d)
+# define ha_search_and_update_if_found(part,fold,data,new_block,new_data) \
+	ha_search_and_update_if_found(part,fold,data,new_data)
 #endif
 
 /** Updates a hash node reference when it has been unsuccessfully used in a
@@ -737,7 +764,7 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 
-		ha_insert_for_fold(&part->table, part->heap, fold, block, rec);
+		ha_insert_for_fold(part, fold, block, rec);
 
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -878,11 +905,37 @@ btr_search_check_guess(
 	return(success);
 }
 
+/** Update the hit ratio of the adaptive hash index of an index, and stop
+using the adaptive hash index of the index for a while if the ratio is
+below innodb_adaptive_hash_index_min_hit_ratio.
+@param info  search info
+@param hit   whether the hash search succeeded */
+static void btr_search_update_hit_ratio(btr_search_t *info, bool hit)
+{
+  if (!btr_search_min_hit_ratio)
+    return;
+
+  info->n_hash_hits+= hit;
+
+  if (++info->n_hash_lookups < BTR_SEARCH_HIT_RATIO_SAMPLE)
+    return;
+
+  if (info->n_hash_hits * 100 < info->n_hash_lookups * btr_search_min_hit_ratio)
+  {
+    info->n_hash_off= BTR_SEARCH_OFF_LIMIT;
+    info->n_hash_potential= 0;
+  }
+
+  info->n_hash_lookups= 0;
+  info->n_hash_hits= 0;
+}
+
 static
 void
 btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
+	btr_search_update_hit_ratio(info, false);
 
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
@@ -944,11 +997,11 @@ inline void buf_pool_t::clear_hash_index()
     btr_search_lazy_free(index);
 }
 
-/** Get a buffer block from an adaptive hash index pointer.
-This function does not return if the block is not identified.
+/** Get a buffer block from an adaptive hash index pointer that
+may be stale, without checking the state of the block.
 @param ptr  pointer to within a page frame
 @return pointer to block, never NULL */
-inline buf_block_t* buf_pool_t::block_from_ahi(const byte *ptr) const
+inline buf_block_t* buf_pool_t::block_from_ahi_low(const byte *ptr) const
 {
   chunk_t::map *chunk_map = chunk_t::map_ref;
   ut_ad(chunk_t::map_ref == chunk_t::map_reg);
@@ -968,6 +1021,16 @@ inline buf_block_t* buf_pool_t::block_from_ahi(const byte *ptr) const
   /* buf_pool_t::chunk_t::init() invokes buf_block_init() so that
   block[n].frame == block->frame + n * srv_page_size.  Check it. */
   ut_ad(block->frame == page_align(ptr));
+  return block;
+}
+
+/** Get a buffer block from an adaptive hash index pointer.
+This function does not return if the block is not identified.
+@param ptr  pointer to within a page frame
+@return pointer to block, never NULL */
+inline buf_block_t* buf_pool_t::block_from_ahi(const byte *ptr) const
+{
+  buf_block_t *block= block_from_ahi_low(ptr);
   /* Read the state of the block without holding hash_lock.
   A state transition from BUF_BLOCK_FILE_PAGE to
   BUF_BLOCK_REMOVE_HASH is possible during this execution. */
@@ -976,6 +1039,133 @@ inline buf_block_t* buf_pool_t::block_from_ahi(const byte *ptr) const
   return block;
 }
 
+/** Outcome of btr_search_guess_lock_free() */
+enum btr_search_lock_free_t
+{
+  /** the partition was modified during the lookup */
+  BTR_SEARCH_LOCK_FREE_RETRY,
+  /** no usable record was found */
+  BTR_SEARCH_LOCK_FREE_FAIL,
+  /** the block was buffer-fixed and latched */
+  BTR_SEARCH_LOCK_FREE_OK
+};
+
+/** Look up a record in the adaptive hash index without acquiring
+part->latch. Every access is validated against part->version, which
+is incremented before and after each modification of part->table.
+A node that was validated may be freed afterwards, but its memory
+remains allocated in the buffer pool, so reading it is harmless.
+btr_search_disable() waits for us before freeing the hash table.
+@param part        adaptive hash index partition of index
+@param index       index
+@param fold        folded value of the search tuple
+@param latch_mode  BTR_SEARCH_LEAF or BTR_MODIFY_LEAF
+@param mtr         mini-transaction
+@param rec         the record that was found
+@param block       the block that contains rec
+@return the outcome of the lookup */
+static btr_search_lock_free_t
+btr_search_guess_lock_free(btr_search_sys_t::partition *part,
+                           const dict_index_t *index, ulint fold,
+                           ulint latch_mode, mtr_t *mtr,
+                           const rec_t **rec, buf_block_t **block)
+{
+  btr_search_sys_t::reader_slot *slot= btr_search_sys.reader_enter();
+  if (!slot)
+    return BTR_SEARCH_LOCK_FREE_FAIL;
+
+  btr_search_lock_free_t result= BTR_SEARCH_LOCK_FREE_RETRY;
+  const uint32_t version= part->version.load(std::memory_order_acquire);
+  const ha_node_t *node;
+  const rec_t *data;
+  buf_block_t *b;
+  page_hash_latch *hash_lock;
+  buf_page_state state;
+  const dict_index_t *block_index;
+
+  if (version & 1)
+    goto func_exit;
+
+  node= static_cast<const ha_node_t*>
+    (part->table.array[part->table.calc_hash(fold)].node);
+
+  for (;;)
+  {
+    if (!part->validate(version))
+      goto func_exit;
+    if (!node)
+    {
+      result= BTR_SEARCH_LOCK_FREE_FAIL;
+      goto func_exit;
+    }
+    const ulint node_fold= node->fold;
+    const ha_node_t *next= node->next;
+    data= node->data;
+    if (!part->validate(version))
+      goto func_exit;
+    if (node_fold == fold)
+      break;
+    node= next;
+  }
+
+  b= buf_pool.block_from_ahi_low(data);
+  hash_lock= buf_pool.hash_lock_get(b->page.id());
+  hash_lock->read_lock();
+  state= b->page.state();
+  block_index= b->index;
+
+  /* As long as part->table is unchanged, the block cannot have been
+  evicted, because that would have removed its adaptive hash index. */
+  if (!part->validate(version))
+  {
+    hash_lock->read_unlock();
+    goto func_exit;
+  }
+
+  if (state != BUF_BLOCK_FILE_PAGE || block_index != index)
+  {
+    hash_lock->read_unlock();
+    result= BTR_SEARCH_LOCK_FREE_FAIL;
+    goto func_exit;
+  }
+
+  buf_block_buf_fix_inc(b);
+  hash_lock->read_unlock();
+  b->page.set_accessed();
+  buf_page_make_young_if_needed(&b->page);
+
+  if (latch_mode == BTR_SEARCH_LEAF ? !b->lock.s_lock_try()
+      : !b->lock.x_lock_try())
+  {
+    buf_block_buf_fix_dec(b);
+    result= BTR_SEARCH_LOCK_FREE_FAIL;
+    goto func_exit;
+  }
+
+  /* Any modification of the page that would move data must have
+  updated the adaptive hash index while holding the page latch. */
+  if (!part->validate(version))
+  {
+    if (latch_mode == BTR_SEARCH_LEAF)
+      b->lock.s_unlock();
+    else
+      b->lock.x_unlock();
+    buf_block_buf_fix_dec(b);
+    goto func_exit;
+  }
+
+  mtr->memo_push(b, latch_mode == BTR_SEARCH_LEAF
+                 ? MTR_MEMO_PAGE_S_FIX : MTR_MEMO_PAGE_X_FIX);
+  buf_pool.stat.n_page_gets++;
+  *rec= data;
+  *block= b;
+  result= BTR_SEARCH_LOCK_FREE_OK;
+
+func_exit:
+  btr_search_sys_t::reader_exit(slot);
+  return result;
+}
+
 /** Tries to guess the right search position based on the hash search info
 of the index. Note that if mode is PAGE_CUR_LE, which is used in inserts,
 and the function returns TRUE, then cursor->up_match and cursor->low_match
@@ -1027,7 +1217,7 @@ btr_search_guess_on_hash(
 	/* Note that, for efficiency, the struct info may not be protected by
 	any latch here! */
 
-	if (info->n_hash_potential == 0) {
+	if (info->n_hash_potential == 0 || info->n_hash_off) {
 		return false;
 	}
 
@@ -1050,6 +1240,22 @@ btr_search_guess_on_hash(
 
 	auto part = btr_search_sys.get_part(*index);
 	const rec_t* rec;
+	buf_block_t* block;
+
+	if (!ahi_latch && btr_search_lock_free) {
+		switch (btr_search_guess_lock_free(part, index, fold,
+						   latch_mode, mtr,
+						   &rec, &block)) {
+		case BTR_SEARCH_LOCK_FREE_OK:
+			goto got_block;
+		case BTR_SEARCH_LOCK_FREE_FAIL:
+			btr_search_failure(info, cursor);
+			return false;
+		case BTR_SEARCH_LOCK_FREE_RETRY:
+			/* Fall back to acquiring the latch. */
+			break;
+		}
+	}
 
 	if (!ahi_latch) {
 		part->latch.rd_lock(SRW_LOCK_CALL);
@@ -1074,7 +1280,7 @@ btr_search_guess_on_hash(
 		return false;
 	}
 
-	buf_block_t* block = buf_pool.block_from_ahi(rec);
+	block = buf_pool.block_from_ahi(rec);
 
 	if (!ahi_latch) {
 		page_hash_latch* hash_lock = buf_pool.hash_lock_get(
@@ -1129,6 +1335,7 @@ btr_search_guess_on_hash(
 		goto fail_and_release_page;
 	}
 
+got_block:
 	if (block->page.state() != BUF_BLOCK_FILE_PAGE) {
 
 		ut_ad(block->page.state() == BUF_BLOCK_REMOVE_HASH);
@@ -1199,6 +1406,7 @@ btr_search_guess_on_hash(
 	meanwhile! Thus it might not be a bug. */
 #endif
 	info->last_hash_succ = TRUE;
+	btr_search_update_hit_ratio(info, true);
 
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
@@ -1357,8 +1565,7 @@ void btr_search_drop_page_hash_index(buf_block_t* block)
 	}
 
 	for (i = 0; i < n_cached; i++) {
-		ha_remove_all_nodes_to_page(&part->table, part->heap,
-					    folds[i], page);
+		ha_remove_all_nodes_to_page(part, folds[i], page);
 	}
 
 	switch (index->search_info->ref_count--) {
@@ -1614,8 +1821,7 @@ btr_search_build_page_hash_index(
 	{
 		auto part = btr_search_sys.get_part(*index);
 		for (ulint i = 0; i < n_cached; i++) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   folds[i], block, recs[i]);
+			ha_insert_for_fold(part, folds[i], block, recs[i]);
 		}
 	}
 
@@ -1801,8 +2007,7 @@ void btr_search_update_hash_on_delete(btr_cur_t* cursor)
 	if (block->index && btr_search_enabled) {
 		ut_a(block->index == index);
 
-		if (ha_search_and_delete_if_found(&part->table, part->heap,
-						  fold, rec)) {
+		if (ha_search_and_delete_if_found(part, fold, rec)) {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVED);
 		} else {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND);
@@ -1864,7 +2069,7 @@ void btr_search_update_hash_node_on_insert(btr_cur_t *cursor,
 	    && !block->curr_left_side) {
 
 		if (ha_search_and_update_if_found(
-			&btr_search_sys.get_part(*cursor->index)->table,
+			btr_search_sys.get_part(*cursor->index),
 			cursor->fold, rec, block,
 			page_rec_get_next(rec))) {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_UPDATED);
@@ -1974,8 +2179,7 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 			}
 
 			part = btr_search_sys.get_part(*index);
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
 
@@ -1996,11 +2200,9 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 		}
 
 		if (!left_side) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   fold, block, rec);
+			ha_insert_for_fold(part, fold, block, rec);
 		} else {
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -2020,8 +2222,7 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 				part = btr_search_sys.get_part(*index);
 			}
 
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
 
@@ -2041,11 +2242,9 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 		}
 
 		if (!left_side) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 		} else {
-			ha_insert_for_fold(&part->table, part->heap,
-					   next_fold, block, next_rec);
+			ha_insert_for_fold(part, next_fold, block, next_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
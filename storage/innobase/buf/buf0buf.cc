@@ -445,7 +445,8 @@ static bool buf_page_decrypt_after_read(buf_page_t *bpage,
 		ut_d(fil_page_type_validate(node.space, dst_frame));
 
 		ulint write_size = fil_page_decompress(
-			slot->crypt_buf, dst_frame, flags);
+			slot->crypt_buf, dst_frame, flags,
+			node.space->zstd_dict.load(std::memory_order_acquire));
 		slot->release();
 		ut_ad(!write_size
 		      || fil_page_type_validate(node.space, dst_frame));
@@ -1206,6 +1207,8 @@ buf_block_init(buf_block_t* block, byte* frame)
 
 	MEM_MAKE_DEFINED(&block->modify_clock, sizeof block->modify_clock);
 	ut_ad(!block->modify_clock);
+	block->vis_clock.store(0, std::memory_order_relaxed);
+	block->vis_max_trx_id = 0;
 	block->page.init(BUF_BLOCK_NOT_USED, page_id_t(~0ULL));
 #ifdef BTR_CUR_HASH_ADAPT
 	MEM_MAKE_DEFINED(&block->index, sizeof block->index);
@@ -1301,6 +1304,14 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
 
   reg();
 
+#ifdef __linux__
+  /* With innodb_linux_aio=io_uring, register the page frames as fixed
+  buffers, so that the kernel will not have to pin the pages on every
+  read or write. This will make the whole chunk resident. */
+  if (srv_linux_aio == tpool::OS_IO_URING && srv_thread_pool)
+    srv_thread_pool->register_buffer(mem, mem_size());
+#endif
+
   return true;
 }
 
@@ -1362,6 +1373,79 @@ static void buf_block_free_mutexes(buf_block_t* block)
 	block->lock.free();
 }
 
+/** State of buf_pool_populate() */
+struct buf_pool_populate_t
+{
+  /** the first chunk */
+  buf_pool_t::chunk_t *chunks;
+  /** number of chunks */
+  size_t n_chunks;
+  /** the next chunk to populate */
+  std::atomic<size_t> next;
+};
+
+/** Make the page frames of buffer pool chunks resident.
+@param arg  buf_pool_populate_t */
+static void buf_pool_populate_task(void *arg)
+{
+  buf_pool_populate_t *p= static_cast<buf_pool_populate_t*>(arg);
+
+  for (;;)
+  {
+    const size_t i= p->next.fetch_add(1, std::memory_order_relaxed);
+    if (i >= p->n_chunks)
+      return;
+    const buf_pool_t::chunk_t &chunk= p->chunks[i];
+    if (!chunk.size)
+      continue;
+    byte *frame= chunk.blocks->frame;
+    const size_t bytes= chunk.size << srv_page_size_shift;
+#ifdef MADV_POPULATE_WRITE
+    if (!madvise(frame, bytes, MADV_POPULATE_WRITE))
+      continue;
+#endif
+    /* The frames of free blocks carry no data. Touch every 4KiB page,
+    which also covers any larger page size of the mapping. */
+    for (size_t offset= 0; offset < bytes; offset+= 4096)
+      frame[offset]= 0;
+    MEM_UNDEFINED(frame, bytes);
+  }
+}
+
+/** Make the buffer pool resident in parallel tasks of srv_thread_pool,
+so that the page faults will not be taken on the first access to
+each page frame. With innodb_numa_interleave=ON, the pages will be
+interleaved according to the mbind() policy of each chunk.
+@param chunks    the first chunk
+@param n_chunks  number of chunks */
+static void buf_pool_populate(buf_pool_t::chunk_t *chunks, size_t n_chunks)
+{
+  buf_pool_populate_t p;
+  p.chunks= chunks;
+  p.n_chunks= n_chunks;
+  p.next= 0;
+
+  const size_t n_tasks= srv_thread_pool
+    ? std::min<size_t>(n_chunks, std::max(my_getncpus(), 1)) - 1 : 0;
+  std::vector<tpool::waitable_task*> tasks;
+
+  for (size_t i= 0; i < n_tasks; i++)
+  {
+    tpool::waitable_task *task=
+      new tpool::waitable_task(buf_pool_populate_task, &p);
+    srv_thread_pool->submit_task(task);
+    tasks.push_back(task);
+  }
+
+  buf_pool_populate_task(&p);
+
+  for (tpool::waitable_task *task : tasks)
+  {
+    task->wait();
+    delete task;
+  }
+}
+
 /** Create the hash table.
 @param n  the lower bound of n_cells */
 void buf_pool_t::page_hash_table::create(ulint n)
@@ -1410,6 +1494,8 @@ bool buf_pool_t::create()
         for (auto i= chunk->size; i--; block++)
           buf_block_free_mutexes(block);
 
+        if (srv_thread_pool)
+          srv_thread_pool->unregister_buffer(chunk->mem);
         allocator.deallocate_large_dodump(chunk->mem, &chunk->mem_pfx);
       }
       ut_free(chunks);
@@ -1424,6 +1510,12 @@ bool buf_pool_t::create()
   }
   while (++chunk < chunks + n_chunks);
 
+  if (srv_buf_pool_populate)
+  {
+    ib::info() << "Populating the buffer pool";
+    buf_pool_populate(chunks, n_chunks);
+  }
+
   ut_ad(is_initialised());
   mysql_mutex_init(buf_pool_mutex_key, &mutex, MY_MUTEX_INIT_FAST);
 
@@ -1512,6 +1604,8 @@ void buf_pool_t::close()
     for (auto i= chunk->size; i--; block++)
       buf_block_free_mutexes(block);
 
+    if (srv_thread_pool)
+      srv_thread_pool->unregister_buffer(chunk->mem);
     allocator.deallocate_large_dodump(chunk->mem, &chunk->mem_pfx);
   }
 
@@ -1817,13 +1911,12 @@ inline bool buf_pool_t::withdraw_blocks()
 	return(false);
 }
 
-/** resize page_hash and zip_hash */
-inline void buf_pool_t::resize_hash()
+/** resize page_hash and zip_hash
+@param new_page_hash  the new page_hash, created and write-locked
+@param new_hash       the new zip_hash, created */
+inline void buf_pool_t::resize_hash(page_hash_table *new_page_hash,
+                                    hash_table_t &new_hash)
 {
-  page_hash_table *new_page_hash= UT_NEW_NOKEY(page_hash_table());
-  new_page_hash->create(2 * buf_pool.curr_size);
-  new_page_hash->write_lock_all();
-
   for (auto i= page_hash.pad(page_hash.n_cells); i--; )
   {
     static_assert(!((page_hash_table::ELEMENTS_PER_LATCH + 1) &
@@ -1850,9 +1943,6 @@ inline void buf_pool_t::resize_hash()
   freed_page_hash= new_page_hash;
 
   /* recreate zip_hash */
-  hash_table_t new_hash;
-  new_hash.create(2 * buf_pool.curr_size);
-
   for (ulint i= 0; i < buf_pool.zip_hash.n_cells; i++)
   {
     while (buf_page_t *bpage= static_cast<buf_page_t*>
@@ -2076,6 +2166,23 @@ inline void buf_pool_t::resize()
 		return;
 	}
 
+	const bool	new_size_too_diff
+		= srv_buf_pool_base_size > srv_buf_pool_size * 2
+			|| srv_buf_pool_base_size * 2 < srv_buf_pool_size;
+
+	/* Allocate and initialize the new hash tables before latching
+	the whole buffer pool. With a large buffer pool, clearing the
+	arrays takes a noticeable time. */
+	page_hash_table* new_page_hash = NULL;
+	hash_table_t new_zip_hash = hash_table_t();
+
+	if (new_size_too_diff) {
+		new_page_hash = UT_NEW_NOKEY(page_hash_table());
+		new_page_hash->create(2 * curr_size);
+		new_page_hash->write_lock_all();
+		new_zip_hash.create(2 * curr_size);
+	}
+
 	/* Indicate critical path */
 	resizing.store(true, std::memory_order_relaxed);
 
@@ -2117,6 +2224,10 @@ inline void buf_pool_t::resize()
 				buf_block_free_mutexes(block);
 			}
 
+			if (srv_thread_pool) {
+				srv_thread_pool->unregister_buffer(
+					chunk->mem);
+			}
 			allocator.deallocate_large_dodump(
 				chunk->mem, &chunk->mem_pfx);
 			sum_freed += chunk->size;
@@ -2231,21 +2342,25 @@ inline void buf_pool_t::resize()
   srv_buf_pool_curr_size= curr_pool_size;/* FIXME: remove*/
   innodb_set_buf_pool_size(buf_pool_size_align(srv_buf_pool_curr_size));
 
-	const bool	new_size_too_diff
-		= srv_buf_pool_base_size > srv_buf_pool_size * 2
-			|| srv_buf_pool_base_size * 2 < srv_buf_pool_size;
-
 	/* Normalize page_hash and zip_hash,
 	if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		buf_resize_status("Resizing hash table");
-		resize_hash();
+		resize_hash(new_page_hash, new_zip_hash);
+		new_page_hash = NULL;
 		ib::info() << "hash tables were resized";
 	}
 
   mysql_mutex_unlock(&mutex);
   write_unlock_all_page_hash();
 
+	if (new_page_hash) {
+		new_page_hash->write_unlock_all();
+		new_page_hash->free();
+		UT_DELETE(new_page_hash);
+	}
+	new_zip_hash.free();
+
 	UT_DELETE(chunk_map_old);
 
 	resizing.store(false, std::memory_order_relaxed);
@@ -48,17 +48,25 @@ Created April 08, 2011 Vasil Dimov
 static void buf_do_load_dump();
 
 enum status_severity {
+	STATUS_VERBOSE,
 	STATUS_INFO,
 	STATUS_ERR
 };
 
 #define SHUTTING_DOWN()	(srv_shutdown_state != SRV_SHUTDOWN_NONE)
 
+/** Number of pages submitted by buf_load() between checks whether
+innodb_buffer_pool_load_status should be updated */
+#define BUF_LOAD_STATUS_INTERVAL	1024
+
 /* Flags that tell the buffer pool dump/load thread which action should it
 take after being waked up. */
 static volatile bool	buf_dump_should_start;
 static volatile bool	buf_load_should_start;
 
+/** Whether the requested dump was started by buf_dump_periodic() */
+static volatile bool	buf_dump_is_periodic;
+
 static bool	buf_load_abort_flag;
 
 /** Start the buffer pool dump/load task and instructs it to start a dump. */
@@ -103,6 +111,9 @@ buf_dump_status(
 		fmt, ap);
 
 	switch (severity) {
+	case STATUS_VERBOSE:
+		break;
+
 	case STATUS_INFO:
 		ib::info() << export_vars.innodb_buffer_pool_dump_status;
 		break;
@@ -142,6 +153,9 @@ buf_load_status(
 		fmt, ap);
 
 	switch (severity) {
+	case STATUS_VERBOSE:
+		break;
+
 	case STATUS_INFO:
 		ib::info() << export_vars.innodb_buffer_pool_load_status;
 		break;
@@ -242,13 +256,17 @@ buf_dump(
 	char	now[32];
 	FILE*	f;
 	int	ret;
+	/* Do not flood the error log with periodic dumps. */
+	const status_severity severity = buf_dump_is_periodic
+		? STATUS_VERBOSE : STATUS_INFO;
+	buf_dump_is_periodic = false;
 
 	buf_dump_generate_path(full_filename, sizeof(full_filename));
 
 	snprintf(tmp_filename, sizeof(tmp_filename),
 		 "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_INFO, "Dumping buffer pool(s) to %s",
+	buf_dump_status(severity, "Dumping buffer pool(s) to %s",
 			full_filename);
 
 #ifdef _WIN32
@@ -296,7 +314,7 @@ buf_dump(
 		total number of pages */
 		t_pages = buf_pool.curr_size * srv_buf_pool_dump_pct / 100;
 		if (n_pages > t_pages) {
-			buf_dump_status(STATUS_INFO,
+			buf_dump_status(severity,
 					"Restricted to " ULINTPF
 					" pages due to "
 					"innodb_buf_pool_dump_pct=%lu",
@@ -400,7 +418,7 @@ buf_dump(
 
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_INFO,
+	buf_dump_status(severity,
 			"Buffer pool(s) dump completed at %s", now);
 
 	/* Though dumping doesn't related to an incomplete load,
@@ -623,6 +641,8 @@ buf_load()
 
 	ulint		last_check_time = 0;
 	ulint		last_activity_cnt = 0;
+	const ulint	start_time = ut_time_ms();
+	ulint		last_status_time = start_time;
 
 	/* Avoid calling the expensive fil_space_t::get() for each
 	page within the same tablespace. dump[] is sorted by (space, page),
@@ -676,8 +696,10 @@ buf_load()
 			continue;
 		}
 
+		/* Submit the reads asynchronously, so that the read I/O
+		threads can keep many requests for adjacent pages in flight. */
 		space->reacquire();
-		buf_read_page_background(space, dump[i], zip_size, true);
+		buf_read_page_background(space, dump[i], zip_size, false);
 
 		if (buf_load_abort_flag) {
 			if (space) {
@@ -701,6 +723,21 @@ buf_load()
 		buf_load_throttle_if_needed(
 			&last_check_time, &last_activity_cnt, i);
 
+		if (!(i % BUF_LOAD_STATUS_INTERVAL)) {
+			const ulint	now_ms = ut_time_ms();
+
+			if (now_ms - last_status_time >= 1000) {
+				last_status_time = now_ms;
+				buf_load_status(
+					STATUS_VERBOSE,
+					"Loaded " ULINTPF "/" ULINTPF " pages, "
+					ULINTPF " pages/s", i, dump_n,
+					i * 1000 / (now_ms - start_time));
+				mysql_stage_set_work_completed(
+					pfs_stage_progress, i);
+			}
+		}
+
 #ifdef UNIV_DEBUG
 		if ((i+1) >= srv_buf_pool_load_pages_abort) {
 			buf_load_abort_flag = true;
@@ -714,6 +751,8 @@ buf_load()
 
 	ut_free(dump);
 
+	os_aio_wait_until_no_pending_reads();
+
 	ut_sprintf_timestamp(now);
 
 	if (i == dump_n) {
@@ -821,3 +860,38 @@ void buf_load_dump_end()
   ut_ad(SHUTTING_DOWN());
   buf_dump_load_task.wait();
 }
+
+/** Start a buffer pool dump if innodb_buffer_pool_dump_interval has passed
+since the previous one and pages were read into the buffer pool since then.
+Invoked by srv_master_callback(). */
+void buf_dump_periodic()
+{
+  static time_t last_dump_time;
+  static ulint last_n_pages;
+
+  /* Do not replace a dump with the contents of a partially loaded
+  buffer pool. */
+  if (!srv_buf_pool_dump_interval || !load_dump_enabled ||
+      export_vars.innodb_buffer_pool_load_incomplete)
+    return;
+
+  const time_t now= time(nullptr);
+  if (!last_dump_time)
+  {
+    last_dump_time= now;
+    return;
+  }
+  if (now - last_dump_time < time_t(srv_buf_pool_dump_interval))
+    return;
+  last_dump_time= now;
+
+  /* Skip the dump if the set of resident pages cannot have changed. */
+  const ulint n_pages= buf_pool.stat.n_pages_read +
+    buf_pool.stat.n_pages_created;
+  if (n_pages == last_n_pages)
+    return;
+  last_n_pages= n_pages;
+
+  buf_dump_is_periodic= true;
+  buf_dump_start();
+}
@@ -38,8 +38,11 @@ Created 11/11/1995 Heikki Tuuri
 #include "page0zip.h"
 #include "fil0fil.h"
 #include "log0crypt.h"
+#include "log0online.h"
 #include "srv0mon.h"
 #include "fil0pagecompress.h"
+#include <algorithm>
+#include <deque>
 #ifdef UNIV_LINUX
 /* include defs for CPU time priority settings */
 #include <unistd.h>
@@ -127,7 +130,7 @@ static void buf_flush_validate_skip()
 #endif /* UNIV_DEBUG */
 
 /** Wake up the page cleaner if needed */
-inline void buf_pool_t::page_cleaner_wakeup()
+void buf_pool_t::page_cleaner_wakeup()
 {
   if (page_cleaner_idle() &&
       (srv_max_dirty_pages_pct_lwm == 0.0 ||
@@ -141,16 +144,19 @@ inline void buf_pool_t::page_cleaner_wakeup()
 }
 
 /** Insert a modified block into the flush list.
+The caller must hold buf_pool.flush_list_mutex, so that all the blocks
+that a mini-transaction made dirty are inserted while acquiring it once,
+and invoke buf_pool.page_cleaner_wakeup() before releasing it.
 @param[in,out]	block	modified block
 @param[in]	lsn	oldest modification */
 void buf_flush_insert_into_flush_list(buf_block_t* block, lsn_t lsn)
 {
 	mysql_mutex_assert_not_owner(&buf_pool.mutex);
 	mysql_mutex_assert_owner(&log_sys.flush_order_mutex);
+	mysql_mutex_assert_owner(&buf_pool.flush_list_mutex);
 	ut_ad(lsn);
 	ut_ad(!fsp_is_system_temporary(block->page.id().space()));
 
-	mysql_mutex_lock(&buf_pool.flush_list_mutex);
 	block->page.set_oldest_modification(lsn);
 	MEM_CHECK_DEFINED(block->page.zip.data
 			  ? block->page.zip.data : block->frame,
@@ -160,8 +166,6 @@ void buf_flush_insert_into_flush_list(buf_block_t* block, lsn_t lsn)
 
 	UT_LIST_ADD_FIRST(buf_pool.flush_list, &block->page);
 	ut_d(buf_flush_validate_skip());
-	buf_pool.page_cleaner_wakeup();
-	mysql_mutex_unlock(&buf_pool.flush_list_mutex);
 }
 
 /** Remove a block from buf_pool.flush_list */
@@ -739,7 +743,8 @@ static byte *buf_page_encrypt(fil_space_t* space, buf_page_t* bpage, byte* s,
     byte *tmp= slot->comp_buf;
     ulint len= fil_page_compress(s, tmp, space->flags,
                                  fil_space_get_block_size(space, page_no),
-                                 encrypted);
+                                 encrypted, space->zstd_dict.load(
+                                   std::memory_order_acquire));
 
     if (!len)
       goto not_compressed;
@@ -811,13 +816,191 @@ static void buf_release_freed_page(buf_page_t *bpage)
   mysql_mutex_unlock(&buf_pool.mutex);
 }
 
+/** Write a page that buf_flush_page() has io-fixed.
+@param bpage       buffer control block
+@param lru         true=buf_pool.LRU; false=buf_pool.flush_list
+@param space       tablespace */
+static void buf_flush_page_low(buf_page_t *bpage, bool lru, fil_space_t *space)
+{
+  ut_ad(bpage->io_fix() == BUF_IO_WRITE);
+  ut_ad(bpage->oldest_modification());
+  mysql_mutex_assert_not_owner(&buf_pool.mutex);
+
+  const bool uncompressed= bpage->state() == BUF_BLOCK_FILE_PAGE;
+  const auto status= bpage->status;
+  ut_ad(status == buf_page_t::NORMAL || status == buf_page_t::INIT_ON_FLUSH);
+
+  buf_block_t *block= reinterpret_cast<buf_block_t*>(bpage);
+  page_t *frame= bpage->zip.data;
+
+  space->reacquire();
+  size_t size;
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+  size_t orig_size;
+#endif
+  IORequest::Type type= lru ? IORequest::WRITE_LRU : IORequest::WRITE_ASYNC;
+
+  if (UNIV_UNLIKELY(!uncompressed)) /* ROW_FORMAT=COMPRESSED */
+  {
+    ut_ad(!space->full_crc32());
+    ut_ad(!space->is_compressed()); /* not page_compressed */
+    size= bpage->zip_size();
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+    orig_size= size;
+#endif
+    buf_flush_update_zip_checksum(frame, size);
+    frame= buf_page_encrypt(space, bpage, frame, &size);
+    ut_ad(size == bpage->zip_size());
+  }
+  else
+  {
+    byte *page= block->frame;
+    size= block->physical_size();
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+    orig_size= size;
+#endif
+
+    if (space->full_crc32())
+    {
+      /* innodb_checksum_algorithm=full_crc32 is not implemented for
+      ROW_FORMAT=COMPRESSED pages. */
+      ut_ad(!frame);
+      page= buf_page_encrypt(space, bpage, page, &size);
+      buf_flush_init_for_writing(block, page, nullptr, true);
+    }
+    else
+    {
+      buf_flush_init_for_writing(block, page, frame ? &bpage->zip : nullptr,
+                                 false);
+      page= buf_page_encrypt(space, bpage, frame ? frame : page, &size);
+    }
+
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+    if (size != orig_size && space->punch_hole)
+      type= lru ? IORequest::PUNCH_LRU : IORequest::PUNCH;
+#endif
+    frame=page;
+  }
+
+  ut_ad(status == bpage->status);
+
+  if (lru)
+    buf_pool.n_flush_LRU++;
+  else
+    buf_pool.n_flush_list++;
+  if (status != buf_page_t::NORMAL || !space->use_doublewrite())
+    space->io(IORequest(type, bpage),
+              bpage->physical_offset(), size, frame, bpage);
+  else
+    buf_dblwr.add_to_batch(IORequest(bpage, space->chain.start, type), size);
+
+  /* Increment the I/O operation count used for selecting LRU policy. */
+  buf_LRU_stat_inc_io();
+}
+
+/** Maximum number of pages that one buf_flush_task_t writes */
+static constexpr ulint buf_flush_task_pages= 64;
+
+/** Pages of one tablespace that a srv_thread_pool task writes during
+a buf_pool.flush_list batch, so that the checksums, encryption and
+compression of the pages are computed by multiple threads */
+struct buf_flush_task_t
+{
+  /** the tablespace; we hold a reference to it */
+  fil_space_t *const space;
+  /** number of elements in pages */
+  ulint n= 0;
+  /** the io-fixed pages */
+  buf_page_t *pages[buf_flush_task_pages];
+  /** the task */
+  tpool::waitable_task task;
+
+  explicit buf_flush_task_t(fil_space_t *space) :
+    space(space), task(write, this)
+  { space->reacquire(); }
+  ~buf_flush_task_t() { space->release(); }
+
+  /** Write the pages in the order of their page numbers.
+  @param arg  buf_flush_task_t */
+  static void write(void *arg)
+  {
+    buf_flush_task_t *t= static_cast<buf_flush_task_t*>(arg);
+    std::sort(t->pages, t->pages + t->n,
+              [](const buf_page_t *a, const buf_page_t *b)
+              { return a->id() < b->id(); });
+    for (ulint i= 0; i < t->n; i++)
+      buf_flush_page_low(t->pages[i], false, t->space);
+  }
+};
+
+/** The buf_flush_task_t of a buf_pool.flush_list batch */
+class buf_flush_tasks_t
+{
+  /** maximum number of tasks in flight */
+  const ulint max_running;
+  /** the tasks in flight, in the order of submission */
+  std::deque<buf_flush_task_t*> running;
+  /** the task that is being filled, or nullptr */
+  buf_flush_task_t *current= nullptr;
+
+  /** Submit the current task. */
+  void submit()
+  {
+    mysql_mutex_assert_not_owner(&buf_pool.mutex);
+    if (running.size() >= max_running)
+    {
+      running.front()->task.wait();
+      delete running.front();
+      running.pop_front();
+    }
+    running.push_back(current);
+    srv_thread_pool->submit_task(&current->task);
+    current= nullptr;
+  }
+
+public:
+  explicit buf_flush_tasks_t(ulint max_running) : max_running(max_running) {}
+  ~buf_flush_tasks_t() { ut_ad(!current); ut_ad(running.empty()); }
+
+  /** Add an io-fixed page, to be written by a task.
+  buf_pool.mutex must not be held.
+  @param bpage   page to be written
+  @param space   tablespace of bpage */
+  void add(buf_page_t *bpage, fil_space_t *space)
+  {
+    if (current && current->space != space)
+      submit();
+    if (!current)
+      current= new buf_flush_task_t(space);
+    current->pages[current->n++]= bpage;
+    if (current->n == buf_flush_task_pages)
+      submit();
+  }
+
+  /** Submit the last task and wait for all tasks to complete.
+  buf_pool.mutex must not be held. */
+  void finish()
+  {
+    if (current)
+      submit();
+    for (buf_flush_task_t *t : running)
+    {
+      t->task.wait();
+      delete t;
+    }
+    running.clear();
+  }
+};
+
 /** Write a flushable page from buf_pool to a file.
 buf_pool.mutex must be held.
 @param bpage       buffer control block
 @param lru         true=buf_pool.LRU; false=buf_pool.flush_list
 @param space       tablespace
+@param tasks       tasks to write the page, or nullptr to write it here
 @return whether the page was flushed and buf_pool.mutex was released */
-static bool buf_flush_page(buf_page_t *bpage, bool lru, fil_space_t *space)
+static bool buf_flush_page(buf_page_t *bpage, bool lru, fil_space_t *space,
+                           buf_flush_tasks_t *tasks= nullptr)
 {
   ut_ad(bpage->in_file());
   ut_ad(bpage->ready_for_flush());
@@ -890,74 +1073,15 @@ static bool buf_flush_page(buf_page_t *bpage, bool lru, fil_space_t *space)
   }
 
   if (status == buf_page_t::FREED)
-    buf_release_freed_page(&block->page);
-  else
   {
-    space->reacquire();
-    ut_ad(status == buf_page_t::NORMAL || status == buf_page_t::INIT_ON_FLUSH);
-    size_t size;
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-    size_t orig_size;
-#endif
-    IORequest::Type type= lru ? IORequest::WRITE_LRU : IORequest::WRITE_ASYNC;
-
-    if (UNIV_UNLIKELY(!rw_lock)) /* ROW_FORMAT=COMPRESSED */
-    {
-      ut_ad(!space->full_crc32());
-      ut_ad(!space->is_compressed()); /* not page_compressed */
-      size= bpage->zip_size();
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      orig_size= size;
-#endif
-      buf_flush_update_zip_checksum(frame, size);
-      frame= buf_page_encrypt(space, bpage, frame, &size);
-      ut_ad(size == bpage->zip_size());
-    }
-    else
-    {
-      byte *page= block->frame;
-      size= block->physical_size();
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      orig_size= size;
-#endif
-
-      if (space->full_crc32())
-      {
-        /* innodb_checksum_algorithm=full_crc32 is not implemented for
-        ROW_FORMAT=COMPRESSED pages. */
-        ut_ad(!frame);
-	page= buf_page_encrypt(space, bpage, page, &size);
-	buf_flush_init_for_writing(block, page, nullptr, true);
-      }
-      else
-      {
-        buf_flush_init_for_writing(block, page, frame ? &bpage->zip : nullptr,
-                                   false);
-        page= buf_page_encrypt(space, bpage, frame ? frame : page, &size);
-      }
-
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      if (size != orig_size && space->punch_hole)
-        type= lru ? IORequest::PUNCH_LRU : IORequest::PUNCH;
-#endif
-      frame=page;
-    }
-
-    ut_ad(status == bpage->status);
-
-    if (lru)
-      buf_pool.n_flush_LRU++;
-    else
-      buf_pool.n_flush_list++;
-    if (status != buf_page_t::NORMAL || !space->use_doublewrite())
-      space->io(IORequest(type, bpage),
-                bpage->physical_offset(), size, frame, bpage);
-    else
-      buf_dblwr.add_to_batch(IORequest(bpage, space->chain.start, type), size);
+    buf_release_freed_page(&block->page);
+    buf_LRU_stat_inc_io();
   }
+  else if (tasks)
+    tasks->add(bpage, space);
+  else
+    buf_flush_page_low(bpage, lru, space);
 
-  /* Increment the I/O operation count used for selecting LRU policy. */
-  buf_LRU_stat_inc_io();
   return true;
 }
 
@@ -1402,6 +1526,11 @@ static ulint buf_do_flush_list_batch(ulint max_n, lsn_t lsn)
   uint32_t last_space_id= FIL_NULL;
   static_assert(FIL_NULL > SRV_TMP_SPACE_ID, "consistency");
   static_assert(FIL_NULL > SRV_SPACE_ID_UPPER_BOUND, "consistency");
+  /* Let up to innodb_write_io_threads tasks prepare and submit the
+  page writes, so that the page cleaner only has to pick the pages. */
+  buf_flush_tasks_t tasks(srv_n_write_io_threads);
+  buf_flush_tasks_t *const parallel= srv_n_write_io_threads > 1
+    ? &tasks : nullptr;
 
   /* Start from the end of the list looking for a suitable block to be
   flushed. */
@@ -1461,7 +1590,7 @@ static ulint buf_do_flush_list_batch(ulint max_n, lsn_t lsn)
 reacquire_mutex:
         mysql_mutex_lock(&buf_pool.mutex);
       }
-      else if (buf_flush_page(bpage, false, space))
+      else if (buf_flush_page(bpage, false, space, parallel))
       {
         ++count;
         goto reacquire_mutex;
@@ -1475,6 +1604,13 @@ static ulint buf_do_flush_list_batch(ulint max_n, lsn_t lsn)
   buf_pool.flush_hp.set(nullptr);
   mysql_mutex_unlock(&buf_pool.flush_list_mutex);
 
+  if (parallel)
+  {
+    mysql_mutex_unlock(&buf_pool.mutex);
+    tasks.finish();
+    mysql_mutex_lock(&buf_pool.mutex);
+  }
+
   if (space)
     space->release();
 
@@ -1659,6 +1795,7 @@ static bool log_checkpoint_low(lsn_t oldest_lsn, lsn_t end_lsn)
   log_sys.next_checkpoint_lsn= oldest_lsn;
   log_write_checkpoint_info(end_lsn);
   mysql_mutex_assert_not_owner(&log_sys.mutex);
+  log_online_write();
 
   return true;
 }
@@ -717,6 +717,62 @@ buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf)
   return count;
 }
 
+/** Read in the background the first read-ahead area of a single-table
+tablespace, before a table scan of it starts.
+@param[in]	space_id	tablespace id
+@param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_scan(ulint space_id, ulint zip_size)
+{
+  /* check if readahead is disabled */
+  if (!srv_read_ahead_threshold)
+    return 0;
+
+  if (srv_startup_is_before_trx_rollback_phase)
+    /* No read-ahead to avoid thread deadlocks */
+    return 0;
+
+  /* The start of a shared tablespace does not belong to any table */
+  if (is_predefined_tablespace(space_id))
+    return 0;
+
+  if (buf_pool.n_pend_reads > buf_pool.curr_size / BUF_READ_AHEAD_PEND_LIMIT)
+    return 0;
+
+  fil_space_t *space= fil_space_t::get(space_id);
+  if (!space)
+    return 0;
+
+  const page_id_t low(space_id, 0);
+  page_id_t high= low + buf_pool.read_ahead_area;
+  high.set_page_no(std::min(high.page_no(), space->last_page_number()));
+
+  ulint count= 0;
+  for (page_id_t i= low; i < high; ++i)
+  {
+    if (ibuf_bitmap_page(i, zip_size))
+      continue;
+    if (space->is_stopping())
+      break;
+    dberr_t err;
+    space->reacquire();
+    count+= buf_read_page_low(&err, space, false, BUF_READ_ANY_PAGE, i,
+                              zip_size, false);
+  }
+
+  if (count)
+    DBUG_PRINT("ib_buf", ("scan read-ahead %zu pages from %s",
+                          count, space->chain.start->name));
+  space->release();
+
+  /* Read ahead is considered one I/O operation for the purpose of
+  LRU policy decision. */
+  buf_LRU_stat_inc_io();
+
+  buf_pool.stat.n_ra_pages_read+= count;
+  return count;
+}
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
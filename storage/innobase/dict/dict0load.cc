@@ -45,6 +45,9 @@ Created 4/24/1996 Heikki Tuuri
 #include "srv0srv.h"
 #include "fts0opt.h"
 
+#include <atomic>
+#include <vector>
+
 /** Following are the InnoDB system tables. The positions in
 this array are referenced by enum dict_system_table_id. */
 static const char* SYSTEM_TABLE_NAME[] = {
@@ -975,6 +978,100 @@ dict_sys_tables_rec_read(
 	return(true);
 }
 
+/** A file-per-table tablespace that dict_check_sys_tables() opens */
+struct dict_check_space_t
+{
+	/** tablespace identifier */
+	ulint		id;
+	/** SYS_TABLES.TYPE */
+	ulint		flags;
+	/** table name; owned by this object */
+	table_name_t	name;
+};
+
+/** Tablespaces that are being opened by dict_check_open_spaces() */
+struct dict_check_open_ctx_t
+{
+	/** the tablespaces */
+	const dict_check_space_t*	spaces;
+	/** number of spaces */
+	ulint				n_spaces;
+	/** index of the next space to open */
+	std::atomic<ulint>		next;
+};
+
+/** Minimum number of tablespaces per thread in dict_check_open_spaces() */
+static constexpr ulint DICT_CHECK_SPACES_PER_THREAD = 256;
+
+/** Open tablespaces from a dict_check_open_ctx_t until none are left.
+@param arg	dict_check_open_ctx_t */
+static void dict_check_open_worker(void* arg)
+{
+	dict_check_open_ctx_t*	ctx = static_cast<dict_check_open_ctx_t*>(arg);
+
+	for (;;) {
+		const ulint	i = ctx->next.fetch_add(
+			1, std::memory_order_relaxed);
+
+		if (i >= ctx->n_spaces) {
+			break;
+		}
+
+		const dict_check_space_t&	space = ctx->spaces[i];
+		char*	filepath = fil_make_filepath(
+			NULL, space.name.m_name, IBD, false);
+
+		/* Check that the .ibd file exists. */
+		if (!fil_ibd_open(
+			    false,
+			    FIL_TYPE_TABLESPACE,
+			    space.id, dict_tf_to_fsp_flags(space.flags),
+			    space.name, filepath)) {
+			ib::warn() << "Ignoring tablespace for "
+				<< space.name
+				<< " because it could not be opened.";
+		}
+
+		ut_free(filepath);
+	}
+}
+
+/** Open the tablespaces that were found in SYS_TABLES.
+Opening a file and reading its first page is dominated by I/O latency,
+and fil_ibd_open() only serializes on fil_system.mutex to register the
+tablespace, so with many .ibd files the work is spread over
+innodb_read_io_threads threads of srv_thread_pool.
+@param spaces	the tablespaces to open */
+static void dict_check_open_spaces(
+	const std::vector<dict_check_space_t>& spaces)
+{
+	dict_check_open_ctx_t	ctx;
+
+	ctx.spaces = spaces.data();
+	ctx.n_spaces = spaces.size();
+	ctx.next = 0;
+
+	ulint	n_threads = std::min<ulint>(
+		srv_n_read_io_threads,
+		spaces.size() / DICT_CHECK_SPACES_PER_THREAD);
+
+	std::vector<tpool::waitable_task*>	tasks;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		tpool::waitable_task*	task = new tpool::waitable_task(
+			dict_check_open_worker, &ctx);
+		srv_thread_pool->submit_task(task);
+		tasks.push_back(task);
+	}
+
+	dict_check_open_worker(&ctx);
+
+	for (tpool::waitable_task* task : tasks) {
+		task->wait();
+		delete task;
+	}
+}
+
 /** Load and check each non-predefined tablespace mentioned in SYS_TABLES.
 Search SYS_TABLES and check each tablespace mentioned that has not
 already been added to the fil_system.  If it is valid, add it to the
@@ -986,6 +1083,7 @@ static ulint dict_check_sys_tables()
 	btr_pcur_t	pcur;
 	const rec_t*	rec;
 	mtr_t		mtr;
+	std::vector<dict_check_space_t>	spaces;
 
 	DBUG_ENTER("dict_check_sys_tables");
 
@@ -1057,28 +1155,21 @@ static ulint dict_check_sys_tables()
 			goto next;
 		}
 
-		char*	filepath = fil_make_filepath(
-			NULL, table_name.m_name, IBD, false);
-
-		/* Check that the .ibd file exists. */
-		if (!fil_ibd_open(
-			    false,
-			    FIL_TYPE_TABLESPACE,
-			    space_id, dict_tf_to_fsp_flags(flags),
-			    table_name, filepath)) {
-			ib::warn() << "Ignoring tablespace for "
-				<< table_name
-				<< " because it could not be opened.";
-		}
-
 		max_space_id = ut_max(max_space_id, space_id);
 
-		ut_free(filepath);
-		goto next;
+		/* The files are opened after the scan, see
+		dict_check_open_spaces(). */
+		spaces.push_back({space_id, flags, table_name});
 	}
 
 	mtr_commit(&mtr);
 
+	dict_check_open_spaces(spaces);
+
+	for (dict_check_space_t& space : spaces) {
+		ut_free(space.name.m_name);
+	}
+
 	DBUG_RETURN(max_space_id);
 }
 
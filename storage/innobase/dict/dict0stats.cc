@@ -33,8 +33,11 @@ Created Jan 06, 2010 Vasil Dimov
 #include "pars0pars.h"
 #include <mysql_com.h>
 #include "btr0btr.h"
+#include "buf0rea.h"
+#include <my_bit.h>
 
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <vector>
 
@@ -1908,6 +1911,378 @@ dict_stats_index_set_n_diff(
 	}
 }
 
+/** log2 of the number of registers in dict_stats_hll_t */
+static constexpr unsigned DICT_STATS_HLL_BITS = 10;
+
+/** HyperLogLog sketch of the number of distinct hash values. With 1024
+registers the standard error of the estimate is about 3%. */
+class dict_stats_hll_t
+{
+  /** the maximum rank seen for each register */
+  byte reg[1U << DICT_STATS_HLL_BITS];
+public:
+  dict_stats_hll_t() { memset(reg, 0, sizeof reg); }
+
+  /** Add a value.
+  @param h  64-bit hash of the value, with all bits well mixed */
+  void add(uint64_t h)
+  {
+    const ulint i= ulint(h >> (64 - DICT_STATS_HLL_BITS));
+    /* The rank is 1 + the number of leading zero bits of the rest
+    of the hash; the extra bit limits it. */
+    const uint64_t w= h << DICT_STATS_HLL_BITS |
+      1ULL << (DICT_STATS_HLL_BITS - 1);
+    const byte rank= byte(64 - my_bit_log2_uint64(w));
+    if (rank > reg[i])
+      reg[i]= rank;
+  }
+
+  /** @return the estimated number of distinct values */
+  double estimate() const
+  {
+    const double m= double(1U << DICT_STATS_HLL_BITS);
+    double sum= 0;
+    ulint zeros= 0;
+    for (byte r : reg)
+    {
+      sum+= std::ldexp(1.0, -int(r));
+      zeros+= !r;
+    }
+    const double e= 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    /* For small cardinalities, linear counting is more accurate. */
+    return e <= 2.5 * m && zeros ? m * std::log(m / double(zeros)) : e;
+  }
+};
+
+/** Mix the bits of a 64-bit value. */
+static inline uint64_t dict_stats_hash_mix(uint64_t h)
+{
+  h^= h >> 33;
+  h*= 0xff51afd7ed558ccdULL;
+  h^= h >> 33;
+  h*= 0xc4ceb9fe1a85ec53ULL;
+  h^= h >> 33;
+  return h;
+}
+
+/** Compute a hash of an index field, so that values that are equal
+according to cmp_data() get the same hash.
+@param[in]	col	column
+@param[in]	data	field data
+@param[in]	len	length of data, or UNIV_SQL_NULL
+@return hash value */
+static uint64_t
+dict_stats_hash_field(const dict_col_t& col, const byte* data, ulint len)
+{
+	if (len == UNIV_SQL_NULL) {
+		return(0x9e3779b97f4a7c15ULL);
+	}
+
+	CHARSET_INFO*	cs = &my_charset_bin;
+
+	switch (col.mtype) {
+	case DATA_FIXBINARY:
+	case DATA_BINARY:
+		if (dtype_get_charset_coll(col.prtype)
+		    != DATA_MYSQL_BINARY_CHARSET_COLL) {
+			/* Trailing spaces are not significant. */
+			while (len && data[len - 1] == 0x20) {
+				len--;
+			}
+		}
+		break;
+	case DATA_BLOB:
+		if (col.prtype & DATA_BINARY_TYPE) {
+			break;
+		}
+		/* fall through */
+	case DATA_VARMYSQL:
+	case DATA_MYSQL:
+		if (CHARSET_INFO* c = get_charset(
+			    uint(dtype_get_charset_coll(col.prtype)),
+			    MYF(MY_WME))) {
+			cs = c;
+		}
+		break;
+	case DATA_VARCHAR:
+	case DATA_CHAR:
+		cs = &my_charset_latin1;
+		break;
+	}
+
+	ulong	nr1 = 1;
+	ulong	nr2 = 4;
+	cs->hash_sort(data, len, &nr1, &nr2);
+	return(dict_stats_hash_mix(uint64_t(nr1) ^ uint64_t(nr2) << 32));
+}
+
+/** Calculate the statistics of an index from a uniform random sample of
+its leaf pages (innodb_stats_random_sampling=ON).
+
+The leaf page numbers are collected from the node pointers on level 1,
+latching one page at a time; the index tree latch is only held while
+locating the leftmost page of level 1. The sampled pages are submitted
+for asynchronous reading before the first of them is examined.
+
+For each n-column prefix, the number of distinct values in the sample
+is estimated with a HyperLogLog sketch, and the number of values that
+occur only once in the sample with a second sketch of the values that
+occur more than once on a page. The number of distinct values in the
+whole index is then estimated with the Duj1 estimator of Haas and
+Stokes: n * d / (n - f1 + f1 * n / N), where n is the number of sampled
+records, N the estimated number of records, d the number of distinct
+values in the sample and f1 the number of values that occur only once.
+@param[in]	index	index with at least 2 levels
+@param[in,out]	result	index statistics
+@return whether the statistics were computed */
+static
+bool
+dict_stats_analyze_index_sample(
+	dict_index_t*	index,
+	index_stats_t&	result)
+{
+	const ulint	n_uniq = dict_index_get_n_unique(index);
+	const ulint	n_sample = ulint(std::min<ib_uint64_t>(
+		N_SAMPLE_PAGES(index) * n_uniq, result.n_leaf_pages));
+	const ulint	zip_size = index->table->space->zip_size();
+	const ulint	space_id = index->table->space_id;
+	const ulint	comp = dict_table_is_comp(index->table);
+	std::vector<uint32_t>	sample;
+	/* number of leaf pages, that is, node pointers on level 1 */
+	ib_uint64_t	n_children = 0;
+	mem_heap_t*	heap = NULL;
+	rec_offs	offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs*	offsets = offsets_;
+	dberr_t		err;
+	mtr_t		mtr;
+
+	rec_offs_init(offsets_);
+	sample.reserve(n_sample);
+
+	/* Find the leftmost page of level 1. */
+	mtr.start();
+	mtr_s_lock_index(index, &mtr);
+
+	uint32_t	page_no = index->page;
+
+	for (;;) {
+		const buf_block_t*	block = btr_block_get(
+			*index, page_no, RW_S_LATCH, false, &mtr);
+
+		if (!block) {
+			page_no = FIL_NULL;
+			break;
+		}
+
+		const ulint	level = btr_page_get_level(block->frame);
+		const rec_t*	rec = page_rec_get_next_const(
+			page_get_infimum_rec(block->frame));
+
+		if (level == 1) {
+			break;
+		} else if (level == 0 || page_rec_is_supremum(rec)) {
+			page_no = FIL_NULL;
+			break;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets, false,
+					  ULINT_UNDEFINED, &heap);
+		page_no = btr_node_ptr_get_child_page_no(rec, offsets);
+	}
+
+	mtr.commit();
+
+	/* Pick a uniform random sample of the child page numbers. */
+	while (page_no != FIL_NULL) {
+		mtr.start();
+
+		const buf_block_t*	block = buf_page_get_gen(
+			page_id_t(space_id, page_no), zip_size, RW_S_LATCH,
+			NULL, BUF_GET_POSSIBLY_FREED, &mtr, &err);
+
+		/* Without the tree latch, the page may have been freed
+		or reused after we read its page number. Then we will
+		sample the part of the index that we have seen. */
+		if (!block
+		    || !fil_page_index_page_check(block->frame)
+		    || btr_page_get_index_id(block->frame) != index->id
+		    || btr_page_get_level(block->frame) != 1) {
+			mtr.commit();
+			break;
+		}
+
+		for (const rec_t* rec = page_rec_get_next_const(
+			     page_get_infimum_rec(block->frame));
+		     !page_rec_is_supremum(rec);
+		     rec = page_rec_get_next_const(rec)) {
+			offsets = rec_get_offsets(rec, index, offsets, false,
+						  ULINT_UNDEFINED, &heap);
+			const uint32_t	child
+				= btr_node_ptr_get_child_page_no(rec, offsets);
+
+			if (sample.size() < n_sample) {
+				sample.push_back(child);
+			} else {
+				const ib_uint64_t	j
+					= (ib_uint64_t(ut_rnd_gen()) << 32
+					   | ut_rnd_gen()) % (n_children + 1);
+				if (j < n_sample) {
+					sample[ulint(j)] = child;
+				}
+			}
+
+			n_children++;
+		}
+
+		page_no = btr_page_get_next(block->frame);
+		mtr.commit();
+	}
+
+	if (sample.empty()) {
+		if (heap) {
+			mem_heap_free(heap);
+		}
+		return(false);
+	}
+
+	/* Submit all the reads at once, in ascending page order. */
+	std::sort(sample.begin(), sample.end());
+
+	fil_space_t*	space = index->table->space;
+
+	for (uint32_t p : sample) {
+		if (space->acquire()) {
+			buf_read_page_background(space,
+						 page_id_t(space_id, p),
+						 zip_size, false);
+		}
+	}
+
+	std::vector<dict_stats_hll_t>	all(n_uniq);
+	std::vector<dict_stats_hll_t>	multi(n_uniq);
+	std::vector<uint64_t>		prev(n_uniq);
+	std::vector<ib_uint64_t>	run(n_uniq);
+	ib_uint64_t	n_recs = 0;
+	ib_uint64_t	n_pages = 0;
+
+	for (uint32_t p : sample) {
+		mtr.start();
+
+		const buf_block_t*	block = buf_page_get_gen(
+			page_id_t(space_id, p), zip_size, RW_S_LATCH,
+			NULL, BUF_GET_POSSIBLY_FREED, &mtr, &err,
+			!index->is_clust());
+
+		if (!block
+		    || !fil_page_index_page_check(block->frame)
+		    || btr_page_get_index_id(block->frame) != index->id
+		    || !page_is_leaf(block->frame)) {
+			mtr.commit();
+			continue;
+		}
+
+		n_pages++;
+
+		bool	first = true;
+
+		for (const rec_t* rec = page_rec_get_next_const(
+			     page_get_infimum_rec(block->frame));
+		     !page_rec_is_supremum(rec);
+		     rec = page_rec_get_next_const(rec)) {
+			/* Skip delete-marked records for the same
+			reason as dict_stats_analyze_index_level(). */
+			if (rec_is_metadata(rec, *index)
+			    || (!srv_stats_include_delete_marked
+				&& rec_get_deleted_flag(rec, comp))) {
+				continue;
+			}
+
+			offsets = rec_get_offsets(rec, index, offsets, true,
+						  n_uniq, &heap);
+			n_recs++;
+
+			uint64_t	h = 0x2545f4914f6cdd1dULL;
+
+			for (ulint i = 0; i < n_uniq; i++) {
+				ulint		len;
+				const byte*	data = rec_get_nth_field(
+					rec, offsets, i, &len);
+
+				h = dict_stats_hash_mix(
+					h ^ dict_stats_hash_field(
+						*dict_index_get_nth_col(
+							index, i),
+						data, len));
+
+				if (first) {
+				} else if (h == prev[i]) {
+					run[i]++;
+					continue;
+				} else {
+					/* The group of prev[i] ended. */
+					all[i].add(prev[i]);
+					if (run[i] > 1) {
+						multi[i].add(prev[i]);
+					}
+				}
+
+				prev[i] = h;
+				run[i] = 1;
+			}
+
+			first = false;
+		}
+
+		if (!first) {
+			for (ulint i = 0; i < n_uniq; i++) {
+				all[i].add(prev[i]);
+				if (run[i] > 1) {
+					multi[i].add(prev[i]);
+				}
+			}
+		}
+
+		mtr.commit();
+	}
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	if (!n_pages) {
+		return(false);
+	}
+
+	DEBUG_PRINTF("  %s(): sampled " UINT64PF " of " UINT64PF
+		     " leaf pages, " UINT64PF " records\n",
+		     __func__, n_pages, n_children, n_recs);
+
+	/* Unlike in dict_stats_index_set_n_diff(), the number of leaf
+	pages that contain records is known from level 1, and externally
+	stored pages in the leaf segment do not need to be estimated. */
+	const double	n = double(n_recs);
+	const double	N = std::max(double(n_children) * n
+				     / double(n_pages), n);
+
+	for (ulint i = 0; i < n_uniq; i++) {
+		double	n_diff = 0;
+
+		if (n_recs) {
+			const double	d = std::min(all[i].estimate(), n);
+			const double	f1 = d - std::min(multi[i].estimate(),
+							  d);
+
+			n_diff = n * d / (n - f1 + f1 * n / N);
+			n_diff = std::min(std::max(n_diff, d), N);
+		}
+
+		result.stats[i].n_diff_key_vals = ib_uint64_t(n_diff + 0.5);
+		result.stats[i].n_sample_sizes = n_pages;
+	}
+
+	return(true);
+}
+
 /** Calculates new statistics for a given index and saves them to the index
 members stat_n_diff_key_vals[], stat_n_sample_sizes[], stat_index_size and
 stat_n_leaf_pages. This function can be slow.
@@ -2014,6 +2389,18 @@ static index_stats_t dict_stats_analyze_index(dict_index_t* index)
 		DBUG_RETURN(result);
 	}
 
+	if (srv_stats_random_sampling) {
+		mtr.commit();
+
+		if (dict_stats_analyze_index_sample(index, result)) {
+			DBUG_RETURN(result);
+		}
+
+		mtr.start();
+		mtr_sx_lock_index(index, &mtr);
+		root_level = btr_height_get(index, &mtr);
+	}
+
 	/* For each level that is being scanned in the btree, this contains the
 	number of different key values for all possible n-column prefixes. */
 	ib_uint64_t*	n_diff_on_level = UT_NEW_ARRAY(
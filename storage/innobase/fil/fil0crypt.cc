@@ -32,6 +32,7 @@ Modified           Jan Lindström jan.lindstrom@mariadb.com
 # include "buf0buf.h"
 #else
 #include "buf0dblwr.h"
+#include "buf0rea.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "mtr0mtr.h"
@@ -1893,6 +1894,23 @@ fil_crypt_rotate_pages(
 
 	ut_ad(state->space->referenced());
 
+	/* Submit asynchronous reads for the whole batch, so that
+	fil_crypt_rotate_page() does not have to wait for each page
+	to be read synchronously. The batch size is already bounded by
+	innodb_encryption_rotation_iops. */
+	const ulint zip_size = state->space->zip_size();
+	for (uint32_t offset = state->offset; offset < end; offset++) {
+		const page_id_t page_id(space_id, offset);
+		if (buf_dblwr.is_inside(page_id)
+		    || state->space->is_stopping()) {
+			continue;
+		}
+		if (state->space->acquire()) {
+			buf_read_page_background(state->space, page_id,
+						 zip_size, false);
+		}
+	}
+
 	for (; state->offset < end; state->offset++) {
 
 		/* we can't rotate pages in dblwr buffer as
@@ -26,6 +26,7 @@ Created 10/25/1995 Heikki Tuuri
 
 #include "fil0fil.h"
 #include "fil0crypt.h"
+#include "fil0pagecompress.h"
 
 #include "btr0btr.h"
 #include "buf0buf.h"
@@ -68,9 +69,13 @@ inline bool fil_is_user_tablespace_id(ulint space_id)
 bool fil_space_t::try_to_close(bool print_info)
 {
   mysql_mutex_assert_owner(&fil_system.mutex);
-  for (fil_space_t *space= UT_LIST_GET_FIRST(fil_system.space_list); space;
-       space= UT_LIST_GET_NEXT(space_list, space))
+  /* The first closed file that was moved to the end of the list */
+  const fil_space_t *moved= nullptr;
+  for (fil_space_t *space= UT_LIST_GET_FIRST(fil_system.space_list), *next;
+       space && space != moved; space= next)
   {
+    next= UT_LIST_GET_NEXT(space_list, space);
+
     switch (space->purpose) {
     case FIL_TYPE_TEMPORARY:
       continue;
@@ -90,7 +95,21 @@ bool fil_space_t::try_to_close(bool print_info)
     ut_ad(!UT_LIST_GET_NEXT(chain, node));
 
     if (!node->is_open())
+    {
+      /* Move closed files to the end of the list, so that the next
+      call does not have to skip them again. With many more tablespaces
+      than innodb_open_files, the list would otherwise start with a long
+      run of closed files. fil_node_open_file_low() moves the file to
+      the end anyway when it is opened again. */
+      if (UNIV_LIKELY(!fil_system.freeze_space_list))
+      {
+        UT_LIST_REMOVE(fil_system.space_list, space);
+        UT_LIST_ADD_LAST(fil_system.space_list, space);
+        if (!moved)
+          moved= space;
+      }
       continue;
+    }
 
     if (const auto n= space->set_closing())
     {
@@ -297,6 +316,9 @@ static bool fil_comp_algo_validate(const fil_space_t* space)
 #ifdef HAVE_SNAPPY
 	case PAGE_SNAPPY_ALGORITHM:
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+#endif /* HAVE_ZSTD */
 		return true;
 	}
 
@@ -851,6 +873,7 @@ fil_space_free_low(
 	ut_ad(space->size == 0);
 
 	fil_space_destroy_crypt_data(&space->crypt_data);
+	fil_zstd_dict_free(space->zstd_dict);
 
 	space->~fil_space_t();
 	ut_free(space->name);
@@ -2690,6 +2713,10 @@ fil_ibd_open(
 		goto error;
 	}
 
+	if (first_page) {
+		space->zstd_dict = fil_zstd_dict_read(flags, first_page);
+	}
+
 	/* We do not measure the size of the file, that is why
 	we pass the 0 below */
 
@@ -3043,6 +3070,10 @@ fil_ibd_load(
 		return(FIL_LOAD_INVALID);
 	}
 
+	if (first_page) {
+		space->zstd_dict = fil_zstd_dict_read(flags, first_page);
+	}
+
 	ut_ad(space->id == file.space_id());
 	ut_ad(space->id == space_id);
 
@@ -70,6 +70,229 @@ Updated 14/02/2015
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#include <vector>
+
+/** Offset of the zstd dictionary from the encryption metadata in the
+first page of a tablespace; the bytes in between are reserved for
+fil_space_crypt_t::write_page0() */
+#define FIL_ZSTD_DICT_OFFSET	64
+
+/** Size of the zstd dictionary header: magic and length */
+#define FIL_ZSTD_DICT_HEADER	6
+
+/** Magic bytes of the zstd dictionary header */
+static const byte FIL_ZSTD_DICT_MAGIC[4] = {'Z', 'D', 'I', 'C'};
+
+/** @return the offset of the zstd dictionary header in the first page */
+static ulint fil_zstd_dict_offset()
+{
+	/* page_compressed excludes ROW_FORMAT=COMPRESSED */
+	return FSP_HEADER_OFFSET + fsp_header_get_encryption_offset(0)
+		+ FIL_ZSTD_DICT_OFFSET;
+}
+
+/** @return the maximum size of a zstd dictionary */
+static ulint fil_zstd_dict_max_size()
+{
+	return std::min<ulint>(srv_page_size / 4,
+			       srv_page_size - FIL_PAGE_DATA_END
+			       - FIL_ZSTD_DICT_HEADER
+			       - fil_zstd_dict_offset());
+}
+
+/** Trained zstd dictionary for page_compressed pages */
+struct fil_zstd_dict_t
+{
+	/** dictionary identifier, as stored in the zstd frame headers */
+	unsigned	id;
+	/** compression level of cdict */
+	int		level;
+	/** digested dictionary for compressing at level */
+	ZSTD_CDict*	cdict;
+	/** digested dictionary for decompressing */
+	ZSTD_DDict*	ddict;
+	/** size of data, in bytes */
+	size_t		size;
+	/** the dictionary (allocated together with this structure) */
+	byte*		data;
+};
+
+/** Create a zstd dictionary.
+@param[in]	data	trained dictionary
+@param[in]	size	size of data, in bytes
+@param[in]	flags	tablespace flags
+@return the dictionary
+@retval	nullptr	if the dictionary is not valid */
+static fil_zstd_dict_t* fil_zstd_dict_create(
+	const byte*	data,
+	size_t		size,
+	ulint		flags)
+{
+	fil_zstd_dict_t* dict = static_cast<fil_zstd_dict_t*>(
+		ut_zalloc_nokey(sizeof *dict + size));
+	if (!dict) {
+		return nullptr;
+	}
+
+	ulint level = FSP_FLAGS_GET_PAGE_COMPRESSION_LEVEL(flags);
+	if (level == 0) {
+		level = page_zip_level;
+	}
+
+	dict->id = ZDICT_getDictID(data, size);
+	dict->level = int(level);
+	dict->size = size;
+	dict->data = reinterpret_cast<byte*>(dict + 1);
+	memcpy(dict->data, data, size);
+
+	/* A dictionary without an identifier would be accepted for
+	decompressing pages that were compressed without it. */
+	if (dict->id
+	    && (dict->cdict = ZSTD_createCDict(dict->data, size, dict->level))
+	    && (dict->ddict = ZSTD_createDDict(dict->data, size))) {
+		return dict;
+	}
+
+	fil_zstd_dict_free(dict);
+	return nullptr;
+}
+
+/** Write a zstd dictionary to the first page of a tablespace and start
+using it for compressing pages.
+@param[in,out]	space	tablespace
+@param[in,out]	dict	dictionary
+@return whether the dictionary was installed */
+static bool fil_zstd_dict_install(fil_space_t* space, fil_zstd_dict_t* dict)
+{
+	ut_ad(!space->zstd_dict);
+
+	mtr_t	mtr;
+	mtr.start();
+	mtr.set_named_space(space);
+
+	buf_block_t* block = buf_page_get_gen(
+		page_id_t(space->id, 0), space->zip_size(), RW_X_LATCH,
+		nullptr, BUF_GET_POSSIBLY_FREED, &mtr);
+
+	if (!block) {
+		mtr.commit();
+		return false;
+	}
+
+	const ulint offset = fil_zstd_dict_offset();
+	byte header[FIL_ZSTD_DICT_HEADER];
+	memcpy(header, FIL_ZSTD_DICT_MAGIC, sizeof FIL_ZSTD_DICT_MAGIC);
+	mach_write_to_2(header + sizeof FIL_ZSTD_DICT_MAGIC, dict->size);
+
+	mtr.memcpy(*block, block->frame + offset, header, sizeof header);
+	mtr.memcpy(*block, block->frame + offset + sizeof header,
+		   dict->data, dict->size);
+	mtr.commit();
+
+	/* A page that was compressed with the dictionary must never
+	reach the file before the dictionary does. Write and sync the
+	first page now, because the dictionary is loaded from the file
+	before any redo log is applied. */
+	while (buf_flush_dirty_pages(space->id));
+	space->flush<false>();
+
+	space->zstd_dict.store(dict, std::memory_order_release);
+	return true;
+}
+#endif /* HAVE_ZSTD */
+
+/** Read the zstd dictionary from the first page of a tablespace.
+@param[in]	flags	tablespace flags
+@param[in]	page	first page of the tablespace
+@return the dictionary
+@retval	nullptr	if the page does not contain a usable dictionary */
+fil_zstd_dict_t* fil_zstd_dict_read(ulint flags, const byte* page)
+{
+#ifdef HAVE_ZSTD
+	if (!fil_space_t::is_compressed(flags)) {
+		return nullptr;
+	}
+
+	const byte* b = page + fil_zstd_dict_offset();
+
+	if (memcmp(b, FIL_ZSTD_DICT_MAGIC, sizeof FIL_ZSTD_DICT_MAGIC)) {
+		return nullptr;
+	}
+
+	const ulint size = mach_read_from_2(b + sizeof FIL_ZSTD_DICT_MAGIC);
+
+	if (size && size <= fil_zstd_dict_max_size()) {
+		if (fil_zstd_dict_t* dict = fil_zstd_dict_create(
+			    b + FIL_ZSTD_DICT_HEADER, size, flags)) {
+			return dict;
+		}
+	}
+
+	ib::error() << "Ignoring a corrupted zstd dictionary in tablespace "
+		    << mach_read_from_4(page + FIL_PAGE_SPACE_ID);
+#endif /* HAVE_ZSTD */
+	return nullptr;
+}
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary returned by fil_zstd_dict_read(),
+			or nullptr */
+void fil_zstd_dict_free(fil_zstd_dict_t* dict)
+{
+#ifdef HAVE_ZSTD
+	if (dict) {
+		ZSTD_freeCDict(dict->cdict);
+		ZSTD_freeDDict(dict->ddict);
+		ut_free(dict);
+	}
+#else
+	ut_ad(!dict);
+#endif /* HAVE_ZSTD */
+}
+
+/** Train a zstd dictionary for a page_compressed tablespace, write it
+to the first page and start using it for compressing pages.
+@param[in,out]	space	tablespace that does not have a dictionary yet
+@param[in]	samples	uncompressed pages, concatenated
+@param[in]	n	number of pages in samples
+@return whether a dictionary was installed */
+bool fil_zstd_dict_train(fil_space_t* space, const byte* samples, ulint n)
+{
+#ifdef HAVE_ZSTD
+	const ulint		max_size = fil_zstd_dict_max_size();
+	byte*			buf = static_cast<byte*>(
+		ut_malloc_nokey(max_size));
+	std::vector<size_t>	sizes(n, srv_page_size);
+	bool			installed = false;
+
+	if (!buf) {
+		return false;
+	}
+
+	size_t size = ZDICT_trainFromBuffer(buf, max_size, samples,
+					    sizes.data(), unsigned(n));
+
+	if (ZDICT_isError(size)) {
+		ib::warn() << "Could not train a zstd dictionary for "
+			   << space->name << ": "
+			   << ZDICT_getErrorName(size);
+	} else if (fil_zstd_dict_t* dict = fil_zstd_dict_create(
+			   buf, size, space->flags)) {
+		installed = fil_zstd_dict_install(space, dict);
+		if (!installed) {
+			fil_zstd_dict_free(dict);
+		}
+	}
+
+	ut_free(buf);
+	return installed;
+#else
+	return false;
+#endif /* HAVE_ZSTD */
+}
 
 /** Compress a page for the given compression algorithm.
 @param[in]	buf		page to be compressed
@@ -77,14 +300,16 @@ Updated 14/02/2015
 @param[in]	header_len	header length of the page
 @param[in]	comp_algo	compression algorithm
 @param[in]	comp_level	compression level
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page data
 @retval 0 if the page was not compressed */
 static ulint fil_page_compress_low(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		header_len,
-	ulint		comp_algo,
-	unsigned	comp_level)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			header_len,
+	ulint			comp_algo,
+	unsigned		comp_level,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint write_size = srv_page_size - header_len;
 
@@ -180,6 +405,39 @@ static ulint fil_page_compress_low(
 		break;
 	}
 #endif /* HAVE_SNAPPY */
+
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM: {
+		ZSTD_CCtx* cctx = ZSTD_createCCtx();
+		if (!cctx) {
+			break;
+		}
+
+		size_t len;
+
+		if (!dict) {
+			len = ZSTD_compressCCtx(
+				cctx, out_buf + header_len, write_size,
+				buf, srv_page_size, int(comp_level));
+		} else if (dict->level == int(comp_level)) {
+			len = ZSTD_compress_usingCDict(
+				cctx, out_buf + header_len, write_size,
+				buf, srv_page_size, dict->cdict);
+		} else {
+			len = ZSTD_compress_usingDict(
+				cctx, out_buf + header_len, write_size,
+				buf, srv_page_size, dict->data, dict->size,
+				int(comp_level));
+		}
+
+		ZSTD_freeCCtx(cctx);
+
+		if (!ZSTD_isError(len) && len <= write_size) {
+			return len;
+		}
+		break;
+	}
+#endif /* HAVE_ZSTD */
 	}
 
 	return 0;
@@ -190,14 +448,16 @@ static ulint fil_page_compress_low(
 @param[out]	out_buf		compressed page
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page
 @retval 0 if the page was not compressed */
 static ulint fil_page_compress_for_full_crc32(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint comp_level = FSP_FLAGS_GET_PAGE_COMPRESSION_LEVEL(flags);
 
@@ -210,7 +470,7 @@ static ulint fil_page_compress_for_full_crc32(
 	ulint write_size = fil_page_compress_low(
 		buf, out_buf, header_len,
 		fil_space_t::get_compression_algo(flags),
-		static_cast<unsigned>(comp_level));
+		static_cast<unsigned>(comp_level), dict);
 
 	if (write_size == 0) {
 fail:
@@ -264,14 +524,16 @@ static ulint fil_page_compress_for_full_crc32(
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page
 @retval        0       if the page was not compressed */
 static ulint fil_page_compress_for_non_full_crc32(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	uint comp_level = static_cast<uint>(
 		FSP_FLAGS_GET_PAGE_COMPRESSION_LEVEL(flags));
@@ -291,7 +553,7 @@ static ulint fil_page_compress_for_non_full_crc32(
 
 	ulint write_size = fil_page_compress_low(
 				buf, out_buf,
-				header_len, comp_algo, comp_level);
+				header_len, comp_algo, comp_level, dict);
 
 	if (write_size == 0) {
 		srv_stats.pages_page_compression_error.inc();
@@ -373,14 +635,16 @@ static ulint fil_page_compress_for_non_full_crc32(
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return actual length of compressed page
 @retval	0	if the page was not compressed */
 ulint fil_page_compress(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	/* The full_crc32 page_compressed format assumes this. */
 	ut_ad(!(block_size & 255));
@@ -398,11 +662,12 @@ ulint fil_page_compress(
 
 	if (fil_space_t::full_crc32(flags)) {
 		return fil_page_compress_for_full_crc32(
-				buf, out_buf, flags, block_size, encrypted);
+				buf, out_buf, flags, block_size, encrypted,
+				dict);
 	}
 
 	return fil_page_compress_for_non_full_crc32(
-			buf, out_buf, flags, block_size, encrypted);
+			buf, out_buf, flags, block_size, encrypted, dict);
 }
 
 /** Decompress a page that may be subject to page_compressed compression.
@@ -411,13 +676,15 @@ ulint fil_page_compress(
 @param[in]	comp_algo	compression algorithm
 @param[in]	header_len	header length of the page
 @param[in]	actual size	actual size of the page
+@param[in]	dict		zstd dictionary, or nullptr
 @retval true if the page is decompressed or false */
 static bool fil_page_decompress_low(
-	byte*		tmp_buf,
-	byte*		buf,
-	ulint		comp_algo,
-	ulint		header_len,
-	ulint		actual_size)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			comp_algo,
+	ulint			header_len,
+	ulint			actual_size,
+	const fil_zstd_dict_t*	dict)
 {
 	switch (comp_algo) {
 	default:
@@ -490,6 +757,35 @@ static bool fil_page_decompress_low(
 				&& olen == srv_page_size;
 		}
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+		{
+			const byte* src = buf + header_len;
+			const unsigned id = ZSTD_getDictID_fromFrame(
+				src, actual_size);
+
+			if (id && (!dict || dict->id != id)) {
+				ib::error() << "Missing zstd dictionary "
+					    << id;
+				return false;
+			}
+
+			ZSTD_DCtx* dctx = ZSTD_createDCtx();
+			if (!dctx) {
+				return false;
+			}
+
+			size_t len = id
+				? ZSTD_decompress_usingDDict(
+					dctx, tmp_buf, srv_page_size,
+					src, actual_size, dict->ddict)
+				: ZSTD_decompressDCtx(
+					dctx, tmp_buf, srv_page_size,
+					src, actual_size);
+			ZSTD_freeDCtx(dctx);
+			return len == srv_page_size;
+		}
+#endif /* HAVE_ZSTD */
 	}
 
 	return false;
@@ -499,10 +795,15 @@ static bool fil_page_decompress_low(
 @param[in,out]	tmp_buf	temporary buffer (of innodb_page_size)
 @param[in,out]	buf	possibly compressed page buffer
 @param[in]	flags	tablespace flags
+@param[in]	dict	zstd dictionary, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
-ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
+static ulint fil_page_decompress_for_full_crc32(
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			flags,
+	const fil_zstd_dict_t*	dict)
 {
 	ut_ad(fil_space_t::full_crc32(flags));
 	bool compressed = false;
@@ -532,7 +833,7 @@ ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
 
 	if (!fil_page_decompress_low(tmp_buf, buf,
 				     fil_space_t::get_compression_algo(flags),
-				     header_len, size - header_len)) {
+				     header_len, size - header_len, dict)) {
 		return 0;
 	}
 
@@ -544,12 +845,14 @@ ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
 /** Decompress a page for non full crc32 format.
 @param[in,out] tmp_buf	temporary buffer (of innodb_page_size)
 @param[in,out] buf	possibly compressed page buffer
+@param[in]	dict	zstd dictionary, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
-ulint fil_page_decompress_for_non_full_crc32(
-	byte*	tmp_buf,
-	byte*	buf)
+static ulint fil_page_decompress_for_non_full_crc32(
+	byte*			tmp_buf,
+	byte*			buf,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint header_len;
 	uint comp_algo;
@@ -584,7 +887,7 @@ ulint fil_page_decompress_for_non_full_crc32(
 	}
 
 	if (!fil_page_decompress_low(tmp_buf, buf, comp_algo, header_len,
-				     actual_size)) {
+				     actual_size, dict)) {
 		return 0;
 	}
 
@@ -596,17 +899,21 @@ ulint fil_page_decompress_for_non_full_crc32(
 /** Decompress a page that may be subject to page_compressed compression.
 @param[in,out]	tmp_buf		temporary buffer (of innodb_page_size)
 @param[in,out]	buf		possibly compressed page buffer
+@param[in]	flags		tablespace flags
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
 ulint fil_page_decompress(
-	byte*	tmp_buf,
-	byte*	buf,
-	ulint	flags)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			flags,
+	const fil_zstd_dict_t*	dict)
 {
 	if (fil_space_t::full_crc32(flags)) {
-		return fil_page_decompress_for_full_crc32(tmp_buf, buf, flags);
+		return fil_page_decompress_for_full_crc32(tmp_buf, buf, flags,
+							  dict);
 	}
 
-	return fil_page_decompress_for_non_full_crc32(tmp_buf, buf);
+	return fil_page_decompress_for_non_full_crc32(tmp_buf, buf, dict);
 }
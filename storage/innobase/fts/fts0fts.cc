@@ -1012,7 +1012,10 @@ fts_cache_index_cache_create(
 }
 
 /****************************************************************//**
-Release all resources help by the words rb tree e.g., the node ilist. */
+Release all resources help by the words rb tree e.g., the node ilist.
+The tree nodes themselves are freed by the subsequent rbt_free(), which
+avoids rebalancing the tree for every removed word while the cache
+lock is being held. */
 static
 void
 fts_words_free(
@@ -1024,7 +1027,7 @@ fts_words_free(
 	/* Free the resources held by a word. */
 	for (rbt_node = rbt_first(words);
 	     rbt_node != NULL;
-	     rbt_node = rbt_first(words)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		ulint			i;
 		fts_tokenizer_word_t*	word;
@@ -1040,9 +1043,6 @@ fts_words_free(
 			ut_free(fts_node->ilist);
 			fts_node->ilist = NULL;
 		}
-
-		/* NOTE: We are responsible for free'ing the node */
-		ut_free(rbt_remove_node(words, rbt_node));
 	}
 }
 
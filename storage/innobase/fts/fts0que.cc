@@ -3525,6 +3525,9 @@ void
 fts_query_calculate_ranking(
 /*========================*/
 	const fts_query_t*	query,		/*!< in: query state */
+	fts_word_freq_t* const*	word_freqs,	/*!< in: term frequencies,
+						indexed by the position in
+						query->word_vector */
 	fts_ranking_t*		ranking)	/*!< in: Document to rank */
 {
 	ulint	pos = 0;
@@ -3542,12 +3545,11 @@ fts_query_calculate_ranking(
 		fts_doc_freq_t*		doc_freq;
 		fts_word_freq_t*	word_freq;
 
-		ret = rbt_search(query->word_freqs, &parent, &word);
+		/* fts_ranking_words_get_next() advanced pos past the word. */
+		word_freq = word_freqs[pos - 1];
 
 		/* It must exist. */
-		ut_a(ret == 0);
-
-		word_freq = rbt_value(fts_word_freq_t, parent.last);
+		ut_a(word_freq != NULL);
 
 		ret = rbt_search(
 			word_freq->doc_freqs, &parent, &ranking->doc_id);
@@ -3716,6 +3718,21 @@ fts_query_prepare_result(
 
 	ut_a(rbt_size(query->doc_ids) > 0);
 
+	/* Look up the frequency of each matched word once, instead of
+	searching query->word_freqs by value for every document. */
+	std::vector<fts_word_freq_t*, ut_allocator<fts_word_freq_t*> >
+		word_freqs(query->word_vector->size());
+
+	for (ulint i = 0; i < word_freqs.size(); i++) {
+		ib_rbt_bound_t	parent;
+
+		if (rbt_search(query->word_freqs, &parent,
+			       &query->word_vector->at(i)) == 0) {
+			word_freqs[i] = rbt_value(fts_word_freq_t,
+						  parent.last);
+		}
+	}
+
 	for (node = rbt_first(query->doc_ids);
 	     node;
 	     node = rbt_next(query->doc_ids, node)) {
@@ -3723,7 +3740,7 @@ fts_query_prepare_result(
 		fts_ranking_t*	ranking;
 
 		ranking = rbt_value(fts_ranking_t, node);
-		fts_query_calculate_ranking(query, ranking);
+		fts_query_calculate_ranking(query, word_freqs.data(), ranking);
 
 		// FIXME: I think we may requre this information to improve the
 		// ranking of doc ids which have more word matches from
@@ -74,6 +74,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "buf0buf.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "dict0boot.h"
 #include "dict0load.h"
 #include "btr0defragment.h"
@@ -91,6 +92,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "ibuf0ibuf.h"
 #include "lock0lock.h"
 #include "log0crypt.h"
+#include "log0online.h"
 #include "mtr0mtr.h"
 #include "os0file.h"
 #include "page0zip.h"
@@ -100,6 +102,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -850,6 +853,7 @@ static ibool innodb_have_lz4=IF_LZ4(1, 0);
 static ibool innodb_have_lzma=IF_LZMA(1, 0);
 static ibool innodb_have_bzip2=IF_BZIP2(1, 0);
 static ibool innodb_have_snappy=IF_SNAPPY(1, 0);
+static ibool innodb_have_zstd=IF_ZSTD(1, 0);
 static ibool innodb_have_punch_hole=IF_PUNCH_HOLE(1, 0);
 
 static
@@ -883,6 +887,18 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 0, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_BOOL(async_commit, PLUGIN_VAR_OPCMDARG,
+  "Let transaction commits of the session return without waiting for the"
+  " redo log to be written. The log is written within"
+  " innodb_flush_log_at_timeout seconds, or earlier by a commit of another"
+  " transaction.",
+  NULL, NULL, FALSE);
+
+static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index to count the rows of"
+  " a table for SELECT COUNT(*). 1 disables the parallel scan.",
+  NULL, NULL, 1, 1, ROW_PREAD_MAX_THREADS, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -1048,6 +1064,7 @@ static SHOW_VAR innodb_status_variables[]= {
   {"have_lzma", &innodb_have_lzma, SHOW_BOOL},
   {"have_bzip2", &innodb_have_bzip2, SHOW_BOOL},
   {"have_snappy", &innodb_have_snappy, SHOW_BOOL},
+  {"have_zstd", &innodb_have_zstd, SHOW_BOOL},
   {"have_punch_hole", &innodb_have_punch_hole, SHOW_BOOL},
 
   /* Defragmentation */
@@ -1330,7 +1347,10 @@ bool
 innobase_flush_logs(
 	handlerton*	hton)
 {
-	return innobase_flush_logs(hton, true);
+	bool ret = innobase_flush_logs(hton, true);
+	/* Make the changed pages up to now visible to mariabackup. */
+	log_online_write();
+	return ret;
 }
 
 /************************************************************************//**
@@ -1554,6 +1574,13 @@ thd_lock_wait_timeout(
 	return(THDVAR(thd, lock_wait_timeout));
 }
 
+/** @return whether innodb_async_commit is set for the connection
+@param thd  thread handle */
+bool thd_async_commit(THD *thd)
+{
+	return THDVAR(thd, async_commit);
+}
+
 /** Get the value of innodb_tmpdir.
 @param[in]	thd	thread handle, or NULL to query
 			the global innodb_tmpdir.
@@ -2507,10 +2534,12 @@ ha_innobase::ha_innobase(
 		*/
 			  | HA_CAN_EXPORT
                           | HA_ONLINE_ANALYZE
+			  | HA_CAN_PREFETCH_KEYS
 			  | HA_CAN_RTREEKEYS
                           | HA_CAN_TABLES_WITHOUT_ROLLBACK
                           | HA_CAN_ONLINE_BACKUPS
 			  | HA_CONCURRENT_OPTIMIZE
+			  | HA_HAS_RECORDS
 			  |  (srv_force_primary_key ? HA_REQUIRE_PRIMARY_KEY : 0)
 		  ),
 	m_start_of_scan(),
@@ -3261,6 +3290,15 @@ static int innodb_init_params()
 	}
 #endif
 
+#ifndef HAVE_ZSTD
+	if (innodb_compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		sql_print_error("InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				"InnoDB: libzstd is not installed. \n",
+				innodb_compression_algorithm);
+		DBUG_RETURN(HA_ERR_INITIALIZATION);
+	}
+#endif
+
 	if ((srv_encrypt_tables || srv_encrypt_log
 	     || innodb_encrypt_temporary_tables)
 	     && !encryption_key_id_exists(FIL_DEFAULT_ENCRYPTION_KEY)) {
@@ -3499,7 +3537,8 @@ static int innodb_init_params()
 	data_mysql_default_charset_coll = (ulint) default_charset_info->number;
 
 	srv_use_atomic_writes
-		= innobase_use_atomic_writes && my_may_have_atomic_write;
+		= innobase_use_atomic_writes
+		&& (my_may_have_atomic_write || srv_detect_atomic_writes);
         if (srv_use_atomic_writes && !srv_file_per_table)
         {
           fprintf(stderr, "InnoDB: Disabling atomic_writes as file_per_table is not used.\n");
@@ -3529,7 +3568,7 @@ static int innodb_init_params()
 		srv_use_doublewrite_buf = FALSE;
 	}
 
-#ifdef LINUX_NATIVE_AIO
+#if defined LINUX_NATIVE_AIO || defined HAVE_URING
 #elif !defined _WIN32
 	/* Currently native AIO is supported only on windows and linux
 	and that also when the support is compiled in. In all other
@@ -13681,6 +13720,113 @@ ha_innobase::estimate_rows_upper_bound()
 	DBUG_RETURN((ha_rows) estimate);
 }
 
+/** Count the rows of the table for SELECT COUNT(*) by scanning the
+clustered index with innodb_parallel_read_threads threads.
+@return number of rows visible to the read view of the transaction
+@retval HA_POS_ERROR if the rows must be counted by a normal scan */
+
+ha_rows
+ha_innobase::records()
+{
+	DBUG_ENTER("ha_innobase::records");
+
+	THD*	thd = ha_thd();
+	ulint	n_threads = THDVAR(thd, parallel_read_threads);
+
+	if (n_threads <= 1) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	update_thd(thd);
+
+	trx_t*		trx = m_prebuilt->trx;
+	dict_index_t*	index = dict_table_get_first_index(m_prebuilt->table);
+
+	/* Locking reads (including SERIALIZABLE) and tables without
+	MVCC are left to the normal scan. */
+	if (m_prebuilt->select_lock_type != LOCK_NONE
+	    || m_prebuilt->table->is_temporary()
+	    || !m_prebuilt->table->is_readable()
+	    || !index || index->is_corrupted()
+	    || srv_read_only_mode) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	trx_start_if_not_started(trx, false);
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED) {
+		trx->read_view.open(trx);
+	}
+
+	trx->op_info = "counting records";
+
+	ulint	n_rows;
+	dberr_t	err = row_pread_count(index, trx, n_threads, &n_rows);
+
+	trx->op_info = "";
+
+	DBUG_RETURN(err == DB_SUCCESS ? ha_rows(n_rows) : HA_POS_ERROR);
+}
+
+/** Read the clustered index pages of the rows with the given primary
+keys into the buffer pool with innodb_parallel_read_threads threads,
+so that the rows can then be looked up one by one without waiting for
+one page read at a time.
+@param[in]	keynr		index of the keys
+@param[in]	keys		keys in MySQL format
+@param[in]	key_length	length of each key
+@param[in]	n_keys		number of keys */
+
+void
+ha_innobase::prefetch_keys(
+	uint		keynr,
+	const uchar*	keys,
+	uint		key_length,
+	uint		n_keys)
+{
+	DBUG_ENTER("ha_innobase::prefetch_keys");
+
+	ulint		n_threads = THDVAR(ha_thd(), parallel_read_threads);
+	dict_index_t*	index = innobase_get_index(keynr);
+
+	if (n_threads <= 1 || n_keys < 2
+	    || !index || !index->is_primary() || index->is_corrupted()
+	    || m_prebuilt->table->is_temporary()
+	    || !m_prebuilt->table->is_readable()
+	    || !m_prebuilt->srch_key_val_len) {
+		DBUG_VOID_RETURN;
+	}
+
+	const uint	n_fields = table->key_info[keynr].ext_key_parts;
+	mem_heap_t*	heap = mem_heap_create(
+		n_keys * (sizeof(dtuple_t) + n_fields * sizeof(dfield_t)
+			  + m_prebuilt->srch_key_val_len));
+	std::vector<const dtuple_t*>	tuples(n_keys);
+
+	for (uint i = 0; i < n_keys; i++) {
+		dtuple_t*	tuple = dtuple_create(heap, n_fields);
+		dict_index_copy_types(tuple, index, n_fields);
+
+		/* The converted key may point into the buffer, which
+		must stay around until the pages have been read. */
+		row_sel_convert_mysql_key_to_innobase(
+			tuple,
+			static_cast<byte*>(mem_heap_alloc(
+				heap, m_prebuilt->srch_key_val_len)),
+			m_prebuilt->srch_key_val_len,
+			index,
+			keys + ulint(i) * key_length,
+			key_length);
+
+		tuples[i] = tuple;
+	}
+
+	row_pread_fetch(index, tuples.data(), n_keys, n_threads);
+
+	mem_heap_free(heap);
+	DBUG_VOID_RETURN;
+}
+
 /*********************************************************************//**
 How many seeks it will take to read through the table. This is to be
 comparable to the number returned by records_in_range so that we can
@@ -15140,6 +15286,11 @@ ha_innobase::extra(
 		trx_register_for_2pc(m_prebuilt->trx);
 		m_prebuilt->sql_stat_start = true;
 		break;
+	case HA_EXTRA_PREFETCH_SCAN:
+		if (const fil_space_t* space = m_prebuilt->table->space) {
+			buf_read_ahead_scan(space->id, space->zip_size());
+		}
+		break;
 	default:/* Do nothing */
 		;
 	}
@@ -18187,12 +18338,25 @@ static MYSQL_SYSVAR_BOOL(use_atomic_writes, innobase_use_atomic_writes,
   "the directFS filesystem or with Shannon cards using any file system.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(detect_atomic_writes, srv_detect_atomic_writes,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "With innodb_use_atomic_writes, also skip the doublewrite buffer for "
+  "files for which the kernel reports atomic writes of a page, and for "
+  "files on ZFS or copy-on-write btrfs.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(stats_include_delete_marked,
   srv_stats_include_delete_marked,
   PLUGIN_VAR_OPCMDARG,
   "Include delete marked records when calculating persistent statistics",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(stats_random_sampling, srv_stats_random_sampling,
+  PLUGIN_VAR_OPCMDARG,
+  "Calculate persistent statistics from a uniform random sample of"
+  " leaf pages, instead of random dives from the upper levels",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ENUM(instant_alter_column_allowed,
 			 innodb_instant_alter_column_allowed,
   PLUGIN_VAR_RQCMDARG,
@@ -18280,6 +18444,14 @@ static MYSQL_SYSVAR_UINT(flush_log_at_timeout, srv_flush_log_at_timeout,
   "Write and flush logs every (n) second.",
   NULL, NULL, 1, 0, 2700, 0);
 
+static MYSQL_SYSVAR_UINT(flush_log_delay_usec, srv_flush_log_delay_usec,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum time in microseconds to delay a redo log flush so that more"
+  " concurrent commits can share it. The delay is only applied when"
+  " recent log flushes were slow compared to the rate of commits."
+  " 0 disables the delay.",
+  NULL, NULL, 0, 0, 100000, 0);
+
 static MYSQL_SYSVAR_ULONG(flush_log_at_trx_commit, srv_flush_log_at_trx_commit,
   PLUGIN_VAR_OPCMDARG,
   "Controls the durability/speed trade-off for commits."
@@ -18427,6 +18599,21 @@ static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Number of InnoDB Adaptive Hash Index Partitions (default 8)",
   NULL, NULL, 8, 1, 512, 0);
+
+static MYSQL_SYSVAR_BOOL(adaptive_hash_index_lock_free, btr_search_lock_free,
+  PLUGIN_VAR_OPCMDARG,
+  "Look up the InnoDB adaptive hash index without acquiring the partition"
+  " latch, validating the result against concurrent modifications"
+  " (disabled by default).",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(adaptive_hash_index_min_hit_ratio,
+  btr_search_min_hit_ratio,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of successful adaptive hash index lookups below which"
+  " the adaptive hash index of an index is not used for a while"
+  " (0 disables the check).",
+  NULL, NULL, 0, 0, 100, 0);
 #endif /* BTR_CUR_HASH_ADAPT */
 
 static MYSQL_SYSVAR_UINT(compression_level, page_zip_level,
@@ -18494,6 +18681,13 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   "Dump only the hottest N% of each buffer pool, defaults to 25",
   NULL, NULL, 25, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_pool_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool into a file named @@innodb_buffer_pool_filename"
+  " in the background every N seconds, if pages were read since the"
+  " previous dump; 0 (the default) disables periodic dumps",
+  NULL, NULL, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 /* Added to test the innodb_buffer_pool_load_incomplete status variable. */
 static MYSQL_SYSVAR_ULONG(buffer_pool_load_pages_abort, srv_buf_pool_load_pages_abort,
@@ -18662,6 +18856,13 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(ddl_threads, srv_ddl_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of indexes that are sorted and built concurrently"
+  " by ALTER TABLE or CREATE INDEX, and of threads that apply the log of"
+  " concurrent DML after an online table rebuild. 1 disables both.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -18806,6 +19007,32 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+#ifdef __linux__
+/** Names of tpool::aio_implementation */
+static const char* innodb_linux_aio_names[] = {
+	"auto",		/* tpool::OS_IO_DEFAULT */
+	"io_uring",	/* tpool::OS_IO_URING */
+	"aio",		/* tpool::OS_IO_LIBAIO */
+	NullS
+};
+
+/** Enumeration of innodb_linux_aio */
+static TYPELIB innodb_linux_aio_typelib = {
+	array_elements(innodb_linux_aio_names) - 1,
+	"innodb_linux_aio_typelib",
+	innodb_linux_aio_names,
+	NULL
+};
+
+static MYSQL_SYSVAR_ENUM(linux_aio, srv_linux_aio,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Native asynchronous I/O implementation to use with"
+  " innodb_use_native_aio=ON: auto (io_uring if available, else libaio),"
+  " io_uring (also registers the buffer pool as fixed buffers),"
+  " or aio (libaio)",
+  NULL, NULL, tpool::OS_IO_DEFAULT, &innodb_linux_aio_typelib);
+#endif /* __linux__ */
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -18813,6 +19040,12 @@ static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   NULL, NULL, FALSE);
 #endif /* HAVE_LIBNUMA */
 
+static MYSQL_SYSVAR_BOOL(buffer_pool_populate, srv_buf_pool_populate,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Make the buffer pool resident at startup, using multiple threads,"
+  " instead of on the first access to each page",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ENUM(change_buffering, innodb_change_buffering,
   PLUGIN_VAR_RQCMDARG,
   "Buffer changes to secondary indexes.",
@@ -18956,6 +19189,12 @@ static MYSQL_SYSVAR_BOOL(read_only, srv_read_only_mode,
   "Start InnoDB in read only mode (off by default)",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(track_changed_pages, srv_track_changed_pages,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Write the identifiers of modified pages to ib_modified_log_*.xdb files,"
+  " for mariabackup --incremental (off by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(read_only_compressed, innodb_read_only_compressed,
   PLUGIN_VAR_OPCMDARG,
   "Make ROW_FORMAT=COMPRESSED tables read-only (ON by default)",
@@ -19050,7 +19289,7 @@ static MYSQL_SYSVAR_BOOL(force_primary_key,
   "Do not allow to create table without primary key (off by default)",
   NULL, NULL, FALSE);
 
-static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", 0 };
+static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", "zstd", 0 };
 static TYPELIB page_compression_algorithms_typelib=
 {
   array_elements(page_compression_algorithms) - 1, 0,
@@ -19058,7 +19297,7 @@ static TYPELIB page_compression_algorithms_typelib=
 };
 static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PLUGIN_VAR_OPCMDARG,
-  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, or snappy",
+  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, snappy, or zstd",
   innodb_compression_algorithm_validate, NULL,
   /* We use here the largest number of supported compression method to
   enable all those methods that are available. Availability of compression
@@ -19066,6 +19305,13 @@ static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PAGE_ZLIB_ALGORITHM,
   &page_compression_algorithms_typelib);
 
+static MYSQL_SYSVAR_BOOL(compression_dictionary, innodb_compression_dictionary,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether ALTER TABLE or OPTIMIZE TABLE that rebuilds a page_compressed"
+  " table that uses zstd trains a compression dictionary for the new"
+  " table from the data of the old table",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(fatal_semaphore_wait_threshold, srv_fatal_semaphore_wait_threshold,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Maximum number of seconds that semaphore times out in InnoDB.",
@@ -19138,6 +19384,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
+  MYSQL_SYSVAR(buffer_pool_populate),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -19163,13 +19411,17 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
   MYSQL_SYSVAR(stats_include_delete_marked),
+  MYSQL_SYSVAR(stats_random_sampling),
   MYSQL_SYSVAR(use_atomic_writes),
+  MYSQL_SYSVAR(detect_atomic_writes),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(read_io_threads),
   MYSQL_SYSVAR(write_io_threads),
   MYSQL_SYSVAR(file_per_table),
   MYSQL_SYSVAR(flush_log_at_timeout),
   MYSQL_SYSVAR(flush_log_at_trx_commit),
+  MYSQL_SYSVAR(async_commit),
+  MYSQL_SYSVAR(flush_log_delay_usec),
   MYSQL_SYSVAR(flush_method),
   MYSQL_SYSVAR(force_recovery),
   MYSQL_SYSVAR(fill_factor),
@@ -19183,6 +19435,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ft_sort_pll_degree),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(ddl_threads),
   MYSQL_SYSVAR(deadlock_detect),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
@@ -19202,6 +19455,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(old_blocks_time),
   MYSQL_SYSVAR(open_files),
   MYSQL_SYSVAR(optimize_fulltext_only),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(rollback_on_timeout),
   MYSQL_SYSVAR(ft_aux_table),
   MYSQL_SYSVAR(ft_enable_diag_print),
@@ -19218,6 +19472,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #ifdef BTR_CUR_HASH_ADAPT
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
+  MYSQL_SYSVAR(adaptive_hash_index_lock_free),
+  MYSQL_SYSVAR(adaptive_hash_index_min_hit_ratio),
 #endif /* BTR_CUR_HASH_ADAPT */
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(status_file),
@@ -19232,6 +19488,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+#ifdef __linux__
+  MYSQL_SYSVAR(linux_aio),
+#endif
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -19248,6 +19507,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(read_ahead_threshold),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(read_only_compressed),
+  MYSQL_SYSVAR(track_changed_pages),
   MYSQL_SYSVAR(instant_alter_column_allowed),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(io_capacity_max),
@@ -19297,6 +19557,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   /* Table page compression feature */
   MYSQL_SYSVAR(compression_default),
   MYSQL_SYSVAR(compression_algorithm),
+  MYSQL_SYSVAR(compression_dictionary),
   /* Encryption feature */
   MYSQL_SYSVAR(encrypt_tables),
   MYSQL_SYSVAR(encryption_threads),
@@ -20446,6 +20707,17 @@ innodb_compression_algorithm_validate(
 		DBUG_RETURN(1);
 	}
 #endif
+
+#ifndef HAVE_ZSTD
+	if (compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				    "InnoDB: libzstd is not installed. \n",
+				    compression_algorithm);
+		DBUG_RETURN(1);
+	}
+#endif
 	DBUG_RETURN(0);
 }
 
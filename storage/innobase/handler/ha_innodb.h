@@ -155,6 +155,9 @@ class ha_innobase final : public handler
 
 	int rnd_pos(uchar * buf, uchar *pos) override;
 
+	void prefetch_keys(uint keynr, const uchar* keys, uint key_length,
+			   uint n_keys) override;
+
 	int ft_init() override;
 	void ft_end() override { rnd_end(); }
 	FT_INFO *ft_init_ext(uint flags, uint inx, String* key) override;
@@ -186,6 +189,8 @@ class ha_innobase final : public handler
 
 	ha_rows estimate_rows_upper_bound() override;
 
+	ha_rows records() override;
+
 	void update_create_info(HA_CREATE_INFO* create_info) override;
 
 	inline int create(
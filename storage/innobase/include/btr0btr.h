@@ -329,6 +329,11 @@ btr_create(
 	dict_index_t*		index,
 	mtr_t*			mtr);
 
+/** Remove all records from an index tree, keeping its root page.
+This is used in the rollback of TRX_UNDO_EMPTY.
+@param[in,out]	index	index tree */
+void btr_clear(dict_index_t* index);
+
 /** Free a persistent index tree if it exists.
 @param[in]	page_id		root page id
 @param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
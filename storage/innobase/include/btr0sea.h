@@ -31,6 +31,7 @@ Created 2/17/1996 Heikki Tuuri
 #ifdef BTR_CUR_HASH_ADAPT
 #include "ha0ha.h"
 #include "srw_lock.h"
+#include "os0thread.h"
 
 #ifdef UNIV_PFS_RWLOCK
 extern mysql_pfs_key_t btr_search_latch_key;
@@ -213,6 +214,16 @@ struct btr_search_t{
 				the same prefix should be indexed in the
 				hash index */
 	/*---------------------- @} */
+	/* @{ The following fields are not protected by any latch. */
+	ulint	n_hash_lookups;	/*!< number of hash searches since the
+				hit ratio was last checked */
+	ulint	n_hash_hits;	/*!< number of successful searches
+				among n_hash_lookups */
+	ulint	n_hash_off;	/*!< number of searches for which the
+				hash index will not be used or built,
+				because its hit ratio was below
+				btr_search_min_hit_ratio */
+	/* @} */
 #ifdef UNIV_SEARCH_PERF_STAT
 	ulint	n_hash_succ;	/*!< number of successful hash searches thus
 				far */
@@ -242,9 +253,14 @@ struct btr_search_sys_t
     hash_table_t table;
     /** memory heap for table */
     mem_heap_t *heap;
+    /** modification counter of table; odd while a modification is
+    in progress. Used by btr_search_guess_on_hash() for validating
+    lookups that do not acquire latch. */
+    std::atomic<uint32_t> version;
 
     char pad[(CPU_LEVEL1_DCACHE_LINESIZE - sizeof(srw_lock) -
-              sizeof(hash_table_t) - sizeof(mem_heap_t)) &
+              sizeof(hash_table_t) - sizeof(mem_heap_t) -
+              sizeof(std::atomic<uint32_t>)) &
              (CPU_LEVEL1_DCACHE_LINESIZE - 1)];
 
     void init()
@@ -276,8 +292,77 @@ struct btr_search_sys_t
       if (heap)
         clear();
     }
+
+    /** Start modifying table, while holding exclusive latch */
+    void start_write()
+    {
+      const uint32_t v= version.load(std::memory_order_relaxed);
+      ut_ad(!(v & 1));
+      version.store(v + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /** Finish modifying table */
+    void end_write()
+    {
+      const uint32_t v= version.load(std::memory_order_relaxed);
+      ut_ad(v & 1);
+      version.store(v + 1, std::memory_order_release);
+    }
+
+    /** @return whether table was not modified since the version v
+    was read */
+    bool validate(uint32_t v) const
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return version.load(std::memory_order_relaxed) == v;
+    }
+  };
+
+  /** Counter of threads that access the partitions without latch */
+  struct reader_slot
+  {
+    /** number of threads */
+    std::atomic<uint32_t> n;
+
+    char pad[CPU_LEVEL1_DCACHE_LINESIZE - sizeof(std::atomic<uint32_t>)];
   };
 
+  /** Number of reader_slot; the slots are distributed over distinct
+  cache lines, so that lookups by different threads do not conflict */
+  static constexpr ulint N_READER_SLOTS= 64;
+
+  /** Threads that are executing a lookup without latch */
+  reader_slot readers[N_READER_SLOTS];
+
+  /** Register a thread that is about to access a partition without latch.
+  @return the slot to pass to reader_exit()
+  @retval nullptr if the adaptive hash index is disabled */
+  reader_slot *reader_enter()
+  {
+    reader_slot *slot= &readers[ut_fold_ulint_pair(
+      ulint(os_thread_get_curr_id()), 0) % N_READER_SLOTS];
+    slot->n.fetch_add(1);
+    if (btr_search_enabled)
+      return slot;
+    reader_exit(slot);
+    return nullptr;
+  }
+
+  /** Deregister a thread that was registered by reader_enter() */
+  static void reader_exit(reader_slot *slot)
+  { slot->n.fetch_sub(1, std::memory_order_release); }
+
+  /** Wait for the lookups that were started before btr_search_enabled
+  was cleared. */
+  void wait_for_readers()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (ulint i= 0; i < N_READER_SLOTS; i++)
+      while (readers[i].n.load(std::memory_order_acquire))
+        os_thread_yield();
+  }
+
   /** Partitions of the adaptive hash index */
   partition *parts;
 
@@ -44,6 +44,15 @@ extern char	btr_search_enabled;
 
 /** Number of adaptive hash index partition. */
 extern ulong	btr_ahi_parts;
+
+/** innodb_adaptive_hash_index_lock_free: whether to look up the
+adaptive hash index without acquiring the partition latch */
+extern my_bool	btr_search_lock_free;
+
+/** innodb_adaptive_hash_index_min_hit_ratio: the percentage of successful
+lookups below which the adaptive hash index of an index is not used for
+a while, or 0 */
+extern ulong	btr_search_min_hit_ratio;
 #endif /* BTR_CUR_HASH_ADAPT */
 
 /** The size of a reference to data stored on a different page.
@@ -666,7 +666,13 @@ class buf_tmp_buffer_t
 
   /** Acquire the slot
   @return whether the slot was acquired */
-  bool acquire() { return !reserved.exchange(true, std::memory_order_relaxed);}
+  bool acquire()
+  {
+    /* Avoid acquiring the cache line in exclusive mode
+    when the slot is known to be busy. */
+    return !reserved.load(std::memory_order_relaxed) &&
+      !reserved.exchange(true, std::memory_order_relaxed);
+  }
 
   /** Allocate a buffer for encryption, decryption or decompression. */
   void allocate()
@@ -1011,6 +1017,32 @@ struct buf_block_t{
 					bufferfixed, or (2) the thread has an
 					x-latch on the block */
 	/* @} */
+	/** @name Visibility hint of a secondary index leaf page
+	A consistent read of a secondary index record must normally look up
+	the clustered index record when PAGE_MAX_TRX_ID is not visible in
+	the read view. These in-memory fields remember which records were
+	inserted, delete-marked or updated after the hint was established,
+	so that the other records can be read without the lookup.
+
+	The hint is established by vis_hint_get() while holding a page
+	latch, and it is valid as long as vis_max_trx_id != 0 and
+	vis_clock == modify_clock. A change of modify_clock (any record
+	removal or movement) implicitly invalidates the hint. The fields
+	are updated by vis_hint_note() while holding an exclusive latch. */
+	/* @{ */
+
+	/** maximum number of elements in vis_heap_no[] */
+	static constexpr uint16_t VIS_HINT_MAX = 6;
+	/** modify_clock when the hint was established */
+	std::atomic<ib_uint64_t> vis_clock;
+	/** PAGE_MAX_TRX_ID when the hint was established, or 0 if invalid */
+	Atomic_relaxed<trx_id_t> vis_max_trx_id;
+	/** number of elements in vis_heap_no[] */
+	Atomic_relaxed<uint16_t> vis_n;
+	/** heap numbers of the records that were modified after the hint
+	was established */
+	uint16_t	vis_heap_no[VIS_HINT_MAX];
+	/* @} */
 #ifdef BTR_CUR_HASH_ADAPT
 	/** @name Hash search fields (unprotected)
 	NOTE that these fields are NOT protected by any semaphore! */
@@ -1112,6 +1144,56 @@ struct buf_block_t{
     return page.unfix();
   }
 
+  /** Note that a record was inserted or modified, while holding an
+  exclusive page latch.
+  @param heap_no  heap number of the record */
+  void vis_hint_note(ulint heap_no)
+  {
+    if (!vis_max_trx_id ||
+        vis_clock.load(std::memory_order_relaxed) != modify_clock)
+      return;
+    const uint16_t n= vis_n;
+    for (uint16_t i= 0; i < n; i++)
+      if (vis_heap_no[i] == heap_no)
+        return;
+    if (n == VIS_HINT_MAX)
+      vis_max_trx_id= 0;
+    else
+    {
+      vis_heap_no[n]= uint16_t(heap_no);
+      vis_n= uint16_t(n + 1);
+    }
+  }
+
+  /** Determine the maximum transaction identifier that may have
+  modified a record of a secondary index leaf page, while holding
+  a page latch. Establish the hint if it is not valid.
+  @param max_trx_id  PAGE_MAX_TRX_ID of the page
+  @param heap_no     heap number of the record
+  @return PAGE_MAX_TRX_ID at the time the hint was established,
+  or max_trx_id if the record was modified since then */
+  trx_id_t vis_hint_get(trx_id_t max_trx_id, ulint heap_no)
+  {
+    trx_id_t min_trx_id;
+    if (vis_clock.load(std::memory_order_acquire) != modify_clock ||
+        !(min_trx_id= vis_max_trx_id))
+    {
+      /* Concurrent readers may establish the hint at the same time.
+      They will store the same values, because the page cannot be
+      modified while they hold the page latch. */
+      vis_n= 0;
+      vis_max_trx_id= max_trx_id;
+      vis_clock.store(modify_clock, std::memory_order_release);
+      return max_trx_id;
+    }
+    const uint16_t n= std::min<uint16_t>(vis_n, VIS_HINT_MAX);
+    for (uint16_t i= 0; i < n; i++)
+      if (vis_heap_no[i] == heap_no)
+        return max_trx_id;
+    ut_ad(min_trx_id <= max_trx_id);
+    return min_trx_id;
+  }
+
   /** @return the physical size, in bytes */
   ulint physical_size() const { return page.physical_size(); }
 
@@ -1479,6 +1561,12 @@ class buf_pool_t
   @param ptr  pointer to within a page frame
   @return pointer to block, never NULL */
   inline buf_block_t *block_from_ahi(const byte *ptr) const;
+
+  /** Get a buffer block from an adaptive hash index pointer that
+  may be stale, without checking the state of the block.
+  @param ptr  pointer to within a page frame
+  @return pointer to block, never NULL */
+  inline buf_block_t *block_from_ahi_low(const byte *ptr) const;
 #endif /* BTR_CUR_HASH_ADAPT */
 
   /** @return the block that was made dirty the longest time ago */
@@ -1825,8 +1913,11 @@ class buf_pool_t
   inline void write_lock_all_page_hash();
   /** Release all page_hash, also freed_page_hash. */
   inline void write_unlock_all_page_hash();
-  /** Resize page_hash and zip_hash. */
-  inline void resize_hash();
+  /** Resize page_hash and zip_hash.
+  @param new_page_hash  the new page_hash, created and write-locked
+  @param new_zip_hash   the new zip_hash, created */
+  inline void resize_hash(page_hash_table *new_page_hash,
+                          hash_table_t &new_zip_hash);
 
 public:
   /** Hash table of file pages (buf_page_t::in_file() holds),
@@ -1876,7 +1967,7 @@ class buf_pool_t
     return page_cleaner_is_idle;
   }
   /** Wake up the page cleaner if needed */
-  inline void page_cleaner_wakeup();
+  void page_cleaner_wakeup();
 
   /** Register whether an explicit wakeup of the page cleaner is needed */
   void page_cleaner_set_idle(bool deep_sleep)
@@ -1986,10 +2077,13 @@ class buf_pool_t
     ulint n_slots;
     /** array of slots */
     buf_tmp_buffer_t *slots;
+    /** the slot where the next reserve() starts searching */
+    Atomic_relaxed<ulint> next;
 
     void create(ulint n_slots)
     {
       this->n_slots= n_slots;
+      next= 0;
       slots= static_cast<buf_tmp_buffer_t*>
         (ut_malloc_nokey(n_slots * sizeof *slots));
       memset((void*) slots, 0, n_slots * sizeof *slots);
@@ -2010,9 +2104,16 @@ class buf_pool_t
     /** Reserve a buffer */
     buf_tmp_buffer_t *reserve()
     {
-      for (buf_tmp_buffer_t *s= slots, *e= slots + n_slots; s != e; s++)
-        if (s->acquire())
-          return s;
+      /* Concurrent read completions of encrypted or page_compressed
+      pages would all contend for the first slots if every search
+      started from slots[0]. */
+      const ulint start= next.fetch_add(1) % n_slots;
+      for (ulint i= start; i < n_slots; i++)
+        if (slots[i].acquire())
+          return &slots[i];
+      for (ulint i= 0; i < start; i++)
+        if (slots[i].acquire())
+          return &slots[i];
       return nullptr;
     }
   } io_buf;
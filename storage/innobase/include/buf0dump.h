@@ -35,6 +35,11 @@ void buf_load_start();
 /** Abort a currently running buffer pool load. */
 void buf_load_abort();
 
+/** Start a buffer pool dump if innodb_buffer_pool_dump_interval has passed
+since the previous one and pages were read into the buffer pool since then.
+Invoked by srv_master_callback(). */
+void buf_dump_periodic();
+
 /** Start async buffer pool load, if srv_buffer_pool_load_at_startup was set.*/
 void buf_load_at_startup();
 
@@ -111,7 +111,8 @@ void buf_flush_ahead(lsn_t lsn);
 /********************************************************************//**
 This function should be called at a mini-transaction commit, if a page was
 modified in it. Puts the block to the list of modified blocks, if it not
-already in it. */
+already in it. If the block was not modified before, the caller must hold
+log_sys.flush_order_mutex and buf_pool.flush_list_mutex. */
 UNIV_INLINE
 void
 buf_flush_note_modification(
@@ -102,6 +102,16 @@ which could result in a deadlock if the OS does not support asynchronous io.
 ulint
 buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf);
 
+/** Read in the background the first read-ahead area of a single-table
+tablespace, before a table scan of it starts. The first leaf pages of
+the clustered index are allocated from the fragment pages at the start
+of the file, and the linear read-ahead takes over once the scan has
+reached the full extents.
+@param[in]	space_id	tablespace id
+@param[in]	zip_size	ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_scan(ulint space_id, ulint zip_size);
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
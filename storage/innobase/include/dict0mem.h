@@ -2290,8 +2290,9 @@ struct dict_table_t {
 
 	/** Count of the number of record locks on this table. We use this to
 	determine whether we can evict the table from the dictionary cache.
-	It is protected by lock_sys.mutex. */
-	ulint					n_rec_locks;
+	It is incremented while holding lock_sys.mutex or
+	lock_sys.rd_lock_page(), and decremented under lock_sys.mutex. */
+	Atomic_counter<ulint>			n_rec_locks;
 
 private:
 	/** Count of how many handles are opened to this table. Dropping of the
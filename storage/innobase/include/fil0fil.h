@@ -99,6 +99,9 @@ class page_id_t;
 /** Structure containing encryption specification */
 struct fil_space_crypt_t;
 
+/** Trained zstd dictionary for page_compressed pages */
+struct fil_zstd_dict_t;
+
 /** File types */
 enum fil_type_t {
 	/** temporary tablespace (temporary undo log or tables) */
@@ -410,6 +413,11 @@ struct fil_space_t final
 	/** MariaDB encryption data */
 	fil_space_crypt_t* crypt_data;
 
+	/** trained zstd dictionary of page_compressed pages;
+	set at most once, by fil_zstd_dict_install() or when the
+	first page is read */
+	std::atomic<fil_zstd_dict_t*> zstd_dict;
+
 	/** Checks that this tablespace in a list of unflushed tablespaces. */
 	bool is_in_unflushed_spaces;
 
@@ -742,6 +750,7 @@ struct fil_space_t final
 		case PAGE_LZ4_ALGORITHM:
 		case PAGE_LZO_ALGORITHM:
 		case PAGE_SNAPPY_ALGORITHM:
+		case PAGE_ZSTD_ALGORITHM:
 			return true;
 		}
 		return false;
@@ -1432,8 +1441,9 @@ struct fil_system_t {
 					startup we scan the data dictionary
 					and set here the maximum of the
 					space id's of the tables there */
-  /** nonzero if fil_node_open_file_low() should avoid moving the tablespace
-  to the end of space_list, for FIFO policy of try_to_close() */
+  /** nonzero if fil_node_open_file_low() and try_to_close() should avoid
+  moving tablespaces to the end of space_list, for FIFO policy of
+  try_to_close() */
   ulint freeze_space_list;
 	UT_LIST_BASE_NODE_T(fil_space_t) space_list;
 					/*!< list of all file spaces */
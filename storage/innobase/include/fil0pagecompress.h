@@ -35,26 +35,52 @@ Created 11/12/2013 Jan Lindström jan.lindstrom@skysql.com
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return actual length of compressed page
 @retval	0	if the page was not compressed */
 ulint fil_page_compress(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
-	MY_ATTRIBUTE((nonnull, warn_unused_result));
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
+	MY_ATTRIBUTE((nonnull(1,2), warn_unused_result));
 
 /** Decompress a page that may be subject to page_compressed compression.
 @param[in,out]	tmp_buf		temporary buffer (of innodb_page_size)
 @param[in,out]	buf		compressed page buffer
 @param[in]	flags		talespace flags
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
 ulint fil_page_decompress(
-	byte*	tmp_buf,
-	byte*	buf,
-	ulint	flags)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			flags,
+	const fil_zstd_dict_t*	dict)
+	MY_ATTRIBUTE((nonnull(1,2), warn_unused_result));
+
+/** Read the zstd dictionary from the first page of a tablespace.
+@param[in]	flags	tablespace flags
+@param[in]	page	first page of the tablespace
+@return the dictionary
+@retval	nullptr	if the page does not contain a usable dictionary */
+fil_zstd_dict_t* fil_zstd_dict_read(ulint flags, const byte* page)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary returned by fil_zstd_dict_read(),
+			or nullptr */
+void fil_zstd_dict_free(fil_zstd_dict_t* dict);
+
+/** Train a zstd dictionary for a page_compressed tablespace, write it
+to the first page and start using it for compressing pages.
+@param[in,out]	space	tablespace that does not have a dictionary yet
+@param[in]	samples	uncompressed pages, concatenated
+@param[in]	n	number of pages in samples
+@return whether a dictionary was installed */
+bool fil_zstd_dict_train(fil_space_t* space, const byte* samples, ulint n)
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
 #endif
@@ -252,6 +252,10 @@ const char*
 thd_innodb_tmpdir(
 	THD*	thd);
 
+/** @return whether innodb_async_commit is set for the connection
+@param thd  thread handle */
+bool thd_async_commit(THD *thd);
+
 /******************************************************************//**
 Returns the lock wait timeout for the current connection.
 @return the lock wait timeout, in seconds */
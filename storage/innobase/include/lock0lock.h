@@ -38,6 +38,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "ut0vec.h"
 #include "gis0rtree.h"
 #include "lock0prdt.h"
+#include "srw_lock.h"
 
 // Forward declaration
 class ReadView;
@@ -403,7 +404,9 @@ Checks that a non-clustered index record is seen in a consistent read.
 NOTE that a non-clustered index page contains so little information on
 its modifications that also in the case false, the present version of
 rec may be the right, but we must check this from the clustered index
-record.
+record. Records that were not modified after an older PAGE_MAX_TRX_ID
+value was remembered in buf_block_t::vis_max_trx_id can be seen without
+the lookup.
 
 @return true if certainly sees, or false if an earlier version of the
 clustered index record might be needed */
@@ -413,6 +416,7 @@ lock_sec_rec_cons_read_sees(
 	const rec_t*		rec,	/*!< in: user record which
 					should be read or passed over
 					by a read cursor */
+	buf_block_t*		block,	/*!< in/out: page of rec */
 	const dict_index_t*     index,  /*!< in: index */
 	const ReadView*	view)	/*!< in: consistent read view */
 	MY_ATTRIBUTE((warn_unused_result));
@@ -430,13 +434,20 @@ lock_table(
 	lock_mode	mode,	/*!< in: lock mode */
 	que_thr_t*	thr)	/*!< in: query thread */
 	MY_ATTRIBUTE((warn_unused_result));
+/** Try to acquire an exclusive table lock without waiting.
+@param[in,out]	table	persistent table
+@param[in,out]	trx	transaction
+@return	whether the lock was granted */
+bool lock_table_x_try(dict_table_t* table, trx_t* trx)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode);	/*!< in: LOCK_IX or LOCK_X */
 
 /** Sets a lock on a table based on the given mode.
 @param[in]	table	table to lock
@@ -701,13 +712,46 @@ struct lock_op_t{
 	lock_mode	mode;	/*!< lock mode */
 };
 
-/** The lock system struct */
+/** The lock system struct.
+
+Most operations are covered by the "exclusive latch", which consists of
+lock_sys.mutex together with an exclusive lock_sys.latch. Operations on
+the record locks of a single page that do not need to wait may instead
+acquire lock_sys.latch in shared mode together with the latch of the
+rec_hash partition that the page belongs to (rd_lock_page()), so that
+record locking on unrelated pages does not serialize on lock_sys.mutex. */
 class lock_sys_t
 {
   bool m_initialised;
 
   /** mutex proteting the locks */
   MY_ALIGNED(CACHE_LINE_SIZE) mysql_mutex_t mutex;
+  /** Held exclusively together with mutex, or in shared mode together
+  with one of hash_latches[] */
+  MY_ALIGNED(CACHE_LINE_SIZE) srw_lock_low latch;
+#ifdef UNIV_DEBUG
+  /** The thread that holds the exclusive latch, or 0 */
+  std::atomic<os_thread_id_t> writer;
+  /** The rec_hash partition that the current thread holds via
+  rd_lock_page(), or ULINT_UNDEFINED */
+  static thread_local ulint rd_latched;
+#endif
+public:
+  /** Number of partitions of rec_hash for rd_lock_page() */
+  static constexpr ulint N_HASH_LATCHES= 256;
+private:
+  /** A latch for a partition of rec_hash */
+  struct MY_ALIGNED(CACHE_LINE_SIZE) hash_latch
+  {
+    srw_mutex m;
+  };
+  /** Latches for the partitions of rec_hash; cell i of rec_hash
+  belongs to partition i % N_HASH_LATCHES */
+  hash_latch hash_latches[N_HASH_LATCHES];
+
+  /** @return the rec_hash partition of a page */
+  ulint partition(const page_id_t id) const
+  { return rec_hash.calc_hash(id.fold()) % N_HASH_LATCHES; }
 public:
   /** record locks */
   hash_table_t rec_hash;
@@ -742,28 +786,99 @@ class lock_sys_t
   bool is_initialised() { return m_initialised; }
 
 #ifdef HAVE_PSI_MUTEX_INTERFACE
-  /** Try to acquire lock_sys.mutex */
+  /** Try to acquire the exclusive latch */
   ATTRIBUTE_NOINLINE int mutex_trylock();
-  /** Acquire lock_sys.mutex */
+  /** Acquire the exclusive latch */
   ATTRIBUTE_NOINLINE void mutex_lock();
-  /** Release lock_sys.mutex */
+  /** Release the exclusive latch */
   ATTRIBUTE_NOINLINE void mutex_unlock();
 #else
-  /** Try to acquire lock_sys.mutex */
-  int mutex_trylock() { return mysql_mutex_trylock(&mutex); }
-  /** Aqcuire lock_sys.mutex */
-  void mutex_lock() { mysql_mutex_lock(&mutex); }
-  /** Release lock_sys.mutex */
-  void mutex_unlock() { mysql_mutex_unlock(&mutex); }
+  /** Try to acquire the exclusive latch */
+  int mutex_trylock()
+  {
+    if (int err= mysql_mutex_trylock(&mutex))
+      return err;
+    if (latch.wr_lock_try())
+    {
+      ut_d(writer.store(os_thread_get_curr_id(), std::memory_order_relaxed));
+      return 0;
+    }
+    mysql_mutex_unlock(&mutex);
+    return EBUSY;
+  }
+  /** Aqcuire the exclusive latch */
+  void mutex_lock()
+  {
+    mysql_mutex_lock(&mutex);
+    latch.wr_lock();
+    ut_d(writer.store(os_thread_get_curr_id(), std::memory_order_relaxed));
+  }
+  /** Release the exclusive latch */
+  void mutex_unlock()
+  {
+    ut_d(writer.store(0, std::memory_order_relaxed));
+    latch.wr_unlock();
+    mysql_mutex_unlock(&mutex);
+  }
 #endif
   /** Assert that mutex_lock() has been invoked */
-  void mutex_assert_locked() const { mysql_mutex_assert_owner(&mutex); }
+  void mutex_assert_locked() const
+  {
+    mysql_mutex_assert_owner(&mutex);
+    ut_ad(writer.load(std::memory_order_relaxed) == os_thread_get_curr_id());
+  }
   /** Assert that mutex_lock() has not been invoked */
   void mutex_assert_unlocked() const { mysql_mutex_assert_not_owner(&mutex); }
+#ifdef UNIV_DEBUG
+  /** @return whether the current thread holds the exclusive latch */
+  bool is_writer() const
+  { return writer.load(std::memory_order_relaxed) == os_thread_get_curr_id(); }
+#endif
+  /** Assert that the record locks of a page are protected, either by
+  mutex_lock() or rd_lock_page() */
+  void assert_locked(const page_id_t id) const
+  { ut_ad(is_writer() || rd_latched == partition(id)); }
+
+  /** Acquire a shared latch on the lock system and the latch of the
+  rec_hash partition of a page, for looking up or granting record locks
+  on the page without waiting. Other pages that share the partition, as
+  well as mutex_lock(), will be blocked.
+  @param id  page identifier
+  @return the rec_hash partition latch, to be passed to rd_unlock_page() */
+  srw_mutex *rd_lock_page(const page_id_t id)
+  {
+    mutex_assert_unlocked();
+    latch.rd_lock();
+    const ulint p= partition(id);
+    srw_mutex *l= &hash_latches[p].m;
+    l->wr_lock();
+    ut_ad(rd_latched == ULINT_UNDEFINED);
+    ut_d(rd_latched= p);
+    return l;
+  }
+  /** Release the latches that were acquired by rd_lock_page().
+  @param l  the return value of rd_lock_page() */
+  void rd_unlock_page(srw_mutex *l)
+  {
+    ut_ad(rd_latched != ULINT_UNDEFINED);
+    ut_d(rd_latched= ULINT_UNDEFINED);
+    l->wr_unlock();
+    latch.rd_unlock();
+  }
 
   /** Wait for a lock to be granted */
   void wait_lock(lock_t **lock, mysql_cond_t *cond)
-  { while (*lock) mysql_cond_wait(cond, &mutex); }
+  {
+    while (*lock)
+    {
+      /* Let rd_lock_page() proceed while we are waiting. */
+      ut_d(writer.store(0, std::memory_order_relaxed));
+      latch.wr_unlock();
+      mysql_cond_wait(cond, &mutex);
+      latch.wr_lock();
+      ut_d(writer.store(os_thread_get_curr_id(), std::memory_order_relaxed));
+    }
+  }
 
   /**
     Creates the lock system at database start.
@@ -786,7 +901,7 @@ class lock_sys_t
 
   /** @return the hash value for a page address */
   ulint hash(const page_id_t id) const
-  { mysql_mutex_assert_owner(&mutex); return rec_hash.calc_hash(id.fold()); }
+  { assert_locked(id); return rec_hash.calc_hash(id.fold()); }
 
   /** Get the first lock on a page.
   @param lock_hash   hash table to look at
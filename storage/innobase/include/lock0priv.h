@@ -120,14 +120,6 @@ operator<<(std::ostream& out, const ib_lock_t& lock)
 extern ibool	lock_print_waits;
 #endif /* UNIV_DEBUG */
 
-/** Restricts the length of search we will do in the waits-for
-graph of transactions */
-static const ulint	LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK = 1000000;
-
-/** Restricts the search depth we will do in the waits-for graph of
-transactions */
-static const ulint	LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK = 200;
-
 /** When releasing transaction locks, this specifies how often we release
 the lock mutex for a moment to give also others access to it */
 static const ulint	LOCK_RELEASE_INTERVAL = 1000;
@@ -414,9 +406,6 @@ static const byte lock_strength_matrix[5][5] = {
  /* AI */ {  FALSE, FALSE, FALSE, FALSE,  TRUE}
 };
 
-/** Maximum depth of the DFS stack. */
-static const ulint MAX_STACK_SIZE = 4096;
-
 #define PRDT_HEAPNO	PAGE_HEAP_NO_INFIMUM
 /** Record locking request status */
 enum lock_rec_req_status {
@@ -459,6 +448,11 @@ lock_cancel_waiting_and_release(
 /*============================*/
 	lock_t*	lock);	/*!< in/out: waiting lock request */
 
+/** Check for a deadlock if the transaction that a lock wait
+is waiting for was changed after the wait was enqueued.
+@param[in,out]	trx	transaction that is waiting for a lock */
+void lock_wait_deadlock_check(trx_t* trx);
+
 /*********************************************************************//**
 Checks if some transaction has an implicit x-lock on a record in a clustered
 index.
@@ -40,6 +40,7 @@ Created 12/9/1995 Heikki Tuuri
 #include "my_atomic_wrapper.h"
 #include <vector>
 #include <string>
+#include <thread>
 
 using st_::span;
 
@@ -482,6 +483,9 @@ struct log_t{
   size_t buf_free;
   /** recommended maximum size of buf, after which the buffer is flushed */
   size_t max_buf_free;
+  /** number of mini-transactions that have reserved space in buf
+  but not copied their log there yet; incremented under mutex */
+  std::atomic<size_t> n_pending_copies;
   /** mutex to serialize access to the flush list when we are putting
   dirty blocks in the list. The idea behind this mutex is to be able
   to release log_sys.mutex during mtr_commit and still ensure that
@@ -662,6 +666,15 @@ struct log_t{
   void set_check_flush_or_checkpoint(bool flag= true)
   { check_flush_or_checkpoint_.store(flag, std::memory_order_relaxed); }
 
+  /** Wait until the mini-transactions have copied their log to buf.
+  The caller must hold mutex, so that no new copies can be reserved. */
+  void wait_for_copies() const
+  {
+    mysql_mutex_assert_owner(&mutex);
+    while (n_pending_copies.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+
   bool has_encryption_key_rotation() const {
     return log.format == FORMAT_ENC_10_4 || log.format == FORMAT_ENC_10_5;
   }
@@ -0,0 +1,60 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/log0online.h
+Changed page tracking for incremental backups (innodb_track_changed_pages)
+
+The ids of the pages that mini-transactions modify are collected when
+mtr_t::commit() assigns their LSN. At every log checkpoint and on
+FLUSH ENGINE LOGS, the pages that were collected so far are appended as
+one run of bitmap blocks to ib_modified_log_<seq>_<start_lsn>.xdb in the
+data home directory, in the format that mariabackup --incremental reads
+instead of scanning every page of every data file. A run that ends at
+LSN end contains every page that was modified by a mini-transaction
+whose LSN is not larger than end and larger than the end of the previous
+run.
+*******************************************************/
+
+#pragma once
+
+#include "buf0types.h"
+#include "log0types.h"
+
+/** innodb_track_changed_pages */
+extern my_bool srv_track_changed_pages;
+
+/** Whether changed pages are being tracked */
+extern bool log_online_enabled;
+
+/** Start tracking changed pages after the redo log was recovered.
+@param lsn  the current LSN */
+void log_online_init(lsn_t lsn);
+
+/** Write the pages that were changed since the previous run and stop
+tracking changed pages. */
+void log_online_close();
+
+/** Note that a mini-transaction modified a page.
+The caller must hold log_sys.mutex.
+@param id  page identifier */
+void log_online_add(const page_id_t id);
+
+/** Write the pages that were changed since the previous run as a run
+that ends at the current LSN. */
+void log_online_write();
@@ -299,6 +299,10 @@ struct recv_sys_t
   @return the recovered block
   @retval nullptr if the page cannot be initialized based on log records */
   buf_block_t *recover_low(const page_id_t page_id);
+  /** Recover pages that are initialized by redo log records.
+  This is a srv_thread_pool task of apply().
+  @param arg  recv_init_pages_t */
+  static void recover_init_pages(void *arg);
 
   /** All found log files (multiple ones are possible if we are upgrading
   from before MariaDB Server 10.5.1) */
@@ -623,6 +623,9 @@ struct mtr_t {
   @return {start_lsn,flush_ahead} */
   inline std::pair<lsn_t,bool> finish_write(ulint len);
 
+  /** Copy the redo log records to the space reserved by finish_write() */
+  inline void copy_log();
+
   /** Release the resources */
   inline void release_resources();
 
@@ -679,6 +682,12 @@ struct mtr_t {
   /** LSN at commit time */
   lsn_t m_commit_lsn;
 
+  /** log_sys.buf where finish_write() reserved space for m_log,
+  or nullptr if m_log was already written there */
+  byte *m_copy_buf= nullptr;
+  /** offset of the space in m_copy_buf */
+  size_t m_copy_offset;
+
   /** tablespace where pages have been freed */
   fil_space_t *m_freed_space= nullptr;
   /** set of freed page ids */
@@ -38,6 +38,8 @@ Created 13/06/2005 Jan Lindstrom
 #include "srv0srv.h"
 #include "ut0stage.h"
 
+#include <atomic>
+
 /* Reserve free space from every block for key_version */
 #define ROW_MERGE_RESERVE_SIZE 4
 
@@ -134,6 +136,12 @@ struct row_merge_dup_t {
 					(index->table), or NULL if not
 					rebuilding table */
 	ulint			n_dup;	/*!< number of duplicates */
+	std::atomic<const dict_index_t*>*	first_dup;
+					/*!< shared by the indexes that are
+					sorted in parallel: the first index
+					whose duplicate was copied to
+					table->record[0], or NULL if the
+					index is sorted alone */
 };
 
 /*************************************************************//**
@@ -563,7 +563,13 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/* Number of rows in the first batch that is cached in fetch_cache;
+each completely filled batch doubles the size of the next one */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Maximum number of rows in fetch_cache */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	1024
+/* Maximum size of fetch_cache, in multiples of innodb_page_size */
+#define MYSQL_FETCH_CACHE_MAX_PAGES	4
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -738,16 +744,22 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
-					bytes for each such row; these
-					pointers point 4 bytes past the
-					allocated mem buf start, because
-					there is a 4 byte magic number at the
-					start and at the end */
+					batch, and the batch is collected
+					while holding the page latch; we
+					reserve mysql_row_len bytes for each
+					such row; these pointers point 4 bytes
+					past the allocated mem buf start,
+					because there is a 4 byte magic number
+					at the start and at the end */
+	ulint		fetch_cache_size;/*!< number of allocated rows
+					in fetch_cache, or 0 */
+	ulint		fetch_cache_limit;/*!< number of rows to cache in
+					the current batch, at most
+					fetch_cache_size */
 	bool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
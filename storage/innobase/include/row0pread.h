@@ -0,0 +1,106 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel read of a clustered index
+
+Created 2021
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "dict0types.h"
+#include "trx0types.h"
+#include "rem0types.h"
+
+/** Maximum value of innodb_parallel_read_threads */
+#define ROW_PREAD_MAX_THREADS	256
+
+/** Callback of row_pread_scan() for a record that is visible to the
+read view. It may be invoked by several threads at the same time, but
+each thread passes its own thread_no, less than the number of threads.
+@param[in]	rec		clustered index record, or its old version
+@param[in]	offsets		rec_get_offsets(rec)
+@param[in]	thread_no	number of the calling thread
+@param[in,out]	arg		argument of row_pread_scan()
+@return error code
+@retval DB_SUCCESS to continue the scan */
+typedef dberr_t (*row_pread_fn_t)(
+	const rec_t*	rec,
+	const rec_offs*	offsets,
+	ulint		thread_no,
+	void*		arg);
+
+/** Scan the records of a clustered index that are visible to the read
+view of a transaction. The index is split into key ranges at the node
+pointers of its upper levels, and the ranges are scanned by up to
+n_threads tasks of srv_thread_pool, including the calling thread.
+@param[in,out]	index		clustered index
+@param[in]	trx		transaction with an open read view,
+				or in READ UNCOMMITTED isolation
+@param[in]	n_threads	maximum number of threads to use
+@param[in]	fn		callback for each visible record
+@param[in,out]	arg		argument of fn
+@return error code
+@retval DB_INTERRUPTED if the statement was killed */
+dberr_t
+row_pread_scan(
+	dict_index_t*	index,
+	trx_t*		trx,
+	ulint		n_threads,
+	row_pread_fn_t	fn,
+	void*		arg)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Count the records of a clustered index that are visible to the
+read view of a transaction, with row_pread_scan().
+@param[in,out]	index		clustered index
+@param[in]	trx		transaction with an open read view,
+				or in READ UNCOMMITTED isolation
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of visible records
+@return error code
+@retval DB_INTERRUPTED if the statement was killed */
+dberr_t
+row_pread_count(
+	dict_index_t*	index,
+	trx_t*		trx,
+	ulint		n_threads,
+	ulint*		n_rows)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Read the leaf pages of a clustered index that contain the given keys
+into the buffer pool, with up to n_threads tasks of srv_thread_pool,
+including the calling thread. This does not look at the records, so no
+read view is needed; it only makes the later searches for the keys
+avoid waiting for the reads one page at a time.
+@param[in,out]	index		clustered index
+@param[in]	tuples		search tuples of the keys
+@param[in]	n_tuples	number of tuples
+@param[in]	n_threads	maximum number of threads to use */
+void
+row_pread_fetch(
+	dict_index_t*		index,
+	const dtuple_t* const*	tuples,
+	ulint			n_tuples,
+	ulint			n_threads)
+	MY_ATTRIBUTE((nonnull));
+
+#endif /* row0pread_h */
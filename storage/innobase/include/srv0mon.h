@@ -320,6 +320,14 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_LOG_FLUSH_BATCH_1,
+	MONITOR_LOG_FLUSH_BATCH_2_3,
+	MONITOR_LOG_FLUSH_BATCH_4_7,
+	MONITOR_LOG_FLUSH_BATCH_8_15,
+	MONITOR_LOG_FLUSH_BATCH_16_31,
+	MONITOR_LOG_FLUSH_BATCH_32_MORE,
+	MONITOR_LOG_FLUSH_DELAYED,
+	MONITOR_LOG_FLUSH_DELAY_USEC,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
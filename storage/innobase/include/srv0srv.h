@@ -260,6 +260,10 @@ extern my_bool	srv_file_per_table;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Maximum number of indexes that are sorted and loaded concurrently
+in index creation, and of threads that apply the log of an online table
+rebuild (innodb_ddl_threads) */
+extern ulong	srv_ddl_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -268,13 +272,27 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+#ifdef __linux__
+/** innodb_linux_aio: the native asynchronous I/O implementation
+(tpool::aio_implementation) */
+extern ulong	srv_linux_aio;
+#endif
 extern my_bool	srv_numa_interleave;
+/** innodb_buffer_pool_populate: whether to pre-fault the buffer pool
+page frames at startup */
+extern my_bool	srv_buf_pool_populate;
 
 /* Use atomic writes i.e disable doublewrite buffer */
 extern my_bool srv_use_atomic_writes;
+/** innodb_detect_atomic_writes: whether to bypass the doublewrite buffer
+for files for which the kernel or the file system guarantees atomic writes */
+extern my_bool srv_detect_atomic_writes;
 
 /* Compression algorithm*/
 extern ulong innodb_compression_algorithm;
+/** innodb_compression_dictionary: whether table rebuilds train
+zstd dictionaries for page_compressed tables */
+extern my_bool innodb_compression_dictionary;
 
 /** TRUE if the server was successfully started */
 extern bool	srv_was_started;
@@ -318,6 +336,7 @@ extern ulonglong	srv_log_file_size;
 extern ulong	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
+extern uint	srv_flush_log_delay_usec;
 extern ulong	srv_log_write_ahead_size;
 extern my_bool	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
@@ -354,6 +373,9 @@ extern ulint	srv_buf_pool_base_size;
 extern ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong	srv_buf_pool_dump_pct;
+/** innodb_buffer_pool_dump_interval: seconds between background buffer
+pool dumps, or 0 */
+extern ulong	srv_buf_pool_dump_interval;
 #ifdef UNIV_DEBUG
 /** Abort load after this amount of pages */
 extern ulong srv_buf_pool_load_pages_abort;
@@ -418,6 +440,7 @@ extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
 extern my_bool			srv_stats_include_delete_marked;
+extern my_bool			srv_stats_random_sampling;
 extern unsigned long long	srv_stats_modified_counter;
 extern my_bool			srv_stats_sample_traditional;
 
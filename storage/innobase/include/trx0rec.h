@@ -166,6 +166,14 @@ trx_undo_rec_get_partial_row(
 @return	DB_SUCCESS or error code */
 dberr_t trx_undo_report_rename(trx_t* trx, const dict_table_t* table)
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/** Report that an empty table will be filled without row-level undo
+logging. The rollback will empty all indexes of the table.
+@param[in,out]	trx	transaction that holds an exclusive lock
+			on the table
+@param[in]	table	table that is empty
+@return	DB_SUCCESS or error code */
+dberr_t trx_undo_report_empty(trx_t* trx, dict_table_t* table)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
 /***********************************************************************//**
 Writes information to an undo log about an insert, update, or a delete marking
 of a clustered index record. This information is used in a rollback of the
@@ -296,6 +304,9 @@ record */
 					fields of the record can change */
 #define	TRX_UNDO_DEL_MARK_REC	14	/* delete marking of a record; fields
 					do not change */
+#define	TRX_UNDO_EMPTY		15	/* insert into an empty table
+					without row-level undo logging;
+					the rollback empties the table */
 #define	TRX_UNDO_CMPL_INFO_MULT	16U	/* compilation info is multiplied by
 					this and ORed to the type above */
 #define	TRX_UNDO_UPD_EXTERN	128U	/* This bit can be ORed to type_cmpl
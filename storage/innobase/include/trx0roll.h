@@ -32,7 +32,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0sys.h"
 
 extern bool		trx_rollback_is_active;
-extern const trx_t*	trx_roll_crash_recv_trx;
+extern thread_local const trx_t*	trx_roll_crash_recv_trx;
 
 /*******************************************************************//**
 Returns a transaction savepoint taken at this point in time.
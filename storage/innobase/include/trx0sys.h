@@ -861,6 +861,37 @@ class trx_sys_t
   MY_ALIGNED(CACHE_LINE_SIZE) std::atomic<trx_id_t> m_rw_trx_hash_version;
 
 
+  /**
+    Incremented whenever the outcome of snapshot_ids() may change: after a
+    transaction is registered in or removed from rw_trx_hash, and after a
+    transaction is assigned a serialisation number.
+
+    @sa snapshot_ids()
+  */
+  MY_ALIGNED(CACHE_LINE_SIZE) std::atomic<uint64_t> m_snapshot_epoch;
+
+
+  /**
+    The most recent MVCC snapshot. As long as m_snapshot_epoch does not
+    change, concurrent ReadView::open() calls copy this instead of iterating
+    rw_trx_hash.
+  */
+  struct snapshot_cache_t
+  {
+    /** Protects the members below */
+    srw_lock_low latch;
+    /** m_snapshot_epoch at the time the snapshot was taken */
+    uint64_t epoch;
+    /** sorted identifiers of active read-write transactions */
+    trx_ids_t ids;
+    /** m_max_trx_id at the time the snapshot was taken */
+    trx_id_t max_trx_id;
+    /** smallest serialisation number of the snapshot */
+    trx_id_t min_trx_no;
+  };
+  MY_ALIGNED(CACHE_LINE_SIZE) snapshot_cache_t m_snapshot_cache;
+
+
   bool m_initialised;
 
 public:
@@ -1002,6 +1033,11 @@ class trx_sys_t
     of rw_trx_hash.iterate_no_dups(). It means that some transaction
     identifiers may appear multiple times in ids.
 
+    The resulting ids are sorted. If no transaction was registered,
+    deregistered or assigned a serialisation number since the previous
+    snapshot (m_snapshot_epoch did not change), the cached copy of that
+    snapshot is returned without iterating rw_trx_hash.
+
     @param[in,out] caller_trx used to get access to rw_trx_hash_pins
     @param[out]    ids        array to store registered transaction identifiers
     @param[out]    max_trx_id variable to store m_max_trx_id value
@@ -1011,6 +1047,19 @@ class trx_sys_t
   void snapshot_ids(trx_t *caller_trx, trx_ids_t *ids, trx_id_t *max_trx_id,
                     trx_id_t *min_trx_no)
   {
+    const uint64_t epoch= m_snapshot_epoch.load(std::memory_order_acquire);
+
+    m_snapshot_cache.latch.rd_lock();
+    if (m_snapshot_cache.epoch == epoch)
+    {
+      ids->assign(m_snapshot_cache.ids.begin(), m_snapshot_cache.ids.end());
+      *max_trx_id= m_snapshot_cache.max_trx_id;
+      *min_trx_no= m_snapshot_cache.min_trx_no;
+      m_snapshot_cache.latch.rd_unlock();
+      return;
+    }
+    m_snapshot_cache.latch.rd_unlock();
+
     snapshot_ids_arg arg(ids);
 
     while ((arg.m_id= get_rw_trx_hash_version()) != get_max_trx_id())
@@ -1020,9 +1069,25 @@ class trx_sys_t
     ids->clear();
     ids->reserve(rw_trx_hash.size() + 32);
     rw_trx_hash.iterate(caller_trx, copy_one_id, &arg);
+    std::sort(ids->begin(), ids->end());
 
     *max_trx_id= arg.m_id;
     *min_trx_no= arg.m_no;
+
+    /* Publish the snapshot unless it could already be stale. Do not wait
+    for other threads that are publishing or copying a snapshot. */
+    if (m_snapshot_epoch.load(std::memory_order_acquire) == epoch &&
+        m_snapshot_cache.latch.wr_lock_try())
+    {
+      if (m_snapshot_epoch.load(std::memory_order_relaxed) == epoch)
+      {
+        m_snapshot_cache.ids.assign(ids->begin(), ids->end());
+        m_snapshot_cache.max_trx_id= arg.m_id;
+        m_snapshot_cache.min_trx_no= arg.m_no;
+        m_snapshot_cache.epoch= epoch;
+      }
+      m_snapshot_cache.latch.wr_unlock();
+    }
   }
 
 
@@ -1085,6 +1150,7 @@ class trx_sys_t
   void deregister_rw(trx_t *trx)
   {
     rw_trx_hash.erase(trx);
+    refresh_snapshot_epoch();
   }
 
 
@@ -1195,6 +1261,14 @@ class trx_sys_t
   void refresh_rw_trx_hash_version()
   {
     m_rw_trx_hash_version.fetch_add(1, std::memory_order_release);
+    refresh_snapshot_epoch();
+  }
+
+
+  /** Invalidates m_snapshot_cache, must issue RELEASE memory barrier. */
+  void refresh_snapshot_epoch()
+  {
+    m_snapshot_epoch.fetch_add(1, std::memory_order_release);
   }
 
 
@@ -495,9 +495,16 @@ struct trx_lock_t {
 					hold lock_sys.mutex, except when
 					they are holding trx->mutex and
 					wait_lock==NULL */
-	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
-					to and checked against lock_mark_counter
-					by lock_deadlock_recursive(). */
+	trx_t*		wait_trx;	/*!< if wait_lock != NULL, a transaction
+					that holds or requests a conflicting
+					lock ahead of wait_lock in the queue;
+					the edge of the wait-for graph that is
+					followed in deadlock detection;
+					protected by lock_sys.mutex */
+	bool		deadlock_check;	/*!< whether wait_trx was changed
+					after the wait was checked for
+					deadlocks; protected by
+					lock_sys.mutex */
 	bool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to false;
@@ -536,12 +543,17 @@ struct trx_lock_t {
 	unsigned	table_cached;
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys.mutex */
+					protected by lock_sys.mutex, or by
+					lock_sys.rd_lock_page() in the thread
+					that is serving the transaction */
 
 	trx_lock_list_t trx_locks;	/*!< locks requested by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys.mutex; removals are
-					protected by lock_sys.mutex */
+					and lock_sys.mutex (or
+					lock_sys.rd_lock_page() in the thread
+					that is serving the transaction);
+					removals are protected by
+					lock_sys.mutex */
 
 	lock_list	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -570,6 +582,9 @@ class trx_mod_table_time_t
 	undo_no_t	first;
 	/** First modification of a system versioned column */
 	undo_no_t	first_versioned;
+	/** Whether the table was empty and is being filled without
+	row-level undo logging; @see TRX_UNDO_EMPTY */
+	bool		bulk;
 
 	/** Magic value signifying that a system versioned column of a
 	table was never modified in a transaction. */
@@ -579,7 +594,7 @@ class trx_mod_table_time_t
 	/** Constructor
 	@param[in]	rows	number of modified rows so far */
 	trx_mod_table_time_t(undo_no_t rows)
-		: first(rows), first_versioned(UNVERSIONED) {}
+		: first(rows), first_versioned(UNVERSIONED), bulk(false) {}
 
 #ifdef UNIV_DEBUG
 	/** Validation
@@ -602,6 +617,26 @@ class trx_mod_table_time_t
 		ut_ad(valid());
 	}
 
+	/** Note that the TRX_UNDO_EMPTY record was written, and
+	inserts will not be undo logged until the end of the statement */
+	void start_bulk_insert() { ut_ad(!bulk); bulk = true; }
+
+	/** Determine if an insert can skip the undo logging.
+	@param[in]	stmt_start	undo number at the start of the
+					current SQL statement
+	@return	whether the table is being filled by the current statement
+	after a TRX_UNDO_EMPTY record */
+	bool is_bulk_insert(undo_no_t stmt_start)
+	{
+		ut_ad(valid());
+		if (bulk && first < stmt_start) {
+			/* A rollback of a later statement could not undo
+			the inserts of that statement. */
+			bulk = false;
+		}
+		return bulk;
+	}
+
 	/** Invoked after partial rollback
 	@param[in]	limit	number of surviving modified rows
 	@return	whether this should be erased from trx_t::mod_tables */
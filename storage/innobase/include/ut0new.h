@@ -849,6 +849,7 @@ constexpr const char* const auto_event_names[] =
   "eval0eval",
   "fil0crypt",
   "fil0fil",
+  "fil0pagecompress",
   "fsp0file",
   "fts0ast",
   "fts0blex",
@@ -63,6 +63,8 @@ IF(UNIX)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
     ENDIF()
+    INCLUDE(uring)
+    MYSQL_CHECK_URING()
     IF(HAVE_LIBNUMA)
       LINK_LIBRARIES(numa)
     ENDIF()
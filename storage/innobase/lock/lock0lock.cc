@@ -62,6 +62,15 @@ lock_rec_has_to_wait_in_queue(
 /*==========================*/
 	const lock_t*	wait_lock);	/*!< in: waiting record lock */
 
+/*********************************************************************//**
+Checks if a waiting table lock request still has to wait in a queue.
+@return lock that is causing the wait */
+static
+const lock_t*
+lock_table_has_to_wait_in_queue(
+/*============================*/
+	const lock_t*	wait_lock);	/*!< in: waiting table lock */
+
 /** Grant a lock to a waiting lock request and release the waiting transaction
 after lock_reset_lock_and_trx_wait() has been called. */
 static void lock_grant_after_reset(lock_t* lock);
@@ -81,8 +90,13 @@ static void lock_table_print(FILE* file, const lock_t* lock);
 @param[in,out]	mtr	mini-transaction for accessing the record */
 static void lock_rec_print(FILE* file, const lock_t* lock, mtr_t& mtr);
 
-/** Deadlock checker. */
-class DeadlockChecker {
+/** Deadlock detector. Every waiting transaction has one edge in the
+wait-for graph: trx_lock_t::wait_trx refers to a transaction that holds
+or requests a conflicting lock ahead of trx_lock_t::wait_lock. Cycles
+are searched for by following these edges, which is linear in the length
+of the path, when a lock wait is enqueued. If wait_trx is changed when
+locks are released, the search is repeated by lock_wait_timeout_task(). */
+class Deadlock {
 public:
 	/** Check if a joining lock request results in a deadlock.
 	If a deadlock is found, we will resolve the deadlock by
@@ -97,126 +111,52 @@ class DeadlockChecker {
 	or there is no deadlock (any more) */
 	static const trx_t* check_and_resolve(const lock_t* lock, trx_t* trx);
 
-private:
-	/** Do a shallow copy. Default destructor OK.
-	@param trx the start transaction (start node)
-	@param wait_lock lock that a transaction wants
-	@param mark_start visited node counter
-	@param report_waiters whether to call thd_rpl_deadlock_check() */
-	DeadlockChecker(
-		const trx_t*	trx,
-		const lock_t*	wait_lock,
-		ib_uint64_t	mark_start,
-		bool report_waiters)
-		:
-		m_cost(),
-		m_start(trx),
-		m_too_deep(),
-		m_wait_lock(wait_lock),
-		m_mark_start(mark_start),
-		m_n_elems(),
-		m_report_waiters(report_waiters)
-	{
-	}
-
-	/** Check if the search is too deep. */
-	bool is_too_deep() const
-	{
-		return(m_n_elems > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK
-		       || m_cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK);
-	}
-
-	/** Save current state.
-	@param lock lock to push on the stack.
-	@param heap_no the heap number to push on the stack.
-	@return false if stack is full. */
-	bool push(const lock_t*	lock, ulint heap_no)
-	{
-		ut_ad((lock_get_type_low(lock) & LOCK_REC)
-		      || (lock_get_type_low(lock) & LOCK_TABLE));
-
-		ut_ad(((lock_get_type_low(lock) & LOCK_TABLE) != 0)
-		      == (heap_no == ULINT_UNDEFINED));
-
-		/* Ensure that the stack is bounded. */
-		if (m_n_elems >= UT_ARR_SIZE(s_states)) {
-			return(false);
-		}
-
-		state_t&	state = s_states[m_n_elems++];
+	/** Check for a deadlock if the transaction that a lock wait
+	is waiting for was changed after the wait was enqueued.
+	@param[in,out]	trx	transaction that is waiting for a lock */
+	static void check_waiting(trx_t* trx);
 
-		state.m_lock = lock;
-		state.m_wait_lock = m_wait_lock;
-		state.m_heap_no =heap_no;
-
-		return(true);
-	}
-
-	/** Restore state.
-	@param[out] lock current lock
-	@param[out] heap_no current heap_no */
-	void pop(const lock_t*& lock, ulint& heap_no)
-	{
-		ut_a(m_n_elems > 0);
-
-		const state_t&	state = s_states[--m_n_elems];
-
-		lock = state.m_lock;
-		heap_no = state.m_heap_no;
-		m_wait_lock = state.m_wait_lock;
-	}
-
-	/** Check whether the node has been visited.
-	@param lock lock to check
-	@return true if the node has been visited */
-	bool is_visited(const lock_t* lock) const
+private:
+	/** @return the next transaction on the wait-for path
+	@param[in]	trx	transaction
+	@retval	NULL if trx is not waiting */
+	static trx_t* next(const trx_t* trx)
 	{
-		return(lock->trx->lock.deadlock_mark > m_mark_start);
-	}
-
-	/** Get the next lock in the queue that is owned by a transaction
-	whose sub-tree has not already been searched.
-	Note: "next" here means PREV for table locks.
-	@param lock Lock in queue
-	@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
-	@return next lock or NULL if at end of queue */
-	const lock_t* get_next_lock(const lock_t* lock, ulint heap_no) const;
-
-	/** Get the first lock to search. The search starts from the current
-	wait_lock. What we are really interested in is an edge from the
-	current wait_lock's owning transaction to another transaction that has
-	a lock ahead in the queue. We skip locks where the owning transaction's
-	sub-tree has already been searched.
-
-	Note: The record locks are traversed from the oldest lock to the
-	latest. For table locks we go from latest to oldest.
-
-	For record locks, we first position the iterator on first lock on
-	the page and then reposition on the actual heap_no. This is required
-	due to the way the record lock has is implemented.
-
-	@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
-
-	@return first lock or NULL */
-	const lock_t* get_first_lock(ulint* heap_no) const;
-
-	/** Notify that a deadlock has been detected and print the conflicting
-	transaction info.
-	@param lock lock causing deadlock */
-	void notify(const lock_t* lock) const;
-
-	/** Select the victim transaction that should be rolledback.
-	@return victim transaction */
-	const trx_t* select_victim() const;
-
-	/** Rollback transaction selected as the victim. */
-	void trx_rollback();
-
-	/** Looks iteratively for a deadlock. Note: the joining transaction
-	may have been granted its lock by the deadlock checks.
-
-	@return 0 if no deadlock else the victim transaction.*/
-	const trx_t* search();
+		return(trx->lock.wait_lock ? trx->lock.wait_trx : NULL);
+	}
+
+	/** Find a cycle on the wait-for path that starts from a
+	transaction, using Brent's cycle detection algorithm.
+	@param[in]	trx	waiting transaction
+	@return a transaction on the cycle
+	@retval	NULL if there is no cycle */
+	static trx_t* find_cycle(trx_t* trx);
+
+	/** Check if trx->lock.wait_lock has to wait for a lock that
+	another transaction holds or requests ahead of it in the queue.
+	@param[in]	trx	waiting transaction
+	@param[in]	blocker	transaction that trx->lock.wait_trx was set to
+	@return whether the wait-for edge is valid */
+	static bool is_waiting_for(const trx_t* trx, const trx_t* blocker);
+
+	/** @return a lock that a waiting lock request has to wait for
+	@param[in]	wait_lock	waiting lock request
+	@retval	NULL if wait_lock could be granted */
+	static const lock_t* get_blocker(const lock_t* wait_lock);
+
+	/** Report the lock requests that a waiting lock request has to wait
+	for with thd_rpl_deadlock_check().
+	@param[in]	wait_lock	waiting lock request */
+	static void report_waits(const lock_t* wait_lock);
+
+	/** Find and resolve deadlocks that a transaction is part of or
+	is waiting for.
+	@param[in,out]	trx	waiting transaction
+	@param[in]	self	whether the caller is serving trx and will
+				handle the case that trx is chosen as the victim
+	@return the last chosen victim
+	@retval	NULL if there is no deadlock (any more) */
+	static const trx_t* resolve(trx_t* trx, bool self);
 
 	/** Print transaction data to the deadlock file and possibly to stderr.
 	@param trx transaction
@@ -235,55 +175,8 @@ class DeadlockChecker {
 	/** Print a message to the deadlock file and possibly to stderr.
 	@param msg message to print */
 	static void print(const char* msg);
-
-	/** Print info about transaction that was rolled back.
-	@param trx transaction rolled back
-	@param lock lock trx wants */
-	static void rollback_print(const trx_t* trx, const lock_t* lock);
-
-private:
-	/** DFS state information, used during deadlock checking. */
-	struct state_t {
-		const lock_t*	m_lock;		/*!< Current lock */
-		const lock_t*	m_wait_lock;	/*!< Waiting for lock */
-		ulint		m_heap_no;	/*!< heap number if rec lock */
-	};
-
-	/** Used in deadlock tracking. Protected by lock_sys.mutex. */
-	static ib_uint64_t	s_lock_mark_counter;
-
-	/** Calculation steps thus far. It is the count of the nodes visited. */
-	ulint			m_cost;
-
-	/** Joining transaction that is requesting a lock in an
-	incompatible mode */
-	const trx_t*		m_start;
-
-	/** TRUE if search was too deep and was aborted */
-	bool			m_too_deep;
-
-	/** Lock that trx wants */
-	const lock_t*		m_wait_lock;
-
-	/**  Value of lock_mark_count at the start of the deadlock check. */
-	ib_uint64_t		m_mark_start;
-
-	/** Number of states pushed onto the stack */
-	size_t			m_n_elems;
-
-	/** This is to avoid malloc/free calls. */
-	static state_t		s_states[MAX_STACK_SIZE];
-
-	/** Set if thd_rpl_deadlock_check() should be called for waits. */
-	const bool m_report_waiters;
 };
 
-/** Counter to mark visited nodes during deadlock search. */
-ib_uint64_t	DeadlockChecker::s_lock_mark_counter = 0;
-
-/** The stack used for deadlock searches. */
-DeadlockChecker::state_t	DeadlockChecker::s_states[MAX_STACK_SIZE];
-
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Validates the lock system.
@@ -400,7 +293,9 @@ Checks that a non-clustered index record is seen in a consistent read.
 NOTE that a non-clustered index page contains so little information on
 its modifications that also in the case false, the present version of
 rec may be the right, but we must check this from the clustered index
-record.
+record. Records that were not modified after an older PAGE_MAX_TRX_ID
+value was remembered in buf_block_t::vis_max_trx_id can be seen without
+the lookup.
 
 @return true if certainly sees, or false if an earlier version of the
 clustered index record might be needed */
@@ -410,6 +305,7 @@ lock_sec_rec_cons_read_sees(
 	const rec_t*		rec,	/*!< in: user record which
 					should be read or passed over
 					by a read cursor */
+	buf_block_t*		block,	/*!< in/out: page of rec */
 	const dict_index_t*	index,	/*!< in: index */
 	const ReadView*	view)	/*!< in: consistent read view */
 {
@@ -430,11 +326,18 @@ lock_sec_rec_cons_read_sees(
 		return(true);
 	}
 
-	trx_id_t	max_trx_id = page_get_max_trx_id(page_align(rec));
+	ut_ad(block->frame == page_align(rec));
+
+	trx_id_t	max_trx_id = page_get_max_trx_id(block->frame);
 
 	ut_ad(max_trx_id > 0);
 
-	return(view->sees(max_trx_id));
+	if (view->sees(max_trx_id)) {
+		return(true);
+	}
+
+	return(view->sees(block->vis_hint_get(max_trx_id,
+					      page_rec_get_heap_no(rec))));
 }
 
 
@@ -457,6 +360,11 @@ void lock_sys_t::create(ulint n_cells)
 	}
 
 	mysql_mutex_init(lock_mutex_key, &mutex, nullptr);
+	latch.init();
+	ut_d(writer.store(0, std::memory_order_relaxed));
+	for (hash_latch& l : hash_latches) {
+		l.m.init();
+	}
 	mysql_mutex_init(lock_wait_mutex_key, &wait_mutex, nullptr);
 
 	rec_hash.create(n_cells);
@@ -472,12 +380,37 @@ void lock_sys_t::create(ulint n_cells)
 
 
 #ifdef HAVE_PSI_MUTEX_INTERFACE
-/** Try to acquire lock_sys.mutex */
-int lock_sys_t::mutex_trylock() { return mysql_mutex_trylock(&mutex); }
-/** Acquire lock_sys.mutex */
-void lock_sys_t::mutex_lock() { mysql_mutex_lock(&mutex); }
-/** Release lock_sys.mutex */
-void lock_sys_t::mutex_unlock() { mysql_mutex_unlock(&mutex); }
+/** Try to acquire the exclusive latch */
+int lock_sys_t::mutex_trylock()
+{
+  if (int err= mysql_mutex_trylock(&mutex))
+    return err;
+  if (latch.wr_lock_try())
+  {
+    ut_d(writer.store(os_thread_get_curr_id(), std::memory_order_relaxed));
+    return 0;
+  }
+  mysql_mutex_unlock(&mutex);
+  return EBUSY;
+}
+/** Acquire the exclusive latch */
+void lock_sys_t::mutex_lock()
+{
+  mysql_mutex_lock(&mutex);
+  latch.wr_lock();
+  ut_d(writer.store(os_thread_get_curr_id(), std::memory_order_relaxed));
+}
+/** Release the exclusive latch */
+void lock_sys_t::mutex_unlock()
+{
+  ut_d(writer.store(0, std::memory_order_relaxed));
+  latch.wr_unlock();
+  mysql_mutex_unlock(&mutex);
+}
+#endif
+
+#ifdef UNIV_DEBUG
+thread_local ulint lock_sys_t::rd_latched= ULINT_UNDEFINED;
 #endif
 
 
@@ -539,6 +472,10 @@ void lock_sys_t::close()
 	prdt_page_hash.free();
 
 	mysql_mutex_destroy(&mutex);
+	latch.destroy();
+	for (hash_latch& l : hash_latches) {
+		l.m.destroy();
+	}
 	mysql_mutex_destroy(&wait_mutex);
 
 	for (ulint i = srv_max_n_threads; i--; ) {
@@ -921,7 +858,7 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	lock_sys.mutex_assert_locked();
+	lock_sys.assert_locked(block->page.id());
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -970,7 +907,7 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	lock_sys.mutex_assert_locked();
+	lock_sys.assert_locked(block->page.id());
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1080,7 +1017,7 @@ lock_rec_other_has_conflicting(
 {
 	lock_t*		lock;
 
-	lock_sys.mutex_assert_locked();
+	lock_sys.assert_locked(block->page.id());
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1258,7 +1195,7 @@ lock_rec_create_low(
 	ulint		n_bits;
 	ulint		n_bytes;
 
-	lock_sys.mutex_assert_locked();
+	lock_sys.assert_locked(page_id);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
 #ifdef UNIV_DEBUG
@@ -1406,8 +1343,9 @@ lock_rec_create_low(
 	if (!holds_trx_mutex) {
 		trx->mutex.wr_unlock();
 	}
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	/* We may be holding lock_sys.rd_lock_page() only. */
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return lock;
 }
@@ -1482,7 +1420,7 @@ lock_rec_enqueue_waiting(
 	}
 
 	if (ut_d(const trx_t* victim =)
-	    DeadlockChecker::check_and_resolve(lock, trx)) {
+	    Deadlock::check_and_resolve(lock, trx)) {
 		ut_ad(victim == trx);
 		lock_reset_lock_and_trx_wait(lock);
 		lock_rec_reset_nth_bit(lock, heap_no);
@@ -1531,8 +1469,6 @@ lock_rec_find_similar_on_page(
 	lock_t*         lock,           /*!< in: lock_sys.get_first() */
 	const trx_t*    trx)            /*!< in: transaction */
 {
-	lock_sys.mutex_assert_locked();
-
 	for (/* No op */;
 	     lock != NULL;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -1572,7 +1508,7 @@ lock_rec_add_to_queue(
 					/*!< in: TRUE if caller owns the
 					transaction mutex */
 {
-	lock_sys.mutex_assert_locked();
+	lock_sys.assert_locked(block->page.id());
 	ut_ad(index->is_primary()
 	      || dict_index_get_online_status(index) != ONLINE_INDEX_CREATION);
 #ifdef UNIV_DEBUG
@@ -1690,7 +1626,7 @@ lock_rec_lock(
 	que_thr_t*		thr)	/*!< in: query thread */
 {
   trx_t *trx= thr_get_trx(thr);
-  dberr_t err= DB_SUCCESS;
+  dberr_t err;
 
   ut_ad(!srv_read_only_mode);
   ut_ad((LOCK_MODE_MASK & mode) == LOCK_S ||
@@ -1701,7 +1637,21 @@ lock_rec_lock(
   ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
   DBUG_EXECUTE_IF("innodb_report_deadlock", return DB_DEADLOCK;);
 
-  lock_sys.mutex_lock();
+  /* First, try to grant the lock while holding only the latch of the
+  rec_hash partition. Only if we have to wait (or we are a Galera
+  transaction, which may have to kill a conflicting one), acquire the
+  exclusive latch and start over. */
+  srw_mutex *latch=
+#ifdef WITH_WSREP
+    trx->is_wsrep() ? nullptr :
+#endif
+    lock_sys.rd_lock_page(block->page.id());
+
+retry:
+  if (!latch)
+    lock_sys.mutex_lock();
+
+  err= DB_SUCCESS;
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_S ||
         lock_table_has(trx, index->table, LOCK_IS));
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_X ||
@@ -1726,6 +1676,15 @@ lock_rec_lock(
 #endif
 	    lock_rec_other_has_conflicting(mode, block, heap_no, trx))
         {
+          if (latch)
+          {
+            /* Enqueueing a waiting request and checking for deadlocks
+            require the exclusive latch. */
+            trx->mutex.wr_unlock();
+            lock_sys.rd_unlock_page(latch);
+            latch= nullptr;
+            goto retry;
+          }
           /*
             If another transaction has a non-gap conflicting
             request in the queue, as this transaction does not
@@ -1775,7 +1734,11 @@ lock_rec_lock(
 
     err= DB_SUCCESS_LOCKED_REC;
   }
-  lock_sys.mutex_unlock();
+
+  if (latch)
+    lock_sys.rd_unlock_page(latch);
+  else
+    lock_sys.mutex_unlock();
   MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
   return err;
 }
@@ -1858,6 +1821,26 @@ static void lock_grant_after_reset(lock_t* lock)
 	}
 }
 
+/** Note that a waiting lock request still has to wait after a lock
+ahead of it in the queue was released.
+@param[in,out]	lock	waiting lock request
+@param[in]	c	lock that is causing the wait */
+static void lock_wait_update_blocker(lock_t* lock, const lock_t* c)
+{
+	lock_sys.mutex_assert_locked();
+	ut_ad(lock->trx->lock.wait_lock == lock);
+
+	trx_lock_t&	trx_lock = lock->trx->lock;
+
+	if (trx_lock.wait_trx != c->trx) {
+		/* Lock waits are only checked for deadlocks when they
+		are enqueued. Let lock_wait_timeout_task() check the
+		new wait-for edge. */
+		trx_lock.wait_trx = c->trx;
+		trx_lock.deadlock_check = true;
+	}
+}
+
 /** Grant a lock to a waiting lock request and release the waiting transaction. */
 static void lock_grant(lock_t* lock)
 {
@@ -1868,6 +1851,42 @@ static void lock_grant(lock_t* lock)
   mutex->wr_unlock();
 }
 
+/** Grant a waiting record lock request, or note the lock that it still
+has to wait for, after a lock ahead of it in the queue was released.
+@param[in,out]	lock	waiting record lock request
+@param[in]	prev	a waiting request on the same record that was
+passed to this function earlier during the same release, or NULL */
+static void lock_rec_grant_or_update_blocker(lock_t* lock, const lock_t* prev)
+{
+	lock_sys.mutex_assert_locked();
+	ut_ad(lock_get_wait(lock));
+
+#ifdef WITH_WSREP
+	if (lock->trx->is_wsrep()) {
+		/* wsrep_assert_no_bf_bf_wait() needs the first
+		conflicting lock in the queue. */
+		prev = NULL;
+	}
+#endif /* WITH_WSREP */
+
+	/* prev is ahead of lock in the queue, and it was either granted
+	or it is still waiting. A waiting lock request also has to wait
+	for conflicting requests that are waiting ahead of it. Checking
+	prev first avoids rescanning the whole queue for each waiter, which
+	would make handing over a hot record to n waiters take O(n^2). */
+	const lock_t* c = prev && lock_has_to_wait(lock, prev)
+		? prev : lock_rec_has_to_wait_in_queue(lock);
+
+	if (!c) {
+		lock_grant(lock);
+	} else {
+		lock_wait_update_blocker(lock, c);
+#ifdef WITH_WSREP
+		wsrep_assert_no_bf_bf_wait(c, lock, c->trx);
+#endif /* WITH_WSREP */
+	}
+}
+
 /*************************************************************//**
 Cancels a waiting record lock request and releases the waiting transaction
 that requested it. NOTE: does NOT check if waiting lock requests behind this
@@ -1925,8 +1944,12 @@ static void lock_rec_dequeue_from_page(lock_t* in_lock)
 	MONITOR_DEC(MONITOR_NUM_RECLOCK);
 
 	/* Check if waiting locks in the queue can now be granted:
-	grant locks if there are no conflicting locks ahead. Stop at
-	the first X lock that is waiting or has been granted. */
+	grant locks if there are no conflicting locks ahead. Only the
+	requests that wait for a record that in_lock covered can be
+	affected by its removal. */
+
+	const lock_t*	prev = NULL;
+	ulint		prev_heap_no = ULINT_UNDEFINED;
 
 	for (lock_t* lock = lock_sys.get_first(*lock_hash, page_id);
 	     lock != NULL;
@@ -1935,16 +1958,18 @@ static void lock_rec_dequeue_from_page(lock_t* in_lock)
 		if (!lock_get_wait(lock)) {
 			continue;
 		}
-		const lock_t* c = lock_rec_has_to_wait_in_queue(lock);
-		if (!c) {
-			/* Grant the lock */
-			ut_ad(lock->trx != in_lock->trx);
-			lock_grant(lock);
-#ifdef WITH_WSREP
-		} else {
-			wsrep_assert_no_bf_bf_wait(c, lock, c->trx);
-#endif /* WITH_WSREP */
+
+		const ulint	heap_no = lock_rec_find_set_bit(lock);
+
+		if (!lock_rec_get_nth_bit(in_lock, heap_no)) {
+			continue;
 		}
+
+		ut_ad(lock->trx != in_lock->trx);
+		lock_rec_grant_or_update_blocker(
+			lock, heap_no == prev_heap_no ? prev : NULL);
+		prev = lock;
+		prev_heap_no = heap_no;
 	}
 }
 
@@ -3404,7 +3429,7 @@ lock_table_enqueue_waiting(
 				 );
 
 	const trx_t*	victim_trx =
-		DeadlockChecker::check_and_resolve(lock, trx);
+		Deadlock::check_and_resolve(lock, trx);
 
 	if (victim_trx != 0) {
 		ut_ad(victim_trx == trx);
@@ -3574,17 +3599,47 @@ lock_table(
 	return(err);
 }
 
+/** Try to acquire an exclusive table lock without waiting.
+@param[in,out]	table	persistent table
+@param[in,out]	trx	transaction
+@return	whether the lock was granted */
+bool lock_table_x_try(dict_table_t* table, trx_t* trx)
+{
+	ut_ad(!table->is_temporary());
+	ut_ad(!srv_read_only_mode);
+
+	if (lock_table_has(trx, table, LOCK_X)) {
+		return true;
+	}
+
+	lock_sys.mutex_lock();
+
+	const bool granted = !lock_table_other_has_incompatible(
+		trx, LOCK_WAIT, table, LOCK_X);
+
+	if (granted) {
+		trx->mutex.wr_lock();
+		lock_table_create(table, LOCK_X, trx);
+		trx->mutex.wr_unlock();
+	}
+
+	lock_sys.mutex_unlock();
+	return granted;
+}
+
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode)	/*!< in: LOCK_IX or LOCK_X */
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_IX || mode == LOCK_X);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -3596,19 +3651,19 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	mutex->wr_lock();
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_sys.mutex_unlock();
 	mutex->wr_unlock();
 }
 
 /*********************************************************************//**
 Checks if a waiting table lock request still has to wait in a queue.
-@return TRUE if still has to wait */
+@return lock that is causing the wait */
 static
-bool
+const lock_t*
 lock_table_has_to_wait_in_queue(
 /*============================*/
 	const lock_t*	wait_lock)	/*!< in: waiting table lock */
@@ -3627,11 +3682,11 @@ lock_table_has_to_wait_in_queue(
 
 		if (lock_has_to_wait(wait_lock, lock)) {
 
-			return(true);
+			return(lock);
 		}
 	}
 
-	return(false);
+	return(NULL);
 }
 
 /*************************************************************//**
@@ -3660,9 +3715,11 @@ lock_table_dequeue(
 	     lock != NULL;
 	     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
 
-		if (lock_get_wait(lock)
-		    && !lock_table_has_to_wait_in_queue(lock)) {
-
+		if (!lock_get_wait(lock)) {
+		} else if (const lock_t* c
+			   = lock_table_has_to_wait_in_queue(lock)) {
+			lock_wait_update_blocker(lock, c);
+		} else {
 			/* Grant the lock */
 			ut_ad(in_lock->trx != lock->trx);
 			lock_grant(lock);
@@ -3787,21 +3844,16 @@ lock_rec_unlock(
 
 	/* Check if we can now grant waiting lock requests */
 
+	const lock_t*	prev = NULL;
+
 	for (lock = first_lock; lock != NULL;
 	     lock = lock_rec_get_next(heap_no, lock)) {
 		if (!lock_get_wait(lock)) {
 			continue;
 		}
-		const lock_t* c = lock_rec_has_to_wait_in_queue(lock);
-		if (!c) {
-			/* Grant the lock */
-			ut_ad(trx != lock->trx);
-			lock_grant(lock);
-#ifdef WITH_WSREP
-		} else {
-			wsrep_assert_no_bf_bf_wait(c, lock, c->trx);
-#endif /* WITH_WSREP */
-		}
+		ut_ad(trx != lock->trx);
+		lock_rec_grant_or_update_blocker(lock, prev);
+		prev = lock;
 	}
 
 	lock_sys.mutex_unlock();
@@ -4793,7 +4845,9 @@ lock_rec_insert_check_and_lock(
 	ulint		heap_no = page_rec_get_heap_no(next_rec);
 	ut_ad(!rec_is_metadata(next_rec, *index));
 
-	lock_sys.mutex_lock();
+	/* In the most common case, there are no locks on the successor
+	record, and we do not need the exclusive lock_sys latch. */
+	srw_mutex*	latch = lock_sys.rd_lock_page(block->page.id());
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -4805,10 +4859,21 @@ lock_rec_insert_check_and_lock(
 
 	lock = lock_rec_get_first(&lock_sys.rec_hash, block, heap_no);
 
+	if (lock) {
+		lock_sys.rd_unlock_page(latch);
+		latch = NULL;
+		lock_sys.mutex_lock();
+		lock = lock_rec_get_first(&lock_sys.rec_hash, block, heap_no);
+	}
+
 	if (lock == NULL) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_sys.mutex_unlock();
+		if (latch) {
+			lock_sys.rd_unlock_page(latch);
+		} else {
+			lock_sys.mutex_unlock();
+		}
 
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -4825,6 +4890,7 @@ lock_rec_insert_check_and_lock(
 	/* Spatial index does not use GAP lock protection. It uses
 	"predicate lock" to protect the "range" */
 	if (dict_index_is_spatial(index)) {
+		lock_sys.mutex_unlock();
 		return(DB_SUCCESS);
 	}
 
@@ -5907,7 +5973,7 @@ lock_trx_has_expl_x_lock(
 print a heading message to stderr if printing of all deadlocks to stderr
 is enabled. */
 void
-DeadlockChecker::start_print()
+Deadlock::start_print()
 {
 	lock_sys.mutex_assert_locked();
 
@@ -5923,7 +5989,7 @@ DeadlockChecker::start_print()
 /** Print a message to the deadlock file and possibly to stderr.
 @param msg message to print */
 void
-DeadlockChecker::print(const char* msg)
+Deadlock::print(const char* msg)
 {
 	fputs(msg, lock_latest_err_file);
 
@@ -5936,7 +6002,7 @@ DeadlockChecker::print(const char* msg)
 @param trx transaction
 @param max_query_len max query length to print */
 void
-DeadlockChecker::print(const trx_t* trx, ulint max_query_len)
+Deadlock::print(const trx_t* trx, ulint max_query_len)
 {
 	lock_sys.mutex_assert_locked();
 
@@ -5956,7 +6022,7 @@ DeadlockChecker::print(const trx_t* trx, ulint max_query_len)
 /** Print lock data to the deadlock file and possibly to stderr.
 @param lock record or table type lock */
 void
-DeadlockChecker::print(const lock_t* lock)
+Deadlock::print(const lock_t* lock)
 {
 	lock_sys.mutex_assert_locked();
 
@@ -5976,324 +6042,246 @@ DeadlockChecker::print(const lock_t* lock)
 	}
 }
 
-/** Get the next lock in the queue that is owned by a transaction whose
-sub-tree has not already been searched.
-Note: "next" here means PREV for table locks.
-
-@param lock Lock in queue
-@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
-
-@return next lock or NULL if at end of queue */
-const lock_t*
-DeadlockChecker::get_next_lock(const lock_t* lock, ulint heap_no) const
+/** Find a cycle on the wait-for path that starts from a
+transaction, using Brent's cycle detection algorithm.
+@param[in]	trx	waiting transaction
+@return a transaction on the cycle
+@retval	NULL if there is no cycle */
+trx_t*
+Deadlock::find_cycle(trx_t* trx)
 {
 	lock_sys.mutex_assert_locked();
 
-	do {
-		if (lock_get_type_low(lock) == LOCK_REC) {
-			ut_ad(heap_no != ULINT_UNDEFINED);
-			lock = lock_rec_get_next_const(heap_no, lock);
-		} else {
-			ut_ad(heap_no == ULINT_UNDEFINED);
-			ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
+	/* The tortoise is teleported to the position of the hare
+	whenever the number of steps reaches a power of 2. Each
+	transaction waits for at most one other transaction, so the
+	path ends or enters a cycle that the hare will run through. */
+	trx_t*	tortoise = trx;
+	trx_t*	hare = trx;
 
-			lock = UT_LIST_GET_NEXT(
-				un_member.tab_lock.locks, lock);
+	for (ulint power = 1, l = 1; (hare = next(hare)) != NULL; l++) {
+		if (tortoise == hare) {
+			return(hare);
 		}
 
-	} while (lock != NULL && is_visited(lock));
-
-	ut_ad(lock == NULL
-	      || lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
+		if (l == power) {
+			tortoise = hare;
+			power <<= 1;
+			l = 0;
+		}
+	}
 
-	return(lock);
+	return(NULL);
 }
 
-/** Get the first lock to search. The search starts from the current
-wait_lock. What we are really interested in is an edge from the
-current wait_lock's owning transaction to another transaction that has
-a lock ahead in the queue. We skip locks where the owning transaction's
-sub-tree has already been searched.
-
-Note: The record locks are traversed from the oldest lock to the
-latest. For table locks we go from latest to oldest.
-
-For record locks, we first position the "iterator" on the first lock on
-the page and then reposition on the actual heap_no. This is required
-due to the way the record lock has is implemented.
-
-@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
-@return first lock or NULL */
+/** @return a lock that a waiting lock request has to wait for
+@param[in]	wait_lock	waiting lock request
+@retval	NULL if wait_lock could be granted */
 const lock_t*
-DeadlockChecker::get_first_lock(ulint* heap_no) const
+Deadlock::get_blocker(const lock_t* wait_lock)
+{
+	return(lock_get_type_low(wait_lock) == LOCK_REC
+	       ? lock_rec_has_to_wait_in_queue(wait_lock)
+	       : lock_table_has_to_wait_in_queue(wait_lock));
+}
+
+/** Check if trx->lock.wait_lock has to wait for a lock that
+another transaction holds or requests ahead of it in the queue.
+@param[in]	trx	waiting transaction
+@param[in]	blocker	transaction that trx->lock.wait_trx was set to
+@return whether the wait-for edge is valid */
+bool
+Deadlock::is_waiting_for(const trx_t* trx, const trx_t* blocker)
 {
 	lock_sys.mutex_assert_locked();
 
-	const lock_t*	lock = m_wait_lock;
+	const lock_t*	wait_lock = trx->lock.wait_lock;
+	ut_ad(wait_lock);
 
-	if (lock_get_type_low(lock) == LOCK_REC) {
-		/* We are only interested in records that match the heap_no. */
-		*heap_no = lock_rec_find_set_bit(lock);
-
-		ut_ad(*heap_no <= 0xffff);
-		ut_ad(*heap_no != ULINT_UNDEFINED);
-
-		/* Find the locks on the page. */
-		lock = lock_sys.get_first(
-			lock->type_mode & LOCK_PREDICATE
-			? lock_sys.prdt_hash
-			: lock_sys.rec_hash,
-			lock->un_member.rec_lock.page_id);
-
-		/* Position on the first lock on the physical record.*/
-		if (!lock_rec_get_nth_bit(lock, *heap_no)) {
-			lock = lock_rec_get_next_const(*heap_no, lock);
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		const ulint	heap_no = lock_rec_find_set_bit(wait_lock);
+
+		for (const lock_t* lock = lock_sys.get_first(
+			     *lock_hash_get(wait_lock->type_mode),
+			     wait_lock->un_member.rec_lock.page_id);
+		     lock != wait_lock;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
+			if (lock->trx == blocker
+			    && lock_rec_get_nth_bit(lock, heap_no)
+			    && lock_has_to_wait(wait_lock, lock)) {
+				return(true);
+			}
 		}
-
-		ut_a(!lock_get_wait(lock));
 	} else {
-		/* Table locks don't care about the heap_no. */
-		*heap_no = ULINT_UNDEFINED;
-		ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
-		dict_table_t*	table = lock->un_member.tab_lock.table;
-		lock = UT_LIST_GET_FIRST(table->locks);
+		for (const lock_t* lock = UT_LIST_GET_FIRST(
+			     wait_lock->un_member.tab_lock.table->locks);
+		     lock != wait_lock;
+		     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
+			if (lock->trx == blocker
+			    && lock_has_to_wait(wait_lock, lock)) {
+				return(true);
+			}
+		}
 	}
 
-	/* Must find at least two locks, otherwise there cannot be a
-	waiting lock, secondly the first lock cannot be the wait_lock. */
-	ut_a(lock != NULL);
-	ut_a(lock != m_wait_lock);
-
-	/* Check that the lock type doesn't change. */
-	ut_ad(lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
-
-	return(lock);
+	return(false);
 }
 
-/** Notify that a deadlock has been detected and print the conflicting
-transaction info.
-@param lock lock causing deadlock */
+/** Report the lock requests that a waiting lock request has to wait
+for with thd_rpl_deadlock_check().
+@param[in]	wait_lock	waiting lock request */
 void
-DeadlockChecker::notify(const lock_t* lock) const
+Deadlock::report_waits(const lock_t* wait_lock)
 {
 	lock_sys.mutex_assert_locked();
 
-	start_print();
+	THD*	thd = wait_lock->trx->mysql_thd;
 
-	print("\n*** (1) TRANSACTION:\n");
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		const ulint	heap_no = lock_rec_find_set_bit(wait_lock);
 
-	print(m_wait_lock->trx, 3000);
-
-	print("*** (1) WAITING FOR THIS LOCK TO BE GRANTED:\n");
-
-	print(m_wait_lock);
-
-	print("*** (2) TRANSACTION:\n");
-
-	print(lock->trx, 3000);
-
-	print("*** (2) HOLDS THE LOCK(S):\n");
-
-	print(lock);
-
-	/* It is possible that the joining transaction was granted its
-	lock when we rolled back some other waiting transaction. */
-
-	if (m_start->lock.wait_lock != 0) {
-		print("*** (2) WAITING FOR THIS LOCK TO BE GRANTED:\n");
-
-		print(m_start->lock.wait_lock);
+		for (const lock_t* lock = lock_sys.get_first(
+			     *lock_hash_get(wait_lock->type_mode),
+			     wait_lock->un_member.rec_lock.page_id);
+		     lock != wait_lock;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
+			if (lock_rec_get_nth_bit(lock, heap_no)
+			    && lock_has_to_wait(wait_lock, lock)) {
+				thd_rpl_deadlock_check(thd,
+						       lock->trx->mysql_thd);
+			}
+		}
+	} else {
+		for (const lock_t* lock = UT_LIST_GET_FIRST(
+			     wait_lock->un_member.tab_lock.table->locks);
+		     lock != wait_lock;
+		     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
+			/* We do not need to report autoinc locks to the
+			upper layer. These locks are released before
+			commit, so they can not cause deadlocks with
+			binlog-fixed commit order. */
+			if (lock_get_mode(lock) != LOCK_AUTO_INC
+			    && lock_has_to_wait(wait_lock, lock)) {
+				thd_rpl_deadlock_check(thd,
+						       lock->trx->mysql_thd);
+			}
+		}
 	}
-
-	DBUG_PRINT("ib_lock", ("deadlock detected"));
 }
 
-/** Select the victim transaction that should be rolledback.
-@return victim transaction */
-const trx_t*
-DeadlockChecker::select_victim() const
+/** @return whether a is a better deadlock victim than b
+@param[in]	a	transaction
+@param[in]	b	transaction */
+static bool lock_deadlock_better_victim(const trx_t* a, const trx_t* b)
 {
-	lock_sys.mutex_assert_locked();
-	ut_ad(m_start->lock.wait_lock != 0);
-	ut_ad(m_wait_lock->trx != m_start);
-
-	if (trx_weight_ge(m_wait_lock->trx, m_start)) {
-		/* The joining transaction is 'smaller',
-		choose it as the victim and roll it back. */
 #ifdef WITH_WSREP
-		if (wsrep_thd_is_BF(m_start->mysql_thd, FALSE)) {
-			return(m_wait_lock->trx);
-		}
-#endif /* WITH_WSREP */
-		return(m_start);
-	}
+	const bool	a_bf = wsrep_thd_is_BF(a->mysql_thd, FALSE);
 
-#ifdef WITH_WSREP
-	if (wsrep_thd_is_BF(m_wait_lock->trx->mysql_thd, FALSE)) {
-		return(m_start);
+	if (a_bf != wsrep_thd_is_BF(b->mysql_thd, FALSE)) {
+		return(!a_bf);
 	}
 #endif /* WITH_WSREP */
-
-	return(m_wait_lock->trx);
+	return(!trx_weight_ge(a, b));
 }
 
-/** Looks iteratively for a deadlock. Note: the joining transaction may
-have been granted its lock by the deadlock checks.
-@return 0 if no deadlock else the victim transaction instance.*/
+/** Find and resolve deadlocks that a transaction is part of or
+is waiting for.
+@param[in,out]	trx	waiting transaction
+@param[in]	self	whether the caller is serving trx and will
+			handle the case that trx is chosen as the victim
+@return the last chosen victim
+@retval	NULL if there is no deadlock (any more) */
 const trx_t*
-DeadlockChecker::search()
+Deadlock::resolve(trx_t* trx, bool self)
 {
 	lock_sys.mutex_assert_locked();
 
-	ut_ad(m_start != NULL);
-	ut_ad(m_wait_lock != NULL);
-	check_trx_state(m_wait_lock->trx);
-	ut_ad(m_mark_start <= s_lock_mark_counter);
-
-	/* Look at the locks ahead of wait_lock in the lock queue. */
-	ulint		heap_no;
-	const lock_t*	lock = get_first_lock(&heap_no);
-
 	for (;;) {
-		/* We should never visit the same sub-tree more than once. */
-		ut_ad(lock == NULL || !is_visited(lock));
-
-		while (m_n_elems > 0 && lock == NULL) {
-
-			/* Restore previous search state. */
+		trx_t*	cycle = find_cycle(trx);
 
-			pop(lock, heap_no);
-
-			lock = get_next_lock(lock, heap_no);
+		if (!cycle) {
+			return(NULL);
 		}
 
-		if (lock == NULL) {
-			break;
-		}
-
-		if (lock == m_wait_lock) {
-
-			/* We can mark this subtree as searched */
-			ut_ad(lock->trx->lock.deadlock_mark <= m_mark_start);
-
-			lock->trx->lock.deadlock_mark = ++s_lock_mark_counter;
-
-			/* We are not prepared for an overflow. This 64-bit
-			counter should never wrap around. At 10^9 increments
-			per second, it would take 10^3 years of uptime. */
+		/* The edges are not updated for every change of the lock
+		queues, for example when a lock request is moved to another
+		record. Validate the cycle before choosing a victim. */
+		trx_t*	t = cycle;
+		bool	valid = true;
+
+		do {
+			if (!is_waiting_for(t, t->lock.wait_trx)) {
+				const lock_t* c = get_blocker(
+					t->lock.wait_lock);
+				t->lock.wait_trx = c ? c->trx : NULL;
+				valid = false;
+				break;
+			}
 
-			ut_ad(s_lock_mark_counter > 0);
+			t = t->lock.wait_trx;
+		} while (t != cycle);
 
-			/* Backtrack */
-			lock = NULL;
+		if (!valid) {
 			continue;
 		}
 
-		if (!lock_has_to_wait(m_wait_lock, lock)) {
-			/* No conflict, next lock */
-			lock = get_next_lock(lock, heap_no);
-			continue;
-		}
-
-		if (lock->trx == m_start) {
-			/* Found a cycle. */
-			notify(lock);
-			return select_victim();
-		}
-
-		if (is_too_deep()) {
-			/* Search too deep to continue. */
-			m_too_deep = true;
-			return m_start;
-		}
-
-		/* We do not need to report autoinc locks to the upper
-		layer. These locks are released before commit, so they
-		can not cause deadlocks with binlog-fixed commit
-		order. */
-		if (m_report_waiters
-		    && (lock_get_type_low(lock) != LOCK_TABLE
-			|| lock_get_mode(lock) != LOCK_AUTO_INC)) {
-			thd_rpl_deadlock_check(m_start->mysql_thd,
-					       lock->trx->mysql_thd);
-		}
-
-		if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
-			/* Another trx ahead has requested a lock in an
-			incompatible mode, and is itself waiting for a lock. */
-
-			++m_cost;
-
-			if (!push(lock, heap_no)) {
-				m_too_deep = true;
-				return m_start;
-			}
-
-			m_wait_lock = lock->trx->lock.wait_lock;
-
-			lock = get_first_lock(&heap_no);
-
-			if (is_visited(lock)) {
-				lock = get_next_lock(lock, heap_no);
+		start_print();
+
+		trx_t*	victim = NULL;
+		ulint	victim_no = 0;
+		ulint	n = 0;
+		char	buf[40];
+
+		do {
+			snprintf(buf, sizeof buf,
+				 "\n*** (" ULINTPF ") TRANSACTION:\n", ++n);
+			print(buf);
+			print(t, 3000);
+			print("*** WAITING FOR THIS LOCK TO BE GRANTED:\n");
+			print(t->lock.wait_lock);
+
+			/* On a tie, prefer the transaction that
+			is being checked. */
+			if (!victim || lock_deadlock_better_victim(t, victim)
+			    || (t == trx
+				&& !lock_deadlock_better_victim(victim, t))) {
+				victim = t;
+				victim_no = n;
 			}
-		} else {
-			lock = get_next_lock(lock, heap_no);
-		}
-	}
 
-	ut_a(lock == NULL && m_n_elems == 0);
+			t = t->lock.wait_trx;
+		} while (t != cycle);
 
-	/* No deadlock found. */
-	return(0);
-}
+		snprintf(buf, sizeof buf,
+			 "*** WE ROLL BACK TRANSACTION (" ULINTPF ")\n",
+			 victim_no);
+		print(buf);
+		DBUG_PRINT("ib_lock", ("deadlock detected"));
 
-/** Print info about transaction that was rolled back.
-@param trx transaction rolled back
-@param lock lock trx wants */
-void
-DeadlockChecker::rollback_print(const trx_t* trx, const lock_t* lock)
-{
-	lock_sys.mutex_assert_locked();
-
-	/* If the lock search exceeds the max step
-	or the max depth, the current trx will be
-	the victim. Print its information. */
-	start_print();
-
-	print("TOO DEEP OR LONG SEARCH IN THE LOCK TABLE"
-	      " WAITS-FOR GRAPH, WE WILL ROLL BACK"
-	      " FOLLOWING TRANSACTION \n\n"
-	      "*** TRANSACTION:\n");
-
-	print(trx, 3000);
-
-	print("*** WAITING FOR THIS LOCK TO BE GRANTED:\n");
-
-	print(lock);
-}
-
-/** Rollback transaction selected as the victim. */
-void
-DeadlockChecker::trx_rollback()
-{
-	lock_sys.mutex_assert_locked();
-
-	trx_t*	trx = m_wait_lock->trx;
+		lock_deadlock_found = true;
+		MONITOR_INC(MONITOR_DEADLOCK);
+		srv_stats.lock_deadlock_count.inc();
 
-	print("*** WE ROLL BACK TRANSACTION (1)\n");
 #ifdef WITH_WSREP
-	if (trx->is_wsrep() && wsrep_thd_is_SR(trx->mysql_thd)) {
-		wsrep_handle_SR_rollback(m_start->mysql_thd, trx->mysql_thd);
-	}
+		if (victim->is_wsrep() && wsrep_thd_is_SR(victim->mysql_thd)) {
+			wsrep_handle_SR_rollback(trx->mysql_thd,
+						 victim->mysql_thd);
+		}
 #endif
 
-	trx->mutex.wr_lock();
-
-	trx->lock.was_chosen_as_deadlock_victim = true;
+		if (victim == trx && self) {
+			return(victim);
+		}
 
-	lock_cancel_waiting_and_release(trx->lock.wait_lock);
+		victim->mutex.wr_lock();
+		victim->lock.was_chosen_as_deadlock_victim = true;
+		lock_cancel_waiting_and_release(victim->lock.wait_lock);
+		victim->mutex.wr_unlock();
 
-	trx->mutex.wr_unlock();
+		if (victim == trx) {
+			return(victim);
+		}
+	}
 }
 
 /** Check if a joining lock request results in a deadlock.
@@ -6308,84 +6296,68 @@ We will attempt to resolve all deadlocks.
 @retval	NULL if another victim was chosen,
 or there is no deadlock (any more) */
 const trx_t*
-DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
+Deadlock::check_and_resolve(const lock_t* lock, trx_t* trx)
 {
 	lock_sys.mutex_assert_locked();
 	check_trx_state(trx);
 	ut_ad(!srv_read_only_mode);
+	ut_ad(trx->lock.wait_lock == lock);
+
+	const lock_t*	c = get_blocker(lock);
+
+	trx->lock.wait_trx = c ? c->trx : NULL;
+	trx->lock.deadlock_check = false;
 
 	if (!innobase_deadlock_detect) {
 		return(NULL);
 	}
 
 	/*  Release the mutex to obey the latching order.
-	This is safe, because DeadlockChecker::check_and_resolve()
+	This is safe, because Deadlock::check_and_resolve()
 	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because m_trx is a running transaction
+	running transaction. Because trx is a running transaction
 	(it is not currently suspended because of a lock wait),
 	its state can only be changed by this thread, which is
 	currently associated with the transaction. */
 
 	trx->mutex.wr_unlock();
 
-	const trx_t*	victim_trx;
-	const bool	report_waiters = trx->mysql_thd
-		&& thd_need_wait_reports(trx->mysql_thd);
-
-	/* Try and resolve as many deadlocks as possible. */
-	do {
-		DeadlockChecker	checker(trx, lock, s_lock_mark_counter,
-					report_waiters);
-
-		victim_trx = checker.search();
-
-		/* Search too deep, we rollback the joining transaction only
-		if it is possible to rollback. Otherwise we rollback the
-		transaction that is holding the lock that the joining
-		transaction wants. */
-		if (checker.is_too_deep()) {
-
-			ut_ad(trx == checker.m_start);
-			ut_ad(trx == victim_trx);
-
-			rollback_print(victim_trx, lock);
-
-			MONITOR_INC(MONITOR_DEADLOCK);
-			srv_stats.lock_deadlock_count.inc();
-
-			break;
-
-		} else if (victim_trx != NULL && victim_trx != trx) {
-
-			ut_ad(victim_trx == checker.m_wait_lock->trx);
+	if (trx->mysql_thd && thd_need_wait_reports(trx->mysql_thd)) {
+		report_waits(lock);
+	}
 
-			checker.trx_rollback();
+	const trx_t*	victim_trx = resolve(trx, true);
 
-			lock_deadlock_found = true;
+	trx->mutex.wr_lock();
 
-			MONITOR_INC(MONITOR_DEADLOCK);
-			srv_stats.lock_deadlock_count.inc();
-		}
+	return(victim_trx);
+}
 
-	} while (victim_trx != NULL && victim_trx != trx);
+/** Check for a deadlock if the transaction that a lock wait
+is waiting for was changed after the wait was enqueued.
+@param[in,out]	trx	transaction that is waiting for a lock */
+void
+Deadlock::check_waiting(trx_t* trx)
+{
+	lock_sys.mutex_assert_locked();
 
-	/* If the joining transaction was selected as the victim. */
-	if (victim_trx != NULL) {
+	if (!trx->lock.deadlock_check) {
+		return;
+	}
 
-		print("*** WE ROLL BACK TRANSACTION (2)\n");
-#ifdef WITH_WSREP
-		if (trx->is_wsrep() && wsrep_thd_is_SR(trx->mysql_thd)) {
-			wsrep_handle_SR_rollback(trx->mysql_thd,
-						 victim_trx->mysql_thd);
-		}
-#endif
+	trx->lock.deadlock_check = false;
 
-		lock_deadlock_found = true;
+	if (innobase_deadlock_detect && trx->lock.wait_lock) {
+		resolve(trx, false);
 	}
+}
 
-	trx->mutex.wr_lock();
-
-	return(victim_trx);
+/** Check for a deadlock if the transaction that a lock wait
+is waiting for was changed after the wait was enqueued.
+@param[in,out]	trx	transaction that is waiting for a lock */
+void lock_wait_deadlock_check(trx_t* trx)
+{
+	Deadlock::check_waiting(trx);
 }
 
 /*************************************************************//**
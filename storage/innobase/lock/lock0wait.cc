@@ -491,7 +491,17 @@ void lock_wait_timeout_task(void*)
   }
 
   if (any_slot_in_use)
+  {
+    /* Look for deadlocks that were formed when a lock wait started to
+    wait for another transaction because a lock was released. */
+    lock_sys.mutex_lock();
+    for (srv_slot_t *slot= lock_sys.waiting_threads;
+         slot < lock_sys.last_slot; ++slot)
+      if (slot->in_use)
+        lock_wait_deadlock_check(thr_get_trx(slot->thr));
+    lock_sys.mutex_unlock();
     lock_sys.timeout_timer->set_time(1000, 0);
+  }
   else
     lock_sys.timeout_timer_active= false;
 
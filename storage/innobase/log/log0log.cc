@@ -97,6 +97,8 @@ void log_buffer_extend(ulong len)
 		" exceeds innodb_log_buffer_size="
 		<< srv_log_buffer_size << " / 2). Trying to extend it.";
 
+	log_sys.wait_for_copies();
+
 	byte* old_buf = log_sys.buf;
 	byte* old_flush_buf = log_sys.flush_buf;
 	const ulong old_buf_size = srv_log_buffer_size;
@@ -196,6 +198,7 @@ void log_t::create()
 
   max_buf_free= srv_log_buffer_size / LOG_BUF_FLUSH_RATIO -
     LOG_BUF_FLUSH_MARGIN;
+  n_pending_copies= 0;
   set_check_flush_or_checkpoint();
 
   n_log_ios_old= n_log_ios;
@@ -687,6 +690,8 @@ static void log_write(bool rotate_key)
 			      log_sys.get_lsn()));
 
 
+	log_sys.wait_for_copies();
+
 	start_offset = log_sys.buf_next_to_write;
 	end_offset = log_sys.buf_free;
 
@@ -764,6 +769,75 @@ static void log_write(bool rotate_key)
 static group_commit_lock write_lock;
 static group_commit_lock flush_lock;
 
+/** Statistics of the log flushes, for innodb_flush_log_delay_usec */
+static struct
+{
+  /** moving average of the duration of a log write and flush,
+  in microseconds */
+  Atomic_relaxed<ulint> flush_usec;
+  /** moving average of the interval between the flush requests,
+  in microseconds */
+  Atomic_relaxed<ulint> request_usec;
+  /** my_interval_timer() at the start of the previous flush */
+  Atomic_relaxed<ulonglong> last_start;
+} log_flush_stats;
+
+/** Update a moving average of log_flush_stats.
+@param avg     current average
+@param sample  new sample
+@return new average */
+static ulint log_flush_avg(ulint avg, ulint sample)
+{
+  return (avg * 7 + sample) / 8;
+}
+
+/** Possibly wait before a log write and flush, so that more flush
+requests can be completed by it. This is only worth it if a flush takes
+much longer than the wait and if more requests are expected to arrive
+during the wait.
+@return my_interval_timer() at the start of the flush */
+static ulonglong log_flush_delay()
+{
+  if (const ulint max_delay= srv_flush_log_delay_usec)
+  {
+    const ulint delay= std::min<ulint>(max_delay,
+                                       log_flush_stats.flush_usec / 2);
+    if (delay && log_flush_stats.request_usec < delay)
+    {
+      MONITOR_INC(MONITOR_LOG_FLUSH_DELAYED);
+      MONITOR_INC_VALUE(MONITOR_LOG_FLUSH_DELAY_USEC, delay);
+      os_thread_sleep(delay);
+    }
+  }
+
+  return my_interval_timer();
+}
+
+/** Account for a completed log flush in log_flush_stats.
+@param start  return value of log_flush_delay()
+@param n      number of flush requests that the flush completed */
+static void log_flush_account(ulonglong start, ulint n)
+{
+  const ulonglong now= my_interval_timer();
+  const ulonglong last= log_flush_stats.last_start;
+  log_flush_stats.last_start= start;
+  log_flush_stats.flush_usec= log_flush_avg(log_flush_stats.flush_usec,
+                                            ulint((now - start) / 1000));
+  if (last && start > last)
+    /* Do not let an idle period dominate the average. */
+    log_flush_stats.request_usec=
+      log_flush_avg(log_flush_stats.request_usec,
+                    ulint(std::min<ulonglong>(start - last, 1000000000)
+                          / 1000 / n));
+
+  ulint b= 0;
+  while (n >>= 1)
+    b++;
+  const monitor_id_t m= monitor_id_t(MONITOR_LOG_FLUSH_BATCH_1 +
+                                     std::min<ulint>(b, 5));
+  MONITOR_ATOMIC_INC(m);
+}
+
 #ifdef UNIV_DEBUG
 bool log_write_lock_own()
 {
@@ -791,10 +865,13 @@ void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key)
     return;
   }
 
-  if (flush_to_disk &&
-    flush_lock.acquire(lsn) != group_commit_lock::ACQUIRED)
+  ulonglong flush_start= 0;
+
+  if (flush_to_disk)
   {
-    return;
+    if (flush_lock.acquire(lsn) != group_commit_lock::ACQUIRED)
+      return;
+    flush_start= log_flush_delay();
   }
 
   if (write_lock.acquire(lsn) == group_commit_lock::ACQUIRED)
@@ -818,7 +895,7 @@ void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key)
   auto flush_lsn = write_lock.value();
   flush_lock.set_pending(flush_lsn);
   log_write_flush_to_disk_low(flush_lsn);
-  flush_lock.release(flush_lsn);
+  log_flush_account(flush_start, flush_lock.release(flush_lsn) + 1);
 
   innobase_mysql_log_notify(flush_lsn);
 }
@@ -0,0 +1,306 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file log/log0online.cc
+Changed page tracking for incremental backups (innodb_track_changed_pages)
+
+The file format is the one of the XtraDB changed page bitmaps, which
+extra/mariabackup/changed_page_bitmap.cc reads.
+*******************************************************/
+
+#include "log0online.h"
+#include "log0log.h"
+#include "os0file.h"
+#include "srv0srv.h"
+#include "srw_lock.h"
+#include <set>
+#include <vector>
+
+/** innodb_track_changed_pages */
+my_bool srv_track_changed_pages;
+
+/** Whether changed pages are being tracked */
+bool log_online_enabled;
+
+/** File name stem of the bitmap files */
+static const char *const bmp_file_name_stem= "ib_modified_log_";
+
+/** Size of a bitmap file after which a new file is started */
+static constexpr os_offset_t bmp_file_max_size= 100 << 20;
+
+/** The bitmap file block size in bytes. */
+static constexpr ulint MODIFIED_PAGE_BLOCK_SIZE= 4096;
+
+/** Offsets in a bitmap file block */
+enum
+{
+  /** 1 if last block in the current run, 0 otherwise */
+  MODIFIED_PAGE_IS_LAST_BLOCK= 0,
+  /** The starting LSN of the run */
+  MODIFIED_PAGE_START_LSN= 4,
+  /** The ending LSN of the run */
+  MODIFIED_PAGE_END_LSN= 12,
+  /** The tablespace id of the tracked pages in this block */
+  MODIFIED_PAGE_SPACE_ID= 20,
+  /** The page number of the first page that this block covers */
+  MODIFIED_PAGE_1ST_PAGE_ID= 24,
+  /** The bitmap, in native byte order 64-bit words */
+  MODIFIED_PAGE_BLOCK_BITMAP= 32,
+  /** Unused, in order to align the end of the bitmap at 8 bytes */
+  MODIFIED_PAGE_BLOCK_UNUSED_2= MODIFIED_PAGE_BLOCK_SIZE - 8,
+  /** The checksum of the block */
+  MODIFIED_PAGE_BLOCK_CHECKSUM= MODIFIED_PAGE_BLOCK_SIZE - 4
+};
+
+/** Number of pages that one bitmap block covers */
+static constexpr uint32_t MODIFIED_PAGE_BLOCK_ID_COUNT=
+  (MODIFIED_PAGE_BLOCK_UNUSED_2 - MODIFIED_PAGE_BLOCK_BITMAP) * 8;
+
+/** The state of changed page tracking */
+static struct
+{
+  /** Pages modified since the previous run; protected by log_sys.mutex */
+  std::set<page_id_t> pages;
+  /** Serializes log_online_write() */
+  srw_mutex mutex;
+  /** End LSN of the previous run; protected by mutex */
+  lsn_t end_lsn;
+  /** Sequence number of the current file; protected by mutex */
+  ulong seq;
+  /** The current file; protected by mutex */
+  pfs_os_file_t file;
+  /** Size of the current file; protected by mutex */
+  os_offset_t size;
+} log_online;
+
+/** Calculate the checksum of a bitmap block, in the same way
+as log_block_calc_checksum_format_0().
+@param block  bitmap block
+@return checksum */
+static uint32_t log_online_calc_checksum(const byte *block)
+{
+  ulint sum= 1;
+  ulint sh= 0;
+
+  for (ulint i= 0; i < MODIFIED_PAGE_BLOCK_CHECKSUM; i++)
+  {
+    ulint b= block[i];
+    sum&= 0x7FFFFFFFUL;
+    sum+= b;
+    sum+= b << sh;
+    if (++sh > 24)
+      sh= 0;
+  }
+
+  return static_cast<uint32_t>(sum);
+}
+
+/** Create the next bitmap file.
+@param start_lsn  the start LSN of its first run
+@return whether the file was created */
+static bool log_online_create_file(lsn_t start_lsn)
+{
+  char name[FN_REFLEN];
+  bool success;
+
+  snprintf(name, sizeof name, "%s%s%lu_" LSN_PF ".xdb", srv_data_home,
+           bmp_file_name_stem, ++log_online.seq, start_lsn);
+  log_online.file= os_file_create_simple_no_error_handling(
+    innodb_log_file_key, name, OS_FILE_CREATE, OS_FILE_READ_WRITE, false,
+    &success);
+  if (!success)
+  {
+    ib::error() << "Cannot create the changed page bitmap file " << name;
+    return false;
+  }
+  log_online.size= 0;
+  return true;
+}
+
+/** Start tracking changed pages after the redo log was recovered.
+@param lsn  the current LSN */
+void log_online_init(lsn_t lsn)
+{
+  ut_ad(!log_online_enabled);
+
+  if (!srv_track_changed_pages || srv_read_only_mode)
+    return;
+
+  /* Continue the sequence numbers of the existing files, so that
+  mariabackup sees the files in the order in which they were written. */
+  log_online.seq= 0;
+  if (os_file_dir_t dir= os_file_opendir(srv_data_home, false))
+  {
+    os_file_stat_t info;
+    while (!os_file_readdir_next_file(srv_data_home, dir, &info))
+    {
+      char stem[FN_REFLEN];
+      ulong seq;
+      lsn_t start_lsn;
+      if (info.type == OS_FILE_TYPE_FILE &&
+          sscanf(info.name, "%[a-z_]%lu_" LSN_PF ".xdb", stem, &seq,
+                 &start_lsn) == 3 &&
+          !strcmp(stem, bmp_file_name_stem) && seq > log_online.seq)
+        log_online.seq= seq;
+    }
+    os_file_closedir(dir);
+  }
+
+  if (!log_online_create_file(lsn))
+  {
+    ib::warn() << "innodb_track_changed_pages is disabled";
+    return;
+  }
+
+  log_online.mutex.init();
+  log_online.end_lsn= lsn;
+  log_online_enabled= true;
+}
+
+/** Write the pages that were changed since the previous run and stop
+tracking changed pages. */
+void log_online_close()
+{
+  if (!log_online_enabled)
+    return;
+  log_online_write();
+  log_online.mutex.wr_lock();
+  log_online_enabled= false;
+  os_file_close(log_online.file);
+  log_online.mutex.wr_unlock();
+  log_online.mutex.destroy();
+  mysql_mutex_lock(&log_sys.mutex);
+  log_online.pages.clear();
+  mysql_mutex_unlock(&log_sys.mutex);
+}
+
+/** Note that a mini-transaction modified a page.
+The caller must hold log_sys.mutex.
+@param id  page identifier */
+void log_online_add(const page_id_t id)
+{
+  mysql_mutex_assert_owner(&log_sys.mutex);
+  ut_ad(log_online_enabled);
+  log_online.pages.insert(id);
+}
+
+/** Write a run of bitmap blocks.
+@param pages      the changed pages
+@param start_lsn  the end LSN of the previous run
+@param end_lsn    the end LSN of this run
+@return whether the run was written */
+static bool log_online_write_run(const std::set<page_id_t> &pages,
+                                 lsn_t start_lsn, lsn_t end_lsn)
+{
+  std::vector<byte> buf;
+  byte *block= nullptr;
+  uint32_t space_id= 0, first_page_no= 0;
+
+  for (const page_id_t id : pages)
+  {
+    const uint32_t first= id.page_no() - id.page_no() %
+      MODIFIED_PAGE_BLOCK_ID_COUNT;
+    if (!block || id.space() != space_id || first != first_page_no)
+    {
+      buf.resize(buf.size() + MODIFIED_PAGE_BLOCK_SIZE);
+      block= &buf[buf.size() - MODIFIED_PAGE_BLOCK_SIZE];
+      space_id= id.space();
+      first_page_no= first;
+      mach_write_to_4(block + MODIFIED_PAGE_SPACE_ID, space_id);
+      mach_write_to_4(block + MODIFIED_PAGE_1ST_PAGE_ID, first_page_no);
+    }
+    const uint32_t bit= id.page_no() - first_page_no;
+    reinterpret_cast<uint64_t*>(block + MODIFIED_PAGE_BLOCK_BITMAP)
+      [bit >> 6]|= 1ULL << (bit & 63);
+  }
+
+  /* A run without any pages still advances the tracked LSN. */
+  if (buf.empty())
+    buf.resize(MODIFIED_PAGE_BLOCK_SIZE);
+
+  for (ulint offset= 0; offset < buf.size();
+       offset+= MODIFIED_PAGE_BLOCK_SIZE)
+  {
+    block= &buf[offset];
+    mach_write_to_4(block + MODIFIED_PAGE_IS_LAST_BLOCK,
+                    offset + MODIFIED_PAGE_BLOCK_SIZE == buf.size());
+    mach_write_to_8(block + MODIFIED_PAGE_START_LSN, start_lsn);
+    mach_write_to_8(block + MODIFIED_PAGE_END_LSN, end_lsn);
+    mach_write_to_4(block + MODIFIED_PAGE_BLOCK_CHECKSUM,
+                    log_online_calc_checksum(block));
+  }
+
+  if (log_online.size >= bmp_file_max_size)
+  {
+    os_file_close(log_online.file);
+    if (!log_online_create_file(start_lsn))
+      return false;
+  }
+
+  if (os_file_write(IORequestWrite, "changed page bitmap", log_online.file,
+                    buf.data(), log_online.size, buf.size()) != DB_SUCCESS ||
+      !os_file_flush(log_online.file))
+    return false;
+
+  log_online.size+= buf.size();
+  return true;
+}
+
+/** Write the pages that were changed since the previous run as a run
+that ends at the current LSN. */
+void log_online_write()
+{
+  if (!log_online_enabled)
+    return;
+
+  mysql_mutex_assert_not_owner(&log_sys.mutex);
+  log_online.mutex.wr_lock();
+
+  if (!log_online_enabled)
+  {
+    log_online.mutex.wr_unlock();
+    return;
+  }
+
+  /* All pages that were modified up to end_lsn have been added under
+  log_sys.mutex, so that the run is complete. */
+  std::set<page_id_t> pages;
+  mysql_mutex_lock(&log_sys.mutex);
+  const lsn_t end_lsn= log_sys.get_lsn();
+  if (end_lsn > log_online.end_lsn)
+    pages.swap(log_online.pages);
+  mysql_mutex_unlock(&log_sys.mutex);
+
+  if (end_lsn > log_online.end_lsn)
+  {
+    if (log_online_write_run(pages, log_online.end_lsn, end_lsn))
+      log_online.end_lsn= end_lsn;
+    else
+    {
+      /* mariabackup notices the incomplete run and falls back to
+      scanning all pages. */
+      ib::error() << "Cannot write the changed page bitmap;"
+                     " innodb_track_changed_pages is disabled";
+      log_online_enabled= false;
+      os_file_close(log_online.file);
+    }
+  }
+
+  log_online.mutex.wr_unlock();
+}
@@ -59,6 +59,10 @@ Created 9/20/1997 Heikki Tuuri
 /** Read-ahead area in applying log records to file pages */
 #define RECV_READ_AHEAD_AREA	32U
 
+/** Minimum number of pages initialized by redo log records per
+srv_thread_pool task in recv_sys_t::apply() */
+#define RECV_INIT_PAGES_PER_TASK	64U
+
 /** The recovery system */
 recv_sys_t	recv_sys;
 /** TRUE when recv_init_crash_recovery() has been called. */
@@ -2398,7 +2402,10 @@ static void recv_recover_page(buf_block_t* block, mtr_t& mtr,
 
 		buf_block_modify_clock_inc(block);
 		mysql_mutex_lock(&log_sys.flush_order_mutex);
+		mysql_mutex_lock(&buf_pool.flush_list_mutex);
 		buf_flush_note_modification(block, start_lsn, end_lsn);
+		buf_pool.page_cleaner_wakeup();
+		mysql_mutex_unlock(&buf_pool.flush_list_mutex);
 		mysql_mutex_unlock(&log_sys.flush_order_mutex);
 	} else if (free_page && init) {
 		/* There have been no operations that modify the page.
@@ -2625,6 +2632,33 @@ buf_block_t *recv_sys_t::recover_low(const page_id_t page_id)
   return block;
 }
 
+/** Pages that are initialized by redo log records, shared by the
+recv_sys_t::recover_init_pages() tasks of recv_sys_t::apply() */
+struct recv_init_pages_t
+{
+  /** identifiers of the pages */
+  std::vector<page_id_t> pages;
+  /** next element of pages to recover */
+  std::atomic<size_t> next;
+};
+
+/** Recover pages that are initialized by redo log records.
+The log of each page is applied by one task only, which preserves
+the order of the records of the page.
+@param arg  recv_init_pages_t */
+void recv_sys_t::recover_init_pages(void *arg)
+{
+  recv_init_pages_t *init= static_cast<recv_init_pages_t*>(arg);
+  const size_t n= init->pages.size();
+
+  for (size_t i; (i= init->next.fetch_add(1, std::memory_order_relaxed)) < n; )
+  {
+    if (recv_sys.is_corrupt_log() || recv_sys.is_corrupt_fs())
+      break;
+    recv_sys.recover_low(init->pages[i]);
+  }
+}
+
 /** Apply buffered log to persistent data pages.
 @param last_batch     whether it is possible to write more redo log */
 void recv_sys_t::apply(bool last_batch)
@@ -2688,6 +2722,28 @@ void recv_sys_t::apply(bool last_batch)
         trim(page_id_t(id + srv_undo_space_id_start, t.pages), t.lsn);
     }
 
+    /* Pages that are initialized by the log need no reads. Let
+    srv_thread_pool tasks recover them while we are submitting the
+    reads of the other pages. */
+    recv_init_pages_t init;
+    std::vector<tpool::waitable_task*> tasks;
+
+    for (const map::value_type &p : pages)
+      if (p.second.state == page_recv_t::RECV_WILL_NOT_READ)
+        init.pages.push_back(p.first);
+
+    if (const size_t n_tasks= std::min<size_t>(srv_n_read_io_threads,
+                                               init.pages.size() /
+                                               RECV_INIT_PAGES_PER_TASK))
+    {
+      init.next= 0;
+      for (size_t i= 0; i < n_tasks; i++)
+      {
+        tasks.push_back(new tpool::waitable_task(recover_init_pages, &init));
+        srv_thread_pool->submit_task(tasks.back());
+      }
+    }
+
     buf_block_t *free_block= buf_LRU_get_free_block(false);
 
     for (map::iterator p= pages.begin(); p != pages.end(); )
@@ -2702,6 +2758,11 @@ void recv_sys_t::apply(bool last_batch)
         p++;
         continue;
       case page_recv_t::RECV_WILL_NOT_READ:
+        if (!tasks.empty())
+        {
+          p++;
+          continue;
+        }
         if (UNIV_LIKELY(!!recover_low(page_id, p, mtr, free_block)))
         {
           mysql_mutex_unlock(&mutex);
@@ -2738,6 +2799,17 @@ void recv_sys_t::apply(bool last_batch)
 
     buf_pool.free_block(free_block);
 
+    if (!tasks.empty())
+    {
+      mysql_mutex_unlock(&mutex);
+      for (tpool::waitable_task *task : tasks)
+      {
+        task->wait();
+        delete task;
+      }
+      mysql_mutex_lock(&mutex);
+    }
+
     /* Wait until all the pages have been processed */
     for (;;)
     {
@@ -3718,7 +3790,9 @@ bool recv_dblwr_t::validate_page(const page_id_t page_id,
   case FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED:
     if (space->zip_size())
       return false; /* ROW_FORMAT=COMPRESSED cannot be page_compressed */
-    ulint decomp= fil_page_decompress(tmp_frame, tmp_page, space->flags);
+    ulint decomp= fil_page_decompress(tmp_frame, tmp_page, space->flags,
+                                      space->zstd_dict.load(
+                                        std::memory_order_acquire));
     if (!decomp)
       return false; /* decompression failed */
     if (decomp == srv_page_size)
@@ -247,7 +247,7 @@ group_commit_lock::lock_return_code group_commit_lock::acquire(value_type num)
   return lock_return_code::EXPIRED;
 }
 
-void group_commit_lock::release(value_type num)
+unsigned group_commit_lock::release(value_type num)
 {
   std::unique_lock<std::mutex> lk(m_mtx);
   m_lock = false;
@@ -263,11 +263,14 @@ void group_commit_lock::release(value_type num)
   group_commit_waiter_t* cur, * prev, * next;
   group_commit_waiter_t* wakeup_list = nullptr;
   int extra_wake = 0;
+  unsigned n_satisfied = 0;
 
   for (prev= nullptr, cur= m_waiters_list; cur; cur= next)
   {
     next= cur->m_next;
-    if (cur->m_value <= num || extra_wake++ == 0)
+    const bool satisfied = cur->m_value <= num;
+    n_satisfied += satisfied;
+    if (satisfied || extra_wake++ == 0)
     {
       /* Move current waiter to wakeup_list*/
 
@@ -298,6 +301,7 @@ void group_commit_lock::release(value_type num)
     next= cur->m_next;
     cur->m_sema.wake();
   }
+  return n_satisfied;
 }
 
 #ifndef DBUG_OFF
@@ -43,6 +43,7 @@ Operations supported on this semaphore
 - releases lock
 - sets new current value to max(num,current_value)
 - releases some threads waiting in acquire()
+- returns the number of released threads whose wait was satisfied
 
 3. value()
 - read current value
@@ -71,7 +72,7 @@ class group_commit_lock
     EXPIRED
   };
   lock_return_code acquire(value_type num);
-  void release(value_type num);
+  unsigned release(value_type num);
   value_type value() const;
   value_type pending() const;
   void set_pending(value_type num);
@@ -32,6 +32,7 @@ Created 11/26/1995 Heikki Tuuri
 #include "page0types.h"
 #include "mtr0log.h"
 #include "log0recv.h"
+#include "log0online.h"
 #ifdef BTR_CUR_HASH_ADAPT
 # include "btr0sea.h"
 #endif
@@ -313,6 +314,28 @@ struct DebugCheck {
 };
 #endif
 
+/** Note the pages modified by the mini-transaction for
+innodb_track_changed_pages. */
+struct TrackChangedPages
+{
+  /** @return true always */
+  bool operator()(const mtr_memo_slot_t *slot) const
+  {
+    switch (slot->type) {
+    case MTR_MEMO_PAGE_X_MODIFY:
+    case MTR_MEMO_PAGE_SX_MODIFY:
+      if (const buf_block_t *block=
+          static_cast<const buf_block_t*>(slot->object))
+        if (block->page.id().space() != SRV_TMP_SPACE_ID)
+          log_online_add(block->page.id());
+      break;
+    default:
+      break;
+    }
+    return true;
+  }
+};
+
 /** Release page latches held by the mini-transaction. */
 struct ReleaseBlocks
 {
@@ -404,12 +427,17 @@ void mtr_t::commit()
     ut_ad(!srv_read_only_mode || m_log_mode == MTR_LOG_NO_REDO);
 
     std::pair<lsn_t,bool> lsns;
+    const ulint len= prepare_write();
 
-    if (const ulint len= prepare_write())
+    if (len)
       lsns= finish_write(len);
     else
       lsns= { m_commit_lsn, false };
 
+    if (log_online_enabled)
+      m_memo.for_each_block_in_reverse(CIterate<const TrackChangedPages>
+                                       (TrackChangedPages()));
+
     if (m_made_dirty)
       mysql_mutex_lock(&log_sys.flush_order_mutex);
 
@@ -440,11 +468,23 @@ void mtr_t::commit()
     else
       ut_ad(!m_freed_space);
 
+    /* Insert all the blocks that we made dirty while acquiring
+    buf_pool.flush_list_mutex only once. */
+    if (m_made_dirty)
+      mysql_mutex_lock(&buf_pool.flush_list_mutex);
+
     m_memo.for_each_block_in_reverse(CIterate<const ReleaseBlocks>
                                      (ReleaseBlocks(lsns.first, m_commit_lsn,
                                                     m_memo)));
     if (m_made_dirty)
+    {
+      buf_pool.page_cleaner_wakeup();
+      mysql_mutex_unlock(&buf_pool.flush_list_mutex);
       mysql_mutex_unlock(&log_sys.flush_order_mutex);
+    }
+
+    if (len)
+      copy_log();
 
     m_memo.for_each_block_in_reverse(CIterate<ReleaseLatches>());
 
@@ -490,6 +530,7 @@ void mtr_t::commit_files(lsn_t checkpoint_lsn)
 	}
 
 	finish_write(m_log.size());
+	copy_log();
 	srv_stats.log_write_requests.inc();
 	release_resources();
 
@@ -679,7 +720,7 @@ static void log_margin_checkpoint_age(ulint len)
 }
 
 
-/** Open the log for log_write_low(). The log must be closed with log_close().
+/** Open the log for log_reserve_low(). The log must be closed with log_close().
 @param len length of the data to be written
 @return start lsn of the log record */
 static lsn_t log_reserve_and_open(size_t len)
@@ -713,8 +754,11 @@ static lsn_t log_reserve_and_open(size_t len)
   return log_sys.get_lsn();
 }
 
-/** Append data to the log buffer. */
-static void log_write_low(const void *str, size_t size)
+/** Reserve space for data in the log buffer, and write the headers and
+trailers of the log blocks that the data will occupy. The data is
+copied by log_copy_low(), possibly after releasing log_sys.mutex.
+@param size  length of the data */
+static void log_reserve_low(size_t size)
 {
   mysql_mutex_assert_owner(&log_sys.mutex);
   const ulint trailer_offset= log_sys.trailer_offset();
@@ -731,10 +775,7 @@ static void log_write_low(const void *str, size_t size)
       len= trailer_offset - log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE;
     }
 
-    memcpy(log_sys.buf + log_sys.buf_free, str, len);
-
     size-= len;
-    str= static_cast<const char*>(str) + len;
 
     byte *log_block= static_cast<byte*>(ut_align_down(log_sys.buf +
                                                       log_sys.buf_free,
@@ -764,6 +805,35 @@ static void log_write_low(const void *str, size_t size)
   while (size);
 }
 
+/** Copy data to log buffer space that was reserved by log_reserve_low().
+@param buf     log_sys.buf at the time of the reservation
+@param offset  offset in buf to copy to; advanced past the data
+@param str     the data
+@param size    length of the data */
+static void log_copy_low(byte *buf, size_t &offset, const void *str,
+                         size_t size)
+{
+  const ulint trailer_offset= log_sys.trailer_offset();
+
+  do
+  {
+    size_t len= size;
+
+    if ((offset % OS_FILE_LOG_BLOCK_SIZE) + size > trailer_offset)
+      len= trailer_offset - offset % OS_FILE_LOG_BLOCK_SIZE;
+
+    memcpy(buf + offset, str, len);
+
+    size-= len;
+    str= static_cast<const char*>(str) + len;
+    offset+= len;
+
+    if (offset % OS_FILE_LOG_BLOCK_SIZE == trailer_offset)
+      offset+= log_sys.framing_size();
+  }
+  while (size);
+}
+
 /** Close the log at mini-transaction commit.
 @return whether buffer pool flushing is needed */
 static bool log_close(lsn_t lsn)
@@ -809,14 +879,19 @@ static bool log_close(lsn_t lsn)
   return true;
 }
 
-/** Write the block contents to the REDO log */
-struct mtr_write_log
+/** Copy the block contents to the reserved space in the REDO log buffer */
+struct mtr_copy_log
 {
-  /** Append a block to the redo log buffer.
-  @return whether the appending should continue */
-  bool operator()(const mtr_buf_t::block_t *block) const
+  byte *const buf;
+  size_t offset;
+
+  mtr_copy_log(byte *buf, size_t offset) : buf(buf), offset(offset) {}
+
+  /** Copy a block to the redo log buffer.
+  @return whether the copying should continue */
+  bool operator()(const mtr_buf_t::block_t *block)
   {
-    log_write_low(block->begin(), block->used());
+    log_copy_low(buf, offset, block->begin(), block->used());
     return true;
   }
 };
@@ -888,15 +963,21 @@ inline std::pair<lsn_t,bool> mtr_t::finish_write(ulint len)
 							  &start_lsn);
 
 		if (m_commit_lsn) {
+			m_copy_buf = NULL;
 			return std::make_pair(start_lsn, false);
 		}
 	}
 
-	/* Open the database log for log_write_low */
+	/* Open the database log for log_reserve_low */
 	start_lsn = log_reserve_and_open(len);
 
-	mtr_write_log write_log;
-	m_log.for_each_block(write_log);
+	/* Only reserve the space here. The log is copied by copy_log(),
+	possibly after log_sys.mutex has been released, so that
+	mini-transactions can copy their log concurrently. */
+	m_copy_buf = log_sys.buf;
+	m_copy_offset = log_sys.buf_free;
+	log_reserve_low(len);
+	log_sys.n_pending_copies.fetch_add(1, std::memory_order_relaxed);
 	m_commit_lsn = log_sys.get_lsn();
 	bool flush = log_close(m_commit_lsn);
 	DBUG_EXECUTE_IF("ib_log_flush_ahead", flush=true;);
@@ -904,6 +985,19 @@ inline std::pair<lsn_t,bool> mtr_t::finish_write(ulint len)
 	return std::make_pair(start_lsn, flush);
 }
 
+/** Copy the redo log records to the space that finish_write() reserved
+in the redo log buffer. */
+inline void mtr_t::copy_log()
+{
+  if (!m_copy_buf)
+    return;
+
+  mtr_copy_log copy(m_copy_buf, m_copy_offset);
+  m_log.for_each_block(copy);
+  m_copy_buf= nullptr;
+  log_sys.n_pending_copies.fetch_sub(1, std::memory_order_release);
+}
+
 /** Find out whether a block was not X-latched by the mini-transaction */
 struct FindBlockX
 {
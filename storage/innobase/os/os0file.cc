@@ -46,6 +46,7 @@ Created 10/21/1995 Heikki Tuuri
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "fil0fil.h"
+#include "fil0pagecompress.h"
 #include "fsp0fsp.h"
 #ifdef HAVE_LINUX_UNISTD_H
 #include "unistd.h"
@@ -1463,6 +1464,11 @@ os_file_create_func(
 	}
 #endif /* USE_FILE_LOCK */
 
+	if (*success && purpose == OS_FILE_AIO && srv_thread_pool) {
+		/* Register the file with the io_uring (if any) */
+		srv_thread_pool->bind(file);
+	}
+
 	return(file);
 }
 
@@ -1653,6 +1659,10 @@ os_file_get_last_error.
 @return true if success */
 bool os_file_close_func(os_file_t file)
 {
+  /* The file must be unbound before the descriptor can be reused. */
+  if (srv_thread_pool)
+    srv_thread_pool->unbind(file);
+
   int ret= close(file);
 
   if (!ret)
@@ -4016,22 +4026,40 @@ int os_aio_init()
                            OS_AIO_N_PENDING_IOS_PER_THREAD);
   int max_events= max_read_events + max_write_events;
   int ret;
+#ifdef __linux__
+  if (srv_use_native_aio && srv_linux_aio != tpool::OS_IO_LIBAIO)
+  {
+    ret= srv_thread_pool->configure_aio(true, max_events, tpool::OS_IO_URING);
+    if (!ret)
+    {
+      ib::info() << "Using liburing";
+      goto created;
+    }
+    if (srv_linux_aio == tpool::OS_IO_URING)
+      ib::warn() << "io_uring is not available (error " << errno
+                 << "); falling back to libaio";
+  }
+#endif
 #if LINUX_NATIVE_AIO
   if (srv_use_native_aio && !is_linux_native_aio_supported())
     goto disable;
 #endif
 
-  ret= srv_thread_pool->configure_aio(srv_use_native_aio, max_events);
+  ret= srv_thread_pool->configure_aio(srv_use_native_aio, max_events,
+                                      tpool::OS_IO_LIBAIO);
 
-#ifdef LINUX_NATIVE_AIO
+#ifdef __linux__
   if (ret)
   {
     ut_ad(srv_use_native_aio);
+# if LINUX_NATIVE_AIO
 disable:
+# endif
     ib::warn() << "Linux Native AIO disabled.";
     srv_use_native_aio= false;
     ret= srv_thread_pool->configure_aio(false, max_events);
   }
+created:
 #endif
 
   if (!ret)
@@ -4465,8 +4493,11 @@ void fil_node_t::find_metadata(os_file_t file
 		space->atomic_write_supported = atomic_write
 			&& srv_use_atomic_writes
 #ifndef _WIN32
-			&& my_test_if_atomic_write(file,
-						   space->physical_size())
+			&& (my_test_if_atomic_write(file,
+						    space->physical_size())
+			    || (srv_detect_atomic_writes
+				&& my_test_if_fs_atomic_write(
+					file, space->physical_size())))
 #else
 			/* On Windows, all single sector writes are atomic,
 			as per WriteFile() documentation on MSDN.
@@ -4557,6 +4588,10 @@ bool fil_node_t::read_page0()
 		space->crypt_data = fil_space_read_crypt_data(
 			fil_space_t::zip_size(flags), page);
 	}
+
+	if (!space->zstd_dict) {
+		space->zstd_dict = fil_zstd_dict_read(flags, page);
+	}
 	aligned_free(page);
 
 	if (UNIV_UNLIKELY(space_id != space->id)) {
@@ -1615,6 +1615,7 @@ page_cur_insert_rec_low(
 
   rec_offs_make_valid(insert_buf + extra_size, index,
                       page_is_leaf(block->frame), offsets);
+  block->vis_hint_note(heap_no);
   return insert_buf + extra_size;
 }
 
@@ -2037,6 +2038,7 @@ page_cur_insert_rec_zip(
                             page_dir_find_owner_slot(next_rec), mtr);
 
   page_zip_write_rec(cursor->block, insert_rec, index, offsets, 1, mtr);
+  cursor->block->vis_hint_note(heap_no);
   return insert_rec;
 }
 
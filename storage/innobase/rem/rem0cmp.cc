@@ -212,6 +212,13 @@ cmp_decimal(const byte*	a, ulint a_length, const byte* b, ulint b_length)
 	return(swap_flag);
 }
 
+/** Compare two unsigned integers.
+@return -1, 0 or 1 if a is less than, equal to or greater than b */
+static inline int cmp_uint(uint64_t a, uint64_t b)
+{
+	return (a > b) - (a < b);
+}
+
 /** Compare two data fields.
 @param[in] mtype main type
 @param[in] prtype precise type
@@ -318,6 +325,23 @@ cmp_data(
 		return 0;
 	}
 
+	if (len1 == len2) {
+		/* Integers, DB_TRX_ID and most fixed-length keys are
+		compared as big-endian unsigned numbers, which is
+		cheaper than a memcmp() call for these lengths. */
+		switch (len1) {
+		case 8:
+			return cmp_uint(mach_read_from_8(data1),
+					mach_read_from_8(data2));
+		case 6:
+			return cmp_uint(mach_read_from_6(data1),
+					mach_read_from_6(data2));
+		case 4:
+			return cmp_uint(mach_read_from_4(data1),
+					mach_read_from_4(data2));
+		}
+	}
+
 	ulint len = std::min(len1, len2);
 	int cmp = len ? memcmp(data1, data2, len) : 0;
 
@@ -3334,6 +3334,7 @@ struct fil_iterator_t {
 						for IO */
 	byte*		io_buffer;		/*!< Buffer to use for IO */
 	fil_space_crypt_t *crypt_data;		/*!< Crypt data (if encrypted) */
+	fil_zstd_dict_t	*zstd_dict;		/*!< zstd dictionary, or NULL */
 	byte*           crypt_io_buffer;        /*!< IO buffer when encrypted */
 };
 
@@ -3527,7 +3528,8 @@ fil_iterate(
 			if (page_compressed) {
 				ulint compress_length = fil_page_decompress(
 					page_compress_buf, dst,
-					callback.get_space_flags());
+					callback.get_space_flags(),
+					iter.zstd_dict);
 				ut_ad(compress_length != srv_page_size);
 				if (compress_length == 0) {
 					goto page_corrupted;
@@ -3603,7 +3605,7 @@ fil_iterate(
 					    page_compress_buf,
 					    callback.get_space_flags(),
 					    512,/* FIXME: proper block size */
-					    encrypted)) {
+					    encrypted, iter.zstd_dict)) {
 					/* FIXME: remove memcpy() */
 					memcpy(src, page_compress_buf, len);
 					memset(src + len, 0,
@@ -3768,6 +3770,8 @@ fil_tablespace_iterate(
 		/* read (optional) crypt data */
 		iter.crypt_data = fil_space_read_crypt_data(
 			callback.get_zip_size(), page);
+		iter.zstd_dict = fil_zstd_dict_read(
+			callback.get_space_flags(), page);
 
 		/* If tablespace is encrypted, it needs extra buffers */
 		if (iter.crypt_data && n_io_buffers > 1) {
@@ -3807,6 +3811,8 @@ fil_tablespace_iterate(
 			fil_space_destroy_crypt_data(&iter.crypt_data);
 		}
 
+		fil_zstd_dict_free(iter.zstd_dict);
+
 		aligned_free(iter.crypt_io_buffer);
 		aligned_free(iter.io_buffer);
 	}
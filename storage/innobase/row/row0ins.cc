@@ -2518,6 +2518,50 @@ row_ins_index_entry_big_rec(
 	return(error);
 }
 
+/** Start an insert into an empty table without row-level undo logging,
+if possible. The transaction will acquire an exclusive lock on the table
+and write a TRX_UNDO_EMPTY record, whose rollback will empty the table.
+Until the end of the current statement, inserts into the table will not
+be undo logged.
+@param[in,out]	index	clustered index whose root page is an empty leaf
+@param[in,out]	trx	transaction
+@return	error code */
+static
+dberr_t
+row_ins_bulk_insert_start(dict_index_t* index, trx_t* trx)
+{
+	dict_table_t*	table = index->table;
+
+	ut_ad(index->is_primary());
+	ut_ad(!table->is_temporary());
+
+	/* A statement that can continue after a failed row would not be
+	able to roll back the rows that were already inserted. */
+	if (!trx->mysql_thd || trx->duplicates
+	    || trx->dict_operation != TRX_DICT_OP_NONE || trx->is_wsrep()
+	    || table->versioned() || table->fts || table->skip_alter_undo
+	    || table->n_rec_locks || trx->mod_tables.count(table)) {
+		return DB_SUCCESS;
+	}
+
+	/* The rollback of TRX_UNDO_EMPTY would not be logged for online
+	ALTER TABLE. */
+	for (const dict_index_t* i = index; i;
+	     i = dict_table_get_next_index(i)) {
+		if (i->online_status != ONLINE_INDEX_COMPLETE) {
+			return DB_SUCCESS;
+		}
+	}
+
+	/* Fall back to row-level undo logging if anyone else is
+	accessing the table. */
+	if (!lock_table_x_try(table, trx) || table->n_rec_locks) {
+		return DB_SUCCESS;
+	}
+
+	return trx_undo_report_empty(trx, table);
+}
+
 /***************************************************************//**
 Tries to insert an entry into a clustered index, ignoring foreign key
 constraints. If a record with the same unique key is found, the other
@@ -2654,6 +2698,15 @@ row_ins_clust_index_entry_low(
 		goto do_insert;
 	}
 
+	if (!flags && page_is_empty(btr_cur_get_page(cursor))
+	    && btr_cur_get_block(cursor)->page.id().page_no()
+	    == index->page) {
+		err = row_ins_bulk_insert_start(index, thr_get_trx(thr));
+		if (err != DB_SUCCESS) {
+			goto err_exit;
+		}
+	}
+
 	if (n_uniq
 	    && (cursor->up_match >= n_uniq || cursor->low_match >= n_uniq)) {
 
@@ -40,7 +40,9 @@ Created 2011-05-26 Marko Makela
 
 #include <sql_class.h>
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <vector>
 
 Atomic_counter<ulint> onlineddl_rowlog_rows;
 ulint onlineddl_rowlog_pct_used;
@@ -236,7 +238,8 @@ struct row_log_t {
 				defaults */
 	const TABLE*	old_table; /*< Use old table in case of error. */
 
-	uint64_t	n_rows; /*< Number of rows read from the table */
+	/** Number of rows read from the table */
+	Atomic_relaxed<uint64_t>	n_rows;
 	/** Determine whether the log should be in the 'instant ADD' format
 	@param[in]	index	the clustered index of the source table
 	@return	whether to use the 'instant ADD COLUMN' format */
@@ -1513,6 +1516,8 @@ row_log_table_apply_convert_mrec(
 	dict_index_t*		index,		/*!< in: index of mrec */
 	const rec_offs*		offsets,	/*!< in: offsets of mrec */
 	row_log_t*		log,		/*!< in: rebuild context */
+	ulonglong		total,		/*!< in: log position at
+						the end of mrec */
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	dberr_t*		error)		/*!< out: DB_SUCCESS or
 						DB_MISSING_HISTORY or
@@ -1520,7 +1525,7 @@ row_log_table_apply_convert_mrec(
 {
 	dtuple_t*	row;
 
-	log->n_rows++;
+	log->n_rows.fetch_add(1);
 	*error = DB_SUCCESS;
 
 	/* This is based on row_build(). */
@@ -1589,7 +1594,7 @@ row_log_table_apply_convert_mrec(
 				page_no_map::const_iterator p = blobs->find(
 					page_no);
 				if (p != blobs->end()
-				    && p->second.is_freed(log->head.total)) {
+				    && p->second.is_freed(total)) {
 					/* This BLOB has been freed.
 					We must not access the row. */
 					*error = DB_MISSING_HISTORY;
@@ -1766,6 +1771,8 @@ row_log_table_apply_insert(
 	que_thr_t*		thr,		/*!< in: query graph */
 	const mrec_t*		mrec,		/*!< in: record to insert */
 	const rec_offs*		offsets,	/*!< in: offsets of mrec */
+	ulonglong		total,		/*!< in: log position at
+						the end of mrec */
 	mem_heap_t*		offsets_heap,	/*!< in/out: memory heap
 						that can be emptied */
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
@@ -1775,7 +1782,7 @@ row_log_table_apply_insert(
 	row_log_t*log	= dup->index->online_log;
 	dberr_t		error;
 	const dtuple_t*	row	= row_log_table_apply_convert_mrec(
-		mrec, dup->index, offsets, log, heap, &error);
+		mrec, dup->index, offsets, log, total, heap, &error);
 
 	switch (error) {
 	case DB_MISSING_HISTORY:
@@ -2033,6 +2040,8 @@ row_log_table_apply_update(
 						clustered index */
 	const mrec_t*		mrec,		/*!< in: new value */
 	const rec_offs*		offsets,	/*!< in: offsets of mrec */
+	ulonglong		total,		/*!< in: log position at
+						the end of mrec */
 	mem_heap_t*		offsets_heap,	/*!< in/out: memory heap
 						that can be emptied */
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
@@ -2057,7 +2066,7 @@ row_log_table_apply_update(
 	      == dict_index_get_n_unique(index));
 
 	row = row_log_table_apply_convert_mrec(
-		mrec, dup->index, offsets, log, heap, &error);
+		mrec, dup->index, offsets, log, total, heap, &error);
 
 	switch (error) {
 	case DB_MISSING_HISTORY:
@@ -2407,8 +2416,11 @@ row_log_table_apply_op(
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	const mrec_t*		mrec,		/*!< in: merge record */
 	const mrec_t*		mrec_end,	/*!< in: end of buffer */
-	rec_offs*		offsets)	/*!< in/out: work area
+	rec_offs*		offsets,	/*!< in/out: work area
 						for parsing mrec */
+	ulonglong*		total)		/*!< in/out: log position
+						at the start of mrec;
+						advanced past mrec */
 {
 	row_log_t*	log	= dup->index->online_log;
 	dict_index_t*	new_index = dict_table_get_first_index(log->table);
@@ -2418,7 +2430,7 @@ row_log_table_apply_op(
 
 	ut_ad(dict_index_is_clust(dup->index));
 	ut_ad(dup->index->table != log->table);
-	ut_ad(log->head.total <= log->tail.total);
+	ut_ad(*total <= log->tail.total);
 
 	*error = DB_SUCCESS;
 
@@ -2466,9 +2478,9 @@ row_log_table_apply_op(
 		if (next_mrec > mrec_end) {
 			return(NULL);
 		} else {
-			log->head.total += ulint(next_mrec - mrec_start);
+			*total += ulint(next_mrec - mrec_start);
 			*error = row_log_table_apply_insert(
-				thr, mrec, offsets, offsets_heap,
+				thr, mrec, offsets, *total, offsets_heap,
 				heap, dup);
 		}
 		break;
@@ -2496,7 +2508,7 @@ row_log_table_apply_op(
 			return(NULL);
 		}
 
-		log->head.total += ulint(next_mrec - mrec_start);
+		*total += ulint(next_mrec - mrec_start);
 
 		*error = row_log_table_apply_delete(
 			new_trx_id_col,
@@ -2650,16 +2662,16 @@ row_log_table_apply_op(
 		}
 
 		ut_ad(next_mrec <= mrec_end);
-		log->head.total += ulint(next_mrec - mrec_start);
+		*total += ulint(next_mrec - mrec_start);
 		dtuple_set_n_fields_cmp(old_pk, new_index->n_uniq);
 
 		*error = row_log_table_apply_update(
 			thr, new_trx_id_col,
-			mrec, offsets, offsets_heap, heap, dup, old_pk);
+			mrec, offsets, *total, offsets_heap, heap, dup, old_pk);
 		break;
 	}
 
-	ut_ad(log->head.total <= log->tail.total);
+	ut_ad(*total <= log->tail.total);
 	mem_heap_empty(offsets_heap);
 	mem_heap_empty(heap);
 	return(next_mrec);
@@ -2725,6 +2737,332 @@ row_log_progress_inc_per_block()
 ALTER TABLE. If not NULL, then stage->inc() will be called for each block
 of log that is applied.
 @return DB_SUCCESS, or error code on failure */
+/** Determine whether the row_log_table log can be applied by
+row_log_table_apply_parallel().
+
+The log records are partitioned by the PRIMARY KEY, and the records of
+each partition are applied in log order. This is only correct if the
+records of different PRIMARY KEY values are independent of each other:
+ * the PRIMARY KEY must not have changed, so that each log record is
+keyed by the same PRIMARY KEY value in the old and new table,
+ * equal PRIMARY KEY values must have equal bytes, so that they are
+assigned to the same partition,
+ * the new table must not contain any UNIQUE secondary index,
+because a duplicate key check depends on the order of the records,
+ * no value must be computed by the SQL layer (virtual columns,
+FULLTEXT indexes, or columns that get a default value), because the
+TABLE and THD of the ALTER TABLE statement must not be used by
+multiple threads.
+@param[in]	index	clustered index of the old table
+@return whether the log can be applied in parallel */
+static bool row_log_table_apply_can_parallel(const dict_index_t* index)
+{
+	const row_log_t*	log = index->online_log;
+	const dict_table_t*	new_table = log->table;
+	const dict_index_t*	new_index = dict_table_get_first_index(
+		new_table);
+
+	if (!log->same_pk || log->defaults
+	    || new_table->n_v_cols || new_table->fts) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < new_index->n_uniq; i++) {
+		const dict_col_t*	col = dict_index_get_nth_col(
+			new_index, i);
+
+		switch (col->mtype) {
+		case DATA_INT:
+			continue;
+		case DATA_FIXBINARY:
+		case DATA_BINARY:
+			if (dtype_get_charset_coll(col->prtype)
+			    == DATA_MYSQL_BINARY_CHARSET_COLL) {
+				continue;
+			}
+		}
+
+		return(false);
+	}
+
+	for (const dict_index_t* i = dict_table_get_next_index(new_index);
+	     i; i = dict_table_get_next_index(i)) {
+		if (dict_index_is_unique(i)) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Determine the end of a row_log_table log record and the fold value
+of its PRIMARY KEY, when row_log_table_apply_can_parallel() holds.
+@param[in]	index		clustered index of the old table
+@param[in]	mrec		log record
+@param[in]	mrec_end	end of the buffer
+@param[in,out]	offsets		work area for parsing mrec
+@param[out]	fold		fold value of the PRIMARY KEY
+@return pointer to the next record
+@retval NULL if the record does not end before mrec_end, or is corrupted */
+static const mrec_t*
+row_log_table_parse_op(
+	const dict_index_t*	index,
+	const mrec_t*		mrec,
+	const mrec_t*		mrec_end,
+	rec_offs*		offsets,
+	ulint*			fold)
+{
+	const row_log_t*	log = index->online_log;
+	const dict_index_t*	new_index = dict_table_get_first_index(
+		log->table);
+	ulint			extra_size;
+
+	ut_ad(log->same_pk);
+
+	/* 3 = 1 (op type) + 1 (extra_size) + at least 1 byte payload */
+	if (mrec + 3 >= mrec_end) {
+		return(NULL);
+	}
+
+	switch (*mrec++) {
+	case ROW_T_INSERT:
+	case ROW_T_UPDATE:
+		extra_size = *mrec++;
+
+		if (extra_size >= 0x80) {
+			/* Read another byte of extra_size. */
+
+			extra_size = (extra_size & 0x7f) << 8;
+			extra_size |= *mrec++;
+		}
+
+		mrec += extra_size;
+
+		if (mrec > mrec_end) {
+			return(NULL);
+		}
+
+		rec_offs_set_n_fields(offsets, index->n_fields);
+		rec_init_offsets_temp(mrec, index, offsets,
+				      log->n_core_fields, log->non_core_fields,
+				      log->is_instant(index)
+				      ? static_cast<rec_comp_status_t>(
+					      *(mrec - extra_size))
+				      : REC_STATUS_ORDINARY);
+		break;
+	case ROW_T_DELETE:
+		/* 1 (extra_size) + at least 1 (payload) */
+		if (mrec + 2 >= mrec_end) {
+			return(NULL);
+		}
+
+		mrec += 1 + *mrec;
+
+		rec_offs_set_n_fields(offsets, new_index->first_user_field());
+		rec_init_offsets_temp(mrec, new_index, offsets);
+		break;
+	default:
+		/* Let row_log_table_apply_op() report the corruption. */
+		return(NULL);
+	}
+
+	const mrec_t*	next_mrec = mrec + rec_offs_data_size(offsets);
+
+	if (next_mrec > mrec_end) {
+		return(NULL);
+	}
+
+	/* The PRIMARY KEY is the first n_uniq fields of all records. */
+	ulint	f = 0;
+
+	for (ulint i = 0; i < new_index->n_uniq; i++) {
+		ulint		len;
+		const byte*	field = rec_get_nth_field(
+			mrec, offsets, i, &len);
+
+		f = ut_fold_ulint_pair(f, ut_fold_binary(field, len));
+	}
+
+	*fold = f;
+	return(next_mrec);
+}
+
+/** Log records of one PRIMARY KEY partition, in log order, together with
+the log position at the start of each record */
+typedef std::vector<std::pair<const mrec_t*, ulonglong> > row_log_part_t;
+
+/** State shared by the tasks of row_log_table_apply_parallel() */
+struct row_log_apply_ctx_t {
+	/** query graph */
+	que_thr_t*			thr;
+	/** position of DB_TRX_ID in the new clustered index */
+	ulint				new_trx_id_col;
+	/** for reporting duplicate key errors */
+	const row_merge_dup_t*		dup;
+	/** end of the log block */
+	const mrec_t*			mrec_end;
+	/** allocated size of the offsets work area */
+	ulint				n_offsets;
+	/** log records of each partition */
+	std::vector<row_log_part_t>	parts;
+	/** next partition to apply */
+	std::atomic<ulint>		next;
+	/** first error encountered by any task */
+	std::atomic<dberr_t>		error;
+};
+
+/** Apply partitions until all of them have been claimed or an error occurs.
+@param[in,out]	arg	row_log_apply_ctx_t */
+static void row_log_table_apply_worker(void* arg)
+{
+	row_log_apply_ctx_t*	ctx = static_cast<row_log_apply_ctx_t*>(arg);
+	row_merge_dup_t		dup = *ctx->dup;
+	trx_t*			trx = thr_get_trx(ctx->thr);
+	mem_heap_t*		heap = mem_heap_create(srv_page_size);
+	mem_heap_t*		offsets_heap = mem_heap_create(srv_page_size);
+	rec_offs*		offsets = static_cast<rec_offs*>(
+		ut_malloc_nokey(ctx->n_offsets * sizeof *offsets));
+
+	rec_offs_set_n_alloc(offsets, ctx->n_offsets);
+
+	while (ctx->error.load(std::memory_order_relaxed) == DB_SUCCESS) {
+		const ulint	part = ctx->next.fetch_add(
+			1, std::memory_order_relaxed);
+
+		if (part >= ctx->parts.size()) {
+			break;
+		}
+
+		for (const auto& op : ctx->parts[part]) {
+			dberr_t		err;
+			ulonglong	total = op.second;
+
+			if (ctx->error.load(std::memory_order_relaxed)
+			    != DB_SUCCESS) {
+				break;
+			}
+
+			if (trx_is_interrupted(trx)) {
+				err = DB_INTERRUPTED;
+			} else {
+				log_free_check();
+
+				if (!row_log_table_apply_op(
+					    ctx->thr, ctx->new_trx_id_col,
+					    &dup, &err, offsets_heap, heap,
+					    op.first, ctx->mrec_end, offsets,
+					    &total)
+				    && err == DB_SUCCESS) {
+					/* row_log_table_parse_op() found
+					the record to be complete. */
+					ut_ad(0);
+					err = DB_CORRUPTION;
+				}
+			}
+
+			if (err != DB_SUCCESS) {
+				dberr_t	expected = DB_SUCCESS;
+				ctx->error.compare_exchange_strong(
+					expected, err);
+				break;
+			}
+		}
+	}
+
+	ut_free(offsets);
+	mem_heap_free(offsets_heap);
+	mem_heap_free(heap);
+}
+
+/** Apply the complete log records at the start of a block of the
+row_log_table log by innodb_ddl_threads tasks of srv_thread_pool,
+including the calling thread. The records are partitioned by a hash
+of the PRIMARY KEY; see row_log_table_apply_can_parallel().
+@param[in]	thr		query graph
+@param[in]	new_trx_id_col	position of DB_TRX_ID in the new index
+@param[in,out]	dup		for reporting duplicate key errors
+@param[in]	mrec		first log record
+@param[in]	mrec_end	end of the block
+@param[in,out]	offsets		work area for parsing mrec
+@param[in]	n_offsets	allocated size of offsets
+@param[out]	error		DB_SUCCESS or error code
+@return pointer to the first record that was not applied */
+static const mrec_t*
+row_log_table_apply_parallel(
+	que_thr_t*		thr,
+	ulint			new_trx_id_col,
+	row_merge_dup_t*	dup,
+	const mrec_t*		mrec,
+	const mrec_t*		mrec_end,
+	rec_offs*		offsets,
+	ulint			n_offsets,
+	dberr_t*		error)
+{
+	row_log_t*		log = dup->index->online_log;
+	const ulint		n_threads = srv_ddl_threads;
+	const mrec_t*		next_mrec = mrec;
+	ulonglong		total = log->head.total;
+	ulint			n_ops = 0;
+	row_log_apply_ctx_t	ctx;
+
+	*error = DB_SUCCESS;
+	ctx.parts.resize(n_threads);
+
+	for (;;) {
+		ulint		fold;
+		const mrec_t*	end = row_log_table_parse_op(
+			dup->index, next_mrec, mrec_end, offsets, &fold);
+
+		if (!end) {
+			break;
+		}
+
+		ctx.parts[fold % n_threads].push_back(
+			std::make_pair(next_mrec, total));
+		total += ulint(end - next_mrec);
+		next_mrec = end;
+		n_ops++;
+	}
+
+	if (n_ops < 2) {
+		/* Let the caller apply the record, if any. */
+		return(mrec);
+	}
+
+	ctx.thr = thr;
+	ctx.new_trx_id_col = new_trx_id_col;
+	ctx.dup = dup;
+	ctx.mrec_end = mrec_end;
+	ctx.n_offsets = n_offsets;
+	ctx.next = 0;
+	ctx.error = DB_SUCCESS;
+
+	std::vector<tpool::waitable_task*>	tasks;
+
+	for (ulint i = 1; i < std::min(n_threads, n_ops); i++) {
+		tpool::waitable_task*	task = new tpool::waitable_task(
+			row_log_table_apply_worker, &ctx);
+		srv_thread_pool->submit_task(task);
+		tasks.push_back(task);
+	}
+
+	row_log_table_apply_worker(&ctx);
+
+	for (tpool::waitable_task* task : tasks) {
+		task->wait();
+		delete task;
+	}
+
+	*error = ctx.error;
+
+	if (*error != DB_SUCCESS) {
+		return(NULL);
+	}
+
+	log->head.total = total;
+	return(next_mrec);
+}
+
 static MY_ATTRIBUTE((warn_unused_result))
 dberr_t
 row_log_table_apply_ops(
@@ -2752,6 +3090,8 @@ row_log_table_apply_ops(
 	const ulint	new_trx_id_col	= dict_col_get_clust_pos(
 		dict_table_get_sys_col(new_table, DATA_TRX_ID), new_index);
 	trx_t*		trx		= thr_get_trx(thr);
+	const bool	parallel	= srv_ddl_threads > 1
+		&& row_log_table_apply_can_parallel(index);
 
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(dict_index_is_online_ddl(index));
@@ -2920,7 +3260,8 @@ row_log_table_apply_ops(
 			thr, new_trx_id_col,
 			dup, &error, offsets_heap, heap,
 			index->online_log->head.buf,
-			(&index->online_log->head.buf)[1], offsets);
+			(&index->online_log->head.buf)[1], offsets,
+			&index->online_log->head.total);
 		if (error != DB_SUCCESS) {
 			goto func_exit;
 		} else if (UNIV_UNLIKELY(mrec == NULL)) {
@@ -2975,6 +3316,24 @@ row_log_table_apply_ops(
 
 	mrec_end = next_mrec_end;
 
+	if (parallel) {
+		mrec = row_log_table_apply_parallel(
+			thr, new_trx_id_col, dup, next_mrec, mrec_end,
+			offsets, i, &error);
+
+		if (error != DB_SUCCESS) {
+			goto func_exit;
+		}
+
+		index->online_log->head.bytes += ulint(mrec - next_mrec);
+		next_mrec = mrec;
+
+		if (next_mrec == next_mrec_end && !has_index_lock) {
+			mrec = NULL;
+			goto process_next_block;
+		}
+	}
+
 	while (!trx_is_interrupted(trx)) {
 		mrec = next_mrec;
 		ut_ad(mrec <= mrec_end);
@@ -3025,7 +3384,8 @@ row_log_table_apply_ops(
 		next_mrec = row_log_table_apply_op(
 			thr, new_trx_id_col,
 			dup, &error, offsets_heap, heap,
-			mrec, mrec_end, offsets);
+			mrec, mrec_end, offsets,
+			&index->online_log->head.total);
 
 		if (error != DB_SUCCESS) {
 			goto func_exit;
@@ -3127,7 +3487,7 @@ row_log_table_apply(
 	} else {
 		row_merge_dup_t	dup = {
 			clust_index, table,
-			clust_index->online_log->col_map, 0
+			clust_index->online_log->col_map, 0, NULL
 		};
 
 		error = row_log_table_apply_ops(thr, &dup, stage);
@@ -3984,7 +4344,7 @@ row_log_apply(
 {
 	dberr_t		error;
 	row_log_t*	log;
-	row_merge_dup_t	dup = { index, table, NULL, 0 };
+	row_merge_dup_t	dup = { index, table, NULL, 0, NULL };
 	DBUG_ENTER("row_log_apply");
 
 	ut_ad(dict_index_is_online_ddl(index));
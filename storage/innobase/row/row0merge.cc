@@ -51,6 +51,7 @@ Completed by Sunny Bains and Marko Makela
 #endif /* BTR_CUR_ADAPT */
 #include "ut0stage.h"
 #include "fil0crypt.h"
+#include "fil0pagecompress.h"
 #include "srv0mon.h"
 
 /* Ignore posix_fadvise() on those platforms where it does not exist */
@@ -131,6 +132,8 @@ class index_tuple_info_t {
 		DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
 				log_sys.set_check_flush_or_checkpoint(););
 
+		str_sort();
+
 		for (idx_tuple_vec::iterator it = m_dtuple_vec->begin();
 		     it != m_dtuple_vec->end();
 		     ++it) {
@@ -240,6 +243,55 @@ class index_tuple_info_t {
 	typedef std::vector<dtuple_t*, ut_allocator<dtuple_t*> >
 		idx_tuple_vec;
 
+	/** The center of the MBR of a cached row */
+	struct str_entry_t {
+		double		x;
+		double		y;
+		dtuple_t*	dtuple;
+	};
+
+	/** Order the cached rows by Sort-Tile-Recursive packing of the
+	centers of their MBR: sort by x, cut into sqrt(n) vertical slices
+	and sort each slice by y. Rows that are inserted one after another
+	are then close to each other, so that they mostly go to the same
+	leaf page, and the MBRs of the pages that are split stay small. */
+	void str_sort() const
+	{
+		const ulint	n = m_dtuple_vec->size();
+
+		if (n < 4) {
+			return;
+		}
+
+		std::vector<str_entry_t, ut_allocator<str_entry_t> >
+			entries(n);
+
+		for (ulint i = 0; i < n; i++) {
+			rtr_mbr_t	mbr;
+			rtr_get_mbr_from_tuple((*m_dtuple_vec)[i], &mbr);
+			entries[i].x = (mbr.xmin + mbr.xmax) / 2;
+			entries[i].y = (mbr.ymin + mbr.ymax) / 2;
+			entries[i].dtuple = (*m_dtuple_vec)[i];
+		}
+
+		std::sort(entries.begin(), entries.end(),
+			  [](const str_entry_t& a, const str_entry_t& b)
+			  { return a.x < b.x; });
+
+		const ulint	slice = ulint(ceil(sqrt(double(n))));
+
+		for (ulint i = 0; i < n; i += slice) {
+			std::sort(entries.begin() + i,
+				  entries.begin() + std::min(i + slice, n),
+				  [](const str_entry_t& a, const str_entry_t& b)
+				  { return a.y < b.y; });
+		}
+
+		for (ulint i = 0; i < n; i++) {
+			(*m_dtuple_vec)[i] = entries[i].dtuple;
+		}
+	}
+
 	/** vector used to cache index rows made from cluster index scan */
 	idx_tuple_vec* const	m_dtuple_vec;
 
@@ -855,6 +907,18 @@ row_merge_dup_report(
 	if (!dup->n_dup++) {
 		/* Only report the first duplicate record,
 		but count all duplicate records. */
+		if (dup->first_dup) {
+			/* Of the indexes that are sorted in parallel,
+			only the first one to find a duplicate may
+			write table->record[0]. */
+			const dict_index_t*	none = NULL;
+
+			if (!dup->first_dup->compare_exchange_strong(
+				    none, dup->index)) {
+				return;
+			}
+		}
+
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
 	}
 }
@@ -1738,7 +1802,7 @@ row_merge_read_clustered_index(
 	merge_buf = static_cast<row_merge_buf_t**>(
 		ut_malloc_nokey(n_index * sizeof *merge_buf));
 
-	row_merge_dup_t	clust_dup = {index[0], table, col_map, 0};
+	row_merge_dup_t	clust_dup = {index[0], table, col_map, 0, NULL};
 	dfield_t*	prev_fields;
 	const ulint	n_uniq = dict_index_get_n_unique(index[0]);
 
@@ -2532,7 +2596,8 @@ row_merge_read_clustered_index(
 					}
 				} else if (dict_index_is_unique(buf->index)) {
 					row_merge_dup_t	dup = {
-						buf->index, table, col_map, 0};
+						buf->index, table, col_map, 0,
+						NULL};
 
 					row_merge_buf_sort(buf, &dup);
 
@@ -4310,6 +4375,263 @@ row_merge_drop_table(
 			trx, SQLCOM_DROP_TABLE, false, false));
 }
 
+/** Merge sort and bulk load of one index in
+row_merge_build_indexes_parallel() */
+struct row_merge_index_task_t {
+	trx_t*			trx;		/*!< transaction */
+	const dict_table_t*	old_table;	/*!< table where rows are
+						read from */
+	const dict_table_t*	new_table;	/*!< table where the index
+						is created */
+	merge_file_t*		file;		/*!< index entries */
+	row_merge_dup_t		dup;		/*!< index being built,
+						for reporting duplicates */
+	double			pct_progress;	/*!< total progress percent
+						before the index is built */
+	dberr_t			error;		/*!< out: error code */
+};
+
+/** Merge sort the entries of one index and insert them into the index.
+@param[in,out]	arg	row_merge_index_task_t */
+static
+void
+row_merge_build_index_task(void* arg)
+{
+	row_merge_index_task_t*	t = static_cast<row_merge_index_task_t*>(
+		arg);
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	const size_t		block_size = 3 * srv_sort_buf_size;
+	row_merge_block_t*	crypt_block = NULL;
+	pfs_os_file_t		tmpfd = OS_FILE_CLOSED;
+	row_merge_block_t*	block = alloc.allocate_large(block_size,
+							     &block_pfx);
+
+	if (block == NULL) {
+		t->error = DB_OUT_OF_MEMORY;
+		return;
+	}
+
+	if (log_tmp_is_encrypted()) {
+		crypt_block = alloc.allocate_large(block_size, &crypt_pfx);
+
+		if (crypt_block == NULL) {
+			t->error = DB_OUT_OF_MEMORY;
+			goto func_exit;
+		}
+	}
+
+	/* The progress of the statement and the performance schema
+	stage are only updated by the thread that executes the
+	statement. */
+	t->error = row_merge_sort(t->trx, &t->dup, t->file, block, &tmpfd,
+				  false, t->pct_progress, 0, crypt_block,
+				  t->new_table->space_id, NULL);
+
+	if (t->error == DB_SUCCESS) {
+		BtrBulk	btr_bulk(t->dup.index, t->trx);
+
+		t->error = row_merge_insert_index_tuples(
+			t->dup.index, t->old_table, t->file->fd, block, NULL,
+			&btr_bulk, t->file->n_rec, t->pct_progress, 0,
+			crypt_block, t->new_table->space_id);
+
+		t->error = btr_bulk.finish(t->error);
+	}
+
+func_exit:
+	row_merge_file_destroy_low(tmpfd);
+
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx);
+	}
+
+	alloc.deallocate_large(block, &block_pfx);
+}
+
+/** Maximum number of leaf pages that row_merge_train_zstd_dict() uses */
+static const ulint	ROW_MERGE_ZSTD_DICT_SAMPLES = 128;
+
+/** Minimum number of leaf pages for row_merge_train_zstd_dict() to
+train a dictionary at all */
+static const ulint	ROW_MERGE_ZSTD_DICT_MIN_SAMPLES = 16;
+
+/** Train a zstd dictionary for the tablespace of a table that is being
+rebuilt, from the leftmost clustered index leaf pages of the old table,
+if innodb_compression_dictionary is set and the new table is
+page_compressed with zstd.
+@param[in]	old_table	table where rows are read from
+@param[in,out]	new_table	table that is being created */
+static
+void
+row_merge_train_zstd_dict(
+	const dict_table_t*	old_table,
+	dict_table_t*		new_table)
+{
+	fil_space_t*	space = new_table->space;
+
+	if (!innodb_compression_dictionary
+	    || !space || !space->is_compressed() || space->zstd_dict
+	    || (space->full_crc32()
+		? space->get_compression_algo()
+		: innodb_compression_algorithm) != PAGE_ZSTD_ALGORITHM) {
+		return;
+	}
+
+	const dict_index_t*	index = dict_table_get_first_index(old_table);
+	byte*			samples = static_cast<byte*>(
+		ut_malloc_nokey(ROW_MERGE_ZSTD_DICT_SAMPLES
+				<< srv_page_size_shift));
+	ulint			n = 0;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+
+	if (!samples) {
+		return;
+	}
+
+	mtr.start();
+	dberr_t	err = btr_pcur_open_at_index_side(
+		true, const_cast<dict_index_t*>(index), BTR_SEARCH_LEAF,
+		&pcur, true, 0, &mtr);
+	uint32_t	page_no = err == DB_SUCCESS
+		? btr_pcur_get_block(&pcur)->page.id().page_no()
+		: FIL_NULL;
+	mtr.commit();
+	btr_pcur_close(&pcur);
+
+	while (page_no != FIL_NULL && n < ROW_MERGE_ZSTD_DICT_SAMPLES) {
+		mtr.start();
+
+		const buf_block_t*	block = buf_page_get_gen(
+			page_id_t(old_table->space_id, page_no),
+			old_table->space->zip_size(), RW_S_LATCH,
+			NULL, BUF_GET_POSSIBLY_FREED, &mtr, &err);
+
+		/* Concurrent DML may free the page after we read its
+		page number. Then we train with the pages we have. */
+		if (!block
+		    || !fil_page_index_page_check(block->frame)
+		    || btr_page_get_index_id(block->frame) != index->id
+		    || !page_is_leaf(block->frame)) {
+			mtr.commit();
+			break;
+		}
+
+		memcpy(samples + (n++ << srv_page_size_shift),
+		       block->frame, srv_page_size);
+		page_no = btr_page_get_next(block->frame);
+		mtr.commit();
+	}
+
+	if (n >= ROW_MERGE_ZSTD_DICT_MIN_SAMPLES
+	    && fil_zstd_dict_train(space, samples, n)) {
+		ib::info() << "Trained a zstd dictionary for "
+			   << new_table->name << " from " << n << " pages";
+	}
+
+	ut_free(samples);
+}
+
+/** Merge sort and bulk load the B-tree indexes whose entries were
+written to temporary files by row_merge_read_clustered_index(),
+executing at most innodb_ddl_threads of them concurrently.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	indexes		indexes to be created
+@param[in]	key_numbers	MySQL key numbers
+@param[in]	n_indexes	size of indexes[]
+@param[in,out]	table		MySQL table, for reporting erroneous key value
+@param[in]	col_map		mapping of old column numbers to new ones, or
+NULL if old_table == new_table
+@param[in,out]	merge_files	index entries, one file per non-spatial index
+@param[in]	pct_progress	total progress percent before the indexes
+are built
+@param[out]	built		built[i] is set if indexes[i] was built
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_build_indexes_parallel(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t**		indexes,
+	const ulint*		key_numbers,
+	ulint			n_indexes,
+	struct TABLE*		table,
+	const ulint*		col_map,
+	merge_file_t*		merge_files,
+	double			pct_progress,
+	bool*			built)
+{
+	std::atomic<const dict_index_t*>	first_dup(NULL);
+	std::vector<row_merge_index_task_t>	tasks;
+	std::vector<ulint>			task_index;
+
+	for (ulint k = 0, i = 0; i < n_indexes; i++) {
+		built[i] = false;
+
+		if (dict_index_is_spatial(indexes[i])) {
+			continue;
+		}
+
+		if (!(indexes[i]->type & DICT_FTS)
+		    && merge_files[k].fd != OS_FILE_CLOSED) {
+			row_merge_index_task_t	t = {
+				trx, old_table, new_table, &merge_files[k],
+				{indexes[i], table, col_map, 0, &first_dup},
+				pct_progress, DB_SUCCESS};
+
+			tasks.push_back(t);
+			task_index.push_back(i);
+		}
+
+		k++;
+	}
+
+	if (tasks.size() < 2) {
+		/* Let the caller build the index as usual. */
+		return(DB_SUCCESS);
+	}
+
+	tpool::task_group	group(unsigned(std::min<ulint>(
+					      srv_ddl_threads, tasks.size())));
+	std::vector<tpool::waitable_task*>	pool_tasks;
+
+	for (row_merge_index_task_t& t : tasks) {
+		tpool::waitable_task*	task = new tpool::waitable_task(
+			row_merge_build_index_task, &t, &group);
+		srv_thread_pool->submit_task(task);
+		pool_tasks.push_back(task);
+	}
+
+	for (tpool::waitable_task* task : pool_tasks) {
+		task->wait();
+		delete task;
+	}
+
+	dberr_t	error = DB_SUCCESS;
+
+	for (ulint j = 0; j < tasks.size(); j++) {
+		const ulint	i = task_index[j];
+
+		built[i] = true;
+
+		/* Report the index whose duplicate is in table->record[0],
+		or else the first index that failed. */
+		if (tasks[j].error != DB_SUCCESS
+		    && (error == DB_SUCCESS
+			|| first_dup.load() == indexes[i])) {
+			error = tasks[j].error;
+			trx->error_key_num = key_numbers[i];
+		}
+	}
+
+	return(error);
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4373,6 +4695,7 @@ row_merge_build_indexes(
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
 	bool			fts_psort_initiated = false;
+	bool*			built = NULL;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4386,6 +4709,10 @@ row_merge_build_indexes(
 	ut_ad((old_table == new_table) == !col_map);
 	ut_ad(!defaults || col_map);
 
+	if (old_table != new_table) {
+		row_merge_train_zstd_dict(old_table, new_table);
+	}
+
 	stage->begin_phase_read_pk(skip_pk_sort && new_table != old_table
 				   ? n_indexes - 1
 				   : n_indexes);
@@ -4462,6 +4789,7 @@ row_merge_build_indexes(
 			dup->table = table;
 			dup->col_map = col_map;
 			dup->n_dup = 0;
+			dup->first_dup = NULL;
 
 			/* This can fail e.g. if temporal files can't be
 			created */
@@ -4532,6 +4860,20 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	if (srv_ddl_threads > 1) {
+		built = static_cast<bool*>(
+			ut_malloc_nokey(n_indexes * sizeof *built));
+
+		error = row_merge_build_indexes_parallel(
+			trx, old_table, new_table, indexes, key_numbers,
+			n_indexes, table, col_map, merge_files, pct_progress,
+			built);
+
+		if (error != DB_SUCCESS) {
+			goto func_exit;
+		}
+	}
+
 	for (ulint k = 0, i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -4560,10 +4902,13 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (built && built[i]) {
+			/* The index was sorted and loaded by
+			row_merge_build_indexes_parallel(). */
 		} else if (merge_files[k].fd != OS_FILE_CLOSED) {
 			char	buf[NAME_LEN + 1];
 			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
+				sort_idx, table, col_map, 0, NULL};
 
 			pct_cost = (COST_BUILD_INDEX_STATIC +
 				    (total_dynamic_cost
@@ -4721,6 +5066,7 @@ row_merge_build_indexes(
 	}
 
 	ut_free(merge_files);
+	ut_free(built);
 
 	alloc.deallocate_large(block, &block_pfx);
 
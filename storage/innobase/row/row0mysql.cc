@@ -912,6 +912,7 @@ row_create_prebuilt(
 
 	prebuilt->sql_stat_start = TRUE;
 	prebuilt->heap = heap;
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 	prebuilt->srch_key_val_len = srch_key_len;
 	if (prebuilt->srch_key_val_len) {
@@ -1009,11 +1010,11 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
+	if (prebuilt->fetch_cache != NULL) {
 		byte*	base = prebuilt->fetch_cache[0] - 4;
 		byte*	ptr = base;
 
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
+		for (ulint i = 0; i < prebuilt->fetch_cache_size; i++) {
 			ulint	magic1 = mach_read_from_4(ptr);
 			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
 			ptr += 4;
@@ -0,0 +1,538 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel read of a clustered index
+
+Created 2021
+*******************************************************/
+
+#include "row0pread.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "rem0cmp.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+#include <atomic>
+#include <vector>
+
+/** Number of key ranges to create per thread, so that threads that
+finish early can help with the remaining ranges */
+static const ulint	ROW_PREAD_RANGES_PER_THREAD = 4;
+
+/** Maximum number of pages of one level that are latched while
+collecting the range boundaries */
+static const ulint	ROW_PREAD_MAX_SPLIT_PAGES = 1024;
+
+/** Split keys of a clustered index; range i is [keys[i-1], keys[i]),
+where keys[-1] and keys[size()] stand for the ends of the index */
+typedef std::vector<const dtuple_t*> row_pread_keys_t;
+
+/** State shared by the tasks of row_pread_scan() */
+struct row_pread_ctx_t {
+	/** clustered index */
+	dict_index_t*		index;
+	/** transaction whose read view is used */
+	trx_t*			trx;
+	/** range boundaries */
+	const row_pread_keys_t*	keys;
+	/** callback for the visible records */
+	row_pread_fn_t		fn;
+	/** argument of fn */
+	void*			arg;
+	/** next range to scan */
+	std::atomic<ulint>	next;
+	/** first error encountered by any task */
+	std::atomic<dberr_t>	error;
+};
+
+/** Argument of a task of row_pread_scan() */
+struct row_pread_task_t {
+	/** shared state */
+	row_pread_ctx_t*	ctx;
+	/** number of the thread, passed to the callback */
+	ulint			thread_no;
+};
+
+/** Collect the node pointers of the highest level of the index that
+provides at least n_ranges ranges.
+@param[in,out]	index		clustered index
+@param[in]	n_ranges	desired number of ranges
+@param[in,out]	heap		memory heap for the keys
+@param[out]	keys		range boundaries
+@return error code */
+static
+dberr_t
+row_pread_split(
+	dict_index_t*		index,
+	ulint			n_ranges,
+	mem_heap_t*		heap,
+	row_pread_keys_t&	keys)
+{
+	mtr_t		mtr;
+	mem_heap_t*	offsets_heap = NULL;
+	rec_offs	offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs*	offsets = offsets_;
+	dberr_t		err = DB_SUCCESS;
+	const ulint	n_fields = dict_index_get_n_unique_in_tree_nonleaf(
+		index);
+	const ulint	comp = dict_table_is_comp(index->table);
+	std::vector<uint32_t>	children;
+
+	rec_offs_init(offsets_);
+
+	mtr.start();
+	mtr_s_lock_index(index, &mtr);
+
+	buf_block_t*	block = btr_block_get(*index, index->page, RW_S_LATCH,
+					      false, &mtr);
+	if (!block) {
+		err = DB_CORRUPTION;
+		goto func_exit;
+	}
+
+	children.push_back(index->page);
+
+	for (ulint level = btr_page_get_level(block->frame);
+	     level > 0; level--) {
+		std::vector<uint32_t>	pages;
+
+		pages.swap(children);
+		keys.clear();
+
+		for (uint32_t page_no : pages) {
+			if (page_no != index->page) {
+				block = btr_block_get(*index, page_no,
+						      RW_S_LATCH, false, &mtr);
+				if (!block) {
+					err = DB_CORRUPTION;
+					goto func_exit;
+				}
+			}
+
+			for (const rec_t* rec = page_rec_get_next_const(
+				     page_get_infimum_rec(block->frame));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+				offsets = rec_get_offsets(
+					rec, index, offsets, false,
+					ULINT_UNDEFINED, &offsets_heap);
+
+				/* The first node pointer of each level
+				stands for the minimum key. */
+				if (!(rec_get_info_bits(rec, comp)
+				      & REC_INFO_MIN_REC_FLAG)) {
+					keys.push_back(
+						dict_index_build_data_tuple(
+							rec, index, false,
+							n_fields, heap));
+				}
+
+				children.push_back(
+					btr_node_ptr_get_child_page_no(
+						rec, offsets));
+			}
+		}
+
+		if (keys.size() + 1 >= n_ranges
+		    || children.size() > ROW_PREAD_MAX_SPLIT_PAGES) {
+			break;
+		}
+	}
+
+func_exit:
+	mtr.commit();
+
+	if (offsets_heap) {
+		mem_heap_free(offsets_heap);
+	}
+
+	return(err);
+}
+
+/** Invoke the callback for the visible records of one range of the index.
+@param[in,out]	ctx		shared state
+@param[in]	range		range number
+@param[in]	thread_no	number of the calling thread
+@return error code */
+static
+dberr_t
+row_pread_scan_range(
+	row_pread_ctx_t*	ctx,
+	ulint			range,
+	ulint			thread_no)
+{
+	dict_index_t*	index = ctx->index;
+	trx_t*		trx = ctx->trx;
+	ReadView*	view = trx->read_view.is_open()
+		? &trx->read_view : NULL;
+	const dtuple_t*	start = range ? (*ctx->keys)[range - 1] : NULL;
+	const dtuple_t*	end = range < ctx->keys->size()
+		? (*ctx->keys)[range] : NULL;
+	const ulint	comp = dict_table_is_comp(index->table);
+	mem_heap_t*	heap = NULL;
+	mem_heap_t*	vers_heap = NULL;
+	rec_offs	offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs*	offsets = offsets_;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	dberr_t		err;
+
+	rec_offs_init(offsets_);
+
+	mtr.start();
+
+	if (start) {
+		err = btr_pcur_open(index, start, PAGE_CUR_GE,
+				    BTR_SEARCH_LEAF, &pcur, &mtr);
+	} else {
+		err = btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	}
+
+	while (err == DB_SUCCESS) {
+		if (btr_pcur_is_after_last_on_page(&pcur)) {
+			if (btr_pcur_is_after_last_in_tree(&pcur)) {
+				break;
+			}
+
+			btr_pcur_move_to_next(&pcur, &mtr);
+
+			/* Do not hold the page latch (and the undo
+			pages that were accessed for building old
+			versions) across pages. */
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr.commit();
+
+			if (heap) {
+				offsets = offsets_;
+				mem_heap_empty(heap);
+			}
+
+			if (trx_is_interrupted(trx)) {
+				err = DB_INTERRUPTED;
+				goto func_exit;
+			}
+
+			mtr.start();
+			btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur,
+						  &mtr);
+			continue;
+		}
+
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		if (page_rec_is_infimum(rec) || rec_is_metadata(rec, *index)) {
+			btr_pcur_move_to_next(&pcur, &mtr);
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets, true,
+					  ULINT_UNDEFINED, &heap);
+
+		if (end && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+			break;
+		}
+
+		if (view && !lock_clust_rec_cons_read_sees(rec, index,
+							   offsets, view)) {
+			rec_t*	old_vers = NULL;
+
+			if (!vers_heap) {
+				vers_heap = mem_heap_create(srv_page_size);
+			}
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, view, &heap,
+				vers_heap, &old_vers, NULL);
+
+			if (err == DB_SUCCESS && old_vers
+			    && !rec_get_deleted_flag(old_vers, comp)) {
+				err = ctx->fn(old_vers, offsets, thread_no,
+					      ctx->arg);
+			}
+
+			mem_heap_empty(vers_heap);
+		} else if (!rec_get_deleted_flag(rec, comp)) {
+			err = ctx->fn(rec, offsets, thread_no, ctx->arg);
+		}
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+
+		btr_pcur_move_to_next(&pcur, &mtr);
+	}
+
+	mtr.commit();
+func_exit:
+	btr_pcur_close(&pcur);
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	if (vers_heap) {
+		mem_heap_free(vers_heap);
+	}
+
+	return(err);
+}
+
+/** Scan ranges until all of them have been claimed or an error occurs.
+@param[in,out]	arg	row_pread_task_t */
+static
+void
+row_pread_worker(void* arg)
+{
+	row_pread_task_t*	task = static_cast<row_pread_task_t*>(arg);
+	row_pread_ctx_t*	ctx = task->ctx;
+	const ulint		n_ranges = ctx->keys->size() + 1;
+
+	while (ctx->error.load(std::memory_order_relaxed) == DB_SUCCESS) {
+		ulint	range = ctx->next.fetch_add(1,
+						    std::memory_order_relaxed);
+		if (range >= n_ranges) {
+			break;
+		}
+
+		dberr_t	err = row_pread_scan_range(ctx, range,
+						   task->thread_no);
+
+		if (err != DB_SUCCESS) {
+			dberr_t	expected = DB_SUCCESS;
+			ctx->error.compare_exchange_strong(expected, err);
+			break;
+		}
+	}
+}
+
+/** Scan the records of a clustered index that are visible to the read
+view of a transaction. The index is split into key ranges at the node
+pointers of its upper levels, and the ranges are scanned by up to
+n_threads tasks of srv_thread_pool, including the calling thread.
+@param[in,out]	index		clustered index
+@param[in]	trx		transaction with an open read view,
+				or in READ UNCOMMITTED isolation
+@param[in]	n_threads	maximum number of threads to use
+@param[in]	fn		callback for each visible record
+@param[in,out]	arg		argument of fn
+@return error code
+@retval DB_INTERRUPTED if the statement was killed */
+dberr_t
+row_pread_scan(
+	dict_index_t*	index,
+	trx_t*		trx,
+	ulint		n_threads,
+	row_pread_fn_t	fn,
+	void*		arg)
+{
+	ut_ad(index->is_primary());
+	ut_ad(n_threads >= 1);
+	ut_ad(n_threads <= ROW_PREAD_MAX_THREADS);
+
+	mem_heap_t*		heap = mem_heap_create(1024);
+	row_pread_keys_t	keys;
+	row_pread_ctx_t		ctx;
+	dberr_t			err = DB_SUCCESS;
+
+	if (n_threads > 1) {
+		err = row_pread_split(index,
+				      n_threads * ROW_PREAD_RANGES_PER_THREAD,
+				      heap, keys);
+	}
+
+	if (err == DB_SUCCESS) {
+		ctx.index = index;
+		ctx.trx = trx;
+		ctx.keys = &keys;
+		ctx.fn = fn;
+		ctx.arg = arg;
+		ctx.next = 0;
+		ctx.error = DB_SUCCESS;
+
+		n_threads = std::min(n_threads, keys.size() + 1);
+
+		std::vector<row_pread_task_t>		args(n_threads);
+		std::vector<tpool::waitable_task*>	tasks;
+
+		for (ulint i = 0; i < n_threads; i++) {
+			args[i].ctx = &ctx;
+			args[i].thread_no = i;
+		}
+
+		for (ulint i = 1; i < n_threads; i++) {
+			tpool::waitable_task*	task = new tpool::waitable_task(
+				row_pread_worker, &args[i]);
+			srv_thread_pool->submit_task(task);
+			tasks.push_back(task);
+		}
+
+		row_pread_worker(&args[0]);
+
+		for (tpool::waitable_task* task : tasks) {
+			task->wait();
+			delete task;
+		}
+
+		err = ctx.error;
+	}
+
+	mem_heap_free(heap);
+	return(err);
+}
+
+/** Number of records counted by one thread of row_pread_count() */
+struct row_pread_count_t {
+	/** number of visible records */
+	alignas(CPU_LEVEL1_DCACHE_LINESIZE) ulint	n_rows;
+};
+
+/** Callback of row_pread_count() */
+static
+dberr_t
+row_pread_count_rec(const rec_t*, const rec_offs*, ulint thread_no, void* arg)
+{
+	static_cast<row_pread_count_t*>(arg)[thread_no].n_rows++;
+	return(DB_SUCCESS);
+}
+
+/** Count the records of a clustered index that are visible to the
+read view of a transaction, with row_pread_scan().
+@param[in,out]	index		clustered index
+@param[in]	trx		transaction with an open read view,
+				or in READ UNCOMMITTED isolation
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of visible records
+@return error code
+@retval DB_INTERRUPTED if the statement was killed */
+dberr_t
+row_pread_count(
+	dict_index_t*	index,
+	trx_t*		trx,
+	ulint		n_threads,
+	ulint*		n_rows)
+{
+	ut_ad(n_threads <= ROW_PREAD_MAX_THREADS);
+
+	row_pread_count_t	counts[ROW_PREAD_MAX_THREADS];
+
+	for (ulint i = 0; i < n_threads; i++) {
+		counts[i].n_rows = 0;
+	}
+
+	dberr_t	err = row_pread_scan(index, trx, n_threads,
+				     row_pread_count_rec, counts);
+
+	*n_rows = 0;
+
+	for (ulint i = 0; i < n_threads; i++) {
+		*n_rows += counts[i].n_rows;
+	}
+
+	return(err);
+}
+
+/** State shared by the tasks of row_pread_fetch() */
+struct row_pread_fetch_ctx_t {
+	/** clustered index */
+	dict_index_t*		index;
+	/** search tuples of the keys */
+	const dtuple_t* const*	tuples;
+	/** number of tuples */
+	ulint			n_tuples;
+	/** next tuple to search for */
+	std::atomic<ulint>	next;
+};
+
+/** Search for keys until all of them have been claimed.
+@param[in,out]	arg	row_pread_fetch_ctx_t */
+static
+void
+row_pread_fetch_worker(void* arg)
+{
+	row_pread_fetch_ctx_t*	ctx = static_cast<row_pread_fetch_ctx_t*>(arg);
+
+	for (;;) {
+		ulint	i = ctx->next.fetch_add(1, std::memory_order_relaxed);
+		if (i >= ctx->n_tuples) {
+			break;
+		}
+
+		btr_pcur_t	pcur;
+		mtr_t		mtr;
+
+		/* Only the page reads matter; a missing key or a
+		corrupted page will be reported by the real search. */
+		mtr.start();
+		btr_pcur_open(ctx->index, ctx->tuples[i], PAGE_CUR_LE,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+		mtr.commit();
+		btr_pcur_close(&pcur);
+	}
+}
+
+/** Read the leaf pages of a clustered index that contain the given keys
+into the buffer pool, with up to n_threads tasks of srv_thread_pool,
+including the calling thread. This does not look at the records, so no
+read view is needed; it only makes the later searches for the keys
+avoid waiting for the reads one page at a time.
+@param[in,out]	index		clustered index
+@param[in]	tuples		search tuples of the keys
+@param[in]	n_tuples	number of tuples
+@param[in]	n_threads	maximum number of threads to use */
+void
+row_pread_fetch(
+	dict_index_t*		index,
+	const dtuple_t* const*	tuples,
+	ulint			n_tuples,
+	ulint			n_threads)
+{
+	ut_ad(index->is_primary());
+	ut_ad(n_threads >= 1);
+	ut_ad(n_threads <= ROW_PREAD_MAX_THREADS);
+
+	row_pread_fetch_ctx_t	ctx;
+
+	ctx.index = index;
+	ctx.tuples = tuples;
+	ctx.n_tuples = n_tuples;
+	ctx.next = 0;
+
+	n_threads = std::min(n_threads, n_tuples);
+
+	std::vector<tpool::waitable_task*>	tasks;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		tpool::waitable_task*	task = new tpool::waitable_task(
+			row_pread_fetch_worker, &ctx);
+		srv_thread_pool->submit_task(task);
+		tasks.push_back(task);
+	}
+
+	row_pread_fetch_worker(&ctx);
+
+	for (tpool::waitable_task* task : tasks) {
+		task->wait();
+		delete task;
+	}
+}
@@ -891,6 +891,7 @@ row_purge_parse_undo_rec(
 
 	switch (type) {
 	case TRX_UNDO_RENAME_TABLE:
+	case TRX_UNDO_EMPTY:
 		return false;
 	case TRX_UNDO_INSERT_METADATA:
 	case TRX_UNDO_INSERT_REC:
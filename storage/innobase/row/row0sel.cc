@@ -1491,7 +1491,8 @@ row_sel_try_search_shortcut(
 		}
 	} else if (!srv_read_only_mode
 		   && !lock_sec_rec_cons_read_sees(
-			rec, index, node->read_view)) {
+			rec, btr_pcur_get_block(&plan->pcur), index,
+			node->read_view)) {
 		goto retry;
 	}
 
@@ -1902,7 +1903,8 @@ row_sel(
 			}
 		} else if (!srv_read_only_mode
 			   && !lock_sec_rec_cons_read_sees(
-				   rec, index, node->read_view)) {
+				   rec, btr_pcur_get_block(&plan->pcur),
+				   index, node->read_view)) {
 
 			cons_read_requires_clust_rec = TRUE;
 		}
@@ -3756,12 +3758,22 @@ row_sel_prefetch_cache_init(
 	ulint	i;
 	ulint	sz;
 	byte*	ptr;
+	/* Allow up to MYSQL_FETCH_CACHE_MAX_PAGES pages worth of rows. */
+	const ulint n = std::max<ulint>(
+		MYSQL_FETCH_CACHE_SIZE,
+		std::min<ulint>(MYSQL_FETCH_CACHE_MAX_SIZE,
+				(MYSQL_FETCH_CACHE_MAX_PAGES << srv_page_size_shift)
+				/ (prebuilt->mysql_row_len + 8)));
+
+	prebuilt->fetch_cache = static_cast<byte**>(
+		mem_heap_alloc(prebuilt->heap, n * sizeof *prebuilt->fetch_cache));
+	prebuilt->fetch_cache_size = n;
 
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = n * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < n; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3788,9 +3800,9 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+	if (prebuilt->fetch_cache == NULL) {
 		/* Allocate memory for the fetch cache */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
@@ -4293,6 +4305,9 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		/* Start with a small batch, in case only a few rows
+		will be read. */
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -4327,7 +4342,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 early_not_found:
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -5186,7 +5202,8 @@ row_search_mvcc(
 
 			if (!srv_read_only_mode
 			    && !lock_sec_rec_cons_read_sees(
-					rec, index, &trx->read_view)) {
+					rec, btr_pcur_get_block(pcur),
+					index, &trx->read_view)) {
 				/* We should look at the clustered index.
 				However, as this is a non-locking read,
 				we can skip the clustered index lookup if
@@ -5403,7 +5420,7 @@ row_search_mvcc(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5455,10 +5472,17 @@ row_search_mvcc(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
+		/* The scan is likely to continue. Collect a larger batch
+		next time, to save the btr_pcur_restore_position() and
+		the page latch acquisition. */
+		prebuilt->fetch_cache_limit = std::min(
+			2 * prebuilt->fetch_cache_limit,
+			prebuilt->fetch_cache_size);
+
 	} else {
 		if (UNIV_UNLIKELY
 		    (prebuilt->template_type == ROW_MYSQL_DUMMY_TEMPLATE)) {
@@ -384,6 +384,7 @@ static bool row_undo_ins_parse_undo_rec(undo_node_t* node, bool dict_locked)
 		goto close_table;
 	case TRX_UNDO_INSERT_METADATA:
 	case TRX_UNDO_INSERT_REC:
+	case TRX_UNDO_EMPTY:
 		break;
 	case TRX_UNDO_RENAME_TABLE:
 		dict_table_t* table = node->table;
@@ -417,6 +418,11 @@ static bool row_undo_ins_parse_undo_rec(undo_node_t* node, bool dict_locked)
 		return false;
 	} else {
 		ut_ad(!node->table->skip_alter_undo);
+
+		if (node->rec_type == TRX_UNDO_EMPTY) {
+			return true;
+		}
+
 		clust_index = dict_table_get_first_index(node->table);
 
 		if (clust_index != NULL) {
@@ -596,6 +602,30 @@ row_undo_ins(
 		log_free_check();
 		ut_ad(!node->table->is_temporary());
 		err = row_undo_ins_remove_clust_rec(node);
+		break;
+
+	case TRX_UNDO_EMPTY:
+		/* The table was empty, and the transaction is holding
+		an exclusive lock on it. Remove everything that was
+		inserted without row-level undo logging. */
+		for (dict_index_t* index = node->index; index;
+		     index = dict_table_get_next_index(index)) {
+			if (!(index->type & DICT_FTS)
+			    && !index->is_corrupted()) {
+				log_free_check();
+				btr_clear(index);
+			}
+		}
+
+		err = DB_SUCCESS;
+
+		if (node->table->stat_initialized) {
+			node->table->stat_n_rows = 0;
+			if (!dict_locked) {
+				dict_stats_update_if_needed(node->table,
+							    *node->trx);
+			}
+		}
 	}
 
 	dict_table_close(node->table, dict_locked, FALSE);
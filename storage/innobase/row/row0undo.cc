@@ -362,6 +362,11 @@ static bool row_undo_rec_get(undo_node_t* node)
 	mtr.commit();
 
 	switch (trx_undo_rec_get_type(node->undo_rec)) {
+	case TRX_UNDO_EMPTY:
+		/* This record is only written for persistent tables,
+		and only to the main undo log. */
+		ut_ad(undo == update);
+		/* fall through */
 	case TRX_UNDO_INSERT_METADATA:
 		/* This record type was introduced in MDEV-11369
 		instant ADD COLUMN, which was implemented after
@@ -887,6 +887,46 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_PADDED},
 
+	{"log_flush_batch_1", "recovery",
+	 "Number of log flushes that completed 1 flush request",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_1},
+
+	{"log_flush_batch_2_3", "recovery",
+	 "Number of log flushes that completed 2 to 3 flush requests",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_2_3},
+
+	{"log_flush_batch_4_7", "recovery",
+	 "Number of log flushes that completed 4 to 7 flush requests",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_4_7},
+
+	{"log_flush_batch_8_15", "recovery",
+	 "Number of log flushes that completed 8 to 15 flush requests",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_8_15},
+
+	{"log_flush_batch_16_31", "recovery",
+	 "Number of log flushes that completed 16 to 31 flush requests",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_16_31},
+
+	{"log_flush_batch_32_more", "recovery",
+	 "Number of log flushes that completed 32 or more flush requests",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_BATCH_32_MORE},
+
+	{"log_flush_delayed", "recovery",
+	 "Number of log flushes delayed by innodb_flush_log_delay_usec",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_DELAYED},
+
+	{"log_flush_delay_usec", "recovery",
+	 "Microseconds log flushes were delayed by innodb_flush_log_delay_usec",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_DELAY_USEC},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
@@ -47,6 +47,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "mysql/psi/psi.h"
 
 #include "btr0sea.h"
+#include "buf0dump.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "dict0boot.h"
@@ -133,6 +134,10 @@ my_bool	high_level_read_only;
 
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size;
+/** Maximum number of indexes that are sorted and loaded concurrently
+in index creation, and of threads that apply the log of an online table
+rebuild (innodb_ddl_threads) */
+ulong	srv_ddl_threads;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
 
@@ -141,11 +146,22 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
+#ifdef __linux__
+/** innodb_linux_aio: the native asynchronous I/O implementation
+(tpool::aio_implementation) */
+ulong	srv_linux_aio;
+#endif
 my_bool	srv_numa_interleave;
+/** innodb_buffer_pool_populate */
+my_bool	srv_buf_pool_populate;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
+/** innodb_detect_atomic_writes */
+my_bool	srv_detect_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
 ulong	innodb_compression_algorithm;
+/** innodb_compression_dictionary; used with zstd page compression */
+my_bool	innodb_compression_dictionary;
 
 #ifdef UNIV_DEBUG
 /** Used by SET GLOBAL innodb_master_thread_disabled_debug = X. */
@@ -166,6 +182,8 @@ ulong		srv_log_buffer_size;
 ulong		srv_flush_log_at_trx_commit;
 /** innodb_flush_log_at_timeout */
 uint		srv_flush_log_at_timeout;
+/** innodb_flush_log_delay_usec */
+uint		srv_flush_log_delay_usec;
 /** innodb_page_size */
 ulong		srv_page_size;
 /** log2 of innodb_page_size; @see innodb_init_params() */
@@ -212,6 +230,8 @@ ulint	srv_buf_pool_base_size;
 ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/** innodb_buffer_pool_dump_interval */
+ulong	srv_buf_pool_dump_interval;
 /** Abort load after this amount of pages */
 #ifdef UNIV_DEBUG
 ulong srv_buf_pool_load_pages_abort = LONG_MAX;
@@ -322,6 +342,8 @@ unsigned long long	srv_stats_transient_sample_pages;
 my_bool		srv_stats_persistent;
 /** innodb_stats_include_delete_marked */
 my_bool		srv_stats_include_delete_marked;
+/** innodb_stats_random_sampling */
+my_bool		srv_stats_random_sampling;
 /** innodb_stats_persistent_sample_pages */
 unsigned long long	srv_stats_persistent_sample_pages;
 /** innodb_stats_auto_recalc */
@@ -1795,6 +1817,7 @@ void srv_master_callback(void*)
 	} else {
 		srv_master_do_idle_tasks();
 	}
+	buf_dump_periodic();
 	srv_main_thread_op_info = "sleeping";
 }
 
@@ -63,6 +63,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "mtr0mtr.h"
 #include "log0crypt.h"
 #include "log0recv.h"
+#include "log0online.h"
 #include "page0page.h"
 #include "page0cur.h"
 #include "trx0trx.h"
@@ -1414,6 +1415,8 @@ dberr_t srv_start(bool create_new_db)
 		if (err != DB_SUCCESS) {
 			return(srv_init_abort(err));
 		}
+
+		log_online_init(flushed_lsn);
 	} else {
 		/* Suppress warnings in fil_space_t::create() for files
 		that are being read before dict_boot() has recovered
@@ -1434,6 +1437,13 @@ dberr_t srv_start(bool create_new_db)
 			return(srv_init_abort(err));
 		}
 
+		if (srv_operation == SRV_OPERATION_NORMAL) {
+			/* Start tracking before anything is modified,
+			so that the first run continues where the
+			tracking before a normal shutdown ended. */
+			log_online_init(log_sys.get_lsn());
+		}
+
 		switch (srv_operation) {
 		case SRV_OPERATION_NORMAL:
 		case SRV_OPERATION_RESTORE_EXPORT:
@@ -1990,6 +2000,7 @@ void innodb_shutdown()
 	case SRV_OPERATION_NORMAL:
 		/* Shut down the persistent files. */
 		logs_empty_and_mark_files_at_shutdown();
+		log_online_close();
 	}
 
 	os_aio_free();
@@ -1097,6 +1097,60 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Determine the purge queue of an undo log record. The records of the
+same table and the same first PRIMARY KEY column are assigned to the same
+queue, so that all records of one row are purged in order by one thread,
+while the records of a large table can be purged by several threads.
+@param undo_rec		undo log record
+@param n_purge_threads	number of purge threads
+@return the queue of the undo log record */
+static
+ulint
+trx_purge_rec_queue(trx_undo_rec_t* undo_rec, ulint n_purge_threads)
+{
+	ulint		type;
+	ulint		cmpl_info;
+	bool		updated_extern;
+	undo_no_t	undo_no;
+	table_id_t	table_id;
+	const byte*	ptr = trx_undo_rec_get_pars(
+		undo_rec, &type, &cmpl_info, &updated_extern, &undo_no,
+		&table_id);
+	const ulint	fold = ut_fold_ull(table_id);
+
+	switch (type) {
+	case TRX_UNDO_INSERT_REC:
+		break;
+	case TRX_UNDO_UPD_EXIST_REC:
+	case TRX_UNDO_UPD_DEL_REC:
+	case TRX_UNDO_DEL_MARK_REC: {
+		trx_id_t	trx_id;
+		roll_ptr_t	roll_ptr;
+		byte		info_bits;
+		ptr = trx_undo_update_rec_get_sys_cols(ptr, &trx_id,
+						       &roll_ptr, &info_bits);
+		break;
+	}
+	default:
+		return(fold);
+	}
+
+	const byte*	field;
+	uint32_t	len;
+	uint32_t	orig_len;
+
+	trx_undo_rec_get_col_val(ptr, &field, &len, &orig_len);
+
+	if (len == UNIV_SQL_NULL) {
+		return(fold);
+	}
+
+	/* Different tables may share a queue. It does not matter, as
+	long as all records of a row are assigned to the same queue. */
+	return(ut_fold_ulint_pair(fold, ut_fold_binary(field, len)
+				  % n_purge_threads));
+}
+
 /** Run a purge batch.
 @param n_purge_threads	number of purge threads
 @return number of undo log pages handled in the batch */
@@ -1146,7 +1200,7 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 	i = 0;
 
 	const ulint		batch_size = srv_purge_batch_size;
-	std::unordered_map<table_id_t, purge_node_t*> table_id_map;
+	std::unordered_map<ulint, purge_node_t*> queue_map;
 	mem_heap_empty(purge_sys.heap);
 
 	while (UNIV_LIKELY(srv_undo_sources) || !srv_fast_shutdown) {
@@ -1177,13 +1231,12 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 			continue;
 		}
 
-		table_id_t table_id = trx_undo_rec_get_table_id(
-			purge_rec.undo_rec);
-
-		purge_node_t *& table_node = table_id_map[table_id];
+		purge_node_t *& queue_node = queue_map[
+			trx_purge_rec_queue(purge_rec.undo_rec,
+					    n_purge_threads)];
 
-		if (table_node) {
-			node = table_node;
+		if (queue_node) {
+			node = queue_node;
 		} else {
 			thr = UT_LIST_GET_NEXT(thrs, thr);
 
@@ -1193,7 +1246,7 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 			}
 
 			ut_a(thr != NULL);
-			table_node = node;
+			queue_node = node;
 		}
 
 		node->undo_recs.push(purge_rec);
@@ -488,7 +488,7 @@ trx_undo_rec_get_pars(
 	type_cmpl &= ~TRX_UNDO_UPD_EXTERN;
 	*type = type_cmpl & (TRX_UNDO_CMPL_INFO_MULT - 1);
 	ut_ad(*type >= TRX_UNDO_RENAME_TABLE);
-	ut_ad(*type <= TRX_UNDO_DEL_MARK_REC);
+	ut_ad(*type <= TRX_UNDO_EMPTY);
 	*cmpl_info = type_cmpl / TRX_UNDO_CMPL_INFO_MULT;
 
 	*undo_no = mach_read_next_much_compressed(&ptr);
@@ -1887,11 +1887,54 @@ trx_undo_page_report_rename(trx_t* trx, const dict_table_t* table,
 	return first_free;
 }
 
-/** Report a RENAME TABLE operation.
+/** Report a TRX_UNDO_EMPTY operation.
 @param[in,out]	trx	transaction
-@param[in]	table	table that is being renamed
+@param[in]	table	table that is empty
+@param[in,out]	block	undo page
+@param[in,out]	mtr	mini-transaction
+@return	byte offset of the undo log record
+@retval	0	in case of failure */
+static
+uint16_t
+trx_undo_page_report_empty(trx_t* trx, const dict_table_t* table,
+			   buf_block_t* block, mtr_t* mtr)
+{
+	byte*	ptr_first_free  = my_assume_aligned<2>(TRX_UNDO_PAGE_HDR
+						       + TRX_UNDO_PAGE_FREE
+						       + block->frame);
+	const uint16_t first_free = mach_read_from_2(ptr_first_free);
+	ut_ad(first_free >= TRX_UNDO_PAGE_HDR + TRX_UNDO_PAGE_HDR_SIZE);
+	ut_ad(first_free <= srv_page_size - FIL_PAGE_DATA_END);
+	byte* const start = block->frame + first_free;
+
+	if (trx_undo_left(block, start) < 2 + 1 + 11 + 11 + 2) {
+		ut_ad(first_free > TRX_UNDO_PAGE_HDR
+		      + TRX_UNDO_PAGE_HDR_SIZE);
+		return 0;
+	}
+
+	byte* ptr = start + 2;
+	*ptr++ = TRX_UNDO_EMPTY;
+	ptr += mach_u64_write_much_compressed(ptr, trx->undo_no);
+	ptr += mach_u64_write_much_compressed(ptr, table->id);
+	mach_write_to_2(ptr, first_free);
+	mach_write_to_2(ptr_first_free, ptr + 2 - block->frame);
+	memcpy(start, ptr_first_free, 2);
+	mtr->undo_append(*block, start + 2, ptr - start - 2);
+	return first_free;
+}
+
+/** Write an undo log record about a table-level operation.
+@param[in,out]	trx	transaction
+@param[in]	table	table
+@param[in]	report	trx_undo_page_report_rename or
+			trx_undo_page_report_empty
 @return	DB_SUCCESS or error code */
-dberr_t trx_undo_report_rename(trx_t* trx, const dict_table_t* table)
+static
+dberr_t
+trx_undo_report_table(trx_t* trx, const dict_table_t* table,
+		      uint16_t (*report)(trx_t*, const dict_table_t*,
+					 buf_block_t*, mtr_t*))
 {
 	ut_ad(!trx->read_only);
 	ut_ad(trx->id);
@@ -1909,8 +1952,8 @@ dberr_t trx_undo_report_rename(trx_t* trx, const dict_table_t* table)
 			ut_ad(undo->last_page_no
 			      == block->page.id().page_no());
 
-			if (uint16_t offset = trx_undo_page_report_rename(
-				    trx, table, block, &mtr)) {
+			if (uint16_t offset = report(trx, table, block,
+						     &mtr)) {
 				undo->top_page_no = undo->last_page_no;
 				undo->top_offset  = offset;
 				undo->top_undo_no = trx->undo_no++;
@@ -1935,6 +1978,35 @@ dberr_t trx_undo_report_rename(trx_t* trx, const dict_table_t* table)
 	return err;
 }
 
+/** Report a RENAME TABLE operation.
+@param[in,out]	trx	transaction
+@param[in]	table	table that is being renamed
+@return	DB_SUCCESS or error code */
+dberr_t trx_undo_report_rename(trx_t* trx, const dict_table_t* table)
+{
+	return trx_undo_report_table(trx, table, trx_undo_page_report_rename);
+}
+
+/** Report that an empty table will be filled without row-level undo
+logging. The rollback will empty all indexes of the table.
+@param[in,out]	trx	transaction that holds an exclusive lock
+			on the table
+@param[in]	table	table that is empty
+@return	DB_SUCCESS or error code */
+dberr_t trx_undo_report_empty(trx_t* trx, dict_table_t* table)
+{
+	ut_ad(!trx->mod_tables.count(table));
+	const undo_no_t	first = trx->undo_no;
+	dberr_t err = trx_undo_report_table(trx, table,
+					    trx_undo_page_report_empty);
+	if (err == DB_SUCCESS) {
+		trx->mod_tables.insert(trx_mod_tables_t::value_type(
+					       table, first))
+			.first->second.start_bulk_insert();
+	}
+	return err;
+}
+
 /***********************************************************************//**
 Writes information to an undo log about an insert, update, or a delete marking
 of a clustered index record. This information is used in a rollback of the
@@ -1981,10 +2053,25 @@ trx_undo_report_row_operation(
 	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
 	ut_ad(!trx->in_rollback);
 
+	const bool	is_temp	= index->table->is_temporary();
+
+	if (!rec && !is_temp) {
+		trx_mod_tables_t::iterator i = trx->mod_tables.find(
+			index->table);
+		if (i != trx->mod_tables.end()
+		    && i->second.is_bulk_insert(
+			    trx->last_sql_stat_start.least_undo_no)) {
+			/* The TRX_UNDO_EMPTY record covers this insert.
+			The record will be treated as the first inserted
+			version, like after row_purge_reset_trx_id(). */
+			*roll_ptr = roll_ptr_t{1} << ROLL_PTR_INSERT_FLAG_POS;
+			return(DB_SUCCESS);
+		}
+	}
+
 	mtr.start();
 	trx_undo_t**	pundo;
 	trx_rseg_t*	rseg;
-	const bool	is_temp	= index->table->is_temporary();
 
 	if (is_temp) {
 		mtr.set_log_mode(MTR_LOG_NO_REDO);
@@ -29,6 +29,9 @@ Created 3/26/1996 Heikki Tuuri
 #include <my_service_manager.h>
 #include <mysql/service_wsrep.h>
 
+#include <atomic>
+#include <vector>
+
 #include "fsp0fsp.h"
 #include "lock0lock.h"
 #include "mach0data.h"
@@ -51,8 +54,9 @@ mysql_pfs_key_t	trx_rollback_clean_thread_key;
 /** true if trx_rollback_all_recovered() thread is active */
 bool			trx_rollback_is_active;
 
-/** In crash recovery, the current trx to be rolled back; NULL otherwise */
-const trx_t*		trx_roll_crash_recv_trx;
+/** In crash recovery, the recovered trx that the current thread is
+rolling back; NULL otherwise */
+thread_local const trx_t*	trx_roll_crash_recv_trx;
 
 /** Finish transaction rollback.
 @return	whether the rollback was completed normally
@@ -697,8 +701,9 @@ void trx_roll_report_progress()
 		trx_roll_count_callback_arg arg;
 
 		/* Get number of recovered active transactions and number of
-		rows they modified. Numbers must be accurate, because only this
-		thread is allowed to touch recovered transactions. */
+		rows they modified. Numbers must be accurate, because only the
+		threads of trx_rollback_recovered() are allowed to touch
+		recovered transactions. */
 		trx_sys.rw_trx_hash.iterate_no_dups(
 			trx_roll_count_callback, &arg);
 
@@ -732,12 +737,93 @@ static my_bool trx_rollback_recovered_callback(rw_trx_hash_element_t *element,
 }
 
 
+/** Roll back a recovered ACTIVE transaction, or discard it if the server
+is being shut down.
+@param trx  recovered transaction */
+static void trx_rollback_recovered_trx(trx_t *trx)
+{
+  ut_ad(trx);
+  ut_d(trx->mutex.wr_lock());
+  ut_ad(trx->is_recovered);
+  ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+  ut_d(trx->mutex.wr_unlock());
+
+  if (srv_shutdown_state != SRV_SHUTDOWN_NONE && !srv_undo_sources &&
+      srv_fast_shutdown)
+    goto discard;
+
+  trx_rollback_active(trx);
+  if (trx->error_state != DB_SUCCESS)
+  {
+    ut_ad(trx->error_state == DB_INTERRUPTED);
+    trx->error_state= DB_SUCCESS;
+    ut_ad(!srv_undo_sources);
+    ut_ad(srv_fast_shutdown);
+discard:
+    /* Note: before kill_server() invoked innobase_end() via
+    unireg_end(), it invoked close_connections(), which should initiate
+    the rollback of any user transactions via THD::cleanup() in the
+    connection threads, and wait for all THD::cleanup() to complete.
+    So, no active user transactions should exist at this point.
+
+    srv_undo_sources=false was cleared early in innobase_end().
+
+    Generally, the server guarantees that all connections using
+    InnoDB must be disconnected by the time we are reaching this code,
+    be it during shutdown or UNINSTALL PLUGIN.
+
+    Because there is no possible race condition with any
+    concurrent user transaction, we do not have to invoke
+    trx->commit_state() or wait for !trx->is_referenced()
+    before trx_sys.deregister_rw(trx). */
+    trx_sys.deregister_rw(trx);
+    trx_free_at_shutdown(trx);
+  }
+  else
+    trx->free();
+}
+
+
+/** Recovered transactions that are rolled back by several threads */
+struct trx_roll_recovered_ctx_t
+{
+  /** the transactions */
+  trx_t *const *trx;
+  /** number of transactions */
+  size_t n_trx;
+  /** index of the next transaction to roll back */
+  std::atomic<size_t> next;
+};
+
+
+/** Roll back transactions from a trx_roll_recovered_ctx_t until none
+are left.
+@param arg  trx_roll_recovered_ctx_t */
+static void trx_rollback_recovered_worker(void *arg)
+{
+  trx_roll_recovered_ctx_t *ctx= static_cast<trx_roll_recovered_ctx_t*>(arg);
+
+  for (;;)
+  {
+    const size_t i= ctx->next.fetch_add(1, std::memory_order_relaxed);
+    if (i >= ctx->n_trx)
+      break;
+    trx_rollback_recovered_trx(ctx->trx[i]);
+  }
+}
+
+
 /**
   Rollback any incomplete transactions which were encountered in crash recovery.
 
   If the transaction already was committed, then we clean up a possible insert
   undo log. If the transaction was not yet committed, then we roll it back.
 
+  Incomplete dictionary transactions are rolled back first, one at a time.
+  The other transactions are independent of each other (none of them can
+  wait for a lock held by another), so they are rolled back by up to
+  innodb_purge_threads threads of srv_thread_pool.
+
   Note: For XA recovered transactions, we rely on MySQL to
   do rollback. They will be in TRX_STATE_PREPARED state. If the server
   is shutdown and they are still lingering in trx_sys_t::trx_list
@@ -750,6 +836,7 @@ static my_bool trx_rollback_recovered_callback(rw_trx_hash_element_t *element,
 void trx_rollback_recovered(bool all)
 {
   std::vector<trx_t*> trx_list;
+  std::vector<trx_t*> parallel;
 
   ut_a(srv_force_recovery < SRV_FORCE_NO_TRX_UNDO);
 
@@ -766,48 +853,41 @@ void trx_rollback_recovered(bool all)
     trx_t *trx= trx_list.back();
     trx_list.pop_back();
 
-    ut_ad(trx);
-    ut_d(trx->mutex.wr_lock());
-    ut_ad(trx->is_recovered);
-    ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
-    ut_d(trx->mutex.wr_unlock());
-
     if (srv_shutdown_state != SRV_SHUTDOWN_NONE && !srv_undo_sources &&
         srv_fast_shutdown)
-      goto discard;
+      trx_rollback_recovered_trx(trx);
+    else if (trx_get_dict_operation(trx) != TRX_DICT_OP_NONE)
+      trx_rollback_recovered_trx(trx);
+    else if (all)
+      parallel.push_back(trx);
+  }
 
-    if (all || trx_get_dict_operation(trx) != TRX_DICT_OP_NONE)
-    {
-      trx_rollback_active(trx);
-      if (trx->error_state != DB_SUCCESS)
-      {
-        ut_ad(trx->error_state == DB_INTERRUPTED);
-        trx->error_state= DB_SUCCESS;
-        ut_ad(!srv_undo_sources);
-        ut_ad(srv_fast_shutdown);
-discard:
-        /* Note: before kill_server() invoked innobase_end() via
-        unireg_end(), it invoked close_connections(), which should initiate
-        the rollback of any user transactions via THD::cleanup() in the
-        connection threads, and wait for all THD::cleanup() to complete.
-        So, no active user transactions should exist at this point.
-
-        srv_undo_sources=false was cleared early in innobase_end().
-
-        Generally, the server guarantees that all connections using
-        InnoDB must be disconnected by the time we are reaching this code,
-        be it during shutdown or UNINSTALL PLUGIN.
-
-        Because there is no possible race condition with any
-        concurrent user transaction, we do not have to invoke
-        trx->commit_state() or wait for !trx->is_referenced()
-        before trx_sys.deregister_rw(trx). */
-        trx_sys.deregister_rw(trx);
-        trx_free_at_shutdown(trx);
-      }
-      else
-        trx->free();
-    }
+  if (parallel.empty())
+    return;
+
+  trx_roll_recovered_ctx_t ctx;
+  ctx.trx= parallel.data();
+  ctx.n_trx= parallel.size();
+  ctx.next= 0;
+
+  const size_t n_threads= std::min<size_t>(srv_n_purge_threads,
+                                           parallel.size());
+  std::vector<tpool::waitable_task*> tasks;
+
+  for (size_t i= 1; i < n_threads; i++)
+  {
+    tpool::waitable_task *task=
+      new tpool::waitable_task(trx_rollback_recovered_worker, &ctx);
+    srv_thread_pool->submit_task(task);
+    tasks.push_back(task);
+  }
+
+  trx_rollback_recovered_worker(&ctx);
+
+  for (tpool::waitable_task *task : tasks)
+  {
+    task->wait();
+    delete task;
   }
 }
 
@@ -208,6 +208,10 @@ trx_sys_t::create()
 	rseg_history_len= 0;
 
 	rw_trx_hash.init();
+	m_snapshot_epoch.store(0, std::memory_order_relaxed);
+	m_snapshot_cache.latch.init();
+	/* Never matches m_snapshot_epoch until a snapshot is published */
+	m_snapshot_cache.epoch= ~uint64_t{0};
 }
 
 /*****************************************************************//**
@@ -305,6 +309,8 @@ trx_sys_t::close()
 	}
 
 	rw_trx_hash.destroy();
+	trx_ids_t().swap(m_snapshot_cache.ids);
+	m_snapshot_cache.latch.destroy();
 
 	/* There can't be any active transactions. */
 
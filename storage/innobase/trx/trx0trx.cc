@@ -563,6 +563,8 @@ trx_resurrect_table_locks(
 {
 	mtr_t			mtr;
 	table_id_set		tables;
+	/* tables for which a TRX_UNDO_EMPTY record exists */
+	table_id_set		empty_tables;
 
 	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE) ||
 	      trx_state_eq(trx, TRX_STATE_PREPARED));
@@ -598,6 +600,9 @@ trx_resurrect_table_locks(
 			undo_rec, &type, &cmpl_info,
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
+		if (type == TRX_UNDO_EMPTY) {
+			empty_tables.insert(table_id);
+		}
 
 		undo_rec = trx_undo_get_prev_rec(
 			block, page_offset(undo_rec), undo->hdr_page_no,
@@ -623,11 +628,16 @@ trx_resurrect_table_locks(
 					trx_mod_tables_t::value_type(table,
 								     0));
 			}
-			lock_table_ix_resurrect(table, trx);
+			/* The rollback of TRX_UNDO_EMPTY will empty the
+			table. Nobody else may modify it until then. */
+			const bool empty = empty_tables.count(*i) != 0;
+			lock_table_resurrect(table, trx,
+					     empty ? LOCK_X : LOCK_IX);
 
 			DBUG_LOG("ib_trx",
 				 "resurrect " << ib::hex(trx->id)
-				 << " IX lock on " << table->name);
+				 << (empty ? " X" : " IX")
+				 << " lock on " << table->name);
 
 			dict_table_close(table, FALSE, FALSE);
 		}
@@ -1209,6 +1219,12 @@ trx_flush_log_if_needed(
 			flushed. */
 	trx_t*	trx)	/*!< in/out: transaction */
 {
+	if (trx->mysql_thd && thd_async_commit(trx->mysql_thd)) {
+		/* innodb_async_commit: like innodb_flush_log_at_trx_commit=0
+		for this session only */
+		return;
+	}
+
 	trx->op_info = "flushing log";
 	trx_flush_log_if_needed_low(lsn);
 	trx->op_info = "";
@@ -59,6 +59,7 @@ C_MODE_END
 #define THD_TRN (TRN*) thd_get_ha_data(thd, maria_hton)
 
 ulong pagecache_division_limit, pagecache_age_threshold, pagecache_file_hash_size;
+ulong pagecache_segments;
 ulonglong pagecache_buffer_size;
 const char *zerofill_error_msg=
   "Table is from another system and must be zerofilled or repaired to be "
@@ -257,6 +258,14 @@ static MYSQL_SYSVAR_ULONG(pagecache_file_hash_size, pagecache_file_hash_size,
        "value is probably 1/10 of number of possible open Aria files.", 0,0,
        512, 128, 16384, 1);
 
+static MYSQL_SYSVAR_ULONG(pagecache_segments, pagecache_segments,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Number of equal parts of aria_pagecache_buffer_size. The first "
+       "one is used for all Aria tables but internal temporary tables, "
+       "which are spread over the others to reduce contention when many "
+       "sessions use them. The value of 1 uses one page cache for all "
+       "tables.", 0, 0, 1, 1, 64, 1);
+
 static MYSQL_SYSVAR_SET(recover_options, maria_recover_options, PLUGIN_VAR_OPCMDARG,
        "Specifies how corrupted tables should be automatically repaired",
        NULL, NULL, HA_RECOVER_BACKUP|HA_RECOVER_QUICK, &maria_recover_typelib);
@@ -2750,6 +2759,11 @@ int ha_maria::delete_table(const char *name)
 void ha_maria::drop_table(const char *name)
 {
   DBUG_ASSERT(file->s->temporary);
+  /*
+    The files are deleted right after closing, so let the close discard
+    the changed pages instead of writing them out.
+  */
+  file->s->deleting= TRUE;
   (void) ha_close();
   (void) maria_delete_table_files(name, 1, MY_WME);
 }
@@ -3774,9 +3788,16 @@ static int ha_maria_init(void *p)
     ((force_start_after_recovery_failures != 0 && !aria_readonly) &&
      mark_recovery_start(log_dir)) ||
     !init_pagecache(maria_pagecache,
-                    (size_t) pagecache_buffer_size, pagecache_division_limit,
+                    (size_t) (pagecache_buffer_size / pagecache_segments),
+                    pagecache_division_limit,
                     pagecache_age_threshold, maria_block_size, pagecache_file_hash_size,
                     0) ||
+    multi_pagecache_init_tmp(pagecache_segments - 1,
+                             (size_t) (pagecache_buffer_size /
+                                       pagecache_segments),
+                             pagecache_division_limit,
+                             pagecache_age_threshold, maria_block_size,
+                             pagecache_file_hash_size) ||
     !init_pagecache(maria_log_pagecache,
                     TRANSLOG_PAGECACHE_SIZE, 0, 0,
                     TRANSLOG_PAGE_SIZE, 0, 0) ||
@@ -3901,6 +3922,7 @@ static struct st_mysql_sys_var *system_variables[]= {
   MYSQL_SYSVAR(pagecache_buffer_size),
   MYSQL_SYSVAR(pagecache_division_limit),
   MYSQL_SYSVAR(pagecache_file_hash_size),
+  MYSQL_SYSVAR(pagecache_segments),
   MYSQL_SYSVAR(recover_options),
   MYSQL_SYSVAR(repair_threads),
   MYSQL_SYSVAR(sort_buffer_size),
@@ -81,9 +81,9 @@ static PAGECACHE s3_pagecache;
 static ulong s3_block_size, s3_protocol_version;
 static ulong s3_pagecache_division_limit, s3_pagecache_age_threshold;
 static ulong s3_pagecache_file_hash_size;
-static ulonglong s3_pagecache_buffer_size;
+static ulonglong s3_pagecache_buffer_size, s3_disk_cache_size;
 static char *s3_bucket, *s3_access_key=0, *s3_secret_key=0, *s3_region;
-static char *s3_host_name;
+static char *s3_host_name, *s3_disk_cache_dir;
 static int s3_port;
 static my_bool s3_use_http;
 static char *s3_tmp_access_key=0, *s3_tmp_secret_key=0;
@@ -179,6 +179,26 @@ static MYSQL_SYSVAR_ULONG(pagecache_file_hash_size,
        "changes. A good value is probably 1/10 of number of possible open "
        "S3 files.", 0,0, 512, 32, 16384, 1);
 
+static MYSQL_SYSVAR_ULONG(prefetch_blocks, s3_prefetch_blocks,
+       PLUGIN_VAR_RQCMDARG,
+       "Number of s3_block_size blocks that are read ahead in parallel, "
+       "each by its own thread and connection, when a table is scanned in "
+       "order. 0 disables read ahead",
+       0, 0, 0, 0, S3_MAX_PREFETCH_BLOCKS, 1);
+
+static MYSQL_SYSVAR_STR(disk_cache_dir, s3_disk_cache_dir,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Directory for a local cache of the blocks read from S3, shared by "
+       "all S3 tables. The blocks in it are used after a restart. "
+       "Empty (default) means that no local cache is used",
+       0, 0, "");
+
+static MYSQL_SYSVAR_ULONGLONG(disk_cache_size, s3_disk_cache_size,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Max size of the files in s3_disk_cache_dir. The least recently "
+       "used blocks are removed when it's exceeded", 0, 0,
+       1024*1024*1024, 1024*1024, ~(ulonglong) 0, 1024*1024);
+
 static MYSQL_SYSVAR_STR(bucket, s3_bucket,
        PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
       "AWS bucket",
@@ -725,6 +745,7 @@ static int s3_hton_panic(handlerton *hton, ha_panic_function flag)
   if (flag == HA_PANIC_CLOSE && s3_hton)
   {
     end_pagecache(&s3_pagecache, TRUE);
+    s3_disk_cache_end();
     s3_deinit_library();
     my_free(s3_access_key);
     my_free(s3_secret_key);
@@ -1036,12 +1057,19 @@ static int ha_s3_init(void *p)
   s3_init_library();
   if (s3_debug)
     ms3_debug();
+  if (!res && s3_disk_cache_dir && s3_disk_cache_dir[0] &&
+      s3_disk_cache_init(s3_disk_cache_dir, s3_disk_cache_size))
+  {
+    end_pagecache(&s3_pagecache, TRUE);
+    s3_hton= 0;
+    res= 1;
+  }
 
   struct s3_func s3f_real =
   {
     ms3_set_option, s3_free, ms3_deinit, s3_unique_file_number,
     read_index_header, s3_check_frm_version, s3_info_copy,
-    set_database_and_table_from_path, s3_open_connection
+    set_database_and_table_from_path, s3_open_connection, s3_prefetch_end
   };
   s3f= s3f_real;
 
@@ -1055,6 +1083,8 @@ static int ha_s3_deinit(void*)
 }
 
 static SHOW_VAR status_variables[]= {
+  {"disk_cache_hits", (char*) &s3_disk_cache_hits, SHOW_LONGLONG},
+  {"disk_cache_misses", (char*) &s3_disk_cache_misses, SHOW_LONGLONG},
   {"pagecache_blocks_not_flushed",
    (char*) &s3_pagecache.global_blocks_changed, SHOW_LONG},
   {"pagecache_blocks_unused",
@@ -1072,6 +1102,8 @@ static SHOW_VAR status_variables[]= {
 static struct st_mysql_sys_var* system_variables[]= {
   MYSQL_SYSVAR(block_size),
   MYSQL_SYSVAR(debug),
+  MYSQL_SYSVAR(disk_cache_dir),
+  MYSQL_SYSVAR(disk_cache_size),
   MYSQL_SYSVAR(protocol_version),
   MYSQL_SYSVAR(pagecache_age_threshold),
   MYSQL_SYSVAR(pagecache_buffer_size),
@@ -1079,6 +1111,7 @@ static struct st_mysql_sys_var* system_variables[]= {
   MYSQL_SYSVAR(pagecache_file_hash_size),
   MYSQL_SYSVAR(host_name),
   MYSQL_SYSVAR(port),
+  MYSQL_SYSVAR(prefetch_blocks),
   MYSQL_SYSVAR(use_http),
   MYSQL_SYSVAR(bucket),
   MYSQL_SYSVAR(access_key),
@@ -43,6 +43,11 @@ int maria_close(register MARIA_HA *info)
   /* Check that file is not part of any uncommitted transactions */
   DBUG_ASSERT(info->trn == 0 || info->trn == &dummy_transaction_object);
 
+#ifdef WITH_S3_STORAGE_ENGINE
+  if (info->s3_prefetch)
+    s3f.prefetch_end(info);
+#endif /* WITH_S3_STORAGE_ENGINE */
+
   if (share->reopen == 1)
   {
     /*
@@ -336,7 +336,10 @@ MARIA_HA *maria_open(const char *name, int mode, uint open_flags,
     share_buff.state.key_root=key_root;
     share_buff.pagecache= multi_pagecache_search((uchar*) name_buff,
 						 (uint) strlen(name_buff),
-                                                 maria_pagecache);
+                                                 (internal_table ?
+                                                  multi_pagecache_tmp(
+                                                    maria_pagecache) :
+                                                  maria_pagecache));
 
     if (!s3)
     {
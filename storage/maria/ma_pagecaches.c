@@ -26,6 +26,7 @@
 #include <hash.h>
 #include <m_string.h>
 #include "../../mysys/my_safehash.h"
+#include <my_atomic.h>
 
 /*****************************************************************************
   Functions to handle the pagecache objects
@@ -102,3 +103,86 @@ void multi_pagecache_change(PAGECACHE *old_data,
 {
   safe_hash_change(&pagecache_hash, (uchar*) old_data, (uchar*) new_data);
 }
+
+
+/*****************************************************************************
+  Page caches for internal temporary tables
+
+  Internal temporary tables are not logged and not part of checkpoints,
+  so they can use page caches of their own. Spreading them over several
+  page caches splits the contention on cache_lock between sessions that
+  run big GROUP BY or DISTINCT queries at the same time.
+*****************************************************************************/
+
+static PAGECACHE *tmp_pagecaches;
+static uint tmp_pagecache_count;
+static int32 tmp_pagecache_next;
+
+/*
+  Create the page caches for internal temporary tables
+
+  SYNOPSIS
+    multi_pagecache_init_tmp()
+    count			Number of page caches
+    other arguments		As for init_pagecache(), for each page cache
+
+  RETURN
+    0  ok
+    1  error
+*/
+
+my_bool multi_pagecache_init_tmp(uint count, size_t use_mem,
+                                 uint division_limit, uint age_threshold,
+                                 uint block_size,
+                                 uint changed_blocks_hash_size)
+{
+  uint i;
+  DBUG_ENTER("multi_pagecache_init_tmp");
+  if (!count)
+    DBUG_RETURN(0);
+  if (!(tmp_pagecaches= (PAGECACHE*) my_malloc(PSI_INSTRUMENT_ME,
+                                               sizeof(PAGECACHE) * count,
+                                               MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  tmp_pagecache_count= count;
+  for (i= 0; i < count; i++)
+  {
+    if (!init_pagecache(tmp_pagecaches + i, use_mem, division_limit,
+                        age_threshold, block_size, changed_blocks_hash_size,
+                        0))
+    {
+      multi_pagecache_end_tmp();
+      DBUG_RETURN(1);
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
+void multi_pagecache_end_tmp(void)
+{
+  uint i;
+  for (i= 0; i < tmp_pagecache_count; i++)
+    end_pagecache(tmp_pagecaches + i, TRUE);
+  my_free(tmp_pagecaches);
+  tmp_pagecaches= 0;
+  tmp_pagecache_count= 0;
+}
+
+
+/*
+  Get the page cache for a new internal temporary table
+
+  The page caches are assigned round robin. If there are none, def is
+  returned.
+*/
+
+PAGECACHE *multi_pagecache_tmp(PAGECACHE *def)
+{
+  uint32 next;
+  if (!tmp_pagecache_count)
+    return def;
+  next= (uint32) my_atomic_add32_explicit(&tmp_pagecache_next, 1,
+                                          MY_MEMORY_ORDER_RELAXED);
+  return tmp_pagecaches + next % tmp_pagecache_count;
+}
@@ -912,6 +912,7 @@ struct st_maria_handler
   MARIA_STATUS_INFO *state_start;       /* State at start of transaction */
   MARIA_USED_TABLES *used_tables;
   struct ms3_st *s3;
+  struct s3_prefetch *s3_prefetch;       /* Read ahead of S3 blocks */
   void **stack_end_ptr;
   MARIA_ROW cur_row;                    /* The active row that we just read */
   MARIA_ROW new_row;			/* Storage for a row during update */
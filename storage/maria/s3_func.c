@@ -138,22 +138,17 @@ S3_INFO *s3_info_copy(S3_INFO *old)
 }
 
 /**
-   Open a connection to s3
+   Open a connection to s3 without reporting errors
 */
 
-ms3_st *s3_open_connection(S3_INFO *s3)
+static ms3_st *s3_open_connection_low(S3_INFO *s3)
 {
   ms3_st *s3_client;
   if (!(s3_client= ms3_init(s3->access_key.str,
                             s3->secret_key.str,
                             s3->region.str,
                             s3->host_name.str)))
-  {
-    my_printf_error(HA_ERR_NO_SUCH_TABLE,
-                    "Can't open connection to S3, error: %d %s", MYF(0),
-                    errno, ms3_error(errno));
-    my_errno= HA_ERR_NO_SUCH_TABLE;
-  }
+    return 0;
   if (s3->protocol_version)
     ms3_set_option(s3_client, MS3_OPT_FORCE_PROTOCOL_VERSION,
                    &s3->protocol_version);
@@ -166,6 +161,24 @@ ms3_st *s3_open_connection(S3_INFO *s3)
   return s3_client;
 }
 
+
+/**
+   Open a connection to s3
+*/
+
+ms3_st *s3_open_connection(S3_INFO *s3)
+{
+  ms3_st *s3_client;
+  if (!(s3_client= s3_open_connection_low(s3)))
+  {
+    my_printf_error(HA_ERR_NO_SUCH_TABLE,
+                    "Can't open connection to S3, error: %d %s", MYF(0),
+                    errno, ms3_error(errno));
+    my_errno= HA_ERR_NO_SUCH_TABLE;
+  }
+  return s3_client;
+}
+
 /**
    close a connection to s3
 */
@@ -966,6 +979,66 @@ int s3_put_object(ms3_st *s3_client, const char *aws_bucket,
 }
 
 
+/**
+   Uncompress a block that was read with s3_get_object()
+
+   The block is freed on error.
+*/
+
+static int s3_uncompress_block(S3_BLOCK *block, const char *name)
+{
+  ulong length;
+  uchar *data;
+
+  /* If not compressed */
+  if (!block->str[0])
+  {
+    block->length-= COMPRESS_HEADER;
+    block->str+=    COMPRESS_HEADER;
+
+    /* Simple check to ensure that it's a correct block */
+    if (block->length % 1024)
+    {
+      s3_free(block);
+      my_printf_error(HA_ERR_NOT_A_TABLE,
+                      "Block '%s' is not compressed", MYF(0), name);
+      return HA_ERR_NOT_A_TABLE;
+    }
+    return 0;
+  }
+
+  if (((uchar*)block->str)[0] > 1)
+  {
+    s3_free(block);
+    my_printf_error(HA_ERR_NOT_A_TABLE,
+                    "Block '%s' is not compressed", MYF(0), name);
+    return HA_ERR_NOT_A_TABLE;
+  }
+
+  length= uint3korr(block->str+1);
+
+  if (!(data= (uchar*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                 length, MYF(MY_WME | MY_THREAD_SPECIFIC))))
+  {
+    s3_free(block);
+    return EE_OUTOFMEMORY;
+  }
+  if (uncompress(data, &length, block->str + COMPRESS_HEADER,
+                 block->length - COMPRESS_HEADER))
+  {
+    my_printf_error(ER_NET_UNCOMPRESS_ERROR,
+                    "Got error uncompressing s3 packet", MYF(0));
+    s3_free(block);
+    my_free(data);
+    return ER_NET_UNCOMPRESS_ERROR;
+  }
+  s3_free(block);
+  block->str= block->alloc_ptr= data;
+  block->length= length;
+  return 0;
+}
+
+
 /**
    Read an object for index or data information
 
@@ -980,7 +1053,6 @@ int s3_get_object(ms3_st *s3_client, const char *aws_bucket,
 {
   uint8_t error;
   int result= 0;
-  uchar *data;
   DBUG_ENTER("s3_get_object");
   DBUG_PRINT("enter", ("name: %s  compression: %d", name, compression));
 
@@ -991,55 +1063,7 @@ int s3_get_object(ms3_st *s3_client, const char *aws_bucket,
   {
     block->str= block->alloc_ptr;
     if (compression)
-    {
-      ulong length;
-
-      /* If not compressed */
-      if (!block->str[0])
-      {
-        block->length-= COMPRESS_HEADER;
-        block->str+=    COMPRESS_HEADER;
-
-        /* Simple check to ensure that it's a correct block */
-        if (block->length % 1024)
-        {
-          s3_free(block);
-          my_printf_error(HA_ERR_NOT_A_TABLE,
-                          "Block '%s' is not compressed", MYF(0), name);
-          DBUG_RETURN(HA_ERR_NOT_A_TABLE);
-        }
-        DBUG_RETURN(0);
-      }
-
-      if (((uchar*)block->str)[0] > 1)
-      {
-        s3_free(block);
-        my_printf_error(HA_ERR_NOT_A_TABLE,
-                        "Block '%s' is not compressed", MYF(0), name);
-        DBUG_RETURN(HA_ERR_NOT_A_TABLE);
-      }
-
-      length= uint3korr(block->str+1);
-
-      if (!(data= (uchar*) my_malloc(PSI_NOT_INSTRUMENTED,
-                                     length, MYF(MY_WME | MY_THREAD_SPECIFIC))))
-      {
-        s3_free(block);
-        DBUG_RETURN(EE_OUTOFMEMORY);
-      }
-      if (uncompress(data, &length, block->str + COMPRESS_HEADER,
-                     block->length - COMPRESS_HEADER))
-      {
-        my_printf_error(ER_NET_UNCOMPRESS_ERROR,
-                        "Got error uncompressing s3 packet", MYF(0));
-        s3_free(block);
-        my_free(data);
-        DBUG_RETURN(ER_NET_UNCOMPRESS_ERROR);
-      }
-      s3_free(block);
-      block->str= block->alloc_ptr= data;
-      block->length= length;
-    }
+      DBUG_RETURN(s3_uncompress_block(block, name));
     DBUG_RETURN(0);
   }
 
@@ -1576,6 +1600,706 @@ my_bool s3_block_read(struct st_pagecache *pagecache,
 #endif
 
 
+/******************************************************************************
+ Local disk cache of S3 blocks
+
+ Data and index blocks are stored, as they are in S3, in files in
+ s3_disk_cache_dir, so that a block that was dropped from the page cache
+ or read before a restart doesn't have to be fetched from S3 again. The
+ cache is shared by all tables. When it grows above its max size, the
+ least recently used files are deleted.
+
+ A file starts with a header that holds a checksum of the key and the
+ data, the length of the key and the length of the data, followed by the
+ key and the data. The name of the file is a hash of the key. The key
+ includes the frm version, the create time and the file lengths of the
+ table, so that blocks of a table that was dropped and created again are
+ not used.
+******************************************************************************/
+
+#define S3_DISK_CACHE_MAGIC   "S3C1"
+#define S3_DISK_CACHE_HEADER  (4+4+4+8)
+#define S3_DISK_CACHE_KEY_LENGTH (AWS_PATH_LENGTH + NAME_LEN + \
+                                  MY_UUID_STRING_LENGTH + 64)
+#define S3_DISK_CACHE_EXT     ".s3c"
+
+typedef struct st_s3_disk_cache_entry
+{
+  ulonglong hash;
+  ulonglong size;
+  /* LRU list, most recently used first */
+  struct st_s3_disk_cache_entry *next, *prev;
+} S3_DISK_CACHE_ENTRY;
+
+static struct st_s3_disk_cache
+{
+  mysql_mutex_t lock;
+  HASH entries;
+  S3_DISK_CACHE_ENTRY *first, *last;
+  ulonglong size, max_size;
+  char dir[FN_REFLEN];
+  my_bool inited;
+} s3_disk_cache;
+
+ulonglong s3_disk_cache_hits, s3_disk_cache_misses;
+
+
+static void s3_disk_cache_unlink(S3_DISK_CACHE_ENTRY *entry)
+{
+  if (entry->prev)
+    entry->prev->next= entry->next;
+  else
+    s3_disk_cache.first= entry->next;
+  if (entry->next)
+    entry->next->prev= entry->prev;
+  else
+    s3_disk_cache.last= entry->prev;
+}
+
+
+static void s3_disk_cache_link_first(S3_DISK_CACHE_ENTRY *entry)
+{
+  entry->prev= 0;
+  if ((entry->next= s3_disk_cache.first))
+    entry->next->prev= entry;
+  else
+    s3_disk_cache.last= entry;
+  s3_disk_cache.first= entry;
+}
+
+
+static void s3_disk_cache_file_name(char *to, ulonglong hash)
+{
+  my_snprintf(to, FN_REFLEN, "%s%016llx%s", s3_disk_cache.dir, hash,
+              S3_DISK_CACHE_EXT);
+}
+
+
+/*
+  Remove an entry and its file. Must be called with lock held
+*/
+
+static void s3_disk_cache_remove(S3_DISK_CACHE_ENTRY *entry)
+{
+  char name[FN_REFLEN];
+  s3_disk_cache_file_name(name, entry->hash);
+  my_delete(name, MYF(0));
+  s3_disk_cache.size-= entry->size;
+  s3_disk_cache_unlink(entry);
+  my_hash_delete(&s3_disk_cache.entries, (uchar*) entry);
+}
+
+
+typedef struct st_s3_disk_cache_file
+{
+  time_t mtime;
+  S3_DISK_CACHE_ENTRY *entry;
+} S3_DISK_CACHE_FILE;
+
+static int cmp_disk_cache_file(const void *a, const void *b)
+{
+  time_t a_time= ((S3_DISK_CACHE_FILE*) a)->mtime;
+  time_t b_time= ((S3_DISK_CACHE_FILE*) b)->mtime;
+  return a_time < b_time ? -1 : a_time > b_time;
+}
+
+
+/**
+   Start using the local disk cache
+
+   The files that are already in the directory are used, with the most
+   recently written ones as the most recently used.
+
+   @param dir       Directory for the cache files. Must exist.
+   @param max_size  Max total size of the files
+*/
+
+my_bool s3_disk_cache_init(const char *dir, ulonglong max_size)
+{
+  MY_DIR *dirp;
+  S3_DISK_CACHE_FILE *files;
+  uint i, count= 0;
+  DBUG_ENTER("s3_disk_cache_init");
+
+  if (!(dirp= my_dir(dir, MYF(MY_WME | MY_WANT_STAT))))
+    DBUG_RETURN(1);
+  if (!(files= (S3_DISK_CACHE_FILE*)
+        my_malloc(PSI_NOT_INSTRUMENTED,
+                  sizeof(*files) * (dirp->number_of_files + 1),
+                  MYF(MY_WME))) ||
+      my_hash_init(PSI_NOT_INSTRUMENTED, &s3_disk_cache.entries,
+                   &my_charset_bin, 1024,
+                   offsetof(S3_DISK_CACHE_ENTRY, hash), sizeof(ulonglong),
+                   0, my_free, 0))
+  {
+    my_free(files);
+    my_dirend(dirp);
+    DBUG_RETURN(1);
+  }
+  mysql_mutex_init(0, &s3_disk_cache.lock, MY_MUTEX_INIT_FAST);
+  s3_disk_cache.first= s3_disk_cache.last= 0;
+  s3_disk_cache.size= 0;
+  s3_disk_cache.max_size= max_size;
+  strxnmov(s3_disk_cache.dir, sizeof(s3_disk_cache.dir)-18-4, dir, "/",
+           NullS);
+  s3_disk_cache.inited= 1;
+
+  for (i= 0; i < dirp->number_of_files; i++)
+  {
+    FILEINFO *file= dirp->dir_entry + i;
+    S3_DISK_CACHE_ENTRY *entry;
+    char *end;
+    ulonglong hash= strtoull(file->name, &end, 16);
+
+    if (end != file->name + 16)
+      continue;
+    if (!strncmp(end, S3_DISK_CACHE_EXT ".", sizeof(S3_DISK_CACHE_EXT)))
+    {
+      /* Left from a write that was interrupted */
+      char name[FN_REFLEN];
+      strxnmov(name, sizeof(name)-1, s3_disk_cache.dir, file->name, NullS);
+      my_delete(name, MYF(0));
+      continue;
+    }
+    if (strcmp(end, S3_DISK_CACHE_EXT) ||
+        !(entry= (S3_DISK_CACHE_ENTRY*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                                  sizeof(*entry), MYF(0))))
+      continue;
+    entry->hash= hash;
+    entry->size= (ulonglong) file->mystat->st_size;
+    if (my_hash_insert(&s3_disk_cache.entries, (uchar*) entry))
+    {
+      my_free(entry);
+      continue;
+    }
+    files[count].mtime= file->mystat->st_mtime;
+    files[count++].entry= entry;
+  }
+  my_dirend(dirp);
+
+  my_qsort(files, count, sizeof(*files), cmp_disk_cache_file);
+  for (i= 0; i < count; i++)
+  {
+    s3_disk_cache_link_first(files[i].entry);
+    s3_disk_cache.size+= files[i].entry->size;
+  }
+  my_free(files);
+
+  while (s3_disk_cache.size > s3_disk_cache.max_size)
+    s3_disk_cache_remove(s3_disk_cache.last);
+  DBUG_RETURN(0);
+}
+
+
+void s3_disk_cache_end()
+{
+  if (!s3_disk_cache.inited)
+    return;
+  s3_disk_cache.inited= 0;
+  my_hash_free(&s3_disk_cache.entries);
+  mysql_mutex_destroy(&s3_disk_cache.lock);
+}
+
+
+static ulonglong s3_disk_cache_hash(const char *key, size_t key_length)
+{
+  return (((ulonglong) crc32(0, (uchar*) key, (uint) key_length) << 32) |
+          crc32(0x5a5a5a5a, (uchar*) key, (uint) key_length));
+}
+
+
+static size_t s3_disk_cache_key(char *to, MARIA_SHARE *share,
+                                const char *aws_path)
+{
+  S3_INFO *s3= share->s3_path;
+  char version[MY_UUID_STRING_LENGTH+1];
+
+  /* The frm version changes when a table with the same name is created */
+  version[0]= 0;
+  if (s3->tabledef_version.length == MY_UUID_SIZE)
+  {
+    my_uuid2str(s3->tabledef_version.str, version);
+    version[MY_UUID_STRING_LENGTH]= 0;
+  }
+  return (size_t) (my_snprintf(to, S3_DISK_CACHE_KEY_LENGTH,
+                               "%s/%s/%s/%llx-%llx-%llx",
+                               s3->bucket.str, aws_path, version,
+                               (ulonglong) share->state.create_time,
+                               (ulonglong) share->state.state.data_file_length,
+                               (ulonglong) share->state.state.key_file_length));
+}
+
+
+/**
+   Read a block from the local disk cache
+
+   @return 0  block was read
+   @return 1  block is not in the cache
+*/
+
+static my_bool s3_disk_cache_read(const char *key, size_t key_length,
+                                  S3_BLOCK *block)
+{
+  char name[FN_REFLEN];
+  uchar header[S3_DISK_CACHE_HEADER];
+  ulonglong hash= s3_disk_cache_hash(key, key_length);
+  S3_DISK_CACHE_ENTRY *entry;
+  size_t length;
+  uchar *data= 0;
+  File file;
+
+  mysql_mutex_lock(&s3_disk_cache.lock);
+  if (!(entry= (S3_DISK_CACHE_ENTRY*) my_hash_search(&s3_disk_cache.entries,
+                                                     (uchar*) &hash,
+                                                     sizeof(hash))))
+  {
+    s3_disk_cache_misses++;
+    mysql_mutex_unlock(&s3_disk_cache.lock);
+    return 1;
+  }
+  s3_disk_cache_unlink(entry);
+  s3_disk_cache_link_first(entry);
+  mysql_mutex_unlock(&s3_disk_cache.lock);
+
+  /* A file that is deleted while we read it stays readable */
+  s3_disk_cache_file_name(name, hash);
+  if ((file= my_open(name, O_RDONLY | O_SHARE | O_BINARY, MYF(0))) < 0)
+    goto err;
+  if (my_read(file, header, sizeof(header), MYF(MY_NABP)) ||
+      memcmp(header, S3_DISK_CACHE_MAGIC, 4) ||
+      uint4korr(header+8) != key_length)
+    goto err_close;
+  length= (size_t) uint8korr(header+12);
+  if (!(data= (uchar*) my_malloc(PSI_NOT_INSTRUMENTED, key_length + length,
+                                 MYF(0))) ||
+      my_read(file, data, key_length + length, MYF(MY_NABP)) ||
+      memcmp(data, key, key_length) ||
+      uint4korr(header+4) != (uint32) crc32(0, data, (uint) (key_length +
+                                                             length)))
+    goto err_close;
+  my_close(file, MYF(0));
+
+  /* The data follows the key */
+  block->alloc_ptr= data;
+  block->str= data + key_length;
+  block->length= length;
+
+  mysql_mutex_lock(&s3_disk_cache.lock);
+  s3_disk_cache_hits++;
+  mysql_mutex_unlock(&s3_disk_cache.lock);
+  return 0;
+
+err_close:
+  my_close(file, MYF(0));
+err:
+  /* Missing or broken file, or another key with the same hash */
+  my_free(data);
+  mysql_mutex_lock(&s3_disk_cache.lock);
+  s3_disk_cache_misses++;
+  if ((entry= (S3_DISK_CACHE_ENTRY*) my_hash_search(&s3_disk_cache.entries,
+                                                    (uchar*) &hash,
+                                                    sizeof(hash))))
+    s3_disk_cache_remove(entry);
+  mysql_mutex_unlock(&s3_disk_cache.lock);
+  return 1;
+}
+
+
+/**
+   Store a block that was read from S3 in the local disk cache
+
+   The file is written under a temporary name and renamed, so that a
+   reader never sees a partly written file.
+*/
+
+static void s3_disk_cache_write(const char *key, size_t key_length,
+                                S3_BLOCK *block)
+{
+  char name[FN_REFLEN], tmp_name[FN_REFLEN];
+  uchar header[S3_DISK_CACHE_HEADER];
+  ulonglong hash= s3_disk_cache_hash(key, key_length);
+  ulonglong size= sizeof(header) + key_length + block->length;
+  S3_DISK_CACHE_ENTRY *entry;
+  uint32 crc;
+  File file;
+
+  if (size > s3_disk_cache.max_size)
+    return;
+
+  crc= (uint32) crc32(0, (uchar*) key, (uint) key_length);
+  crc= (uint32) crc32(crc, block->str, (uint) block->length);
+  memcpy(header, S3_DISK_CACHE_MAGIC, 4);
+  int4store(header+4, crc);
+  int4store(header+8, (uint32) key_length);
+  int8store(header+12, (ulonglong) block->length);
+
+  s3_disk_cache_file_name(name, hash);
+  my_snprintf(tmp_name, sizeof(tmp_name), "%s.%d", name,
+              (int) s3_unique_file_number());
+  if ((file= my_create(tmp_name, 0, O_WRONLY | O_TRUNC | O_BINARY,
+                       MYF(0))) < 0)
+    return;
+  if (my_write(file, header, sizeof(header), MYF(MY_NABP)) ||
+      my_write(file, (uchar*) key, key_length, MYF(MY_NABP)) ||
+      my_write(file, block->str, block->length, MYF(MY_NABP)) ||
+      my_close(file, MYF(0)))
+  {
+    my_close(file, MYF(0));
+    my_delete(tmp_name, MYF(0));
+    return;
+  }
+
+  mysql_mutex_lock(&s3_disk_cache.lock);
+  if (my_rename(tmp_name, name, MYF(0)))
+  {
+    mysql_mutex_unlock(&s3_disk_cache.lock);
+    my_delete(tmp_name, MYF(0));
+    return;
+  }
+  if ((entry= (S3_DISK_CACHE_ENTRY*) my_hash_search(&s3_disk_cache.entries,
+                                                    (uchar*) &hash,
+                                                    sizeof(hash))))
+  {
+    /* Written by another thread at the same time */
+    s3_disk_cache.size-= entry->size;
+    s3_disk_cache_unlink(entry);
+  }
+  else
+  {
+    if (!(entry= (S3_DISK_CACHE_ENTRY*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                                  sizeof(*entry), MYF(0))))
+      goto err;
+    entry->hash= hash;
+    if (my_hash_insert(&s3_disk_cache.entries, (uchar*) entry))
+    {
+      my_free(entry);
+      goto err;
+    }
+  }
+  entry->size= size;
+  s3_disk_cache_link_first(entry);
+  s3_disk_cache.size+= size;
+
+  while (s3_disk_cache.size > s3_disk_cache.max_size)
+    s3_disk_cache_remove(s3_disk_cache.last);
+  mysql_mutex_unlock(&s3_disk_cache.lock);
+  return;
+
+err:
+  my_delete(name, MYF(0));
+  mysql_mutex_unlock(&s3_disk_cache.lock);
+}
+
+
+/**
+   Read a data or index block, from the local disk cache if it's used
+
+   The block is not uncompressed
+*/
+
+static int s3_get_block(ms3_st *client, MARIA_SHARE *share,
+                        const char *aws_path, S3_BLOCK *block,
+                        int print_error)
+{
+  char key[S3_DISK_CACHE_KEY_LENGTH];
+  size_t key_length;
+  int error;
+
+  if (!s3_disk_cache.inited)
+    return s3_get_object(client, share->s3_path->bucket.str, aws_path,
+                         block, 0, print_error);
+
+  key_length= s3_disk_cache_key(key, share, aws_path);
+  if (!s3_disk_cache_read(key, key_length, block))
+    return 0;
+  if (!(error= s3_get_object(client, share->s3_path->bucket.str, aws_path,
+                             block, 0, print_error)))
+    s3_disk_cache_write(key, key_length, block);
+  return error;
+}
+
+
+/******************************************************************************
+ Read ahead of S3 blocks
+
+ When a handler reads the blocks of a data or index file in order, the
+ next s3_prefetch_blocks blocks are fetched by background threads, one
+ GET per thread and each thread with its own connection to S3, while the
+ caller is working on the current block. A fetched block is kept in the
+ handler until the page cache asks for it with s3_block_read().
+******************************************************************************/
+
+ulong s3_prefetch_blocks= 0;
+
+enum s3_prefetch_state
+{
+  S3_PREFETCH_FREE, S3_PREFETCH_QUEUED, S3_PREFETCH_READING, S3_PREFETCH_DONE
+};
+
+typedef struct st_s3_prefetch_slot
+{
+  S3_BLOCK block;
+  ulong block_number;
+  enum s3_prefetch_state state;
+  int error;
+  my_bool datafile;
+  char aws_path[AWS_PATH_LENGTH];
+} S3_PREFETCH_SLOT;
+
+struct s3_prefetch
+{
+  mysql_mutex_t lock;
+  mysql_cond_t cond;                    /* Signaled on every state change */
+  MARIA_SHARE *share;
+  S3_INFO *s3_info;
+  size_t block_size;
+  pthread_t threads[S3_MAX_PREFETCH_BLOCKS];
+  uint thread_count;
+  my_bool threads_started, stop;
+  /* Last block read from the index file [0] and the data file [1] */
+  ulong last_block[2];
+  S3_PREFETCH_SLOT slots[S3_MAX_PREFETCH_BLOCKS * 2];
+};
+
+
+static void s3_block_path(char *aws_path, S3_INFO *s3, my_bool datafile,
+                          ulong block_number)
+{
+  char *end= strxnmov(aws_path, AWS_PATH_LENGTH-12, s3->database.str, "/",
+                      s3->table.str, datafile ? "/data/" : "/index/",
+                      "000000", NullS);
+  fix_suffix(end, block_number);
+}
+
+
+static void *s3_prefetch_thread(void *arg)
+{
+  S3_PREFETCH *prefetch= (S3_PREFETCH*) arg;
+  ms3_st *client;
+  my_thread_init();
+
+  if ((client= s3_open_connection_low(prefetch->s3_info)))
+    ms3_set_option(client, MS3_OPT_BUFFER_CHUNK_SIZE, &prefetch->block_size);
+
+  mysql_mutex_lock(&prefetch->lock);
+  for (;;)
+  {
+    S3_PREFETCH_SLOT *slot;
+    S3_PREFETCH_SLOT *end= prefetch->slots + array_elements(prefetch->slots);
+    S3_BLOCK block;
+    int error;
+
+    for (slot= prefetch->slots; slot < end; slot++)
+      if (slot->state == S3_PREFETCH_QUEUED)
+        break;
+    if (slot == end)
+    {
+      if (prefetch->stop)
+        break;
+      mysql_cond_wait(&prefetch->cond, &prefetch->lock);
+      continue;
+    }
+    slot->state= S3_PREFETCH_READING;
+    mysql_mutex_unlock(&prefetch->lock);
+
+    /*
+      The block is uncompressed by the thread that uses it, as the
+      memory for it is accounted to that thread
+    */
+    block.str= block.alloc_ptr= 0;
+    error= (client ?
+            s3_get_block(client, prefetch->share, slot->aws_path, &block, 0) :
+            HA_ERR_NO_SUCH_TABLE);
+
+    mysql_mutex_lock(&prefetch->lock);
+    slot->block= block;
+    slot->error= error;
+    slot->state= S3_PREFETCH_DONE;
+    mysql_cond_broadcast(&prefetch->cond);
+  }
+  mysql_mutex_unlock(&prefetch->lock);
+
+  if (client)
+    s3_deinit(client);
+  my_thread_end();
+  return 0;
+}
+
+
+static void s3_prefetch_free_slot(S3_PREFETCH_SLOT *slot)
+{
+  if (slot->state == S3_PREFETCH_DONE && !slot->error)
+    s3_free(&slot->block);
+  slot->state= S3_PREFETCH_FREE;
+}
+
+
+/**
+   Stop the read ahead threads of a handler and free all fetched blocks
+*/
+
+void s3_prefetch_end(MARIA_HA *info)
+{
+  S3_PREFETCH *prefetch= info->s3_prefetch;
+  S3_PREFETCH_SLOT *slot;
+  S3_PREFETCH_SLOT *end= prefetch->slots + array_elements(prefetch->slots);
+  uint i;
+
+  mysql_mutex_lock(&prefetch->lock);
+  for (slot= prefetch->slots; slot < end; slot++)
+    if (slot->state == S3_PREFETCH_QUEUED)
+      slot->state= S3_PREFETCH_FREE;
+  prefetch->stop= 1;
+  mysql_cond_broadcast(&prefetch->cond);
+  mysql_mutex_unlock(&prefetch->lock);
+
+  for (i= 0; i < prefetch->thread_count; i++)
+    pthread_join(prefetch->threads[i], NULL);
+
+  for (slot= prefetch->slots; slot < end; slot++)
+    s3_prefetch_free_slot(slot);
+  mysql_cond_destroy(&prefetch->cond);
+  mysql_mutex_destroy(&prefetch->lock);
+  my_free(prefetch);
+  info->s3_prefetch= 0;
+}
+
+
+/**
+   Get a block from the read ahead buffer and queue the blocks that
+   follow it if the file is read in order
+
+   @param error  Set to the result of reading the block, if it was found
+
+   @return 1  block was taken from the read ahead buffer
+   @return 0  block has to be read by the caller
+*/
+
+static my_bool s3_prefetch_read(PAGECACHE *pagecache, PAGECACHE_FILE *file,
+                                MARIA_HA *info, my_bool datafile,
+                                ulong block_number, S3_BLOCK *block,
+                                int *error)
+{
+  MARIA_SHARE *share= info->s;
+  S3_PREFETCH *prefetch= info->s3_prefetch;
+  S3_PREFETCH_SLOT *slot, *found= 0;
+  S3_PREFETCH_SLOT *end;
+  my_bool sequential;
+  ulong next, last_block, depth;
+  my_off_t length, head;
+  DBUG_ENTER("s3_prefetch_read");
+
+  if (!prefetch)
+  {
+    if (!(prefetch= (S3_PREFETCH*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                             sizeof(*prefetch),
+                                             MYF(MY_ZEROFILL))))
+      DBUG_RETURN(0);
+    mysql_mutex_init(0, &prefetch->lock, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(0, &prefetch->cond, 0);
+    prefetch->share= share;
+    prefetch->s3_info= share->s3_path;
+    prefetch->block_size= share->base.s3_block_size;
+    info->s3_prefetch= prefetch;
+  }
+  end= prefetch->slots + array_elements(prefetch->slots);
+
+  mysql_mutex_lock(&prefetch->lock);
+  for (slot= prefetch->slots; slot < end; slot++)
+  {
+    if (slot->state == S3_PREFETCH_FREE || slot->datafile != datafile)
+      continue;
+    if (slot->block_number == block_number)
+      found= slot;
+    else if (slot->block_number < block_number &&
+             slot->state != S3_PREFETCH_READING)
+      s3_prefetch_free_slot(slot);              /* Skipped by the reader */
+  }
+
+  /*
+    Blocks that are already in the page cache are not read, so a scan
+    that finds a block that was read ahead is still sequential
+  */
+  sequential= (found || block_number == prefetch->last_block[datafile] + 1);
+  prefetch->last_block[datafile]= block_number;
+
+  if (sequential && !prefetch->threads_started)
+  {
+    uint count= (uint) MY_MIN(s3_prefetch_blocks, S3_MAX_PREFETCH_BLOCKS);
+    prefetch->threads_started= 1;
+    for (; prefetch->thread_count < count; prefetch->thread_count++)
+      if (mysql_thread_create(0,
+                              &prefetch->threads[prefetch->thread_count],
+                              NULL, s3_prefetch_thread, prefetch))
+        break;
+  }
+
+  if (sequential && prefetch->thread_count)
+  {
+    length= (datafile ? share->state.state.data_file_length :
+             share->state.state.key_file_length);
+    head= (my_off_t) file->head_blocks << pagecache->shift;
+    last_block= (length <= head ? 0 :
+                 (ulong) ((length - head + file->big_block_size - 1) /
+                          file->big_block_size));
+    depth= MY_MIN(s3_prefetch_blocks, prefetch->thread_count);
+
+    for (next= block_number + 1;
+         next <= block_number + depth && next <= last_block;
+         next++)
+    {
+      S3_PREFETCH_SLOT *free_slot= 0;
+      for (slot= prefetch->slots; slot < end; slot++)
+      {
+        if (slot->state == S3_PREFETCH_FREE)
+        {
+          if (!free_slot)
+            free_slot= slot;
+        }
+        else if (slot->datafile == datafile && slot->block_number == next)
+          break;
+      }
+      if (slot != end)
+        continue;                               /* Already queued */
+      if (!free_slot)
+        break;
+      free_slot->datafile= datafile;
+      free_slot->block_number= next;
+      free_slot->error= 0;
+      s3_block_path(free_slot->aws_path, share->s3_path, datafile, next);
+      free_slot->state= S3_PREFETCH_QUEUED;
+    }
+    mysql_cond_broadcast(&prefetch->cond);
+  }
+
+  if (found)
+  {
+    /* The block may still be waiting for a thread if others are slow */
+    if (found->state == S3_PREFETCH_QUEUED)
+      found->state= S3_PREFETCH_FREE;
+    else
+    {
+      while (found->state != S3_PREFETCH_DONE)
+        mysql_cond_wait(&prefetch->cond, &prefetch->lock);
+      if (found->error)
+        found->state= S3_PREFETCH_FREE;
+      else
+      {
+        /* Only this thread queues blocks, so aws_path stays valid */
+        *block= found->block;
+        found->state= S3_PREFETCH_FREE;
+        mysql_mutex_unlock(&prefetch->lock);
+        *error= (share->base.compression_algorithm ?
+                 s3_uncompress_block(block, found->aws_path) : 0);
+        DBUG_RETURN(1);
+      }
+    }
+  }
+  mysql_mutex_unlock(&prefetch->lock);
+  DBUG_RETURN(0);
+}
+
+
 /**
    Read a block from S3 to page cache
 */
@@ -1589,11 +2313,8 @@ my_bool s3_block_read(struct st_pagecache *pagecache,
   MARIA_SHARE *share= (MARIA_SHARE*) file->callback_data;
   my_bool datafile= file->file != share->kfile.file;
   MARIA_HA *info= (MARIA_HA*) my_thread_var->keycache_file;
-  ms3_st *client= info->s3;
-  const char *path_suffix= datafile ? "/data/" : "/index/";
-  char *end;
-  S3_INFO *s3= share->s3_path;
   ulong block_number;
+  int error;
   DBUG_ENTER("s3_block_read");
 
   DBUG_ASSERT(file->big_block_size > 0);
@@ -1604,12 +2325,17 @@ my_bool s3_block_read(struct st_pagecache *pagecache,
   block_number= (((args->pageno - file->head_blocks) << pagecache->shift) /
                  file->big_block_size) + 1;
 
-  end= strxnmov(aws_path, sizeof(aws_path)-12, s3->database.str, "/",
-                s3->table.str, path_suffix, "000000", NullS);
-  fix_suffix(end, block_number);
+  if ((s3_prefetch_blocks || info->s3_prefetch) &&
+      s3_prefetch_read(pagecache, file, info, datafile, block_number, block,
+                       &error))
+    DBUG_RETURN(MY_TEST(error));
+
+  s3_block_path(aws_path, share->s3_path, datafile, block_number);
 
-  DBUG_RETURN(s3_get_object(client, s3->bucket.str, aws_path, block,
-                            share->base.compression_algorithm, 1));
+  if (!(error= s3_get_block(info->s3, share, aws_path, block, 1)) &&
+      share->base.compression_algorithm)
+    error= s3_uncompress_block(block, aws_path);
+  DBUG_RETURN(MY_TEST(error));
 }
 
 /*
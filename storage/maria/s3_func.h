@@ -35,6 +35,7 @@ extern struct s3_func {
   S3_INFO *(*info_copy)(S3_INFO *);
   my_bool (*set_database_and_table_from_path)(S3_INFO *, const char *);
   ms3_st *(*open_connection)(S3_INFO *);
+  void (*prefetch_end)(struct st_maria_handler *);
 } s3f;
 
 extern TYPELIB s3_protocol_typelib;
@@ -72,6 +73,13 @@ typedef struct s3_info
 /* Max length of an AWS PATH */
 #define AWS_PATH_LENGTH ((NAME_LEN)*3+3+10+6+11)
 
+/* Max value of s3_prefetch_blocks */
+#define S3_MAX_PREFETCH_BLOCKS 32
+
+typedef struct s3_prefetch S3_PREFETCH;
+extern ulong s3_prefetch_blocks;
+extern ulonglong s3_disk_cache_hits, s3_disk_cache_misses;
+
 void s3_init_library(void);
 void s3_deinit_library(void);
 int aria_copy_to_s3(ms3_st *s3_client, const char *aws_bucket,
@@ -135,6 +143,9 @@ my_bool s3_block_read(struct st_pagecache *pagecache,
                       PAGECACHE_IO_HOOK_ARGS *args,
                       struct st_pagecache_file *file,
                       S3_BLOCK *block);
+void s3_prefetch_end(struct st_maria_handler *info);
+my_bool s3_disk_cache_init(const char *dir, ulonglong max_size);
+void s3_disk_cache_end(void);
 C_MODE_END
 #else
 
@@ -5430,6 +5430,7 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
    Capture statement stats by digest.
   */
   const sql_digest_storage *digest_storage= NULL;
+  PFS_statements_digest_stat *digest= NULL;
   PFS_statement_stat *digest_stat= NULL;
   PFS_program *pfs_program= NULL;
   PFS_prepared_stmt *pfs_prepared_stmt= NULL;
@@ -5449,9 +5450,9 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
       if (digest_storage != NULL)
       {
         /* Populate PFS_statements_digest_stat with computed digest information.*/
-        digest_stat= find_or_create_digest(thread, digest_storage,
-                                           state->m_schema_name,
-                                           state->m_schema_name_length);
+        digest= find_or_create_digest(thread, digest_storage,
+                                      state->m_schema_name,
+                                      state->m_schema_name_length);
       }
     }
 
@@ -5533,9 +5534,9 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
         if (digest_storage != NULL)
         {
           /* Populate statements_digest_stat with computed digest information. */
-          digest_stat= find_or_create_digest(thread, digest_storage,
-                                             state->m_schema_name,
-                                             state->m_schema_name_length);
+          digest= find_or_create_digest(thread, digest_storage,
+                                        state->m_schema_name,
+                                        state->m_schema_name_length);
         }
       }
     }
@@ -5575,13 +5576,17 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
   stat->m_no_index_used+= state->m_no_index_used;
   stat->m_no_good_index_used+= state->m_no_good_index_used;
 
-  if (digest_stat != NULL)
+  if (digest != NULL)
   {
+    digest_stat= & digest->m_stat;
     digest_stat->mark_used();
 
     if (flags & STATE_FLAG_TIMED)
     {
       digest_stat->aggregate_value(wait_time);
+      /* Aggregate to EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST */
+      digest->m_histogram.aggregate_value(
+        time_normalizer::get(statement_timer)->wait_to_pico(wait_time));
     }
     else
     {
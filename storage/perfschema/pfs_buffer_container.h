@@ -109,7 +109,12 @@ class PFS_buffer_default_array
   void deallocate(value_type *pfs)
   {
     pfs->m_lock.allocated_to_free();
-    m_full= false;
+    /*
+      Only write the flag when it changes, to keep the cache line
+      shared between CPUs on the (common) not full path.
+    */
+    if (m_full)
+      m_full= false;
   }
 
   T* get_first()
@@ -720,10 +725,12 @@ class PFS_buffer_scalable_container
     safe_pfs->m_lock.allocated_to_free();
 
     /* Flag the containing page as not full. */
-    page->m_full= false;
+    if (page->m_full)
+      page->m_full= false;
 
     /* Flag the overall container as not full. */
-    m_full= false;
+    if (m_full)
+      m_full= false;
   }
 
   static void static_deallocate(value_type *safe_pfs)
@@ -736,7 +743,8 @@ class PFS_buffer_scalable_container
     safe_pfs->m_lock.allocated_to_free();
 
     /* Flag the containing page as not full. */
-    page->m_full= false;
+    if (page->m_full)
+      page->m_full= false;
 
     /* Find the containing buffer */
     PFS_opaque_container *opaque_container= page->m_container;
@@ -744,7 +752,8 @@ class PFS_buffer_scalable_container
     container= reinterpret_cast<container_type *> (opaque_container);
 
     /* Flag the overall container as not full. */
-    container->m_full= false;
+    if (container->m_full)
+      container->m_full= false;
   }
 
   iterator_type iterate()
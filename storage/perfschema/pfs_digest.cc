@@ -33,6 +33,7 @@
 
 #include "my_global.h"
 #include "my_sys.h"
+#include "my_bit.h"
 #include "pfs_instr.h"
 #include "pfs_digest.h"
 #include "pfs_global.h"
@@ -198,7 +199,7 @@ static LF_PINS* get_digest_hash_pins(PFS_thread *thread)
   return thread->m_digest_hash_pins;
 }
 
-PFS_statement_stat*
+PFS_statements_digest_stat*
 find_or_create_digest(PFS_thread *thread,
                       const sql_digest_storage *digest_storage,
                       const char *schema_name,
@@ -255,7 +256,7 @@ find_or_create_digest(PFS_thread *thread,
     pfs= *entry;
     pfs->m_last_seen= now;
     lf_hash_search_unpin(pins);
-    return & pfs->m_stat;
+    return pfs;
   }
 
   lf_hash_search_unpin(pins);
@@ -269,7 +270,7 @@ find_or_create_digest(PFS_thread *thread,
     if (pfs->m_first_seen == 0)
       pfs->m_first_seen= now;
     pfs->m_last_seen= now;
-    return & pfs->m_stat;
+    return pfs;
   }
 
   while (++attempts <= digest_max)
@@ -305,7 +306,7 @@ find_or_create_digest(PFS_thread *thread,
         if (likely(res == 0))
         {
           pfs->m_lock.dirty_to_allocated(& dirty_state);
-          return & pfs->m_stat;
+          return pfs;
         }
 
         pfs->m_lock.dirty_to_free(& dirty_state);
@@ -336,7 +337,7 @@ find_or_create_digest(PFS_thread *thread,
   if (pfs->m_first_seen == 0)
     pfs->m_first_seen= now;
   pfs->m_last_seen= now;
-  return & pfs->m_stat;
+  return pfs;
 }
 
 void purge_digest(PFS_thread* thread, PFS_digest_key *hash_key)
@@ -367,11 +368,35 @@ void PFS_statements_digest_stat::reset_data(unsigned char *token_array, size_t l
   m_lock.set_dirty(& dirty_state);
   m_digest_storage.reset(token_array, length);
   m_stat.reset();
+  m_histogram.reset();
   m_first_seen= 0;
   m_last_seen= 0;
   m_lock.dirty_to_free(& dirty_state);
 }
 
+ulonglong PFS_statements_digest_stat::get_quantile(double quantile)
+{
+  ulonglong count[NUMBER_OF_BUCKETS];
+  ulonglong total= 0;
+  uint index;
+
+  for (index= 0; index < NUMBER_OF_BUCKETS; index++)
+    total+= count[index]= m_histogram.read_bucket(index);
+
+  if (total == 0)
+    return 0;
+
+  ulonglong limit= (ulonglong) ceil(quantile * (double) total);
+  ulonglong sum= 0;
+  for (index= 0; index < NUMBER_OF_BUCKETS - 1; index++)
+  {
+    sum+= count[index];
+    if (sum >= limit)
+      break;
+  }
+  return PFS_histogram::bucket_timer_high(index);
+}
+
 void PFS_statements_digest_stat::reset_index(PFS_thread *thread)
 {
   /* Only remove entries that exists in the HASH index. */
@@ -381,6 +406,28 @@ void PFS_statements_digest_stat::reset_index(PFS_thread *thread)
   }
 }
 
+/** One microsecond, in pico seconds. */
+static const ulonglong histogram_base= 1000000ULL;
+
+uint PFS_histogram::bucket_index(ulonglong pico)
+{
+  ulonglong micro= pico / histogram_base;
+  if (micro == 0)
+    return 0;
+  uint index= my_bit_log2_uint64(micro) + 1;
+  return MY_MIN(index, NUMBER_OF_BUCKETS - 1);
+}
+
+ulonglong PFS_histogram::bucket_timer_low(uint index)
+{
+  return index == 0 ? 0 : histogram_base << (index - 1);
+}
+
+ulonglong PFS_histogram::bucket_timer_high(uint index)
+{
+  return histogram_base << index;
+}
+
 void reset_esms_by_digest()
 {
   uint index;
@@ -410,3 +457,14 @@ void reset_esms_by_digest()
   digest_full= false;
 }
 
+void reset_histogram_by_digest()
+{
+  uint index;
+
+  if (statements_digest_stat_array == NULL)
+    return;
+
+  for (index= 0; index < digest_max; index++)
+    statements_digest_stat_array[index].m_histogram.reset();
+}
+
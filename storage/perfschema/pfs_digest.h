@@ -31,6 +31,7 @@
 #include "pfs_column_types.h"
 #include "lf.h"
 #include "pfs_stat.h"
+#include "pfs_atomic.h"
 #include "sql_digest.h"
 
 extern bool flag_statements_digest;
@@ -48,6 +49,44 @@ struct PFS_digest_key
   uint m_schema_name_length;
 };
 
+/** Number of buckets of a statement latency histogram. */
+#define NUMBER_OF_BUCKETS 40
+
+/**
+  Statement latency histogram.
+  Bucket 0 counts the statements that took less than 1 microsecond,
+  bucket i counts the statements that took between 2^(i-1) and 2^i
+  microseconds. The last bucket also counts all longer statements.
+  Buckets are incremented with atomic operations, without any lock.
+*/
+struct PFS_histogram
+{
+  uint64 m_bucket[NUMBER_OF_BUCKETS];
+
+  void reset()
+  {
+    for (uint i= 0; i < NUMBER_OF_BUCKETS; i++)
+      m_bucket[i]= 0;
+  }
+
+  void aggregate_value(ulonglong pico)
+  {
+    PFS_atomic::add_u64(& m_bucket[bucket_index(pico)], 1);
+  }
+
+  ulonglong read_bucket(uint index)
+  {
+    return PFS_atomic::load_u64(& m_bucket[index]);
+  }
+
+  /** Bucket of a latency, in pico seconds. */
+  static uint bucket_index(ulonglong pico);
+  /** Lower bound of a bucket, in pico seconds. */
+  static ulonglong bucket_timer_low(uint index);
+  /** Upper bound of a bucket, in pico seconds. */
+  static ulonglong bucket_timer_high(uint index);
+};
+
 /** A statement digest stat record. */
 struct PFS_ALIGNED PFS_statements_digest_stat
 {
@@ -63,6 +102,17 @@ struct PFS_ALIGNED PFS_statements_digest_stat
   /** Statement stat. */
   PFS_statement_stat m_stat;
 
+  /** Statement latency histogram. */
+  PFS_histogram m_histogram;
+
+  /**
+    Latency of the statements at a given quantile, in pico seconds.
+    This is the upper bound of the first histogram bucket that,
+    with all lower buckets, counts at least @c quantile of the statements.
+    @param quantile the quantile, between 0 and 1
+  */
+  ulonglong get_quantile(double quantile);
+
   /** First and last seen timestamps.*/
   ulonglong m_first_seen;
   ulonglong m_last_seen;
@@ -78,12 +128,13 @@ void cleanup_digest();
 
 int init_digest_hash(const PFS_global_param *param);
 void cleanup_digest_hash(void);
-PFS_statement_stat* find_or_create_digest(PFS_thread *thread,
-                                          const sql_digest_storage *digest_storage,
-                                          const char *schema_name,
-                                          uint schema_name_length);
+PFS_statements_digest_stat* find_or_create_digest(PFS_thread *thread,
+                                                  const sql_digest_storage *digest_storage,
+                                                  const char *schema_name,
+                                                  uint schema_name_length);
 
 void reset_esms_by_digest();
+void reset_histogram_by_digest();
 
 /* Exposing the data directly, for iterators. */
 extern PFS_statements_digest_stat *statements_digest_stat_array;
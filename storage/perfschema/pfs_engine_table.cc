@@ -70,6 +70,7 @@
 #include "table_esms_by_account_by_event_name.h"
 #include "table_esms_global_by_event_name.h"
 #include "table_esms_by_digest.h"
+#include "table_esms_histogram_by_digest.h"
 #include "table_esms_by_program.h"
 
 #include "table_events_transactions.h"
@@ -280,6 +281,7 @@ static PFS_engine_table_share *all_shares[]=
   &table_esms_by_host_by_event_name::m_share,
   &table_esms_global_by_event_name::m_share,
   &table_esms_by_digest::m_share,
+  &table_esms_histogram_by_digest::m_share,
   &table_esms_by_program::m_share,
 
   &table_events_transactions_current::m_share,
@@ -81,7 +81,10 @@ table_esms_by_digest::m_share=
                       "SUM_NO_INDEX_USED BIGINT unsigned not null,"
                       "SUM_NO_GOOD_INDEX_USED BIGINT unsigned not null,"
                       "FIRST_SEEN TIMESTAMP(0) NOT NULL default 0,"
-                      "LAST_SEEN TIMESTAMP(0) NOT NULL default 0)") },
+                      "LAST_SEEN TIMESTAMP(0) NOT NULL default 0,"
+                      "QUANTILE_50 BIGINT unsigned not null,"
+                      "QUANTILE_95 BIGINT unsigned not null,"
+                      "QUANTILE_99 BIGINT unsigned not null)") },
   false  /* perpetual */
 };
 
@@ -178,6 +181,13 @@ void table_esms_by_digest::make_row(PFS_statements_digest_stat* digest_stat)
   time_normalizer *normalizer= time_normalizer::get(statement_timer);
   m_row.m_stat.set(normalizer, & digest_stat->m_stat);
 
+  /*
+    Get latency quantiles, from the histogram.
+  */
+  m_row.m_p50= digest_stat->get_quantile(0.50);
+  m_row.m_p95= digest_stat->get_quantile(0.95);
+  m_row.m_p99= digest_stat->get_quantile(0.99);
+
   m_row_exists= true;
 }
 
@@ -214,6 +224,15 @@ ::read_row_values(TABLE *table, unsigned char *buf, Field **fields,
       case 28: /* LAST_SEEN */
         set_field_timestamp(f, m_row.m_last_seen);
         break;
+      case 29: /* QUANTILE_50 */
+        set_field_ulonglong(f, m_row.m_p50);
+        break;
+      case 30: /* QUANTILE_95 */
+        set_field_ulonglong(f, m_row.m_p95);
+        break;
+      case 31: /* QUANTILE_99 */
+        set_field_ulonglong(f, m_row.m_p99);
+        break;
       default: /* 3, ... COUNT/SUM/MIN/AVG/MAX */
         m_row.m_stat.set_field(f->field_index - 3, f);
         break;
@@ -52,6 +52,13 @@ struct row_esms_by_digest
   ulonglong m_first_seen;
   /** Column LAST_SEEN. */
   ulonglong m_last_seen;
+
+  /** Column QUANTILE_50. */
+  ulonglong m_p50;
+  /** Column QUANTILE_95. */
+  ulonglong m_p95;
+  /** Column QUANTILE_99. */
+  ulonglong m_p99;
 };
 
 /** Table PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_SUMMARY_BY_DIGEST. */
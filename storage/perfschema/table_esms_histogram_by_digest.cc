@@ -0,0 +1,219 @@
+/* Copyright (c) 2025, MariaDB Corporation.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License, version 2.0, for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/**
+  @file storage/perfschema/table_esms_histogram_by_digest.cc
+  Table EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST (implementation).
+*/
+
+#include "my_global.h"
+#include "my_thread.h"
+#include "pfs_column_types.h"
+#include "pfs_column_values.h"
+#include "table_esms_histogram_by_digest.h"
+#include "pfs_global.h"
+#include "pfs_digest.h"
+#include "field.h"
+
+THR_LOCK table_esms_histogram_by_digest::m_table_lock;
+
+PFS_engine_table_share
+table_esms_histogram_by_digest::m_share=
+{
+  { C_STRING_WITH_LEN("events_statements_histogram_by_digest") },
+  &pfs_truncatable_acl,
+  table_esms_histogram_by_digest::create,
+  NULL, /* write_row */
+  table_esms_histogram_by_digest::delete_all_rows,
+  table_esms_histogram_by_digest::get_row_count,
+  sizeof(pos_esms_histogram_by_digest),
+  &m_table_lock,
+  { C_STRING_WITH_LEN("CREATE TABLE events_statements_histogram_by_digest("
+                      "SCHEMA_NAME VARCHAR(64),"
+                      "DIGEST VARCHAR(32),"
+                      "BUCKET_NUMBER INTEGER unsigned not null,"
+                      "BUCKET_TIMER_LOW BIGINT unsigned not null,"
+                      "BUCKET_TIMER_HIGH BIGINT unsigned not null,"
+                      "COUNT_BUCKET BIGINT unsigned not null,"
+                      "COUNT_BUCKET_AND_LOWER BIGINT unsigned not null,"
+                      "BUCKET_QUANTILE DOUBLE(7,6) not null)") },
+  false  /* perpetual */
+};
+
+PFS_engine_table*
+table_esms_histogram_by_digest::create(void)
+{
+  return new table_esms_histogram_by_digest();
+}
+
+int
+table_esms_histogram_by_digest::delete_all_rows(void)
+{
+  reset_histogram_by_digest();
+  return 0;
+}
+
+ha_rows
+table_esms_histogram_by_digest::get_row_count(void)
+{
+  return digest_max * NUMBER_OF_BUCKETS;
+}
+
+table_esms_histogram_by_digest::table_esms_histogram_by_digest()
+  : PFS_engine_table(&m_share, &m_pos),
+    m_row_exists(false), m_pos(), m_next_pos()
+{}
+
+void table_esms_histogram_by_digest::reset_position(void)
+{
+  m_pos.reset();
+  m_next_pos.reset();
+}
+
+int table_esms_histogram_by_digest::rnd_next(void)
+{
+  PFS_statements_digest_stat* digest_stat;
+
+  if (statements_digest_stat_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  for (m_pos.set_at(&m_next_pos);
+       m_pos.has_more_digest();
+       m_pos.next_digest())
+  {
+    digest_stat= &statements_digest_stat_array[m_pos.m_index_1];
+    if (digest_stat->m_lock.is_populated())
+    {
+      if (digest_stat->m_first_seen != 0 &&
+          m_pos.m_index_2 < NUMBER_OF_BUCKETS)
+      {
+        make_row(digest_stat, m_pos.m_index_2);
+        m_next_pos.set_after(&m_pos);
+        return 0;
+      }
+    }
+  }
+
+  return HA_ERR_END_OF_FILE;
+}
+
+int
+table_esms_histogram_by_digest::rnd_pos(const void *pos)
+{
+  PFS_statements_digest_stat* digest_stat;
+
+  if (statements_digest_stat_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  set_position(pos);
+  digest_stat= &statements_digest_stat_array[m_pos.m_index_1];
+
+  if (digest_stat->m_lock.is_populated())
+  {
+    if (digest_stat->m_first_seen != 0)
+    {
+      make_row(digest_stat, m_pos.m_index_2);
+      return 0;
+    }
+  }
+
+  return HA_ERR_RECORD_DELETED;
+}
+
+void table_esms_histogram_by_digest
+::make_row(PFS_statements_digest_stat* digest_stat, uint bucket)
+{
+  ulonglong count_and_lower= 0;
+  ulonglong total= 0;
+  ulonglong count;
+  uint index;
+
+  m_row_exists= false;
+  m_row.m_digest.make_row(digest_stat);
+
+  for (index= 0; index < NUMBER_OF_BUCKETS; index++)
+  {
+    count= digest_stat->m_histogram.read_bucket(index);
+    total+= count;
+    if (index < bucket)
+      count_and_lower+= count;
+    else if (index == bucket)
+    {
+      count_and_lower+= count;
+      m_row.m_count_bucket= count;
+    }
+  }
+
+  m_row.m_bucket_number= bucket;
+  m_row.m_bucket_timer_low= PFS_histogram::bucket_timer_low(bucket);
+  m_row.m_bucket_timer_high= PFS_histogram::bucket_timer_high(bucket);
+  m_row.m_count_bucket_and_lower= count_and_lower;
+  m_row.m_bucket_quantile= total ? (double) count_and_lower / total : 0.0;
+
+  m_row_exists= true;
+}
+
+int table_esms_histogram_by_digest
+::read_row_values(TABLE *table, unsigned char *buf, Field **fields,
+                  bool read_all)
+{
+  Field *f;
+
+  if (unlikely(! m_row_exists))
+    return HA_ERR_RECORD_DELETED;
+
+  /*
+    Set the null bits. It indicates how many fields could be null
+    in the table.
+  */
+  DBUG_ASSERT(table->s->null_bytes == 1);
+  buf[0]= 0;
+
+  for (; (f= *fields) ; fields++)
+  {
+    if (read_all || bitmap_is_set(table->read_set, f->field_index))
+    {
+      switch(f->field_index)
+      {
+      case 0: /* SCHEMA_NAME */
+      case 1: /* DIGEST */
+        m_row.m_digest.set_field(f->field_index, f);
+        break;
+      case 2: /* BUCKET_NUMBER */
+        set_field_ulong(f, m_row.m_bucket_number);
+        break;
+      case 3: /* BUCKET_TIMER_LOW */
+        set_field_ulonglong(f, m_row.m_bucket_timer_low);
+        break;
+      case 4: /* BUCKET_TIMER_HIGH */
+        set_field_ulonglong(f, m_row.m_bucket_timer_high);
+        break;
+      case 5: /* COUNT_BUCKET */
+        set_field_ulonglong(f, m_row.m_count_bucket);
+        break;
+      case 6: /* COUNT_BUCKET_AND_LOWER */
+        set_field_ulonglong(f, m_row.m_count_bucket_and_lower);
+        break;
+      case 7: /* BUCKET_QUANTILE */
+        set_field_double(f, m_row.m_bucket_quantile);
+        break;
+      default:
+        DBUG_ASSERT(false);
+      }
+    }
+  }
+
+  return 0;
+}
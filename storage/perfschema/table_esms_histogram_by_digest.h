@@ -0,0 +1,128 @@
+/* Copyright (c) 2025, MariaDB Corporation.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License, version 2.0, for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#ifndef TABLE_ESMS_HISTOGRAM_BY_DIGEST_H
+#define TABLE_ESMS_HISTOGRAM_BY_DIGEST_H
+
+/**
+  @file storage/perfschema/table_esms_histogram_by_digest.h
+  Table EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST (declarations).
+*/
+
+#include "table_helper.h"
+#include "pfs_digest.h"
+
+/**
+  @addtogroup Performance_schema_tables
+  @{
+*/
+
+/**
+  A row of table
+  PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST.
+*/
+struct row_esms_histogram_by_digest
+{
+  /** Columns SCHEMA_NAME, DIGEST. */
+  PFS_digest_row m_digest;
+
+  /** Column BUCKET_NUMBER. */
+  ulong m_bucket_number;
+  /** Column BUCKET_TIMER_LOW. */
+  ulonglong m_bucket_timer_low;
+  /** Column BUCKET_TIMER_HIGH. */
+  ulonglong m_bucket_timer_high;
+  /** Column COUNT_BUCKET. */
+  ulonglong m_count_bucket;
+  /** Column COUNT_BUCKET_AND_LOWER. */
+  ulonglong m_count_bucket_and_lower;
+  /** Column BUCKET_QUANTILE. */
+  double m_bucket_quantile;
+};
+
+/**
+  Position of a cursor on
+  PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST.
+  Index 1 on digest (0 based),
+  index 2 on bucket (0 based).
+*/
+struct pos_esms_histogram_by_digest
+: public PFS_double_index
+{
+  pos_esms_histogram_by_digest()
+    : PFS_double_index(0, 0)
+  {}
+
+  inline void reset(void)
+  {
+    m_index_1= 0;
+    m_index_2= 0;
+  }
+
+  inline bool has_more_digest(void)
+  { return (m_index_1 < digest_max); }
+
+  inline void next_digest(void)
+  {
+    m_index_1++;
+    m_index_2= 0;
+  }
+};
+
+/** Table PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST. */
+class table_esms_histogram_by_digest : public PFS_engine_table
+{
+public:
+  /** Table share */
+  static PFS_engine_table_share m_share;
+  static PFS_engine_table* create();
+  static int delete_all_rows();
+  static ha_rows get_row_count();
+
+  virtual int rnd_next();
+  virtual int rnd_pos(const void *pos);
+  virtual void reset_position(void);
+
+protected:
+  virtual int read_row_values(TABLE *table,
+                              unsigned char *buf,
+                              Field **fields,
+                              bool read_all);
+
+  table_esms_histogram_by_digest();
+
+public:
+  ~table_esms_histogram_by_digest()
+  {}
+
+protected:
+  void make_row(PFS_statements_digest_stat *digest_stat, uint bucket);
+
+private:
+  /** Table share lock. */
+  static THR_LOCK m_table_lock;
+
+  /** Current row. */
+  row_esms_histogram_by_digest m_row;
+  /** True is the current row exists. */
+  bool m_row_exists;
+  /** Current position. */
+  pos_esms_histogram_by_digest m_pos;
+  /** Next position. */
+  pos_esms_histogram_by_digest m_next_pos;
+};
+
+/** @} */
+#endif
@@ -31747,6 +31747,28 @@ my_space_weight(const MY_UCA_WEIGHT_LEVEL *level)
 }
 
 
+/*
+  Return the length of the longest common prefix of two strings
+  that consists of ASCII bytes only, comparing 8 bytes at a time.
+  In an ASCII compatible character set, such a prefix ends on a
+  character boundary in both strings.
+*/
+static inline size_t
+my_uca_ascii_common_prefix(const uchar *s, const uchar *t, size_t length)
+{
+  const uchar *s0= s, *se= s + length;
+  for ( ; se - s >= 8; s+= 8, t+= 8)
+  {
+    ulonglong a= uint8korr(s);
+    if ((a ^ uint8korr(t)) | (a & 0x8080808080808080ULL))
+      break;
+  }
+  for ( ; s < se && *s == *t && *s < 0x80; s++, t++)
+  { }
+  return s - s0;
+}
+
+
 /**
   Helper function:
   Find address of weights of the given character.
@@ -366,11 +366,39 @@ int json_read_string_const_chr(json_string_t *js)
 }
 
 
+/*
+  Check 8 bytes at a time for anything but the ASCII characters that
+  need no attention inside a string constant: quotes, backslashes,
+  control characters and non-ASCII bytes. Returns the position of the
+  first 8-byte word that has any of them.
+*/
+
+#define JSON_BYTES(n) (0x0101010101010101ULL * (n))
+#define JSON_HAS_LESS(v, n) (((v) - JSON_BYTES(n)) & ~(v) & JSON_BYTES(0x80))
+
+static const uchar *skip_plain_ascii(const uchar *str, const uchar *end)
+{
+  for (; end - str >= 8; str+= 8)
+  {
+    ulonglong v= uint8korr(str);
+    if ((v & JSON_BYTES(0x80)) || JSON_HAS_LESS(v, 0x20) ||
+        JSON_HAS_LESS(v ^ JSON_BYTES('"'), 1) ||
+        JSON_HAS_LESS(v ^ JSON_BYTES('\\'), 1))
+      break;
+  }
+  return str;
+}
+
+
 static int skip_str_constant(json_engine_t *j)
 {
   int t, c_len;
+  /* In an ASCII based character set, ASCII bytes are single characters */
+  my_bool ascii_based= my_charset_is_ascii_based(j->s.cs);
   for (;;)
   {
+    if (ascii_based && j->s.c_next < 128)
+      j->s.c_str= skip_plain_ascii(j->s.c_str, j->s.str_end);
     if ((c_len= json_next_char(&j->s)) > 0)
     {
       j->s.c_str+= c_len;
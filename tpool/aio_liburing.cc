@@ -0,0 +1,384 @@
+/* Copyright (C) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute itand /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111 - 1301 USA*/
+
+#include "tpool_structs.h"
+#include "tpool.h"
+
+#ifdef HAVE_URING
+# include <liburing.h>
+# include <sys/resource.h>
+# include <algorithm>
+# include <thread>
+# include <vector>
+# include <cerrno>
+# include <cstdio>
+# include <cstdlib>
+#endif
+
+/*
+  Linux AIO implementation, based on io_uring.
+  Needs liburing.h and -luring at the compile time.
+
+  Requests are placed to the submission queue and submitted
+  with io_uring_submit() by the thread that initiates the IO.
+
+  A single thread will collect the completion notifications
+  in batches and forward io completion callback to the worker
+  threadpool, just like the libaio based implementation does.
+
+  File descriptors that are passed to bind() are registered with
+  the ring, and memory regions that are passed to register_buffer()
+  (the buffer pool) are registered as fixed buffers, so that the kernel
+  does not have to look up the file and pin the user pages for every
+  single request.
+*/
+namespace tpool
+{
+#ifdef HAVE_URING
+
+class aio_uring final : public aio
+{
+  /** Maximum length of a registered buffer (imposed by the kernel) */
+  static constexpr size_t MAX_FIXED_BUFFER_LEN= size_t{1} << 30;
+  /** Maximum number of slots in the registered file table */
+  static constexpr unsigned MAX_FIXED_FILES= 4096;
+  /** Number of slots in the registered buffer table */
+  static constexpr unsigned N_FIXED_BUFFERS= 1024;
+  /** Maximum number of completion events to collect at a time */
+  static constexpr unsigned MAX_EVENTS= 256;
+
+  /** A registered buffer */
+  struct fixed_buffer
+  {
+    /** start of the buffer */
+    const char *start;
+    /** length of the buffer, in bytes */
+    size_t len;
+    /** the region that was passed to register_buffer() */
+    const void *region;
+    /** index in the registered buffer table */
+    unsigned index;
+  };
+
+  thread_pool *m_pool;
+  io_uring m_ring;
+  /** Protects the submission queue and the registration tables */
+  std::mutex m_mutex;
+  /** Registered file table slot of each file descriptor, or -1 */
+  std::vector<int> m_fixed_file;
+  /** Unused slots of the registered file table */
+  std::vector<int> m_free_files;
+  /** Registered buffers, ordered by start */
+  std::vector<fixed_buffer> m_fixed_buffers;
+  /** Unused slots of the registered buffer table */
+  std::vector<unsigned> m_free_buffers;
+  std::thread m_getevent_thread;
+
+  static void getevent_thread_routine(aio_uring *aio)
+  {
+    io_uring_cqe *cqes[MAX_EVENTS];
+    for (;;)
+    {
+      io_uring_cqe *cqe;
+      if (int ret= io_uring_wait_cqe(&aio->m_ring, &cqe))
+      {
+        if (ret == -EINTR)
+          continue;
+        fprintf(stderr, "io_uring_wait_cqe() returned %d\n", ret);
+        abort();
+      }
+
+      bool shutdown= false;
+      const unsigned n= io_uring_peek_batch_cqe(&aio->m_ring, cqes,
+                                                MAX_EVENTS);
+      for (unsigned i= 0; i < n; i++)
+      {
+        aiocb *iocb= static_cast<aiocb*>(io_uring_cqe_get_data(cqes[i]));
+        if (!iocb)
+        {
+          /* ~aio_uring() told us to terminate */
+          shutdown= true;
+          continue;
+        }
+        const int res= cqes[i]->res;
+        if (res < 0)
+        {
+          iocb->m_err= -res;
+          iocb->m_ret_len= 0;
+        }
+        else
+        {
+          iocb->m_ret_len= res;
+          iocb->m_err= 0;
+        }
+        iocb->m_internal_task.m_func= iocb->m_callback;
+        iocb->m_internal_task.m_arg= iocb;
+        iocb->m_internal_task.m_group= iocb->m_group;
+        if (iocb->m_opcode == aio_opcode::AIO_PREAD)
+          aio->m_pool->submit_urgent_task(&iocb->m_internal_task);
+        else
+          aio->m_pool->submit_task(&iocb->m_internal_task);
+      }
+      io_uring_cq_advance(&aio->m_ring, n);
+
+      if (shutdown)
+        return;
+    }
+  }
+
+  /** Look up a registered buffer.
+  @param buf  start of the I/O buffer
+  @param len  length of the I/O buffer
+  @return the registered buffer that contains [buf,buf+len)
+  @retval nullptr if there is no such buffer */
+  const fixed_buffer *find_fixed_buffer(const void *buf, size_t len) const
+  {
+    const char *b= static_cast<const char*>(buf);
+    auto it= std::upper_bound(m_fixed_buffers.begin(), m_fixed_buffers.end(),
+                              b, [](const char *p, const fixed_buffer &f)
+                              { return p < f.start; });
+    if (it == m_fixed_buffers.begin())
+      return nullptr;
+    --it;
+    return b + len <= it->start + it->len ? &*it : nullptr;
+  }
+
+  /** Register the sparse file and buffer tables */
+  void register_tables()
+  {
+    rlimit rl;
+    unsigned n_files= MAX_FIXED_FILES;
+    if (!getrlimit(RLIMIT_NOFILE, &rl) && rl.rlim_cur < n_files)
+      n_files= unsigned(rl.rlim_cur);
+
+    std::vector<int> files(n_files, -1);
+    if (n_files && !io_uring_register_files(&m_ring, files.data(), n_files))
+      for (int i= int(n_files); i--; )
+        m_free_files.push_back(i);
+
+#ifdef HAVE_URING_BUFFERS_UPDATE
+    if (!io_uring_register_buffers_sparse(&m_ring, N_FIXED_BUFFERS))
+      for (unsigned i= N_FIXED_BUFFERS; i--; )
+        m_free_buffers.push_back(i);
+#endif
+  }
+
+public:
+  aio_uring(thread_pool *pool) : m_pool(pool) {}
+
+  /** Create the ring and start the completion thread.
+  @param max_io  maximum number of concurrent requests
+  @return 0 on success, or negated errno */
+  int init(int max_io)
+  {
+    if (int ret= io_uring_queue_init(std::min(max_io, 32768), &m_ring, 0))
+      return ret;
+
+    /* IORING_OP_READ and IORING_OP_WRITE are available since Linux 5.6 */
+    io_uring_probe *probe= io_uring_get_probe_ring(&m_ring);
+    const bool supported= probe &&
+      io_uring_opcode_supported(probe, IORING_OP_READ) &&
+      io_uring_opcode_supported(probe, IORING_OP_WRITE);
+    if (probe)
+      io_uring_free_probe(probe);
+    if (!supported)
+    {
+      io_uring_queue_exit(&m_ring);
+      return -ENOSYS;
+    }
+
+    /* Do not let a fork()ed child process inherit the ring mappings */
+    if (int ret= io_uring_ring_dontfork(&m_ring))
+    {
+      io_uring_queue_exit(&m_ring);
+      return ret;
+    }
+
+    register_tables();
+    m_getevent_thread= std::thread(getevent_thread_routine, this);
+    return 0;
+  }
+
+  ~aio_uring()
+  {
+    if (!m_getevent_thread.joinable())
+      return;
+    {
+      std::lock_guard<std::mutex> _(m_mutex);
+      io_uring_sqe *sqe;
+      while (!(sqe= io_uring_get_sqe(&m_ring)))
+        io_uring_submit(&m_ring);
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      while (io_uring_submit(&m_ring) < 0)
+        std::this_thread::yield();
+    }
+    m_getevent_thread.join();
+    io_uring_queue_exit(&m_ring);
+  }
+
+  int submit_io(aiocb *cb) override
+  {
+    const bool is_read= cb->m_opcode == aio_opcode::AIO_PREAD;
+    std::lock_guard<std::mutex> _(m_mutex);
+
+    io_uring_sqe *sqe= io_uring_get_sqe(&m_ring);
+    if (!sqe)
+    {
+      errno= EAGAIN;
+      return -1;
+    }
+
+    int fd= cb->m_fh;
+    const int slot= size_t(fd) < m_fixed_file.size() ? m_fixed_file[fd] : -1;
+    if (slot >= 0)
+      fd= slot;
+
+    if (const fixed_buffer *b= find_fixed_buffer(cb->m_buffer, cb->m_len))
+    {
+      if (is_read)
+        io_uring_prep_read_fixed(sqe, fd, cb->m_buffer, cb->m_len,
+                                 cb->m_offset, b->index);
+      else
+        io_uring_prep_write_fixed(sqe, fd, cb->m_buffer, cb->m_len,
+                                  cb->m_offset, b->index);
+    }
+    else if (is_read)
+      io_uring_prep_read(sqe, fd, cb->m_buffer, cb->m_len, cb->m_offset);
+    else
+      io_uring_prep_write(sqe, fd, cb->m_buffer, cb->m_len, cb->m_offset);
+
+    if (slot >= 0)
+      sqe->flags|= IOSQE_FIXED_FILE;
+    io_uring_sqe_set_data(sqe, cb);
+
+    for (;;)
+    {
+      switch (int ret= io_uring_submit(&m_ring)) {
+      case 1:
+        return 0;
+      case -EINTR:
+      case -EAGAIN:
+      case -EBUSY:
+        /* The completion thread will make room for us. */
+        std::this_thread::yield();
+        continue;
+      default:
+        errno= ret < 0 ? -ret : EIO;
+        return -1;
+      }
+    }
+  }
+
+  int bind(native_file_handle &fd) override
+  {
+    std::lock_guard<std::mutex> _(m_mutex);
+    if (fd < 0 || m_free_files.empty())
+      return 0;
+    if (size_t(fd) >= m_fixed_file.size())
+      m_fixed_file.resize(size_t(fd) + 1, -1);
+    int &slot= m_fixed_file[fd];
+    if (slot >= 0)
+      return 0;
+    int f= fd;
+    if (io_uring_register_files_update(&m_ring, unsigned(m_free_files.back()),
+                                       &f, 1) == 1)
+    {
+      slot= m_free_files.back();
+      m_free_files.pop_back();
+    }
+    return 0;
+  }
+
+  int unbind(const native_file_handle &fd) override
+  {
+    std::lock_guard<std::mutex> _(m_mutex);
+    if (size_t(fd) >= m_fixed_file.size())
+      return 0;
+    int &slot= m_fixed_file[fd];
+    if (slot < 0)
+      return 0;
+    /* Requests that are in flight keep a reference to the file. */
+    int f= -1;
+    io_uring_register_files_update(&m_ring, unsigned(slot), &f, 1);
+    m_free_files.push_back(slot);
+    slot= -1;
+    return 0;
+  }
+
+#ifdef HAVE_URING_BUFFERS_UPDATE
+  int register_buffer(void *buf, size_t len) override
+  {
+    std::lock_guard<std::mutex> _(m_mutex);
+    for (char *b= static_cast<char*>(buf); len && !m_free_buffers.empty(); )
+    {
+      const size_t l= std::min(len, MAX_FIXED_BUFFER_LEN);
+      const unsigned index= m_free_buffers.back();
+      iovec iov{b, l};
+      __u64 tag= 0;
+      /* This may fail due to RLIMIT_MEMLOCK; then we will
+      simply not use fixed buffers for the rest of the region. */
+      if (io_uring_register_buffers_update_tag(&m_ring, index,
+                                               &iov, &tag, 1) != 1)
+        break;
+      m_free_buffers.pop_back();
+      const fixed_buffer f{b, l, buf, index};
+      m_fixed_buffers.insert(std::upper_bound(m_fixed_buffers.begin(),
+                                              m_fixed_buffers.end(), f,
+                                              [](const fixed_buffer &a,
+                                                 const fixed_buffer &b)
+                                              { return a.start < b.start; }),
+                             f);
+      b+= l;
+      len-= l;
+    }
+    return 0;
+  }
+
+  void unregister_buffer(void *buf) override
+  {
+    std::lock_guard<std::mutex> _(m_mutex);
+    for (auto it= m_fixed_buffers.begin(); it != m_fixed_buffers.end(); )
+    {
+      if (it->region != buf)
+      {
+        ++it;
+        continue;
+      }
+      iovec iov{nullptr, 0};
+      __u64 tag= 0;
+      io_uring_register_buffers_update_tag(&m_ring, it->index, &iov, &tag, 1);
+      m_free_buffers.push_back(it->index);
+      it= m_fixed_buffers.erase(it);
+    }
+  }
+#endif
+};
+
+aio *create_uring_aio(thread_pool *pool, int max_io)
+{
+  aio_uring *aio= new aio_uring(pool);
+  if (int ret= aio->init(max_io))
+  {
+    delete aio;
+    errno= -ret;
+    return nullptr;
+  }
+  return aio;
+}
+#else
+aio *create_uring_aio(thread_pool*, int) { return nullptr; }
+#endif
+}
@@ -135,7 +135,10 @@ class aio_linux final : public aio
           iocb->m_internal_task.m_func= iocb->m_callback;
           iocb->m_internal_task.m_arg= iocb;
           iocb->m_internal_task.m_group= iocb->m_group;
-          aio->m_pool->submit_task(&iocb->m_internal_task);
+          if (iocb->m_opcode == aio_opcode::AIO_PREAD)
+            aio->m_pool->submit_urgent_task(&iocb->m_internal_task);
+          else
+            aio->m_pool->submit_task(&iocb->m_internal_task);
         }
       }
     }
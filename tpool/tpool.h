@@ -160,10 +160,20 @@ class aio
     On completion, cb->m_callback is executed.
   */
   virtual int submit_io(aiocb *cb)= 0;
-  /** "Bind" file to AIO handler (used on Windows only) */
+  /** "Bind" file to AIO handler (used on Windows, and by io_uring
+  to register the file descriptor with the ring) */
   virtual int bind(native_file_handle &fd)= 0;
-  /** "Unind" file to AIO handler (used on Windows only) */
+  /** "Unbind" file from AIO handler. On POSIX, this must be invoked
+  before the file descriptor is closed. */
   virtual int unbind(const native_file_handle &fd)= 0;
+  /**
+    Register a memory region that will be used as an I/O buffer
+    (used by io_uring only, for fixed-buffer reads and writes).
+    @return 0 on success, or if the request was ignored
+  */
+  virtual int register_buffer(void *, size_t) { return 0; }
+  /** Unregister a memory region that was passed to register_buffer() */
+  virtual void unregister_buffer(void *) {}
   virtual ~aio(){};
 };
 
@@ -179,6 +189,17 @@ class thread_pool;
 
 extern aio *create_simulated_aio(thread_pool *tp);
 
+/** Native asynchronous I/O implementation (relevant on Linux only) */
+enum aio_implementation
+{
+  /** io_uring if it is available, otherwise libaio */
+  OS_IO_DEFAULT,
+  /** io_uring */
+  OS_IO_URING,
+  /** libaio io_submit()/io_getevents() */
+  OS_IO_LIBAIO
+};
+
 #ifndef DBUG_OFF
 /*
   This function is useful for debugging to make sure all mutexes are released
@@ -196,7 +217,7 @@ class thread_pool
 protected:
   /* AIO handler */
   std::unique_ptr<aio> m_aio;
-  virtual aio *create_native_aio(int max_io)= 0;
+  virtual aio *create_native_aio(int max_io, aio_implementation impl)= 0;
 
   /**
     Functions to be called at worker thread start/end
@@ -210,16 +231,22 @@ class thread_pool
   {
   }
   virtual void submit_task(task *t)= 0;
+  /**
+    Submit a task that should run before tasks submitted with submit_task(),
+    for example the completion of a read that a query is waiting for.
+  */
+  virtual void submit_urgent_task(task *t) { submit_task(t); }
   virtual timer* create_timer(callback_func func, void *data=nullptr) = 0;
   void set_thread_callbacks(void (*init)(), void (*destroy)())
   {
     m_worker_init_callback= init;
     m_worker_destroy_callback= destroy;
   }
-  int configure_aio(bool use_native_aio, int max_io)
+  int configure_aio(bool use_native_aio, int max_io,
+                    aio_implementation impl= OS_IO_DEFAULT)
   {
     if (use_native_aio)
-      m_aio.reset(create_native_aio(max_io));
+      m_aio.reset(create_native_aio(max_io, impl));
     else
       m_aio.reset(create_simulated_aio(this));
     return !m_aio ? -1 : 0;
@@ -230,6 +257,9 @@ class thread_pool
   }
   int bind(native_file_handle &fd) { return m_aio->bind(fd); }
   void unbind(const native_file_handle &fd) { if (m_aio) m_aio->unbind(fd); }
+  int register_buffer(void *buf, size_t len)
+  { return m_aio ? m_aio->register_buffer(buf, len) : 0; }
+  void unregister_buffer(void *buf) { if (m_aio) m_aio->unregister_buffer(buf); }
   int submit_io(aiocb *cb) { return m_aio->submit_io(cb); }
   virtual void wait_begin() {};
   virtual void wait_end() {};
@@ -39,6 +39,7 @@ namespace tpool
 
 #ifdef __linux__
   extern aio* create_linux_aio(thread_pool* tp, int max_io);
+  extern aio* create_uring_aio(thread_pool* tp, int max_io);
 #endif
 #ifdef _WIN32
   extern aio* create_win_aio(thread_pool* tp, int max_io);
@@ -46,6 +47,8 @@ namespace tpool
 
   static const std::chrono::milliseconds LONG_TASK_DURATION = std::chrono::milliseconds(500);
   static const int  OVERSUBSCRIBE_FACTOR = 2;
+  /** Maximum number of urgent tasks dequeued while normal tasks wait */
+  static const unsigned int MAX_URGENT_IN_ROW = 8;
 
 /**
   Implementation of generic threadpool.
@@ -168,6 +171,13 @@ class thread_pool_generic : public thread_pool
   /** The task queue */
   circular_queue<task*> m_task_queue;
 
+  /** Tasks submitted by submit_urgent_task(), dequeued before
+  m_task_queue */
+  circular_queue<task*> m_urgent_queue;
+
+  /** Number of urgent tasks dequeued since the last normal task */
+  unsigned int m_urgent_in_row;
+
   /** List of standby (idle) workers */
   doubly_linked_list<worker_data> m_standby_threads;
 
@@ -267,19 +277,37 @@ class thread_pool_generic : public thread_pool
   {
     return m_active_threads.size() + m_standby_threads.size();
   }
+  bool queues_empty()
+  {
+    return m_task_queue.empty() && m_urgent_queue.empty();
+  }
+  void enqueue_task(task *t, circular_queue<task*> &queue);
 public:
   thread_pool_generic(int min_threads, int max_threads);
   ~thread_pool_generic();
   void wait_begin() override;
   void wait_end() override;
   void submit_task(task *task) override;
-  virtual aio *create_native_aio(int max_io) override
+  void submit_urgent_task(task *task) override;
+  virtual aio *create_native_aio(int max_io, aio_implementation impl) override
   {
 #ifdef _WIN32
+    (void) impl;
     return create_win_aio(this, max_io);
 #elif defined(__linux__)
-    return create_linux_aio(this,max_io);
+    switch (impl) {
+    case OS_IO_URING:
+      return create_uring_aio(this, max_io);
+    case OS_IO_LIBAIO:
+      return create_linux_aio(this, max_io);
+    case OS_IO_DEFAULT:
+      break;
+    }
+    if (aio *a= create_uring_aio(this, max_io))
+      return a;
+    return create_linux_aio(this, max_io);
 #else
+    (void) impl;
     return nullptr;
 #endif
   }
@@ -424,6 +452,14 @@ void thread_pool_generic::cancel_pending(task* t)
       *it = nullptr;
     }
   }
+  for (auto it = m_urgent_queue.begin(); it != m_urgent_queue.end(); it++)
+  {
+    if (*it == t)
+    {
+      t->release();
+      *it = nullptr;
+    }
+  }
 }
 /**
   Register worker in standby list, and wait to be woken.
@@ -434,7 +470,7 @@ void thread_pool_generic::cancel_pending(task* t)
 bool thread_pool_generic::wait_for_tasks(std::unique_lock<std::mutex> &lk,
                                          worker_data *thread_data)
 {
-  assert(m_task_queue.empty());
+  assert(queues_empty());
   assert(!m_in_shutdown);
 
   thread_data->m_wake_reason= WAKE_REASON_NONE;
@@ -491,23 +527,47 @@ bool thread_pool_generic::get_task(worker_data *thread_var, task **t)
   DBUG_ASSERT(!thread_var->is_waiting());
   thread_var->m_state = worker_data::NONE;
 
-  while (m_task_queue.empty())
+  for (;;)
   {
+    /*
+      Prefer urgent tasks, but do not let a steady stream of them
+      starve the normal task queue.
+    */
+    if (!m_urgent_queue.empty() &&
+        (m_task_queue.empty() || m_urgent_in_row < MAX_URGENT_IN_ROW))
+    {
+      *t= m_urgent_queue.front();
+      m_urgent_queue.pop();
+      m_urgent_in_row++;
+      break;
+    }
+
+    if (!m_task_queue.empty())
+    {
+      /* Dequeue from the task queue.*/
+      *t= m_task_queue.front();
+      m_task_queue.pop();
+      m_urgent_in_row= 0;
+      break;
+    }
+
     if (m_in_shutdown)
       return false;
 
     if (!wait_for_tasks(lk, thread_var))
       return false;
-    if (m_task_queue.empty())
+
+    if (thread_var->m_task)
     {
-      m_spurious_wakeups++;
-      continue;
+      /* The task was handed over in submit_task().*/
+      *t= thread_var->m_task;
+      thread_var->m_task= nullptr;
+      break;
     }
+    if (queues_empty())
+      m_spurious_wakeups++;
   }
 
-  /* Dequeue from the task queue.*/
-  *t= m_task_queue.front();
-  m_task_queue.pop();
   m_tasks_dequeued++;
   thread_var->m_state |= worker_data::EXECUTING_TASK;
   thread_var->m_task_start_time = m_timestamp;
@@ -569,7 +629,7 @@ constexpr auto max_idle_time= std::chrono::minutes(1);
 static std::chrono::system_clock::time_point idle_since= invalid_timestamp;
 void thread_pool_generic::check_idle(std::chrono::system_clock::time_point now)
 {
-  DBUG_ASSERT(m_task_queue.empty());
+  DBUG_ASSERT(queues_empty());
 
   /*
    We think that there is no activity, if there were at most 2 tasks
@@ -626,7 +686,7 @@ void thread_pool_generic::maintenance()
 
   m_timestamp = std::chrono::system_clock::now();
 
-  if (m_task_queue.empty())
+  if (queues_empty())
   {
     check_idle(m_timestamp);
     m_last_activity = m_tasks_dequeued + m_wakeups;
@@ -731,7 +791,7 @@ bool thread_pool_generic::add_thread()
 }
 
 /** Wake a standby thread, and hand the given task over to this thread. */
-bool thread_pool_generic::wake(worker_wake_reason reason, task *)
+bool thread_pool_generic::wake(worker_wake_reason reason, task *t)
 {
   assert(reason != WAKE_REASON_NONE);
 
@@ -741,7 +801,9 @@ bool thread_pool_generic::wake(worker_wake_reason reason, task *)
   m_standby_threads.pop_back();
   m_active_threads.push_back(var);
   assert(var->m_wake_reason == WAKE_REASON_NONE);
+  assert(!var->m_task);
   var->m_wake_reason= reason;
+  var->m_task= t;
   var->m_cv.notify_one();
   m_wakeups++;
   return true;
@@ -751,6 +813,8 @@ bool thread_pool_generic::wake(worker_wake_reason reason, task *)
 thread_pool_generic::thread_pool_generic(int min_threads, int max_threads) :
   m_thread_data_cache(max_threads),
   m_task_queue(10000),
+  m_urgent_queue(1000),
+  m_urgent_in_row(),
   m_standby_threads(),
   m_active_threads(),
   m_mtx(),
@@ -789,7 +853,7 @@ thread_pool_generic::thread_pool_generic(int min_threads, int max_threads) :
 
 void thread_pool_generic::maybe_wake_or_create_thread()
 {
-  if (m_task_queue.empty())
+  if (queues_empty())
     return;
   DBUG_ASSERT(m_active_threads.size() >= static_cast<size_t>(m_long_tasks_count + m_waiting_task_count));
   if (m_active_threads.size() - m_long_tasks_count - m_waiting_task_count > m_concurrency)
@@ -810,18 +874,43 @@ bool thread_pool_generic::too_many_active_threads()
     m_concurrency* OVERSUBSCRIBE_FACTOR;
 }
 
-/** Submit a new task*/
-void thread_pool_generic::submit_task(task* task)
+/** Queue a new task, or hand it over to a standby worker */
+void thread_pool_generic::enqueue_task(task* t,
+                                       circular_queue<task*> &queue)
 {
   std::unique_lock<std::mutex> lk(m_mtx);
   if (m_in_shutdown)
     return;
-  task->add_ref();
+  t->add_ref();
   m_tasks_enqueued++;
-  m_task_queue.push(task);
+  if (queues_empty() && !m_standby_threads.empty() &&
+      m_active_threads.size() - m_long_tasks_count - m_waiting_task_count <=
+      m_concurrency)
+  {
+    /*
+      Hand the task directly to the standby thread that we would wake
+      anyway. It then does not have to compete for the task with the
+      active workers, and a woken thread never finds the queue empty.
+    */
+    wake(WAKE_REASON_TASK, t);
+    return;
+  }
+  queue.push(t);
   maybe_wake_or_create_thread();
 }
 
+/** Submit a new task*/
+void thread_pool_generic::submit_task(task* task)
+{
+  enqueue_task(task, m_task_queue);
+}
+
+/** Submit a new task that is executed before normally submitted ones */
+void thread_pool_generic::submit_urgent_task(task* task)
+{
+  enqueue_task(task, m_urgent_queue);
+}
+
 
 /* Notify thread pool that current thread is going to wait */
 void thread_pool_generic::wait_begin()
@@ -0,0 +1,464 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Micro-benchmarks of the primitives that are on the hot path of the server:
+  lf_hash, MEM_ROOT, IO_CACHE, MY_BITMAP, thr_lock, collations (compare and
+  sort key construction), decimal arithmetic and the JSON scanner.
+
+  Every benchmark is run with a growing number of iterations until it takes
+  at least --min-time seconds, and the time per iteration is reported either
+  as a table or, with --json, as a JSON document that can be compared
+  between releases.
+
+  Usage: mysys-bench [--json] [--filter=prefix] [--min-time=seconds]
+*/
+
+#include <my_global.h>
+#include <mysql_version.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <my_bitmap.h>
+#include <lf.h>
+#include <thr_lock.h>
+#include <decimal.h>
+#include <json_lib.h>
+
+typedef struct st_benchmark
+{
+  const char *name;
+  /* Optional; called before every timed run */
+  void (*setup)(void);
+  /* Executes the benchmarked operation iterations times */
+  void (*run)(ulonglong iterations);
+  /* Optional; called after every timed run */
+  void (*teardown)(void);
+} BENCHMARK;
+
+/* Keeps the compiler from optimizing away the benchmarked code */
+static volatile ulonglong sink;
+
+/* lf_hash */
+
+#define LF_HASH_KEYS 4096
+
+static LF_HASH lf_hash;
+static LF_PINS *lf_pins;
+
+static void lf_hash_setup(void)
+{
+  int32 i;
+  lf_hash_init(&lf_hash, sizeof(int32), LF_HASH_UNIQUE, 0, sizeof(int32), 0,
+               &my_charset_bin);
+  lf_pins= lf_hash_get_pins(&lf_hash);
+  for (i= 0; i < LF_HASH_KEYS; i++)
+    lf_hash_insert(&lf_hash, lf_pins, &i);
+}
+
+static void lf_hash_teardown(void)
+{
+  lf_hash_put_pins(lf_pins);
+  lf_hash_destroy(&lf_hash);
+}
+
+static void bench_lf_hash_search(ulonglong iterations)
+{
+  ulonglong found= 0;
+  int32 key;
+  for (; iterations; iterations--)
+  {
+    key= (int32) (iterations % LF_HASH_KEYS);
+    if (lf_hash_search(&lf_hash, lf_pins, &key, sizeof(key)))
+      found++;
+    lf_hash_search_unpin(lf_pins);
+  }
+  sink= found;
+}
+
+static void bench_lf_hash_insert_delete(ulonglong iterations)
+{
+  int32 key;
+  for (; iterations; iterations--)
+  {
+    key= LF_HASH_KEYS + (int32) (iterations % LF_HASH_KEYS);
+    lf_hash_insert(&lf_hash, lf_pins, &key);
+    lf_hash_delete(&lf_hash, lf_pins, &key, sizeof(key));
+  }
+}
+
+/* MEM_ROOT */
+
+static void bench_alloc_root(ulonglong iterations)
+{
+  MEM_ROOT root;
+  uint i;
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 8192, 0, MYF(0));
+  for (; iterations; iterations--)
+  {
+    /* A statement worth of small allocations, then a reset */
+    for (i= 0; i < 64; i++)
+      sink+= (size_t) alloc_root(&root, 8 + (i & 7) * 8) & 1;
+    free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  free_root(&root, MYF(0));
+}
+
+/* IO_CACHE */
+
+#define IO_CACHE_RECORD 128
+#define IO_CACHE_RECORDS 1024
+
+static void bench_io_cache(ulonglong iterations)
+{
+  IO_CACHE cache;
+  uchar record[IO_CACHE_RECORD];
+  uint i;
+
+  memset(record, 'a', sizeof(record));
+  if (open_cached_file(&cache, NULL, "bench", 65536, MYF(MY_WME)))
+    abort();
+  for (; iterations; iterations--)
+  {
+    /* Write and read back a spilled result, as filesort and tmp tables do */
+    for (i= 0; i < IO_CACHE_RECORDS; i++)
+      my_b_write(&cache, record, sizeof(record));
+    reinit_io_cache(&cache, READ_CACHE, 0, 0, 0);
+    for (i= 0; i < IO_CACHE_RECORDS; i++)
+      my_b_read(&cache, record, sizeof(record));
+    reinit_io_cache(&cache, WRITE_CACHE, 0, 0, 1);
+  }
+  close_cached_file(&cache);
+}
+
+/* MY_BITMAP */
+
+#define BITMAP_BITS 1024
+
+static void bench_bitmap(ulonglong iterations)
+{
+  MY_BITMAP map1, map2;
+  uint bits= 0;
+
+  my_bitmap_init(&map1, NULL, BITMAP_BITS, FALSE);
+  my_bitmap_init(&map2, NULL, BITMAP_BITS, FALSE);
+  for (; iterations; iterations--)
+  {
+    uint bit= (uint) (iterations % BITMAP_BITS);
+    bitmap_set_bit(&map1, bit);
+    bitmap_set_bit(&map2, BITMAP_BITS - 1 - bit);
+    bitmap_union(&map1, &map2);
+    bitmap_intersect(&map2, &map1);
+    bits+= bitmap_bits_set(&map1) + bitmap_is_set(&map2, bit);
+  }
+  sink= bits;
+  my_bitmap_free(&map1);
+  my_bitmap_free(&map2);
+}
+
+/* thr_lock */
+
+#define THR_LOCKS 4
+
+static void bench_thr_multi_lock(ulonglong iterations)
+{
+  THR_LOCK locks[THR_LOCKS];
+  THR_LOCK_DATA data[THR_LOCKS], *multi[THR_LOCKS];
+  THR_LOCK_INFO info;
+  uint i;
+
+  thr_lock_info_init(&info, 0);
+  for (i= 0; i < THR_LOCKS; i++)
+  {
+    thr_lock_init(&locks[i]);
+    thr_lock_data_init(&locks[i], &data[i], NULL);
+  }
+  for (; iterations; iterations--)
+  {
+    /* Lock the tables of a statement: one written, the others read */
+    for (i= 0; i < THR_LOCKS; i++)
+    {
+      data[i].type= i ? TL_READ : TL_WRITE;
+      multi[i]= &data[i];
+    }
+    if (thr_multi_lock(multi, THR_LOCKS, &info, 1) != THR_LOCK_SUCCESS)
+      abort();
+    thr_multi_unlock(multi, THR_LOCKS, 0);
+  }
+  for (i= 0; i < THR_LOCKS; i++)
+    thr_lock_delete(&locks[i]);
+}
+
+/* Collations */
+
+static const uchar coll_str1[]= "The quick brown fox jumps over the lazy dog "
+                                "\xc3\xa4\xc3\xb6\xc3\xbc   ";
+static const uchar coll_str2[]= "The quick brown fox jumps over the lazy dog "
+                                "\xc3\xa4\xc3\xb6\xc3\xbd";
+
+static void bench_collation_compare(const char *name, ulonglong iterations)
+{
+  CHARSET_INFO *cs= get_charset_by_name(name, MYF(0));
+  int res= 0;
+  if (!cs)
+    abort();
+  for (; iterations; iterations--)
+    res+= cs->coll->strnncollsp(cs, coll_str1, sizeof(coll_str1) - 1,
+                                coll_str2, sizeof(coll_str2) - 1);
+  sink= res;
+}
+
+/* The key construction of filesort: make_sortkey() calls strnxfrm() */
+static void bench_collation_sortkey(const char *name, ulonglong iterations)
+{
+  CHARSET_INFO *cs= get_charset_by_name(name, MYF(0));
+  uchar key[1024];
+  size_t len= 0;
+  if (!cs)
+    abort();
+  for (; iterations; iterations--)
+    len+= cs->coll->strnxfrm(cs, key, sizeof(key), 64,
+                             coll_str1, sizeof(coll_str1) - 1,
+                             MY_STRXFRM_PAD_WITH_SPACE);
+  sink= len;
+}
+
+static void bench_latin1_compare(ulonglong iterations)
+{
+  bench_collation_compare("latin1_swedish_ci", iterations);
+}
+
+static void bench_utf8mb4_general_compare(ulonglong iterations)
+{
+  bench_collation_compare("utf8mb4_general_ci", iterations);
+}
+
+static void bench_utf8mb4_unicode_compare(ulonglong iterations)
+{
+  bench_collation_compare("utf8mb4_unicode_ci", iterations);
+}
+
+static void bench_latin1_sortkey(ulonglong iterations)
+{
+  bench_collation_sortkey("latin1_swedish_ci", iterations);
+}
+
+static void bench_utf8mb4_general_sortkey(ulonglong iterations)
+{
+  bench_collation_sortkey("utf8mb4_general_ci", iterations);
+}
+
+static void bench_utf8mb4_unicode_sortkey(ulonglong iterations)
+{
+  bench_collation_sortkey("utf8mb4_unicode_ci", iterations);
+}
+
+/* Decimal arithmetic */
+
+#define DECIMAL_LEN 9
+
+static decimal_digit_t dec_buf1[DECIMAL_LEN], dec_buf2[DECIMAL_LEN],
+                       dec_buf3[DECIMAL_LEN];
+static decimal_t dec1, dec2, dec3;
+
+static void decimal_setup(void)
+{
+  char str1[]= "12345678901234.56789", str2[]= "-98765.4321";
+  char *end;
+  dec1.buf= dec_buf1; dec1.len= DECIMAL_LEN;
+  dec2.buf= dec_buf2; dec2.len= DECIMAL_LEN;
+  dec3.buf= dec_buf3; dec3.len= DECIMAL_LEN;
+  end= strend(str1);
+  string2decimal(str1, &dec1, &end);
+  end= strend(str2);
+  string2decimal(str2, &dec2, &end);
+}
+
+static void bench_decimal_add(ulonglong iterations)
+{
+  for (; iterations; iterations--)
+    decimal_add(&dec1, &dec2, &dec3);
+  sink= dec3.intg;
+}
+
+static void bench_decimal_mul(ulonglong iterations)
+{
+  for (; iterations; iterations--)
+    decimal_mul(&dec1, &dec2, &dec3);
+  sink= dec3.intg;
+}
+
+static void bench_decimal_div(ulonglong iterations)
+{
+  for (; iterations; iterations--)
+    decimal_div(&dec1, &dec2, &dec3, 4);
+  sink= dec3.intg;
+}
+
+static void bench_string2decimal(ulonglong iterations)
+{
+  char str[]= "12345678901234.56789";
+  char *end;
+  for (; iterations; iterations--)
+  {
+    end= str + sizeof(str) - 1;
+    string2decimal(str, &dec3, &end);
+  }
+  sink= dec3.intg;
+}
+
+/* JSON scanner */
+
+static const char json_doc[]=
+  "{\"id\": 12345, \"name\": \"a somewhat longer string value\","
+  " \"tags\": [\"one\", \"two\", \"three\"], \"price\": 12.50,"
+  " \"nested\": {\"a\": [1, 2, 3, {\"b\": null}], \"c\": true}}";
+
+static void bench_json_scan(ulonglong iterations)
+{
+  json_engine_t je;
+  ulonglong steps= 0;
+  for (; iterations; iterations--)
+  {
+    json_scan_start(&je, &my_charset_utf8mb4_bin, (const uchar *) json_doc,
+                    (const uchar *) json_doc + sizeof(json_doc) - 1);
+    while (json_scan_next(&je) == 0)
+      steps++;
+  }
+  sink= steps;
+}
+
+
+static BENCHMARK benchmarks[]=
+{
+  {"lf_hash_search", lf_hash_setup, bench_lf_hash_search, lf_hash_teardown},
+  {"lf_hash_insert_delete", lf_hash_setup, bench_lf_hash_insert_delete,
+   lf_hash_teardown},
+  {"alloc_root_64", NULL, bench_alloc_root, NULL},
+  {"io_cache_write_read_128k", NULL, bench_io_cache, NULL},
+  {"bitmap_1024", NULL, bench_bitmap, NULL},
+  {"thr_multi_lock_4", NULL, bench_thr_multi_lock, NULL},
+  {"strnncollsp_latin1_swedish_ci", NULL, bench_latin1_compare, NULL},
+  {"strnncollsp_utf8mb4_general_ci", NULL, bench_utf8mb4_general_compare,
+   NULL},
+  {"strnncollsp_utf8mb4_unicode_ci", NULL, bench_utf8mb4_unicode_compare,
+   NULL},
+  {"strnxfrm_latin1_swedish_ci", NULL, bench_latin1_sortkey, NULL},
+  {"strnxfrm_utf8mb4_general_ci", NULL, bench_utf8mb4_general_sortkey, NULL},
+  {"strnxfrm_utf8mb4_unicode_ci", NULL, bench_utf8mb4_unicode_sortkey, NULL},
+  {"decimal_add", decimal_setup, bench_decimal_add, NULL},
+  {"decimal_mul", decimal_setup, bench_decimal_mul, NULL},
+  {"decimal_div", decimal_setup, bench_decimal_div, NULL},
+  {"string2decimal", decimal_setup, bench_string2decimal, NULL},
+  {"json_scan", NULL, bench_json_scan, NULL},
+  {NULL, NULL, NULL, NULL}
+};
+
+
+static ulonglong time_run(const BENCHMARK *b, ulonglong iterations)
+{
+  ulonglong start;
+  if (b->setup)
+    b->setup();
+  start= my_interval_timer();
+  b->run(iterations);
+  start= my_interval_timer() - start;
+  if (b->teardown)
+    b->teardown();
+  return start;
+}
+
+
+/**
+  Run a benchmark with a growing number of iterations until it takes
+  at least min_time nanoseconds.
+*/
+static void run_benchmark(const BENCHMARK *b, ulonglong min_time,
+                          ulonglong *iterations, ulonglong *elapsed)
+{
+  ulonglong n= 1, t;
+  for (;;)
+  {
+    t= time_run(b, n);
+    if (t >= min_time || n >= 1000000000ULL)
+      break;
+    /* Aim a bit above min_time, but grow at most 10 times per step */
+    if (t * 10 <= min_time)
+      n*= 10;
+    else
+      n= (ulonglong) ((double) n * min_time * 1.4 / (double) t) + 1;
+  }
+  *iterations= n;
+  *elapsed= t;
+}
+
+
+int main(int argc, char **argv)
+{
+  const char *filter= "";
+  my_bool json= FALSE, first= TRUE;
+  double min_time= 0.5;
+  const BENCHMARK *b;
+  int i;
+
+  MY_INIT(argv[0]);
+
+  for (i= 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--json"))
+      json= TRUE;
+    else if (is_prefix(argv[i], "--filter="))
+      filter= argv[i] + sizeof("--filter=") - 1;
+    else if (is_prefix(argv[i], "--min-time="))
+      min_time= atof(argv[i] + sizeof("--min-time=") - 1);
+    else
+    {
+      fprintf(stderr,
+              "Usage: %s [--json] [--filter=prefix] [--min-time=seconds]\n",
+              argv[0]);
+      my_end(0);
+      return 1;
+    }
+  }
+
+  if (json)
+    printf("{\n  \"context\": {\"version\": \"%s\", \"min_time\": %g},\n"
+           "  \"benchmarks\": [", MYSQL_SERVER_VERSION, min_time);
+  else
+    printf("%-34s %14s %14s\n", "Benchmark", "Iterations", "ns/iteration");
+
+  for (b= benchmarks; b->name; b++)
+  {
+    ulonglong iterations, elapsed;
+    if (!is_prefix(b->name, filter))
+      continue;
+    run_benchmark(b, (ulonglong) (min_time * 1e9), &iterations, &elapsed);
+    if (json)
+      printf("%s\n    {\"name\": \"%s\", \"iterations\": %llu,"
+             " \"real_time\": %llu, \"ns_per_iteration\": %.2f}",
+             first ? "" : ",", b->name, iterations, elapsed,
+             (double) elapsed / (double) iterations);
+    else
+      printf("%-34s %14llu %14.2f\n", b->name, iterations,
+             (double) elapsed / (double) iterations);
+    fflush(stdout);
+    first= FALSE;
+  }
+
+  if (json)
+    printf("\n  ]\n}\n");
+
+  my_end(0);
+  return 0;
+}
@@ -37,6 +37,14 @@
     }while(0)
 
 
+/* Check that combining the checksums of two parts gives the whole checksum */
+#define DO_TEST_CRC32_COMBINE(str,len1) \
+    ok(my_checksum(0, str, sizeof(str)-1) == \
+       my_checksum_combine(my_checksum(0, str, len1), \
+                           my_checksum(0, str + len1, sizeof(str)-1-len1), \
+                           sizeof(str)-1-len1), "crc32 combine '%s' at %u", \
+       str, (uint) len1)
+
 #define LONG_STR "1234567890234568900212345678901231213123321212123123123123123"\
  "............................................................................." \
  "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx" \
@@ -46,7 +54,7 @@
 int main(int argc __attribute__((unused)),char *argv[])
 {
   MY_INIT(argv[0]);
-  plan(14);
+  plan(18);
   printf("%s\n",my_crc32c_implementation());
   DO_TEST_CRC32(0,"");
   DO_TEST_CRC32(1,"");
@@ -55,6 +63,10 @@ int main(int argc __attribute__((unused)),char *argv[])
   DO_TEST_CRC32(0,"1234567890123456789");
   DO_TEST_CRC32(0, LONG_STR);
   ok(0 == my_checksum(0, NULL, 0) , "crc32 data = NULL, length = 0");
+  DO_TEST_CRC32_COMBINE("12345", 5);
+  DO_TEST_CRC32_COMBINE("1234567890123456789", 0);
+  DO_TEST_CRC32_COMBINE("1234567890123456789", 7);
+  DO_TEST_CRC32_COMBINE(LONG_STR, 19);
 
   DO_TEST_CRC32C(0,"", 0);
   DO_TEST_CRC32C(1,"", 1);
@@ -0,0 +1,98 @@
+/* Copyright (c) 2021, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_rnd.h>
+#include "tap.h"
+
+#define MAX_ITEMS 20000
+#define MAX_SIZE 64
+
+static uchar data[MAX_ITEMS * MAX_SIZE];
+static uchar *keys[MAX_ITEMS], *buffer[MAX_ITEMS];
+
+/*
+  Fill the keys with random bytes. Only the last `random` bytes vary, and
+  only among `alphabet` values, so that there are long common prefixes and
+  many duplicates, as with typical sort keys.
+*/
+static void fill(struct my_rnd_struct *rnd, uint n, size_t size,
+                 size_t random, uint alphabet)
+{
+  uint i;
+  size_t j;
+  for (i= 0; i < n; i++)
+  {
+    keys[i]= data + i * size;
+    for (j= 0; j < size; j++)
+      keys[i][j]= j < size - random ? 'a' :
+        (uchar) (my_rnd(rnd) * alphabet);
+  }
+}
+
+static my_bool is_sorted(uint n, size_t size)
+{
+  uint i;
+  for (i= 1; i < n; i++)
+    if (memcmp(keys[i - 1], keys[i], size) > 0)
+      return 0;
+  return 1;
+}
+
+static my_bool is_permutation(uint n, size_t size)
+{
+  static uchar seen[MAX_ITEMS];
+  uint i;
+  bzero(seen, n);
+  for (i= 0; i < n; i++)
+  {
+    size_t idx= (size_t) (keys[i] - data) / size;
+    if (idx >= n || seen[idx])
+      return 0;
+    seen[idx]= 1;
+  }
+  return 1;
+}
+
+static void test(struct my_rnd_struct *rnd, uint n, size_t size,
+                 size_t random, uint alphabet)
+{
+  fill(rnd, n, size, random, alphabet);
+  radixsort_msd_for_str_ptr(keys, n, size, buffer);
+  ok(is_sorted(n, size) && is_permutation(n, size),
+     "items=%u size=%u random bytes=%u alphabet=%u",
+     n, (uint) size, (uint) random, alphabet);
+}
+
+int main(int argc __attribute__((unused)), char *argv[])
+{
+  struct my_rnd_struct rnd;
+  MY_INIT(argv[0]);
+  my_rnd_init(&rnd, 1, 2);
+  plan(8);
+
+  test(&rnd, 0, 8, 8, 256);
+  test(&rnd, 1, 8, 8, 256);
+  test(&rnd, 20, 8, 8, 256);
+  test(&rnd, 1000, 4, 4, 256);
+  test(&rnd, MAX_ITEMS, 16, 16, 256);
+  test(&rnd, MAX_ITEMS, MAX_SIZE, 8, 4);
+  test(&rnd, MAX_ITEMS, MAX_SIZE, MAX_SIZE, 2);
+  test(&rnd, MAX_ITEMS, MAX_SIZE, 0, 1);
+
+  my_end(0);
+  return exit_status();
+}
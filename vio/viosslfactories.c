@@ -268,6 +268,15 @@ new_VioSSLFd(const char *key_file, const char *cert_file,
 
   SSL_CTX_set_options(ssl_fd->ssl_context, ssl_ctx_options);
 
+#ifdef SSL_OP_ENABLE_KTLS
+  /*
+    Let the kernel encrypt and decrypt the records once the handshake
+    is done (Linux kTLS). OpenSSL silently keeps doing it in user space
+    if the kernel or the negotiated cipher does not support it.
+  */
+  SSL_CTX_set_options(ssl_fd->ssl_context, SSL_OP_ENABLE_KTLS);
+#endif
+
   /*
     Set the ciphers that can be used
     NOTE: SSL_CTX_set_cipher_list will return 0 if